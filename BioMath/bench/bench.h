@@ -0,0 +1,33 @@
+#pragma once
+
+// ---------------------------
+// BioMathBench
+// ---------------------------
+
+// Ejecutable de consola con benchmarks headless (sin ventana ni GL), para correr en CI.
+// Cada benchmark es un subcomando: BioMathBench <nombre> [opciones]. Devuelve 0 si todo ok.
+
+#include <chrono>
+
+// Reloj para medir: segundos desde un punto arbitrario.
+inline double BenchNowSeconds()
+{
+	using namespace std::chrono;
+	return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Busca "--name" en argv. BenchArgInt/Float devuelven 'fallback' si no esta.
+bool BenchHasFlag(int argc, char** argv, const char* name);
+int BenchArgInt(int argc, char** argv, const char* name, int fallback);
+double BenchArgFloat(int argc, char** argv, const char* name, double fallback);
+
+int BenchAgents(int argc, char** argv);
+int BenchAssets(int argc, char** argv);
+int BenchCpuRender(int argc, char** argv);
+int BenchExpr(int argc, char** argv);
+int BenchJobs(int argc, char** argv);
+int BenchNoiseBake(int argc, char** argv);
+int BenchOde(int argc, char** argv);
+int BenchReactionDiffusion(int argc, char** argv);
+int BenchSynth(int argc, char** argv);
+int BenchText(int argc, char** argv);
@@ -0,0 +1,233 @@
+#include "bench.h"
+
+#include "agents.h"
+#include "parallel.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+// Agentes (agents.h), por modo:
+//   1. La grilla encuentra exactamente los mismos vecinos que la fuerza bruta O(n^2) (al inicio y
+//      despues de --verify-ticks, cuando ya hay grupos densos).
+//   2. SSE2/AVX2 dan los mismos bits que el escalar, y el mejor camino da los mismos bits con 1
+//      thread que con todos.
+//   3. ms por tick con --agents agentes, separado en sort / fuerzas / integracion, por camino.
+// Al final, el escalado por threads del mejor camino (bandada).
+//
+// Opciones:
+//   --agents <n>          agentes medidos (default 1000000)
+//   --verify-agents <n>   agentes de la verificacion (default 4096)
+//   --verify-ticks <n>    ticks antes de comparar (default 240: 2 s a 120 Hz)
+//   --min-seconds <s>     tiempo minimo medido por caso (default 0.5)
+//   --threads <n>         maximo de threads del escalado (default: todos)
+
+static const CpuShadePath kPaths[] = { CpuShadePath::Scalar, CpuShadePath::SSE2, CpuShadePath::AVX2 };
+static const AgentMode kModes[] = { AgentMode::Flocking, AgentMode::Chemotaxis };
+static const float kTickSeconds = 1.0f / 120.0f;
+static const uint32_t kSeed = 1234;
+
+// Pares (i, j) con 0 < d^2 < radius^2 en el toro, con las mismas operaciones que el kernel.
+static uint64_t BruteForceNeighbors(const AgentWorld& w, const AgentParams& params)
+{
+	const float radius2 = params.radius * params.radius;
+	const float halfW = w.width * 0.5f, halfH = w.height * 0.5f;
+	uint64_t total = 0;
+	for (int i = 0; i < w.count; ++i)
+	{
+		for (int j = 0; j < w.count; ++j)
+		{
+			float dx = w.x[(size_t)j] - w.x[(size_t)i];
+			float dy = w.y[(size_t)j] - w.y[(size_t)i];
+			dx = halfW < dx ? dx - w.width : (dx < -halfW ? dx + w.width : dx);
+			dy = halfH < dy ? dy - w.height : (dy < -halfH ? dy + w.height : dy);
+			const float d2 = dx * dx + dy * dy;
+			if (0.0f < d2 && d2 < radius2) ++total;
+		}
+	}
+	return total;
+}
+
+// Un tick con dt = 0 no mueve a nadie: los vecinos que conto la grilla son los de las posiciones actuales.
+static uint64_t GridNeighbors(AgentWorld* w, const AgentParams& params)
+{
+	AgentWorldStep(w, params, 0.0f, nullptr, CpuShadePath::Scalar);
+	uint64_t total = 0;
+	for (uint64_t n : w->rowNeighbors) total += n;
+	return total;
+}
+
+static bool SameState(const AgentWorld& a, const AgentWorld& b)
+{
+	const size_t bytes = (size_t)a.count * sizeof(float);
+	return memcmp(a.x.data(), b.x.data(), bytes) == 0 && memcmp(a.y.data(), b.y.data(), bytes) == 0 &&
+		memcmp(a.vx.data(), b.vx.data(), bytes) == 0 && memcmp(a.vy.data(), b.vy.data(), bytes) == 0;
+}
+
+static void RunTicks(AgentWorld* w, const AgentParams& params, int ticks, CpuShadePath path, float* frame = nullptr)
+{
+	for (int t = 0; t < ticks; ++t) AgentWorldStep(w, params, kTickSeconds, frame, path);
+}
+
+static int VerifyMode(AgentMode mode, int count, int ticks, CpuShadePath best)
+{
+	const AgentParams params = AgentParamsDefault(mode);
+	int failures = 0;
+
+	AgentWorld world;
+	AgentWorldInit(&world, mode, count, kSeed, params);
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		if (pass == 1) RunTicks(&world, params, ticks, CpuShadePath::Scalar);
+		const uint64_t grid = GridNeighbors(&world, params);
+		const uint64_t brute = BruteForceNeighbors(world, params);
+		printf("  %-5s %d agents, tick %-4llu grid %llu neighbors, brute force %llu: %s\n", AgentModeName(mode), count,
+			(unsigned long long)world.ticks - 1, (unsigned long long)grid, (unsigned long long)brute, grid == brute ? "ok" : "MISMATCH");
+		if (grid != brute) ++failures;
+	}
+
+	AgentWorld scalar;
+	AgentWorldInit(&scalar, mode, count, kSeed, params);
+	RunTicks(&scalar, params, ticks, CpuShadePath::Scalar);
+
+	std::vector<float> frame((size_t)count * 4);
+	for (CpuShadePath path : kPaths)
+	{
+		if (path == CpuShadePath::Scalar) continue;
+		if (!CpuShadePathAvailable(path))
+		{
+			printf("    %-6s n/a\n", CpuShadePathName(path));
+			continue;
+		}
+		AgentWorld w;
+		AgentWorldInit(&w, mode, count, kSeed, params);
+		RunTicks(&w, params, ticks, path, frame.data());
+
+		// El frame publicado tiene que ser el estado.
+		const size_t bytes = (size_t)count * sizeof(float);
+		const bool frameOk = memcmp(frame.data(), w.x.data(), bytes) == 0 && memcmp(frame.data() + (size_t)count * 3, w.vy.data(), bytes) == 0;
+		const bool exact = SameState(w, scalar);
+		printf("    %-6s vs scalar after %d ticks: %s, frame %s\n", CpuShadePathName(path), ticks, exact ? "exact" : "MISMATCH",
+			frameOk ? "ok" : "MISMATCH");
+		if (!exact || !frameOk) ++failures;
+	}
+
+	// Mismo resultado con 1 thread.
+	AgentWorld single;
+	AgentWorldInit(&single, mode, count, kSeed, params);
+	ParallelSetThreadLimit(1);
+	RunTicks(&single, params, ticks, best);
+	ParallelSetThreadLimit(0);
+	const bool exact = SameState(single, scalar);
+	printf("    %-6s 1 thread vs scalar: %s\n", CpuShadePathName(best), exact ? "exact" : "MISMATCH");
+	if (!exact) ++failures;
+	return failures;
+}
+
+struct AgentTiming
+{
+	double tick = 0.0;   // ms
+	double sort = 0.0;
+	double force = 0.0;
+	double integrate = 0.0;
+	double neighbors = 0.0;
+};
+
+// Promedio por tick, desde el mismo estado inicial (tras unos ticks de calentamiento).
+static AgentTiming MeasureTicks(AgentMode mode, const AgentParams& params, int count, CpuShadePath path, double minSeconds, float* frame)
+{
+	AgentWorld w;
+	AgentWorldInit(&w, mode, count, kSeed, params);
+	RunTicks(&w, params, 2, path, frame);
+
+	AgentTiming t;
+	int ticks = 0;
+	const double start = BenchNowSeconds();
+	double elapsed = 0.0;
+	do
+	{
+		AgentWorldStep(&w, params, kTickSeconds, frame, path);
+		t.sort += w.sortMs;
+		t.force += w.forceMs;
+		t.integrate += w.integrateMs;
+		t.neighbors += w.meanNeighbors;
+		++ticks;
+		elapsed = BenchNowSeconds() - start;
+	} while (elapsed < minSeconds);
+
+	t.tick = elapsed * 1e3 / ticks;
+	t.sort /= ticks;
+	t.force /= ticks;
+	t.integrate /= ticks;
+	t.neighbors /= ticks;
+	return t;
+}
+
+int BenchAgents(int argc, char** argv)
+{
+	const int count = BenchArgInt(argc, argv, "--agents", 1000000);
+	const int verifyCount = BenchArgInt(argc, argv, "--verify-agents", 4096);
+	const int verifyTicks = BenchArgInt(argc, argv, "--verify-ticks", 240);
+	const double minSeconds = BenchArgFloat(argc, argv, "--min-seconds", 0.5);
+	const int maxThreads = BenchArgInt(argc, argv, "--threads", 0);
+	if (count < 1 || verifyCount < 1 || verifyTicks < 1)
+	{
+		fprintf(stderr, "agents: --agents, --verify-agents and --verify-ticks must be >= 1\n");
+		return 1;
+	}
+
+	CpuShadePath best = CpuShadePath::Scalar;
+	for (CpuShadePath path : kPaths)
+		if (CpuShadePathAvailable(path)) best = path;
+
+	int failures = 0;
+
+	// ---- Verificacion: vecinos y mismos bits ----
+
+	printf("agents: verify (%d ticks)\n", verifyTicks);
+	for (AgentMode mode : kModes) failures += VerifyMode(mode, verifyCount, verifyTicks, best);
+
+	// ---- Throughput: ms por tick con todos los threads ----
+
+	ParallelSetThreadLimit(maxThreads);
+	const int threads = ParallelThreadCount();
+	std::vector<float> frame((size_t)count * 4);
+
+	printf("\n%d agents, threads=%d\n", count, threads);
+	printf("%-5s %-7s %9s %9s %9s %9s %10s %9s %10s\n", "mode", "path", "ms/tick", "sort", "force", "integr", "neighbors", "speedup", "Magent/s");
+	for (AgentMode mode : kModes)
+	{
+		const AgentParams params = AgentParamsDefault(mode);
+		double scalarMs = 0.0;
+		for (CpuShadePath path : kPaths)
+		{
+			if (!CpuShadePathAvailable(path))
+			{
+				printf("%-5s %-7s %9s\n", AgentModeName(mode), CpuShadePathName(path), "n/a");
+				continue;
+			}
+			const AgentTiming t = MeasureTicks(mode, params, count, path, minSeconds, frame.data());
+			if (path == CpuShadePath::Scalar) scalarMs = t.tick;
+			printf("%-5s %-7s %9.2f %9.2f %9.2f %9.2f %10.1f %8.2fx %10.1f\n", AgentModeName(mode), CpuShadePathName(path), t.tick,
+				t.sort, t.force, t.integrate, t.neighbors, scalarMs / t.tick, (double)count / t.tick * 1e-3);
+		}
+	}
+
+	// ---- Escalado por threads: bandada, mejor camino ----
+
+	printf("\nscaling (flock, %s):\n", CpuShadePathName(best));
+	printf("%-8s %9s %9s %9s %9s %9s %11s\n", "threads", "ms/tick", "sort", "force", "integr", "speedup", "efficiency");
+	const AgentParams params = AgentParamsDefault(AgentMode::Flocking);
+	double oneThreadMs = 0.0;
+	for (int n = 1; n <= threads; n = n * 2 > threads && n != threads ? threads : n * 2)
+	{
+		ParallelSetThreadLimit(n);
+		const AgentTiming t = MeasureTicks(AgentMode::Flocking, params, count, best, minSeconds, frame.data());
+		if (n == 1) oneThreadMs = t.tick;
+		const double speedup = oneThreadMs / t.tick;
+		printf("%-8d %9.2f %9.2f %9.2f %9.2f %8.2fx %10.0f%%\n", n, t.tick, t.sort, t.force, t.integrate, speedup, speedup / n * 100.0);
+	}
+	ParallelSetThreadLimit(maxThreads);
+
+	return failures ? 1 : 0;
+}
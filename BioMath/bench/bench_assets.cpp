@@ -0,0 +1,439 @@
+#include "bench.h"
+
+#include "asset_pack.h"
+#include "lz4_block.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+// Paquete de assets (asset_pack.h) contra archivos sueltos, con ~300 assets sinteticos de tres
+// tipos: texto (como los shaders), tablas suaves de floats (curvas, envolventes) y datos tipo
+// ruido (lattices, muestras). Se escriben sueltos, en un paquete sin comprimir y en uno con LZ4.
+//
+// Para cada forma de carga, ms en frio (sin las paginas en el cache del sistema; solo Linux, con
+// posix_fadvise DONTNEED) y en caliente, leyendo todos los bytes de todos los assets:
+//   files      fopen + fread de cada archivo a un buffer propio
+//   pack       AssetPackOpen + los datos desde el mapping, sin copia
+//   pack-lz4   AssetPackOpen + descomprimir las entradas comprimidas
+//   open       solo AssetPackOpen + AssetPackFind de todos los nombres (lo que paga el arranque)
+// y la memoria residente que agrega cada una con todo cargado: privada (buffers propios) o del
+// archivo (paginas del mapping, descartables por el sistema).
+//
+// Verifica que los bytes del paquete sean los de los archivos, el ida y vuelta de LZ4 en cada
+// asset y que un paquete truncado, con la TOC rota o con datos corruptos se rechace.
+//
+// Opciones:
+//   --assets <n>      cantidad de assets (default 300)
+//   --runs <n>        corridas por medicion, se toma la mejor (default 3)
+
+enum class AssetKind
+{
+	Text,
+	Table,
+	Noise,
+};
+
+static const char* const kKindNames[] = { "text", "table", "noise" };
+
+static uint32_t NextRandom(uint32_t* state)
+{
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
+
+// Texto con el vocabulario y la repeticion de un shader.
+static void MakeText(std::vector<uint8_t>* out, size_t bytes, uint32_t seed)
+{
+	static const char* const kWords[] = { "uniform ", "float ", "vec3 ", "vec2 ", "return ", "mix(", "smoothstep(",
+		"noise(", "uv", " * ", " + ", "0.5", "1.0", ");\n", "\t", "color", "time", "// capa\n", "fbm(", "p.xy", ", " };
+	out->clear();
+	while (out->size() < bytes)
+	{
+		const char* w = kWords[NextRandom(&seed) % (sizeof(kWords) / sizeof(kWords[0]))];
+		out->insert(out->end(), w, w + strlen(w));
+	}
+	out->resize(bytes);
+}
+
+// Curva suave muestreada en floats.
+static void MakeTable(std::vector<uint8_t>* out, size_t bytes, uint32_t seed)
+{
+	const size_t count = bytes / sizeof(float);
+	out->assign(count * sizeof(float), 0);
+	float* values = (float*)out->data();
+	const float f = 1.0f + (float)(seed % 7);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float t = (float)i / (float)count;
+		values[i] = roundf((0.5f + 0.5f * sinf(6.2831853f * f * t)) * 4096.0f) / 4096.0f;
+	}
+}
+
+static void MakeNoise(std::vector<uint8_t>* out, size_t bytes, uint32_t seed)
+{
+	out->resize(bytes);
+	for (size_t i = 0; i < bytes; ++i)
+		(*out)[i] = (uint8_t)(NextRandom(&seed) >> 24);
+}
+
+// Bytes residentes del proceso: privados y respaldados por archivos (mappings).
+static void ResidentBytes(uint64_t* privateBytes, uint64_t* fileBytes)
+{
+	*privateBytes = 0;
+	*fileBytes = 0;
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS_EX counters = {};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&counters, sizeof(counters)))
+	{
+		*privateBytes = counters.PrivateUsage;
+		*fileBytes = counters.WorkingSetSize > counters.PrivateUsage ? counters.WorkingSetSize - counters.PrivateUsage : 0;
+	}
+#else
+	// statm: size resident shared ... en paginas; "shared" son las paginas de archivos.
+	FILE* f = fopen("/proc/self/statm", "r");
+	if (!f) return;
+	unsigned long long size = 0, resident = 0, shared = 0;
+	if (fscanf(f, "%llu %llu %llu", &size, &resident, &shared) == 3)
+	{
+		const uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+		*privateBytes = (resident - shared) * page;
+		*fileBytes = shared * page;
+	}
+	fclose(f);
+#endif
+}
+
+// Saca el archivo del cache del sistema. false si no se puede (Windows, o el sistema no lo hace).
+static bool EvictFile(const std::string& path)
+{
+#ifdef _WIN32
+	(void)path;
+	return false;
+#else
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	fdatasync(fd);
+	const bool ok = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(fd);
+	return ok;
+#endif
+}
+
+static bool WriteFile(const std::string& path, const void* data, size_t bytes)
+{
+	FILE* f = fopen(path.c_str(), "wb");
+	if (!f) return false;
+	const bool ok = fwrite(data, 1, bytes, f) == bytes;
+	return fclose(f) == 0 && ok;
+}
+
+static bool ReadFile(const std::string& path, std::vector<uint8_t>* out)
+{
+	FILE* f = fopen(path.c_str(), "rb");
+	if (!f) return false;
+	fseek(f, 0, SEEK_END);
+	const long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	out->resize(size > 0 ? (size_t)size : 0);
+	const bool ok = size >= 0 && fread(out->data(), 1, out->size(), f) == out->size();
+	fclose(f);
+	return ok;
+}
+
+struct LoadResult
+{
+	double ms = 0.0;
+	uint64_t sum = 0;                // checksum combinado: las formas de carga tienen que coincidir
+	uint64_t privateBytes = 0;       // residente agregado con todo cargado
+	uint64_t fileBytes = 0;
+	bool ok = true;
+};
+
+enum class LoadMode
+{
+	Files,
+	Pack,
+	PackLz4,
+	Open,
+};
+
+static LoadResult Load(LoadMode mode, const std::vector<AssetPackSource>& assets, const std::string& looseDir,
+	const std::string& packPath)
+{
+	LoadResult r;
+	uint64_t private0, file0;
+	ResidentBytes(&private0, &file0);
+
+	const double start = BenchNowSeconds();
+	std::vector<std::vector<uint8_t>> buffers(assets.size());
+	AssetPack pack;
+	if (mode == LoadMode::Files)
+	{
+		for (size_t i = 0; i < assets.size(); ++i)
+		{
+			r.ok = r.ok && ReadFile(looseDir + "/" + std::to_string(i), &buffers[i]);
+			r.sum += AssetPackChecksum(buffers[i].data(), buffers[i].size());
+		}
+	}
+	else
+	{
+		std::string error;
+		r.ok = AssetPackOpen(packPath.c_str(), &pack, &error);
+		for (size_t i = 0; i < assets.size() && r.ok; ++i)
+		{
+			const int index = AssetPackFind(pack, assets[i].name.c_str());
+			if (index < 0)
+			{
+				r.ok = false;
+				break;
+			}
+			if (mode == LoadMode::Open) continue;
+			const uint8_t* data = AssetPackData(pack, index, &buffers[i]);
+			r.ok = data != nullptr;
+			if (data) r.sum += AssetPackChecksum(data, (size_t)pack.entries[index].bytes);
+		}
+	}
+	r.ms = (BenchNowSeconds() - start) * 1e3;
+
+	uint64_t private1, file1;
+	ResidentBytes(&private1, &file1);
+	r.privateBytes = private1 > private0 ? private1 - private0 : 0;
+	r.fileBytes = file1 > file0 ? file1 - file0 : 0;
+	AssetPackClose(&pack);
+	return r;
+}
+
+// Copia el paquete con 'damage' aplicado y comprueba que abrirlo o verificarlo falle.
+static bool RejectsDamaged(const std::vector<uint8_t>& pack, const std::string& path, const char* what,
+	void (*damage)(std::vector<uint8_t>*))
+{
+	std::vector<uint8_t> bytes = pack;
+	damage(&bytes);
+	bool rejected = !WriteFile(path, bytes.data(), bytes.size());
+	if (!rejected)
+	{
+		AssetPack opened;
+		std::string error;
+		if (!AssetPackOpen(path.c_str(), &opened, &error))
+		{
+			rejected = true;
+		}
+		else
+		{
+			std::vector<uint8_t> storage;
+			for (int i = 0; i < opened.count && !rejected; ++i)
+				rejected = !AssetPackVerify(opened, i, &storage);
+			AssetPackClose(&opened);
+		}
+	}
+	printf("  %-26s %s\n", what, rejected ? "rejected" : "ACCEPTED");
+	remove(path.c_str());
+	return rejected;
+}
+
+int BenchAssets(int argc, char** argv)
+{
+	const int count = BenchArgInt(argc, argv, "--assets", 300);
+	const int runs = BenchArgInt(argc, argv, "--runs", 3);
+	if (count < 1 || runs < 1)
+	{
+		fprintf(stderr, "assets: --assets and --runs must be >= 1\n");
+		return 1;
+	}
+
+	namespace fs = std::filesystem;
+	std::error_code ec;
+	const fs::path root = fs::temp_directory_path(ec) / "biomath-bench-assets";
+	fs::remove_all(root, ec);
+	fs::create_directories(root / "loose", ec);
+	if (ec)
+	{
+		fprintf(stderr, "assets: cannot create %s: %s\n", root.string().c_str(), ec.message().c_str());
+		return 1;
+	}
+	const std::string looseDir = (root / "loose").string();
+	const std::string rawPath = (root / "raw.bmpak").string();
+	const std::string lz4Path = (root / "lz4.bmpak").string();
+
+	// Tamanios de 2 KB a ~256 KB, un tercio de cada tipo.
+	std::vector<AssetPackSource> assets(count);
+	uint64_t totalBytes = 0;
+	uint32_t rng = 0x2545F491u;
+	int failures = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		const AssetKind kind = (AssetKind)(i % 3);
+		const size_t bytes = (size_t)2048 << (NextRandom(&rng) % 8);
+		const uint32_t seed = NextRandom(&rng) | 1;
+		AssetPackSource& a = assets[i];
+		a.name = std::string(kKindNames[(int)kind]) + "/" + std::to_string(i);
+		if (kind == AssetKind::Text) MakeText(&a.data, bytes, seed);
+		else if (kind == AssetKind::Table) MakeTable(&a.data, bytes, seed);
+		else MakeNoise(&a.data, bytes, seed);
+		totalBytes += a.data.size();
+		if (!WriteFile(looseDir + "/" + std::to_string(i), a.data.data(), a.data.size()))
+		{
+			fprintf(stderr, "assets: cannot write to %s\n", looseDir.c_str());
+			return 1;
+		}
+	}
+
+	AssetPackWriteOptions rawOptions;
+	AssetPackWriteOptions lz4Options;
+	lz4Options.lz4 = true;
+	AssetPackWriteStats rawStats, lz4Stats;
+	std::string error;
+	const double writeStart = BenchNowSeconds();
+	if (!AssetPackWrite(rawPath.c_str(), assets, rawOptions, &rawStats, &error))
+	{
+		fprintf(stderr, "assets: %s\n", error.c_str());
+		return 1;
+	}
+	const double rawWriteMs = (BenchNowSeconds() - writeStart) * 1e3;
+	const double lz4Start = BenchNowSeconds();
+	if (!AssetPackWrite(lz4Path.c_str(), assets, lz4Options, &lz4Stats, &error))
+	{
+		fprintf(stderr, "assets: %s\n", error.c_str());
+		return 1;
+	}
+	const double lz4WriteMs = (BenchNowSeconds() - lz4Start) * 1e3;
+
+	printf("assets: %d assets, %.2f MB in %s\n", count, totalBytes / 1048576.0, root.string().c_str());
+	printf("  raw pack  %.2f MB, written in %.1f ms\n", rawStats.fileBytes / 1048576.0, rawWriteMs);
+	printf("  lz4 pack  %.2f MB (%d/%d entries compressed), written in %.1f ms\n\n", lz4Stats.fileBytes / 1048576.0,
+		lz4Stats.compressed, lz4Stats.entries, lz4WriteMs);
+
+	// LZ4 por tipo: ratio y MB/s de descompresion, con ida y vuelta exacta.
+	printf("%-6s %8s %11s %11s %s\n", "kind", "ratio", "comp MB/s", "decomp MB/s", "roundtrip");
+	for (int kind = 0; kind < 3; ++kind)
+	{
+		uint64_t raw = 0, stored = 0;
+		double compSeconds = 0.0, decompSeconds = 0.0;
+		bool exact = true;
+		std::vector<uint8_t> compressed, restored;
+		for (int i = kind; i < count; i += 3)
+		{
+			const std::vector<uint8_t>& data = assets[i].data;
+			compressed.resize(Lz4CompressBound(data.size()));
+			double t = BenchNowSeconds();
+			const size_t n = Lz4Compress(data.data(), data.size(), compressed.data(), compressed.size());
+			compSeconds += BenchNowSeconds() - t;
+			restored.assign(data.size(), 0);
+			t = BenchNowSeconds();
+			const bool ok = n > 0 && Lz4Decompress(compressed.data(), n, restored.data(), restored.size());
+			decompSeconds += BenchNowSeconds() - t;
+			exact = exact && ok && restored == data;
+			raw += data.size();
+			stored += n;
+		}
+		printf("%-6s %7.2fx %11.0f %11.0f %s\n", kKindNames[kind], stored ? (double)raw / (double)stored : 0.0,
+			raw / 1048576.0 / compSeconds, raw / 1048576.0 / decompSeconds, exact ? "exact" : "MISMATCH");
+		if (!exact) ++failures;
+	}
+
+	// Cargas: la mejor de --runs, en frio y en caliente.
+	struct LoadCase
+	{
+		const char* name;
+		LoadMode mode;
+		const std::string* pack;
+	};
+	const LoadCase cases[] = {
+		{ "files", LoadMode::Files, nullptr },
+		{ "pack", LoadMode::Pack, &rawPath },
+		{ "pack-lz4", LoadMode::PackLz4, &lz4Path },
+		{ "open", LoadMode::Open, &rawPath },
+	};
+	auto evictAll = [&]()
+	{
+		bool ok = EvictFile(rawPath) && EvictFile(lz4Path);
+		for (int i = 0; i < count && ok; ++i)
+			ok = EvictFile(looseDir + "/" + std::to_string(i));
+		return ok;
+	};
+	const bool canEvict = evictAll();
+
+	printf("\n%-9s %10s %10s %12s %12s %s\n", "load", "cold ms", "warm ms", "private MB", "file MB", "bytes");
+	uint64_t referenceSum = 0;
+	for (const LoadCase& c : cases)
+	{
+		LoadResult cold, warm;
+		cold.ms = warm.ms = 1e30;
+		for (int run = 0; run < runs; ++run)
+		{
+			if (canEvict)
+			{
+				evictAll();
+				const LoadResult r = Load(c.mode, assets, looseDir, c.pack ? *c.pack : std::string());
+				if (r.ms < cold.ms) cold = r;
+			}
+			const LoadResult r = Load(c.mode, assets, looseDir, c.pack ? *c.pack : std::string());
+			if (r.ms < warm.ms) warm = r;
+		}
+
+		const char* match = "-";
+		if (c.mode == LoadMode::Files) referenceSum = warm.sum;
+		if (c.mode != LoadMode::Open)
+		{
+			const bool same = warm.ok && warm.sum == referenceSum && (!canEvict || cold.sum == referenceSum);
+			match = c.mode == LoadMode::Files ? "ref" : same ? "match" : "MISMATCH";
+			if (!same) ++failures;
+		}
+		else if (!warm.ok)
+		{
+			match = "FAIL";
+			++failures;
+		}
+		char coldText[32] = "n/a";
+		if (canEvict) snprintf(coldText, sizeof(coldText), "%.2f", cold.ms);
+		printf("%-9s %10s %10.2f %12.2f %12.2f %s\n", c.name, coldText, warm.ms, warm.privateBytes / 1048576.0,
+			warm.fileBytes / 1048576.0, match);
+	}
+	if (!canEvict) printf("(cold loads need posix_fadvise: not available here)\n");
+
+	// Rechazo de paquetes danados.
+	printf("\ndamaged packs:\n");
+	std::vector<uint8_t> packBytes;
+	if (!ReadFile(lz4Path, &packBytes))
+	{
+		fprintf(stderr, "assets: cannot read %s\n", lz4Path.c_str());
+		return 1;
+	}
+	const std::string damagedPath = (root / "damaged.bmpak").string();
+	const bool rejected =
+		RejectsDamaged(packBytes, damagedPath, "truncated", [](std::vector<uint8_t>* b) { b->resize(b->size() - 100); }) &&
+		RejectsDamaged(packBytes, damagedPath, "bad magic", [](std::vector<uint8_t>* b) { (*b)[0] ^= 0xFF; }) &&
+		RejectsDamaged(packBytes, damagedPath, "entry offset out of file", [](std::vector<uint8_t>* b)
+		{
+			AssetPackEntry* e = (AssetPackEntry*)(b->data() + sizeof(AssetPackHeader));
+			e->offset = (uint64_t)b->size() + kAssetPackAlign;
+		}) &&
+		RejectsDamaged(packBytes, damagedPath, "flipped data byte", [](std::vector<uint8_t>* b) { (*b)[b->size() - 200] ^= 0x40; }) &&
+		RejectsDamaged(packBytes, damagedPath, "zeroed data block", [](std::vector<uint8_t>* b)
+		{
+			const AssetPackHeader* h = (const AssetPackHeader*)b->data();
+			memset(b->data() + h->dataOffset, 0, (size_t)std::min<uint64_t>(4096, b->size() - h->dataOffset));
+		});
+	if (!rejected) ++failures;
+
+	fs::remove_all(root, ec);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,95 @@
+#include "bench.h"
+
+#include "cpu_renderer.h"
+#include "parallel.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+// MPix/s del renderer de CPU a 720p/1080p/4K para cada camino disponible.
+// Ademas verifica que los caminos SIMD den exactamente los mismos bytes que el escalar.
+//
+// Opciones:
+//   --time <s>          tiempo de animacion a renderizar (default 12.5)
+//   --min-seconds <s>   tiempo minimo medido por caso (default 0.5)
+//   --threads <n>       limitar threads (default: todos)
+
+struct Resolution
+{
+	const char* name;
+	int width;
+	int height;
+};
+
+static const Resolution kResolutions[] = {
+	{ "720p",  1280,  720 },
+	{ "1080p", 1920, 1080 },
+	{ "4K",    3840, 2160 },
+};
+
+static const CpuShadePath kPaths[] = { CpuShadePath::Scalar, CpuShadePath::SSE2, CpuShadePath::AVX2 };
+
+// Renderiza frames hasta juntar 'minSeconds' y devuelve los segundos por frame.
+static double MeasureFrame(uint8_t* rgba, int w, int h, float t, CpuShadePath path, double minSeconds)
+{
+	CpuRenderBackground(rgba, w, h, t, path); // warm-up (paginas, caches, pool de threads)
+
+	int frames = 0;
+	const double start = BenchNowSeconds();
+	double elapsed = 0.0;
+	do
+	{
+		CpuRenderBackground(rgba, w, h, t, path);
+		++frames;
+		elapsed = BenchNowSeconds() - start;
+	} while (elapsed < minSeconds);
+
+	return elapsed / frames;
+}
+
+int BenchCpuRender(int argc, char** argv)
+{
+	const float t = (float)BenchArgFloat(argc, argv, "--time", 12.5);
+	const double minSeconds = BenchArgFloat(argc, argv, "--min-seconds", 0.5);
+	ParallelSetThreadLimit(BenchArgInt(argc, argv, "--threads", 0));
+
+	printf("cpu-render: t=%.3f threads=%d\n\n", t, ParallelThreadCount());
+	printf("%-6s %-7s %10s %10s %9s %s\n", "res", "path", "ms/frame", "MPix/s", "speedup", "match");
+
+	int failures = 0;
+	for (const Resolution& res : kResolutions)
+	{
+		const size_t bytes = (size_t)res.width * (size_t)res.height * 4;
+		std::vector<uint8_t> reference(bytes);
+		std::vector<uint8_t> image(bytes);
+		const double mpix = (double)res.width * (double)res.height * 1e-6;
+
+		double scalarSeconds = 0.0;
+		for (CpuShadePath path : kPaths)
+		{
+			if (!CpuShadePathAvailable(path))
+			{
+				printf("%-6s %-7s %10s\n", res.name, CpuShadePathName(path), "n/a");
+				continue;
+			}
+
+			uint8_t* dst = path == CpuShadePath::Scalar ? reference.data() : image.data();
+			const double seconds = MeasureFrame(dst, res.width, res.height, t, path, minSeconds);
+			if (path == CpuShadePath::Scalar) scalarSeconds = seconds;
+
+			const char* match = "ref";
+			if (path != CpuShadePath::Scalar)
+			{
+				const CpuImageDiff diff = CpuCompareImages(reference.data(), image.data(), res.width, res.height, 0);
+				match = diff.pixelsOverTolerance == 0 ? "exact" : "MISMATCH";
+				if (diff.pixelsOverTolerance) ++failures;
+			}
+
+			printf("%-6s %-7s %10.2f %10.1f %8.2fx %s\n", res.name, CpuShadePathName(path),
+				seconds * 1e3, mpix / seconds, scalarSeconds / seconds, match);
+		}
+	}
+
+	return failures ? 1 : 0;
+}
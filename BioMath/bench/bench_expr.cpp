@@ -0,0 +1,285 @@
+#include "bench.h"
+
+#include "expr.h"
+#include "parallel.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Compilador de expresiones (expr.h), por formula:
+//   1. Nodos del arbol vs del grafo optimizado (plegado, CSE) e instrucciones/registros del bytecode.
+//   2. El VM escalar/SSE2/AVX2/AVX-512 da los mismos valores que el interprete del arbol sin
+//      optimizar, en --verify-points puntos al azar (NaN cuenta como igual a NaN).
+//   3. Mpuntos/s de cada camino con un thread, y la ganancia contra el arbol.
+// Despues, potencias con exponentes constantes anidados ((2^2)^2)^2...: pow() arma x*x sobre el
+// mismo nodo, asi que compilar y recorrer el arbol tiene que ser lineal en la profundidad, no
+// exponencial. Y raices de formulas con raices conocidas (ExprFindRoots) contra el valor analitico.
+//
+// Opciones:
+//   --points <n>          puntos por evaluacion medida (default 1048576)
+//   --verify-points <n>   puntos de la verificacion (default 100000)
+//   --expr "<f(x,y,t)>"   solo esa formula
+//   --dump                imprime el GLSL y el bytecode de cada formula
+//   --min-seconds <s>     tiempo minimo medido por caso (default 0.3)
+
+static const ExprPath kPaths[] = { ExprPath::Tree, ExprPath::Scalar, ExprPath::SSE2, ExprPath::AVX2, ExprPath::AVX512 };
+static const char* const kVars[] = { "x", "y", "t" };
+
+static const char* const kFormulas[] = {
+	// Campo del fondo: interferencia de ondas
+	"sin(x*3 + t) * cos(y*2 - t) + 0.5*sin(sqrt(x*x + y*y)*8 - t*2)",
+	// Presa-depredador con respuesta Holling II (lado derecho de la EDO de la presa)
+	"1.2*x*(1 - x/3.5) - 0.4*x*y/(1 + 0.5*x)",
+	// Funcion de Hill con n = 4: pow con exponente constante -> multiplicaciones
+	"x^4/(0.5^4 + x^4) - y^4/(0.5^4 + y^4)",
+	// Dos gaussianas moviles
+	"exp(-((x - 0.3*sin(t))^2 + (y + 0.2)^2)/0.05) - exp(-((x + 0.4)^2 + (y - 0.3*cos(t))^2)/0.08)",
+	// Subexpresiones repetidas a proposito (CSE)
+	"(x*y + sin(x*y)) * (y*x - sin(x*y)) + clamp(x*y, 0, 1) + smoothstep(0, 1, x*y)",
+	// Constantes que se pliegan enteras
+	"x*(2*pi/360)*(1 + 0) + y*(e^2 - e*e + 1) + fract(x*7.5) + step(0.25, y) - mix(x, y, 0.5)^3",
+};
+
+struct RootCase
+{
+	const char* source;
+	float lo, hi;
+	int expected;
+	double roots[8];
+};
+
+static const RootCase kRootCases[] = {
+	{ "x^3 - 2*x - 5", -4.0f, 4.0f, 1, { 2.0945514815423265 } },
+	{ "sin(x)", -10.0f, 10.0f, 7, { -9.42477796076938, -6.283185307179586, -3.141592653589793, 0.0, 3.141592653589793, 6.283185307179586, 9.42477796076938 } },
+	{ "x*x - 2", -3.0f, 3.0f, 2, { -1.4142135623730951, 1.4142135623730951 } },
+	{ "exp(x) - 3", -2.0f, 4.0f, 1, { 1.0986122886681098 } },
+	{ "tanh_like(x)", 0.0f, 0.0f, -1, {} },   // error esperado: nombre desconocido
+};
+
+static bool SameValue(float a, float b)
+{
+	return a == b || (isnan(a) && isnan(b));
+}
+
+static double MeasurePath(const ExprProgram& prog, const ExprInput* inputs, size_t points, float* out, ExprPath path, double minSeconds)
+{
+	ExprEvaluate(prog, inputs, points, out, path);   // warm-up
+	int runs = 0;
+	const double start = BenchNowSeconds();
+	double elapsed = 0.0;
+	do
+	{
+		ExprEvaluate(prog, inputs, points, out, path);
+		++runs;
+		elapsed = BenchNowSeconds() - start;
+	} while (elapsed < minSeconds);
+	return (double)points * runs / elapsed;
+}
+
+// Entradas al azar (LCG fijo): x, y en [-2, 2], t en [0, 10].
+static void FillInputs(std::vector<float>* xs, std::vector<float>* ys, std::vector<float>* ts, size_t n)
+{
+	xs->resize(n);
+	ys->resize(n);
+	ts->resize(n);
+	uint32_t s = 12345;
+	auto next = [&]() { s = s * 1664525u + 1013904223u; return (float)(s >> 8) * (1.0f / 16777216.0f); };
+	for (size_t i = 0; i < n; ++i)
+	{
+		(*xs)[i] = next() * 4.0f - 2.0f;
+		(*ys)[i] = next() * 4.0f - 2.0f;
+		(*ts)[i] = next() * 10.0f;
+	}
+}
+
+static int RunFormula(const char* source, size_t points, size_t verifyPoints, double minSeconds, bool dump)
+{
+	ExprProgram prog;
+	std::string error;
+	if (!ExprCompile(source, kVars, 3, &prog, &error))
+	{
+		printf("  %s\n    compile error: %s\n", source, error.c_str());
+		return 1;
+	}
+
+	const ExprStats& s = prog.stats;
+	printf("  %s\n", source);
+	printf("    nodes %d -> %d (folded %d, simplified %d, cse %d); %d instructions, %d registers (%d constants)\n",
+		s.parsedNodes, s.nodes, s.folded, s.simplified, s.cseHits, (int)prog.code.size(), prog.registers, (int)prog.constants.size());
+	if (dump)
+	{
+		printf("%s", ExprToGlsl(prog, "f").c_str());
+		printf("%s", ExprDisassemble(prog).c_str());
+	}
+
+	int failures = 0;
+	std::vector<float> xs, ys, ts;
+	FillInputs(&xs, &ys, &ts, verifyPoints);
+	ExprInput inputs[3];
+	inputs[0].values = xs.data();
+	inputs[1].values = ys.data();
+	inputs[2].values = ts.data();
+
+	std::vector<float> reference(verifyPoints), out(verifyPoints);
+	ExprEvaluate(prog, inputs, verifyPoints, reference.data(), ExprPath::Tree);
+	for (ExprPath path : kPaths)
+	{
+		if (path == ExprPath::Tree) continue;
+		if (!ExprPathAvailable(path))
+		{
+			printf("    %-6s n/a\n", ExprPathName(path));
+			continue;
+		}
+		ExprEvaluate(prog, inputs, verifyPoints, out.data(), path);
+		size_t mismatches = 0;
+		for (size_t i = 0; i < verifyPoints; ++i)
+			if (!SameValue(out[i], reference[i])) ++mismatches;
+		if (mismatches)
+			printf("    %-6s vs tree: MISMATCH (%zu of %zu)\n", ExprPathName(path), mismatches, verifyPoints);
+		else
+			printf("    %-6s vs tree: exact\n", ExprPathName(path));
+		if (mismatches) ++failures;
+	}
+
+	FillInputs(&xs, &ys, &ts, points);
+	inputs[0].values = xs.data();
+	inputs[1].values = ys.data();
+	inputs[2].values = ts.data();
+	out.resize(points);
+	double treeRate = 0.0;
+	for (ExprPath path : kPaths)
+	{
+		if (!ExprPathAvailable(path)) continue;
+		const double rate = MeasurePath(prog, inputs, points, out.data(), path, minSeconds);
+		if (path == ExprPath::Tree) treeRate = rate;
+		printf("    %-6s %9.1f Mpoints/s  %6.1fx\n", ExprPathName(path), rate * 1e-6, rate / treeRate);
+	}
+	return failures;
+}
+
+// pow(x, ((((2)^2)^2)...)^2) con 'depth' potencias: exponente constante (inf a partir de ~7).
+static std::string NestedPowSource(int depth)
+{
+	std::string exponent = "2";
+	for (int i = 0; i < depth; ++i)
+		exponent = "(" + exponent + ")^2";
+	return "pow(x*0.5 + 0.5, " + exponent + ")";
+}
+
+static int RunNestedPow()
+{
+	static const int kDepths[] = { 10, 20, 40, 90 };
+	const double budgetMs = 50.0;   // sin memo, profundidad 26 ya tardaba segundos
+	const size_t points = 4096;
+	int failures = 0;
+	printf("\nnested constant exponents (compile + %zu tree points, budget %.0f ms each):\n", points, budgetMs);
+
+	std::vector<float> xs(points), reference(points), out(points);
+	for (size_t i = 0; i < points; ++i)
+		xs[i] = (float)i / (float)points * 2.0f - 1.0f;
+	ExprInput inputs[3];
+	inputs[0].values = xs.data();
+
+	for (int depth : kDepths)
+	{
+		const std::string source = NestedPowSource(depth);
+		ExprProgram prog;
+		std::string error;
+		const double start = BenchNowSeconds();
+		const bool compiled = ExprCompile(source.c_str(), kVars, 3, &prog, &error);
+		const double compileMs = (BenchNowSeconds() - start) * 1e3;
+		if (!compiled)
+		{
+			printf("  depth %3d  compile error: %s\n", depth, error.c_str());
+			++failures;
+			continue;
+		}
+		ExprEvaluate(prog, inputs, points, reference.data(), ExprPath::Tree);
+		const double totalMs = (BenchNowSeconds() - start) * 1e3;
+		ExprEvaluate(prog, inputs, points, out.data(), ExprPath::Auto);
+		size_t mismatches = 0;
+		for (size_t i = 0; i < points; ++i)
+			if (!SameValue(out[i], reference[i])) ++mismatches;
+
+		const bool ok = totalMs < budgetMs && mismatches == 0;
+		printf("  depth %3d  %4d tree nodes, compile %.3f ms, compile + tree %.3f ms, vm vs tree %s: %s\n", depth,
+			prog.stats.parsedNodes, compileMs, totalMs, mismatches ? "MISMATCH" : "exact", ok ? "ok" : "FAIL");
+		if (!ok) ++failures;
+	}
+	return failures;
+}
+
+static int RunRoots()
+{
+	int failures = 0;
+	printf("\nroots (4096 samples + batched bisection, auto path):\n");
+	for (const RootCase& c : kRootCases)
+	{
+		ExprProgram prog;
+		std::string error;
+		const bool compiled = ExprCompile(c.source, kVars, 3, &prog, &error);
+		if (c.expected < 0)
+		{
+			printf("  %-16s %s (%s)\n", c.source, compiled ? "compiled: FAIL" : "rejected: ok", compiled ? "" : error.c_str());
+			if (compiled) ++failures;
+			continue;
+		}
+		if (!compiled)
+		{
+			printf("  %-16s compile error: %s\n", c.source, error.c_str());
+			++failures;
+			continue;
+		}
+
+		float roots[16];
+		ExprInput inputs[3];
+		const double start = BenchNowSeconds();
+		const int n = ExprFindRoots(prog, 0, c.lo, c.hi, 4096, inputs, roots, 16);
+		const double ms = (BenchNowSeconds() - start) * 1e3;
+		double maxError = n == c.expected ? 0.0 : INFINITY;
+		for (int i = 0; i < n && i < c.expected; ++i)
+			maxError = fmax(maxError, fabs((double)roots[i] - c.roots[i]) / fmax(1.0, fabs(c.roots[i])));
+		// Unos pocos ulp: float en el muestreo y en la biseccion, mas el error de sin/exp.
+		const bool ok = n == c.expected && maxError < 1e-5;
+		printf("  %-16s %d roots, max rel error %.1e, %.2f ms: %s\n", c.source, n, maxError, ms, ok ? "ok" : "FAIL");
+		if (!ok) ++failures;
+	}
+	return failures;
+}
+
+int BenchExpr(int argc, char** argv)
+{
+	const size_t points = (size_t)BenchArgInt(argc, argv, "--points", 1 << 20);
+	const size_t verifyPoints = (size_t)BenchArgInt(argc, argv, "--verify-points", 100000);
+	const double minSeconds = BenchArgFloat(argc, argv, "--min-seconds", 0.3);
+	const bool dump = BenchHasFlag(argc, argv, "--dump");
+	const char* only = nullptr;
+	for (int i = 0; i + 1 < argc; ++i)
+		if (strcmp(argv[i], "--expr") == 0) only = argv[i + 1];
+
+	// Throughput por core: el escalado por threads es el de ParallelFor, igual que en los otros.
+	ParallelSetThreadLimit(1);
+	printf("expression VM, %zu points per evaluation, 1 thread, auto path: %s\n\n", points, ExprPathName(ExprResolvePath(ExprPath::Auto)));
+
+	int failures = 0;
+	if (only)
+	{
+		failures += RunFormula(only, points, verifyPoints, minSeconds, dump);
+	}
+	else
+	{
+		for (const char* f : kFormulas)
+			failures += RunFormula(f, points, verifyPoints, minSeconds, dump);
+	}
+	ParallelSetThreadLimit(0);
+
+	if (!only) failures += RunNestedPow();
+	if (!only) failures += RunRoots();
+
+	printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
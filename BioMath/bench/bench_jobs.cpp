@@ -0,0 +1,206 @@
+#include "bench.h"
+
+#include "jobs.h"
+#include "parallel.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// Scheduler de jobs (jobs.h) con una carga fork-join sintetica: un arbol binario de jobs sobre
+// --leaves hojas. Cada nodo manda la mitad derecha como hijo, hace la izquierda y espera al hijo
+// ayudando; cada hoja mezcla un hash --work veces. El resultado (la suma de las hojas) se compara
+// con el recorrido serial: una hoja perdida o corrida dos veces lo cambia.
+//
+// Casos:
+//   balanced   todas las hojas cuestan lo mismo
+//   skewed     la primera octava parte de las hojas cuesta 8x (la mitad del trabajo): con un
+//              reparto estatico un thread se llevaria casi todo, con robo se equilibra
+//   fine       hojas de ~50 ns: mide el costo por job del scheduler
+//   parallel   las hojas balanced con ParallelFor (grain 64) en vez del arbol a mano
+//
+// Para cada caso, tiempo, speedup y eficiencia con 1, 2, 4, ... threads (JobSetThreadLimit) y
+// cuantos jobs se robaron.
+//
+// Opciones:
+//   --leaves <n>          hojas del arbol (default 65536)
+//   --work <n>            vueltas del hash por hoja (default 400)
+//   --threads <n>         maximo de threads del escalado (default todos)
+//   --workers <n>         workers del scheduler (default cores - 1). Con mas workers que cores
+//                         no hay speedup, pero ejercita el robo en maquinas chicas.
+//   --min-seconds <s>     tiempo minimo medido por fila (default 0.3)
+
+struct ForkCase
+{
+	const char* name;
+	int workScale;     // divisor de --work (fine)
+	bool skewed;
+	bool parallelFor;
+};
+
+static const ForkCase kCases[] = {
+	{ "balanced", 1, false, false },
+	{ "skewed", 1, true, false },
+	{ "fine", 20, false, false },
+	{ "parallel", 1, false, true },
+};
+
+static uint64_t LeafWork(uint32_t leaf, int iterations)
+{
+	uint64_t h = (uint64_t)leaf * 0x9E3779B97F4A7C15ull + 1;
+	for (int i = 0; i < iterations; ++i)
+	{
+		h ^= h >> 31;
+		h *= 0xBF58476D1CE4E5B9ull;
+		h ^= h >> 29;
+	}
+	return h;
+}
+
+struct ForkTree
+{
+	uint32_t leaves;
+	int work;
+	bool skewed;
+};
+
+static int LeafIterations(const ForkTree& tree, uint32_t leaf)
+{
+	return tree.skewed && leaf < tree.leaves / 8 ? tree.work * 8 : tree.work;
+}
+
+struct ForkNode
+{
+	const ForkTree* tree;
+	uint32_t first;
+	uint32_t count;
+	uint64_t result;
+};
+
+static void RunNode(void* ctx)
+{
+	ForkNode* node = static_cast<ForkNode*>(ctx);
+	const ForkTree& tree = *node->tree;
+	if (node->count == 1)
+	{
+		node->result = LeafWork(node->first, LeafIterations(tree, node->first));
+		return;
+	}
+
+	const uint32_t half = node->count / 2;
+	ForkNode left = { &tree, node->first, half, 0 };
+	ForkNode right = { &tree, node->first + half, node->count - half, 0 };
+	JobCounter children;
+	Job job;
+	job.fn = RunNode;
+	job.ctx = &right;
+	JobSubmit(&job, &children);
+	RunNode(&left);
+	JobWait(&children);
+	node->result = left.result + right.result;
+}
+
+static uint64_t RunSerial(const ForkTree& tree)
+{
+	uint64_t sum = 0;
+	for (uint32_t leaf = 0; leaf < tree.leaves; ++leaf)
+		sum += LeafWork(leaf, LeafIterations(tree, leaf));
+	return sum;
+}
+
+static uint64_t RunForkJoin(const ForkTree& tree)
+{
+	ForkNode root = { &tree, 0, tree.leaves, 0 };
+	RunNode(&root);
+	return root.result;
+}
+
+static uint64_t RunParallelFor(const ForkTree& tree, std::vector<uint64_t>* partial)
+{
+	const int grain = 64;
+	partial->assign((tree.leaves + grain - 1) / grain, 0);
+	uint64_t* sums = partial->data();
+	ParallelFor((int)tree.leaves, grain, [&](int begin, int end)
+	{
+		uint64_t sum = 0;
+		for (int leaf = begin; leaf < end; ++leaf)
+			sum += LeafWork((uint32_t)leaf, LeafIterations(tree, (uint32_t)leaf));
+		sums[begin / grain] = sum;
+	});
+	uint64_t sum = 0;
+	for (uint64_t s : *partial)
+		sum += s;
+	return sum;
+}
+
+// Mejor tiempo de una corrida (segundos) repitiendo hasta minSeconds. 'ok' queda en false si alguna
+// corrida no dio 'expected'.
+static double MeasureCase(const ForkCase& c, const ForkTree& tree, uint64_t expected, double minSeconds, bool* ok)
+{
+	std::vector<uint64_t> partial;
+	double best = 1e30;
+	double total = 0.0;
+	int runs = 0;
+	while (total < minSeconds || runs < 3)
+	{
+		const double start = BenchNowSeconds();
+		const uint64_t result = c.parallelFor ? RunParallelFor(tree, &partial) : RunForkJoin(tree);
+		const double seconds = BenchNowSeconds() - start;
+		if (result != expected) *ok = false;
+		if (seconds < best) best = seconds;
+		total += seconds;
+		++runs;
+	}
+	return best;
+}
+
+int BenchJobs(int argc, char** argv)
+{
+	const uint32_t leaves = (uint32_t)BenchArgInt(argc, argv, "--leaves", 65536);
+	const int work = BenchArgInt(argc, argv, "--work", 400);
+	const double minSeconds = BenchArgFloat(argc, argv, "--min-seconds", 0.3);
+	JobStartWorkers(BenchArgInt(argc, argv, "--workers", -1));
+	const int maxThreads = BenchArgInt(argc, argv, "--threads", 0);
+	const int threads = maxThreads > 0 && maxThreads < JobThreadCount() ? maxThreads : JobThreadCount();
+	if (leaves < 1 || work < 1)
+	{
+		fprintf(stderr, "jobs: --leaves and --work must be >= 1\n");
+		return 1;
+	}
+
+	printf("jobs: fork-join tree of %u leaves, %d threads available (%d workers + caller)\n", leaves, JobThreadCount(), JobThreadCount() - 1);
+
+	int failures = 0;
+	for (const ForkCase& c : kCases)
+	{
+		ForkTree tree;
+		tree.leaves = leaves;
+		tree.work = work / c.workScale > 0 ? work / c.workScale : 1;
+		tree.skewed = c.skewed;
+		const uint64_t expected = RunSerial(tree);
+
+		printf("\n%s (%d hash rounds per leaf%s):\n", c.name, tree.work, c.skewed ? ", first 1/8 of the leaves 8x" : "");
+		printf("%-8s %10s %12s %9s %11s %10s %s\n", "threads", "ms", "ns/leaf", "speedup", "efficiency", "stolen", "");
+
+		double oneThreadSeconds = 0.0;
+		for (int n = 1; n <= threads; n = n * 2 > threads && n != threads ? threads : n * 2)
+		{
+			JobSetThreadLimit(n);
+			bool ok = true;
+			const JobStats before = JobGetStats();
+			const double seconds = MeasureCase(c, tree, expected, minSeconds, &ok);
+			const JobStats after = JobGetStats();
+			if (n == 1) oneThreadSeconds = seconds;
+			const double speedup = oneThreadSeconds / seconds;
+			printf("%-8d %10.3f %12.1f %8.2fx %10.0f%% %10llu %s\n", n, seconds * 1e3, seconds * 1e9 / leaves, speedup,
+				speedup / n * 100.0, after.stolen - before.stolen, ok ? "ok" : "WRONG RESULT");
+			if (!ok) ++failures;
+		}
+		JobSetThreadLimit(0);
+	}
+
+	const JobStats stats = JobGetStats();
+	printf("\nsubmitted %llu jobs, %llu ran inline, %llu stolen, workers slept %llu times\n", stats.submitted, stats.inlined, stats.stolen, stats.sleeps);
+	printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
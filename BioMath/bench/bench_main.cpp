@@ -0,0 +1,72 @@
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct BenchEntry
+{
+	const char* name;
+	const char* help;
+	int (*run)(int argc, char** argv);
+};
+
+static const BenchEntry kBenches[] = {
+	{ "agents", "agentes (bandada/quimiotaxis): grilla vs fuerza bruta, SIMD vs escalar, ms por fase a 1M y escalado", BenchAgents },
+	{ "assets", "paquete de assets: carga en frio/caliente vs archivos sueltos, mapping vs LZ4, memoria residente y rechazo de corruptos", BenchAssets },
+	{ "cpu-render", "renderer de CPU del shader de fondo: MPix/s escalar vs SSE2/AVX2 a 720p/1080p/4K", BenchCpuRender },
+	{ "expr", "expresiones: verificacion del VM contra el arbol, Mpuntos/s escalar/SSE2/AVX2/AVX-512 vs interprete y raices", BenchExpr },
+	{ "jobs", "scheduler de jobs: speedup y eficiencia por cantidad de threads en un arbol fork-join sintetico", BenchJobs },
+	{ "noise-bake", "horneado del lattice de ruido: Mhash/s por camino + verificacion contra el hash analitico", BenchNoiseBake },
+	{ "ode", "ensamble de EDOs (LV/SIR/HH): SIMD vs escalar, precision contra double, ms por tick y escalado", BenchOde },
+	{ "reaction-diffusion", "Gray-Scott: verificacion SIMD vs escalar, Mcell-updates/s por camino y escalado por threads", BenchReactionDiffusion },
+	{ "synth", "sintetizador: carga por voz y voces por core, cola SPSC, --wav render offline de la musica", BenchSynth },
+	{ "text", "texto del HUD: horneado del atlas SDF por threads, verificacion contra el font, layout con y sin cache", BenchText },
+};
+
+bool BenchHasFlag(int argc, char** argv, const char* name)
+{
+	for (int i = 0; i < argc; ++i)
+		if (strcmp(argv[i], name) == 0) return true;
+	return false;
+}
+
+int BenchArgInt(int argc, char** argv, const char* name, int fallback)
+{
+	for (int i = 0; i + 1 < argc; ++i)
+		if (strcmp(argv[i], name) == 0) return atoi(argv[i + 1]);
+	return fallback;
+}
+
+double BenchArgFloat(int argc, char** argv, const char* name, double fallback)
+{
+	for (int i = 0; i + 1 < argc; ++i)
+		if (strcmp(argv[i], name) == 0) return atof(argv[i + 1]);
+	return fallback;
+}
+
+static void PrintUsage()
+{
+	printf("usage: BioMathBench <bench> [options]\n\n");
+	for (const BenchEntry& b : kBenches)
+		printf("  %-18s %s\n", b.name, b.help);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	for (const BenchEntry& b : kBenches)
+	{
+		if (strcmp(argv[1], b.name) == 0)
+			return b.run(argc - 2, argv + 2);
+	}
+
+	fprintf(stderr, "unknown bench '%s'\n\n", argv[1]);
+	PrintUsage();
+	return 1;
+}
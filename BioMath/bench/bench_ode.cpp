@@ -0,0 +1,234 @@
+#include "bench.h"
+
+#include "ode_ensemble.h"
+#include "parallel.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Ensamble de EDOs (ode_ensemble.h), por modelo:
+//   1. SSE2/AVX2 dan los mismos bits (y los mismos pasos aceptados/rechazados) que el escalar.
+//   2. Precision de RK4 y RK45 en float contra la referencia en double (RK4 con dt/8): error de
+//      las variables del grafico relativo a su rango, maximo y RMS sobre todos los sistemas.
+//   3. ms por tick de simulacion (timePerTick del modelo) con --systems sistemas, por metodo y camino.
+// Al final, el escalado por threads del mejor camino con el modelo mas caro (hh, RK4).
+//
+// Opciones:
+//   --systems <n>         sistemas medidos (default 100000)
+//   --verify-systems <n>  sistemas de la verificacion (default 2048)
+//   --verify-ticks <n>    ticks antes de comparar (default 240: 2 s a 120 Hz)
+//   --model <name>        solo ese modelo (lv, sir, hh)
+//   --min-seconds <s>     tiempo minimo medido por caso (default 0.3)
+//   --threads <n>         maximo de threads del escalado (default: todos)
+
+static const CpuShadePath kPaths[] = { CpuShadePath::Scalar, CpuShadePath::SSE2, CpuShadePath::AVX2 };
+static const OdeMethod kMethods[] = { OdeMethod::RK4, OdeMethod::RK45 };
+
+// Error maximo tolerado (relativo al rango del grafico). HH es el mas exigente: durante un spike V
+// cambia ~100 mV en ~1 ms y un error chico en la fase se ve grande en V (medido: ~7e-4 con RK4,
+// ~3e-4 con RK45 a la tolerancia por defecto; LV y SIR quedan en ~1e-6).
+static const double kMaxError = 5e-3;
+static const int kReferenceSubdivisions = 8;
+
+static void RunTicks(OdeEnsemble* ens, int ticks, CpuShadePath path)
+{
+	const float duration = OdeModelGetInfo(ens->model).timePerTick;
+	for (int t = 0; t < ticks; ++t) OdeEnsembleAdvance(ens, duration, path);
+}
+
+// Segundos por tick.
+static double MeasureTicks(OdeEnsemble* ens, CpuShadePath path, double minSeconds)
+{
+	OdeEnsembleReset(ens);
+	RunTicks(ens, 2, path); // warm-up
+
+	int ticks = 0;
+	const double start = BenchNowSeconds();
+	double elapsed = 0.0;
+	do
+	{
+		RunTicks(ens, 1, path);
+		++ticks;
+		elapsed = BenchNowSeconds() - start;
+	} while (elapsed < minSeconds);
+
+	return elapsed / ticks;
+}
+
+struct OdeError
+{
+	double max = 0.0;
+	double rms = 0.0;
+	bool finite = true;
+};
+
+static OdeError CompareToReference(const OdeEnsemble& ens, const OdeReference& ref)
+{
+	const OdeModelInfo& info = OdeModelGetInfo(ens.model);
+	const int vars[2] = { info.plotX, info.plotY };
+	const size_t stride = (size_t)ens.stride;
+
+	OdeError e;
+	double sum = 0.0;
+	for (int a = 0; a < 2; ++a)
+	{
+		const double range = (double)info.plotMax[a] - (double)info.plotMin[a];
+		for (int i = 0; i < ens.count; ++i)
+		{
+			const size_t k = (size_t)vars[a] * stride + (size_t)i;
+			if (!isfinite(ens.y[k])) e.finite = false;
+			const double d = fabs((double)ens.y[k] - ref.y[k]) / range;
+			if (d > e.max) e.max = d;
+			sum += d * d;
+		}
+	}
+	e.rms = sqrt(sum / (2.0 * (double)ens.count));
+	return e;
+}
+
+static int VerifyModel(OdeModel model, int systems, int ticks)
+{
+	const OdeModelInfo& info = OdeModelGetInfo(model);
+	int failures = 0;
+
+	OdeEnsemble base;
+	OdeEnsembleInit(&base, model, OdeMethod::RK4, systems);
+	OdeReference ref;
+	OdeReferenceInit(&ref, base);
+	const double start = BenchNowSeconds();
+	for (int t = 0; t < ticks; ++t) OdeReferenceAdvance(&ref, (double)info.timePerTick, kReferenceSubdivisions);
+	printf("  %-4s t=%.3g, %d systems, double reference in %.2f s\n", info.name, (double)ticks * info.timePerTick, systems,
+		BenchNowSeconds() - start);
+
+	for (OdeMethod method : kMethods)
+	{
+		OdeEnsemble scalar;
+		OdeEnsembleInit(&scalar, model, method, systems);
+		RunTicks(&scalar, ticks, CpuShadePath::Scalar);
+
+		const OdeError err = CompareToReference(scalar, ref);
+		const bool accurate = err.finite && err.max <= kMaxError;
+		printf("    %-5s vs reference: max %.2e rms %.2e (limit %.0e) %s; steps: %llu accepted, %llu rejected\n",
+			OdeMethodName(method), err.max, err.rms, kMaxError, accurate ? "ok" : "FAIL",
+			(unsigned long long)scalar.accepted, (unsigned long long)scalar.rejected);
+		if (!accurate) ++failures;
+
+		for (CpuShadePath path : kPaths)
+		{
+			if (path == CpuShadePath::Scalar) continue;
+			if (!CpuShadePathAvailable(path))
+			{
+				printf("    %-5s %-6s n/a\n", OdeMethodName(method), CpuShadePathName(path));
+				continue;
+			}
+			OdeEnsemble ens;
+			OdeEnsembleInit(&ens, model, method, systems);
+			RunTicks(&ens, ticks, path);
+
+			const bool exact = memcmp(ens.y.data(), scalar.y.data(), ens.y.size() * sizeof(float)) == 0 &&
+				memcmp(ens.h.data(), scalar.h.data(), ens.h.size() * sizeof(float)) == 0 &&
+				ens.accepted == scalar.accepted && ens.rejected == scalar.rejected;
+			printf("    %-5s %-6s vs scalar: %s\n", OdeMethodName(method), CpuShadePathName(path), exact ? "exact" : "MISMATCH");
+			if (!exact) ++failures;
+		}
+	}
+	return failures;
+}
+
+int BenchOde(int argc, char** argv)
+{
+	const int systems = BenchArgInt(argc, argv, "--systems", 100000);
+	const int verifySystems = BenchArgInt(argc, argv, "--verify-systems", 2048);
+	const int verifyTicks = BenchArgInt(argc, argv, "--verify-ticks", 240);
+	const double minSeconds = BenchArgFloat(argc, argv, "--min-seconds", 0.3);
+	const int maxThreads = BenchArgInt(argc, argv, "--threads", 0);
+
+	bool selected[kOdeModelCount];
+	for (bool& s : selected) s = true;
+	for (int i = 0; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--model") != 0) continue;
+		OdeModel model;
+		if (!OdeModelFind(argv[i + 1], &model))
+		{
+			fprintf(stderr, "ode: unknown model '%s'\n", argv[i + 1]);
+			return 1;
+		}
+		for (int m = 0; m < kOdeModelCount; ++m) selected[m] = m == (int)model;
+	}
+	if (systems < 1 || verifySystems < 1 || verifyTicks < 1)
+	{
+		fprintf(stderr, "ode: --systems, --verify-systems and --verify-ticks must be >= 1\n");
+		return 1;
+	}
+
+	ParallelSetThreadLimit(maxThreads);
+	const int threads = ParallelThreadCount();
+
+	int failures = 0;
+
+	// ---- Verificacion: precision y mismos bits ----
+
+	printf("ode: verify (%d ticks)\n", verifyTicks);
+	for (int m = 0; m < kOdeModelCount; ++m)
+		if (selected[m]) failures += VerifyModel((OdeModel)m, verifySystems, verifyTicks);
+
+	// ---- Throughput: ms por tick con todos los threads ----
+
+	printf("\n%d systems, threads=%d\n", systems, threads);
+	printf("%-5s %-6s %-7s %10s %14s %9s\n", "model", "method", "path", "ms/tick", "Msys-tick/s", "speedup");
+
+	CpuShadePath best = CpuShadePath::Scalar;
+	double bestSeconds = 0.0;
+	for (int m = 0; m < kOdeModelCount; ++m)
+	{
+		if (!selected[m]) continue;
+		for (OdeMethod method : kMethods)
+		{
+			OdeEnsemble ens;
+			OdeEnsembleInit(&ens, (OdeModel)m, method, systems);
+			double scalarSeconds = 0.0;
+			for (CpuShadePath path : kPaths)
+			{
+				if (!CpuShadePathAvailable(path))
+				{
+					printf("%-5s %-6s %-7s %10s\n", kOdeModels[m].name, OdeMethodName(method), CpuShadePathName(path), "n/a");
+					continue;
+				}
+				const double seconds = MeasureTicks(&ens, path, minSeconds);
+				if (path == CpuShadePath::Scalar) scalarSeconds = seconds;
+				if ((OdeModel)m == OdeModel::HodgkinHuxley && method == OdeMethod::RK4 && (bestSeconds == 0.0 || seconds < bestSeconds))
+				{
+					bestSeconds = seconds;
+					best = path;
+				}
+				printf("%-5s %-6s %-7s %10.3f %14.2f %8.2fx\n", kOdeModels[m].name, OdeMethodName(method), CpuShadePathName(path),
+					seconds * 1e3, (double)systems / seconds * 1e-6, scalarSeconds / seconds);
+			}
+		}
+	}
+
+	// ---- Escalado por threads: hh, RK4, mejor camino ----
+
+	if (selected[(int)OdeModel::HodgkinHuxley])
+	{
+		printf("\nscaling (hh, rk4, %s):\n", CpuShadePathName(best));
+		printf("%-8s %10s %14s %9s %11s\n", "threads", "ms/tick", "Msys-tick/s", "speedup", "efficiency");
+
+		OdeEnsemble ens;
+		OdeEnsembleInit(&ens, OdeModel::HodgkinHuxley, OdeMethod::RK4, systems);
+		double oneThreadSeconds = 0.0;
+		for (int n = 1; n <= threads; n = n * 2 > threads && n != threads ? threads : n * 2)
+		{
+			ParallelSetThreadLimit(n);
+			const double seconds = MeasureTicks(&ens, best, minSeconds);
+			if (n == 1) oneThreadSeconds = seconds;
+			const double speedup = oneThreadSeconds / seconds;
+			printf("%-8d %10.3f %14.2f %8.2fx %10.0f%%\n", n, seconds * 1e3, (double)systems / seconds * 1e-6, speedup, speedup / n * 100.0);
+		}
+		ParallelSetThreadLimit(maxThreads);
+	}
+
+	return failures ? 1 : 0;
+}
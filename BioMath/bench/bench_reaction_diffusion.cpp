@@ -0,0 +1,170 @@
+#include "bench.h"
+
+#include "parallel.h"
+#include "reaction_diffusion.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+// Paso de reaccion-difusion (reaction_diffusion.h): verifica que SSE2/AVX2 den los mismos bits que
+// el escalar despues de varios pasos (y la cuantizacion), mide millones de celdas actualizadas por
+// segundo por camino con todos los threads, y despues el escalado del mejor camino por cantidad de
+// threads (1, 2, 4, ... hasta todos).
+//
+// Opciones:
+//   --size <n>          lado de la grilla medida, multiplo de 16 (default 2048)
+//   --verify-size <n>   lado de la grilla de la verificacion (default 512)
+//   --verify-steps <n>  pasos antes de comparar (default 200)
+//   --min-seconds <s>   tiempo minimo medido por caso (default 0.5)
+//   --threads <n>       maximo de threads del escalado (default: todos)
+//   --preset <name>     patron (default el primero de kRdPresets)
+
+static const CpuShadePath kPaths[] = { CpuShadePath::Scalar, CpuShadePath::SSE2, CpuShadePath::AVX2 };
+
+// Segundos por paso.
+static double MeasureSteps(RdGrid* grid, const RdParams& params, CpuShadePath path, double minSeconds)
+{
+	RdStep(grid, params, 2, path); // warm-up
+
+	int steps = 0;
+	const double start = BenchNowSeconds();
+	double elapsed = 0.0;
+	do
+	{
+		RdStep(grid, params, 1, path);
+		++steps;
+		elapsed = BenchNowSeconds() - start;
+	} while (elapsed < minSeconds);
+
+	return elapsed / steps;
+}
+
+static bool SameBits(const RdGrid& a, const RdGrid& b)
+{
+	return memcmp(a.u.data(), b.u.data(), a.u.size() * sizeof(float)) == 0 &&
+		memcmp(a.v.data(), b.v.data(), a.v.size() * sizeof(float)) == 0;
+}
+
+int BenchReactionDiffusion(int argc, char** argv)
+{
+	const int size = BenchArgInt(argc, argv, "--size", 2048);
+	const int verifySize = BenchArgInt(argc, argv, "--verify-size", 512);
+	const int verifySteps = BenchArgInt(argc, argv, "--verify-steps", 200);
+	const double minSeconds = BenchArgFloat(argc, argv, "--min-seconds", 0.5);
+	const int maxThreads = BenchArgInt(argc, argv, "--threads", 0);
+
+	RdParams params;
+	for (int i = 0; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--preset") != 0) continue;
+		const int preset = RdPresetFind(argv[i + 1]);
+		if (preset < 0)
+		{
+			fprintf(stderr, "reaction-diffusion: unknown preset '%s'\n", argv[i + 1]);
+			return 1;
+		}
+		params.feed = kRdPresets[preset].feed;
+		params.kill = kRdPresets[preset].kill;
+	}
+
+	ParallelSetThreadLimit(maxThreads);
+	const int threads = ParallelThreadCount();
+
+	RdGrid grid, reference;
+	if (!RdGridInit(&grid, size, size) || !RdGridInit(&reference, verifySize, verifySize))
+	{
+		fprintf(stderr, "reaction-diffusion: sizes must be multiples of 16 and >= %d\n", kRdMinSize);
+		return 1;
+	}
+
+	int failures = 0;
+
+	// ---- Verificacion: mismos bits que el escalar ----
+
+	printf("reaction-diffusion: verify %dx%d x %d steps (F=%.4f k=%.4f)\n", verifySize, verifySize, verifySteps, params.feed, params.kill);
+	RdGridSeed(&reference, 1);
+	RdStep(&reference, params, verifySteps, CpuShadePath::Scalar);
+
+	std::vector<uint8_t> refTexels((size_t)verifySize * (size_t)verifySize);
+	std::vector<uint8_t> texels(refTexels.size());
+	RdQuantize(reference, refTexels.data(), CpuShadePath::Scalar);
+
+	double sumV = 0.0;
+	bool finite = true;
+	for (size_t i = 0; i < reference.v.size(); ++i)
+	{
+		sumV += reference.v[i];
+		if (!isfinite(reference.u[i]) || !isfinite(reference.v[i])) finite = false;
+	}
+	const double meanV = sumV / (double)reference.v.size();
+	printf("  scalar: mean V %.4f %s\n", meanV, finite && meanV > 1e-4 ? "ok" : "FAIL (degenerate)");
+	if (!finite || meanV <= 1e-4) ++failures;
+
+	for (CpuShadePath path : kPaths)
+	{
+		if (path == CpuShadePath::Scalar) continue;
+		if (!CpuShadePathAvailable(path))
+		{
+			printf("  %-6s n/a\n", CpuShadePathName(path));
+			continue;
+		}
+		RdGrid g;
+		RdGridInit(&g, verifySize, verifySize);
+		RdGridSeed(&g, 1);
+		RdStep(&g, params, verifySteps, path);
+		RdQuantize(g, texels.data(), path);
+
+		const bool exact = SameBits(g, reference);
+		const bool quantized = memcmp(texels.data(), refTexels.data(), texels.size()) == 0;
+		printf("  %-6s step %s, quantize %s\n", CpuShadePathName(path), exact ? "exact" : "MISMATCH", quantized ? "exact" : "MISMATCH");
+		if (!exact || !quantized) ++failures;
+	}
+
+	// ---- Throughput por camino, todos los threads ----
+
+	const double cells = (double)size * (double)size;
+	printf("\n%dx%d, threads=%d, block %d columns x %d rows\n", size, size, threads, kRdBlockColumns, kRdBandRows);
+	printf("%-7s %10s %14s %9s\n", "path", "ms/step", "Mcell-upd/s", "speedup");
+
+	CpuShadePath best = CpuShadePath::Scalar;
+	double scalarSeconds = 0.0, bestSeconds = 0.0;
+	for (CpuShadePath path : kPaths)
+	{
+		if (!CpuShadePathAvailable(path))
+		{
+			printf("%-7s %10s\n", CpuShadePathName(path), "n/a");
+			continue;
+		}
+		RdGridSeed(&grid, 1);
+		const double seconds = MeasureSteps(&grid, params, path, minSeconds);
+		if (path == CpuShadePath::Scalar) scalarSeconds = seconds;
+		if (bestSeconds == 0.0 || seconds < bestSeconds)
+		{
+			bestSeconds = seconds;
+			best = path;
+		}
+		printf("%-7s %10.3f %14.1f %8.2fx\n", CpuShadePathName(path), seconds * 1e3, cells / seconds * 1e-6, scalarSeconds / seconds);
+	}
+
+	// ---- Escalado por threads con el mejor camino ----
+
+	printf("\nscaling (%s):\n", CpuShadePathName(best));
+	printf("%-8s %10s %14s %16s %9s %11s\n", "threads", "ms/step", "Mcell-upd/s", "Mcell-upd/s/core", "speedup", "efficiency");
+
+	double oneThreadSeconds = 0.0;
+	for (int n = 1; n <= threads; n = n * 2 > threads && n != threads ? threads : n * 2)
+	{
+		ParallelSetThreadLimit(n);
+		RdGridSeed(&grid, 1);
+		const double seconds = MeasureSteps(&grid, params, best, minSeconds);
+		if (n == 1) oneThreadSeconds = seconds;
+		const double speedup = oneThreadSeconds / seconds;
+		printf("%-8d %10.3f %14.1f %16.1f %8.2fx %10.0f%%\n", n, seconds * 1e3, cells / seconds * 1e-6,
+			cells / seconds * 1e-6 / n, speedup, speedup / n * 100.0);
+	}
+	ParallelSetThreadLimit(maxThreads);
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,374 @@
+#include "bench.h"
+
+#include "ambient_music.h"
+#include "spsc_ring.h"
+#include "synth.h"
+#include "wav_file.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Sintetizador (synth.h): costo de SynthRender por voz y cuantas voces entran en tiempo real en un
+// core; cuantas voces entran en un presupuesto de audio por bloque (el peor bloque, no el promedio);
+// robo de voces por prioridad y un caso de muchas notas cortas por segundo; la cola SPSC entre dos
+// threads (orden y throughput); y, con --wav, un render offline de la musica de fondo.
+//
+// Opciones:
+//   --rate <hz>          sample rate (default 48000)
+//   --block <frames>     frames por bloque, multiplo de 4 (default 128)
+//   --seconds <s>        audio simulado por caso (default 10)
+//   --budget-ms <ms>     bloque de audio para la busqueda de voces maximas (default 5)
+//   --notes-per-sec <n>  notas cortas por segundo en el caso de churn (default 800)
+//   --wav <path>         escribir 'seconds' de ambient_music a un WAV estereo de 16 bits
+//   --seed <n>           semilla de la musica (default 1)
+
+struct SynthCase
+{
+	const char* name;
+	SynthWave wave;
+	bool filtered;
+};
+
+static const SynthCase kCases[] = {
+	{ "sine", SynthWave::Sine, false },
+	{ "saw", SynthWave::Saw, false },
+	{ "saw+svf", SynthWave::Saw, true },
+	{ "square+svf", SynthWave::Square, true },
+	{ "noise+svf", SynthWave::Noise, true },
+};
+
+static void StartVoices(Synth* synth, const SynthCase& c, int voices)
+{
+	SynthInit(synth, synth->sampleRate); // sin voces en release del caso anterior
+
+	for (int i = 0; i < voices; ++i)
+	{
+		SynthCommand cmd;
+		cmd.type = SynthCommandType::NoteOn;
+		cmd.note = (uint32_t)i + 1;
+		cmd.freqHz = SynthMidiToHz(36.0f + (float)(i % 48));
+		cmd.velocity = 0.5f;
+		cmd.patch.wave = c.wave;
+		cmd.patch.attack = 0.001f;
+		cmd.patch.sustain = 1.0f;
+		cmd.patch.release = 10.0f;
+		cmd.patch.cutoffHz = c.filtered ? 2000.0f + 50.0f * (float)i : 1e9f;
+		cmd.patch.gain = 1.0f / (float)voices;
+		cmd.patch.pan = (float)(i % 9) * 0.25f - 1.0f;
+		SynthApply(synth, cmd);
+	}
+}
+
+// Segundos de CPU por segundo de audio (< 1 = mas rapido que tiempo real).
+static double MeasureLoad(Synth* synth, float* left, float* right, int block, double seconds, bool* finite)
+{
+	const int blocks = (int)(seconds * synth->sampleRate / (double)block);
+	*finite = true;
+
+	const double start = BenchNowSeconds();
+	for (int b = 0; b < blocks; ++b)
+	{
+		SynthRender(synth, left, right, block);
+		if (!isfinite(left[0]) || !isfinite(right[block - 1])) *finite = false;
+	}
+	const double elapsed = BenchNowSeconds() - start;
+	return elapsed / ((double)blocks * block / synth->sampleRate);
+}
+
+// Patch variado para los casos de carga: una de cada 4 voces de cada onda, casi todas filtradas.
+static void MixedNoteOn(Synth* synth, uint32_t note, uint8_t priority, float release)
+{
+	static const SynthWave kWaves[] = { SynthWave::Saw, SynthWave::Square, SynthWave::Sine, SynthWave::Noise };
+	SynthCommand cmd;
+	cmd.type = SynthCommandType::NoteOn;
+	cmd.note = note;
+	cmd.priority = priority;
+	cmd.freqHz = SynthMidiToHz(40.0f + (float)(note % 40));
+	cmd.velocity = 0.5f;
+	cmd.patch.wave = kWaves[note % 4];
+	cmd.patch.attack = 0.002f;
+	cmd.patch.sustain = 0.8f;
+	cmd.patch.release = release;
+	cmd.patch.cutoffHz = cmd.patch.wave == SynthWave::Sine ? 1e9f : 1500.0f + 40.0f * (float)(note % 64);
+	cmd.patch.gain = 0.01f;
+	cmd.patch.pan = (float)(note % 7) / 3.0f - 1.0f;
+	SynthApply(synth, cmd);
+}
+
+// Peor bloque (p99, en ms) para 'voices' voces mezcladas en un solo Synth (voices <= kSynthMaxVoices).
+static double MeasureVoiceBlock(int voices, int rate, int block, int blocks, double* meanMs)
+{
+	std::unique_ptr<Synth> synth(new Synth);
+	SynthInit(synth.get(), (float)rate);
+	for (int v = 0; v < voices; ++v)
+		MixedNoteOn(synth.get(), (uint32_t)v + 1, kSynthPriorityNormal, 10.0f);
+
+	alignas(16) float left[kSynthMaxBlock], right[kSynthMaxBlock];
+	std::vector<double> times((size_t)blocks);
+	for (int b = -8; b < blocks; ++b) // 8 bloques de warm-up
+	{
+		const double start = BenchNowSeconds();
+		SynthRender(synth.get(), left, right, block);
+		if (b >= 0) times[(size_t)b] = (BenchNowSeconds() - start) * 1e3;
+	}
+
+	double sum = 0.0;
+	for (double t : times) sum += t;
+	*meanMs = sum / blocks;
+	std::sort(times.begin(), times.end());
+	return times[(size_t)(blocks * 99 / 100)];
+}
+
+// Mayor cantidad de voces de un Synth cuyo peor bloque (p99) entra en 'budgetMs': duplicando hasta
+// kSynthMaxVoices y despues biseccion con paso de 4 voces (un grupo SIMD). Si entra el pool entero
+// se informa el tope y cuanto del presupuesto usa.
+static void BenchVoiceBudget(int rate, double budgetMs)
+{
+	int block = ((int)(budgetMs * rate / 1000.0)) & ~3;
+	if (block > kSynthMaxBlock) block = kSynthMaxBlock;
+	if (block < 4) block = 4;
+	const double blockMs = 1000.0 * block / rate;
+	const int blocks = 200;
+
+	printf("voice budget: %d-frame blocks (%.2f ms), mixed patches, p99 over %d blocks\n", block, blockMs, blocks);
+	printf("%8s %10s %10s %8s\n", "voices", "mean ms", "p99 ms", "load");
+
+	double lastLoad = 0.0;
+	auto fits = [&](int voices) {
+		double mean = 0.0;
+		const double p99 = MeasureVoiceBlock(voices, rate, block, blocks, &mean);
+		lastLoad = p99 / blockMs * 100.0;
+		printf("%8d %10.3f %10.3f %7.1f%%\n", voices, mean, p99, lastLoad);
+		return p99 <= blockMs;
+	};
+
+	int good = 0, bad = 0;
+	for (int voices = 64;; voices *= 2)
+	{
+		if (voices > kSynthMaxVoices) voices = kSynthMaxVoices;
+		if (!fits(voices))
+		{
+			bad = voices;
+			break;
+		}
+		good = voices;
+		if (voices == kSynthMaxVoices) break;
+	}
+	if (!bad)
+	{
+		printf("cap reached at %d voices with %.1f%% of the %.2f ms budget used\n\n", kSynthMaxVoices, lastLoad, blockMs);
+		return;
+	}
+	while (bad - good > 4 && bad - good > good / 32)
+	{
+		const int mid = ((good + bad) / 2) & ~3;
+		if (fits(mid)) good = mid;
+		else bad = mid;
+	}
+	printf("max voices within %.2f ms: %d of %d\n\n", blockMs, good, kSynthMaxVoices);
+}
+
+// Robo por prioridad: con el pool lleno de notas altas, una nota baja se descarta y una alta roba
+// a la de menor prioridad (y de esas, a la que esta en release).
+static int CheckStealing(int rate)
+{
+	static Synth synth;
+	SynthInit(&synth, (float)rate);
+	for (int v = 0; v < kSynthMaxVoices; ++v)
+		MixedNoteOn(&synth, (uint32_t)v + 1, v == 7 || v == 9 ? kSynthPriorityNormal : kSynthPriorityHigh, 1.0f);
+	SynthCommand off;
+	off.type = SynthCommandType::NoteOff;
+	off.note = 10; // voz 9 en release
+	SynthApply(&synth, off);
+
+	MixedNoteOn(&synth, 1000, kSynthPriorityLow, 1.0f);
+	const bool lowDropped = synth.stats.notesDropped == 1 && synth.stats.voicesStolen == 0;
+
+	MixedNoteOn(&synth, 1001, kSynthPriorityHigh, 1.0f);
+	const bool stoleReleasing = synth.voices.note[9] == 1001;
+	MixedNoteOn(&synth, 1002, kSynthPriorityHigh, 1.0f);
+	const bool stoleNormal = synth.voices.note[7] == 1002;
+
+	const bool ok = lowDropped && stoleReleasing && stoleNormal;
+	printf("priority stealing: low note dropped %s, releasing voice stolen first %s, then lowest priority %s %s\n",
+		lowDropped ? "yes" : "no", stoleReleasing ? "yes" : "no", stoleNormal ? "yes" : "no", ok ? "ok" : "FAIL");
+	return ok ? 0 : 1;
+}
+
+// Muchas notas cortas por segundo (efectos de juego) en bloques del tamanio del motor: cuanto roba
+// y cuanto tarda el peor bloque.
+static int BenchChurn(int rate, int block, double seconds, int notesPerSecond)
+{
+	static Synth synth;
+	SynthInit(&synth, (float)rate);
+	alignas(16) float left[kSynthMaxBlock], right[kSynthMaxBlock];
+
+	const int blocks = (int)(seconds * rate / block);
+	const double notesPerBlock = (double)notesPerSecond * block / rate;
+	double pending = 0.0, worstMs = 0.0;
+	uint32_t note = 1, rng = 0x2545F491u;
+	int maxVoices = 0;
+	bool finite = true;
+
+	for (int b = 0; b < blocks; ++b)
+	{
+		for (pending += notesPerBlock; pending >= 1.0; pending -= 1.0)
+		{
+			rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+			const uint8_t priority = (rng & 3) == 0 ? kSynthPriorityHigh : ((rng & 3) == 1 ? kSynthPriorityLow : kSynthPriorityNormal);
+			MixedNoteOn(&synth, note, priority, 0.05f + (float)((rng >> 8) % 400) * 0.001f);
+			SynthCommand off;
+			off.type = SynthCommandType::NoteOff;
+			off.note = note > 8 ? note - 8 : 0; // ~8 notas sostenidas a la vez, el resto en release
+			SynthApply(&synth, off);
+			++note;
+		}
+
+		const double start = BenchNowSeconds();
+		SynthRender(&synth, left, right, block);
+		worstMs = std::max(worstMs, (BenchNowSeconds() - start) * 1e3);
+		maxVoices = std::max(maxVoices, synth.stats.activeVoices);
+		if (!isfinite(left[0]) || !isfinite(right[block - 1])) finite = false;
+	}
+
+	printf("churn: %d notes/s for %.0f s: %llu started, %llu stolen, %llu dropped, max voices %d, worst block %.3f ms of %.2f, scratch %zu/%d bytes %s\n",
+		notesPerSecond, seconds, (unsigned long long)synth.stats.notesStarted, (unsigned long long)synth.stats.voicesStolen,
+		(unsigned long long)synth.stats.notesDropped, maxVoices, worstMs, 1000.0 * block / rate,
+		synth.stats.scratchHighWater, kSynthScratchBytes, finite && !synth.stats.scratchFailures ? "ok" : "FAIL");
+	return finite && !synth.stats.scratchFailures ? 0 : 1;
+}
+
+static int BenchRing()
+{
+	static SpscRing<uint32_t, 256> ring;
+	const uint32_t count = 4u * 1000u * 1000u;
+	uint32_t errors = 0;
+
+	const double start = BenchNowSeconds();
+	std::thread consumer([&]() {
+		uint32_t expected = 0, value = 0;
+		while (expected < count)
+		{
+			if (!ring.TryPop(&value))
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			if (value != expected) ++errors;
+			++expected;
+		}
+	});
+	for (uint32_t i = 0; i < count;)
+	{
+		if (ring.TryPush(i)) ++i;
+		else std::this_thread::yield();
+	}
+	consumer.join();
+	const double elapsed = BenchNowSeconds() - start;
+
+	printf("spsc ring: %u items across threads in %.1f ms (%.1f Mitems/s), %u out of order %s\n",
+		count, elapsed * 1e3, count / elapsed * 1e-6, errors, errors ? "FAIL" : "ok");
+	return errors ? 1 : 0;
+}
+
+static void PostToSynth(void* ctx, const SynthCommand& cmd)
+{
+	SynthApply((Synth*)ctx, cmd);
+}
+
+static int RenderWav(const char* path, int rate, int block, double seconds, uint32_t seed)
+{
+	WavWriter* wav = WavOpen(path, rate, 2);
+	if (!wav)
+	{
+		fprintf(stderr, "synth: cannot create '%s'\n", path);
+		return 1;
+	}
+
+	static Synth synth;
+	SynthInit(&synth, (float)rate);
+	AmbientMusic music;
+	AmbientMusicInit(&music, seed);
+
+	alignas(16) float left[kSynthMaxBlock];
+	alignas(16) float right[kSynthMaxBlock];
+	const int blocks = (int)(seconds * rate / block);
+	float peak = 0.0f;
+	int maxVoices = 0;
+
+	// Mismo orden que el thread de audio: comandos del bloque, despues el render.
+	const double start = BenchNowSeconds();
+	for (int b = 0; b < blocks; ++b)
+	{
+		AmbientMusicUpdate(&music, (double)b * block / rate, PostToSynth, &synth);
+		SynthRender(&synth, left, right, block);
+		for (int i = 0; i < block; ++i)
+			peak = fmaxf(peak, fmaxf(fabsf(left[i]), fabsf(right[i])));
+		if (synth.stats.activeVoices > maxVoices) maxVoices = synth.stats.activeVoices;
+		WavWriteFrames(wav, left, right, block);
+	}
+	const double elapsed = BenchNowSeconds() - start;
+
+	const bool ok = WavClose(wav);
+	printf("wav: %s, %.1f s at %d Hz in %.1f ms, peak %.3f, max voices %d, %llu notes, %llu stolen %s\n",
+		path, (double)blocks * block / rate, rate, elapsed * 1e3, peak, maxVoices,
+		(unsigned long long)synth.stats.notesStarted, (unsigned long long)synth.stats.voicesStolen,
+		ok ? "ok" : "FAIL (write error)");
+	return ok && peak <= 1.0f ? 0 : 1;
+}
+
+int BenchSynth(int argc, char** argv)
+{
+	const int rate = BenchArgInt(argc, argv, "--rate", 48000);
+	const int block = BenchArgInt(argc, argv, "--block", 128);
+	const double seconds = BenchArgFloat(argc, argv, "--seconds", 10.0);
+	const uint32_t seed = (uint32_t)BenchArgInt(argc, argv, "--seed", 1);
+	const double budgetMs = BenchArgFloat(argc, argv, "--budget-ms", 5.0);
+	const int notesPerSecond = BenchArgInt(argc, argv, "--notes-per-sec", 800);
+
+	if (block < 4 || block > kSynthMaxBlock || (block & 3) != 0)
+	{
+		fprintf(stderr, "synth: --block must be a multiple of 4 in [4, %d]\n", kSynthMaxBlock);
+		return 1;
+	}
+
+	SynthEnableFlushToZero();
+
+	static Synth synth;
+	SynthInit(&synth, (float)rate);
+	alignas(16) float left[kSynthMaxBlock];
+	alignas(16) float right[kSynthMaxBlock];
+	int failures = 0;
+
+	const double blockMs = 1000.0 * block / rate;
+	printf("synth: %d Hz, %d-frame blocks (%.2f ms), %.0f s of audio per case\n\n", rate, block, blockMs, seconds);
+	printf("%-11s %6s %9s %12s %12s %s\n", "case", "count", "load", "us/block", "voices/core", "");
+
+	for (const SynthCase& c : kCases)
+	{
+		StartVoices(&synth, c, kSynthMaxVoices);
+		bool finite = true;
+		const double load = MeasureLoad(&synth, left, right, block, seconds, &finite);
+		if (!finite) ++failures;
+
+		// Voces que entran en un core sin pasar del 100% (el mixer es lineal en voces).
+		printf("%-11s %6d %8.2f%% %12.2f %12.0f %s\n", c.name, kSynthMaxVoices, load * 100.0, load * blockMs * 1e3,
+			kSynthMaxVoices / load, finite ? "" : "NON-FINITE");
+	}
+	printf("\n");
+
+	BenchVoiceBudget(rate, budgetMs);
+	failures += CheckStealing(rate);
+	failures += BenchChurn(rate, block, seconds, notesPerSecond);
+	failures += BenchRing();
+
+	for (int i = 0; i + 1 < argc; ++i)
+		if (strcmp(argv[i], "--wav") == 0) failures += RenderWav(argv[i + 1], rate, block, seconds, seed);
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+#include "bench.h"
+
+#include "glyph_atlas.h"
+#include "parallel.h"
+#include "text_layout.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+// Texto del HUD (glyph_atlas.h, text_layout.h), la parte de CPU:
+//   1. horneado del atlas SDF con 1, 2, 4, ... threads (ParallelSetThreadLimit); el atlas tiene
+//      que salir igual byte a byte con cualquier cantidad
+//   2. el campo contra el font: el centro de cada pixel prendido adentro del glifo (> 127.5) y el
+//      de cada pixel apagado sin vecinos prendidos afuera; GlyphAtlasVerify sobre todos los glifos
+//   3. layout: ns por string armandolo cada vez vs sacandolo del cache, y us por frame de un HUD
+//      tipico (layout + instancias de 20 bytes, lo que hace HudText)
+//
+// Opciones:
+//   --threads <n>         maximo de threads del escalado (default todos)
+//   --min-seconds <s>     tiempo minimo medido por fila (default 0.3)
+
+template <class F>
+static double MeasureSeconds(double minSeconds, F&& fn)
+{
+	fn(); // warmup
+	int runs = 0;
+	const double start = BenchNowSeconds();
+	double elapsed = 0.0;
+	do
+	{
+		fn();
+		++runs;
+		elapsed = BenchNowSeconds() - start;
+	} while (elapsed < minSeconds);
+	return elapsed / runs;
+}
+
+static int BenchBake(int maxThreads, double minSeconds, std::vector<uint8_t>* reference)
+{
+	const size_t bytes = GlyphAtlasBytes();
+	printf("atlas: %dx%d R8 (%.1f KB), %d glyphs, spread %d texels\n", kGlyphAtlasWidth, kGlyphAtlasHeight,
+		bytes / 1024.0, kGlyphCount, kGlyphSpreadTexels);
+	printf("%-8s %10s %12s %9s %s\n", "threads", "ms/bake", "us/glyph", "speedup", "match");
+
+	std::vector<uint8_t> atlas(bytes);
+	reference->resize(bytes);
+	int failures = 0;
+	double oneThread = 0.0;
+	for (int n = 1; n <= maxThreads; n = n * 2 > maxThreads && n != maxThreads ? maxThreads : n * 2)
+	{
+		ParallelSetThreadLimit(n);
+		uint8_t* dst = n == 1 ? reference->data() : atlas.data();
+		const double seconds = MeasureSeconds(minSeconds, [&] { GlyphAtlasBake(dst); });
+		if (n == 1) oneThread = seconds;
+
+		const char* match = "ref";
+		if (n != 1)
+		{
+			const bool exact = memcmp(reference->data(), atlas.data(), bytes) == 0;
+			match = exact ? "exact" : "MISMATCH";
+			if (!exact) ++failures;
+		}
+		printf("%-8d %10.2f %12.1f %8.2fx %s\n", n, seconds * 1e3, seconds * 1e6 / kGlyphCount, oneThread / seconds, match);
+	}
+	ParallelSetThreadLimit(0);
+	return failures;
+}
+
+static int CheckField(const std::vector<uint8_t>& atlas)
+{
+	const int padX = (kGlyphBoxWidth - kGlyphFontWidth * kGlyphCellTexels) / 2;
+	const int padY = (kGlyphBoxHeight - kGlyphFontHeight * kGlyphCellTexels) / 2;
+	int lit = 0, litBad = 0, clear = 0, clearBad = 0;
+	for (int g = 0; g < kGlyphCount; ++g)
+	{
+		const uint8_t* box = atlas.data() + (size_t)(g / kGlyphAtlasColumns) * kGlyphBoxHeight * kGlyphAtlasWidth +
+			(size_t)(g % kGlyphAtlasColumns) * kGlyphBoxWidth;
+		for (int y = 0; y < kGlyphFontHeight; ++y)
+		{
+			for (int x = 0; x < kGlyphFontWidth; ++x)
+			{
+				const int tx = padX + x * kGlyphCellTexels + kGlyphCellTexels / 2;
+				const int ty = padY + y * kGlyphCellTexels + kGlyphCellTexels / 2;
+				const uint8_t v = box[(size_t)ty * kGlyphAtlasWidth + tx];
+				if (GlyphFontPixel(g, x, y))
+				{
+					++lit;
+					if (v <= 127) ++litBad;
+					continue;
+				}
+				bool neighbor = false;
+				for (int dy = -1; dy <= 1; ++dy)
+					for (int dx = -1; dx <= 1; ++dx)
+					{
+						const int nx = x + dx, ny = y + dy;
+						if (nx >= 0 && nx < kGlyphFontWidth && ny >= 0 && ny < kGlyphFontHeight && GlyphFontPixel(g, nx, ny))
+							neighbor = true;
+					}
+				if (neighbor) continue;
+				++clear;
+				if (v >= 128) ++clearBad;
+			}
+		}
+	}
+	const int verify = GlyphAtlasVerify(atlas.data(), 1);
+	printf("\nfield vs font: %d/%d lit pixel centres inside, %d/%d isolated clear pixels outside\n",
+		lit - litBad, lit, clear - clearBad, clear);
+	printf("GlyphAtlasVerify: %d mismatching texels\n", verify);
+	return (litBad || clearBad || verify) ? 1 : 0;
+}
+
+// Lo que el HUD de main.cpp escribe en un frame: valores que cambian unas pocas veces por segundo.
+static const char* const kHudLines[] = {
+	"x11-egl  medium",
+	"143.9 fps  6.95 ms",
+	"2560x1440  scale 0.85  gpu 5.12/13.33 ms",
+	"noise (baked)  speed 1.00x",
+	"ode hh rk4 x100000",
+	"agents flock x1000000",
+	"F1 hud  Tab variant  Up/Down speed  Esc quit",
+};
+static const int kHudLineCount = (int)(sizeof(kHudLines) / sizeof(kHudLines[0]));
+
+struct Instance
+{
+	float x, y, size, glyph;
+	uint32_t color;
+};
+
+static int BenchLayout(double minSeconds)
+{
+	int glyphs = 0;
+	for (const char* line : kHudLines)
+	{
+		TextLayout layout;
+		TextLayoutBuild(line, &layout);
+		glyphs += (int)layout.glyphs.size();
+	}
+	printf("\nlayout: %d strings, %d glyphs per frame\n", kHudLineCount, glyphs);
+	printf("%-14s %12s %12s\n", "", "ns/string", "us/frame");
+
+	TextLayout scratch;
+	const double build = MeasureSeconds(minSeconds, [&]
+	{
+		for (const char* line : kHudLines) TextLayoutBuild(line, &scratch);
+	});
+	printf("%-14s %12.1f %12.2f\n", "build", build * 1e9 / kHudLineCount, build * 1e6);
+
+	TextLayoutCache cache;
+	const double cached = MeasureSeconds(minSeconds, [&]
+	{
+		for (const char* line : kHudLines) TextLayoutCacheGet(&cache, line);
+		TextLayoutCacheEndFrame(&cache);
+	});
+	printf("%-14s %12.1f %12.2f\n", "cache hit", cached * 1e9 / kHudLineCount, cached * 1e6);
+
+	// Layout del cache + instancias, como HudText.
+	std::vector<Instance> instances;
+	instances.reserve(8192);
+	const double frame = MeasureSeconds(minSeconds, [&]
+	{
+		instances.clear();
+		float y = 12.0f;
+		for (const char* line : kHudLines)
+		{
+			const TextLayout& layout = TextLayoutCacheGet(&cache, line);
+			for (const TextGlyph& g : layout.glyphs)
+				instances.push_back({ 12.0f + g.x * 24.0f, y + g.y * 24.0f, 24.0f, (float)g.glyph, 0xFFFFFFFFu });
+			y += 24.0f * kGlyphLineHeight;
+		}
+		TextLayoutCacheEndFrame(&cache);
+	});
+	printf("%-14s %12s %12.2f  (%.1f KB of instances)\n", "hud frame", "", frame * 1e6,
+		instances.size() * sizeof(Instance) / 1024.0);
+
+	const double hitRate = cache.lookups ? (double)cache.hits / (double)cache.lookups : 0.0;
+	printf("cache: %llu lookups, hit rate %.4f, %d entries, speedup %.1fx\n", (unsigned long long)cache.lookups, hitRate,
+		(int)cache.entries.size(), build / cached);
+	return hitRate > 0.99 && instances.size() == (size_t)glyphs ? 0 : 1;
+}
+
+int BenchText(int argc, char** argv)
+{
+	const int available = ParallelThreadCount();
+	const int maxArg = BenchArgInt(argc, argv, "--threads", 0);
+	const int maxThreads = maxArg > 0 && maxArg < available ? maxArg : available;
+	const double minSeconds = BenchArgFloat(argc, argv, "--min-seconds", 0.3);
+
+	std::vector<uint8_t> atlas;
+	int failures = BenchBake(maxThreads, minSeconds, &atlas);
+	failures += CheckField(atlas);
+	failures += BenchLayout(minSeconds);
+	return failures ? 1 : 0;
+}
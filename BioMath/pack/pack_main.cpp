@@ -0,0 +1,203 @@
+#include "asset_pack.h"
+#include "glyph_atlas.h"
+#include "noise_bake.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// ---------------------------
+// BioMathPack
+// ---------------------------
+
+// Empaquetador offline de assets (asset_pack.h). Lo corre el build (target BioMathAssets, que
+// deja biomath.bmpak junto al ejecutable) o se usa a mano:
+//
+//   BioMathPack <salida.bmpak> [opciones] <directorio|archivo>...
+//
+// Un directorio entra recursivo, con nombres relativos a su padre ("shaders" da
+// "shaders/fullscreen.glsl"); un archivo suelto entra con su nombre sin directorio.
+//
+// Opciones:
+//   --lz4                  comprime con LZ4 las entradas que ahorran al menos --min-savings
+//   --min-savings <f>      fraccion minima ahorrada para guardar comprimida (default 0.125)
+//   --store <sufijo>       las entradas que terminan asi van sin comprimir (repetible)
+//   --noise-lattice        agrega el lattice de ruido horneado (NoiseBakeAssetName), sin comprimir:
+//                          el app lo sube a GL directo desde el mapping
+//   --glyph-atlas          agrega el atlas SDF del HUD (GlyphAtlasAssetName), sin comprimir
+//   --list                 lista las entradas del paquete escrito
+
+static bool ReadWholeFile(const std::filesystem::path& path, std::vector<uint8_t>* out)
+{
+	FILE* f = fopen(path.string().c_str(), "rb");
+	if (!f) return false;
+	out->clear();
+	uint8_t buffer[1 << 16];
+	size_t n;
+	while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+		out->insert(out->end(), buffer, buffer + n);
+	const bool ok = !ferror(f);
+	fclose(f);
+	return ok;
+}
+
+static bool EndsWith(const std::string& s, const char* suffix)
+{
+	const size_t n = strlen(suffix);
+	return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+// Agrega 'input' (archivo o directorio). false y el motivo a stderr si algo no se pudo leer.
+static bool AddInput(const char* input, std::vector<AssetPackSource>* sources)
+{
+	namespace fs = std::filesystem;
+	std::error_code ec;
+	const fs::path root(input);
+	if (fs::is_regular_file(root, ec))
+	{
+		AssetPackSource s;
+		s.name = root.filename().generic_string();
+		if (!ReadWholeFile(root, &s.data))
+		{
+			fprintf(stderr, "BioMathPack: cannot read '%s'\n", input);
+			return false;
+		}
+		sources->push_back(std::move(s));
+		return true;
+	}
+	if (!fs::is_directory(root, ec))
+	{
+		fprintf(stderr, "BioMathPack: '%s' is not a file or a directory\n", input);
+		return false;
+	}
+
+	// Orden estable entre corridas (el del directorio depende del sistema de archivos).
+	std::vector<fs::path> files;
+	for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec))
+	{
+		if (it->is_regular_file(ec)) files.push_back(it->path());
+	}
+	if (ec)
+	{
+		fprintf(stderr, "BioMathPack: cannot list '%s': %s\n", input, ec.message().c_str());
+		return false;
+	}
+	std::sort(files.begin(), files.end());
+
+	fs::path prefix = root.has_filename() ? root.filename() : root.parent_path().filename();
+	if (prefix == "." || prefix == "..") prefix.clear();
+	for (const fs::path& file : files)
+	{
+		AssetPackSource s;
+		s.name = (prefix / file.lexically_relative(root)).generic_string();
+		if (!ReadWholeFile(file, &s.data))
+		{
+			fprintf(stderr, "BioMathPack: cannot read '%s'\n", file.string().c_str());
+			return false;
+		}
+		sources->push_back(std::move(s));
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "usage: BioMathPack <out.bmpak> [--lz4] [--min-savings f] [--store suffix]... [--noise-lattice] [--glyph-atlas] [--list] <dir|file>...\n");
+		return 1;
+	}
+
+	const char* outPath = argv[1];
+	AssetPackWriteOptions options;
+	std::vector<const char*> storeSuffixes;
+	std::vector<AssetPackSource> sources;
+	bool list = false;
+	const auto start = std::chrono::steady_clock::now();
+
+	for (int i = 2; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--lz4") == 0)
+		{
+			options.lz4 = true;
+		}
+		else if (strcmp(argv[i], "--min-savings") == 0 && i + 1 < argc)
+		{
+			options.minSavings = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--store") == 0 && i + 1 < argc)
+		{
+			storeSuffixes.push_back(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--list") == 0)
+		{
+			list = true;
+		}
+		else if (strcmp(argv[i], "--noise-lattice") == 0)
+		{
+			char name[64];
+			NoiseBakeAssetName(kNoisePeriod, name, sizeof(name));
+			AssetPackSource s;
+			s.name = name;
+			s.data.resize(NoiseBakeBytes(kNoisePeriod));
+			NoiseBakeLattice((uint16_t*)s.data.data(), kNoisePeriod);
+			s.allowCompression = false;
+			sources.push_back(std::move(s));
+		}
+		else if (strcmp(argv[i], "--glyph-atlas") == 0)
+		{
+			char name[64];
+			GlyphAtlasAssetName(name, sizeof(name));
+			AssetPackSource s;
+			s.name = name;
+			s.data.resize(GlyphAtlasBytes());
+			GlyphAtlasBake(s.data.data());
+			s.allowCompression = false;
+			sources.push_back(std::move(s));
+		}
+		else if (!AddInput(argv[i], &sources))
+		{
+			return 1;
+		}
+	}
+
+	for (AssetPackSource& s : sources)
+	{
+		for (const char* suffix : storeSuffixes)
+			if (EndsWith(s.name, suffix)) s.allowCompression = false;
+	}
+
+	AssetPackWriteStats stats;
+	std::string error;
+	if (!AssetPackWrite(outPath, sources, options, &stats, &error))
+	{
+		fprintf(stderr, "BioMathPack: %s\n", error.c_str());
+		return 1;
+	}
+	const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	printf("BioMathPack: %s: %d entries (%d lz4), %.2f MB -> %.2f MB in %.1f ms\n", outPath, stats.entries, stats.compressed,
+		stats.rawBytes / 1048576.0, stats.fileBytes / 1048576.0, ms);
+
+	if (list)
+	{
+		AssetPack pack;
+		if (!AssetPackOpen(outPath, &pack, &error))
+		{
+			fprintf(stderr, "BioMathPack: %s\n", error.c_str());
+			return 1;
+		}
+		for (int i = 0; i < pack.count; ++i)
+		{
+			const AssetPackEntry& e = pack.entries[i];
+			printf("  %10llu %10llu %-4s %s\n", (unsigned long long)e.bytes, (unsigned long long)e.storedBytes,
+				e.compression == (uint32_t)AssetCompression::Lz4 ? "lz4" : "raw", AssetPackName(pack, i));
+		}
+		AssetPackClose(&pack);
+	}
+	return 0;
+}
@@ -0,0 +1,45 @@
+// Agentes (agents_render.h): un triangulito por agente, todos en un solo draw instanciado.
+//
+// aX, aY, aVx, aVy son atributos por instancia (divisor 1) del mismo vertex buffer: x de todos,
+// despues y, vx y vy. gl_VertexID (0..2) elige el vertice del triangulo, que apunta en la
+// direccion de la velocidad. uScale/uOffset llevan el mundo a clip space y uSize es el largo del
+// triangulo en clip (fijo en pixels, no depende de la cantidad de agentes). El color sale del
+// rumbo; con blending aditivo las bandadas densas saturan.
+
+#ifdef VERTEX_SHADER
+
+layout(location=0) in float aX;
+layout(location=1) in float aY;
+layout(location=2) in float aVx;
+layout(location=3) in float aVy;
+uniform vec2 uScale;
+uniform vec2 uOffset;
+uniform vec2 uSize;
+out vec3 vColor;
+
+const vec2 kShape[3] = vec2[3](vec2(1.0, 0.0), vec2(-0.6, 0.45), vec2(-0.6, -0.45));
+
+void main(){
+  vec2 v = vec2(aVx, aVy);
+  float speed = length(v);
+  vec2 dir = speed > 0.0 ? v / speed : vec2(1.0, 0.0);
+  vec2 local = kShape[gl_VertexID];
+  vec2 corner = dir * local.x + vec2(-dir.y, dir.x) * local.y;
+  gl_Position = vec4(vec2(aX, aY) * uScale + uOffset + corner * uSize * 0.5, 0.0, 1.0);
+
+  float heading = atan(dir.y, dir.x);
+  vColor = (0.5 + 0.5 * cos(heading + vec3(0.0, 2.094, 4.189))) * 0.35;
+}
+
+#endif
+
+#ifdef FRAGMENT_SHADER
+
+in vec3 vColor;
+out vec4 FragColor;
+
+void main(){
+  FragColor = vec4(vColor, 1.0);
+}
+
+#endif
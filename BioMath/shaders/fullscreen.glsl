@@ -0,0 +1,151 @@
+// Fondo procedural: un triangulo que cubre la pantalla + ruido animado con vinieta.
+//
+// Los dos stages viven en este archivo. shader_program.cpp antepone "#version 330 core" y
+// VERTEX_SHADER o FRAGMENT_SHADER segun el stage. Se recarga solo al guardar (hot reload).
+//
+// Variantes (tabla kShaderVariants en shader_variants.h): NOISE_OCTAVES, VIGNETTE y CHEAP_HASH
+// llegan como #define. Los valores por defecto de abajo son la variante "medium".
+//
+// BAKED_NOISE (--noise baked, noise_texture.h): hash() lee el lattice precalculado en CPU en vez de
+// evaluarse. Capa 0 = el hash con sin(), capa 1 = el de CHEAP_HASH. Da el mismo resultado: con o
+// sin lattice, noise() envuelve las esquinas de las celdas cada NOISE_PERIOD.
+//
+// Tiempo (BackgroundTimeAt, cpu_renderer.h): uTime solo mueve los senos y llega envuelto en un
+// multiplo de su periodo; el desplazamiento del ruido de cada octava llega aparte en uNoiseScroll,
+// envuelto modulo NOISE_PERIOD. Ninguno de los dos salta al envolver.
+//
+// USER_EXPR (--expr, expr_field.h): el valor sale de UserExpr(x, y, t), la funcion que genera el
+// compilador de expresiones y que llega antes de este archivo junto con los #define.
+//
+// Si se cambia la variante "medium" (o un hash) hay que acompaniar cpu_renderer.cpp y
+// noise_bake.cpp: --headless --golden compara contra la CPU.
+
+#ifndef NOISE_OCTAVES
+#define NOISE_OCTAVES 1
+#endif
+#ifndef VIGNETTE
+#define VIGNETTE 1
+#endif
+#ifndef CHEAP_HASH
+#define CHEAP_HASH 0
+#endif
+#ifndef BAKED_NOISE
+#define BAKED_NOISE 0
+#endif
+#ifndef REACTION_DIFFUSION
+#define REACTION_DIFFUSION 0
+#endif
+#ifndef USER_EXPR
+#define USER_EXPR 0
+#endif
+#ifndef NOISE_PERIOD
+#define NOISE_PERIOD 1024   // kNoisePeriod (noise_bake.h)
+#endif
+
+#ifdef VERTEX_SHADER
+
+layout(location=0) in vec2 aPos;
+out vec2 vUV;
+
+void main(){
+  gl_Position = vec4(aPos, 0.0, 1.0);
+  vUV = aPos * 0.5 + 0.5;
+}
+
+#endif
+
+#ifdef FRAGMENT_SHADER
+
+in vec2 vUV;
+out vec4 FragColor;
+uniform float uTime;
+uniform vec2  uResolution;
+uniform vec2  uNoiseScroll[NOISE_OCTAVES];
+#if USER_EXPR
+uniform float uExprTime;   // sin envolver: la formula no tiene periodo
+#endif
+
+#if REACTION_DIFFUSION
+// Unidad 0, como el lattice (con --rd el lattice no se carga). R = V * 2.
+uniform sampler2D uField;
+#endif
+
+#if BAKED_NOISE
+// Unidad 0 (valor por defecto del sampler). p siempre es entero: las esquinas de la celda.
+uniform sampler2DArray uNoiseLattice;
+float hash(vec2 p){
+  ivec2 c = ivec2(p) & (NOISE_PERIOD - 1);
+  return texelFetch(uNoiseLattice, ivec3(c, CHEAP_HASH), 0).r;
+}
+#elif CHEAP_HASH
+// Solo fract y productos: sin sin(), que en muchas GPUs es caro o de baja precision.
+float hash(vec2 p){
+  vec3 p3 = fract(vec3(p.xyx) * 0.1031);
+  p3 += dot(p3, p3.yzx + 33.33);
+  return fract((p3.x + p3.y) * p3.z);
+}
+#else
+float hash(vec2 p){ return fract(sin(dot(p, vec2(127.1,311.7))) * 43758.5453123); }
+#endif
+
+// Periodica: las esquinas envuelven cada NOISE_PERIOD celdas (mod es exacto, el periodo es
+// potencia de dos), asi el desplazamiento puede envolver sin que el fondo salte.
+float noise(vec2 p){
+  vec2 i = floor(p);
+  vec2 f = fract(p);
+  vec2 i0 = mod(i, float(NOISE_PERIOD));
+  vec2 i1 = mod(i + 1.0, float(NOISE_PERIOD));
+  float a = hash(i0);
+  float b = hash(vec2(i1.x, i0.y));
+  float c = hash(vec2(i0.x, i1.y));
+  float d = hash(i1);
+  vec2 u = f*f*(3.0-2.0*f);
+  return mix(a,b,u.x) + (c-a)*u.y*(1.0-u.x) + (d-b)*u.x*u.y;
+}
+
+// Suma de octavas normalizada a [0,1]: con 1 octava es exactamente noise(). p va sin el
+// desplazamiento, que cada octava suma ya escalado (uNoiseScroll[o]).
+float fbm(vec2 p){
+#if NOISE_OCTAVES <= 1
+  return noise(p + uNoiseScroll[0]);
+#else
+  float sum = 0.0;
+  float amp = 1.0;
+  float norm = 0.0;
+  for (int o = 0; o < NOISE_OCTAVES; ++o){
+    sum += amp * noise(p + uNoiseScroll[o]);
+    norm += amp;
+    p = p * 2.03 + vec2(17.0, 9.0);
+    amp *= 0.5;
+  }
+  return sum / norm;
+#endif
+}
+
+void main(){
+  vec2 uv = vUV;
+  float t = uTime;
+#if USER_EXPR
+  // y en [-1, 1], x con la misma escala.
+  vec2 p = (uv * 2.0 - 1.0) * vec2(uResolution.x / uResolution.y, 1.0);
+  float v = UserExpr(p.x, p.y, uExprTime);
+  float n = clamp(0.5 + 0.5 * v, 0.0, 1.0);
+#elif REACTION_DIFFUSION
+  float n = texture(uField, vec2(uv.x * uResolution.x / uResolution.y, uv.y)).r;
+#else
+  float n = fbm(uv*6.0);
+#endif
+  vec3 col = vec3(0.08,0.10,0.14);
+  col += 0.35 * vec3(0.20,0.55,0.95) * n;
+  col += 0.15 * vec3(sin(t + uv.x*6.0), sin(t*0.7 + uv.y*5.0), sin(t*1.3)) * 0.5;
+#if USER_EXPR
+  // La curva f = 0, de ~1.5 pixels de ancho.
+  col = mix(col, vec3(0.95, 0.85, 0.40), 1.0 - smoothstep(0.0, 1.5 * fwidth(v), abs(v)));
+#endif
+#if VIGNETTE
+  col *= smoothstep(1.2, 0.2, length(uv - 0.5));
+#endif
+  FragColor = vec4(col, 1.0);
+}
+
+#endif
@@ -0,0 +1,53 @@
+// HUD de texto (hud.h): un quad por glifo, todos en un solo draw instanciado.
+//
+// aGlyph = (x, y, tamanio, indice) y aColor son atributos por instancia (divisor 1); gl_VertexID
+// (0..3, triangle strip) elige la esquina. Las posiciones vienen en pixels desde arriba a la
+// izquierda y uViewport = 2 / tamanio de la salida las lleva a clip. La caja del glifo mide
+// tamanio * uAspect x tamanio y la uv sale del indice en la grilla del atlas (uGrid = columnas,
+// filas). El atlas es un campo de distancia (glyph_atlas.h, 0.5 = borde): fwidth da el ancho de
+// un pixel en unidades del campo, asi el borde queda suave a cualquier tamanio, y un segundo umbral
+// mas afuera pinta un contorno oscuro para que se lea sobre el fondo. Salida premultiplicada.
+
+#ifdef VERTEX_SHADER
+
+layout(location=0) in vec4 aGlyph;
+layout(location=1) in vec4 aColor;
+uniform vec2 uViewport;
+uniform vec2 uGrid;
+uniform float uAspect;
+out vec2 vUv;
+out vec4 vColor;
+
+void main(){
+  vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+  vec2 px = aGlyph.xy + corner * vec2(aGlyph.z * uAspect, aGlyph.z);
+  gl_Position = vec4(px.x * uViewport.x - 1.0, 1.0 - px.y * uViewport.y, 0.0, 1.0);
+
+  float index = aGlyph.w;
+  float row = floor(index / uGrid.x);
+  vec2 cell = vec2(index - row * uGrid.x, row);
+  vUv = (cell + corner) / uGrid;
+  vColor = aColor;
+}
+
+#endif
+
+#ifdef FRAGMENT_SHADER
+
+uniform sampler2D uAtlas;
+in vec2 vUv;
+in vec4 vColor;
+out vec4 FragColor;
+
+const float kOutline = 0.18;   // ancho del contorno en unidades del campo (1 = kGlyphSpreadTexels)
+
+void main(){
+  float d = texture(uAtlas, vUv).r;
+  float aa = max(fwidth(d), 1e-4) * 0.75;
+  float fill = smoothstep(0.5 - aa, 0.5 + aa, d);
+  float shape = smoothstep(0.5 - kOutline - aa, 0.5 - kOutline + aa, d);
+  float alpha = shape * vColor.a;
+  FragColor = vec4(vColor.rgb * fill * vColor.a, alpha);
+}
+
+#endif
@@ -0,0 +1,38 @@
+// Diagrama de fase del ensamble de EDOs (ode_plot.h): un punto por sistema.
+//
+// aX y aY son las dos variables del grafico, del mismo vertex buffer (X de todos los sistemas y
+// despues Y de todos). uPlotScale/uPlotOffset llevan [plotMin, plotMax] a clip space. El color sale
+// de la posicion del sistema en la grilla del barrido (uSweep = columnas, filas): el primer
+// parametro va de azul a naranja y el segundo sube el brillo. Se dibuja con blending aditivo: donde
+// se juntan muchos sistemas el punto satura.
+
+#ifdef VERTEX_SHADER
+
+layout(location=0) in float aX;
+layout(location=1) in float aY;
+uniform vec2 uPlotScale;
+uniform vec2 uPlotOffset;
+uniform vec2 uSweep;
+out vec3 vColor;
+
+void main(){
+  gl_Position = vec4(vec2(aX, aY) * uPlotScale + uPlotOffset, 0.0, 1.0);
+
+  int columns = int(uSweep.x);
+  float u = (float(gl_VertexID % columns) + 0.5) / uSweep.x;
+  float v = (float(gl_VertexID / columns) + 0.5) / uSweep.y;
+  vColor = mix(vec3(0.15, 0.45, 1.0), vec3(1.0, 0.45, 0.1), u) * (0.03 + 0.05 * v);
+}
+
+#endif
+
+#ifdef FRAGMENT_SHADER
+
+in vec3 vColor;
+out vec4 FragColor;
+
+void main(){
+  FragColor = vec4(vColor, 1.0);
+}
+
+#endif
@@ -0,0 +1,24 @@
+// Microbenchmark de streaming (stream_buffer.h): cada vertice es un punto (x, y) en [-1, 1].
+// Lo que se mide es la subida, no el raster: el vertex shader lee todos los puntos (la GPU tiene
+// que terminar de leer el segmento antes de que se pueda reescribir) pero los manda fuera del
+// clip space, asi que casi ninguno llega a rasterizarse.
+
+#ifdef VERTEX_SHADER
+
+layout(location=0) in vec2 aPos;
+
+void main(){
+  gl_Position = vec4(aPos, 2.0 + abs(aPos.x), 1.0);
+}
+
+#endif
+
+#ifdef FRAGMENT_SHADER
+
+out vec4 FragColor;
+
+void main(){
+  FragColor = vec4(1.0 / 255.0);
+}
+
+#endif
@@ -0,0 +1,58 @@
+// Escalado de la escena (resolucion dinamica) al tamanio de la ventana.
+//
+// La escena se dibuja en la esquina inferior izquierda de una textura del tamanio de la ventana;
+// uSrcScale es la fraccion usada (ancho y alto de la escena / tamanio de la textura) y uSrcMax el
+// ultimo centro de texel valido, para que el filtro no lea lo que quedo afuera.
+//
+// EDGE_AWARE 0: bilineal. EDGE_AWARE 1: bilineal + realce adaptativo al contraste local (estilo
+// CAS): recupera bordes que el bilineal lava sin amplificar ruido en zonas planas.
+
+#ifndef EDGE_AWARE
+#define EDGE_AWARE 0
+#endif
+
+#ifdef VERTEX_SHADER
+
+layout(location=0) in vec2 aPos;
+out vec2 vUV;
+
+void main(){
+  gl_Position = vec4(aPos, 0.0, 1.0);
+  vUV = aPos * 0.5 + 0.5;
+}
+
+#endif
+
+#ifdef FRAGMENT_SHADER
+
+in vec2 vUV;
+out vec4 FragColor;
+uniform sampler2D uScene;
+uniform vec2 uSrcScale;
+uniform vec2 uSrcMax;
+
+vec3 Sample(vec2 uv){ return texture(uScene, min(uv, uSrcMax)).rgb; }
+
+void main(){
+  vec2 uv = vUV * uSrcScale;
+  vec3 c = Sample(uv);
+
+#if EDGE_AWARE
+  vec2 texel = 1.0 / vec2(textureSize(uScene, 0));
+  vec3 n = Sample(uv + vec2(0.0, texel.y));
+  vec3 s = Sample(uv - vec2(0.0, texel.y));
+  vec3 e = Sample(uv + vec2(texel.x, 0.0));
+  vec3 w = Sample(uv - vec2(texel.x, 0.0));
+
+  // Cuanto margen hay hasta saturar (0 o 1) decide cuanto se puede realzar sin halos.
+  vec3 mn = min(c, min(min(n, s), min(e, w)));
+  vec3 mx = max(c, max(max(n, s), max(e, w)));
+  vec3 amp = sqrt(clamp(min(mn, 1.0 - mx) / max(mx, 1e-4), 0.0, 1.0));
+  vec3 wgt = -amp * 0.125; // hasta 1/8 por vecino
+  c = clamp((c + (n + s + e + w) * wgt) / (1.0 + 4.0 * wgt), 0.0, 1.0);
+#endif
+
+  FragColor = vec4(c, 1.0);
+}
+
+#endif
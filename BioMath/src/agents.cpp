@@ -0,0 +1,334 @@
+#include "agents.h"
+#include "agents_kernels.h"
+#include "parallel.h"
+
+#include <chrono>
+#include <math.h>
+#include <string.h>
+#include <utility>
+
+// ---------------------------
+// Kernels escalar y SSE2 (el AVX2 esta en agents_avx2.cpp)
+// ---------------------------
+
+uint64_t AgentForceSpanScalar(const AgentForceArgs& args, int row, int cell0, int cell1)
+{
+	return agents::ForceSpan<lanes::F1>(args, row, cell0, cell1);
+}
+
+uint64_t AgentForceSpanSSE2(const AgentForceArgs& args, int row, int cell0, int cell1)
+{
+	return agents::ForceSpan<lanes::F4>(args, row, cell0, cell1);
+}
+
+void AgentIntegrateSpanScalar(const AgentIntegrateArgs& args, int i0, int i1)
+{
+	agents::IntegrateSpan<lanes::F1>(args, i0, i1);
+}
+
+void AgentIntegrateSpanSSE2(const AgentIntegrateArgs& args, int i0, int i1)
+{
+	agents::IntegrateSpan<lanes::F4>(args, i0, i1);
+}
+
+// ---------------------------
+// Modos
+// ---------------------------
+
+static const int kAgentsPerCell = 4;          // densidad inicial
+static const int kAgentSortCellBlock = 4096;  // celdas por bloque del scan
+static const int kAgentIntegrateGrain = 16384;
+
+AgentParams AgentParamsDefault(AgentMode mode)
+{
+	AgentParams p;
+	if (mode == AgentMode::Chemotaxis)
+	{
+		p.minSpeed = 1.5f;
+		p.maxSpeed = 4.0f;
+		p.separation = 40.0f;
+		p.alignment = 0.0f;
+		p.cohesion = 0.0f;
+		p.chemotaxis = 12.0f;
+	}
+	return p;
+}
+
+const char* AgentModeName(AgentMode mode)
+{
+	return mode == AgentMode::Chemotaxis ? "chemo" : "flock";
+}
+
+bool AgentModeFind(const char* name, AgentMode* mode)
+{
+	if (strcmp(name, "flock") == 0) *mode = AgentMode::Flocking;
+	else if (strcmp(name, "chemo") == 0) *mode = AgentMode::Chemotaxis;
+	else return false;
+	return true;
+}
+
+// ---------------------------
+// Mundo
+// ---------------------------
+
+// xorshift32: reproducible en todas las plataformas (rand() no lo es).
+static float NextUnit(uint32_t* state)
+{
+	uint32_t s = *state;
+	s ^= s << 13;
+	s ^= s >> 17;
+	s ^= s << 5;
+	*state = s;
+	return (float)(s >> 8) * (1.0f / 16777216.0f);
+}
+
+bool AgentWorldInit(AgentWorld* world, AgentMode mode, int count, uint32_t seed, const AgentParams& params)
+{
+	if (count < 1) return false;
+
+	// Grilla cuadrada con ~kAgentsPerCell agentes por celda; al menos 4 celdas por lado para que
+	// las tres columnas vecinas de una celda sean distintas.
+	int side = (int)ceil(sqrt((double)count / kAgentsPerCell));
+	if (side < 4) side = 4;
+
+	world->mode = mode;
+	world->count = count;
+	world->gridW = side;
+	world->gridH = side;
+	world->width = (float)side * params.radius;
+	world->height = (float)side * params.radius;
+
+	const size_t padded = (size_t)count + kAgentPad;
+	const size_t cells = (size_t)side * (size_t)side;
+	for (std::vector<float>* v : { &world->x, &world->y, &world->vx, &world->vy, &world->sx, &world->sy, &world->svx, &world->svy, &world->ax, &world->ay })
+		v->assign(padded, 0.0f);
+	world->cell.assign((size_t)count, 0);
+	world->histogram.assign(cells * kAgentSortChunks, 0);
+	world->cellStart.assign(cells + 1, 0);
+	world->blockStart.assign(cells / kAgentSortCellBlock + 2, 0);
+	world->rowNeighbors.assign((size_t)side, 0);
+
+	uint32_t state = seed ? seed : 0x9E3779B9u;
+	const float speed = 0.5f * (params.minSpeed + params.maxSpeed);
+	for (int i = 0; i < count; ++i)
+	{
+		world->x[(size_t)i] = NextUnit(&state) * world->width;
+		world->y[(size_t)i] = NextUnit(&state) * world->height;
+		const float angle = NextUnit(&state) * 6.2831853f;
+		world->vx[(size_t)i] = cosf(angle) * speed;
+		world->vy[(size_t)i] = sinf(angle) * speed;
+	}
+	// NextUnit puede dar exactamente width por redondeo.
+	for (int i = 0; i < count; ++i)
+	{
+		if (world->x[(size_t)i] >= world->width) world->x[(size_t)i] = 0.0f;
+		if (world->y[(size_t)i] >= world->height) world->y[(size_t)i] = 0.0f;
+	}
+
+	world->time = 0.0;
+	world->ticks = 0;
+	world->sortMs = world->forceMs = world->integrateMs = 0.0;
+	world->meanNeighbors = 0.0;
+	return true;
+}
+
+static double MsBetween(std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b)
+{
+	return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+// Counting sort por celda. Los bloques de agentes son fijos (kAgentSortChunks), asi que el orden
+// resultante no depende de cuantos threads haya: dentro de una celda quedan por indice original.
+static void SortByCell(AgentWorld* w, float invCell)
+{
+	const int count = w->count;
+	const int cells = w->gridW * w->gridH;
+	uint32_t* histogram = w->histogram.data();
+	uint32_t* cell = w->cell.data();
+
+	// 1. Celda de cada agente e histograma de su bloque (una fila de 'cells' por bloque: los
+	//    bloques no comparten lineas de cache).
+	ParallelFor(kAgentSortChunks, 1, [&](int k0, int k1)
+	{
+		for (int k = k0; k < k1; ++k)
+		{
+			uint32_t* h = histogram + (size_t)k * (size_t)cells;
+			memset(h, 0, (size_t)cells * sizeof(uint32_t));
+			const int i0 = (int)((int64_t)count * k / kAgentSortChunks);
+			const int i1 = (int)((int64_t)count * (k + 1) / kAgentSortChunks);
+			for (int i = i0; i < i1; ++i)
+			{
+				int cx = (int)(w->x[(size_t)i] * invCell);
+				int cy = (int)(w->y[(size_t)i] * invCell);
+				cx = cx < 0 ? 0 : (cx >= w->gridW ? w->gridW - 1 : cx);
+				cy = cy < 0 ? 0 : (cy >= w->gridH ? w->gridH - 1 : cy);
+				const uint32_t c = (uint32_t)(cy * w->gridW + cx);
+				cell[i] = c;
+				++h[c];
+			}
+		}
+	});
+
+	// 2. Scan: primero el total de cada bloque de celdas, despues (serie) donde empieza cada bloque
+	//    y al final, en paralelo, el inicio de cada celda y de cada bloque de agentes dentro de ella.
+	const int cellBlocks = (cells + kAgentSortCellBlock - 1) / kAgentSortCellBlock;
+	uint32_t* blockStart = w->blockStart.data();
+	ParallelFor(cellBlocks, 1, [&](int b0, int b1)
+	{
+		for (int b = b0; b < b1; ++b)
+		{
+			const int c1 = (b + 1) * kAgentSortCellBlock < cells ? (b + 1) * kAgentSortCellBlock : cells;
+			uint32_t sum = 0;
+			for (int k = 0; k < kAgentSortChunks; ++k)
+			{
+				const uint32_t* h = histogram + (size_t)k * (size_t)cells;
+				for (int c = b * kAgentSortCellBlock; c < c1; ++c) sum += h[c];
+			}
+			blockStart[b + 1] = sum;
+		}
+	});
+	blockStart[0] = 0;
+	for (int b = 0; b < cellBlocks; ++b) blockStart[b + 1] += blockStart[b];
+
+	uint32_t* cellStart = w->cellStart.data();
+	ParallelFor(cellBlocks, 1, [&](int b0, int b1)
+	{
+		for (int b = b0; b < b1; ++b)
+		{
+			const int c1 = (b + 1) * kAgentSortCellBlock < cells ? (b + 1) * kAgentSortCellBlock : cells;
+			uint32_t running = blockStart[b];
+			for (int c = b * kAgentSortCellBlock; c < c1; ++c)
+			{
+				cellStart[c] = running;
+				for (int k = 0; k < kAgentSortChunks; ++k)
+				{
+					uint32_t& h = histogram[(size_t)k * (size_t)cells + (size_t)c];
+					const uint32_t n = h;
+					h = running;
+					running += n;
+				}
+			}
+		}
+	});
+	cellStart[cells] = (uint32_t)count;
+
+	// 3. Scatter estable: cada bloque escribe en sus posiciones, sin atomicos.
+	ParallelFor(kAgentSortChunks, 1, [&](int k0, int k1)
+	{
+		for (int k = k0; k < k1; ++k)
+		{
+			uint32_t* h = histogram + (size_t)k * (size_t)cells;
+			const int i0 = (int)((int64_t)count * k / kAgentSortChunks);
+			const int i1 = (int)((int64_t)count * (k + 1) / kAgentSortChunks);
+			for (int i = i0; i < i1; ++i)
+			{
+				const uint32_t dst = h[cell[i]]++;
+				w->sx[dst] = w->x[(size_t)i];
+				w->sy[dst] = w->y[(size_t)i];
+				w->svx[dst] = w->vx[(size_t)i];
+				w->svy[dst] = w->vy[(size_t)i];
+			}
+		}
+	});
+
+	std::swap(w->x, w->sx);
+	std::swap(w->y, w->sy);
+	std::swap(w->vx, w->svx);
+	std::swap(w->vy, w->svy);
+}
+
+void AgentWorldStep(AgentWorld* world, const AgentParams& params, float dt, float* frameOut, CpuShadePath path)
+{
+	if (world->count <= 0) return;
+
+	path = CpuResolveShadePath(path);
+	AgentForceSpanFn force = AgentForceSpanScalar;
+	AgentIntegrateSpanFn integrate = AgentIntegrateSpanScalar;
+	if (path == CpuShadePath::SSE2)
+	{
+		force = AgentForceSpanSSE2;
+		integrate = AgentIntegrateSpanSSE2;
+	}
+	if (path == CpuShadePath::AVX2)
+	{
+		force = AgentForceSpanAVX2;
+		integrate = AgentIntegrateSpanAVX2;
+	}
+
+	using clock = std::chrono::steady_clock;
+	const clock::time_point t0 = clock::now();
+
+	SortByCell(world, 1.0f / params.radius);
+	const clock::time_point t1 = clock::now();
+
+	AgentForceArgs fa = {};
+	fa.x = world->x.data();
+	fa.y = world->y.data();
+	fa.vx = world->vx.data();
+	fa.vy = world->vy.data();
+	fa.cellStart = world->cellStart.data();
+	fa.ax = world->ax.data();
+	fa.ay = world->ay.data();
+	fa.gridW = world->gridW;
+	fa.gridH = world->gridH;
+	fa.width = world->width;
+	fa.height = world->height;
+	fa.radius2 = params.radius * params.radius;
+	fa.separation2 = params.separationRadius * params.separationRadius;
+	fa.invSeparation2 = 1.0f / fa.separation2;
+	fa.separation = params.separation;
+	fa.alignment = params.alignment;
+	fa.cohesion = params.cohesion;
+
+	uint64_t* rowNeighbors = world->rowNeighbors.data();
+	const int gridW = world->gridW;
+	ParallelFor(world->gridH, 2, [&](int r0, int r1)
+	{
+		for (int r = r0; r < r1; ++r) rowNeighbors[r] = force(fa, r, r * gridW, (r + 1) * gridW);
+	});
+	const clock::time_point t2 = clock::now();
+
+	AgentIntegrateArgs ia = {};
+	ia.x = world->x.data();
+	ia.y = world->y.data();
+	ia.vx = world->vx.data();
+	ia.vy = world->vy.data();
+	ia.ax = world->ax.data();
+	ia.ay = world->ay.data();
+	ia.frameOut = frameOut;
+	ia.count = (size_t)world->count;
+	ia.dt = dt;
+	ia.width = world->width;
+	ia.height = world->height;
+	ia.minSpeed = params.minSpeed;
+	ia.maxSpeed = params.maxSpeed;
+	if (world->mode == AgentMode::Chemotaxis && params.chemotaxis != 0.0f)
+	{
+		// Fuentes en curvas de Lissajous lentas; sigma por defecto: 1/6 del mundo.
+		const float sigma = params.chemoSigma > 0.0f ? params.chemoSigma : world->width / 6.0f;
+		const float t = (float)world->time;
+		ia.chemotaxis = params.chemotaxis / sigma;
+		ia.chemoInvTwoSigma2 = 1.0f / (2.0f * sigma * sigma);
+		for (int k = 0; k < kAgentChemoSources; ++k)
+		{
+			const float phase = (float)k * 2.0943951f;
+			ia.chemoX[k] = world->width * (0.5f + 0.3f * sinf(t * 0.05f * (float)(k + 1) + phase));
+			ia.chemoY[k] = world->height * (0.5f + 0.3f * cosf(t * 0.037f * (float)(k + 2) + phase));
+		}
+	}
+
+	ParallelFor(world->count, kAgentIntegrateGrain, [&](int i0, int i1)
+	{
+		integrate(ia, i0, i1);
+	});
+	const clock::time_point t3 = clock::now();
+
+	uint64_t neighbors = 0;
+	for (uint64_t n : world->rowNeighbors) neighbors += n;
+	world->meanNeighbors = (double)neighbors / (double)world->count;
+	world->sortMs = MsBetween(t0, t1);
+	world->forceMs = MsBetween(t1, t2);
+	world->integrateMs = MsBetween(t2, t3);
+	world->time += (double)dt;
+	++world->ticks;
+}
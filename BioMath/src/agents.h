@@ -0,0 +1,95 @@
+#pragma once
+
+#include "cpu_renderer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// ---------------------------
+// Agentes (celulas / bandada)
+// ---------------------------
+
+// Muchos agentes puntuales en un toro de width x height que se mueven por reglas locales:
+//   Flocking     bandada estilo boids: separacion, alineacion y cohesion con los vecinos.
+//   Chemotaxis   celulas que suben el gradiente de tres fuentes gaussianas que se mueven, con
+//                separacion entre vecinas (no se apilan) y sin alineacion ni cohesion.
+//
+// El estado es SoA (x, y, vx, vy en arrays separados). Cada tick:
+//   1. Sort: grilla hash uniforme de celdas de lado 'radius' (el radio de vecindad), reconstruida
+//      con un counting sort paralelo: histograma por bloque fijo de agentes, scan de los
+//      histogramas y scatter estable. Los agentes quedan ordenados por celda, asi que los vecinos
+//      de una celda son tres rangos contiguos (filas cy-1, cy, cy+1; columnas cx-1..cx+1).
+//   2. Fuerzas: por agente, recorre esos rangos de a 8 candidatos con SIMD (mascaras de rango y de
+//      radio) y acumula las sumas de las tres reglas; la direccion final es escalar.
+//   3. Integracion: SIMD sobre todos los agentes (quimiotaxis, velocidad limitada a
+//      [minSpeed, maxSpeed], posicion y envoltura del toro).
+// Los bloques del sort son fijos (no dependen de los threads) y las sumas de las fuerzas se
+// reducen en un orden fijo, asi que escalar, SSE2 y AVX2 dan los mismos bits con cualquier
+// cantidad de threads.
+
+enum class AgentMode
+{
+	Flocking,
+	Chemotaxis,
+};
+
+static const int kAgentSortChunks = 16;   // bloques fijos de agentes del counting sort
+static const int kAgentPad = 8;           // floats extra al final de cada array (lecturas de a 8)
+static const int kAgentChemoSources = 3;
+
+struct AgentParams
+{
+	float radius = 1.0f;            // radio de vecindad (= lado de la celda)
+	float separationRadius = 0.35f;
+	float minSpeed = 2.0f;          // unidades por segundo
+	float maxSpeed = 6.0f;
+	float separation = 24.0f;       // pesos de las reglas (aceleracion)
+	float alignment = 2.0f;
+	float cohesion = 1.5f;
+	float chemotaxis = 0.0f;        // ganancia del gradiente
+	float chemoSigma = 0.0f;        // ancho de las fuentes (0 = proporcional al mundo)
+};
+
+// Parametros por defecto de cada modo.
+AgentParams AgentParamsDefault(AgentMode mode);
+
+struct AgentWorld
+{
+	AgentMode mode = AgentMode::Flocking;
+	int count = 0;
+	int gridW = 0;                 // celdas
+	int gridH = 0;
+	float width = 0.0f;            // gridW * radius
+	float height = 0.0f;
+
+	// Estado (count + kAgentPad; el relleno queda en 0) y su copia ordenada por celda.
+	std::vector<float> x, y, vx, vy;
+	std::vector<float> sx, sy, svx, svy;
+	std::vector<float> ax, ay;                // aceleracion de las reglas de vecindad
+	std::vector<uint32_t> cell;               // celda de cada agente (antes del sort)
+	std::vector<uint32_t> histogram;          // kAgentSortChunks filas de gridW*gridH
+	std::vector<uint32_t> cellStart;          // gridW*gridH + 1: agentes de la celda c en [cellStart[c], cellStart[c+1])
+	std::vector<uint32_t> blockStart;         // scan del sort: inicio de cada bloque de celdas
+	std::vector<uint64_t> rowNeighbors;       // vecinos contados por fila de celdas en el ultimo tick
+
+	double time = 0.0;
+	uint64_t ticks = 0;
+
+	// Ultimo tick, en ms.
+	double sortMs = 0.0;
+	double forceMs = 0.0;
+	double integrateMs = 0.0;
+	double meanNeighbors = 0.0;
+};
+
+const char* AgentModeName(AgentMode mode);
+bool AgentModeFind(const char* name, AgentMode* mode);   // "flock", "chemo"
+
+// Reserva 'count' agentes con posiciones y velocidades pseudoaleatorias de 'seed' en un toro de
+// densidad ~4 agentes por celda. false si count < 1.
+bool AgentWorldInit(AgentWorld* world, AgentMode mode, int count, uint32_t seed, const AgentParams& params);
+
+// Un tick de 'dt' segundos. Si 'frameOut' no es null ahi van x, y, vx, vy de todos los agentes
+// (4 arrays de 'count' floats seguidos, en el orden del sort): lo que dibuja el render.
+void AgentWorldStep(AgentWorld* world, const AgentParams& params, float dt, float* frameOut, CpuShadePath path = CpuShadePath::Auto);
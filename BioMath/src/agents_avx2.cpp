@@ -0,0 +1,15 @@
+// Kernels AVX2 de los agentes (agents.h). Igual que cpu_renderer_avx2.cpp: unidad de compilacion
+// propia por -mavx2, solo se llama si GetCpuFeatures().avx2. Los templates son los mismos de los
+// otros caminos (agents_kernels.h), instanciados con 8 lanes.
+
+#include "agents_kernels.h"
+
+uint64_t AgentForceSpanAVX2(const AgentForceArgs& args, int row, int cell0, int cell1)
+{
+	return agents::ForceSpan<lanes::F8>(args, row, cell0, cell1);
+}
+
+void AgentIntegrateSpanAVX2(const AgentIntegrateArgs& args, int i0, int i1)
+{
+	agents::IntegrateSpan<lanes::F8>(args, i0, i1);
+}
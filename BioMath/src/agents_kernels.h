@@ -0,0 +1,284 @@
+#pragma once
+
+// Kernels de los agentes (agents.h), escritos una vez sobre los tipos de simd_lanes.h.
+// Los incluyen agents.cpp (F1, F4) y agents_avx2.cpp (F8).
+//
+// Fuerzas: los candidatos se recorren de a 8 con cualquier ancho (8 / kWidth grupos de
+// acumuladores), asi que el candidato j siempre cae en el acumulador j % 8 y las sumas se reducen
+// en el mismo orden con 1, 4 u 8 lanes (Sum8). Integracion: cada agente es independiente; la cola usa F1,
+// que hace las mismas operaciones que una lane.
+
+#include "cpu_renderer_internal.h"
+#include "simd_lanes.h"
+
+#include <string.h>
+#include <vector>
+
+namespace agents
+{
+	using namespace lanes;
+
+	static const int kBlock = 8;   // candidatos por vuelta, en todos los anchos
+
+	// Diferencia en el toro: lleva d a [-size/2, size/2].
+	template <typename V>
+	static inline V Wrap(V d, V size, V half, V negHalf)
+	{
+		return Select(half < d, d - size, Select(d < negHalf, d + size, d));
+	}
+
+	// Suma de los 8 acumuladores (candidato j en el acumulador j % 8), siempre en el orden
+	// ((t0+t4) + (t2+t6)) + ((t1+t5) + (t3+t7)): el que sale natural de sumar mitades en SIMD.
+	static inline float Sum8(const F1* t)
+	{
+		return ((t[0].v + t[4].v) + (t[2].v + t[6].v)) + ((t[1].v + t[5].v) + (t[3].v + t[7].v));
+	}
+
+	static inline float Sum4(__m128 s)   // s = (t0+t4, t1+t5, t2+t6, t3+t7)
+	{
+		s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+		return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+	}
+
+	static inline float Sum8(const F4* t)
+	{
+		return Sum4(_mm_add_ps(t[0].v, t[1].v));
+	}
+
+#if defined(_MSC_VER) || defined(__AVX2__)
+	static inline float Sum8(const F8* t)
+	{
+		return Sum4(_mm_add_ps(_mm256_castps256_ps128(t[0].v), _mm256_extractf128_ps(t[0].v, 1)));
+	}
+#endif
+
+	// Vecinos de la celda copiados juntos (SoA, con relleno de kBlock): los rangos de las tres
+	// filas quedan en un solo recorrido. Uno por thread.
+	struct Candidates
+	{
+		std::vector<float> data;
+		size_t capacity = 0;
+
+		float* X() { return data.data(); }
+		float* Y() { return data.data() + capacity; }
+		float* Vx() { return data.data() + capacity * 2; }
+		float* Vy() { return data.data() + capacity * 3; }
+
+		void Reserve(size_t n)
+		{
+			if (n + kBlock <= capacity) return;
+			capacity = (n + kBlock) * 2;
+			data.assign(capacity * 4, 0.0f);
+		}
+	};
+
+	// Sumas de un agente contra los 'n' candidatos. Con kWrap = false (celdas que no tocan el borde)
+	// no se envuelve la diferencia: ahi Wrap nunca cambia nada, asi que los bits son los mismos.
+	template <typename V, bool kWrap>
+	static inline void Accumulate(const AgentForceArgs& a, Candidates& cand, uint32_t n, float xs, float ys, float* sums)
+	{
+		typedef typename V::Mask M;
+		static const int kGroups = kBlock / V::kWidth;
+		alignas(32) static const float kLane[kBlock] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f };
+
+		const V zero(0.0f), one(1.0f);
+		const V radius2(a.radius2), separation2(a.separation2), invSeparation2(a.invSeparation2);
+		const V width(a.width), halfW(a.width * 0.5f), negHalfW(a.width * -0.5f);
+		const V height(a.height), halfH(a.height * 0.5f), negHalfH(a.height * -0.5f);
+		const V xi(xs), yi(ys);
+		const float* cx = cand.X();
+		const float* cy = cand.Y();
+		const float* cvx = cand.Vx();
+		const float* cvy = cand.Vy();
+
+		V count[kGroups], sumVx[kGroups], sumVy[kGroups], sumDx[kGroups], sumDy[kGroups], sepX[kGroups], sepY[kGroups];
+		for (int g = 0; g < kGroups; ++g)
+			count[g] = sumVx[g] = sumVy[g] = sumDx[g] = sumDy[g] = sepX[g] = sepY[g] = zero;
+
+		for (uint32_t j0 = 0; j0 < n; j0 += kBlock)
+		{
+			// Las lanes despues del ultimo candidato leen el relleno: la mascara las descarta.
+			const V remaining((float)(n - j0));
+			for (int g = 0; g < kGroups; ++g)
+			{
+				const uint32_t j = j0 + (uint32_t)(g * V::kWidth);
+				V dx = V::Load(cx + j) - xi;
+				V dy = V::Load(cy + j) - yi;
+				if (kWrap)
+				{
+					dx = Wrap(dx, width, halfW, negHalfW);
+					dy = Wrap(dy, height, halfH, negHalfH);
+				}
+				const V d2 = dx * dx + dy * dy;
+				const M in = (V::Load(kLane + g * V::kWidth) < remaining) & (zero < d2) & (d2 < radius2);   // 0 < d2: el propio agente no cuenta
+				const M near = in & (d2 < separation2);
+				const V w = (separation2 - d2) * invSeparation2;
+
+				count[g] = count[g] + Select(in, one, zero);
+				sumVx[g] = sumVx[g] + Select(in, V::Load(cvx + j), zero);
+				sumVy[g] = sumVy[g] + Select(in, V::Load(cvy + j), zero);
+				sumDx[g] = sumDx[g] + Select(in, dx, zero);
+				sumDy[g] = sumDy[g] + Select(in, dy, zero);
+				sepX[g] = sepX[g] - Select(near, dx * w, zero);
+				sepY[g] = sepY[g] - Select(near, dy * w, zero);
+			}
+		}
+
+		sums[0] = Sum8(count);
+		sums[1] = Sum8(sumVx);
+		sums[2] = Sum8(sumVy);
+		sums[3] = Sum8(sumDx);
+		sums[4] = Sum8(sumDy);
+		sums[5] = Sum8(sepX);
+		sums[6] = Sum8(sepY);
+	}
+
+	template <typename V>
+	static uint64_t ForceSpan(const AgentForceArgs& a, int row, int cell0, int cell1)
+	{
+		static thread_local Candidates cand;
+
+		const int gridW = a.gridW;
+		const int rows[3] = { (row + a.gridH - 1) % a.gridH, row, (row + 1) % a.gridH };
+		const bool edgeRow = row == 0 || row == a.gridH - 1;
+		uint64_t neighbors = 0;
+
+		for (int c = cell0; c < cell1; ++c)
+		{
+			// Celdas vecinas: cx-1..cx+1 de cada fila son contiguas salvo en los bordes, que envuelven.
+			const int cx = c - row * gridW;
+			uint32_t begin[6], end[6];
+			int ranges = 0;
+			uint32_t n = 0;
+			auto add = [&](int c0, int c1)
+			{
+				begin[ranges] = a.cellStart[c0];
+				end[ranges] = a.cellStart[c1];
+				n += end[ranges] - begin[ranges];
+				++ranges;
+			};
+			for (int r : rows)
+			{
+				const int base = r * gridW;
+				if (cx == 0)
+				{
+					add(base + gridW - 1, base + gridW);
+					add(base, base + 2);
+				}
+				else if (cx == gridW - 1)
+				{
+					add(base + gridW - 2, base + gridW);
+					add(base, base + 1);
+				}
+				else
+				{
+					add(base + cx - 1, base + cx + 2);
+				}
+			}
+
+			const uint32_t first = a.cellStart[c], last = a.cellStart[c + 1];
+			if (first == last) continue;
+
+			cand.Reserve(n);
+			uint32_t k = 0;
+			for (int r = 0; r < ranges; ++r)
+			{
+				const size_t bytes = (size_t)(end[r] - begin[r]) * sizeof(float);
+				memcpy(cand.X() + k, a.x + begin[r], bytes);
+				memcpy(cand.Y() + k, a.y + begin[r], bytes);
+				memcpy(cand.Vx() + k, a.vx + begin[r], bytes);
+				memcpy(cand.Vy() + k, a.vy + begin[r], bytes);
+				k += end[r] - begin[r];
+			}
+
+			const bool wrap = edgeRow || cx == 0 || cx == gridW - 1;
+			for (uint32_t i = first; i < last; ++i)
+			{
+				float t[7];
+				if (wrap)
+					Accumulate<V, true>(a, cand, n, a.x[i], a.y[i], t);
+				else
+					Accumulate<V, false>(a, cand, n, a.x[i], a.y[i], t);
+				const float count = t[0];
+
+				// Separacion siempre; alineacion (hacia la velocidad media) y cohesion (hacia el centro) con vecinos.
+				float ax = t[5] * a.separation;
+				float ay = t[6] * a.separation;
+				if (count > 0.0f)
+				{
+					const float inv = 1.0f / count;
+					ax = ax + (t[1] * inv - a.vx[i]) * a.alignment + t[3] * inv * a.cohesion;
+					ay = ay + (t[2] * inv - a.vy[i]) * a.alignment + t[4] * inv * a.cohesion;
+				}
+				a.ax[i] = ax;
+				a.ay[i] = ay;
+				neighbors += (uint64_t)count;
+			}
+		}
+		return neighbors;
+	}
+
+	template <typename V>
+	static inline void IntegrateLanes(const AgentIntegrateArgs& a, size_t i)
+	{
+		const V zero(0.0f), dt(a.dt);
+		const V width(a.width), halfW(a.width * 0.5f), negHalfW(a.width * -0.5f);
+		const V height(a.height), halfH(a.height * 0.5f), negHalfH(a.height * -0.5f);
+
+		V x = V::Load(a.x + i), y = V::Load(a.y + i);
+		V vx = V::Load(a.vx + i) + V::Load(a.ax + i) * dt;
+		V vy = V::Load(a.vy + i) + V::Load(a.ay + i) * dt;
+
+		// Quimiotaxis: gradiente de sum exp(-r^2 / 2 sigma^2) de las fuentes (sin el 1/sigma^2, va en la ganancia).
+		if (a.chemotaxis != 0.0f)
+		{
+			const V invTwoSigma2(a.chemoInvTwoSigma2);
+			V gx = zero, gy = zero;
+			for (int k = 0; k < 3; ++k)
+			{
+				const V dx = Wrap(V(a.chemoX[k]) - x, width, halfW, negHalfW);
+				const V dy = Wrap(V(a.chemoY[k]) - y, height, halfH, negHalfH);
+				const V g = Exp(zero - (dx * dx + dy * dy) * invTwoSigma2);
+				gx = gx + dx * g;
+				gy = gy + dy * g;
+			}
+			const V gain(a.chemotaxis * a.dt);
+			vx = vx + gx * gain;
+			vy = vy + gy * gain;
+		}
+
+		// Rapidez limitada a [minSpeed, maxSpeed], manteniendo la direccion.
+		const V speed = Sqrt(Max(vx * vx + vy * vy, V(1e-12f)));
+		const V scale = Min(Max(speed, V(a.minSpeed)), V(a.maxSpeed)) / speed;
+		vx = vx * scale;
+		vy = vy * scale;
+
+		// x + width puede redondear a width: el segundo Select lo deja en 0.
+		x = x + vx * dt;
+		y = y + vy * dt;
+		x = Select(x < zero, x + width, x);
+		x = Select(width <= x, x - width, x);
+		y = Select(y < zero, y + height, y);
+		y = Select(height <= y, y - height, y);
+
+		x.Store(a.x + i);
+		y.Store(a.y + i);
+		vx.Store(a.vx + i);
+		vy.Store(a.vy + i);
+		if (a.frameOut)
+		{
+			x.Store(a.frameOut + i);
+			y.Store(a.frameOut + a.count + i);
+			vx.Store(a.frameOut + a.count * 2 + i);
+			vy.Store(a.frameOut + a.count * 3 + i);
+		}
+	}
+
+	template <typename V>
+	static void IntegrateSpan(const AgentIntegrateArgs& a, int i0, int i1)
+	{
+		int i = i0;
+		for (; i + V::kWidth <= i1; i += V::kWidth) IntegrateLanes<V>(a, (size_t)i);
+		for (; i < i1; ++i) IntegrateLanes<F1>(a, (size_t)i);
+	}
+}
@@ -0,0 +1,343 @@
+#include "agents_render.h"
+#include "frame_stats.h"
+#include "gl_state.h"
+#include "parallel.h"
+#include "platform.h"
+#include "profiler.h"
+#include "shader_program.h"
+#include "stream_buffer.h"
+#include "triple_buffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Un tick ya en el layout del vertex buffer: [x | y | vx | vy], 'count' floats cada uno. Los slots
+// se reservan al iniciar: publicar no aloca.
+struct AgentsFrame
+{
+	double time = 0.0;
+	std::vector<float> data;
+};
+
+struct AgentsState
+{
+	AgentsOptions options;
+	bool active = false;
+	bool prepared = false;    // AgentsPrepare corrio y su resultado espera a AgentsInit
+	bool ready = false;       // el mundo esta sembrado y su estado inicial publicado
+	AgentParams params;
+	AgentWorld world;
+	TripleBuffer<AgentsFrame> frames;
+	size_t bytes = 0;
+
+	// Lo toca solo quien corre los ticks; se lee despues de SimShutdown.
+	uint64_t ticks = 0;
+	uint64_t published = 0;
+	double tickSeconds = 0.0;
+	double neighborSum = 0.0;
+	std::vector<double> tickMs;
+	std::vector<double> sortMs;
+	std::vector<double> forceMs;
+	std::vector<double> integrateMs;
+	size_t tickCount = 0;
+
+	// Render
+	GLuint program = 0;
+	GLint uScale = -1;
+	GLint uOffset = -1;
+	GLint uSize = -1;
+	GLuint vaos[kStreamSegments] = {};   // uno por segmento del stream: los offsets son fijos
+	StreamBuffer stream;
+	uint64_t uploaded = 0;
+	uint64_t mapFailures = 0;
+	std::vector<double> uploadMs;
+	size_t uploadCount = 0;
+};
+
+static AgentsState g_agents;
+
+// Margen alrededor del mundo, en coordenadas de clip, y largo de cada triangulo en pixels.
+static const float kAgentsExtent = 0.95f;
+static const float kAgentsSizePixels = 3.0f;
+static const float kAgentsTickSeconds = 1.0f / 120.0f;
+
+bool ParseAgentsOptions(int argc, char** argv, AgentsOptions* opts)
+{
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--agents") == 0)
+		{
+			opts->enabled = true;
+			if (!AgentModeFind(argv[++i], &opts->mode))
+			{
+				PlatformAttachConsole();
+				fprintf(stderr, "unknown agents mode '%s'; available: flock chemo\n", argv[i]);
+				return false;
+			}
+		}
+		else if (strcmp(argv[i], "--agents-count") == 0)
+			opts->count = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--agents-seed") == 0)
+			opts->seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+	}
+
+	if (opts->count < 1) opts->count = 1;
+	if (opts->count > 8000000) opts->count = 8000000;
+	return true;
+}
+
+static double MsSince(uint64_t startTicks)
+{
+	return (double)(PlatformTicks() - startTicks) * 1000.0 / (double)PlatformTickFrequency();
+}
+
+// Tambien despues de un hot reload (ShaderWatch).
+static void LocateUniforms(GLuint program)
+{
+	g_agents.uScale = glGetUniformLocation_ptr(program, "uScale");
+	g_agents.uOffset = glGetUniformLocation_ptr(program, "uOffset");
+	g_agents.uSize = glGetUniformLocation_ptr(program, "uSize");
+}
+
+static bool CreateGLObjects()
+{
+	ShaderFile file;
+	std::string error;
+	if (!ShaderFileLoad("agents.glsl", &file, &error))
+	{
+		fprintf(stderr, "agents: %s\n", error.c_str());
+		return false;
+	}
+	g_agents.program = ShaderBuildProgram(file, nullptr, &error);
+	if (!g_agents.program)
+	{
+		fprintf(stderr, "agents: shader failed:\n%s\n", error.c_str());
+		return false;
+	}
+	LocateUniforms(g_agents.program);
+	ShaderWatch("agents.glsl", file, nullptr, &g_agents.program, LocateUniforms);
+
+	// x, y, vx, vy en locations 0..3, un float por instancia cada uno, del mismo segmento.
+	if (!StreamBufferInit(&g_agents.stream, GL_ARRAY_BUFFER, g_agents.bytes))
+		return false;
+	for (int s = 0; s < g_agents.stream.segments; ++s)
+	{
+		const size_t base = StreamBufferSegmentOffset(g_agents.stream, s);
+		glGenVertexArrays_ptr(1, &g_agents.vaos[s]);
+		GLStateBindVertexArray(g_agents.vaos[s]);
+		GLStateBindBuffer(GL_ARRAY_BUFFER, g_agents.stream.buffer);
+		for (GLuint a = 0; a < 4; ++a)
+		{
+			glEnableVertexAttribArray_ptr(a);
+			glVertexAttribPointer_ptr(a, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(base + g_agents.bytes / 4 * a));
+			glVertexAttribDivisor_ptr(a, 1);
+		}
+	}
+	GLStateBindVertexArray(0);
+	GLStateBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	const GLenum glError = glGetError();
+	if (glError != GL_NO_ERROR)
+	{
+		fprintf(stderr, "agents: vertex buffer setup failed (0x%04X)\n", glError);
+		return false;
+	}
+	return true;
+}
+
+static void DeleteGLObjects()
+{
+	StreamBufferShutdown(&g_agents.stream);
+	for (GLuint& vao : g_agents.vaos)
+	{
+		GLStateDeleteVertexArray(vao);
+		vao = 0;
+	}
+	ShaderUnwatch(&g_agents.program);
+	GLStateDeleteProgram(g_agents.program);
+	g_agents.program = 0;
+}
+
+void AgentsPrepare(const AgentsOptions& opts)
+{
+	g_agents.options = opts;
+	g_agents.prepared = true;
+	g_agents.ready = false;
+	if (!opts.enabled) return;
+	PROFILE_ZONE("AgentsPrepare");
+
+	g_agents.params = AgentParamsDefault(opts.mode);
+	if (!AgentWorldInit(&g_agents.world, opts.mode, opts.count, opts.seed, g_agents.params))
+		return;
+
+	const size_t floats = (size_t)opts.count * 4;
+	g_agents.bytes = floats * sizeof(float);
+	for (auto& slot : g_agents.frames.slots)
+		slot.value.data.assign(floats, 0.0f);
+	for (std::vector<double>* v : { &g_agents.tickMs, &g_agents.sortMs, &g_agents.forceMs, &g_agents.integrateMs, &g_agents.uploadMs })
+		v->assign(kAgentsTimingSamples, 0.0);
+
+	// Un tick congelado (dt = 0) ya escribe el estado inicial en el primer slot: el primer frame
+	// tiene algo que dibujar.
+	AgentsFrame& frame = g_agents.frames.Write();
+	AgentWorldStep(&g_agents.world, g_agents.params, 0.0f, frame.data.data());
+	frame.time = g_agents.world.time;
+	g_agents.frames.Publish();
+	++g_agents.published;
+	g_agents.ready = true;
+}
+
+bool AgentsInit(const AgentsOptions& opts)
+{
+	if (!g_agents.prepared) AgentsPrepare(opts);
+	g_agents.prepared = false;
+	g_agents.active = false;
+	if (!opts.enabled || !g_agents.ready) return false;
+	if (!glDrawArraysInstanced_ptr || !glVertexAttribDivisor_ptr)
+	{
+		fprintf(stderr, "agents: instanced drawing not available, agents disabled\n");
+		g_agents.world = AgentWorld();
+		return false;
+	}
+	if (!glMapBufferRange_ptr || !glUnmapBuffer_ptr)
+	{
+		fprintf(stderr, "agents: glMapBufferRange not available, agents disabled\n");
+		g_agents.world = AgentWorld();
+		return false;
+	}
+	PROFILE_ZONE("AgentsInit");
+
+	if (!CreateGLObjects())
+	{
+		DeleteGLObjects();
+		g_agents.world = AgentWorld();
+		return false;
+	}
+	g_agents.active = true;
+	return true;
+}
+
+void AgentsShutdown()
+{
+	DeleteGLObjects();
+	g_agents.active = false;
+}
+
+bool AgentsActive()
+{
+	return g_agents.active;
+}
+
+void AgentsTick(int timeScaleQuarters)
+{
+	if (!g_agents.active || timeScaleQuarters <= 0) return; // congelado: nada nuevo que publicar
+
+	PROFILE_ZONE("AgentsTick");
+	const uint64_t t0 = PlatformTicks();
+
+	// La integracion escribe en el slot que se publica.
+	AgentsFrame& frame = g_agents.frames.Write();
+	AgentWorldStep(&g_agents.world, g_agents.params, kAgentsTickSeconds * (float)timeScaleQuarters * 0.25f, frame.data.data());
+	frame.time = g_agents.world.time;
+	g_agents.frames.Publish();
+	++g_agents.published;
+	++g_agents.ticks;
+
+	const double ms = MsSince(t0);
+	const size_t sample = g_agents.tickCount++ % kAgentsTimingSamples;
+	g_agents.tickSeconds += ms * 1e-3;
+	g_agents.neighborSum += g_agents.world.meanNeighbors;
+	g_agents.tickMs[sample] = ms;
+	g_agents.sortMs[sample] = g_agents.world.sortMs;
+	g_agents.forceMs[sample] = g_agents.world.forceMs;
+	g_agents.integrateMs[sample] = g_agents.world.integrateMs;
+}
+
+static void Upload()
+{
+	PROFILE_ZONE("AgentsUpload");
+	const uint64_t t0 = PlatformTicks();
+
+	StreamWrite w;
+	if (StreamBufferBegin(&g_agents.stream, &w))
+	{
+		memcpy(w.data, g_agents.frames.Read().data.data(), g_agents.bytes);
+		if (StreamBufferEnd(&g_agents.stream, g_agents.bytes))
+			++g_agents.uploaded;
+		else
+			++g_agents.mapFailures; // el contenido se perdio: se dibuja lo que haya y se sube el proximo
+	}
+	else
+	{
+		++g_agents.mapFailures;
+	}
+
+	g_agents.uploadMs[g_agents.uploadCount++ % kAgentsTimingSamples] = MsSince(t0);
+}
+
+void AgentsDraw(int outputWidth, int outputHeight)
+{
+	if (!g_agents.active) return;
+	if (g_agents.frames.Acquire()) Upload();
+
+	PROFILE_GPU_ZONE("Agents");
+	const float w = (float)(outputWidth > 0 ? outputWidth : 1);
+	const float h = (float)(outputHeight > 0 ? outputHeight : 1);
+
+	// El mundo (cuadrado) centrado y entero en pantalla: [0, width] -> [-e, e] en el eje corto.
+	const float fitX = h < w ? h / w : 1.0f;
+	const float fitY = w < h ? w / h : 1.0f;
+	const float scaleX = 2.0f * kAgentsExtent * fitX / g_agents.world.width;
+	const float scaleY = 2.0f * kAgentsExtent * fitY / g_agents.world.height;
+
+	GLStateViewport(0, 0, (GLsizei)w, (GLsizei)h);
+	GLStateUseProgram(g_agents.program);
+	GLStateUniform2f(g_agents.uScale, scaleX, scaleY);
+	GLStateUniform2f(g_agents.uOffset, -kAgentsExtent * fitX, -kAgentsExtent * fitY);
+	GLStateUniform2f(g_agents.uSize, 2.0f * kAgentsSizePixels / w, 2.0f * kAgentsSizePixels / h);
+	GLStateBindVertexArray(g_agents.vaos[g_agents.stream.segment]);
+
+	// El blending solo lo usa este draw: se prende y se apaga aca (gl_state.h no lo sigue).
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE);
+	GLStateDrawArraysInstanced(GL_TRIANGLES, 0, 3, g_agents.world.count);
+	glDisable(GL_BLEND);
+	StreamBufferFence(&g_agents.stream);
+}
+
+void WriteAgentsJson(FILE* f)
+{
+	if (!g_agents.active)
+	{
+		fprintf(f, "\"agents\": { \"enabled\": false }");
+		return;
+	}
+
+	const AgentWorld& w = g_agents.world;
+	const double agentTicksPerSecond = g_agents.tickSeconds > 0.0 ? (double)g_agents.ticks * (double)w.count / g_agents.tickSeconds : 0.0;
+	fprintf(f, "\"agents\": { \"enabled\": true, \"mode\": \"%s\", \"agents\": %d, \"grid\": [%d, %d]",
+		AgentModeName(w.mode), w.count, w.gridW, w.gridH);
+	fprintf(f, ", \"path\": \"%s\", \"threads\": %d, \"ticks\": %llu, \"sim_time\": %.3f, \"mean_neighbors\": %.2f",
+		CpuShadePathName(CpuResolveShadePath(CpuShadePath::Auto)), ParallelThreadCount(), (unsigned long long)g_agents.ticks,
+		w.time, g_agents.ticks ? g_agents.neighborSum / (double)g_agents.ticks : 0.0);
+	fprintf(f, ", \"magent_ticks_per_s\": %.2f", agentTicksPerSecond * 1e-6);
+	fprintf(f, ", \"published\": %llu, \"uploaded\": %llu, \"dropped\": %llu, \"map_failures\": %llu, ",
+		(unsigned long long)g_agents.published, (unsigned long long)g_agents.uploaded,
+		(unsigned long long)(g_agents.published - g_agents.uploaded - g_agents.mapFailures), (unsigned long long)g_agents.mapFailures);
+	const size_t ticks = g_agents.tickCount < kAgentsTimingSamples ? g_agents.tickCount : kAgentsTimingSamples;
+	const size_t uploads = g_agents.uploadCount < kAgentsTimingSamples ? g_agents.uploadCount : kAgentsTimingSamples;
+	WriteTimingSummaryJson(f, "tick_ms", SummarizeTimings(g_agents.tickMs.data(), ticks));
+	fprintf(f, ", ");
+	WriteTimingSummaryJson(f, "sort_ms", SummarizeTimings(g_agents.sortMs.data(), ticks));
+	fprintf(f, ", ");
+	WriteTimingSummaryJson(f, "force_ms", SummarizeTimings(g_agents.forceMs.data(), ticks));
+	fprintf(f, ", ");
+	WriteTimingSummaryJson(f, "integrate_ms", SummarizeTimings(g_agents.integrateMs.data(), ticks));
+	fprintf(f, ", ");
+	WriteTimingSummaryJson(f, "upload_ms", SummarizeTimings(g_agents.uploadMs.data(), uploads));
+	fprintf(f, ", ");
+	WriteStreamBufferJson(f, g_agents.stream);
+	fprintf(f, " }");
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "agents.h"
+#include "gl_api.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+// ---------------------------
+// Agentes en pantalla
+// ---------------------------
+
+// Con --agents flock|chemo el frame lleva encima una simulacion de agentes (agents.h): por defecto
+// un millon, cada uno un triangulito orientado segun su velocidad y coloreado por su rumbo.
+//
+// El mundo avanza en el thread de simulacion (simulation.h): cada tick es 1/120 s escalado por la
+// velocidad (Up/Down, en cuartos; a 0 se congela). La integracion escribe x, y, vx, vy
+// directamente en el slot del triple buffer que se va a publicar (sin copia extra), con el layout
+// del vertex buffer: [x de todos | y | vx | vy]. El render toma la ultima publicacion, la copia al
+// segmento siguiente de un StreamBuffer (stream_buffer.h; un VAO por segmento) y dibuja todo con
+// un solo glDrawArraysInstanced: 3 vertices por instancia, los cuatro atributos con divisor 1
+// (shaders/agents.glsl arma el triangulo con gl_VertexID). Blending aditivo, a la resolucion de salida, despues del upsample de la escena.
+//
+// En headless no hay thread de simulacion: el loop de headless.cpp llama a AgentsTick antes de
+// cada frame (un tick por frame, velocidad 1x).
+
+struct AgentsOptions
+{
+	bool enabled = false;
+	AgentMode mode = AgentMode::Flocking;
+	int count = 1000000;
+	uint32_t seed = 1;
+};
+
+static const size_t kAgentsTimingSamples = 1 << 16;
+
+// --agents flock|chemo (lo prende), --agents-count N, --agents-seed N. false si el modo no existe.
+bool ParseAgentsOptions(int argc, char** argv, AgentsOptions* opts);
+
+// La parte de CPU de AgentsInit, sin GL: siembra el mundo y publica su estado inicial. Puede correr
+// en otro thread mientras se crea el contexto (startup.h).
+void AgentsPrepare(const AgentsOptions& opts);
+
+// Requiere contexto GL: siembra el mundo (si no se llamo a AgentsPrepare) y crea el programa y los
+// buffers. Si falta algo (instancing, glMapBufferRange) queda apagado y el motivo va a stderr.
+bool AgentsInit(const AgentsOptions& opts);
+void AgentsShutdown();   // despues de SimShutdown
+bool AgentsActive();
+
+// Thread de simulacion (o el loop en headless): un tick. 'timeScaleQuarters' = velocidad en cuartos.
+void AgentsTick(int timeScaleQuarters);
+
+// Render: sube la ultima publicacion (si hay una nueva) y dibuja los agentes sobre lo que haya en
+// el framebuffer bindeado. Una vez por frame, despues de la escena.
+void AgentsDraw(int outputWidth, int outputHeight);
+
+// "agents": { ... } para los reportes JSON. Despues de SimShutdown.
+void WriteAgentsJson(FILE* f);
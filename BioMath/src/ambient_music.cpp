@@ -0,0 +1,148 @@
+#include "ambient_music.h"
+
+static const int kMaxCatchUpSteps = 4;
+
+// La menor / Fa / Do / Sol, en notas MIDI (raiz, tercera, quinta).
+static const int kChords[4][3] = {
+	{ 57, 60, 64 },
+	{ 53, 57, 60 },
+	{ 48, 52, 55 },
+	{ 55, 59, 62 },
+};
+
+// Pentatonica de La menor, dos octavas arriba del acorde.
+static const int kPentatonic[] = { 69, 72, 74, 76, 79, 81, 84 };
+
+void AmbientMusicInit(AmbientMusic* music, uint32_t seed)
+{
+	*music = AmbientMusic();
+	music->rng = seed ? seed : 1;
+}
+
+static uint32_t NextRandom(AmbientMusic* music)
+{
+	uint32_t x = music->rng;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	music->rng = x;
+	return x;
+}
+
+static float RandomUnit(AmbientMusic* music)
+{
+	return (float)(NextRandom(music) >> 8) / 16777216.0f;
+}
+
+// Pads y bajo con prioridad normal; arpegio y hat bajos: son los primeros en ceder la voz a un
+// efecto si el pool se llena.
+static void PlayNote(AmbientMusic* music, int64_t step, int lengthSteps, int midiNote, float velocity, uint8_t priority,
+	const SynthPatch& patch, SynthPostFn post, void* ctx)
+{
+	SynthCommand cmd;
+	cmd.type = SynthCommandType::NoteOn;
+	cmd.priority = priority;
+	cmd.note = music->nextNoteId++;
+	cmd.freqHz = SynthMidiToHz((float)midiNote);
+	cmd.velocity = velocity;
+	cmd.patch = patch;
+	post(ctx, cmd);
+
+	for (int i = 0; i < kAmbientPendingOffs; ++i)
+	{
+		if (music->offNote[i]) continue;
+		music->offNote[i] = cmd.note;
+		music->offStep[i] = step + lengthSteps;
+		return;
+	}
+	// Sin slot: la nota se suelta ya (se escucha el release).
+	cmd.type = SynthCommandType::NoteOff;
+	post(ctx, cmd);
+}
+
+static void RunStep(AmbientMusic* music, int64_t step, SynthPostFn post, void* ctx)
+{
+	for (int i = 0; i < kAmbientPendingOffs; ++i)
+	{
+		if (!music->offNote[i] || music->offStep[i] > step) continue;
+		SynthCommand off;
+		off.type = SynthCommandType::NoteOff;
+		off.note = music->offNote[i];
+		post(ctx, off);
+		music->offNote[i] = 0;
+	}
+
+	const int* chord = kChords[(step / 16) % 4];
+
+	if (step % 16 == 0)
+	{
+		SynthPatch pad;
+		pad.wave = SynthWave::Saw;
+		pad.attack = 1.2f;
+		pad.decay = 1.0f;
+		pad.sustain = 0.7f;
+		pad.release = 2.0f;
+		pad.cutoffHz = 900.0f;
+		pad.resonance = 0.3f;
+		pad.gain = 0.08f;
+		for (int i = 0; i < 3; ++i)
+		{
+			pad.pan = (float)(i - 1) * 0.6f;
+			PlayNote(music, step, 16, chord[i], 1.0f, kSynthPriorityNormal, pad, post, ctx);
+		}
+	}
+
+	if (step % 4 == 0)
+	{
+		SynthPatch bass;
+		bass.wave = SynthWave::Sine;
+		bass.attack = 0.01f;
+		bass.decay = 0.6f;
+		bass.sustain = 0.4f;
+		bass.release = 0.3f;
+		bass.cutoffHz = 1e9f;
+		bass.gain = 0.22f;
+		PlayNote(music, step, 3, chord[0] - 24, 1.0f, kSynthPriorityNormal, bass, post, ctx);
+	}
+
+	if (RandomUnit(music) < 0.55f)
+	{
+		SynthPatch arp;
+		arp.wave = RandomUnit(music) < 0.5f ? SynthWave::Square : SynthWave::Saw;
+		arp.attack = 0.005f;
+		arp.decay = 0.25f;
+		arp.sustain = 0.0f;
+		arp.release = 0.4f;
+		arp.cutoffHz = 1800.0f + 2500.0f * RandomUnit(music);
+		arp.resonance = 0.5f;
+		arp.pan = RandomUnit(music) * 1.6f - 0.8f;
+		arp.gain = 0.07f;
+		const int note = kPentatonic[NextRandom(music) % (sizeof(kPentatonic) / sizeof(kPentatonic[0]))];
+		PlayNote(music, step, 1, note, 0.6f + 0.4f * RandomUnit(music), kSynthPriorityLow, arp, post, ctx);
+	}
+
+	// Un golpe de ruido filtrado en los tiempos 2 y 4.
+	if (step % 8 == 4)
+	{
+		SynthPatch hat;
+		hat.wave = SynthWave::Noise;
+		hat.attack = 0.001f;
+		hat.decay = 0.08f;
+		hat.sustain = 0.0f;
+		hat.release = 0.05f;
+		hat.cutoffHz = 7000.0f;
+		hat.resonance = 0.1f;
+		hat.pan = 0.3f;
+		hat.gain = 0.05f;
+		PlayNote(music, step, 1, 60, 1.0f, kSynthPriorityLow, hat, post, ctx);
+	}
+}
+
+void AmbientMusicUpdate(AmbientMusic* music, double timeSeconds, SynthPostFn post, void* ctx)
+{
+	const int64_t current = (int64_t)(timeSeconds / kAmbientStepSeconds);
+	if (current - music->nextStep > kMaxCatchUpSteps) music->nextStep = current;
+
+	while (music->nextStep <= current)
+		RunStep(music, music->nextStep++, post, ctx);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "synth.h"
+
+// ---------------------------
+// Musica procedural de fondo
+// ---------------------------
+
+// Secuenciador generativo chico: progresion de acordes con pads filtrados, bajo y un arpegio
+// pentatonico aleatorio (pero reproducible con la semilla). No produce audio: emite SynthCommand
+// por 'post', asi el mismo codigo alimenta la cola del thread de audio (audio_engine.h) y el
+// render offline a WAV (BioMathBench synth --wav).
+
+typedef void (*SynthPostFn)(void* ctx, const SynthCommand& cmd);
+
+static const double kAmbientStepSeconds = 60.0 / 84.0 / 2.0; // corcheas a 84 BPM
+static const int kAmbientPendingOffs = 32;
+
+struct AmbientMusic
+{
+	uint32_t rng = 1;
+	uint32_t nextNoteId = 1;
+	int64_t nextStep = 0;
+
+	// Notas a soltar: id y paso en el que termina (0 = slot libre).
+	uint32_t offNote[kAmbientPendingOffs] = {};
+	int64_t offStep[kAmbientPendingOffs] = {};
+};
+
+void AmbientMusicInit(AmbientMusic* music, uint32_t seed);
+
+// Emite los comandos de todos los pasos que empiezan antes de 'timeSeconds'. Si se atraso mucho
+// (ventana arrastrada, breakpoint) salta al paso actual en vez de disparar todo junto.
+void AmbientMusicUpdate(AmbientMusic* music, double timeSeconds, SynthPostFn post, void* ctx);
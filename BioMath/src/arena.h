@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ---------------------------
+// Arena lineal
+// ---------------------------
+
+// Bump allocator sobre un buffer que pone quien lo usa (normalmente un array fijo dentro de su
+// estado). Alocar es sumar un offset; no hay free: todo se libera junto con ArenaReset, p.ej. al
+// principio de cada bloque de audio. Nunca llama al heap, asi que sirve en threads de tiempo real.
+//
+// Si no alcanza devuelve nullptr y cuenta la falla: el que pide decide como degradar. highWater
+// guarda el maximo usado, para dimensionar el buffer con datos.
+
+struct Arena
+{
+	uint8_t* base = nullptr;
+	size_t capacity = 0;
+	size_t used = 0;
+	size_t highWater = 0;
+	uint32_t failures = 0;
+};
+
+inline void ArenaInit(Arena* arena, void* buffer, size_t capacity)
+{
+	arena->base = (uint8_t*)buffer;
+	arena->capacity = capacity;
+	arena->used = 0;
+	arena->highWater = 0;
+	arena->failures = 0;
+}
+
+inline void ArenaReset(Arena* arena)
+{
+	arena->used = 0;
+}
+
+// 'align' potencia de 2. La memoria no se inicializa.
+inline void* ArenaAlloc(Arena* arena, size_t bytes, size_t align = 16)
+{
+	const uintptr_t start = ((uintptr_t)arena->base + arena->used + (align - 1)) & ~(uintptr_t)(align - 1);
+	const size_t end = (size_t)(start - (uintptr_t)arena->base) + bytes;
+	if (end > arena->capacity)
+	{
+		++arena->failures;
+		return nullptr;
+	}
+	arena->used = end;
+	if (end > arena->highWater) arena->highWater = end;
+	return (void*)start;
+}
+
+template <typename T>
+inline T* ArenaAllocArray(Arena* arena, size_t count, size_t align = alignof(T) > 16 ? alignof(T) : 16)
+{
+	return (T*)ArenaAlloc(arena, count * sizeof(T), align);
+}
@@ -0,0 +1,306 @@
+#include "asset_pack.h"
+#include "lz4_block.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+static const char kAssetPackMagic[4] = { 'B', 'M', 'P', 'K' };
+
+uint64_t AssetPackHashName(const char* name, size_t bytes)
+{
+	uint64_t h = 0xCBF29CE484222325ull;
+	for (size_t i = 0; i < bytes; ++i)
+	{
+		h ^= (uint8_t)name[i];
+		h *= 0x100000001B3ull;
+	}
+	return h;
+}
+
+static uint64_t Rotl64(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+// De a 8 bytes con multiplicaciones (estilo murmur3): varios GB/s, suficiente para detectar un
+// archivo corrupto o truncado. No es criptografico.
+uint64_t AssetPackChecksum(const uint8_t* data, size_t bytes)
+{
+	uint64_t h = 0x9E3779B97F4A7C15ull ^ bytes;
+	size_t i = 0;
+	for (; i + 8 <= bytes; i += 8)
+	{
+		uint64_t w;
+		memcpy(&w, data + i, sizeof(w));
+		h ^= w * 0x87C37B91114253D5ull;
+		h = Rotl64(h, 31) * 0x4CF5AD432745937Full;
+	}
+	if (i < bytes)
+	{
+		uint64_t w = 0;
+		memcpy(&w, data + i, bytes - i);
+		h ^= w * 0x87C37B91114253D5ull;
+		h = Rotl64(h, 31) * 0x4CF5AD432745937Full;
+	}
+	h ^= h >> 33;
+	h *= 0xFF51AFD7ED558CCDull;
+	h ^= h >> 33;
+	return h;
+}
+
+static uint64_t AlignUp(uint64_t x)
+{
+	return (x + kAssetPackAlign - 1) & ~(uint64_t)(kAssetPackAlign - 1);
+}
+
+// ---------------------------
+// Escritura
+// ---------------------------
+
+struct PackedEntry
+{
+	const AssetPackSource* source;
+	uint64_t nameHash;
+	std::vector<uint8_t> compressed;   // vacio: se guarda tal cual
+};
+
+static bool WritePadding(FILE* f, uint64_t* position, uint64_t target)
+{
+	static const uint8_t kZeros[kAssetPackAlign] = {};
+	const size_t pad = (size_t)(target - *position);
+	*position = target;
+	return pad == 0 || fwrite(kZeros, 1, pad, f) == pad;
+}
+
+bool AssetPackWrite(const char* path, const std::vector<AssetPackSource>& sources, const AssetPackWriteOptions& options,
+	AssetPackWriteStats* stats, std::string* error)
+{
+	*stats = AssetPackWriteStats();
+
+	std::vector<PackedEntry> entries(sources.size());
+	for (size_t i = 0; i < sources.size(); ++i)
+	{
+		entries[i].source = &sources[i];
+		entries[i].nameHash = AssetPackHashName(sources[i].name.c_str(), sources[i].name.size());
+	}
+	std::sort(entries.begin(), entries.end(), [](const PackedEntry& a, const PackedEntry& b)
+	{
+		return a.nameHash != b.nameHash ? a.nameHash < b.nameHash : a.source->name < b.source->name;
+	});
+	for (size_t i = 1; i < entries.size(); ++i)
+	{
+		if (entries[i].source->name == entries[i - 1].source->name)
+		{
+			*error = "duplicate asset name '" + entries[i].source->name + "'";
+			return false;
+		}
+	}
+
+	if (options.lz4)
+	{
+		ParallelFor((int)entries.size(), 1, [&](int begin, int end)
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				PackedEntry& e = entries[i];
+				const std::vector<uint8_t>& data = e.source->data;
+				if (!e.source->allowCompression || data.empty()) continue;
+				e.compressed.resize(Lz4CompressBound(data.size()));
+				const size_t stored = Lz4Compress(data.data(), data.size(), e.compressed.data(), e.compressed.size());
+				if (stored == 0 || (double)stored > (double)data.size() * (1.0 - options.minSavings))
+				{
+					std::vector<uint8_t>().swap(e.compressed);
+					continue;
+				}
+				e.compressed.resize(stored);
+			}
+		});
+	}
+
+	// Layout: header, TOC, nombres y datos, cada uno alineado.
+	AssetPackHeader header = {};
+	memcpy(header.magic, kAssetPackMagic, sizeof(kAssetPackMagic));
+	header.version = kAssetPackVersion;
+	header.entryCount = (uint32_t)entries.size();
+	header.alignment = kAssetPackAlign;
+	header.tocOffset = sizeof(AssetPackHeader);
+	header.namesOffset = header.tocOffset + sizeof(AssetPackEntry) * entries.size();
+
+	std::vector<AssetPackEntry> toc(entries.size());
+	std::string names;
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		const PackedEntry& e = entries[i];
+		AssetPackEntry& t = toc[i];
+		t = AssetPackEntry();
+		t.nameHash = e.nameHash;
+		t.nameOffset = (uint32_t)names.size();
+		t.nameBytes = (uint32_t)e.source->name.size();
+		names += e.source->name;
+		names += '\0';
+	}
+	header.namesBytes = names.size();
+	header.dataOffset = AlignUp(header.namesOffset + header.namesBytes);
+
+	uint64_t offset = header.dataOffset;
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		const PackedEntry& e = entries[i];
+		AssetPackEntry& t = toc[i];
+		const std::vector<uint8_t>& data = e.source->data;
+		t.offset = offset;
+		t.bytes = data.size();
+		t.compression = (uint32_t)(e.compressed.empty() ? AssetCompression::None : AssetCompression::Lz4);
+		t.storedBytes = e.compressed.empty() ? data.size() : e.compressed.size();
+		t.checksum = AssetPackChecksum(data.data(), data.size());
+		offset = AlignUp(offset + t.storedBytes);
+
+		++stats->entries;
+		if (!e.compressed.empty()) ++stats->compressed;
+		stats->rawBytes += t.bytes;
+	}
+	header.fileBytes = offset;
+	stats->fileBytes = offset;
+
+	// Igual que los caches: se escribe aparte y se renombra, nunca queda un paquete a medias.
+	const std::string tmpPath = std::string(path) + ".tmp";
+	FILE* f = fopen(tmpPath.c_str(), "wb");
+	if (!f)
+	{
+		*error = "cannot create '" + tmpPath + "'";
+		return false;
+	}
+	uint64_t position = 0;
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	position += sizeof(header);
+	ok = ok && (toc.empty() || fwrite(toc.data(), sizeof(AssetPackEntry), toc.size(), f) == toc.size());
+	position += sizeof(AssetPackEntry) * toc.size();
+	ok = ok && fwrite(names.data(), 1, names.size(), f) == names.size();
+	position += names.size();
+	for (size_t i = 0; i < entries.size() && ok; ++i)
+	{
+		const PackedEntry& e = entries[i];
+		const uint8_t* data = e.compressed.empty() ? e.source->data.data() : e.compressed.data();
+		ok = WritePadding(f, &position, toc[i].offset) &&
+			fwrite(data, 1, (size_t)toc[i].storedBytes, f) == (size_t)toc[i].storedBytes;
+		position += toc[i].storedBytes;
+	}
+	ok = ok && WritePadding(f, &position, header.fileBytes);
+	if (fclose(f) != 0 || !ok)
+	{
+		remove(tmpPath.c_str());
+		*error = "cannot write '" + tmpPath + "'";
+		return false;
+	}
+	remove(path); // rename no pisa en Windows
+	if (rename(tmpPath.c_str(), path) != 0)
+	{
+		remove(tmpPath.c_str());
+		*error = std::string("cannot rename to '") + path + "'";
+		return false;
+	}
+	return true;
+}
+
+// ---------------------------
+// Lectura
+// ---------------------------
+
+static bool Fail(AssetPack* pack, std::string* error, const char* path, const char* what)
+{
+	AssetPackClose(pack);
+	*error = std::string(path) + ": " + what;
+	return false;
+}
+
+bool AssetPackOpen(const char* path, AssetPack* pack, std::string* error)
+{
+	*pack = AssetPack();
+	if (!PlatformMapFile(path, &pack->mapping))
+		return Fail(pack, error, path, "cannot open");
+
+	const uint8_t* base = pack->mapping.data;
+	const uint64_t size = pack->mapping.size;
+	if (size < sizeof(AssetPackHeader))
+		return Fail(pack, error, path, "too small for a header");
+
+	const AssetPackHeader* h = (const AssetPackHeader*)base;
+	if (memcmp(h->magic, kAssetPackMagic, sizeof(kAssetPackMagic)) != 0)
+		return Fail(pack, error, path, "not an asset pack");
+	if (h->version != kAssetPackVersion || h->alignment != (uint32_t)kAssetPackAlign)
+		return Fail(pack, error, path, "unsupported version");
+	if (h->fileBytes != size)
+		return Fail(pack, error, path, "truncated");
+	if (h->tocOffset % kAssetPackAlign != 0 || h->tocOffset > size ||
+		(size - h->tocOffset) / sizeof(AssetPackEntry) < h->entryCount ||
+		h->namesOffset > size || h->namesBytes > size - h->namesOffset ||
+		(h->namesBytes > 0 && base[h->namesOffset + h->namesBytes - 1] != 0))
+		return Fail(pack, error, path, "bad table of contents");
+
+	const AssetPackEntry* entries = (const AssetPackEntry*)(base + h->tocOffset);
+	const char* names = (const char*)(base + h->namesOffset);
+	for (uint32_t i = 0; i < h->entryCount; ++i)
+	{
+		const AssetPackEntry& e = entries[i];
+		const bool nameOk = (uint64_t)e.nameOffset + e.nameBytes < h->namesBytes && names[e.nameOffset + e.nameBytes] == 0;
+		const bool dataOk = e.offset % kAssetPackAlign == 0 && e.offset >= h->dataOffset && e.offset <= size &&
+			e.storedBytes <= size - e.offset;
+		// LZ4 no expande mas de ~255x: un tamanio mayor es un TOC roto, no un asset.
+		const bool codecOk = (e.compression == (uint32_t)AssetCompression::Lz4 && e.bytes / 256 <= e.storedBytes) ||
+			(e.compression == (uint32_t)AssetCompression::None && e.storedBytes == e.bytes);
+		const bool sorted = i == 0 || entries[i - 1].nameHash <= e.nameHash;
+		if (!nameOk || !dataOk || !codecOk || !sorted)
+			return Fail(pack, error, path, "bad table of contents");
+	}
+
+	pack->header = h;
+	pack->entries = entries;
+	pack->names = names;
+	pack->count = (int)h->entryCount;
+	return true;
+}
+
+void AssetPackClose(AssetPack* pack)
+{
+	PlatformUnmapFile(&pack->mapping);
+	*pack = AssetPack();
+}
+
+int AssetPackFind(const AssetPack& pack, const char* name)
+{
+	const size_t bytes = strlen(name);
+	const uint64_t hash = AssetPackHashName(name, bytes);
+	const AssetPackEntry* end = pack.entries + pack.count;
+	const AssetPackEntry* e = std::lower_bound(pack.entries, end, hash,
+		[](const AssetPackEntry& entry, uint64_t h) { return entry.nameHash < h; });
+	for (; e != end && e->nameHash == hash; ++e)
+	{
+		if (e->nameBytes == bytes && memcmp(pack.names + e->nameOffset, name, bytes) == 0)
+			return (int)(e - pack.entries);
+	}
+	return -1;
+}
+
+const char* AssetPackName(const AssetPack& pack, int index)
+{
+	return pack.names + pack.entries[index].nameOffset;
+}
+
+const uint8_t* AssetPackData(const AssetPack& pack, int index, std::vector<uint8_t>* storage)
+{
+	const AssetPackEntry& e = pack.entries[index];
+	const uint8_t* stored = pack.mapping.data + e.offset;
+	if (e.compression == (uint32_t)AssetCompression::None || e.bytes == 0) return stored;
+
+	storage->resize((size_t)e.bytes);
+	if (!Lz4Decompress(stored, (size_t)e.storedBytes, storage->data(), storage->size())) return nullptr;
+	return storage->data();
+}
+
+bool AssetPackVerify(const AssetPack& pack, int index, std::vector<uint8_t>* storage)
+{
+	const uint8_t* data = AssetPackData(pack, index, storage);
+	return data && AssetPackChecksum(data, (size_t)pack.entries[index].bytes) == pack.entries[index].checksum;
+}
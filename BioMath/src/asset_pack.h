@@ -0,0 +1,129 @@
+#pragma once
+
+#include "platform.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// ---------------------------
+// Paquete de assets
+// ---------------------------
+
+// Un solo archivo con muchos assets (shaders, tablas horneadas, muestras), pensado para mapearse
+// entero (PlatformMapFile: mmap / MapViewOfFile) en vez de abrir y leer archivo por archivo:
+//
+//   header (64 bytes) | TOC (una entrada de 64 bytes por asset) | nombres | datos
+//
+// Todo empieza alineado a kAssetPackAlign (64) dentro del archivo, y el mapping esta alineado a
+// pagina, asi que los datos de cada entrada quedan alineados en memoria: un asset sin comprimir
+// se pasa tal cual a GL (glTexImage3D, glBufferData) o a quien lo use, sin copia. Abrir el paquete
+// toca solo el header y la TOC; las paginas de datos las trae el sistema cuando se leen y, como
+// son del archivo y limpias, no cuentan como memoria privada del proceso y se pueden descartar.
+//
+// Cada entrada puede ir comprimida con LZ4 (formato de bloque, lz4_block.h). El empaquetador
+// (BioMathPack) comprime solo si gana lo suficiente: texto y tablas suaves si, datos tipo ruido
+// no, y esos quedan para uso directo. Las entradas comprimidas se descomprimen en un buffer del
+// que las pide.
+//
+// La TOC esta ordenada por hash del nombre (FNV-1a de 64 bits): buscar es una busqueda binaria.
+// Cada entrada guarda tambien un checksum de los datos sin comprimir, que AssetPackVerify compara
+// (leer todo; no se hace al abrir, para no traer todas las paginas).
+
+static const int kAssetPackAlign = 64;
+static const uint32_t kAssetPackVersion = 1;
+
+enum class AssetCompression : uint32_t
+{
+	None = 0,
+	Lz4 = 1,
+};
+
+struct AssetPackHeader
+{
+	char magic[4];            // "BMPK"
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t alignment;
+	uint64_t tocOffset;
+	uint64_t namesOffset;
+	uint64_t namesBytes;
+	uint64_t dataOffset;
+	uint64_t fileBytes;       // tamanio total, para detectar un archivo truncado
+	uint64_t reserved;
+};
+
+struct AssetPackEntry
+{
+	uint64_t nameHash;
+	uint32_t nameOffset;      // en la tabla de nombres (terminados en 0)
+	uint32_t nameBytes;       // sin el 0
+	uint64_t offset;          // desde el principio del archivo, multiplo de alignment
+	uint64_t storedBytes;     // en el archivo
+	uint64_t bytes;           // sin comprimir
+	uint32_t compression;     // AssetCompression
+	uint32_t reserved;
+	uint64_t checksum;        // AssetPackChecksum de los bytes sin comprimir
+	uint64_t reserved2;
+};
+
+static_assert(sizeof(AssetPackHeader) == 64 && sizeof(AssetPackEntry) == 64, "the file layout is fixed");
+
+uint64_t AssetPackHashName(const char* name, size_t bytes);
+uint64_t AssetPackChecksum(const uint8_t* data, size_t bytes);
+
+// ---- Escritura (empaquetador offline, benchmarks) ----
+
+struct AssetPackSource
+{
+	std::string name;         // "shaders/fullscreen.glsl"
+	std::vector<uint8_t> data;
+	bool allowCompression = true;
+};
+
+struct AssetPackWriteOptions
+{
+	bool lz4 = false;
+	double minSavings = 0.125;   // se guarda comprimida solo si ahorra al menos esta fraccion
+};
+
+struct AssetPackWriteStats
+{
+	int entries = 0;
+	int compressed = 0;
+	uint64_t rawBytes = 0;       // suma de los assets sin comprimir
+	uint64_t fileBytes = 0;
+};
+
+// Escribe el paquete (a 'path'.tmp y despues renombra). Los nombres tienen que ser unicos. La
+// compresion de las entradas va en paralelo (ParallelFor).
+bool AssetPackWrite(const char* path, const std::vector<AssetPackSource>& sources, const AssetPackWriteOptions& options,
+	AssetPackWriteStats* stats, std::string* error);
+
+// ---- Lectura ----
+
+struct AssetPack
+{
+	PlatformFileMapping mapping;
+	const AssetPackHeader* header = nullptr;
+	const AssetPackEntry* entries = nullptr;
+	const char* names = nullptr;
+	int count = 0;
+};
+
+// Mapea y valida el header y la TOC (tamanios, offsets y alineacion dentro del archivo, nombres
+// terminados en 0). No lee los datos.
+bool AssetPackOpen(const char* path, AssetPack* pack, std::string* error);
+void AssetPackClose(AssetPack* pack);
+
+// Indice de la entrada 'name', o -1.
+int AssetPackFind(const AssetPack& pack, const char* name);
+const char* AssetPackName(const AssetPack& pack, int index);
+
+// Los bytes de la entrada: sin comprimir, un puntero al mapping (vale hasta AssetPackClose);
+// comprimida, se descomprime en 'storage' y apunta ahi. nullptr si el bloque LZ4 es invalido.
+const uint8_t* AssetPackData(const AssetPack& pack, int index, std::vector<uint8_t>* storage);
+
+// Lee la entrada y compara su checksum. Toca todas sus paginas.
+bool AssetPackVerify(const AssetPack& pack, int index, std::vector<uint8_t>* storage);
@@ -0,0 +1,112 @@
+#include "assets.h"
+#include "asset_pack.h"
+#include "platform.h"
+#include "profiler.h"
+
+#include <atomic>
+#include <string.h>
+#include <string>
+
+struct MountedAssets
+{
+	AssetPack pack;
+	const char* path = nullptr;
+	bool mounted = false;
+	double mountMs = 0.0;
+
+	// Reporte (AssetsLoad corre en los threads del arranque)
+	std::atomic<int> lookups{ 0 };
+	std::atomic<int> hits{ 0 };
+	std::atomic<uint64_t> mappedBytes{ 0 };         // entregados desde el mapping, sin copia
+	std::atomic<uint64_t> decompressedBytes{ 0 };
+	std::atomic<uint64_t> decompressUs{ 0 };
+};
+
+static MountedAssets g_assets;
+
+static double MsSince(uint64_t startTicks)
+{
+	return (double)(PlatformTicks() - startTicks) * 1000.0 / (double)PlatformTickFrequency();
+}
+
+void ParseAssetOptions(int argc, char** argv, AssetOptions* opts)
+{
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--assets") == 0) opts->path = argv[++i];
+	}
+}
+
+bool AssetsMount(const AssetOptions& opts)
+{
+	if (!opts.path) return true;
+	PROFILE_ZONE("AssetsMount");
+
+	const uint64_t start = PlatformTicks();
+	std::string error;
+	if (!AssetPackOpen(opts.path, &g_assets.pack, &error))
+	{
+		PlatformAttachConsole();
+		fprintf(stderr, "--assets %s\n", error.c_str());
+		return false;
+	}
+	g_assets.mountMs = MsSince(start);
+	g_assets.path = opts.path;
+	g_assets.mounted = true;
+	return true;
+}
+
+bool AssetsMounted()
+{
+	return g_assets.mounted;
+}
+
+const char* AssetsPackPath()
+{
+	return g_assets.path ? g_assets.path : "";
+}
+
+bool AssetsLoad(const char* name, const uint8_t** data, size_t* size, std::vector<uint8_t>* storage)
+{
+	if (!g_assets.mounted) return false;
+	g_assets.lookups.fetch_add(1, std::memory_order_relaxed);
+
+	const int index = AssetPackFind(g_assets.pack, name);
+	if (index < 0) return false;
+
+	const AssetPackEntry& e = g_assets.pack.entries[index];
+	const uint64_t start = PlatformTicks();
+	const uint8_t* bytes = AssetPackData(g_assets.pack, index, storage);
+	if (!bytes)
+	{
+		fprintf(stderr, "assets: '%s' in %s is corrupt\n", name, g_assets.path);
+		return false;
+	}
+	if (e.compression == (uint32_t)AssetCompression::None)
+	{
+		g_assets.mappedBytes.fetch_add(e.bytes, std::memory_order_relaxed);
+	}
+	else
+	{
+		g_assets.decompressedBytes.fetch_add(e.bytes, std::memory_order_relaxed);
+		g_assets.decompressUs.fetch_add((uint64_t)(MsSince(start) * 1000.0), std::memory_order_relaxed);
+	}
+	g_assets.hits.fetch_add(1, std::memory_order_relaxed);
+	*data = bytes;
+	*size = (size_t)e.bytes;
+	return true;
+}
+
+void WriteAssetsJson(FILE* f)
+{
+	if (!g_assets.mounted)
+	{
+		fprintf(f, "\"assets\": { \"mounted\": false }");
+		return;
+	}
+	fprintf(f, "\"assets\": { \"mounted\": true, \"entries\": %d, \"file_bytes\": %llu, \"mount_ms\": %.3f",
+		g_assets.pack.count, (unsigned long long)g_assets.pack.mapping.size, g_assets.mountMs);
+	fprintf(f, ", \"lookups\": %d, \"hits\": %d, \"mapped_bytes\": %llu, \"decompressed_bytes\": %llu, \"decompress_ms\": %.3f }",
+		g_assets.lookups.load(), g_assets.hits.load(), (unsigned long long)g_assets.mappedBytes.load(),
+		(unsigned long long)g_assets.decompressedBytes.load(), g_assets.decompressUs.load() / 1000.0);
+}
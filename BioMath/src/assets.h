@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// ---------------------------
+// Paquete de assets montado
+// ---------------------------
+
+// Con --assets <archivo.bmpak> el proceso monta un paquete (asset_pack.h, lo arma BioMathPack) y
+// los que cargan assets lo consultan antes que el disco:
+//   - ShaderFileLoad busca "shaders/<nombre>" (salvo --shader-dir explicito). Un shader del
+//     paquete no tiene hot reload.
+//   - El ruido horneado (--noise baked) busca NoiseBakeAssetName: sin comprimir, se verifica una
+//     muestra de filas y se sube a GL directo desde el mapping, sin copia ni cache aparte.
+// Lo que no esta en el paquete se carga como siempre.
+//
+// Montar solo mapea el archivo y valida la TOC; el paquete queda montado hasta que termina el
+// proceso (las entradas sin comprimir se usan desde el mapping). El reporte va en el JSON como
+// "assets".
+
+struct AssetOptions
+{
+	const char* path = nullptr;   // nullptr = sin paquete
+};
+
+// --assets <archivo>
+void ParseAssetOptions(int argc, char** argv, AssetOptions* opts);
+
+// Monta el paquete. false (con el motivo en stderr) si se pidio uno y no se pudo abrir.
+bool AssetsMount(const AssetOptions& opts);
+bool AssetsMounted();
+const char* AssetsPackPath();
+
+// Busca 'name' en el paquete montado. 'data' apunta al mapping (entrada sin comprimir) o a
+// 'storage' (descomprimida ahi). Desde cualquier thread. false si no hay paquete, no esta o el
+// bloque comprimido es invalido.
+bool AssetsLoad(const char* name, const uint8_t** data, size_t* size, std::vector<uint8_t>* storage);
+
+// "assets": { ... } para los reportes JSON.
+void WriteAssetsJson(FILE* f);
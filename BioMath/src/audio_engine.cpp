@@ -0,0 +1,218 @@
+#include "audio_engine.h"
+#include "platform.h"
+#include "profiler.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+struct AudioEngine
+{
+	AudioOptions options;
+	PlatformAudioDevice* device = nullptr;  // nullptr = backend "null" (reloj)
+	std::thread thread;
+	std::atomic<bool> running{ false };
+	std::atomic<bool> deviceActive{ false }; // para el reporte: el device lo cierra el thread si falla
+
+	// Lo toca solo el thread de audio (despues de arrancar)
+	Synth synth;
+	alignas(16) float left[kSynthMaxBlock];
+	alignas(16) float right[kSynthMaxBlock];
+
+	SpscRing<SynthCommand, kAudioCommandQueue> commands;
+
+	// Estadisticas: las escribe el thread de audio (relaxed), las lee el loop principal.
+	std::atomic<uint64_t> blocks{ 0 };
+	std::atomic<uint64_t> underruns{ 0 };
+	std::atomic<uint64_t> commandsApplied{ 0 };
+	std::atomic<uint64_t> renderTicksTotal{ 0 };
+	std::atomic<uint64_t> renderTicksMax{ 0 };
+	std::atomic<int> activeVoices{ 0 };
+	std::atomic<uint64_t> voicesStolen{ 0 };
+	std::atomic<uint64_t> notesDropped{ 0 };
+	uint64_t commandsDropped = 0; // productor
+};
+
+static AudioEngine g_audio;
+
+void ParseAudioOptions(int argc, char** argv, AudioOptions* opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--audio") == 0)
+			opts->enabled = true;
+		else if (strcmp(argv[i], "--no-audio") == 0)
+			opts->enabled = false;
+		else if (strcmp(argv[i], "--audio-rate") == 0 && i + 1 < argc)
+			opts->sampleRate = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--audio-block") == 0 && i + 1 < argc)
+			opts->blockFrames = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--audio-buffers") == 0 && i + 1 < argc)
+			opts->bufferBlocks = atoi(argv[++i]);
+	}
+
+	if (opts->sampleRate < 8000) opts->sampleRate = 8000;
+	if (opts->sampleRate > 192000) opts->sampleRate = 192000;
+	if (opts->blockFrames < 64) opts->blockFrames = 64;
+	if (opts->blockFrames > kSynthMaxBlock) opts->blockFrames = kSynthMaxBlock;
+	opts->blockFrames &= ~3;
+	if (opts->bufferBlocks < 2) opts->bufferBlocks = 2;
+	if (opts->bufferBlocks > 8) opts->bufferBlocks = 8;
+}
+
+static void AudioMain()
+{
+	ProfilerSetThreadName("Audio");
+	PlatformSetAudioThreadPriority();
+	SynthEnableFlushToZero();
+
+	const int frames = g_audio.options.blockFrames;
+	const uint64_t blockTicks = (uint64_t)frames * PlatformTickFrequency() / (uint64_t)g_audio.options.sampleRate;
+	uint64_t deadline = PlatformTicks();
+
+	while (g_audio.running.load(std::memory_order_acquire))
+	{
+		SynthCommand cmd;
+		uint64_t applied = 0;
+		while (g_audio.commands.TryPop(&cmd))
+		{
+			SynthApply(&g_audio.synth, cmd);
+			++applied;
+		}
+
+		const uint64_t start = PlatformTicks();
+		SynthRender(&g_audio.synth, g_audio.left, g_audio.right, frames);
+		const uint64_t renderTicks = PlatformTicks() - start;
+
+		g_audio.commandsApplied.fetch_add(applied, std::memory_order_relaxed);
+		g_audio.renderTicksTotal.fetch_add(renderTicks, std::memory_order_relaxed);
+		if (renderTicks > g_audio.renderTicksMax.load(std::memory_order_relaxed))
+			g_audio.renderTicksMax.store(renderTicks, std::memory_order_relaxed);
+		g_audio.activeVoices.store(g_audio.synth.stats.activeVoices, std::memory_order_relaxed);
+		g_audio.voicesStolen.store(g_audio.synth.stats.voicesStolen, std::memory_order_relaxed);
+		g_audio.notesDropped.store(g_audio.synth.stats.notesDropped, std::memory_order_relaxed);
+		g_audio.blocks.fetch_add(1, std::memory_order_relaxed);
+
+		if (g_audio.device)
+		{
+			const PlatformAudioResult result = PlatformAudioWrite(g_audio.device, g_audio.left, g_audio.right, frames);
+			if (result == PlatformAudioResult::Underrun)
+				g_audio.underruns.fetch_add(1, std::memory_order_relaxed);
+			else if (result == PlatformAudioResult::Error)
+			{
+				// El dispositivo se fue (se desenchufo, lo tomo otro proceso): sigue con el reloj.
+				PlatformAudioClose(g_audio.device);
+				g_audio.device = nullptr;
+				g_audio.deviceActive.store(false, std::memory_order_relaxed);
+				deadline = PlatformTicks();
+			}
+		}
+		else
+		{
+			// Sin dispositivo: un bloque por periodo. Terminar el render despues del deadline es
+			// exactamente lo que en un dispositivo real seria un corte.
+			deadline += blockTicks;
+			const uint64_t now = PlatformTicks();
+			if (now > deadline)
+			{
+				g_audio.underruns.fetch_add(1, std::memory_order_relaxed);
+				deadline = now;
+			}
+			else
+			{
+				PlatformSleepUntil(deadline);
+			}
+		}
+	}
+}
+
+bool AudioEngineInit(const AudioOptions& opts)
+{
+	if (!opts.enabled || g_audio.running.load()) return false;
+
+	g_audio.options = opts;
+	SynthInit(&g_audio.synth, (float)opts.sampleRate);
+
+	PlatformAudioDesc desc;
+	desc.sampleRate = opts.sampleRate;
+	desc.blockFrames = opts.blockFrames;
+	desc.bufferBlocks = opts.bufferBlocks;
+	g_audio.device = PlatformAudioOpen(desc);
+	g_audio.deviceActive.store(g_audio.device != nullptr, std::memory_order_relaxed);
+	if (!g_audio.device)
+		fprintf(stderr, "audio: no %s output device, rendering against the clock\n", PlatformAudioBackendName());
+
+	g_audio.running.store(true, std::memory_order_release);
+	g_audio.thread = std::thread(AudioMain);
+	return true;
+}
+
+void AudioEngineShutdown()
+{
+	if (!g_audio.running.load()) return;
+
+	g_audio.running.store(false, std::memory_order_release);
+	if (g_audio.thread.joinable())
+		g_audio.thread.join();
+
+	if (g_audio.device)
+	{
+		PlatformAudioClose(g_audio.device);
+		g_audio.device = nullptr;
+	}
+}
+
+bool AudioEngineRunning()
+{
+	return g_audio.running.load(std::memory_order_relaxed);
+}
+
+bool AudioEnginePost(const SynthCommand& cmd)
+{
+	if (!g_audio.running.load(std::memory_order_relaxed)) return false;
+	if (g_audio.commands.TryPush(cmd)) return true;
+	++g_audio.commandsDropped;
+	return false;
+}
+
+AudioEngineStats AudioEngineGetStats()
+{
+	AudioEngineStats stats;
+	const double tickMs = 1000.0 / (double)PlatformTickFrequency();
+	stats.blocks = g_audio.blocks.load(std::memory_order_relaxed);
+	stats.underruns = g_audio.underruns.load(std::memory_order_relaxed);
+	stats.commandsApplied = g_audio.commandsApplied.load(std::memory_order_relaxed);
+	stats.commandsDropped = g_audio.commandsDropped;
+	stats.activeVoices = g_audio.activeVoices.load(std::memory_order_relaxed);
+	stats.voicesStolen = g_audio.voicesStolen.load(std::memory_order_relaxed);
+	stats.notesDropped = g_audio.notesDropped.load(std::memory_order_relaxed);
+	stats.renderMsMax = (double)g_audio.renderTicksMax.load(std::memory_order_relaxed) * tickMs;
+	if (stats.blocks)
+		stats.renderMsMean = (double)g_audio.renderTicksTotal.load(std::memory_order_relaxed) * tickMs / (double)stats.blocks;
+	if (g_audio.options.sampleRate > 0)
+		stats.blockMs = 1000.0 * g_audio.options.blockFrames / g_audio.options.sampleRate;
+	return stats;
+}
+
+void WriteAudioJson(FILE* f)
+{
+	if (!g_audio.running.load())
+	{
+		fprintf(f, "\"audio\": { \"enabled\": false }");
+		return;
+	}
+
+	const AudioEngineStats stats = AudioEngineGetStats();
+	fprintf(f, "\"audio\": { \"enabled\": true, \"backend\": \"%s\", \"sample_rate\": %d, \"block_frames\": %d, \"buffer_blocks\": %d",
+		g_audio.deviceActive.load(std::memory_order_relaxed) ? PlatformAudioBackendName() : "null", g_audio.options.sampleRate,
+		g_audio.options.blockFrames, g_audio.options.bufferBlocks);
+	fprintf(f, ", \"blocks\": %llu, \"underruns\": %llu, \"commands_applied\": %llu, \"commands_dropped\": %llu",
+		(unsigned long long)stats.blocks, (unsigned long long)stats.underruns,
+		(unsigned long long)stats.commandsApplied, (unsigned long long)stats.commandsDropped);
+	fprintf(f, ", \"active_voices\": %d, \"voices_stolen\": %llu, \"notes_dropped\": %llu",
+		stats.activeVoices, (unsigned long long)stats.voicesStolen, (unsigned long long)stats.notesDropped);
+	fprintf(f, ", \"block_ms\": %.3f, \"render_ms_mean\": %.4f, \"render_ms_max\": %.4f }",
+		stats.blockMs, stats.renderMsMean, stats.renderMsMax);
+}
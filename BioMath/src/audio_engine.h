@@ -0,0 +1,61 @@
+#pragma once
+
+#include "synth.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+// ---------------------------
+// Motor de audio (thread dedicado)
+// ---------------------------
+
+// Dueno del Synth y de un thread de audio propio. El loop principal (WinMain / main) no toca el
+// synth: le manda SynthCommand por una cola SPSC sin locks (spsc_ring.h) y el thread los aplica
+// al principio de cada bloque.
+//
+// Por bloque el thread hace: vaciar la cola -> SynthRender -> PlatformAudioWrite, que bloquea hasta
+// que el dispositivo tenga lugar y asi marca el ritmo. En ese camino no hay allocs, locks ni
+// syscalls aparte de la escritura al dispositivo. Si no hay dispositivo (CI, sin ALSA) el thread
+// sigue igual con el reloj ("null"): la musica corre y las estadisticas valen.
+
+struct AudioOptions
+{
+	bool enabled = true;
+	int sampleRate = 48000;
+	int blockFrames = 128;   // 64..kSynthMaxBlock, multiplo de 4
+	int bufferBlocks = 3;
+};
+
+static const int kAudioCommandQueue = 256;
+
+// --audio / --no-audio, --audio-rate hz, --audio-block frames, --audio-buffers n
+void ParseAudioOptions(int argc, char** argv, AudioOptions* opts);
+
+// Arranca el thread. false si esta deshabilitado.
+bool AudioEngineInit(const AudioOptions& opts);
+void AudioEngineShutdown();
+bool AudioEngineRunning();
+
+// Desde un solo thread productor (el loop principal). false si la cola esta llena: el comando se
+// descarta y se cuenta en commandsDropped.
+bool AudioEnginePost(const SynthCommand& cmd);
+
+struct AudioEngineStats
+{
+	uint64_t blocks = 0;
+	uint64_t underruns = 0;
+	uint64_t commandsApplied = 0;
+	uint64_t commandsDropped = 0;
+	int activeVoices = 0;
+	uint64_t voicesStolen = 0;
+	uint64_t notesDropped = 0;   // el synth no encontro voz de prioridad <= a la de la nota
+	double renderMsMax = 0.0;   // peor SynthRender
+	double renderMsMean = 0.0;
+	double blockMs = 0.0;       // presupuesto: blockFrames / sampleRate
+};
+
+// Lectura aproximada (contadores atomicos del thread de audio), para reportes.
+AudioEngineStats AudioEngineGetStats();
+
+// "audio": { ... } para los reportes JSON.
+void WriteAudioJson(FILE* f);
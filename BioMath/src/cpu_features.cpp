@@ -0,0 +1,69 @@
+#include "cpu_features.h"
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#else
+	#include <cpuid.h>
+#endif
+
+static void CpuId(int leaf, int subleaf, unsigned regs[4])
+{
+#if defined(_MSC_VER)
+	int r[4];
+	__cpuidex(r, leaf, subleaf);
+	for (int i = 0; i < 4; ++i) regs[i] = (unsigned)r[i];
+#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// XCR0: que registros guarda/restaura el SO en un context switch (sin esto, AVX no es usable aunque la CPU lo tenga).
+static unsigned long long ReadXCR0()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned lo = 0, hi = 0;
+	__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+	return ((unsigned long long)hi << 32) | lo;
+#endif
+}
+
+static CpuFeatures DetectCpuFeatures()
+{
+	CpuFeatures f;
+
+	unsigned r[4] = {};
+	CpuId(0, 0, r);
+	const unsigned maxLeaf = r[0];
+	if (maxLeaf < 1) return f;
+
+	CpuId(1, 0, r);
+	f.sse2 = (r[3] & (1u << 26)) != 0;
+	f.sse41 = (r[2] & (1u << 19)) != 0;
+	const bool osxsave = (r[2] & (1u << 27)) != 0;
+	const bool cpuAvx = (r[2] & (1u << 28)) != 0;
+	const bool cpuFma = (r[2] & (1u << 12)) != 0;
+
+	const unsigned long long xcr0 = osxsave ? ReadXCR0() : 0;
+	const bool osYmm = (xcr0 & 0x6) == 0x6;    // XMM + YMM
+	const bool osZmm = (xcr0 & 0xE6) == 0xE6;  // XMM + YMM + opmask + ZMM
+
+	f.avx = cpuAvx && osYmm;
+	f.fma = cpuFma && osYmm;
+
+	if (maxLeaf >= 7)
+	{
+		CpuId(7, 0, r);
+		f.avx2 = f.avx && (r[1] & (1u << 5)) != 0;
+		f.avx512f = osZmm && (r[1] & (1u << 16)) != 0;
+	}
+
+	return f;
+}
+
+const CpuFeatures& GetCpuFeatures()
+{
+	static const CpuFeatures s_features = DetectCpuFeatures();
+	return s_features;
+}
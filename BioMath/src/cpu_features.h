@@ -0,0 +1,20 @@
+#pragma once
+
+// ---------------------------
+// Deteccion de features de CPU
+// ---------------------------
+
+// Los kernels SIMD se compilan siempre, pero solo se ejecutan si la CPU (y el SO) los soportan.
+// La deteccion se hace una sola vez con CPUID y se cachea.
+
+struct CpuFeatures
+{
+	bool sse2 = false;
+	bool sse41 = false;
+	bool avx = false;
+	bool avx2 = false;
+	bool fma = false;
+	bool avx512f = false;
+};
+
+const CpuFeatures& GetCpuFeatures();
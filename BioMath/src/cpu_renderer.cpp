@@ -0,0 +1,319 @@
+#include "cpu_renderer.h"
+#include "cpu_renderer_internal.h"
+#include "cpu_features.h"
+#include "noise_bake.h"
+#include "parallel.h"
+#include "simd_math.h"
+
+#include <math.h>
+#include <vector>
+
+static_assert(shade::kLatticePeriod == (float)kNoisePeriod, "the CPU lattice wrap must match the baked lattice");
+
+// ---------------------------
+// Kernel escalar (referencia)
+// ---------------------------
+
+// Traduccion literal del fragment shader. No usa las tablas del frame a proposito:
+// es el oraculo contra el que se validan los kernels SIMD. sin() es simd::Sin y no sinf(),
+// para que los tres caminos den exactamente los mismos bytes (ver simd_math.h).
+
+static inline float Fract(float x) { return x - floorf(x); }
+static inline float Clamp01(float x) { return x < 0.0f ? 0.0f : (x > 1.0f ? 1.0f : x); }
+
+static inline float Hash(float px, float py)
+{
+	return Fract(simd::Sin(px * shade::kHashX + py * shade::kHashY) * shade::kHashScale);
+}
+
+// mod(x, NOISE_PERIOD) del shader
+static inline float WrapLattice(float x)
+{
+	return x - floorf(x * shade::kInvLatticePeriod) * shade::kLatticePeriod;
+}
+
+static inline float Noise(float px, float py)
+{
+	const float ix = floorf(px), iy = floorf(py);
+	const float fx = Fract(px), fy = Fract(py);
+	const float ix0 = WrapLattice(ix), iy0 = WrapLattice(iy);
+	const float ix1 = WrapLattice(ix + 1.0f), iy1 = WrapLattice(iy + 1.0f);
+	const float a = Hash(ix0, iy0);
+	const float b = Hash(ix1, iy0);
+	const float c = Hash(ix0, iy1);
+	const float d = Hash(ix1, iy1);
+	const float ux = fx * fx * (3.0f - 2.0f * fx);
+	const float uy = fy * fy * (3.0f - 2.0f * fy);
+	const float ab = a * (1.0f - ux) + b * ux; // mix(a, b, u.x)
+	return ab + (c - a) * uy * (1.0f - ux) + (d - b) * ux * uy;
+}
+
+// Un pixel en un uint32 little-endian: con RGBA8, R queda en el byte bajo (GL_RGBA/GL_UNSIGNED_BYTE).
+static inline uint32_t PackUnorm8(const CpuShadeFrame& frame, float r, float g, float b)
+{
+	const uint32_t R = (uint32_t)(Clamp01(r) * 255.0f + 0.5f);
+	const uint32_t G = (uint32_t)(Clamp01(g) * 255.0f + 0.5f);
+	const uint32_t B = (uint32_t)(Clamp01(b) * 255.0f + 0.5f);
+	return (R << frame.redShift) | (G << 8) | (B << frame.blueShift) | 0xFF000000u;
+}
+
+void CpuShadeSpanScalar(const CpuShadeFrame& frame, int y, int x0, int x1, uint32_t* dst)
+{
+	const float t = frame.time;
+	const float uvy = ((float)y + 0.5f) / (float)frame.height;
+
+	for (int x = x0; x < x1; ++x)
+	{
+		const float uvx = ((float)x + 0.5f) / (float)frame.width;
+
+		const float n = Noise(uvx * shade::kNoiseScale + frame.noiseOffX, uvy * shade::kNoiseScale + frame.noiseOffY);
+
+		const float dx = uvx - 0.5f, dy = uvy - 0.5f;
+		const float v = Clamp01((sqrtf(dx * dx + dy * dy) - shade::kVignetteEdge0) * shade::kVignetteInvRange);
+		const float vign = v * v * (3.0f - 2.0f * v);
+
+		float r = shade::kBaseR + shade::kNoiseR * n + shade::kWave * simd::Sin(t + uvx * 6.0f);
+		float g = shade::kBaseG + shade::kNoiseG * n + shade::kWave * simd::Sin(t * 0.7f + uvy * 5.0f);
+		float b = shade::kBaseB + shade::kNoiseB * n + shade::kWave * simd::Sin(t * 1.3f);
+
+		*dst++ = PackUnorm8(frame, r * vign, g * vign, b * vign);
+	}
+}
+
+// ---------------------------
+// Kernel SSE2
+// ---------------------------
+
+// 8 pixels por iteracion como dos grupos de 4 lanes. Los senos que solo dependen de la columna
+// o de la fila salen de las tablas del frame; los 4 hashes por pixel se evaluan completos.
+
+static inline __m128 HashSSE(__m128 px, __m128 py)
+{
+	const __m128 d = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(shade::kHashX)), _mm_mul_ps(py, _mm_set1_ps(shade::kHashY)));
+	return simd::Fract(_mm_mul_ps(simd::Sin(d), _mm_set1_ps(shade::kHashScale)));
+}
+
+static inline __m128 WrapLatticeSSE(__m128 x)
+{
+	const __m128 cells = simd::Floor(_mm_mul_ps(x, _mm_set1_ps(shade::kInvLatticePeriod)));
+	return _mm_sub_ps(x, _mm_mul_ps(cells, _mm_set1_ps(shade::kLatticePeriod)));
+}
+
+static inline __m128i ShadeGroupSSE(const CpuShadeFrame& frame, int x, float greenWave, __m128 vy, __m128 py)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 three = _mm_set1_ps(3.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+
+	const __m128 uvx = _mm_loadu_ps(frame.uvX + x);
+
+	// noise(uv*6 + off)
+	const __m128 px = _mm_add_ps(_mm_mul_ps(uvx, _mm_set1_ps(shade::kNoiseScale)), _mm_set1_ps(frame.noiseOffX));
+	const __m128 ifx = simd::Floor(px);
+	const __m128 ify = simd::Floor(py);
+	const __m128 fx = _mm_sub_ps(px, ifx);
+	const __m128 fy = _mm_sub_ps(py, ify);
+	const __m128 ix = WrapLatticeSSE(ifx);
+	const __m128 iy = WrapLatticeSSE(ify);
+	const __m128 ix1 = WrapLatticeSSE(_mm_add_ps(ifx, one));
+	const __m128 iy1 = WrapLatticeSSE(_mm_add_ps(ify, one));
+
+	const __m128 a = HashSSE(ix, iy);
+	const __m128 b = HashSSE(ix1, iy);
+	const __m128 c = HashSSE(ix, iy1);
+	const __m128 d = HashSSE(ix1, iy1);
+
+	const __m128 ux = _mm_mul_ps(_mm_mul_ps(fx, fx), _mm_sub_ps(three, _mm_mul_ps(two, fx)));
+	const __m128 uy = _mm_mul_ps(_mm_mul_ps(fy, fy), _mm_sub_ps(three, _mm_mul_ps(two, fy)));
+	const __m128 omux = _mm_sub_ps(one, ux);
+
+	__m128 n = _mm_add_ps(_mm_mul_ps(a, omux), _mm_mul_ps(b, ux));
+	n = _mm_add_ps(n, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(c, a), uy), omux));
+	n = _mm_add_ps(n, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(d, b), ux), uy));
+
+	// vignette
+	const __m128 dx = _mm_sub_ps(uvx, _mm_set1_ps(0.5f));
+	const __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), vy));
+	const __m128 v = simd::Clamp01(_mm_mul_ps(_mm_sub_ps(len, _mm_set1_ps(shade::kVignetteEdge0)), _mm_set1_ps(shade::kVignetteInvRange)));
+	const __m128 vign = _mm_mul_ps(_mm_mul_ps(v, v), _mm_sub_ps(three, _mm_mul_ps(two, v)));
+
+	__m128 r = _mm_add_ps(_mm_set1_ps(shade::kBaseR), _mm_mul_ps(_mm_set1_ps(shade::kNoiseR), n));
+	__m128 g = _mm_add_ps(_mm_set1_ps(shade::kBaseG), _mm_mul_ps(_mm_set1_ps(shade::kNoiseG), n));
+	__m128 bl = _mm_add_ps(_mm_set1_ps(shade::kBaseB), _mm_mul_ps(_mm_set1_ps(shade::kNoiseB), n));
+	r = _mm_add_ps(r, _mm_loadu_ps(frame.redWave + x));
+	g = _mm_add_ps(g, _mm_set1_ps(greenWave));
+	bl = _mm_add_ps(bl, _mm_set1_ps(frame.blueWave));
+
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128i R = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(simd::Clamp01(_mm_mul_ps(r, vign)), _mm_set1_ps(255.0f)), half));
+	const __m128i G = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(simd::Clamp01(_mm_mul_ps(g, vign)), _mm_set1_ps(255.0f)), half));
+	const __m128i B = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(simd::Clamp01(_mm_mul_ps(bl, vign)), _mm_set1_ps(255.0f)), half));
+
+	const __m128i rShift = _mm_cvtsi32_si128(frame.redShift);
+	const __m128i bShift = _mm_cvtsi32_si128(frame.blueShift);
+	__m128i px32 = _mm_or_si128(_mm_sll_epi32(R, rShift), _mm_slli_epi32(G, 8));
+	px32 = _mm_or_si128(px32, _mm_sll_epi32(B, bShift));
+	return _mm_or_si128(px32, _mm_set1_epi32((int)0xFF000000));
+}
+
+void CpuShadeSpanSSE2(const CpuShadeFrame& frame, int y, int x0, int x1, uint32_t* dst)
+{
+	const float uvy = ((float)y + 0.5f) / (float)frame.height;
+	const float greenWave = shade::kWave * simd::Sin(frame.time * 0.7f + uvy * 5.0f);
+	const float dyv = uvy - 0.5f;
+	const __m128 vy = _mm_set1_ps(dyv * dyv);
+	const __m128 py = _mm_set1_ps(uvy * shade::kNoiseScale + frame.noiseOffY);
+
+	int x = x0;
+	for (; x + 8 <= x1; x += 8)
+	{
+		_mm_storeu_si128((__m128i*)(dst + (x - x0)), ShadeGroupSSE(frame, x, greenWave, vy, py));
+		_mm_storeu_si128((__m128i*)(dst + (x - x0) + 4), ShadeGroupSSE(frame, x + 4, greenWave, vy, py));
+	}
+	for (; x < x1; x += 4)
+	{
+		// Cola: las tablas estan paddeadas, asi que sombreamos 4 y copiamos los que entran.
+		alignas(16) uint32_t tmp[4];
+		_mm_store_si128((__m128i*)tmp, ShadeGroupSSE(frame, x, greenWave, vy, py));
+		for (int i = 0; i < 4 && x + i < x1; ++i)
+			dst[x - x0 + i] = tmp[i];
+	}
+}
+
+// ---------------------------
+// Dispatch
+// ---------------------------
+
+static const int kTileWidth = 256;
+static const int kTileHeight = 32;
+
+const char* CpuShadePathName(CpuShadePath path)
+{
+	switch (path)
+	{
+	case CpuShadePath::Auto:   return "auto";
+	case CpuShadePath::Scalar: return "scalar";
+	case CpuShadePath::SSE2:   return "sse2";
+	case CpuShadePath::AVX2:   return "avx2";
+	}
+	return "?";
+}
+
+bool CpuShadePathAvailable(CpuShadePath path)
+{
+	switch (path)
+	{
+	case CpuShadePath::Auto:
+	case CpuShadePath::Scalar: return true;
+	case CpuShadePath::SSE2:   return GetCpuFeatures().sse2;
+	case CpuShadePath::AVX2:   return GetCpuFeatures().avx2;
+	}
+	return false;
+}
+
+CpuShadePath CpuResolveShadePath(CpuShadePath path)
+{
+	if (path == CpuShadePath::Auto)
+	{
+		if (CpuShadePathAvailable(CpuShadePath::AVX2)) return CpuShadePath::AVX2;
+		if (CpuShadePathAvailable(CpuShadePath::SSE2)) return CpuShadePath::SSE2;
+		return CpuShadePath::Scalar;
+	}
+	return CpuShadePathAvailable(path) ? path : CpuShadePath::Scalar;
+}
+
+// 20*pi es el periodo comun de sin(t), sin(0.7 t) y sin(1.3 t); 64 periodos ~= 4021 s.
+static const double kShaderTimeWrap = 20.0 * 3.14159265358979323846 * 64.0;
+
+BackgroundTime BackgroundTimeAt(double seconds)
+{
+	BackgroundTime bt;
+	bt.time = (float)fmod(seconds, kShaderTimeWrap);
+	double scale = 1.0;
+	for (int o = 0; o < kBackgroundMaxOctaves; ++o)
+	{
+		// fbm: la octava o muestrea p * 2.03^o (+ una constante), asi que el desplazamiento tambien
+		// se escala. Cada uno envuelve por su cuenta, en double.
+		bt.scrollX[o] = (float)fmod(seconds * 0.15 * scale, (double)kNoisePeriod);
+		bt.scrollY[o] = (float)fmod(seconds * 0.07 * scale, (double)kNoisePeriod);
+		scale *= 2.03;
+	}
+	bt.exprTime = (float)seconds;
+	return bt;
+}
+
+void CpuRenderBackground(uint8_t* pixels, int width, int height, double seconds, CpuShadePath path, CpuPixelFormat format)
+{
+	if (!pixels || width <= 0 || height <= 0) return;
+	const BackgroundTime bt = BackgroundTimeAt(seconds);
+	const float timeSeconds = bt.time;
+
+	path = CpuResolveShadePath(path);
+	CpuShadeSpanFn span = CpuShadeSpanScalar;
+	if (path == CpuShadePath::SSE2) span = CpuShadeSpanSSE2;
+	if (path == CpuShadePath::AVX2) span = CpuShadeSpanAVX2;
+
+	// Tablas por columna, paddeadas a multiplo de 8 para que los kernels no tengan que chequear bordes.
+	const int padded = (width + 7) & ~7;
+	std::vector<float> uvX((size_t)padded);
+	std::vector<float> redWave((size_t)padded);
+	for (int x = 0; x < padded; ++x)
+	{
+		uvX[(size_t)x] = ((float)x + 0.5f) / (float)width;
+		redWave[(size_t)x] = shade::kWave * simd::Sin(timeSeconds + uvX[(size_t)x] * 6.0f);
+	}
+
+	CpuShadeFrame frame;
+	frame.width = width;
+	frame.height = height;
+	frame.time = timeSeconds;
+	frame.noiseOffX = bt.scrollX[0];
+	frame.noiseOffY = bt.scrollY[0];
+	frame.blueWave = shade::kWave * simd::Sin(timeSeconds * 1.3f);
+	frame.redShift = format == CpuPixelFormat::BGRA8 ? 16 : 0;
+	frame.blueShift = format == CpuPixelFormat::BGRA8 ? 0 : 16;
+	frame.uvX = uvX.data();
+	frame.redWave = redWave.data();
+
+	const int tilesX = (width + kTileWidth - 1) / kTileWidth;
+	const int tilesY = (height + kTileHeight - 1) / kTileHeight;
+	uint32_t* dst = (uint32_t*)pixels;
+
+	ParallelFor(tilesX * tilesY, 1, [&](int begin, int end)
+	{
+		for (int tile = begin; tile < end; ++tile)
+		{
+			const int x0 = (tile % tilesX) * kTileWidth;
+			const int y0 = (tile / tilesX) * kTileHeight;
+			const int x1 = x0 + kTileWidth < width ? x0 + kTileWidth : width;
+			const int y1 = y0 + kTileHeight < height ? y0 + kTileHeight : height;
+			for (int y = y0; y < y1; ++y)
+				span(frame, y, x0, x1, dst + (size_t)y * (size_t)width + (size_t)x0);
+		}
+	});
+}
+
+CpuImageDiff CpuCompareImages(const uint8_t* a, const uint8_t* b, int width, int height, int tolerance)
+{
+	CpuImageDiff diff;
+	double sqSum = 0.0;
+	const size_t count = (size_t)width * (size_t)height;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		int worst = 0;
+		for (int ch = 0; ch < 3; ++ch)
+		{
+			const int d = (int)a[i * 4 + ch] - (int)b[i * 4 + ch];
+			const int ad = d < 0 ? -d : d;
+			if (ad > worst) worst = ad;
+			sqSum += (double)(d * d);
+		}
+		if (worst > diff.maxChannelDiff) diff.maxChannelDiff = worst;
+		if (worst > tolerance) ++diff.pixelsOverTolerance;
+	}
+
+	const double mse = count ? sqSum / (double)(count * 3) : 0.0;
+	diff.psnr = mse > 0.0 ? 10.0 * log10(255.0 * 255.0 / mse) : 99.0;
+	return diff;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+
+// ---------------------------
+// Renderer de referencia en CPU
+// ---------------------------
+
+// Implementacion en CPU del fragment shader de fondo (hash/noise/vignette) de CompileAndLinkProgram().
+// Sirve de fallback cuando no hay driver GL usable y de "golden image" para comparar contra la GPU
+// en maquinas sin GPU (CI).
+//
+// El buffer de salida es RGBA8 (o BGRA8), width*height*4 bytes, con las filas de abajo hacia arriba
+// (fila 0 = abajo), igual que lo devuelve glReadPixels, asi se compara byte a byte.
+
+enum class CpuShadePath
+{
+	Auto,    // el mejor disponible en esta CPU
+	Scalar,  // referencia: evalua el shader pixel por pixel, tal cual esta escrito
+	SSE2,    // 4 lanes, 8 pixels por iteracion
+	AVX2,    // 8 lanes, 8 pixels por iteracion
+};
+
+const char* CpuShadePathName(CpuShadePath path);
+bool CpuShadePathAvailable(CpuShadePath path);
+CpuShadePath CpuResolveShadePath(CpuShadePath path);
+
+// Orden de canales del buffer de salida. BGRA8 es lo que espera GDI (StretchDIBits) en el fallback.
+enum class CpuPixelFormat
+{
+	RGBA8,
+	BGRA8,
+};
+
+// Los uniforms de tiempo del shader de fondo, calculados en double a partir de los segundos desde
+// el arranque. Un float pierde resolucion con valores grandes (a las 4 h el paso minimo ya es
+// ~1 ms), asi que cada termino que depende del tiempo se envuelve con su propio periodo:
+//   time       uTime, para sin(t), sin(0.7 t) y sin(1.3 t): modulo 20*pi*64 (~4021 s), que es
+//              multiplo del periodo de los tres senos
+//   scroll     uNoiseScroll[o], el desplazamiento del ruido en la octava o (t*(0.15, 0.07) escalado
+//              por la lacunaridad, 2.03^o): modulo kNoisePeriod, el periodo con el que se repite el
+//              lattice (el hash analitico tambien envuelve las esquinas de las celdas)
+// Asi el fondo no salta nunca. Una formula de --expr es arbitraria y no tiene periodo: exprTime va
+// sin envolver y pierde resolucion de a poco (~8 ms al dia de uptime) en vez de saltar.
+static const int kBackgroundMaxOctaves = 8;
+
+struct BackgroundTime
+{
+	float time = 0.0f;
+	float scrollX[kBackgroundMaxOctaves] = {};
+	float scrollY[kBackgroundMaxOctaves] = {};
+	float exprTime = 0.0f;
+};
+
+BackgroundTime BackgroundTimeAt(double seconds);
+
+// Renderiza un frame completo en el instante 'seconds' (los uniforms salen de BackgroundTimeAt). El
+// trabajo se reparte en tiles entre todos los cores (ParallelFor).
+void CpuRenderBackground(uint8_t* pixels, int width, int height, double seconds,
+	CpuShadePath path = CpuShadePath::Auto, CpuPixelFormat format = CpuPixelFormat::RGBA8);
+
+// Comparacion de imagenes para tests "golden": diferencia maxima por canal, cantidad de pixels
+// con algun canal fuera de tolerancia, y PSNR (RGB) en dB.
+struct CpuImageDiff
+{
+	int maxChannelDiff = 0;
+	long long pixelsOverTolerance = 0;
+	double psnr = 0.0;
+};
+
+CpuImageDiff CpuCompareImages(const uint8_t* a, const uint8_t* b, int width, int height, int tolerance);
@@ -0,0 +1,97 @@
+// Kernel AVX2 del renderer de CPU. Vive en su propia unidad de compilacion porque con GCC/Clang
+// necesita -mavx2 (MSVC acepta los intrinsics sin flags). Solo se llama si GetCpuFeatures().avx2.
+
+#include "cpu_renderer_internal.h"
+#include "simd_math.h"
+
+static inline __m256 HashAVX2(__m256 px, __m256 py)
+{
+	const __m256 d = _mm256_add_ps(_mm256_mul_ps(px, _mm256_set1_ps(shade::kHashX)), _mm256_mul_ps(py, _mm256_set1_ps(shade::kHashY)));
+	return simd::Fract(_mm256_mul_ps(simd::Sin(d), _mm256_set1_ps(shade::kHashScale)));
+}
+
+static inline __m256 WrapLatticeAVX2(__m256 x)
+{
+	const __m256 cells = simd::Floor(_mm256_mul_ps(x, _mm256_set1_ps(shade::kInvLatticePeriod)));
+	return _mm256_sub_ps(x, _mm256_mul_ps(cells, _mm256_set1_ps(shade::kLatticePeriod)));
+}
+
+static inline __m256i ShadeGroupAVX2(const CpuShadeFrame& frame, int x, float greenWave, __m256 vy, __m256 py)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 three = _mm256_set1_ps(3.0f);
+	const __m256 two = _mm256_set1_ps(2.0f);
+
+	const __m256 uvx = _mm256_loadu_ps(frame.uvX + x);
+
+	// noise(uv*6 + off)
+	const __m256 px = _mm256_add_ps(_mm256_mul_ps(uvx, _mm256_set1_ps(shade::kNoiseScale)), _mm256_set1_ps(frame.noiseOffX));
+	const __m256 ifx = simd::Floor(px);
+	const __m256 ify = simd::Floor(py);
+	const __m256 fx = _mm256_sub_ps(px, ifx);
+	const __m256 fy = _mm256_sub_ps(py, ify);
+	const __m256 ix = WrapLatticeAVX2(ifx);
+	const __m256 iy = WrapLatticeAVX2(ify);
+	const __m256 ix1 = WrapLatticeAVX2(_mm256_add_ps(ifx, one));
+	const __m256 iy1 = WrapLatticeAVX2(_mm256_add_ps(ify, one));
+
+	const __m256 a = HashAVX2(ix, iy);
+	const __m256 b = HashAVX2(ix1, iy);
+	const __m256 c = HashAVX2(ix, iy1);
+	const __m256 d = HashAVX2(ix1, iy1);
+
+	const __m256 ux = _mm256_mul_ps(_mm256_mul_ps(fx, fx), _mm256_sub_ps(three, _mm256_mul_ps(two, fx)));
+	const __m256 uy = _mm256_mul_ps(_mm256_mul_ps(fy, fy), _mm256_sub_ps(three, _mm256_mul_ps(two, fy)));
+	const __m256 omux = _mm256_sub_ps(one, ux);
+
+	__m256 n = _mm256_add_ps(_mm256_mul_ps(a, omux), _mm256_mul_ps(b, ux));
+	n = _mm256_add_ps(n, _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(c, a), uy), omux));
+	n = _mm256_add_ps(n, _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(d, b), ux), uy));
+
+	// vignette
+	const __m256 dx = _mm256_sub_ps(uvx, _mm256_set1_ps(0.5f));
+	const __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), vy));
+	const __m256 v = simd::Clamp01(_mm256_mul_ps(_mm256_sub_ps(len, _mm256_set1_ps(shade::kVignetteEdge0)), _mm256_set1_ps(shade::kVignetteInvRange)));
+	const __m256 vign = _mm256_mul_ps(_mm256_mul_ps(v, v), _mm256_sub_ps(three, _mm256_mul_ps(two, v)));
+
+	__m256 r = _mm256_add_ps(_mm256_set1_ps(shade::kBaseR), _mm256_mul_ps(_mm256_set1_ps(shade::kNoiseR), n));
+	__m256 g = _mm256_add_ps(_mm256_set1_ps(shade::kBaseG), _mm256_mul_ps(_mm256_set1_ps(shade::kNoiseG), n));
+	__m256 bl = _mm256_add_ps(_mm256_set1_ps(shade::kBaseB), _mm256_mul_ps(_mm256_set1_ps(shade::kNoiseB), n));
+	r = _mm256_add_ps(r, _mm256_loadu_ps(frame.redWave + x));
+	g = _mm256_add_ps(g, _mm256_set1_ps(greenWave));
+	bl = _mm256_add_ps(bl, _mm256_set1_ps(frame.blueWave));
+
+	const __m256 k255 = _mm256_set1_ps(255.0f);
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256i R = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(simd::Clamp01(_mm256_mul_ps(r, vign)), k255), half));
+	const __m256i G = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(simd::Clamp01(_mm256_mul_ps(g, vign)), k255), half));
+	const __m256i B = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(simd::Clamp01(_mm256_mul_ps(bl, vign)), k255), half));
+
+	// Empaquetado por pixel con shifts (no cruza lanes de 128 bits, a diferencia de packus).
+	const __m128i rShift = _mm_cvtsi32_si128(frame.redShift);
+	const __m128i bShift = _mm_cvtsi32_si128(frame.blueShift);
+	__m256i px32 = _mm256_or_si256(_mm256_sll_epi32(R, rShift), _mm256_slli_epi32(G, 8));
+	px32 = _mm256_or_si256(px32, _mm256_sll_epi32(B, bShift));
+	return _mm256_or_si256(px32, _mm256_set1_epi32((int)0xFF000000));
+}
+
+void CpuShadeSpanAVX2(const CpuShadeFrame& frame, int y, int x0, int x1, uint32_t* dst)
+{
+	const float uvy = ((float)y + 0.5f) / (float)frame.height;
+	const float greenWave = shade::kWave * simd::Sin(frame.time * 0.7f + uvy * 5.0f);
+	const float dyv = uvy - 0.5f;
+	const __m256 vy = _mm256_set1_ps(dyv * dyv);
+	const __m256 py = _mm256_set1_ps(uvy * shade::kNoiseScale + frame.noiseOffY);
+
+	int x = x0;
+	for (; x + 8 <= x1; x += 8)
+		_mm256_storeu_si256((__m256i*)(dst + (x - x0)), ShadeGroupAVX2(frame, x, greenWave, vy, py));
+
+	if (x < x1)
+	{
+		alignas(32) uint32_t tmp[8];
+		_mm256_store_si256((__m256i*)tmp, ShadeGroupAVX2(frame, x, greenWave, vy, py));
+		for (int i = 0; x + i < x1; ++i)
+			dst[x - x0 + i] = tmp[i];
+	}
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Compartido entre cpu_renderer.cpp y los kernels que viven en su propia unidad de compilacion
+// (cada ISA se compila con sus propios flags).
+
+// Constantes del frame, calculadas una vez antes de repartir los tiles.
+struct CpuShadeFrame
+{
+	int width = 0;
+	int height = 0;
+	float time = 0.0f;
+	float noiseOffX = 0.0f;   // t*0.15, envuelto (BackgroundTimeAt)
+	float noiseOffY = 0.0f;   // t*0.07
+	float blueWave = 0.0f;    // 0.15*0.5*sin(t*1.3), constante en todo el frame
+	int redShift = 0;         // posicion de R y B dentro del uint32 (RGBA8: 0/16, BGRA8: 16/0)
+	int blueShift = 16;
+
+	// Tablas por columna (paddeadas a multiplo de 8):
+	const float* uvX = nullptr;       // (x + 0.5) / width
+	const float* redWave = nullptr;   // 0.15*0.5*sin(t + uv.x*6)
+};
+
+// Cada kernel sombrea los pixels [x0, x1) de la fila y. 'dst' apunta al pixel x0.
+typedef void (*CpuShadeSpanFn)(const CpuShadeFrame& frame, int y, int x0, int x1, uint32_t* dst);
+
+void CpuShadeSpanScalar(const CpuShadeFrame& frame, int y, int x0, int x1, uint32_t* dst);
+void CpuShadeSpanSSE2(const CpuShadeFrame& frame, int y, int x0, int x1, uint32_t* dst);
+void CpuShadeSpanAVX2(const CpuShadeFrame& frame, int y, int x0, int x1, uint32_t* dst);
+
+// Horneado del lattice de ruido (noise_bake.h): una fila de 'period' texels de cada capa.
+// 'period' es multiplo de 16.
+typedef void (*NoiseBakeRowFn)(int y, int period, uint16_t* sinRow, uint16_t* cheapRow);
+
+void NoiseBakeRowScalar(int y, int period, uint16_t* sinRow, uint16_t* cheapRow);
+void NoiseBakeRowSSE2(int y, int period, uint16_t* sinRow, uint16_t* cheapRow);
+void NoiseBakeRowAVX2(int y, int period, uint16_t* sinRow, uint16_t* cheapRow);
+
+// Paso de reaccion-difusion (reaction_diffusion.h): las celdas [x0, x1) de una fila, con
+// 1 <= x0 y x1 <= width - 1 (las columnas del borde, que envuelven, las hace el llamador).
+struct RdConstants
+{
+	float du, dv, feed, feedKill, dt;   // feedKill = F + k
+};
+
+struct RdRows
+{
+	const float* uUp;   // filas y - 1, y, y + 1 de cada campo (ya envueltas)
+	const float* uMid;
+	const float* uDown;
+	const float* vUp;
+	const float* vMid;
+	const float* vDown;
+	float* uOut;
+	float* vOut;
+};
+
+typedef void (*RdStepSpanFn)(const RdConstants& k, const RdRows& rows, int x0, int x1);
+
+void RdStepSpanScalar(const RdConstants& k, const RdRows& rows, int x0, int x1);
+void RdStepSpanSSE2(const RdConstants& k, const RdRows& rows, int x0, int x1);
+void RdStepSpanAVX2(const RdConstants& k, const RdRows& rows, int x0, int x1);
+
+// Ensamble de EDOs (ode_ensemble.h): avanza las lanes [lane0, lane1), multiplos de 8.
+struct OdeSpan
+{
+	int model;          // OdeModel
+	int method;         // OdeMethod
+	float duration;
+	int rk4Steps;       // RK4: pasos de rk4Step (calculados una vez para todos los caminos)
+	float rk4Step;
+	float minStep;      // RK45
+	float tolerance;
+	float* y;
+	const float* p;
+	float* h;
+	size_t stride;
+};
+
+struct OdeSpanStats
+{
+	uint64_t accepted;
+	uint64_t rejected;
+};
+
+typedef void (*OdeAdvanceSpanFn)(const OdeSpan& span, int lane0, int lane1, OdeSpanStats* stats);
+
+void OdeAdvanceSpanScalar(const OdeSpan& span, int lane0, int lane1, OdeSpanStats* stats);
+void OdeAdvanceSpanSSE2(const OdeSpan& span, int lane0, int lane1, OdeSpanStats* stats);
+void OdeAdvanceSpanAVX2(const OdeSpan& span, int lane0, int lane1, OdeSpanStats* stats);
+
+// Agentes (agents.h). Fuerzas: los agentes (ya ordenados por celda) de las celdas [cell0, cell1),
+// todas de la misma fila de la grilla. Integracion: los agentes [i0, i1).
+struct AgentForceArgs
+{
+	const float* x;
+	const float* y;
+	const float* vx;
+	const float* vy;
+	const uint32_t* cellStart;
+	float* ax;
+	float* ay;
+	int gridW, gridH;
+	float width, height;
+	float radius2;
+	float separation2;
+	float invSeparation2;
+	float separation, alignment, cohesion;   // pesos
+};
+
+struct AgentIntegrateArgs
+{
+	float* x;
+	float* y;
+	float* vx;
+	float* vy;
+	const float* ax;
+	const float* ay;
+	float* frameOut;          // null o 4 arrays de 'count'
+	size_t count;
+	float dt;
+	float width, height;
+	float minSpeed, maxSpeed;
+	float chemotaxis;         // 0 = sin quimiotaxis
+	float chemoInvTwoSigma2;
+	float chemoX[3];          // fuentes, ya movidas al tiempo del tick
+	float chemoY[3];
+};
+
+typedef uint64_t (*AgentForceSpanFn)(const AgentForceArgs& args, int row, int cell0, int cell1);   // devuelve vecinos contados
+typedef void (*AgentIntegrateSpanFn)(const AgentIntegrateArgs& args, int i0, int i1);
+
+uint64_t AgentForceSpanScalar(const AgentForceArgs& args, int row, int cell0, int cell1);
+uint64_t AgentForceSpanSSE2(const AgentForceArgs& args, int row, int cell0, int cell1);
+uint64_t AgentForceSpanAVX2(const AgentForceArgs& args, int row, int cell0, int cell1);
+void AgentIntegrateSpanScalar(const AgentIntegrateArgs& args, int i0, int i1);
+void AgentIntegrateSpanSSE2(const AgentIntegrateArgs& args, int i0, int i1);
+void AgentIntegrateSpanAVX2(const AgentIntegrateArgs& args, int i0, int i1);
+
+// Expresiones (expr.h): ejecuta 'count' instrucciones sobre un tile de kExprTile puntos. regs[r]
+// apunta a los kExprTile floats del registro r.
+struct ExprInstr;
+
+typedef void (*ExprRunTileFn)(const ExprInstr* code, int count, float* const* regs);
+
+void ExprRunTileScalar(const ExprInstr* code, int count, float* const* regs);
+void ExprRunTileSSE2(const ExprInstr* code, int count, float* const* regs);
+void ExprRunTileAVX2(const ExprInstr* code, int count, float* const* regs);
+void ExprRunTileAVX512(const ExprInstr* code, int count, float* const* regs);
+
+// Constantes del shader, compartidas por todos los kernels.
+namespace shade
+{
+	constexpr float kHashX = 127.1f;
+	constexpr float kHashY = 311.7f;
+	constexpr float kHashScale = 43758.5453123f;
+	constexpr float kNoiseScale = 6.0f;
+
+	// Las esquinas de las celdas del ruido envuelven cada kNoisePeriod (noise_bake.h): x mod periodo,
+	// exacto en float para enteros (el periodo es potencia de dos).
+	constexpr float kLatticePeriod = 1024.0f;
+	constexpr float kInvLatticePeriod = 1.0f / kLatticePeriod;
+
+	// hash() de la variante CHEAP_HASH (fract/productos, sin sin())
+	constexpr float kCheapHashScale = 0.1031f;
+	constexpr float kCheapHashBias = 33.33f;
+
+	// Texels del ruido horneado: hash en [0,1) -> unorm16
+	constexpr float kNoiseQuantize = 65535.0f;
+
+	constexpr float kBaseR = 0.08f, kBaseG = 0.10f, kBaseB = 0.14f;
+	constexpr float kNoiseR = 0.35f * 0.20f, kNoiseG = 0.35f * 0.55f, kNoiseB = 0.35f * 0.95f;
+	constexpr float kWave = 0.15f * 0.5f;
+
+	// smoothstep(1.2, 0.2, d): t = clamp((d - 1.2) / (0.2 - 1.2), 0, 1)
+	constexpr float kVignetteEdge0 = 1.2f;
+	constexpr float kVignetteInvRange = 1.0f / (0.2f - 1.2f);
+}
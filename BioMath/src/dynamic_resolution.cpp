@@ -0,0 +1,425 @@
+#include "dynamic_resolution.h"
+#include "gl_state.h"
+#include "profiler.h"
+#include "shader_program.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+// Pares de timestamps en vuelo: la medicion de un frame se lee kTimerRing frames despues.
+static const int kTimerRing = 8;
+
+static const float kScaleQuantum = 1.0f / 40.0f;  // escalas posibles: multiplos de 2.5%
+static const double kEmaAlpha = 0.2;
+static const double kOverBudget = 1.0;             // bajar si la media pasa el presupuesto
+static const double kUnderBudget = 0.75;           // subir si se sostiene debajo del 75%
+static const double kAimBudget = 0.9;              // al recalcular, apuntar al 90% (margen)
+static const float kMaxRaiseStep = 0.1f;
+
+struct DynResGovernor
+{
+	double budgetMs = 16.0;
+	float minScale = 0.5f;
+	float maxScale = 1.0f;
+	float scale = 1.0f;
+
+	double emaMs = 0.0;
+	bool emaValid = false;
+	int underCount = 0;
+	uint64_t ignoreUntilFrame = 0; // mediciones de frames anteriores al cambio no valen
+};
+
+struct DynRes
+{
+	bool enabled = false;
+	bool log = false;
+	DynResGovernor gov;
+
+	// Render target: textura del tamanio de la salida, la escena usa w x h de la esquina.
+	GLuint fbo = 0;
+	GLuint texture = 0;
+	int texWidth = 0;
+	int texHeight = 0;
+	int sceneWidth = 0;
+	int sceneHeight = 0;
+	GLuint outputFbo = 0;
+
+	GLuint program = 0;
+	GLint uSrcScale = -1;
+	GLint uSrcMax = -1;
+
+	bool timing = false;
+	GLuint queries[kTimerRing][2] = {};
+	uint64_t queryFrame[kTimerRing] = {}; // frame + 1 grabado en el slot (0 = libre)
+	uint64_t frame = 0;
+	double lastGpuMs = 0.0;
+
+	DynResDecision decisions[kDynResDecisionRing] = {};
+	uint64_t decisionTotal = 0;
+	DynResDecisionFn callback = nullptr;
+};
+
+static DynRes g_dynres;
+
+void ParseDynResOptions(int argc, char** argv, DynResOptions* opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* a = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (strcmp(a, "--dynres") == 0) opts->enabled = true;
+		else if (strcmp(a, "--no-dynres") == 0) opts->enabled = false;
+		else if (strcmp(a, "--dynres-log") == 0) opts->log = true;
+		else if (strcmp(a, "--gpu-budget") == 0 && hasValue) opts->budgetMs = atof(argv[++i]);
+		else if (strcmp(a, "--dynres-min") == 0 && hasValue) opts->minScale = (float)atof(argv[++i]);
+		else if (strcmp(a, "--dynres-max") == 0 && hasValue) opts->maxScale = (float)atof(argv[++i]);
+		else if (strcmp(a, "--upsample") == 0 && hasValue)
+			opts->filter = strcmp(argv[++i], "bilinear") == 0 ? UpsampleFilter::Bilinear : UpsampleFilter::EdgeAware;
+	}
+
+	if (opts->maxScale > 1.0f || opts->maxScale <= 0.0f) opts->maxScale = 1.0f;
+	if (opts->minScale < 0.1f) opts->minScale = 0.1f;
+	if (opts->minScale > opts->maxScale) opts->minScale = opts->maxScale;
+}
+
+
+// ---------------------------
+// Governor
+// ---------------------------
+
+static float QuantizeScale(const DynResGovernor& gov, float scale)
+{
+	scale = floorf(scale / kScaleQuantum + 0.5f) * kScaleQuantum;
+	if (scale < gov.minScale) scale = gov.minScale;
+	if (scale > gov.maxScale) scale = gov.maxScale;
+	return scale;
+}
+
+static void RecordDecision(double gpuMs, float from, float to, const char* reason)
+{
+	DynResDecision& d = g_dynres.decisions[g_dynres.decisionTotal % kDynResDecisionRing];
+	d.frame = g_dynres.frame;
+	d.gpuMs = gpuMs;
+	d.budgetMs = g_dynres.gov.budgetMs;
+	d.fromScale = from;
+	d.toScale = to;
+	d.reason = reason;
+	++g_dynres.decisionTotal;
+
+	if (g_dynres.log)
+		fprintf(stderr, "dynres: frame %llu gpu %.2f ms (budget %.2f) scale %.3f -> %.3f (%s)\n",
+			(unsigned long long)d.frame, gpuMs, d.budgetMs, from, to, reason);
+	if (g_dynres.callback) g_dynres.callback(d);
+}
+
+// Una medicion de GPU de la escena del frame 'measuredFrame'.
+static void GovernorUpdate(uint64_t measuredFrame, double gpuMs)
+{
+	DynResGovernor& gov = g_dynres.gov;
+	if (measuredFrame < gov.ignoreUntilFrame) return;
+
+	gov.emaMs = gov.emaValid ? gov.emaMs + kEmaAlpha * (gpuMs - gov.emaMs) : gpuMs;
+	gov.emaValid = true;
+
+	const float from = gov.scale;
+	float to = from;
+	const char* reason = nullptr;
+
+	// El costo va con la cantidad de pixeles: escala nueva = escala * sqrt(presupuesto / medido).
+	const double ratio = sqrt(gov.budgetMs * kAimBudget / (gov.emaMs > 1e-6 ? gov.emaMs : 1e-6));
+
+	if (gov.emaMs > gov.budgetMs * kOverBudget)
+	{
+		gov.underCount = 0;
+		to = QuantizeScale(gov, (float)(from * ratio) - kScaleQuantum * 0.5f); // redondear hacia abajo
+		reason = "over_budget";
+	}
+	else if (gov.emaMs < gov.budgetMs * kUnderBudget)
+	{
+		if (++gov.underCount >= kDynResRaiseFrames)
+		{
+			gov.underCount = 0;
+			float raised = (float)(from * ratio);
+			if (raised > from + kMaxRaiseStep) raised = from + kMaxRaiseStep;
+			to = QuantizeScale(gov, raised);
+			reason = "headroom";
+		}
+	}
+	else
+	{
+		gov.underCount = 0;
+	}
+
+	if (!reason || to == from) return;
+
+	RecordDecision(gov.emaMs, from, to, reason);
+	gov.scale = to;
+
+	// La media vieja se midio con otra escala: se estima para la nueva, y las mediciones de los
+	// frames que ya estan en vuelo (anteriores a este) se ignoran.
+	gov.emaMs *= ((double)to * to) / ((double)from * from);
+	gov.ignoreUntilFrame = g_dynres.frame;
+}
+
+
+// ---------------------------
+// Timers de GPU
+// ---------------------------
+
+static void ResolveTimer(int slot)
+{
+	if (!g_dynres.queryFrame[slot]) return;
+
+	GLint available = 0;
+	glGetQueryObjectiv_ptr(g_dynres.queries[slot][1], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available) return; // se pierde esta medicion: nunca se espera a la GPU
+
+	GLuint64 begin = 0, end = 0;
+	glGetQueryObjectui64v_ptr(g_dynres.queries[slot][0], GL_QUERY_RESULT, &begin);
+	glGetQueryObjectui64v_ptr(g_dynres.queries[slot][1], GL_QUERY_RESULT, &end);
+	const uint64_t measuredFrame = g_dynres.queryFrame[slot] - 1;
+	g_dynres.queryFrame[slot] = 0;
+
+	if (end <= begin) return;
+	g_dynres.lastGpuMs = (double)(end - begin) * 1e-6;
+	GovernorUpdate(measuredFrame, g_dynres.lastGpuMs);
+}
+
+
+// ---------------------------
+// Ciclo de vida
+// ---------------------------
+
+static bool ResizeTarget(int width, int height)
+{
+	if (width == g_dynres.texWidth && height == g_dynres.texHeight) return true;
+	PROFILE_ZONE("DynResResize");
+
+	GLStateBindTexture2D(0, g_dynres.texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+	GLStateBindFramebuffer(GL_FRAMEBUFFER, g_dynres.fbo);
+	glFramebufferTexture2D_ptr(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, g_dynres.texture, 0);
+	const bool complete = glCheckFramebufferStatus_ptr(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+	g_dynres.texWidth = width;
+	g_dynres.texHeight = height;
+	return complete;
+}
+
+// Tambien despues de un hot reload (ShaderWatch).
+static void LocateUniforms(GLuint program)
+{
+	g_dynres.uSrcScale = glGetUniformLocation_ptr(program, "uSrcScale");
+	g_dynres.uSrcMax = glGetUniformLocation_ptr(program, "uSrcMax");
+}
+
+bool DynResInit(const DynResOptions& opts, double defaultBudgetMs)
+{
+	PROFILE_ZONE("DynResInit");
+
+	g_dynres.enabled = false;
+	g_dynres.log = opts.log;
+	g_dynres.gov = DynResGovernor();
+	g_dynres.gov.budgetMs = opts.budgetMs > 0.0 ? opts.budgetMs : defaultBudgetMs;
+	g_dynres.gov.minScale = opts.minScale;
+	g_dynres.gov.maxScale = opts.maxScale;
+	g_dynres.gov.scale = opts.maxScale;
+	if (!opts.enabled) return true;
+
+	if (!glGenFramebuffers_ptr || !glFramebufferTexture2D_ptr || !glCheckFramebufferStatus_ptr || !glActiveTexture_ptr)
+	{
+		fprintf(stderr, "dynres: framebuffer objects not available, rendering at full resolution\n");
+		return false;
+	}
+
+	ShaderFile file;
+	std::string error;
+	if (!ShaderFileLoad("upsample.glsl", &file, &error))
+	{
+		fprintf(stderr, "dynres: %s\n", error.c_str());
+		return false;
+	}
+	const char* defines = opts.filter == UpsampleFilter::EdgeAware ? "#define EDGE_AWARE 1\n" : "#define EDGE_AWARE 0\n";
+	g_dynres.program = ShaderBuildProgram(file, defines, &error);
+	if (!g_dynres.program)
+	{
+		fprintf(stderr, "dynres: upsample shader failed, rendering at full resolution\n%s", error.c_str());
+		return false;
+	}
+	LocateUniforms(g_dynres.program);
+	ShaderWatch("upsample.glsl", file, defines, &g_dynres.program, LocateUniforms);
+
+	glGenTextures(1, &g_dynres.texture);
+	GLStateBindTexture2D(0, g_dynres.texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glGenFramebuffers_ptr(1, &g_dynres.fbo);
+	g_dynres.texWidth = g_dynres.texHeight = 0;
+
+	// Sin timestamps no hay mediciones: la escala queda fija en maxScale.
+	g_dynres.timing = glGenQueries_ptr && glQueryCounter_ptr && glGetQueryObjectiv_ptr && glGetQueryObjectui64v_ptr;
+	if (g_dynres.timing)
+	{
+		for (int i = 0; i < kTimerRing; ++i) glGenQueries_ptr(2, g_dynres.queries[i]);
+		memset(g_dynres.queryFrame, 0, sizeof(g_dynres.queryFrame));
+	}
+
+	g_dynres.frame = 0;
+	g_dynres.decisionTotal = 0;
+	g_dynres.enabled = true;
+	return true;
+}
+
+void DynResShutdown()
+{
+	if (g_dynres.timing)
+	{
+		for (int i = 0; i < kTimerRing; ++i) glDeleteQueries_ptr(2, g_dynres.queries[i]);
+		g_dynres.timing = false;
+	}
+	GLStateDeleteFramebuffer(g_dynres.fbo);
+	GLStateDeleteTexture(g_dynres.texture);
+	ShaderUnwatch(&g_dynres.program);
+	GLStateDeleteProgram(g_dynres.program);
+	g_dynres.fbo = 0;
+	g_dynres.texture = 0;
+	g_dynres.program = 0;
+	g_dynres.texWidth = g_dynres.texHeight = 0;
+	g_dynres.enabled = false;
+}
+
+bool DynResEnabled()
+{
+	return g_dynres.enabled;
+}
+
+
+// ---------------------------
+// Frame
+// ---------------------------
+
+void DynResBeginScene(int outputWidth, int outputHeight, int* sceneWidth, int* sceneHeight)
+{
+	*sceneWidth = outputWidth;
+	*sceneHeight = outputHeight;
+	if (!g_dynres.enabled) return;
+	PROFILE_ZONE("DynResBeginScene");
+
+	++g_dynres.frame;
+	const int slot = (int)(g_dynres.frame % kTimerRing);
+	if (g_dynres.timing) ResolveTimer(slot);
+
+	g_dynres.outputFbo = GLStateDrawFramebuffer();
+	if (!ResizeTarget(outputWidth > 0 ? outputWidth : 1, outputHeight > 0 ? outputHeight : 1))
+	{
+		// Sin render target usable: se apaga y se dibuja directo.
+		GLStateBindFramebuffer(GL_FRAMEBUFFER, g_dynres.outputFbo);
+		fprintf(stderr, "dynres: framebuffer %dx%d incomplete, rendering at full resolution\n", outputWidth, outputHeight);
+		DynResShutdown();
+		return;
+	}
+
+	const float scale = g_dynres.gov.scale;
+	int w = (int)lroundf((float)g_dynres.texWidth * scale);
+	int h = (int)lroundf((float)g_dynres.texHeight * scale);
+	g_dynres.sceneWidth = w > 0 ? w : 1;
+	g_dynres.sceneHeight = h > 0 ? h : 1;
+	*sceneWidth = g_dynres.sceneWidth;
+	*sceneHeight = g_dynres.sceneHeight;
+
+	GLStateBindFramebuffer(GL_FRAMEBUFFER, g_dynres.fbo);
+	if (g_dynres.timing)
+	{
+		glQueryCounter_ptr(g_dynres.queries[slot][0], GL_TIMESTAMP);
+		g_dynres.queryFrame[slot] = 0;
+	}
+}
+
+void DynResEndScene(GLuint fullscreenVao)
+{
+	if (!g_dynres.enabled) return;
+	PROFILE_GPU_ZONE("Upsample");
+
+	const int slot = (int)(g_dynres.frame % kTimerRing);
+	if (g_dynres.timing)
+	{
+		glQueryCounter_ptr(g_dynres.queries[slot][1], GL_TIMESTAMP);
+		g_dynres.queryFrame[slot] = g_dynres.frame + 1;
+	}
+
+	const float tw = (float)g_dynres.texWidth;
+	const float th = (float)g_dynres.texHeight;
+
+	GLStateBindFramebuffer(GL_FRAMEBUFFER, g_dynres.outputFbo);
+	GLStateViewport(0, 0, g_dynres.texWidth, g_dynres.texHeight);
+	GLStateUseProgram(g_dynres.program);
+	GLStateUniform2f(g_dynres.uSrcScale, (float)g_dynres.sceneWidth / tw, (float)g_dynres.sceneHeight / th);
+	GLStateUniform2f(g_dynres.uSrcMax, ((float)g_dynres.sceneWidth - 0.5f) / tw, ((float)g_dynres.sceneHeight - 0.5f) / th);
+	GLStateBindTexture2D(0, g_dynres.texture);
+	GLStateBindVertexArray(fullscreenVao);
+	GLStateDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+
+// ---------------------------
+// Consultas
+// ---------------------------
+
+float DynResScale()
+{
+	return g_dynres.enabled ? g_dynres.gov.scale : 1.0f;
+}
+
+double DynResBudgetMs()
+{
+	return g_dynres.gov.budgetMs;
+}
+
+double DynResLastGpuMs()
+{
+	return g_dynres.lastGpuMs;
+}
+
+int DynResDecisionCount()
+{
+	return g_dynres.decisionTotal < (uint64_t)kDynResDecisionRing ? (int)g_dynres.decisionTotal : kDynResDecisionRing;
+}
+
+DynResDecision DynResDecisionAt(int index)
+{
+	const uint64_t first = g_dynres.decisionTotal - (uint64_t)DynResDecisionCount();
+	return g_dynres.decisions[(first + (uint64_t)index) % kDynResDecisionRing];
+}
+
+uint64_t DynResDecisionTotal()
+{
+	return g_dynres.decisionTotal;
+}
+
+void DynResSetDecisionCallback(DynResDecisionFn fn)
+{
+	g_dynres.callback = fn;
+}
+
+void WriteDynResJson(FILE* f)
+{
+	fprintf(f, "\"dynres\": { \"enabled\": %s, \"budget_ms\": %.3f, \"scale\": %.3f, \"last_gpu_ms\": %.3f, \"decisions\": %llu",
+		g_dynres.enabled ? "true" : "false", g_dynres.gov.budgetMs, DynResScale(), g_dynres.lastGpuMs,
+		(unsigned long long)g_dynres.decisionTotal);
+
+	fprintf(f, ", \"log\": [");
+	const int count = DynResDecisionCount();
+	for (int i = 0; i < count; ++i)
+	{
+		const DynResDecision d = DynResDecisionAt(i);
+		fprintf(f, "%s{ \"frame\": %llu, \"gpu_ms\": %.3f, \"from\": %.3f, \"to\": %.3f, \"reason\": \"%s\" }",
+			i ? ", " : "", (unsigned long long)d.frame, d.gpuMs, d.fromScale, d.toScale, d.reason);
+	}
+	fprintf(f, "] }");
+}
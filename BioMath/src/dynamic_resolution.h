@@ -0,0 +1,92 @@
+#pragma once
+
+#include "gl_api.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+// ---------------------------
+// Resolucion dinamica
+// ---------------------------
+
+// El fragment shader del fondo corre una vez por pixel de la ventana: en 4K con una GPU integrada
+// no entra en el frame. Con resolucion dinamica la escena se dibuja en un FBO mas chico y un pase
+// de upsample (shaders/upsample.glsl, bilineal o con realce de bordes) la lleva al backbuffer.
+//
+// La escala la decide un governor a partir del tiempo de GPU medido de la escena (pares de
+// GL_TIMESTAMP leidos unos frames despues, sin bloquear) contra un presupuesto en ms:
+//
+//   - por encima del presupuesto baja enseguida, en proporcion (el costo va con los pixeles, o sea
+//     con escala^2);
+//   - con margen sostenido (kDynResRaiseFrames mediciones debajo del 75%) sube de a poco;
+//   - despues de cada cambio espera a que lleguen mediciones con la escala nueva.
+//
+// La textura tiene el tamanio de la ventana y la escena usa la esquina inferior izquierda, asi
+// que cambiar de escala no realoca nada. Cada decision queda registrada (DynResDecisionAt,
+// callback opcional) para poder loguearla.
+//
+// Uso por frame:
+//
+//   int w, h;
+//   DynResBeginScene(outW, outH, &w, &h);  // bindea el FBO (o nada si esta apagado)
+//   ... dibujar la escena en w x h ...
+//   DynResEndScene(vao);                   // upsample al framebuffer que estaba bindeado
+
+enum class UpsampleFilter
+{
+	Bilinear,
+	EdgeAware,
+};
+
+struct DynResOptions
+{
+	bool enabled = true;
+	double budgetMs = 0.0;   // 0 = lo que pase DynResInit (derivado del frame pacer)
+	float minScale = 0.5f;
+	float maxScale = 1.0f;
+	UpsampleFilter filter = UpsampleFilter::EdgeAware;
+	bool log = false;        // decisiones del governor a stderr
+};
+
+static const int kDynResRaiseFrames = 60;
+
+// --dynres / --no-dynres, --gpu-budget ms, --dynres-min s, --dynres-max s,
+// --upsample bilinear|edge, --dynres-log
+void ParseDynResOptions(int argc, char** argv, DynResOptions* opts);
+
+// Requiere contexto GL. 'defaultBudgetMs' se usa si opts.budgetMs es 0. Si falta algo (FBO,
+// texturas, shader) queda apagado y la escena se dibuja directo: devuelve false solo como aviso.
+bool DynResInit(const DynResOptions& opts, double defaultBudgetMs);
+void DynResShutdown();
+bool DynResEnabled();
+
+void DynResBeginScene(int outputWidth, int outputHeight, int* sceneWidth, int* sceneHeight);
+void DynResEndScene(GLuint fullscreenVao);
+
+float DynResScale();
+double DynResBudgetMs();
+double DynResLastGpuMs(); // ultima medicion de la escena (0 si todavia no hay)
+
+struct DynResDecision
+{
+	uint64_t frame;
+	double gpuMs;        // medicion filtrada que disparo el cambio
+	double budgetMs;
+	float fromScale;
+	float toScale;
+	const char* reason;  // "over_budget" | "headroom"
+};
+
+typedef void (*DynResDecisionFn)(const DynResDecision& decision);
+
+// Ultimas decisiones (ring de kDynResDecisionRing). index 0 = la mas vieja que sobrevive.
+static const int kDynResDecisionRing = 256;
+int DynResDecisionCount();
+DynResDecision DynResDecisionAt(int index);
+uint64_t DynResDecisionTotal();
+
+// Se llama en el thread de render en cada cambio de escala.
+void DynResSetDecisionCallback(DynResDecisionFn fn);
+
+// "dynres": { ... } para los reportes JSON.
+void WriteDynResJson(FILE* f);
@@ -0,0 +1,897 @@
+#include "expr.h"
+#include "cpu_features.h"
+#include "expr_vm_kernels.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <map>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tuple>
+
+// ---------------------------
+// Kernels escalar y SSE2 (AVX2 y AVX-512 estan en expr_vm_avx2.cpp / expr_vm_avx512.cpp)
+// ---------------------------
+
+void ExprRunTileScalar(const ExprInstr* code, int count, float* const* regs)
+{
+	expr::RunTile<lanes::F1>(code, count, regs);
+}
+
+void ExprRunTileSSE2(const ExprInstr* code, int count, float* const* regs)
+{
+	expr::RunTile<lanes::F4>(code, count, regs);
+}
+
+// ---------------------------
+// Construccion del grafo
+// ---------------------------
+
+static const int kMaxNodes = 8192;     // los registros son uint16 y el arbol se recorre recursivo
+static const int kMaxNesting = 200;
+
+static bool IsUnary(ExprOp op)
+{
+	return op == ExprOp::Neg || op >= ExprOp::Sin;
+}
+
+// Valores ya calculados del punto actual, por nodo. pow() arma x*x con los dos operandos en el
+// mismo nodo, asi que el "arbol" es un DAG: sin memo, una cadena de potencias anidadas se
+// recorreria 2^profundidad veces. stamp[n] == pass: value[n] vale para este punto.
+struct TreeMemo
+{
+	std::vector<float> value;
+	std::vector<uint32_t> stamp;
+	uint32_t pass = 0;
+};
+
+static float EvalNode(const std::vector<ExprNode>& nodes, int n, const float* values, TreeMemo& memo)
+{
+	const ExprNode& node = nodes[(size_t)n];
+	if (node.op == ExprOp::Const) return node.value;
+	if (node.op == ExprOp::Var) return values[node.a];
+	if (memo.stamp[(size_t)n] == memo.pass) return memo.value[(size_t)n];
+	const lanes::F1 a = EvalNode(nodes, node.a, values, memo);
+	const lanes::F1 b = node.b >= 0 ? lanes::F1(EvalNode(nodes, node.b, values, memo)) : a;
+	const float r = expr::Apply<lanes::F1>(node.op, a, b).v;
+	memo.stamp[(size_t)n] = memo.pass;
+	memo.value[(size_t)n] = r;
+	return r;
+}
+
+// Un punto con el interprete recursivo. El memo es por thread (ParallelFor).
+static float EvalTree(const std::vector<ExprNode>& nodes, int root, const float* values)
+{
+	thread_local TreeMemo memo;
+	if (memo.stamp.size() < nodes.size())
+	{
+		memo.value.resize(nodes.size());
+		memo.stamp.assign(nodes.size(), 0);
+		memo.pass = 0;
+	}
+	if (++memo.pass == 0)
+	{
+		std::fill(memo.stamp.begin(), memo.stamp.end(), 0u);
+		memo.pass = 1;
+	}
+	return EvalNode(nodes, root, values, memo);
+}
+
+// Arma los nodos. Sin optimizar es un arbol tal cual se escribio (salvo las funciones que se bajan
+// a otras); optimizado pliega, simplifica y comparte subexpresiones.
+struct ExprBuilder
+{
+	std::vector<ExprNode>* nodes = nullptr;
+	bool optimize = false;
+	ExprStats* stats = nullptr;
+	std::map<std::tuple<int, int, int, uint32_t>, int> unique;   // (op, a, b, bits del valor)
+	std::vector<uint8_t> isConst;     // por nodo: sin variables (se calcula en Add)
+	std::vector<float> constValue;    // su valor, si isConst
+
+	int Add(const ExprNode& node)
+	{
+		if (optimize)
+		{
+			uint32_t bits;
+			memcpy(&bits, &node.value, sizeof(bits));
+			const auto key = std::make_tuple((int)node.op, node.a, node.b, bits);
+			const auto it = unique.find(key);
+			if (it != unique.end())
+			{
+				if (node.op != ExprOp::Const && node.op != ExprOp::Var) ++stats->cseHits;
+				return it->second;
+			}
+			unique[key] = (int)nodes->size();
+		}
+
+		bool constant = node.op == ExprOp::Const;
+		float value = node.value;
+		if (node.op != ExprOp::Const && node.op != ExprOp::Var)
+		{
+			constant = isConst[(size_t)node.a] && (node.b < 0 || isConst[(size_t)node.b]);
+			if (constant)
+			{
+				const lanes::F1 va = constValue[(size_t)node.a];
+				const lanes::F1 vb = node.b >= 0 ? lanes::F1(constValue[(size_t)node.b]) : va;
+				value = expr::Apply<lanes::F1>(node.op, va, vb).v;
+			}
+		}
+		isConst.push_back(constant ? 1 : 0);
+		constValue.push_back(value);
+		nodes->push_back(node);
+		return (int)nodes->size() - 1;
+	}
+
+	int Const(float v)
+	{
+		ExprNode node;
+		node.value = v;
+		return Add(node);
+	}
+
+	int Var(int index)
+	{
+		ExprNode node;
+		node.op = ExprOp::Var;
+		node.a = index;
+		return Add(node);
+	}
+
+	// Valor de un subarbol sin variables. Sin optimizar tambien, para que las decisiones de
+	// pow() sean las mismas en los dos grafos.
+	bool ConstValue(int n, float* v) const
+	{
+		if (!isConst[(size_t)n]) return false;
+		*v = constValue[(size_t)n];
+		return true;
+	}
+
+	bool IsConst(int n, float v) const
+	{
+		const ExprNode& node = (*nodes)[(size_t)n];
+		return node.op == ExprOp::Const && node.value == v;
+	}
+
+	int Op(ExprOp op, int a, int b = -1)
+	{
+		if (optimize)
+		{
+			const ExprNode& na = (*nodes)[(size_t)a];
+			const bool constA = na.op == ExprOp::Const;
+			const bool constB = b < 0 || (*nodes)[(size_t)b].op == ExprOp::Const;
+			if (constA && constB)
+			{
+				const lanes::F1 va = na.value;
+				const lanes::F1 vb = b >= 0 ? lanes::F1((*nodes)[(size_t)b].value) : va;
+				const float r = expr::Apply<lanes::F1>(op, va, vb).v;
+				// Sin literales para inf/NaN en GLSL: esos quedan como operacion.
+				if (isfinite(r))
+				{
+					++stats->folded;
+					return Const(r);
+				}
+			}
+
+			// Solo simplificaciones exactas (a lo sumo cambian el signo de un cero).
+			int same = -1;
+			if ((op == ExprOp::Add || op == ExprOp::Sub) && IsConst(b, 0.0f)) same = a;
+			if (op == ExprOp::Add && IsConst(a, 0.0f)) same = b;
+			if ((op == ExprOp::Mul || op == ExprOp::Div) && IsConst(b, 1.0f)) same = a;
+			if (op == ExprOp::Mul && IsConst(a, 1.0f)) same = b;
+			if (op == ExprOp::Neg && na.op == ExprOp::Neg) same = na.a;
+			if (same >= 0)
+			{
+				++stats->simplified;
+				return same;
+			}
+
+			// Conmutativas: orden canonico para que x*y y y*x sean el mismo nodo. min/max no,
+			// porque con NaN o con ceros de distinto signo el orden cambia el resultado.
+			if ((op == ExprOp::Add || op == ExprOp::Mul) && b < a) std::swap(a, b);
+		}
+
+		ExprNode node;
+		node.op = op;
+		node.a = a;
+		node.b = IsUnary(op) ? -1 : b;
+		return Add(node);
+	}
+
+	// ---- Funciones que se bajan a otras ----
+
+	int Pow(int a, int b)
+	{
+		float e;
+		if (ConstValue(b, &e) && e == floorf(e) && fabsf(e) <= (float)kExprMaxPowExponent)
+		{
+			int n = (int)fabsf(e);
+			if (n == 0) return Const(1.0f);
+			// Cuadrados sucesivos: x^5 = x * (x^2)^2.
+			int result = -1, base = a;
+			for (;;)
+			{
+				if (n & 1) result = result < 0 ? base : Op(ExprOp::Mul, result, base);
+				n >>= 1;
+				if (!n) break;
+				base = Op(ExprOp::Mul, base, base);
+			}
+			return e < 0.0f ? Op(ExprOp::Div, Const(1.0f), result) : result;
+		}
+		if (ConstValue(b, &e) && e == 0.5f) return Op(ExprOp::Sqrt, a);
+		return Op(ExprOp::Exp, Op(ExprOp::Mul, b, Op(ExprOp::Log, a)));
+	}
+
+	int Clamp(int x, int lo, int hi)
+	{
+		return Op(ExprOp::Min, Op(ExprOp::Max, x, lo), hi);
+	}
+
+	int Smoothstep(int e0, int e1, int x)
+	{
+		const int t = Clamp(Op(ExprOp::Div, Op(ExprOp::Sub, x, e0), Op(ExprOp::Sub, e1, e0)), Const(0.0f), Const(1.0f));
+		return Op(ExprOp::Mul, Op(ExprOp::Mul, t, t), Op(ExprOp::Sub, Const(3.0f), Op(ExprOp::Mul, Const(2.0f), t)));
+	}
+};
+
+// ---------------------------
+// Parser
+// ---------------------------
+
+struct ExprFunction
+{
+	const char* name;
+	int args;
+};
+
+static const ExprFunction kFunctions[] = {
+	{ "sin", 1 }, { "cos", 1 }, { "tan", 1 }, { "exp", 1 }, { "log", 1 }, { "sqrt", 1 },
+	{ "abs", 1 }, { "floor", 1 }, { "fract", 1 },
+	{ "min", 2 }, { "max", 2 }, { "pow", 2 }, { "step", 2 },
+	{ "clamp", 3 }, { "mix", 3 }, { "smoothstep", 3 },
+};
+
+// Recursivo descendente. Cada regla devuelve el nodo o -1 (con el error ya escrito).
+//   expr    := term (('+' | '-') term)*
+//   term    := unary (('*' | '/') unary)*
+//   unary   := ('-' | '+') unary | power
+//   power   := primary ('^' unary)?
+//   primary := numero | nombre | nombre '(' expr (',' expr)* ')' | '(' expr ')'
+struct ExprParser
+{
+	const char* src = nullptr;
+	const char* p = nullptr;
+	const std::vector<std::string>* vars = nullptr;
+	ExprBuilder* b = nullptr;
+	std::string error;
+	int depth = 0;
+
+	int Fail(const char* what)
+	{
+		if (error.empty())
+		{
+			char buf[160];
+			snprintf(buf, sizeof(buf), "%s at column %d", what, (int)(p - src) + 1);
+			error = buf;
+		}
+		return -1;
+	}
+
+	void Skip()
+	{
+		while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') ++p;
+	}
+
+	bool Accept(char c)
+	{
+		Skip();
+		if (*p != c) return false;
+		++p;
+		return true;
+	}
+
+	bool TooBig()
+	{
+		return b->nodes->size() > (size_t)kMaxNodes;
+	}
+
+	int Expr()
+	{
+		if (++depth > kMaxNesting) return Fail("expression nested too deep");
+		int n = Term();
+		while (n >= 0)
+		{
+			if (Accept('+')) { const int r = Term(); n = r < 0 ? -1 : b->Op(ExprOp::Add, n, r); }
+			else if (Accept('-')) { const int r = Term(); n = r < 0 ? -1 : b->Op(ExprOp::Sub, n, r); }
+			else break;
+		}
+		--depth;
+		return n;
+	}
+
+	int Term()
+	{
+		int n = Unary();
+		while (n >= 0)
+		{
+			if (Accept('*')) { const int r = Unary(); n = r < 0 ? -1 : b->Op(ExprOp::Mul, n, r); }
+			else if (Accept('/')) { const int r = Unary(); n = r < 0 ? -1 : b->Op(ExprOp::Div, n, r); }
+			else break;
+		}
+		return n;
+	}
+
+	int Unary()
+	{
+		if (++depth > kMaxNesting) return Fail("expression nested too deep");
+		int n;
+		if (Accept('-')) { n = Unary(); n = n < 0 ? -1 : b->Op(ExprOp::Neg, n); }
+		else if (Accept('+')) n = Unary();
+		else n = Power();
+		--depth;
+		return n;
+	}
+
+	int Power()
+	{
+		const int n = Primary();
+		if (n < 0 || !Accept('^')) return n;
+		const int e = Unary();
+		return e < 0 ? -1 : b->Pow(n, e);
+	}
+
+	int Primary()
+	{
+		if (TooBig()) return Fail("expression too large");
+		Skip();
+		if (Accept('('))
+		{
+			const int n = Expr();
+			if (n < 0) return -1;
+			return Accept(')') ? n : Fail("expected ')'");
+		}
+
+		if ((*p >= '0' && *p <= '9') || *p == '.')
+		{
+			char* end = nullptr;
+			const float v = strtof(p, &end);
+			if (end == p) return Fail("bad number");
+			if (!isfinite(v)) return Fail("number out of range");
+			p = end;
+			return b->Const(v);
+		}
+
+		if (!isalpha((unsigned char)*p) && *p != '_') return Fail(*p ? "unexpected character" : "unexpected end");
+		const char* start = p;
+		while (isalnum((unsigned char)*p) || *p == '_') ++p;
+		const std::string name(start, (size_t)(p - start));
+
+		for (size_t i = 0; i < vars->size(); ++i)
+			if ((*vars)[i] == name) return b->Var((int)i);
+		if (name == "pi") return b->Const(3.14159265358979f);
+		if (name == "e") return b->Const(2.71828182845905f);
+
+		const ExprFunction* fn = nullptr;
+		for (const ExprFunction& f : kFunctions)
+			if (name == f.name) fn = &f;
+		if (!fn)
+		{
+			p = start;
+			return Fail(("unknown name '" + name + "'").c_str());
+		}
+
+		if (!Accept('(')) return Fail("expected '('");
+		int args[3] = { -1, -1, -1 };
+		for (int i = 0; i < fn->args; ++i)
+		{
+			if (i > 0 && !Accept(',')) return Fail(("'" + name + "' takes " + std::to_string(fn->args) + " arguments").c_str());
+			args[i] = Expr();
+			if (args[i] < 0) return -1;
+		}
+		if (!Accept(')'))
+			return Accept(',') ? Fail(("'" + name + "' takes " + std::to_string(fn->args) + " arguments").c_str()) : Fail("expected ')'");
+		return Call(name, args);
+	}
+
+	int Call(const std::string& name, const int* a)
+	{
+		if (name == "sin") return b->Op(ExprOp::Sin, a[0]);
+		if (name == "cos") return b->Op(ExprOp::Cos, a[0]);
+		if (name == "tan") return b->Op(ExprOp::Div, b->Op(ExprOp::Sin, a[0]), b->Op(ExprOp::Cos, a[0]));
+		if (name == "exp") return b->Op(ExprOp::Exp, a[0]);
+		if (name == "log") return b->Op(ExprOp::Log, a[0]);
+		if (name == "sqrt") return b->Op(ExprOp::Sqrt, a[0]);
+		if (name == "abs") return b->Op(ExprOp::Abs, a[0]);
+		if (name == "floor") return b->Op(ExprOp::Floor, a[0]);
+		if (name == "fract") return b->Op(ExprOp::Fract, a[0]);
+		if (name == "min") return b->Op(ExprOp::Min, a[0], a[1]);
+		if (name == "max") return b->Op(ExprOp::Max, a[0], a[1]);
+		if (name == "pow") return b->Pow(a[0], a[1]);
+		if (name == "step") return b->Op(ExprOp::Step, a[0], a[1]);
+		if (name == "clamp") return b->Clamp(a[0], a[1], a[2]);
+		if (name == "mix") return b->Op(ExprOp::Add, a[0], b->Op(ExprOp::Mul, b->Op(ExprOp::Sub, a[1], a[0]), a[2]));
+		return b->Smoothstep(a[0], a[1], a[2]);
+	}
+
+	int Parse()
+	{
+		p = src;
+		const int n = Expr();
+		if (n < 0) return -1;
+		Skip();
+		if (*p) return Fail("unexpected character");
+		if (TooBig()) return Fail("expression too large");
+		return n;
+	}
+};
+
+// ---------------------------
+// Bytecode
+// ---------------------------
+
+// Un registro por entrada y por constante viva; los temporales se reusan cuando muere su ultimo
+// uso. Como los nodos ya estan en orden topologico, el orden de las instrucciones es ese.
+static void EmitBytecode(ExprProgram* prog)
+{
+	const std::vector<ExprNode>& nodes = prog->nodes;
+	const int n = (int)nodes.size();
+	const int varCount = (int)prog->vars.size();
+
+	std::vector<char> live((size_t)n, 0);
+	std::vector<int> lastUse((size_t)n, -1);
+	live[(size_t)prog->root] = 1;
+	for (int i = n - 1; i >= 0; --i)
+	{
+		const ExprNode& node = nodes[(size_t)i];
+		if (!live[(size_t)i] || node.op == ExprOp::Const || node.op == ExprOp::Var) continue;
+		live[(size_t)node.a] = 1;
+		lastUse[(size_t)node.a] = std::max(lastUse[(size_t)node.a], i);
+		if (node.b >= 0)
+		{
+			live[(size_t)node.b] = 1;
+			lastUse[(size_t)node.b] = std::max(lastUse[(size_t)node.b], i);
+		}
+	}
+
+	std::vector<int> reg((size_t)n, -1);
+	prog->constants.clear();
+	prog->stats.nodes = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		if (!live[(size_t)i]) continue;
+		++prog->stats.nodes;
+		const ExprNode& node = nodes[(size_t)i];
+		if (node.op == ExprOp::Var) reg[(size_t)i] = node.a;
+		if (node.op == ExprOp::Const)
+		{
+			reg[(size_t)i] = varCount + (int)prog->constants.size();
+			prog->constants.push_back(node.value);
+		}
+	}
+
+	int next = varCount + (int)prog->constants.size();
+	std::vector<int> freeRegs;
+	prog->code.clear();
+	for (int i = 0; i < n; ++i)
+	{
+		const ExprNode& node = nodes[(size_t)i];
+		if (!live[(size_t)i] || node.op == ExprOp::Const || node.op == ExprOp::Var) continue;
+		const int ra = reg[(size_t)node.a];
+		const int rb = node.b >= 0 ? reg[(size_t)node.b] : ra;
+
+		// Los operandos temporales que mueren aca liberan su registro antes de elegir el destino.
+		for (int o : { node.a, node.b })
+		{
+			if (o < 0 || (o == node.b && node.b == node.a)) continue;
+			const ExprOp opOp = nodes[(size_t)o].op;
+			if (opOp != ExprOp::Const && opOp != ExprOp::Var && lastUse[(size_t)o] == i) freeRegs.push_back(reg[(size_t)o]);
+		}
+		int dst;
+		if (freeRegs.empty()) dst = next++;
+		else
+		{
+			dst = freeRegs.back();
+			freeRegs.pop_back();
+		}
+		reg[(size_t)i] = dst;
+		prog->code.push_back({ node.op, (uint16_t)dst, (uint16_t)ra, (uint16_t)rb });
+	}
+
+	const ExprOp rootOp = nodes[(size_t)prog->root].op;
+	if (rootOp == ExprOp::Const || rootOp == ExprOp::Var)
+	{
+		const int src = reg[(size_t)prog->root];
+		prog->code.push_back({ ExprOp::Copy, (uint16_t)next, (uint16_t)src, (uint16_t)src });
+		prog->result = next++;
+	}
+	else
+	{
+		prog->result = reg[(size_t)prog->root];
+	}
+	prog->registers = next;
+}
+
+bool ExprCompile(const char* source, const char* const* varNames, int varCount, ExprProgram* program, std::string* error)
+{
+	*program = ExprProgram();
+	if (!source || varCount < 0 || varCount > kExprMaxVars)
+	{
+		if (error) *error = "bad arguments";
+		return false;
+	}
+	program->source = source;
+	for (int i = 0; i < varCount; ++i)
+		program->vars.push_back(varNames[i]);
+
+	// Dos pasadas del parser: el arbol tal cual (referencia) y el grafo optimizado.
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		ExprBuilder builder;
+		builder.optimize = pass == 1;
+		builder.nodes = pass == 0 ? &program->tree : &program->nodes;
+		builder.stats = &program->stats;
+
+		ExprParser parser;
+		parser.src = source;
+		parser.vars = &program->vars;
+		parser.b = &builder;
+		const int root = parser.Parse();
+		if (root < 0)
+		{
+			if (error) *error = parser.error;
+			return false;
+		}
+		if (pass == 0) program->treeRoot = root;
+		else program->root = root;
+	}
+	program->stats.parsedNodes = (int)program->tree.size();
+
+	EmitBytecode(program);
+	return true;
+}
+
+// ---------------------------
+// GLSL y listado
+// ---------------------------
+
+static std::string FormatConst(float v)
+{
+	char buf[48];
+	snprintf(buf, sizeof(buf), "%.9g", (double)v);
+	std::string s = buf;
+	if (s.find_first_of(".e") == std::string::npos) s += ".0";
+	return v < 0.0f ? "(" + s + ")" : s;
+}
+
+static const char* OpName(ExprOp op)
+{
+	switch (op)
+	{
+	case ExprOp::Const: return "const";
+	case ExprOp::Var:   return "var";
+	case ExprOp::Copy:  return "copy";
+	case ExprOp::Neg:   return "neg";
+	case ExprOp::Add:   return "add";
+	case ExprOp::Sub:   return "sub";
+	case ExprOp::Mul:   return "mul";
+	case ExprOp::Div:   return "div";
+	case ExprOp::Min:   return "min";
+	case ExprOp::Max:   return "max";
+	case ExprOp::Step:  return "step";
+	case ExprOp::Sin:   return "sin";
+	case ExprOp::Cos:   return "cos";
+	case ExprOp::Exp:   return "exp";
+	case ExprOp::Log:   return "log";
+	case ExprOp::Sqrt:  return "sqrt";
+	case ExprOp::Abs:   return "abs";
+	case ExprOp::Floor: return "floor";
+	case ExprOp::Fract: return "fract";
+	}
+	return "?";
+}
+
+std::string ExprToGlsl(const ExprProgram& program, const char* functionName)
+{
+	const std::vector<ExprNode>& nodes = program.nodes;
+	std::string out = "float ";
+	out += functionName;
+	out += "(";
+	for (size_t v = 0; v < program.vars.size(); ++v)
+		out += (v ? ", float " : "float ") + program.vars[v];
+	out += ")\n{\n";
+	if (program.root < 0) return out + "\treturn 0.0;\n}\n";
+
+	// Lo que se usa mas de una vez va a una variable local; el resto queda en linea.
+	std::vector<int> uses(nodes.size(), 0);
+	std::vector<char> live(nodes.size(), 0);
+	live[(size_t)program.root] = 1;
+	for (int i = (int)nodes.size() - 1; i >= 0; --i)
+	{
+		const ExprNode& node = nodes[(size_t)i];
+		if (!live[(size_t)i] || node.op == ExprOp::Const || node.op == ExprOp::Var) continue;
+		live[(size_t)node.a] = 1;
+		++uses[(size_t)node.a];
+		if (node.b >= 0)
+		{
+			live[(size_t)node.b] = 1;
+			++uses[(size_t)node.b];
+		}
+	}
+
+	std::vector<std::string> text(nodes.size());
+	int locals = 0;
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		if (!live[i]) continue;
+		const ExprNode& node = nodes[i];
+		if (node.op == ExprOp::Const) { text[i] = FormatConst(node.value); continue; }
+		if (node.op == ExprOp::Var) { text[i] = program.vars[(size_t)node.a]; continue; }
+
+		const std::string& a = text[(size_t)node.a];
+		const std::string& b = node.b >= 0 ? text[(size_t)node.b] : a;
+		std::string e;
+		switch (node.op)
+		{
+		case ExprOp::Neg: e = "(-" + a + ")"; break;
+		case ExprOp::Add: e = "(" + a + " + " + b + ")"; break;
+		case ExprOp::Sub: e = "(" + a + " - " + b + ")"; break;
+		case ExprOp::Mul: e = "(" + a + " * " + b + ")"; break;
+		case ExprOp::Div: e = "(" + a + " / " + b + ")"; break;
+		case ExprOp::Min:
+		case ExprOp::Max:
+		case ExprOp::Step: e = std::string(OpName(node.op)) + "(" + a + ", " + b + ")"; break;
+		default: e = std::string(OpName(node.op)) + "(" + a + ")"; break;
+		}
+
+		if (uses[i] > 1)
+		{
+			const std::string name = "tmp" + std::to_string(locals++);
+			out += "\tfloat " + name + " = " + e + ";\n";
+			text[i] = name;
+		}
+		else
+		{
+			text[i] = e;
+		}
+	}
+	return out + "\treturn " + text[(size_t)program.root] + ";\n}\n";
+}
+
+std::string ExprDisassemble(const ExprProgram& program)
+{
+	const int varCount = (int)program.vars.size();
+	const int constCount = (int)program.constants.size();
+	auto name = [&](int r) -> std::string
+	{
+		if (r < varCount) return program.vars[(size_t)r];
+		if (r < varCount + constCount) return FormatConst(program.constants[(size_t)(r - varCount)]);
+		char buf[16];
+		snprintf(buf, sizeof(buf), "r%d", r - varCount - constCount);
+		return buf;
+	};
+
+	std::string out;
+	char line[160];
+	for (const ExprInstr& in : program.code)
+	{
+		if (IsUnary(in.op) || in.op == ExprOp::Copy)
+			snprintf(line, sizeof(line), "%-6s %s = %s\n", OpName(in.op), name(in.dst).c_str(), name(in.a).c_str());
+		else
+			snprintf(line, sizeof(line), "%-6s %s = %s, %s\n", OpName(in.op), name(in.dst).c_str(), name(in.a).c_str(), name(in.b).c_str());
+		out += line;
+	}
+	return out;
+}
+
+// ---------------------------
+// Evaluacion
+// ---------------------------
+
+const char* ExprPathName(ExprPath path)
+{
+	switch (path)
+	{
+	case ExprPath::Auto:   return "auto";
+	case ExprPath::Tree:   return "tree";
+	case ExprPath::Scalar: return "scalar";
+	case ExprPath::SSE2:   return "sse2";
+	case ExprPath::AVX2:   return "avx2";
+	case ExprPath::AVX512: return "avx512";
+	}
+	return "?";
+}
+
+bool ExprPathAvailable(ExprPath path)
+{
+	switch (path)
+	{
+	case ExprPath::Auto:
+	case ExprPath::Tree:
+	case ExprPath::Scalar: return true;
+	case ExprPath::SSE2:   return GetCpuFeatures().sse2;
+	case ExprPath::AVX2:   return GetCpuFeatures().avx2;
+	case ExprPath::AVX512: return GetCpuFeatures().avx512f;
+	}
+	return false;
+}
+
+ExprPath ExprResolvePath(ExprPath path)
+{
+	if (path == ExprPath::Auto)
+	{
+		if (ExprPathAvailable(ExprPath::AVX512)) return ExprPath::AVX512;
+		if (ExprPathAvailable(ExprPath::AVX2)) return ExprPath::AVX2;
+		if (ExprPathAvailable(ExprPath::SSE2)) return ExprPath::SSE2;
+		return ExprPath::Scalar;
+	}
+	return ExprPathAvailable(path) ? path : ExprPath::Scalar;
+}
+
+float ExprEvaluateTree(const ExprProgram& program, const float* values)
+{
+	return program.treeRoot < 0 ? 0.0f : EvalTree(program.tree, program.treeRoot, values);
+}
+
+void ExprEvaluate(const ExprProgram& program, const ExprInput* inputs, size_t count, float* out, ExprPath path)
+{
+	if (count == 0 || program.root < 0) return;
+	const int varCount = (int)program.vars.size();
+	const int tiles = (int)((count + kExprTile - 1) / kExprTile);
+
+	path = ExprResolvePath(path);
+	if (path == ExprPath::Tree)
+	{
+		ParallelFor(tiles, kExprGrainTiles, [&](int tile0, int tile1)
+		{
+			const size_t end = std::min(count, (size_t)tile1 * kExprTile);
+			float values[kExprMaxVars];
+			for (size_t i = (size_t)tile0 * kExprTile; i < end; ++i)
+			{
+				for (int v = 0; v < varCount; ++v)
+					values[v] = inputs[v].values ? inputs[v].values[i] : inputs[v].scalar;
+				out[i] = EvalTree(program.tree, program.treeRoot, values);
+			}
+		});
+		return;
+	}
+
+	ExprRunTileFn run = ExprRunTileScalar;
+	if (path == ExprPath::SSE2) run = ExprRunTileSSE2;
+	if (path == ExprPath::AVX2) run = ExprRunTileAVX2;
+	if (path == ExprPath::AVX512) run = ExprRunTileAVX512;
+
+	// Filas compartidas (solo lectura): las constantes y las entradas escalares, ya repetidas.
+	const int constCount = (int)program.constants.size();
+	std::vector<float> shared((size_t)(constCount + varCount) * kExprTile);
+	for (int c = 0; c < constCount; ++c)
+		std::fill_n(shared.data() + (size_t)c * kExprTile, kExprTile, program.constants[(size_t)c]);
+	for (int v = 0; v < varCount; ++v)
+		std::fill_n(shared.data() + (size_t)(constCount + v) * kExprTile, kExprTile, inputs[v].scalar);
+
+	const int temps = program.registers - varCount - constCount;
+	ParallelFor(tiles, kExprGrainTiles, [&](int tile0, int tile1)
+	{
+		// Por thread: los temporales y, para el ultimo tile incompleto, copias de las entradas y
+		// de la salida con relleno.
+		thread_local std::vector<float> scratch;
+		thread_local std::vector<float*> regs;
+		scratch.resize((size_t)(temps + varCount + 1) * kExprTile);
+		regs.resize((size_t)program.registers);
+		for (int c = 0; c < constCount; ++c)
+			regs[(size_t)(varCount + c)] = shared.data() + (size_t)c * kExprTile;
+		for (int t = 0; t < temps; ++t)
+			regs[(size_t)(varCount + constCount + t)] = scratch.data() + (size_t)t * kExprTile;
+		float* tailIn = scratch.data() + (size_t)temps * kExprTile;
+		float* tailOut = tailIn + (size_t)varCount * kExprTile;
+
+		for (int tile = tile0; tile < tile1; ++tile)
+		{
+			const size_t base = (size_t)tile * kExprTile;
+			const size_t n = std::min((size_t)kExprTile, count - base);
+			const bool full = n == (size_t)kExprTile;
+			for (int v = 0; v < varCount; ++v)
+			{
+				if (!inputs[v].values)
+				{
+					regs[(size_t)v] = shared.data() + (size_t)(constCount + v) * kExprTile;
+				}
+				else if (full)
+				{
+					regs[(size_t)v] = const_cast<float*>(inputs[v].values + base);   // el VM nunca escribe las entradas
+				}
+				else
+				{
+					float* row = tailIn + (size_t)v * kExprTile;
+					memcpy(row, inputs[v].values + base, n * sizeof(float));
+					std::fill(row + n, row + kExprTile, 0.0f);
+					regs[(size_t)v] = row;
+				}
+			}
+			// El registro del resultado escribe directo en la salida (si otro temporal lo uso antes,
+			// tambien vivio ahi: da igual).
+			regs[(size_t)program.result] = full ? out + base : tailOut;
+			run(program.code.data(), (int)program.code.size(), regs.data());
+			if (!full) memcpy(out + base, tailOut, n * sizeof(float));
+		}
+	});
+}
+
+int ExprFindRoots(const ExprProgram& program, int var, float lo, float hi, int samples, const ExprInput* inputs,
+	float* roots, int maxRoots, ExprPath path)
+{
+	const int varCount = (int)program.vars.size();
+	if (var < 0 || var >= varCount || !(hi > lo)) return 0;
+	if (samples < 2) samples = 2;
+
+	std::vector<ExprInput> in((size_t)varCount);
+	for (int v = 0; v < varCount; ++v)
+		in[(size_t)v].scalar = inputs ? inputs[v].scalar : 0.0f;
+
+	std::vector<float> xs((size_t)samples), fs((size_t)samples);
+	for (int i = 0; i < samples; ++i)
+		xs[(size_t)i] = lo + (hi - lo) * ((float)i / (float)(samples - 1));
+	xs[(size_t)samples - 1] = hi;
+	in[(size_t)var].values = xs.data();
+	ExprEvaluate(program, in.data(), (size_t)samples, fs.data(), path);
+
+	// Intervalos con cambio de signo (los ceros exactos ya son raices).
+	std::vector<float> found, a, b, fa;
+	for (int i = 0; i < samples; ++i)
+	{
+		const float f0 = fs[(size_t)i];
+		if (f0 == 0.0f)
+		{
+			found.push_back(xs[(size_t)i]);
+			continue;
+		}
+		if (i + 1 == samples) break;
+		const float f1 = fs[(size_t)i + 1];
+		if (f1 != 0.0f && !isnan(f0) && !isnan(f1) && (f0 < 0.0f) != (f1 < 0.0f))
+		{
+			a.push_back(xs[(size_t)i]);
+			b.push_back(xs[(size_t)i + 1]);
+			fa.push_back(f0);
+		}
+	}
+
+	// Biseccion de todos los intervalos a la vez: una evaluacion del VM por iteracion. En float
+	// alcanza con ~150 iteraciones para cualquier intervalo; el tope es por las dudas.
+	std::vector<float> mid, fm;
+	for (int iter = 0; iter < 200 && !a.empty(); ++iter)
+	{
+		mid.resize(a.size());
+		fm.resize(a.size());
+		for (size_t k = 0; k < a.size(); ++k)
+			mid[k] = a[k] + (b[k] - a[k]) * 0.5f;
+		in[(size_t)var].values = mid.data();
+		ExprEvaluate(program, in.data(), mid.size(), fm.data(), path);
+
+		size_t keep = 0;
+		for (size_t k = 0; k < a.size(); ++k)
+		{
+			if (fm[k] == 0.0f || mid[k] <= a[k] || mid[k] >= b[k])
+			{
+				found.push_back(mid[k]);
+				continue;
+			}
+			if ((fm[k] < 0.0f) == (fa[k] < 0.0f)) { a[k] = mid[k]; fa[k] = fm[k]; }
+			else b[k] = mid[k];
+			a[keep] = a[k];
+			b[keep] = b[k];
+			fa[keep] = fa[k];
+			++keep;
+		}
+		a.resize(keep);
+		b.resize(keep);
+		fa.resize(keep);
+	}
+	for (size_t k = 0; k < a.size(); ++k)
+		found.push_back(a[k] + (b[k] - a[k]) * 0.5f);
+
+	std::sort(found.begin(), found.end());
+	for (size_t i = 0; i < found.size() && (int)i < maxRoots; ++i)
+		roots[i] = found[i];
+	return (int)found.size();
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// ---------------------------
+// Expresiones matematicas
+// ---------------------------
+
+// Una formula escrita por el usuario ("sin(x*3 + t) * exp(-y*y)") se compila una vez a dos
+// destinos: una funcion GLSL que se pega en el shader de fondo (--expr, expr_field.h) y un
+// bytecode de registros que corre un VM SIMD en CPU, para muestrear la funcion en lotes grandes
+// (buscar raices, graficar, verificar).
+//
+// Sintaxis: numeros, las variables pasadas a ExprCompile, pi, e, + - * / ^ (potencia, asociativa
+// a derecha y mas fuerte que el menos unario: -x^2 = -(x^2)), parentesis y las funciones
+//   sin cos tan exp log sqrt abs floor fract              (1 argumento)
+//   min max pow step                                      (2)
+//   clamp mix smoothstep                                  (3)
+// con la semantica de GLSL. log de x <= 0 satura (simd_math.h) en vez de dar NaN.
+//
+// Compilacion:
+//   1. Parser recursivo -> grafo de nodos con un set chico de operaciones. tan, pow, clamp, mix y
+//      smoothstep se bajan a esas operaciones (pow con exponente entero constante |n| <= 16 queda
+//      en multiplicaciones; si no, exp(b * log(a))).
+//   2. Optimizacion: plegado de constantes (con las mismas operaciones que el VM, asi que da los
+//      mismos bits), simplificaciones exactas (x + 0, x * 1, x / 1, -(-x)) y CSE por hash-consing:
+//      cada subexpresion existe una sola vez ("x*y" repetido se calcula una vez).
+//   3. Bytecode: un nodo = una instruccion de tres registros, en orden topologico. Los registros
+//      temporales se reusan apenas muere su ultimo uso (linear scan), asi que el working set
+//      del VM entra en L1 aunque la formula sea larga.
+//
+// El VM ejecuta instruccion por instruccion sobre un tile de kExprTile puntos: el switch de la
+// operacion se paga una vez cada kExprTile puntos y el loop interno es un kernel SIMD de una
+// operacion. El kernel es un solo template (expr_vm_kernels.h sobre simd_lanes.h) compilado para
+// 1, 4, 8 y 16 lanes (escalar, SSE2, AVX2, AVX-512); sin FMA, todos dan los mismos bits. Los tiles
+// se reparten entre threads (ParallelFor).
+//
+// El arbol sin optimizar tambien se guarda: ExprPath::Tree lo recorre recursivamente punto por
+// punto (el interprete ingenuo), como referencia para la verificacion y el benchmark. Cada nodo se
+// calcula una vez por punto: pow() comparte el operando de x*x y el "arbol" es en realidad un DAG.
+
+enum class ExprPath
+{
+	Auto,
+	Tree,      // interprete recursivo del arbol sin optimizar, un punto a la vez
+	Scalar,
+	SSE2,
+	AVX2,
+	AVX512,
+};
+
+static const int kExprMaxVars = 8;
+static const int kExprTile = 256;         // puntos por instruccion del VM
+static const int kExprGrainTiles = 16;    // tiles por bloque de ParallelFor
+static const int kExprMaxPowExponent = 16;
+
+enum class ExprOp : uint8_t
+{
+	Const,   // solo nodos
+	Var,     // solo nodos
+	Copy,    // solo bytecode (la raiz es una variable o una constante)
+	Neg,
+	Add,
+	Sub,
+	Mul,
+	Div,
+	Min,
+	Max,
+	Step,    // step(a, b) = b < a ? 0 : 1
+	Sin,
+	Cos,
+	Exp,
+	Log,
+	Sqrt,
+	Abs,
+	Floor,
+	Fract,
+};
+
+struct ExprNode
+{
+	ExprOp op = ExprOp::Const;
+	int a = -1;            // operandos (indices de nodos anteriores); Var: indice de la variable
+	int b = -1;
+	float value = 0.0f;    // Const
+};
+
+struct ExprInstr
+{
+	ExprOp op;
+	uint16_t dst;
+	uint16_t a;
+	uint16_t b;
+};
+
+struct ExprStats
+{
+	int parsedNodes = 0;   // nodos del arbol sin optimizar
+	int nodes = 0;         // nodos vivos del grafo optimizado
+	int folded = 0;        // operaciones plegadas a constantes
+	int simplified = 0;    // x + 0, x * 1, ...
+	int cseHits = 0;       // subexpresiones que ya existian
+};
+
+struct ExprProgram
+{
+	std::string source;
+	std::vector<std::string> vars;
+
+	std::vector<ExprNode> tree;    // sin optimizar, orden topologico
+	int treeRoot = -1;
+	std::vector<ExprNode> nodes;   // optimizado (DAG), orden topologico
+	int root = -1;
+
+	// Registros: [0, vars) las entradas, [vars, vars + constants) las constantes, despues los
+	// temporales. El resultado queda en el registro 'result'.
+	std::vector<ExprInstr> code;
+	std::vector<float> constants;
+	int registers = 0;
+	int result = 0;
+
+	ExprStats stats;
+};
+
+// Entrada de una variable: un array de 'count' valores o, si values es null, el mismo valor para
+// todos los puntos.
+struct ExprInput
+{
+	const float* values = nullptr;
+	float scalar = 0.0f;
+};
+
+// Compila 'source' con las variables 'varNames' (a lo sumo kExprMaxVars). Si falla, 'error' dice
+// que y en que columna.
+bool ExprCompile(const char* source, const char* const* varNames, int varCount, ExprProgram* program, std::string* error);
+
+// float name(float v0, float v1, ...) { ... } con los nombres de las variables. Constantes con 9
+// digitos (el float exacto); las subexpresiones compartidas van a variables locales.
+std::string ExprToGlsl(const ExprProgram& program, const char* functionName);
+
+// Listado legible del bytecode, una instruccion por linea.
+std::string ExprDisassemble(const ExprProgram& program);
+
+const char* ExprPathName(ExprPath path);
+bool ExprPathAvailable(ExprPath path);
+ExprPath ExprResolvePath(ExprPath path);   // Auto -> el mas ancho disponible
+
+// out[i] = f(inputs[0][i], inputs[1][i], ...) para i en [0, count). 'inputs' tiene una entrada por
+// variable; 'out' no puede ser uno de los arrays de entrada. En paralelo.
+void ExprEvaluate(const ExprProgram& program, const ExprInput* inputs, size_t count, float* out, ExprPath path = ExprPath::Auto);
+
+// Un punto por el arbol sin optimizar (sin SIMD ni threads). Para probar a mano.
+float ExprEvaluateTree(const ExprProgram& program, const float* values);
+
+// Raices de f en la variable 'var' dentro de [lo, hi], con las otras variables fijas en
+// inputs[v].scalar. Muestrea 'samples' puntos equiespaciados en un lote, y cada cambio de signo
+// se refina por biseccion, todos los intervalos juntos en un lote del VM por iteracion (hasta que
+// el punto medio ya no se puede representar entre los extremos). Una discontinuidad con cambio de
+// signo (1/x en 0) tambien aparece. Devuelve cuantas encontro (guarda hasta maxRoots, en orden).
+int ExprFindRoots(const ExprProgram& program, int var, float lo, float hi, int samples, const ExprInput* inputs,
+	float* roots, int maxRoots, ExprPath path = ExprPath::Auto);
@@ -0,0 +1,100 @@
+#include "expr_field.h"
+#include "expr.h"
+#include "platform.h"
+
+#include <string.h>
+
+static const char* const kFieldVars[] = { "x", "y", "t" };
+static const float kRootRange = 2.0f;   // |x| <= 2 cubre hasta 2:1 de aspecto
+static const int kRootSamples = 4096;
+static const int kMaxReportedRoots = 16;
+
+struct ExprFieldState
+{
+	bool active = false;
+	ExprProgram program;
+	std::string glsl;
+	double compileUs = 0.0;
+	float roots[kMaxReportedRoots] = {};
+	int rootCount = 0;
+	double rootsUs = 0.0;
+};
+
+static ExprFieldState g_expr;
+
+static double UsSince(uint64_t t0)
+{
+	return (double)(PlatformTicks() - t0) * 1e6 / (double)PlatformTickFrequency();
+}
+
+bool ParseExprOptions(int argc, char** argv, ExprOptions* opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--expr") == 0 && i + 1 < argc)
+			opts->source = argv[++i];
+	}
+	if (!opts->source) return true;
+
+	uint64_t t0 = PlatformTicks();
+	std::string error;
+	if (!ExprCompile(opts->source, kFieldVars, 3, &g_expr.program, &error))
+	{
+		PlatformAttachConsole();
+		fprintf(stderr, "--expr \"%s\": %s\n", opts->source, error.c_str());
+		return false;
+	}
+	g_expr.glsl = ExprToGlsl(g_expr.program, "UserExpr");
+	g_expr.compileUs = UsSince(t0);
+
+	t0 = PlatformTicks();
+	ExprInput inputs[3];
+	g_expr.rootCount = ExprFindRoots(g_expr.program, 0, -kRootRange, kRootRange, kRootSamples, inputs,
+		g_expr.roots, kMaxReportedRoots);
+	g_expr.rootsUs = UsSince(t0);
+	g_expr.active = true;
+	return true;
+}
+
+bool ExprFieldActive()
+{
+	return g_expr.active;
+}
+
+std::string ExprShaderDefines()
+{
+	return g_expr.active ? "#define USER_EXPR 1\n" + g_expr.glsl : std::string();
+}
+
+static void WriteJsonString(FILE* f, const char* s)
+{
+	fputc('"', f);
+	for (; *s; ++s)
+	{
+		if (*s == '"' || *s == '\\') fputc('\\', f);
+		fputc(*s, f);
+	}
+	fputc('"', f);
+}
+
+void WriteExprJson(FILE* f)
+{
+	if (!g_expr.active)
+	{
+		fprintf(f, "\"expr\": { \"enabled\": false }");
+		return;
+	}
+
+	const ExprProgram& p = g_expr.program;
+	fprintf(f, "\"expr\": { \"enabled\": true, \"source\": ");
+	WriteJsonString(f, p.source.c_str());
+	fprintf(f, ", \"compile_us\": %.1f, \"nodes_parsed\": %d, \"nodes\": %d, \"folded\": %d, \"cse_hits\": %d",
+		g_expr.compileUs, p.stats.parsedNodes, p.stats.nodes, p.stats.folded, p.stats.cseHits);
+	fprintf(f, ", \"instructions\": %d, \"registers\": %d, \"glsl_bytes\": %d, \"cpu_path\": \"%s\"",
+		(int)p.code.size(), p.registers, (int)g_expr.glsl.size(), ExprPathName(ExprResolvePath(ExprPath::Auto)));
+	fprintf(f, ", \"roots_us\": %.1f, \"root_count\": %d, \"roots_x\": [", g_expr.rootsUs, g_expr.rootCount);
+	const int shown = g_expr.rootCount < kMaxReportedRoots ? g_expr.rootCount : kMaxReportedRoots;
+	for (int i = 0; i < shown; ++i)
+		fprintf(f, "%s%.7g", i ? ", " : " ", (double)g_expr.roots[i]);
+	fprintf(f, "%s] }", shown ? " " : "");
+}
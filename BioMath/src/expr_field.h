@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+
+// ---------------------------
+// Fondo de una expresion
+// ---------------------------
+
+// Con --expr "f(x, y, t)" el fondo deja de ser ruido: la formula se compila (expr.h) a una funcion
+// GLSL UserExpr que fullscreen.glsl usa con USER_EXPR en lugar de fbm(). y va de -1 a 1 de abajo
+// arriba, x tiene la misma escala (segun el aspecto de la ventana) y t es el tiempo en segundos.
+// El valor se mapea a [0, 1] como 0.5 + 0.5 f, y la curva f = 0 se resalta.
+//
+// La misma compilacion da el bytecode del VM de CPU: al arrancar se buscan las raices de f(x, 0, 0)
+// en el ancho visible (ExprFindRoots) y van al reporte junto con el tamanio del programa, como
+// chequeo de que la CPU y el shader ven la misma funcion.
+//
+// La formula es fija por ejecucion; el hot reload del .glsl la conserva.
+
+struct ExprOptions
+{
+	const char* source = nullptr;   // nullptr = apagado
+};
+
+// --expr "formula". Compila enseguida: false (con el error en stderr) si no es valida.
+bool ParseExprOptions(int argc, char** argv, ExprOptions* opts);
+
+bool ExprFieldActive();
+
+// #defines y la funcion UserExpr para fullscreen.glsl ("" si esta apagado).
+std::string ExprShaderDefines();
+
+// "expr": { ... } para los reportes JSON.
+void WriteExprJson(FILE* f);
@@ -0,0 +1,10 @@
+// Kernel AVX2 del VM de expresiones (expr.h). Igual que cpu_renderer_avx2.cpp: unidad de
+// compilacion propia por -mavx2, solo se llama si GetCpuFeatures().avx2. El template es el mismo
+// de los otros caminos (expr_vm_kernels.h), instanciado con 8 lanes.
+
+#include "expr_vm_kernels.h"
+
+void ExprRunTileAVX2(const ExprInstr* code, int count, float* const* regs)
+{
+	expr::RunTile<lanes::F8>(code, count, regs);
+}
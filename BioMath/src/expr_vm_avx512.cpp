@@ -0,0 +1,16 @@
+// Kernel AVX-512 del VM de expresiones (expr.h). Unidad de compilacion propia por -mavx512f, solo
+// se llama si GetCpuFeatures().avx512f. Mismo template que los otros caminos, con 16 lanes: cada
+// instruccion del VM recorre el tile en 16 iteraciones.
+
+// Los headers de AVX-512 de GCC 12 usan _mm512_undefined_*() como fuente de las versiones sin
+// mascara y -Wmaybe-uninitialized los marca en cada uso (falso positivo, corregido en GCC 13).
+#if defined(__GNUC__) && !defined(__clang__)
+	#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include "expr_vm_kernels.h"
+
+void ExprRunTileAVX512(const ExprInstr* code, int count, float* const* regs)
+{
+	expr::RunTile<lanes::F16>(code, count, regs);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+// Kernels del VM de expresiones (expr.h), escritos una vez sobre los tipos de simd_lanes.h. Los
+// incluyen expr.cpp (F1 y F4; F1 tambien para plegar constantes y para el interprete del arbol),
+// expr_vm_avx2.cpp (F8) y expr_vm_avx512.cpp (F16).
+//
+// Apply es la unica definicion de cada operacion: como el plegado de constantes, el arbol y el VM
+// pasan todos por aca, una formula da los mismos bits optimizada o no y en cualquier ancho.
+
+#include "cpu_renderer_internal.h"
+#include "expr.h"
+#include "simd_lanes.h"
+
+namespace expr
+{
+	using namespace lanes;
+
+	// Los unarios ignoran b.
+	template <typename V>
+	static inline V Apply(ExprOp op, V a, V b)
+	{
+		typedef typename V::Scalar S;
+		switch (op)
+		{
+		case ExprOp::Neg:   return V(S(0)) - a;
+		case ExprOp::Add:   return a + b;
+		case ExprOp::Sub:   return a - b;
+		case ExprOp::Mul:   return a * b;
+		case ExprOp::Div:   return a / b;
+		case ExprOp::Min:   return Min(a, b);
+		case ExprOp::Max:   return Max(a, b);
+		case ExprOp::Step:  return Select(b < a, V(S(0)), V(S(1)));
+		case ExprOp::Sin:   return Sin(a);
+		case ExprOp::Cos:   return Sin(a + V(S(1.57079632679489662)));
+		case ExprOp::Exp:   return Exp(a);
+		case ExprOp::Log:   return Log(a);
+		case ExprOp::Sqrt:  return Sqrt(a);
+		case ExprOp::Abs:   return Abs(a);
+		case ExprOp::Floor: return Floor(a);
+		case ExprOp::Fract: return Fract(a);
+		default:            return a;   // Copy
+		}
+	}
+
+	// Una instruccion sobre el tile: con kOp constante el switch de Apply desaparece y queda un
+	// loop de una sola operacion SIMD. dst puede ser a o b (cada lane se lee antes de escribirse).
+	template <typename V, ExprOp kOp>
+	static inline void Run(float* dst, const float* a, const float* b)
+	{
+		for (int i = 0; i < kExprTile; i += V::kWidth)
+			Apply<V>(kOp, V::Load(a + i), V::Load(b + i)).Store(dst + i);
+	}
+
+	template <typename V>
+	static void RunTile(const ExprInstr* code, int count, float* const* regs)
+	{
+		for (int k = 0; k < count; ++k)
+		{
+			const ExprInstr& in = code[k];
+			float* dst = regs[in.dst];
+			const float* a = regs[in.a];
+			const float* b = regs[in.b];
+			switch (in.op)
+			{
+			case ExprOp::Copy:  Run<V, ExprOp::Copy>(dst, a, b); break;
+			case ExprOp::Neg:   Run<V, ExprOp::Neg>(dst, a, b); break;
+			case ExprOp::Add:   Run<V, ExprOp::Add>(dst, a, b); break;
+			case ExprOp::Sub:   Run<V, ExprOp::Sub>(dst, a, b); break;
+			case ExprOp::Mul:   Run<V, ExprOp::Mul>(dst, a, b); break;
+			case ExprOp::Div:   Run<V, ExprOp::Div>(dst, a, b); break;
+			case ExprOp::Min:   Run<V, ExprOp::Min>(dst, a, b); break;
+			case ExprOp::Max:   Run<V, ExprOp::Max>(dst, a, b); break;
+			case ExprOp::Step:  Run<V, ExprOp::Step>(dst, a, b); break;
+			case ExprOp::Sin:   Run<V, ExprOp::Sin>(dst, a, b); break;
+			case ExprOp::Cos:   Run<V, ExprOp::Cos>(dst, a, b); break;
+			case ExprOp::Exp:   Run<V, ExprOp::Exp>(dst, a, b); break;
+			case ExprOp::Log:   Run<V, ExprOp::Log>(dst, a, b); break;
+			case ExprOp::Sqrt:  Run<V, ExprOp::Sqrt>(dst, a, b); break;
+			case ExprOp::Abs:   Run<V, ExprOp::Abs>(dst, a, b); break;
+			case ExprOp::Floor: Run<V, ExprOp::Floor>(dst, a, b); break;
+			case ExprOp::Fract: Run<V, ExprOp::Fract>(dst, a, b); break;
+			default: break;
+			}
+		}
+	}
+}
@@ -0,0 +1,531 @@
+#include "frame_capture.h"
+#include "frame_stats.h"
+#include "gl_api.h"
+#include "gl_state.h"
+#include "image_file.h"
+#include "platform.h"
+#include "profiler.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+enum class CaptureFormat
+{
+	Y4m,
+	Raw,
+	Png,
+};
+
+static const char* CaptureFormatName(CaptureFormat format)
+{
+	switch (format)
+	{
+	case CaptureFormat::Y4m: return "y4m";
+	case CaptureFormat::Raw: return "rgba";
+	case CaptureFormat::Png: return "png";
+	}
+	return "?";
+}
+
+// El estado lo toca solo el thread de render. Un slot Encoding es del writer hasta que vuelve por
+// la lista 'done'.
+enum class CaptureSlotState
+{
+	Free,
+	Reading,    // glReadPixels emitido, esperando el fence
+	Encoding,   // mapeado (o en 'host') y en manos del writer
+};
+
+struct CaptureSlot
+{
+	GLuint pbo = 0;
+	GLsync fence = nullptr;
+	CaptureSlotState state = CaptureSlotState::Free;
+	const uint8_t* data = nullptr;   // lo que lee el writer: el mapeo del PBO o 'host'
+	std::vector<uint8_t> host;       // --capture-sync
+	uint64_t number = 0;             // numero de captura (para el nombre del PNG)
+	uint64_t issueFrame = 0;
+};
+
+struct CaptureState
+{
+	CaptureOptions options;
+	CaptureFormat format = CaptureFormat::Y4m;
+	bool active = false;
+	bool fences = false;
+	int width = 0;                   // del primer frame capturado
+	int height = 0;
+	size_t bytes = 0;
+	std::vector<CaptureSlot> slots;
+	std::deque<int> reading;         // slots Reading en el orden en que se emitieron
+	std::vector<int> reclaim;        // se intercambia con 'done' (sin alocar por frame)
+
+	// Thread de render
+	uint64_t frames = 0;
+	uint64_t issued = 0;
+	uint64_t dropped = 0;
+	uint64_t skippedSize = 0;
+	uint64_t notReady = 0;
+	uint64_t mapFailures = 0;
+	std::vector<double> captureMs;
+	size_t captureCount = 0;
+
+	// Writer. pending/done/handed/finished/stop con el mutex; lo demas lo toca solo el writer (y
+	// se lee despues de CaptureFlush).
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable idle;
+	std::deque<int> pending;
+	std::vector<int> done;
+	uint64_t handed = 0;
+	uint64_t finished = 0;
+	bool stop = false;
+	VideoWriter* video = nullptr;
+	uint64_t written = 0;
+	uint64_t writeFailures = 0;
+	double bytesEncoded = 0.0;
+	std::vector<double> encodeMs;
+	size_t encodeCount = 0;
+};
+
+static CaptureState g_capture;
+
+static bool EndsWith(const char* s, const char* suffix)
+{
+	const size_t n = strlen(s), m = strlen(suffix);
+	return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+// Nombre del PNG numero 'number' segun el patron de --capture: exactamente un %d o %0Nd (N de 1 a
+// 20) y %% para un '%' literal. El patron no pasa nunca por printf. false si el patron no es valido
+// o el nombre no entra en 'size'.
+static bool PngPatternName(const char* pattern, uint64_t number, char* out, size_t size)
+{
+	size_t n = 0;
+	int conversions = 0;
+	for (const char* p = pattern; *p; ++p)
+	{
+		char digits[24];
+		size_t count = 0;
+		if (*p != '%')
+		{
+			digits[count++] = *p;
+		}
+		else if (p[1] == '%')
+		{
+			digits[count++] = '%';
+			++p;
+		}
+		else
+		{
+			int width = 0;
+			if (p[1] == '0')
+			{
+				++p;
+				while (p[1] >= '0' && p[1] <= '9' && width <= 20) width = width * 10 + (*++p - '0');
+				if (width < 1 || width > 20) return false;
+			}
+			if (p[1] != 'd' || ++conversions > 1) return false;
+			++p;
+
+			uint64_t v = number;
+			do
+			{
+				digits[count++] = (char)('0' + v % 10);
+				v /= 10;
+			} while (v);
+			while (count < (size_t)width) digits[count++] = '0';
+			for (size_t i = 0; i < count / 2; ++i)
+			{
+				const char c = digits[i];
+				digits[i] = digits[count - 1 - i];
+				digits[count - 1 - i] = c;
+			}
+		}
+		if (n + count >= size) return false;
+		memcpy(out + n, digits, count);
+		n += count;
+	}
+	out[n] = '\0';
+	return conversions == 1;
+}
+
+bool ParseCaptureOptions(int argc, char** argv, CaptureOptions* opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* a = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (strcmp(a, "--capture") == 0 && hasValue) opts->path = argv[++i];
+		else if (strcmp(a, "--capture-ring") == 0 && hasValue) opts->ring = atoi(argv[++i]);
+		else if (strcmp(a, "--capture-every") == 0 && hasValue) opts->every = atoi(argv[++i]);
+		else if (strcmp(a, "--capture-frames") == 0 && hasValue) opts->maxFrames = atoi(argv[++i]);
+		else if (strcmp(a, "--capture-fps") == 0 && hasValue) opts->fps = atof(argv[++i]);
+		else if (strcmp(a, "--capture-sync") == 0) opts->sync = true;
+	}
+
+	if (opts->ring < 2) opts->ring = 2;
+	if (opts->ring > 16) opts->ring = 16;
+	if (opts->every < 1) opts->every = 1;
+	if (opts->maxFrames < 0) opts->maxFrames = 0;
+	if (opts->fps <= 0.0) opts->fps = 60.0;
+
+	const char* path = opts->path;
+	if (!path) return true;
+	if (EndsWith(path, ".y4m") || EndsWith(path, ".rgba") || EndsWith(path, ".raw")) return true;
+	char name[1024];
+	if (EndsWith(path, ".png") && PngPatternName(path, 0, name, sizeof(name))) return true;
+
+	PlatformAttachConsole();
+	fprintf(stderr, "capture: unknown format for '%s'; use .y4m, .rgba, or a .png pattern with one %%d or %%0Nd (%%%% for a literal '%%') like frames/%%05d.png\n", path);
+	return false;
+}
+
+static double MsSince(uint64_t startTicks)
+{
+	return (double)(PlatformTicks() - startTicks) * 1000.0 / (double)PlatformTickFrequency();
+}
+
+// ---------------------------
+// Writer
+// ---------------------------
+
+static void Encode(CaptureSlot& slot)
+{
+	const uint64_t t0 = PlatformTicks();
+	const int w = g_capture.width, h = g_capture.height;
+
+	// glReadPixels deja las filas de abajo hacia arriba: se escribe desde la ultima con stride negativo.
+	const ptrdiff_t stride = -(ptrdiff_t)w * 4;
+	const uint8_t* top = slot.data + (size_t)(h - 1) * (size_t)w * 4;
+
+	bool ok = false;
+	if (g_capture.format == CaptureFormat::Png)
+	{
+		char name[1024];
+		ok = PngPatternName(g_capture.options.path, slot.number, name, sizeof(name)) && PngWrite(name, top, w, h, stride);
+	}
+	else
+	{
+		if (!g_capture.video && g_capture.written + g_capture.writeFailures == 0)
+		{
+			const VideoFormat format = g_capture.format == CaptureFormat::Y4m ? VideoFormat::Y4m : VideoFormat::Raw;
+			g_capture.video = VideoOpen(g_capture.options.path, format, w, h, g_capture.options.fps);
+			if (!g_capture.video) fprintf(stderr, "capture: cannot write '%s'\n", g_capture.options.path);
+		}
+		ok = VideoWriteFrame(g_capture.video, top, stride);
+	}
+
+	if (ok)
+	{
+		++g_capture.written;
+		g_capture.bytesEncoded += (double)g_capture.bytes;
+	}
+	else
+	{
+		++g_capture.writeFailures;
+	}
+	g_capture.encodeMs[g_capture.encodeCount++ % kCaptureTimingSamples] = MsSince(t0);
+}
+
+static void WriterMain()
+{
+	ProfilerSetThreadName("capture");
+	for (;;)
+	{
+		int index = -1;
+		{
+			std::unique_lock<std::mutex> lock(g_capture.mutex);
+			g_capture.wake.wait(lock, [] { return g_capture.stop || !g_capture.pending.empty(); });
+			if (g_capture.pending.empty()) break; // stop con todo escrito
+			index = g_capture.pending.front();
+			g_capture.pending.pop_front();
+		}
+
+		{
+			PROFILE_ZONE("CaptureEncode");
+			Encode(g_capture.slots[(size_t)index]);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(g_capture.mutex);
+			g_capture.done.push_back(index);
+			++g_capture.finished;
+		}
+		g_capture.idle.notify_all();
+	}
+}
+
+// ---------------------------
+// Render thread
+// ---------------------------
+
+bool CaptureInit(const CaptureOptions& opts)
+{
+	g_capture.options = opts;
+	g_capture.active = false;
+	if (!opts.path) return false;
+
+	if (EndsWith(opts.path, ".y4m")) g_capture.format = CaptureFormat::Y4m;
+	else if (EndsWith(opts.path, ".png")) g_capture.format = CaptureFormat::Png;
+	else g_capture.format = CaptureFormat::Raw;
+
+	if (!opts.sync && (!glMapBufferRange_ptr || !glUnmapBuffer_ptr))
+	{
+		fprintf(stderr, "capture: glMapBufferRange not available, capture disabled\n");
+		return false;
+	}
+	g_capture.fences = glFenceSync_ptr && glClientWaitSync_ptr && glDeleteSync_ptr;
+
+	g_capture.slots = std::vector<CaptureSlot>((size_t)opts.ring);
+	if (!opts.sync)
+		for (CaptureSlot& slot : g_capture.slots)
+			glGenBuffers_ptr(1, &slot.pbo);
+	g_capture.captureMs.assign(kCaptureTimingSamples, 0.0);
+	g_capture.encodeMs.assign(kCaptureTimingSamples, 0.0);
+
+	g_capture.stop = false;
+	g_capture.thread = std::thread(WriterMain);
+	g_capture.active = true;
+	return true;
+}
+
+static void HandToWriter(int index)
+{
+	g_capture.slots[(size_t)index].state = CaptureSlotState::Encoding;
+	{
+		std::lock_guard<std::mutex> lock(g_capture.mutex);
+		g_capture.pending.push_back(index);
+		++g_capture.handed;
+	}
+	g_capture.wake.notify_one();
+}
+
+// Los slots que el writer termino se desmapean y quedan libres.
+static void Reclaim()
+{
+	std::vector<int>& done = g_capture.reclaim;
+	done.clear();
+	{
+		std::lock_guard<std::mutex> lock(g_capture.mutex);
+		done.swap(g_capture.done);
+	}
+	for (int index : done)
+	{
+		CaptureSlot& slot = g_capture.slots[(size_t)index];
+		if (slot.pbo)
+		{
+			GLStateBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+			glUnmapBuffer_ptr(GL_PIXEL_PACK_BUFFER);
+		}
+		slot.data = nullptr;
+		slot.state = CaptureSlotState::Free;
+	}
+	GLStateBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+// true si la copia del slot ya termino. Con 'wait' espera lo que haga falta.
+static bool ReadbackDone(CaptureSlot& slot, bool wait)
+{
+	if (!g_capture.fences)
+		return wait || g_capture.frames - slot.issueFrame >= (uint64_t)g_capture.options.ring - 1;
+
+	GLenum result = glClientWaitSync_ptr(slot.fence, 0, 0);
+	while (wait && result == GL_TIMEOUT_EXPIRED)
+		result = glClientWaitSync_ptr(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	if (result == GL_TIMEOUT_EXPIRED) return false;
+	glDeleteSync_ptr(slot.fence);
+	slot.fence = nullptr;
+	return true;
+}
+
+// Mapea, en orden, los slots cuya copia ya termino y se los pasa al writer.
+static void MapReady(bool wait)
+{
+	while (!g_capture.reading.empty())
+	{
+		const int index = g_capture.reading.front();
+		CaptureSlot& slot = g_capture.slots[(size_t)index];
+		if (!ReadbackDone(slot, wait))
+		{
+			++g_capture.notReady;
+			break;
+		}
+		g_capture.reading.pop_front();
+
+		GLStateBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+		slot.data = (const uint8_t*)glMapBufferRange_ptr(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)g_capture.bytes, GL_MAP_READ_BIT);
+		GLStateBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		if (!slot.data)
+		{
+			++g_capture.mapFailures;
+			slot.state = CaptureSlotState::Free;
+			continue;
+		}
+		HandToWriter(index);
+	}
+}
+
+// El tamanio se fija con el primer frame: ahi se reservan los PBOs (o la memoria de --capture-sync).
+static bool AllocateSlots(int width, int height)
+{
+	g_capture.width = width;
+	g_capture.height = height;
+	g_capture.bytes = (size_t)width * (size_t)height * 4;
+	for (CaptureSlot& slot : g_capture.slots)
+	{
+		if (g_capture.options.sync)
+		{
+			slot.host.assign(g_capture.bytes, 0);
+			continue;
+		}
+		GLStateBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+		glBufferData_ptr(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)g_capture.bytes, nullptr, GL_STREAM_READ);
+	}
+	GLStateBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	const GLenum glError = glGetError();
+	if (glError != GL_NO_ERROR)
+	{
+		fprintf(stderr, "capture: pixel pack buffers (%dx%d) failed (0x%04X), capture disabled\n", width, height, glError);
+		return false;
+	}
+	return true;
+}
+
+static void Issue(int width, int height)
+{
+	if (g_capture.width == 0 && !AllocateSlots(width, height))
+	{
+		g_capture.active = false;
+		return;
+	}
+	if (width != g_capture.width || height != g_capture.height)
+	{
+		++g_capture.skippedSize;
+		return;
+	}
+
+	int index = -1;
+	for (size_t i = 0; i < g_capture.slots.size() && index < 0; ++i)
+		if (g_capture.slots[i].state == CaptureSlotState::Free) index = (int)i;
+	if (index < 0)
+	{
+		++g_capture.dropped; // el writer (o la GPU) no da abasto: no se espera
+		return;
+	}
+
+	CaptureSlot& slot = g_capture.slots[(size_t)index];
+	slot.number = g_capture.issued++;
+	slot.issueFrame = g_capture.frames;
+	if (g_capture.options.sync)
+	{
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, slot.host.data());
+		slot.data = slot.host.data();
+		HandToWriter(index);
+		return;
+	}
+
+	// Con un PBO bindeado el ultimo argumento es un offset: la llamada solo encola la copia.
+	GLStateBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	GLStateBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	if (g_capture.fences) slot.fence = glFenceSync_ptr(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.state = CaptureSlotState::Reading;
+	g_capture.reading.push_back(index);
+}
+
+bool CaptureActive()
+{
+	return g_capture.active;
+}
+
+void CaptureFrame(int width, int height)
+{
+	if (!g_capture.active || width < 1 || height < 1) return;
+
+	PROFILE_ZONE("Capture");
+	const uint64_t t0 = PlatformTicks();
+
+	Reclaim();
+	MapReady(false);
+	const uint64_t frame = g_capture.frames++;
+	const bool limited = g_capture.options.maxFrames > 0 && g_capture.issued >= (uint64_t)g_capture.options.maxFrames;
+	if (frame % (uint64_t)g_capture.options.every == 0 && !limited)
+		Issue(width, height);
+
+	g_capture.captureMs[g_capture.captureCount++ % kCaptureTimingSamples] = MsSince(t0);
+}
+
+void CaptureFlush()
+{
+	if (!g_capture.thread.joinable()) return;
+
+	PROFILE_ZONE("CaptureFlush");
+	MapReady(true);
+	{
+		std::unique_lock<std::mutex> lock(g_capture.mutex);
+		g_capture.idle.wait(lock, [] { return g_capture.finished == g_capture.handed; });
+	}
+	Reclaim();
+}
+
+void CaptureShutdown()
+{
+	if (g_capture.thread.joinable())
+	{
+		CaptureFlush();
+		{
+			std::lock_guard<std::mutex> lock(g_capture.mutex);
+			g_capture.stop = true;
+		}
+		g_capture.wake.notify_one();
+		g_capture.thread.join();
+	}
+	if (g_capture.video && !VideoClose(g_capture.video))
+	{
+		fprintf(stderr, "capture: error writing '%s'\n", g_capture.options.path);
+		++g_capture.writeFailures;
+	}
+	g_capture.video = nullptr;
+
+	for (CaptureSlot& slot : g_capture.slots)
+	{
+		if (slot.fence) glDeleteSync_ptr(slot.fence);
+		GLStateDeleteBuffer(slot.pbo);
+		slot = CaptureSlot();
+	}
+	g_capture.reading.clear();
+	g_capture.active = false;
+}
+
+void WriteCaptureJson(FILE* f)
+{
+	if (!g_capture.options.path || g_capture.slots.empty())
+	{
+		fprintf(f, "\"capture\": { \"enabled\": false }");
+		return;
+	}
+
+	fprintf(f, "\"capture\": { \"enabled\": true, \"format\": \"%s\", \"readback\": \"%s\", \"ring\": %d, \"size\": [%d, %d]",
+		CaptureFormatName(g_capture.format), g_capture.options.sync ? "sync" : "pbo", g_capture.options.ring, g_capture.width, g_capture.height);
+	fprintf(f, ", \"frames\": %llu, \"captured\": %llu, \"written\": %llu, \"dropped\": %llu, \"skipped_size\": %llu",
+		(unsigned long long)g_capture.frames, (unsigned long long)g_capture.issued, (unsigned long long)g_capture.written,
+		(unsigned long long)g_capture.dropped, (unsigned long long)g_capture.skippedSize);
+	fprintf(f, ", \"not_ready_polls\": %llu, \"map_failures\": %llu, \"write_failures\": %llu, \"mb_encoded\": %.1f, ",
+		(unsigned long long)g_capture.notReady, (unsigned long long)g_capture.mapFailures, (unsigned long long)g_capture.writeFailures,
+		g_capture.bytesEncoded / (1024.0 * 1024.0));
+	const size_t captures = g_capture.captureCount < kCaptureTimingSamples ? g_capture.captureCount : kCaptureTimingSamples;
+	const size_t encodes = g_capture.encodeCount < kCaptureTimingSamples ? g_capture.encodeCount : kCaptureTimingSamples;
+	WriteTimingSummaryJson(f, "frame_ms", SummarizeTimings(g_capture.captureMs.data(), captures));
+	fprintf(f, ", ");
+	WriteTimingSummaryJson(f, "encode_ms", SummarizeTimings(g_capture.encodeMs.data(), encodes));
+	fprintf(f, " }");
+}
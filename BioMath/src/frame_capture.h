@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdio.h>
+
+// ---------------------------
+// Captura de frames
+// ---------------------------
+
+// Con --capture path cada frame dibujado (o uno cada --capture-every) se graba a disco, para
+// comparar el render entre versiones o armar demos. El formato sale de la extension
+// (image_file.h):
+//   frames.y4m             video Y4M 4:2:0
+//   frames.rgba            RGBA crudo, un frame detras de otro
+//   dir/frame_%05d.png     un PNG por frame (el patron recibe el numero de frame capturado:
+//                          un solo %d o %0Nd, y %% para un '%' literal)
+//
+// El render nunca espera a la lectura. Al final del frame, glReadPixels escribe en un pixel pack
+// buffer (PBO) de un anillo de --capture-ring (default 3): la copia la hace la GPU cuando llega, y
+// la llamada vuelve enseguida. Un fence marca cuando termino. En los frames siguientes, el PBO
+// cuyo fence ya paso se mapea y el puntero se le pasa al thread writer, que convierte y escribe
+// el archivo directo desde el mapeo (sin copia en el thread de render); cuando termina, el
+// render desmapea el PBO y queda libre. Si no hay PBO libre (el writer o la GPU van atrasados)
+// ese frame no se captura y se cuenta como descartado: la captura nunca frena el loop.
+//
+// --capture-sync lee con glReadPixels a memoria propia (espera a la GPU en el acto), para medir
+// contra el camino asincronico. --capture-frames N corta despues de N capturas; --capture-fps da
+// el frame rate del header Y4M (default 60).
+//
+// Funciona igual en la ventana (antes del swap) y en headless (dentro del tiempo medido del frame).
+
+struct CaptureOptions
+{
+	const char* path = nullptr;   // nullptr = apagada
+	int ring = 3;
+	int every = 1;
+	int maxFrames = 0;            // 0 = sin limite
+	double fps = 60.0;
+	bool sync = false;
+};
+
+static const size_t kCaptureTimingSamples = 1 << 16;
+
+// --capture path, --capture-ring N, --capture-every N, --capture-frames N, --capture-fps x,
+// --capture-sync. false si el path no tiene un formato conocido.
+bool ParseCaptureOptions(int argc, char** argv, CaptureOptions* opts);
+
+// Requiere contexto GL: crea los PBOs y arranca el writer. Si falta algo (PBOs, glMapBufferRange)
+// queda apagada y el motivo va a stderr. El archivo se abre con el primer frame (ahi se conoce el
+// tamanio; los frames de otro tamanio se saltean).
+bool CaptureInit(const CaptureOptions& opts);
+void CaptureShutdown();
+bool CaptureActive();
+
+// Despues de dibujar el frame, con el framebuffer de salida bindeado para lectura.
+void CaptureFrame(int width, int height);
+
+// Espera las lecturas en vuelo y a que el writer escriba todo lo pendiente. Antes de los reportes.
+void CaptureFlush();
+
+// "capture": { ... } para los reportes JSON. Despues de CaptureFlush.
+void WriteCaptureJson(FILE* f);
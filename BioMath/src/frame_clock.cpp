@@ -0,0 +1,32 @@
+#include "frame_clock.h"
+#include "platform.h"
+
+void FrameClockStart(FrameClock* clock)
+{
+	clock->frequency = PlatformTickFrequency();
+	clock->startTicks = PlatformTicks();
+}
+
+uint64_t FrameClockElapsedTicks(const FrameClock& clock)
+{
+	return PlatformTicks() - clock.startTicks;
+}
+
+double TicksToSeconds(uint64_t ticks, uint64_t frequency)
+{
+	// Parte entera y resto por separado: (double)ticks / freq perderia bits con uptimes enormes.
+	const uint64_t whole = ticks / frequency;
+	const uint64_t rest = ticks % frequency;
+	return (double)whole + (double)rest / (double)frequency;
+}
+
+uint64_t SecondsToTicks(double seconds, uint64_t frequency)
+{
+	if (seconds <= 0.0) return 0;
+	return (uint64_t)(seconds * (double)frequency + 0.5);
+}
+
+double FrameClockSeconds(const FrameClock& clock)
+{
+	return TicksToSeconds(FrameClockElapsedTicks(clock), clock.frequency);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+// ---------------------------
+// Reloj de la app
+// ---------------------------
+
+// La base de tiempo son ticks enteros del reloj de plataforma (PlatformTicks) contados desde el
+// arranque: las restas son unsigned, asi que siguen bien aunque el contador de 64 bits de la vuelta.
+// Los segundos se derivan en double a partir de los ticks, nunca se acumulan sumando dt: no hay
+// error que crezca con las horas de uptime.
+
+struct FrameClock
+{
+	uint64_t startTicks = 0;
+	uint64_t frequency = 1;
+};
+
+void FrameClockStart(FrameClock* clock);
+
+// Ticks desde FrameClockStart.
+uint64_t FrameClockElapsedTicks(const FrameClock& clock);
+
+// Segundos desde FrameClockStart. Exacto en la parte entera (division entera de ticks). Los
+// uniforms del shader (float) salen de aca con BackgroundTimeAt (cpu_renderer.h).
+double FrameClockSeconds(const FrameClock& clock);
+
+double TicksToSeconds(uint64_t ticks, uint64_t frequency);
+uint64_t SecondsToTicks(double seconds, uint64_t frequency);
@@ -0,0 +1,131 @@
+#include "frame_pacer.h"
+#include "frame_clock.h"
+#include "frame_stats.h"
+#include "platform.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+	#define PACER_CPU_RELAX() _mm_pause()
+#else
+	#define PACER_CPU_RELAX() std::this_thread::yield()
+#endif
+
+static const size_t kErrorRing = 1 << 16; // ~18 minutos a 60 Hz
+
+// Margen de spin: arranca en 1 ms y se ajusta al peor overshoot reciente de los sleeps.
+static const double kSpinMarginInitialMs = 1.0;
+static const double kSpinMarginMinMs = 0.1;
+static const double kSpinMarginMaxMs = 4.0;
+
+void ParseFramePacerOptions(int argc, char** argv, FramePacerOptions* opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* a = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (strcmp(a, "--fps") == 0 && hasValue) opts->targetHz = atof(argv[++i]);
+		else if (strcmp(a, "--vsync") == 0 && hasValue) opts->swapInterval = atoi(argv[++i]);
+		else if (strcmp(a, "--pacing-json") == 0 && hasValue) opts->jsonPath = argv[++i];
+	}
+
+	if (opts->targetHz < 0.0) opts->targetHz = 0.0;
+}
+
+void FramePacerInit(FramePacer* pacer, const FramePacerOptions& opts)
+{
+	pacer->options = opts;
+	pacer->frequency = PlatformTickFrequency();
+	pacer->periodTicks = opts.targetHz > 0.0 ? SecondsToTicks(1.0 / opts.targetHz, pacer->frequency) : 0;
+	pacer->spinMarginTicks = SecondsToTicks(kSpinMarginInitialMs * 1e-3, pacer->frequency);
+	pacer->nextDeadline = PlatformTicks() + pacer->periodTicks;
+	pacer->frames = 0;
+	pacer->missedFrames = 0;
+	pacer->errorsMs.assign(kErrorRing, 0.0);
+	pacer->errorCount = 0;
+}
+
+static void AdaptSpinMargin(FramePacer* pacer, uint64_t overshootTicks)
+{
+	const uint64_t minTicks = SecondsToTicks(kSpinMarginMinMs * 1e-3, pacer->frequency);
+	const uint64_t maxTicks = SecondsToTicks(kSpinMarginMaxMs * 1e-3, pacer->frequency);
+
+	// Sube enseguida si el sleep se paso (con 50% de holgura), baja despacio si sobra margen:
+	// un spin de mas cuesta CPU, uno de menos cuesta un frame tarde.
+	uint64_t margin = pacer->spinMarginTicks;
+	const uint64_t wanted = overshootTicks + overshootTicks / 2;
+	if (wanted > margin) margin = wanted;
+	else margin -= (margin - wanted) / 64;
+
+	if (margin < minTicks) margin = minTicks;
+	if (margin > maxTicks) margin = maxTicks;
+	pacer->spinMarginTicks = margin;
+}
+
+void FramePacerWait(FramePacer* pacer)
+{
+	++pacer->frames;
+	if (pacer->periodTicks == 0) return;
+
+	const uint64_t deadline = pacer->nextDeadline;
+	uint64_t now = PlatformTicks();
+
+	// Resta unsigned: "now esta antes del deadline" sin problemas de wrap.
+	if ((int64_t)(deadline - now) > (int64_t)pacer->spinMarginTicks)
+	{
+		const uint64_t sleepUntil = deadline - pacer->spinMarginTicks;
+		PlatformSleepUntil(sleepUntil);
+		now = PlatformTicks();
+		AdaptSpinMargin(pacer, (int64_t)(now - sleepUntil) > 0 ? now - sleepUntil : 0);
+	}
+
+	while ((int64_t)(deadline - now) > 0)
+	{
+		PACER_CPU_RELAX();
+		now = PlatformTicks();
+	}
+
+	const int64_t lateTicks = (int64_t)(now - deadline);
+	const double errorMs = (double)lateTicks * 1e3 / (double)pacer->frequency;
+	pacer->errorsMs[pacer->errorCount % kErrorRing] = errorMs;
+	++pacer->errorCount;
+
+	// Proximo deadline: un periodo exacto despues del anterior. Si ya vamos mas de un periodo
+	// tarde (hitch, ventana arrastrada, breakpoint) se resincroniza en vez de correr para alcanzarlo.
+	if ((uint64_t)lateTicks >= pacer->periodTicks)
+	{
+		++pacer->missedFrames;
+		pacer->nextDeadline = now + pacer->periodTicks;
+	}
+	else
+	{
+		pacer->nextDeadline = deadline + pacer->periodTicks;
+	}
+}
+
+double FramePacerWithinTolerance(const FramePacer& pacer, double toleranceMs)
+{
+	const size_t count = pacer.errorCount < kErrorRing ? pacer.errorCount : kErrorRing;
+	if (count == 0) return 100.0;
+
+	size_t within = 0;
+	for (size_t i = 0; i < count; ++i)
+		if (fabs(pacer.errorsMs[i]) <= toleranceMs) ++within;
+	return 100.0 * (double)within / (double)count;
+}
+
+void WriteFramePacerJson(FILE* f, const FramePacer& pacer)
+{
+	const size_t count = pacer.errorCount < kErrorRing ? pacer.errorCount : kErrorRing;
+
+	fprintf(f, "\"pacing\": { \"target_hz\": %.3f, \"swap_interval\": %d, \"frames\": %llu, \"missed\": %llu, ",
+		pacer.options.targetHz, pacer.options.swapInterval,
+		(unsigned long long)pacer.frames, (unsigned long long)pacer.missedFrames);
+	WriteTimingSummaryJson(f, "error_ms", SummarizeTimings(pacer.errorsMs.data(), count));
+	fprintf(f, ", \"within_0_25ms_pct\": %.3f }", FramePacerWithinTolerance(pacer, 0.25));
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// ---------------------------
+// Frame pacing
+// ---------------------------
+
+// Programa el inicio de cada frame a una tasa fija (o sin limite). La espera es hibrida:
+// sleep de alta resolucion (PlatformSleepUntil) hasta un margen antes del deadline y spin el
+// resto. El margen se adapta al overshoot que se mide en los sleeps.
+//
+// Los deadlines avanzan de a un periodo exacto desde el anterior (no desde "ahora"), asi el
+// error de un frame no se arrastra al siguiente. Si se pierde mas de un frame se resincroniza.
+//
+// Por frame se guarda el error de scheduling (despertar real - deadline) para poder verificar
+// que el pacing queda dentro de +-0.25 ms.
+//
+// Opciones: --fps N (0 = sin limite) --vsync N (swap interval) --pacing-json path
+
+struct FramePacerOptions
+{
+	double targetHz = 0.0;        // 0 = sin limite (solo vsync, si esta activo)
+	int swapInterval = 1;         // 0 = sin vsync, 1 = cada vblank, -1 = adaptive (si el driver lo soporta)
+	const char* jsonPath = nullptr;
+};
+
+void ParseFramePacerOptions(int argc, char** argv, FramePacerOptions* opts);
+
+struct FramePacer
+{
+	FramePacerOptions options;
+
+	uint64_t frequency = 1;
+	uint64_t periodTicks = 0;     // 0 = sin limite
+	uint64_t nextDeadline = 0;    // en ticks de PlatformTicks
+	uint64_t spinMarginTicks = 0; // cuanto antes del deadline se deja de dormir y se hace spin
+	uint64_t frames = 0;
+	uint64_t missedFrames = 0;    // frames que llegaron mas de un periodo tarde (resync)
+
+	// Ultimos errores de scheduling en ms (ring). Se reserva al iniciar: nada aloca por frame.
+	std::vector<double> errorsMs;
+	size_t errorCount = 0;
+};
+
+void FramePacerInit(FramePacer* pacer, const FramePacerOptions& opts);
+
+// Bloquea hasta el inicio del proximo frame. Sin limite vuelve enseguida.
+void FramePacerWait(FramePacer* pacer);
+
+// Porcentaje de frames con |error| <= toleranceMs.
+double FramePacerWithinTolerance(const FramePacer& pacer, double toleranceMs);
+
+// Escribe "pacing": { target_hz, swap_interval, frames, missed, error_ms: {...}, within_0_25ms_pct }.
+void WriteFramePacerJson(FILE* f, const FramePacer& pacer);
@@ -0,0 +1,41 @@
+#include "frame_stats.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+	// Nearest-rank: el menor valor que deja al menos p% de las muestras por debajo o igual.
+	size_t rank = (size_t)ceil(p / 100.0 * (double)sorted.size());
+	if (rank < 1) rank = 1;
+	if (rank > sorted.size()) rank = sorted.size();
+	return sorted[rank - 1];
+}
+
+TimingSummary SummarizeTimings(const double* samples, size_t count)
+{
+	TimingSummary s;
+	if (!samples || count == 0) return s;
+
+	std::vector<double> sorted(samples, samples + count);
+	std::sort(sorted.begin(), sorted.end());
+
+	double sum = 0.0;
+	for (double v : sorted) sum += v;
+
+	s.count = count;
+	s.mean = sum / (double)count;
+	s.min = sorted.front();
+	s.p50 = Percentile(sorted, 50.0);
+	s.p95 = Percentile(sorted, 95.0);
+	s.p99 = Percentile(sorted, 99.0);
+	s.max = sorted.back();
+	return s;
+}
+
+void WriteTimingSummaryJson(FILE* f, const char* name, const TimingSummary& s)
+{
+	fprintf(f, "\"%s\": { \"count\": %zu, \"mean\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f }",
+		name, s.count, s.mean, s.min, s.p50, s.p95, s.p99, s.max);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdio.h>
+
+// ---------------------------
+// Estadisticas de tiempos
+// ---------------------------
+
+// Resumen de una serie de muestras (en la unidad que se le pase, normalmente ms).
+struct TimingSummary
+{
+	size_t count = 0;
+	double mean = 0.0;
+	double min = 0.0;
+	double p50 = 0.0;
+	double p95 = 0.0;
+	double p99 = 0.0;
+	double max = 0.0;
+};
+
+// Ordena una copia de las muestras y calcula percentiles (nearest-rank).
+TimingSummary SummarizeTimings(const double* samples, size_t count);
+
+// Escribe el resumen como objeto JSON: "name": { "mean": .., "p50": .., ... }
+void WriteTimingSummaryJson(FILE* f, const char* name, const TimingSummary& s);
@@ -0,0 +1,185 @@
+#include "gl_api.h"
+#include "platform.h"
+#include "profiler.h"
+
+#include <string.h>
+
+PFNGLCREATESHADERPROC glCreateShader_ptr = nullptr;
+PFNGLSHADERSOURCEPROC glShaderSource_ptr = nullptr;
+PFNGLCOMPILESHADERPROC glCompileShader_ptr = nullptr;
+PFNGLGETSHADERIVPROC glGetShaderiv_ptr = nullptr;
+PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog_ptr = nullptr;
+PFNGLDELETESHADERPROC glDeleteShader_ptr = nullptr;
+
+PFNGLCREATEPROGRAMPROC glCreateProgram_ptr = nullptr;
+PFNGLATTACHSHADERPROC glAttachShader_ptr = nullptr;
+PFNGLLINKPROGRAMPROC glLinkProgram_ptr = nullptr;
+PFNGLGETPROGRAMIVPROC glGetProgramiv_ptr = nullptr;
+PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog_ptr = nullptr;
+PFNGLUSEPROGRAMPROC glUseProgram_ptr = nullptr;
+PFNGLDELETEPROGRAMPROC glDeleteProgram_ptr = nullptr;
+PFNGLGETPROGRAMBINARYPROC glGetProgramBinary_ptr = nullptr;
+PFNGLPROGRAMBINARYPROC glProgramBinary_ptr = nullptr;
+PFNGLPROGRAMPARAMETERIPROC glProgramParameteri_ptr = nullptr;
+
+PFNGLGENVERTEXARRAYSPROC glGenVertexArrays_ptr = nullptr;
+PFNGLBINDVERTEXARRAYPROC glBindVertexArray_ptr = nullptr;
+PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays_ptr = nullptr;
+
+PFNGLGENBUFFERSPROC glGenBuffers_ptr = nullptr;
+PFNGLBINDBUFFERPROC glBindBuffer_ptr = nullptr;
+PFNGLBUFFERDATAPROC glBufferData_ptr = nullptr;
+PFNGLDELETEBUFFERSPROC glDeleteBuffers_ptr = nullptr;
+PFNGLMAPBUFFERRANGEPROC glMapBufferRange_ptr = nullptr;
+PFNGLUNMAPBUFFERPROC glUnmapBuffer_ptr = nullptr;
+PFNGLBUFFERSTORAGEPROC glBufferStorage_ptr = nullptr;
+
+PFNGLFENCESYNCPROC glFenceSync_ptr = nullptr;
+PFNGLCLIENTWAITSYNCPROC glClientWaitSync_ptr = nullptr;
+PFNGLDELETESYNCPROC glDeleteSync_ptr = nullptr;
+
+PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray_ptr = nullptr;
+PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer_ptr = nullptr;
+PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor_ptr = nullptr;
+
+PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced_ptr = nullptr;
+
+PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation_ptr = nullptr;
+PFNGLUNIFORM1FPROC glUniform1f_ptr = nullptr;
+PFNGLUNIFORM2FPROC glUniform2f_ptr = nullptr;
+
+PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers_ptr = nullptr;
+PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer_ptr = nullptr;
+PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers_ptr = nullptr;
+PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus_ptr = nullptr;
+PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer_ptr = nullptr;
+PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers_ptr = nullptr;
+PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer_ptr = nullptr;
+PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage_ptr = nullptr;
+PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D_ptr = nullptr;
+PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffers_ptr = nullptr;
+
+PFNGLGENQUERIESPROC glGenQueries_ptr = nullptr;
+PFNGLDELETEQUERIESPROC glDeleteQueries_ptr = nullptr;
+PFNGLBEGINQUERYPROC glBeginQuery_ptr = nullptr;
+PFNGLENDQUERYPROC glEndQuery_ptr = nullptr;
+PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv_ptr = nullptr;
+PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v_ptr = nullptr;
+PFNGLQUERYCOUNTERPROC glQueryCounter_ptr = nullptr;
+PFNGLGETINTEGER64VPROC glGetInteger64v_ptr = nullptr;
+
+PFNGLACTIVETEXTUREPROC glActiveTexture_ptr = nullptr;
+PFNGLTEXIMAGE3DPROC glTexImage3D_ptr = nullptr;
+
+PFNGLGETSTRINGIPROC glGetStringi_ptr = nullptr;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR_ptr = nullptr;
+
+
+// Este helper hace exactamente lo que hara GLAD/GLEW, pero a mano y solo con lo que el programa necesita.
+bool LoadGLFunctions() 
+{
+	PROFILE_ZONE("LoadGLFunctions");
+
+	glCreateShader_ptr = (PFNGLCREATESHADERPROC)PlatformGetGLProc("glCreateShader");
+	glShaderSource_ptr = (PFNGLSHADERSOURCEPROC)PlatformGetGLProc("glShaderSource");
+	glCompileShader_ptr = (PFNGLCOMPILESHADERPROC)PlatformGetGLProc("glCompileShader");
+	glGetShaderiv_ptr = (PFNGLGETSHADERIVPROC)PlatformGetGLProc("glGetShaderiv");
+	glGetShaderInfoLog_ptr = (PFNGLGETSHADERINFOLOGPROC)PlatformGetGLProc("glGetShaderInfoLog");
+	glDeleteShader_ptr = (PFNGLDELETESHADERPROC)PlatformGetGLProc("glDeleteShader");
+
+	glCreateProgram_ptr = (PFNGLCREATEPROGRAMPROC)PlatformGetGLProc("glCreateProgram");
+	glAttachShader_ptr = (PFNGLATTACHSHADERPROC)PlatformGetGLProc("glAttachShader");
+	glLinkProgram_ptr = (PFNGLLINKPROGRAMPROC)PlatformGetGLProc("glLinkProgram");
+	glGetProgramiv_ptr = (PFNGLGETPROGRAMIVPROC)PlatformGetGLProc("glGetProgramiv");
+	glGetProgramInfoLog_ptr = (PFNGLGETPROGRAMINFOLOGPROC)PlatformGetGLProc("glGetProgramInfoLog");
+	glUseProgram_ptr = (PFNGLUSEPROGRAMPROC)PlatformGetGLProc("glUseProgram");
+	glDeleteProgram_ptr = (PFNGLDELETEPROGRAMPROC)PlatformGetGLProc("glDeleteProgram");
+	glGetProgramBinary_ptr = (PFNGLGETPROGRAMBINARYPROC)PlatformGetGLProc("glGetProgramBinary");
+	glProgramBinary_ptr = (PFNGLPROGRAMBINARYPROC)PlatformGetGLProc("glProgramBinary");
+	glProgramParameteri_ptr = (PFNGLPROGRAMPARAMETERIPROC)PlatformGetGLProc("glProgramParameteri");
+
+	glGenVertexArrays_ptr = (PFNGLGENVERTEXARRAYSPROC)PlatformGetGLProc("glGenVertexArrays");
+	glBindVertexArray_ptr = (PFNGLBINDVERTEXARRAYPROC)PlatformGetGLProc("glBindVertexArray");
+	glDeleteVertexArrays_ptr = (PFNGLDELETEVERTEXARRAYSPROC)PlatformGetGLProc("glDeleteVertexArrays");
+
+	glGenBuffers_ptr = (PFNGLGENBUFFERSPROC)PlatformGetGLProc("glGenBuffers");
+	glBindBuffer_ptr = (PFNGLBINDBUFFERPROC)PlatformGetGLProc("glBindBuffer");
+	glBufferData_ptr = (PFNGLBUFFERDATAPROC)PlatformGetGLProc("glBufferData");
+	glDeleteBuffers_ptr = (PFNGLDELETEBUFFERSPROC)PlatformGetGLProc("glDeleteBuffers");
+	glMapBufferRange_ptr = (PFNGLMAPBUFFERRANGEPROC)PlatformGetGLProc("glMapBufferRange");
+	glUnmapBuffer_ptr = (PFNGLUNMAPBUFFERPROC)PlatformGetGLProc("glUnmapBuffer");
+	glBufferStorage_ptr = (PFNGLBUFFERSTORAGEPROC)PlatformGetGLProc("glBufferStorage");
+
+	glFenceSync_ptr = (PFNGLFENCESYNCPROC)PlatformGetGLProc("glFenceSync");
+	glClientWaitSync_ptr = (PFNGLCLIENTWAITSYNCPROC)PlatformGetGLProc("glClientWaitSync");
+	glDeleteSync_ptr = (PFNGLDELETESYNCPROC)PlatformGetGLProc("glDeleteSync");
+
+	glEnableVertexAttribArray_ptr = (PFNGLENABLEVERTEXATTRIBARRAYPROC)PlatformGetGLProc("glEnableVertexAttribArray");
+	glVertexAttribPointer_ptr = (PFNGLVERTEXATTRIBPOINTERPROC)PlatformGetGLProc("glVertexAttribPointer");
+	glVertexAttribDivisor_ptr = (PFNGLVERTEXATTRIBDIVISORPROC)PlatformGetGLProc("glVertexAttribDivisor");
+
+	glDrawArraysInstanced_ptr = (PFNGLDRAWARRAYSINSTANCEDPROC)PlatformGetGLProc("glDrawArraysInstanced");
+
+	glGetUniformLocation_ptr = (PFNGLGETUNIFORMLOCATIONPROC)PlatformGetGLProc("glGetUniformLocation");
+	glUniform1f_ptr = (PFNGLUNIFORM1FPROC)PlatformGetGLProc("glUniform1f");
+	glUniform2f_ptr = (PFNGLUNIFORM2FPROC)PlatformGetGLProc("glUniform2f");
+
+	glGenFramebuffers_ptr = (PFNGLGENFRAMEBUFFERSPROC)PlatformGetGLProc("glGenFramebuffers");
+	glBindFramebuffer_ptr = (PFNGLBINDFRAMEBUFFERPROC)PlatformGetGLProc("glBindFramebuffer");
+	glDeleteFramebuffers_ptr = (PFNGLDELETEFRAMEBUFFERSPROC)PlatformGetGLProc("glDeleteFramebuffers");
+	glCheckFramebufferStatus_ptr = (PFNGLCHECKFRAMEBUFFERSTATUSPROC)PlatformGetGLProc("glCheckFramebufferStatus");
+	glFramebufferRenderbuffer_ptr = (PFNGLFRAMEBUFFERRENDERBUFFERPROC)PlatformGetGLProc("glFramebufferRenderbuffer");
+	glGenRenderbuffers_ptr = (PFNGLGENRENDERBUFFERSPROC)PlatformGetGLProc("glGenRenderbuffers");
+	glBindRenderbuffer_ptr = (PFNGLBINDRENDERBUFFERPROC)PlatformGetGLProc("glBindRenderbuffer");
+	glRenderbufferStorage_ptr = (PFNGLRENDERBUFFERSTORAGEPROC)PlatformGetGLProc("glRenderbufferStorage");
+	glFramebufferTexture2D_ptr = (PFNGLFRAMEBUFFERTEXTURE2DPROC)PlatformGetGLProc("glFramebufferTexture2D");
+	glDeleteRenderbuffers_ptr = (PFNGLDELETERENDERBUFFERSPROC)PlatformGetGLProc("glDeleteRenderbuffers");
+
+	glGenQueries_ptr = (PFNGLGENQUERIESPROC)PlatformGetGLProc("glGenQueries");
+	glDeleteQueries_ptr = (PFNGLDELETEQUERIESPROC)PlatformGetGLProc("glDeleteQueries");
+	glBeginQuery_ptr = (PFNGLBEGINQUERYPROC)PlatformGetGLProc("glBeginQuery");
+	glEndQuery_ptr = (PFNGLENDQUERYPROC)PlatformGetGLProc("glEndQuery");
+	glGetQueryObjectiv_ptr = (PFNGLGETQUERYOBJECTIVPROC)PlatformGetGLProc("glGetQueryObjectiv");
+	glGetQueryObjectui64v_ptr = (PFNGLGETQUERYOBJECTUI64VPROC)PlatformGetGLProc("glGetQueryObjectui64v");
+	glQueryCounter_ptr = (PFNGLQUERYCOUNTERPROC)PlatformGetGLProc("glQueryCounter");
+	glGetInteger64v_ptr = (PFNGLGETINTEGER64VPROC)PlatformGetGLProc("glGetInteger64v");
+
+	glActiveTexture_ptr = (PFNGLACTIVETEXTUREPROC)PlatformGetGLProc("glActiveTexture");
+	glTexImage3D_ptr = (PFNGLTEXIMAGE3DPROC)PlatformGetGLProc("glTexImage3D");
+
+	glGetStringi_ptr = (PFNGLGETSTRINGIPROC)PlatformGetGLProc("glGetStringi");
+	glMaxShaderCompilerThreadsKHR_ptr = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)PlatformGetGLProc("glMaxShaderCompilerThreadsKHR");
+	if (!glMaxShaderCompilerThreadsKHR_ptr) // misma funcion, nombre de la version ARB
+		glMaxShaderCompilerThreadsKHR_ptr = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)PlatformGetGLProc("glMaxShaderCompilerThreadsARB");
+
+	// Minimal sanity check: shaders + VAO required for our path
+	return glCreateShader_ptr && glShaderSource_ptr && glCompileShader_ptr &&
+		glCreateProgram_ptr && glLinkProgram_ptr && glUseProgram_ptr &&
+		glGenVertexArrays_ptr && glBindVertexArray_ptr &&
+		glGenBuffers_ptr && glBindBuffer_ptr && glBufferData_ptr &&
+		glEnableVertexAttribArray_ptr && glVertexAttribPointer_ptr &&
+		glGetUniformLocation_ptr && glUniform1f_ptr && glUniform2f_ptr;
+}
+
+bool GLHasExtension(const char* name)
+{
+	if (!glGetStringi_ptr) return false;
+
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (GLint i = 0; i < count; ++i)
+	{
+		const GLubyte* ext = glGetStringi_ptr(GL_EXTENSIONS, (GLuint)i);
+		if (ext && strcmp((const char*)ext, name) == 0) return true;
+	}
+	return false;
+}
+
+bool GLVersionAtLeast(int major, int minor)
+{
+	GLint ctxMajor = 0, ctxMinor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &ctxMajor);
+	glGetIntegerv(GL_MINOR_VERSION, &ctxMinor);
+	glGetError(); // contextos < 3.0 no conocen GL_MAJOR_VERSION: quedan en 0
+	return ctxMajor > major || (ctxMajor == major && ctxMinor >= minor);
+}
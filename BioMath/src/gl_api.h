@@ -0,0 +1,304 @@
+#pragma once
+
+// ----------------------------
+// Declaraciones GL minimas
+// ----------------------------
+
+// Tipos, constantes y punteros a funciones de OpenGL que usa el programa, cargados a mano
+// (ver LoadGLFunctions). Compartido por todos los modulos que hablan con GL.
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN //Minimal basic WinApi
+	#endif
+	#include <windows.h>
+	#include <gl/GL.h>
+#else
+	// Solo GL 1.1 del sistema: el resto lo declaramos abajo, sin glext.h (chocaria con estas definiciones).
+	#define GL_GLEXT_LEGACY
+	#include <GL/gl.h>
+	#include <stddef.h>
+#endif
+
+// Construccin manual de tipos bsicos de OpenGL
+
+typedef char GLchar;
+typedef ptrdiff_t GLsizeiptr;
+
+// Constantes simblicas de OpenGL.
+
+#define GL_ARRAY_BUFFER 0x8892 // 0x8892 Un valor entero nico que el estndar OpenGL asigna al concepto array buffer. (Vertex data).
+#define GL_STATIC_DRAW 0x88E4 // Pista (sugerencia) sobre como se va a usar el buffer para el driver.
+#define GL_VERTEX_SHADER 0x8B31 // Se usa para crear shaders (un shader de tipo vrtice)
+#define GL_FRAGMENT_SHADER 0x8B30 // Se usa para crear shaders (un shader de tipo fragment)
+#define GL_COMPILE_STATUS 0x8B81 // El estado de compilacin de un shader (Este shader compil bien?)
+#define GL_LINK_STATUS 0x8B82 // El estado de linkeo de un programa de shaders
+#define GL_INFO_LOG_LENGTH 0x8B84 // La longitud del log de errores o warnings
+#define GL_TRUE 1 // Los valores booleanos de OpenGL (usa enteros).
+#define GL_FALSE 0
+
+// Framebuffers offscreen (FBO) y timer queries, para el modo headless.
+
+#define GL_FRAMEBUFFER 0x8D40 // Target de un framebuffer object (lectura + escritura)
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#define GL_RENDERBUFFER 0x8D41 // Imagen offscreen que solo sirve como attachment (no se samplea)
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#define GL_TIME_ELAPSED 0x88BF // Query que mide nanosegundos de GPU entre Begin y End
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#define GL_TIMESTAMP 0x8E28 // Query/valor con el reloj de la GPU en nanosegundos (profiler)
+
+// Texturas (render target de la resolucion dinamica, ruido horneado). El gl.h de Windows es 1.1: no las trae.
+
+#ifndef GL_TEXTURE0
+	#define GL_TEXTURE0 0x84C0
+#endif
+#ifndef GL_CLAMP_TO_EDGE
+	#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+#ifndef GL_TEXTURE_2D_ARRAY
+	#define GL_TEXTURE_2D_ARRAY 0x8C1A // Pila de texturas 2D del mismo tamanio (ruido horneado: una capa por hash)
+#endif
+#ifndef GL_R16
+	#define GL_R16 0x822A // Un canal unorm de 16 bits
+#endif
+#ifndef GL_R8
+	#define GL_R8 0x8229 // Un canal unorm de 8 bits (campo de reaccion-difusion)
+#endif
+
+// Pixel buffer objects: subir texturas y leer el framebuffer a traves de un buffer del driver (copia asincronica, sin bloquear el frame)
+
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC // Buffer del que leen glTexImage/glTexSubImage (el puntero pasa a ser un offset)
+#define GL_STREAM_DRAW 0x88E0 // Pista: se llena una vez por frame y se usa una vez
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008 // El contenido anterior no importa: el driver puede darnos memoria nueva
+#define GL_PIXEL_PACK_BUFFER 0x88EB // Buffer en el que escribe glReadPixels (lectura asincronica del framebuffer)
+#define GL_STREAM_READ 0x88E1 // Pista: lo escribe la GPU una vez y lo lee la CPU una vez
+#define GL_MAP_READ_BIT 0x0001
+
+// Buffers persistentes (ARB_buffer_storage / GL 4.4) y fences (ARB_sync / GL 3.2), para el streaming de geometria
+
+#define GL_MAP_PERSISTENT_BIT 0x0040 // El buffer puede quedar mapeado mientras la GPU lo usa
+#define GL_MAP_COHERENT_BIT 0x0080 // Lo escrito en el mapeo lo ve la GPU sin flush explicito
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117 // Fence: se senializa cuando la GPU termina todo lo anterior
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001 // glClientWaitSync: flushea antes de esperar (si no, puede no llegar nunca)
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_WAIT_FAILED 0x911D
+#define GL_MAJOR_VERSION 0x821B // glGetIntegerv: version del contexto (GL 3.0+)
+#define GL_MINOR_VERSION 0x821C
+
+// Program binaries (cache de programas linkeados en disco)
+
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257 // Pedirle al driver que guarde el binario al linkear
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE // 0 = el driver no sabe devolver binarios
+
+// Extensiones (core profile: se consultan de a una con glGetStringi) y compilacion en paralelo
+
+#define GL_NUM_EXTENSIONS 0x821D
+#define GL_COMPLETION_STATUS_KHR 0x91B1 // KHR_parallel_shader_compile: compile/link terminado, sin bloquear
+
+typedef unsigned long long GLuint64; // Resultados de timer queries (nanosegundos)
+typedef long long GLint64;
+typedef struct __GLsync* GLsync; // Fence (opaco)
+
+
+// En algunos casos APIENTRYP no puede no estar definido, lo definimos.
+// APIENTRY suele corresponder a __stdcall en 32 bits y a "*" en 64 bits. 
+// Bsicamente define como una funcin recibe argumentos, quin limpia la pila y cmo se nombra el smbolo a nivel binario.
+
+#ifndef APIENTRYP
+	#define APIENTRYP APIENTRY *
+#endif
+
+// Typedefs que describen la firma exacta de diversas funciones OpenGL modernas, para poder mas adelante obtener el puntero
+// y llamarlas como funciones normales.
+
+// PFNGL...PROC viene de la convencin del "registry":
+// PFN = Pointer to FuNction
+// GL = OpenGL
+// ... = nombre de la funcin
+// PROC = procedure(histrico)
+
+
+// BLoque de shaders:
+
+typedef GLuint(APIENTRYP PFNGLCREATESHADERPROC)(GLenum); // Crea un objeto shader (vertex o fragment) y devuelve un ID (GLuint).
+typedef void  (APIENTRYP PFNGLSHADERSOURCEPROC)(GLuint, GLsizei, const GLchar* const*, const GLint*); // Le pasa el cdigo GLSL al shader (se puede pasar 1 o varias strings).
+typedef void  (APIENTRYP PFNGLCOMPILESHADERPROC)(GLuint); // Compila el shader.
+typedef void  (APIENTRYP PFNGLGETSHADERIVPROC)(GLuint, GLenum, GLint*); // Consulta propiedades, resultado de compilacion
+typedef void  (APIENTRYP PFNGLGETSHADERINFOLOGPROC)(GLuint, GLsizei, GLsizei*, GLchar*); // Obtiene el texto del log de compilacin
+typedef void  (APIENTRYP PFNGLDELETESHADERPROC)(GLuint); // Libera el objeto shader
+
+// Bloque de programas (linkeo de shaders)
+
+typedef GLuint(APIENTRYP PFNGLCREATEPROGRAMPROC)(void); // Crea un "program object".
+typedef void  (APIENTRYP PFNGLATTACHSHADERPROC)(GLuint, GLuint); // Adjunta shaders al programa (vertex + fragment).
+typedef void  (APIENTRYP PFNGLLINKPROGRAMPROC)(GLuint); // Linkea el programa (verifica compatibilidad de inputs/outputs).
+typedef void  (APIENTRYP PFNGLGETPROGRAMIVPROC)(GLuint, GLenum, GLint*); // Igual que con shaders, pero para el link.
+typedef void  (APIENTRYP PFNGLGETPROGRAMINFOLOGPROC)(GLuint, GLsizei, GLsizei*, GLchar*);
+typedef void  (APIENTRYP PFNGLUSEPROGRAMPROC)(GLuint); // Activa el programa para dibujar.
+typedef void  (APIENTRYP PFNGLDELETEPROGRAMPROC)(GLuint); // Libera el programa.
+typedef void  (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint, GLsizei, GLsizei*, GLenum*, void*); // Binario del programa linkeado (formato del driver)
+typedef void  (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint, GLenum, const void*, GLsizei); // Carga un binario: reemplaza compile + link
+typedef void  (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint, GLenum, GLint);
+
+// VAOs (Vertex Array Objects)
+
+typedef void  (APIENTRYP PFNGLGENVERTEXARRAYSPROC)(GLsizei, GLuint*); // Genera IDs de VAOs.
+typedef void  (APIENTRYP PFNGLBINDVERTEXARRAYPROC)(GLuint); // Selecciona el VAO actual.
+typedef void  (APIENTRYP PFNGLDELETEVERTEXARRAYSPROC)(GLsizei, const GLuint*); // Libera VAOs.
+
+// VBOs / Buffers
+
+typedef void  (APIENTRYP PFNGLGENBUFFERSPROC)(GLsizei, GLuint*); // Genera IDs de buffers.
+typedef void  (APIENTRYP PFNGLBINDBUFFERPROC)(GLenum, GLuint); // Bindea un buffer a un target (GL_ARRAY_BUFFER, etc.)
+typedef void  (APIENTRYP PFNGLBUFFERDATAPROC)(GLenum, GLsizeiptr, const void*, GLenum); // Reserva y/o copia datos al buffer.
+typedef void  (APIENTRYP PFNGLDELETEBUFFERSPROC)(GLsizei, const GLuint*); // Libera buffers.
+typedef void* (APIENTRYP PFNGLMAPBUFFERRANGEPROC)(GLenum, GLsizeiptr, GLsizeiptr, GLbitfield); // Mapea un rango del buffer en memoria del proceso.
+typedef GLboolean(APIENTRYP PFNGLUNMAPBUFFERPROC)(GLenum); // Devuelve GL_FALSE si el contenido se perdio mientras estaba mapeado.
+typedef void  (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum, GLsizeiptr, const void*, GLbitfield); // Storage inmutable (tamanio y flags fijos): permite mapeo persistente
+
+// Sincronizacion CPU/GPU
+
+typedef GLsync(APIENTRYP PFNGLFENCESYNCPROC)(GLenum, GLbitfield); // Inserta un fence en el stream de comandos
+typedef GLenum(APIENTRYP PFNGLCLIENTWAITSYNCPROC)(GLsync, GLbitfield, GLuint64); // Espera hasta 'timeout' ns (0 = solo consulta)
+typedef void  (APIENTRYP PFNGLDELETESYNCPROC)(GLsync);
+
+// Vertex attributes (Le dicen al pipeline cmo leer el VBO para alimentar el vertex shader.)
+
+typedef void  (APIENTRYP PFNGLENABLEVERTEXATTRIBARRAYPROC)(GLuint); // Habilita un atributo (ej: location 0 para posicin).
+typedef void  (APIENTRYP PFNGLVERTEXATTRIBPOINTERPROC)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*); //Define el layout: cantidad de componentes, tipo, stride, offset, etc.
+typedef void  (APIENTRYP PFNGLVERTEXATTRIBDIVISORPROC)(GLuint, GLuint); // 1 = el atributo avanza por instancia, no por vertice (GL 3.3)
+
+// Instancing
+
+typedef void  (APIENTRYP PFNGLDRAWARRAYSINSTANCEDPROC)(GLenum, GLint, GLsizei, GLsizei); // Dibuja 'instancecount' copias de los vertices (GL 3.1)
+
+// Uniforms (variables globales para shaders)
+
+typedef GLint(APIENTRYP PFNGLGETUNIFORMLOCATIONPROC)(GLuint, const GLchar*); //Busca la ubicacin de un uniform por nombre.
+typedef void  (APIENTRYP PFNGLUNIFORM1FPROC)(GLint, GLfloat); //Setea un float.
+typedef void  (APIENTRYP PFNGLUNIFORM2FPROC)(GLint, GLfloat, GLfloat); //Setea dos floats (vec2).
+
+// Framebuffers / renderbuffers
+
+typedef void  (APIENTRYP PFNGLGENFRAMEBUFFERSPROC)(GLsizei, GLuint*);
+typedef void  (APIENTRYP PFNGLBINDFRAMEBUFFERPROC)(GLenum, GLuint);
+typedef void  (APIENTRYP PFNGLDELETEFRAMEBUFFERSPROC)(GLsizei, const GLuint*);
+typedef GLenum(APIENTRYP PFNGLCHECKFRAMEBUFFERSTATUSPROC)(GLenum); // GL_FRAMEBUFFER_COMPLETE si se puede dibujar
+typedef void  (APIENTRYP PFNGLFRAMEBUFFERRENDERBUFFERPROC)(GLenum, GLenum, GLenum, GLuint);
+typedef void  (APIENTRYP PFNGLGENRENDERBUFFERSPROC)(GLsizei, GLuint*);
+typedef void  (APIENTRYP PFNGLBINDRENDERBUFFERPROC)(GLenum, GLuint);
+typedef void  (APIENTRYP PFNGLRENDERBUFFERSTORAGEPROC)(GLenum, GLenum, GLsizei, GLsizei);
+typedef void  (APIENTRYP PFNGLFRAMEBUFFERTEXTURE2DPROC)(GLenum, GLenum, GLenum, GLuint, GLint); // Textura como attachment (se puede samplear despues)
+typedef void  (APIENTRYP PFNGLDELETERENDERBUFFERSPROC)(GLsizei, const GLuint*);
+
+// Queries (timer queries de GPU)
+
+typedef void  (APIENTRYP PFNGLGENQUERIESPROC)(GLsizei, GLuint*);
+typedef void  (APIENTRYP PFNGLDELETEQUERIESPROC)(GLsizei, const GLuint*);
+typedef void  (APIENTRYP PFNGLBEGINQUERYPROC)(GLenum, GLuint);
+typedef void  (APIENTRYP PFNGLENDQUERYPROC)(GLenum);
+typedef void  (APIENTRYP PFNGLGETQUERYOBJECTIVPROC)(GLuint, GLenum, GLint*);
+typedef void  (APIENTRYP PFNGLGETQUERYOBJECTUI64VPROC)(GLuint, GLenum, GLuint64*); // Lee el resultado (bloquea si no esta listo)
+typedef void  (APIENTRYP PFNGLQUERYCOUNTERPROC)(GLuint, GLenum); // Graba un GL_TIMESTAMP cuando la GPU llega a este punto
+typedef void  (APIENTRYP PFNGLGETINTEGER64VPROC)(GLenum, GLint64*);
+
+// Texturas
+
+typedef void  (APIENTRYP PFNGLACTIVETEXTUREPROC)(GLenum); // Unidad de textura activa (GL_TEXTURE0 + i)
+typedef void  (APIENTRYP PFNGLTEXIMAGE3DPROC)(GLenum, GLint, GLint, GLsizei, GLsizei, GLsizei, GLint, GLenum, GLenum, const void*); // Texturas 3D / 2D array
+
+// Extensiones
+
+typedef const GLubyte* (APIENTRYP PFNGLGETSTRINGIPROC)(GLenum, GLuint); // Nombre de la extension i (GL_EXTENSIONS)
+typedef void  (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint); // Threads del driver para compilar (0xFFFFFFFF = los que quiera)
+
+
+// Punteros (definidos en gl_api.cpp):
+
+extern PFNGLCREATESHADERPROC glCreateShader_ptr;
+extern PFNGLSHADERSOURCEPROC glShaderSource_ptr;
+extern PFNGLCOMPILESHADERPROC glCompileShader_ptr;
+extern PFNGLGETSHADERIVPROC glGetShaderiv_ptr;
+extern PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog_ptr;
+extern PFNGLDELETESHADERPROC glDeleteShader_ptr;
+
+extern PFNGLCREATEPROGRAMPROC glCreateProgram_ptr;
+extern PFNGLATTACHSHADERPROC glAttachShader_ptr;
+extern PFNGLLINKPROGRAMPROC glLinkProgram_ptr;
+extern PFNGLGETPROGRAMIVPROC glGetProgramiv_ptr;
+extern PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog_ptr;
+extern PFNGLUSEPROGRAMPROC glUseProgram_ptr;
+extern PFNGLDELETEPROGRAMPROC glDeleteProgram_ptr;
+extern PFNGLGETPROGRAMBINARYPROC glGetProgramBinary_ptr;
+extern PFNGLPROGRAMBINARYPROC glProgramBinary_ptr;
+extern PFNGLPROGRAMPARAMETERIPROC glProgramParameteri_ptr;
+
+extern PFNGLGENVERTEXARRAYSPROC glGenVertexArrays_ptr;
+extern PFNGLBINDVERTEXARRAYPROC glBindVertexArray_ptr;
+extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays_ptr;
+
+extern PFNGLGENBUFFERSPROC glGenBuffers_ptr;
+extern PFNGLBINDBUFFERPROC glBindBuffer_ptr;
+extern PFNGLBUFFERDATAPROC glBufferData_ptr;
+extern PFNGLDELETEBUFFERSPROC glDeleteBuffers_ptr;
+extern PFNGLMAPBUFFERRANGEPROC glMapBufferRange_ptr;
+extern PFNGLUNMAPBUFFERPROC glUnmapBuffer_ptr;
+extern PFNGLBUFFERSTORAGEPROC glBufferStorage_ptr;
+
+extern PFNGLFENCESYNCPROC glFenceSync_ptr;
+extern PFNGLCLIENTWAITSYNCPROC glClientWaitSync_ptr;
+extern PFNGLDELETESYNCPROC glDeleteSync_ptr;
+
+extern PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray_ptr;
+extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer_ptr;
+extern PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor_ptr;
+
+extern PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced_ptr;
+
+extern PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation_ptr;
+extern PFNGLUNIFORM1FPROC glUniform1f_ptr;
+extern PFNGLUNIFORM2FPROC glUniform2f_ptr;
+
+extern PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers_ptr;
+extern PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer_ptr;
+extern PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers_ptr;
+extern PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus_ptr;
+extern PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer_ptr;
+extern PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers_ptr;
+extern PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer_ptr;
+extern PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage_ptr;
+extern PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D_ptr;
+extern PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffers_ptr;
+
+extern PFNGLGENQUERIESPROC glGenQueries_ptr;
+extern PFNGLDELETEQUERIESPROC glDeleteQueries_ptr;
+extern PFNGLBEGINQUERYPROC glBeginQuery_ptr;
+extern PFNGLENDQUERYPROC glEndQuery_ptr;
+extern PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv_ptr;
+extern PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v_ptr;
+extern PFNGLQUERYCOUNTERPROC glQueryCounter_ptr;
+extern PFNGLGETINTEGER64VPROC glGetInteger64v_ptr;
+
+extern PFNGLACTIVETEXTUREPROC glActiveTexture_ptr;
+extern PFNGLTEXIMAGE3DPROC glTexImage3D_ptr;
+
+extern PFNGLGETSTRINGIPROC glGetStringi_ptr;
+extern PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR_ptr;
+
+
+// Carga todos los punteros del contexto actual. Devuelve false si falta algo imprescindible
+// para dibujar (shaders + VAO); las funciones opcionales (FBO, queries) pueden quedar en null.
+bool LoadGLFunctions();
+
+// true si el contexto actual expone la extension (p. ej. "GL_KHR_parallel_shader_compile").
+bool GLHasExtension(const char* name);
+
+// true si el contexto es de version major.minor o mas nueva.
+bool GLVersionAtLeast(int major, int minor);
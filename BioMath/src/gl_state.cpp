@@ -0,0 +1,346 @@
+#include "gl_state.h"
+
+#include <string.h>
+
+#ifndef GL_ELEMENT_ARRAY_BUFFER
+	#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#endif
+
+// Valor imposible para los IDs: "no sabemos que hay bindeado".
+static const GLuint kUnknown = 0xFFFFFFFFu;
+
+static const int kBufferTargets = 8;
+static const int kTextureUnits = 8;
+static const int kUniformSlots = 256; // potencia de 2 (open addressing)
+
+struct BufferBinding
+{
+	GLenum target;
+	GLuint buffer;
+};
+
+// Valor de un uniform ya subido. La clave junta programa y location; 0 = slot libre.
+struct UniformSlot
+{
+	uint64_t key;
+	int components;
+	GLfloat v[4];
+};
+
+struct GLState
+{
+	GLuint program = kUnknown;
+	GLuint vao = kUnknown;
+	GLuint readFbo = kUnknown;
+	GLuint drawFbo = kUnknown;
+
+	BufferBinding buffers[kBufferTargets] = {};
+	int bufferCount = 0;
+
+	GLuint activeUnit = kUnknown;
+	GLuint textures2D[kTextureUnits] = { kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown };
+	GLuint textures2DArray[kTextureUnits] = { kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown };
+
+	bool viewportKnown = false;
+	GLint viewport[4] = {};
+
+	bool clearColorKnown = false;
+	GLfloat clearColor[4] = {};
+
+	UniformSlot uniforms[kUniformSlots] = {};
+
+	GLStateCounters frame;
+	GLStateCounters total;
+};
+
+static GLState g_state;
+
+static void Issued()
+{
+	++g_state.frame.issued;
+	++g_state.total.issued;
+}
+
+static void Elided()
+{
+	++g_state.frame.elided;
+	++g_state.total.elided;
+}
+
+void GLStateInvalidate()
+{
+	// Se preservan los contadores: invalidar no es un frame nuevo.
+	const GLStateCounters frame = g_state.frame;
+	const GLStateCounters total = g_state.total;
+	g_state = GLState();
+	g_state.frame = frame;
+	g_state.total = total;
+}
+
+void GLStateBeginFrame()
+{
+	g_state.frame = GLStateCounters();
+}
+
+GLStateCounters GLStateFrameCounters()
+{
+	return g_state.frame;
+}
+
+GLStateCounters GLStateTotalCounters()
+{
+	return g_state.total;
+}
+
+
+// ---------------------------
+// Bindings
+// ---------------------------
+
+void GLStateUseProgram(GLuint program)
+{
+	if (g_state.program == program) { Elided(); return; }
+	glUseProgram_ptr(program);
+	g_state.program = program;
+	Issued();
+}
+
+void GLStateBindVertexArray(GLuint vao)
+{
+	if (g_state.vao == vao) { Elided(); return; }
+	glBindVertexArray_ptr(vao);
+	g_state.vao = vao;
+	Issued();
+
+	// El element array buffer es estado del VAO: al cambiar de VAO ya no lo conocemos.
+	for (int i = 0; i < g_state.bufferCount; ++i)
+		if (g_state.buffers[i].target == GL_ELEMENT_ARRAY_BUFFER)
+			g_state.buffers[i].buffer = kUnknown;
+}
+
+static BufferBinding* FindBufferBinding(GLenum target)
+{
+	for (int i = 0; i < g_state.bufferCount; ++i)
+		if (g_state.buffers[i].target == target)
+			return &g_state.buffers[i];
+
+	if (g_state.bufferCount == kBufferTargets) return nullptr;
+	BufferBinding* b = &g_state.buffers[g_state.bufferCount++];
+	b->target = target;
+	b->buffer = kUnknown;
+	return b;
+}
+
+void GLStateBindBuffer(GLenum target, GLuint buffer)
+{
+	BufferBinding* b = FindBufferBinding(target);
+	if (b && b->buffer == buffer) { Elided(); return; }
+	glBindBuffer_ptr(target, buffer);
+	if (b) b->buffer = buffer;
+	Issued();
+}
+
+void GLStateBindFramebuffer(GLenum target, GLuint fbo)
+{
+	const bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+	const bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+	if ((!read || g_state.readFbo == fbo) && (!draw || g_state.drawFbo == fbo)) { Elided(); return; }
+
+	glBindFramebuffer_ptr(target, fbo);
+	if (read) g_state.readFbo = fbo;
+	if (draw) g_state.drawFbo = fbo;
+	Issued();
+}
+
+// Cada target tiene su propio binding por unidad; 'bound' es la tabla del target.
+static void BindTexture(GLenum target, GLuint* bound, GLuint unit, GLuint texture)
+{
+	if (unit < (GLuint)kTextureUnits && bound[unit] == texture) { Elided(); return; }
+
+	if (g_state.activeUnit != unit)
+	{
+		glActiveTexture_ptr(GL_TEXTURE0 + unit);
+		g_state.activeUnit = unit;
+		Issued();
+	}
+	glBindTexture(target, texture);
+	if (unit < (GLuint)kTextureUnits) bound[unit] = texture;
+	Issued();
+}
+
+void GLStateBindTexture2D(GLuint unit, GLuint texture)
+{
+	BindTexture(GL_TEXTURE_2D, g_state.textures2D, unit, texture);
+}
+
+void GLStateBindTexture2DArray(GLuint unit, GLuint texture)
+{
+	BindTexture(GL_TEXTURE_2D_ARRAY, g_state.textures2DArray, unit, texture);
+}
+
+GLuint GLStateDrawFramebuffer()
+{
+	return g_state.drawFbo == kUnknown ? 0 : g_state.drawFbo;
+}
+
+
+// ---------------------------
+// Estado fijo
+// ---------------------------
+
+void GLStateViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	const GLint v[4] = { x, y, width, height };
+	if (g_state.viewportKnown && memcmp(g_state.viewport, v, sizeof(v)) == 0) { Elided(); return; }
+	glViewport(x, y, width, height);
+	memcpy(g_state.viewport, v, sizeof(v));
+	g_state.viewportKnown = true;
+	Issued();
+}
+
+void GLStateClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+{
+	const GLfloat c[4] = { r, g, b, a };
+	if (g_state.clearColorKnown && memcmp(g_state.clearColor, c, sizeof(c)) == 0) { Elided(); return; }
+	glClearColor(r, g, b, a);
+	memcpy(g_state.clearColor, c, sizeof(c));
+	g_state.clearColorKnown = true;
+	Issued();
+}
+
+
+// ---------------------------
+// Uniforms
+// ---------------------------
+
+static uint64_t UniformKey(GLuint program, GLint location)
+{
+	return ((uint64_t)program << 32) | (uint64_t)(uint32_t)(location + 1); // +1: nunca 0
+}
+
+// Devuelve el slot del uniform (existente o recien tomado), o nullptr si la tabla esta llena.
+static UniformSlot* FindUniformSlot(GLuint program, GLint location)
+{
+	const uint64_t key = UniformKey(program, location);
+	uint32_t h = (uint32_t)(key * 0x9E3779B97F4A7C15ull >> 40);
+	for (int probe = 0; probe < kUniformSlots; ++probe, ++h)
+	{
+		UniformSlot& s = g_state.uniforms[h & (kUniformSlots - 1)];
+		if (s.key == key) return &s;
+		if (s.key == 0)
+		{
+			s.key = key;
+			s.components = 0; // valor desconocido
+			return &s;
+		}
+	}
+	return nullptr;
+}
+
+// Comparacion por bits: -0.0 != 0.0 y NaN == NaN, igual que lo que termina en el driver.
+static bool SetUniformShadow(GLint location, int components, const GLfloat* v)
+{
+	if (location < 0 || g_state.program == kUnknown) return true;
+	UniformSlot* s = FindUniformSlot(g_state.program, location);
+	if (!s) return true;
+	if (s->components == components && memcmp(s->v, v, sizeof(GLfloat) * (size_t)components) == 0)
+		return false;
+	s->components = components;
+	memcpy(s->v, v, sizeof(GLfloat) * (size_t)components);
+	return true;
+}
+
+void GLStateUniform1f(GLint location, GLfloat x)
+{
+	const GLfloat v[1] = { x };
+	if (!SetUniformShadow(location, 1, v)) { Elided(); return; }
+	glUniform1f_ptr(location, x);
+	Issued();
+}
+
+void GLStateUniform2f(GLint location, GLfloat x, GLfloat y)
+{
+	const GLfloat v[2] = { x, y };
+	if (!SetUniformShadow(location, 2, v)) { Elided(); return; }
+	glUniform2f_ptr(location, x, y);
+	Issued();
+}
+
+
+// ---------------------------
+// Draws / clears
+// ---------------------------
+
+void GLStateClear(GLbitfield mask)
+{
+	glClear(mask);
+	Issued();
+}
+
+void GLStateDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	glDrawArrays(mode, first, count);
+	Issued();
+}
+
+void GLStateDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+{
+	glDrawArraysInstanced_ptr(mode, first, count, instances);
+	Issued();
+}
+
+
+// ---------------------------
+// Borrado
+// ---------------------------
+
+void GLStateDeleteProgram(GLuint program)
+{
+	if (!program) return;
+	glDeleteProgram_ptr(program);
+	Issued();
+
+	// El ID se puede reciclar en un programa nuevo: sus uniforms no valen mas. Se vacia la
+	// tabla entera (borrar en open addressing rompe las cadenas y esto pasa muy poco).
+	memset(g_state.uniforms, 0, sizeof(g_state.uniforms));
+	if (g_state.program == program) g_state.program = kUnknown;
+}
+
+void GLStateDeleteVertexArray(GLuint vao)
+{
+	if (!vao) return;
+	glDeleteVertexArrays_ptr(1, &vao);
+	Issued();
+	if (g_state.vao == vao) g_state.vao = kUnknown;
+}
+
+void GLStateDeleteBuffer(GLuint buffer)
+{
+	if (!buffer) return;
+	glDeleteBuffers_ptr(1, &buffer);
+	Issued();
+	for (int i = 0; i < g_state.bufferCount; ++i)
+		if (g_state.buffers[i].buffer == buffer)
+			g_state.buffers[i].buffer = kUnknown;
+}
+
+void GLStateDeleteFramebuffer(GLuint fbo)
+{
+	if (!fbo) return;
+	glDeleteFramebuffers_ptr(1, &fbo);
+	Issued();
+	if (g_state.readFbo == fbo) g_state.readFbo = kUnknown;
+	if (g_state.drawFbo == fbo) g_state.drawFbo = kUnknown;
+}
+
+void GLStateDeleteTexture(GLuint texture)
+{
+	if (!texture) return;
+	glDeleteTextures(1, &texture);
+	Issued();
+	for (int i = 0; i < kTextureUnits; ++i)
+	{
+		if (g_state.textures2D[i] == texture) g_state.textures2D[i] = kUnknown;
+		if (g_state.textures2DArray[i] == texture) g_state.textures2DArray[i] = kUnknown;
+	}
+}
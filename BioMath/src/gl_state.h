@@ -0,0 +1,64 @@
+#pragma once
+
+#include "gl_api.h"
+
+#include <stdint.h>
+
+// ---------------------------
+// Cache de estado GL
+// ---------------------------
+
+// Capa fina sobre los punteros de gl_api.h: guarda una copia del estado que ya le mandamos al
+// driver (programa, VAO, buffers, framebuffer, texturas, viewport, clear color y uniforms) y
+// no repite llamadas que no cambiarian nada. Todo el codigo de render pasa por aca.
+//
+// Si algo toca ese estado por fuera (otra lib, un glBind directo) hay que llamar a
+// GLStateInvalidate() para que la proxima llamada se emita si o si.
+//
+// Los contadores cuentan las llamadas que pasaron por esta capa: 'issued' llegaron al driver,
+// 'elided' se descartaron por redundantes. Draws y clears siempre se emiten.
+
+struct GLStateCounters
+{
+	uint64_t issued = 0;
+	uint64_t elided = 0;
+};
+
+// Olvida todo el estado conocido (contexto nuevo o estado tocado por fuera).
+void GLStateInvalidate();
+
+// Contadores del frame actual / acumulados. GLStateBeginFrame reinicia los del frame.
+void GLStateBeginFrame();
+GLStateCounters GLStateFrameCounters();
+GLStateCounters GLStateTotalCounters();
+
+// Bindings
+void GLStateUseProgram(GLuint program);
+void GLStateBindVertexArray(GLuint vao);
+void GLStateBindBuffer(GLenum target, GLuint buffer);     // GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, ...
+void GLStateBindFramebuffer(GLenum target, GLuint fbo);   // GL_FRAMEBUFFER actualiza read y draw
+void GLStateBindTexture2D(GLuint unit, GLuint texture);   // unit = indice (0, 1, ...), no GL_TEXTURE0 + i
+void GLStateBindTexture2DArray(GLuint unit, GLuint texture);
+
+// Draw framebuffer que quedo bindeado por esta capa (0 si no se sabe o es el de la ventana).
+GLuint GLStateDrawFramebuffer();
+
+// Estado fijo
+void GLStateViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void GLStateClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+
+// Uniforms del programa en uso (GLStateUseProgram). Los valores se recuerdan por programa.
+void GLStateUniform1f(GLint location, GLfloat x);
+void GLStateUniform2f(GLint location, GLfloat x, GLfloat y);
+
+// Siempre se emiten (solo cuentan)
+void GLStateClear(GLbitfield mask);
+void GLStateDrawArrays(GLenum mode, GLint first, GLsizei count);
+void GLStateDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances);   // requiere glDrawArraysInstanced_ptr
+
+// Borrado: ademas de borrar, limpia los bindings y uniforms cacheados del objeto.
+void GLStateDeleteProgram(GLuint program);
+void GLStateDeleteVertexArray(GLuint vao);
+void GLStateDeleteBuffer(GLuint buffer);
+void GLStateDeleteFramebuffer(GLuint fbo);
+void GLStateDeleteTexture(GLuint texture);
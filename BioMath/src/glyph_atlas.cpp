@@ -0,0 +1,268 @@
+#include "glyph_atlas.h"
+#include "parallel.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Font de 5x7 por columnas: 5 bytes por glifo, bit 0 = fila de arriba.
+static const uint8_t kFont5x7[kGlyphCount][kGlyphFontWidth] = {
+	{ 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+	{ 0x00, 0x00, 0x5F, 0x00, 0x00 }, // !
+	{ 0x00, 0x07, 0x00, 0x07, 0x00 }, // "
+	{ 0x14, 0x7F, 0x14, 0x7F, 0x14 }, // #
+	{ 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, // $
+	{ 0x23, 0x13, 0x08, 0x64, 0x62 }, // %
+	{ 0x36, 0x49, 0x55, 0x22, 0x50 }, // &
+	{ 0x00, 0x05, 0x03, 0x00, 0x00 }, // '
+	{ 0x00, 0x1C, 0x22, 0x41, 0x00 }, // (
+	{ 0x00, 0x41, 0x22, 0x1C, 0x00 }, // )
+	{ 0x14, 0x08, 0x3E, 0x08, 0x14 }, // *
+	{ 0x08, 0x08, 0x3E, 0x08, 0x08 }, // +
+	{ 0x00, 0x50, 0x30, 0x00, 0x00 }, // ,
+	{ 0x08, 0x08, 0x08, 0x08, 0x08 }, // -
+	{ 0x00, 0x60, 0x60, 0x00, 0x00 }, // .
+	{ 0x20, 0x10, 0x08, 0x04, 0x02 }, // /
+	{ 0x3E, 0x51, 0x49, 0x45, 0x3E }, // 0
+	{ 0x00, 0x42, 0x7F, 0x40, 0x00 }, // 1
+	{ 0x42, 0x61, 0x51, 0x49, 0x46 }, // 2
+	{ 0x21, 0x41, 0x45, 0x4B, 0x31 }, // 3
+	{ 0x18, 0x14, 0x12, 0x7F, 0x10 }, // 4
+	{ 0x27, 0x45, 0x45, 0x45, 0x39 }, // 5
+	{ 0x3C, 0x4A, 0x49, 0x49, 0x30 }, // 6
+	{ 0x01, 0x71, 0x09, 0x05, 0x03 }, // 7
+	{ 0x36, 0x49, 0x49, 0x49, 0x36 }, // 8
+	{ 0x06, 0x49, 0x49, 0x29, 0x1E }, // 9
+	{ 0x00, 0x36, 0x36, 0x00, 0x00 }, // :
+	{ 0x00, 0x56, 0x36, 0x00, 0x00 }, // ;
+	{ 0x08, 0x14, 0x22, 0x41, 0x00 }, // <
+	{ 0x14, 0x14, 0x14, 0x14, 0x14 }, // =
+	{ 0x00, 0x41, 0x22, 0x14, 0x08 }, // >
+	{ 0x02, 0x01, 0x51, 0x09, 0x06 }, // ?
+	{ 0x32, 0x49, 0x79, 0x41, 0x3E }, // @
+	{ 0x7E, 0x11, 0x11, 0x11, 0x7E }, // A
+	{ 0x7F, 0x49, 0x49, 0x49, 0x36 }, // B
+	{ 0x3E, 0x41, 0x41, 0x41, 0x22 }, // C
+	{ 0x7F, 0x41, 0x41, 0x22, 0x1C }, // D
+	{ 0x7F, 0x49, 0x49, 0x49, 0x41 }, // E
+	{ 0x7F, 0x09, 0x09, 0x09, 0x01 }, // F
+	{ 0x3E, 0x41, 0x49, 0x49, 0x7A }, // G
+	{ 0x7F, 0x08, 0x08, 0x08, 0x7F }, // H
+	{ 0x00, 0x41, 0x7F, 0x41, 0x00 }, // I
+	{ 0x20, 0x40, 0x41, 0x3F, 0x01 }, // J
+	{ 0x7F, 0x08, 0x14, 0x22, 0x41 }, // K
+	{ 0x7F, 0x40, 0x40, 0x40, 0x40 }, // L
+	{ 0x7F, 0x02, 0x0C, 0x02, 0x7F }, // M
+	{ 0x7F, 0x04, 0x08, 0x10, 0x7F }, // N
+	{ 0x3E, 0x41, 0x41, 0x41, 0x3E }, // O
+	{ 0x7F, 0x09, 0x09, 0x09, 0x06 }, // P
+	{ 0x3E, 0x41, 0x51, 0x21, 0x5E }, // Q
+	{ 0x7F, 0x09, 0x19, 0x29, 0x46 }, // R
+	{ 0x46, 0x49, 0x49, 0x49, 0x31 }, // S
+	{ 0x01, 0x01, 0x7F, 0x01, 0x01 }, // T
+	{ 0x3F, 0x40, 0x40, 0x40, 0x3F }, // U
+	{ 0x1F, 0x20, 0x40, 0x20, 0x1F }, // V
+	{ 0x3F, 0x40, 0x38, 0x40, 0x3F }, // W
+	{ 0x63, 0x14, 0x08, 0x14, 0x63 }, // X
+	{ 0x07, 0x08, 0x70, 0x08, 0x07 }, // Y
+	{ 0x61, 0x51, 0x49, 0x45, 0x43 }, // Z
+	{ 0x00, 0x7F, 0x41, 0x41, 0x00 }, // [
+	{ 0x02, 0x04, 0x08, 0x10, 0x20 }, // backslash
+	{ 0x00, 0x41, 0x41, 0x7F, 0x00 }, // ]
+	{ 0x04, 0x02, 0x01, 0x02, 0x04 }, // ^
+	{ 0x40, 0x40, 0x40, 0x40, 0x40 }, // _
+	{ 0x00, 0x01, 0x02, 0x04, 0x00 }, // `
+	{ 0x20, 0x54, 0x54, 0x54, 0x78 }, // a
+	{ 0x7F, 0x48, 0x44, 0x44, 0x38 }, // b
+	{ 0x38, 0x44, 0x44, 0x44, 0x20 }, // c
+	{ 0x38, 0x44, 0x44, 0x48, 0x7F }, // d
+	{ 0x38, 0x54, 0x54, 0x54, 0x18 }, // e
+	{ 0x08, 0x7E, 0x09, 0x01, 0x02 }, // f
+	{ 0x0C, 0x52, 0x52, 0x52, 0x3E }, // g
+	{ 0x7F, 0x08, 0x04, 0x04, 0x78 }, // h
+	{ 0x00, 0x44, 0x7D, 0x40, 0x00 }, // i
+	{ 0x20, 0x40, 0x44, 0x3D, 0x00 }, // j
+	{ 0x7F, 0x10, 0x28, 0x44, 0x00 }, // k
+	{ 0x00, 0x41, 0x7F, 0x40, 0x00 }, // l
+	{ 0x7C, 0x04, 0x18, 0x04, 0x78 }, // m
+	{ 0x7C, 0x08, 0x04, 0x04, 0x78 }, // n
+	{ 0x38, 0x44, 0x44, 0x44, 0x38 }, // o
+	{ 0x7C, 0x14, 0x14, 0x14, 0x08 }, // p
+	{ 0x08, 0x14, 0x14, 0x18, 0x7C }, // q
+	{ 0x7C, 0x08, 0x04, 0x04, 0x08 }, // r
+	{ 0x48, 0x54, 0x54, 0x54, 0x20 }, // s
+	{ 0x04, 0x3F, 0x44, 0x40, 0x20 }, // t
+	{ 0x3C, 0x40, 0x40, 0x20, 0x7C }, // u
+	{ 0x1C, 0x20, 0x40, 0x20, 0x1C }, // v
+	{ 0x3C, 0x40, 0x30, 0x40, 0x3C }, // w
+	{ 0x44, 0x28, 0x10, 0x28, 0x44 }, // x
+	{ 0x0C, 0x50, 0x50, 0x50, 0x3C }, // y
+	{ 0x44, 0x64, 0x54, 0x4C, 0x44 }, // z
+	{ 0x00, 0x08, 0x36, 0x41, 0x00 }, // {
+	{ 0x00, 0x00, 0x7F, 0x00, 0x00 }, // |
+	{ 0x00, 0x41, 0x36, 0x08, 0x00 }, // }
+	{ 0x08, 0x04, 0x08, 0x10, 0x08 }, // ~
+};
+
+// Radio del trazo en pixels del font (0.5 = pixels pegados; un poco menos separa trazos vecinos).
+static const float kStrokeRadius = 0.42f;
+
+static const int kPadX = (kGlyphBoxWidth - kGlyphFontWidth * kGlyphCellTexels) / 2;
+static const int kPadY = (kGlyphBoxHeight - kGlyphFontHeight * kGlyphCellTexels) / 2;
+
+// Un glifo tiene como mucho 35 pixels con 4 segmentos cada uno (derecha, abajo y dos diagonales).
+static const int kMaxSegments = kGlyphFontWidth * kGlyphFontHeight * 4;
+
+struct Segment
+{
+	float ax, ay, bx, by;
+};
+
+size_t GlyphAtlasBytes()
+{
+	return (size_t)kGlyphAtlasWidth * (size_t)kGlyphAtlasHeight;
+}
+
+int GlyphIndex(unsigned char c)
+{
+	if (c < kGlyphFirst || c >= kGlyphFirst + kGlyphCount) c = '?';
+	return (int)c - kGlyphFirst;
+}
+
+bool GlyphFontPixel(int glyph, int x, int y)
+{
+	if (x < 0 || y < 0 || x >= kGlyphFontWidth || y >= kGlyphFontHeight) return false;
+	return (kFont5x7[glyph][x] >> y) & 1;
+}
+
+// Los trazos del glifo en texels de su caja: centros de pixel unidos a los vecinos prendidos.
+static int GlyphSegments(int glyph, Segment* out)
+{
+	int count = 0;
+	auto add = [&](int x0, int y0, int x1, int y1)
+	{
+		const float s = (float)kGlyphCellTexels;
+		out[count++] = { kPadX + (x0 + 0.5f) * s, kPadY + (y0 + 0.5f) * s, kPadX + (x1 + 0.5f) * s, kPadY + (y1 + 0.5f) * s };
+	};
+	for (int y = 0; y < kGlyphFontHeight; ++y)
+	{
+		for (int x = 0; x < kGlyphFontWidth; ++x)
+		{
+			if (!GlyphFontPixel(glyph, x, y)) continue;
+			const bool right = GlyphFontPixel(glyph, x + 1, y);
+			const bool down = GlyphFontPixel(glyph, x, y + 1);
+			const bool left = GlyphFontPixel(glyph, x - 1, y);
+			bool linked = right || down || left || GlyphFontPixel(glyph, x, y - 1);
+			if (right) add(x, y, x + 1, y);
+			if (down) add(x, y, x, y + 1);
+			// Diagonales solo donde no hay un camino recto: si no, las esquinas se llenan.
+			if (GlyphFontPixel(glyph, x + 1, y + 1) && !right && !down)
+			{
+				add(x, y, x + 1, y + 1);
+				linked = true;
+			}
+			if (GlyphFontPixel(glyph, x - 1, y + 1) && !left && !down)
+			{
+				add(x, y, x - 1, y + 1);
+				linked = true;
+			}
+			linked = linked || (GlyphFontPixel(glyph, x - 1, y - 1) && !left && !GlyphFontPixel(glyph, x, y - 1)) ||
+				(GlyphFontPixel(glyph, x + 1, y - 1) && !right && !GlyphFontPixel(glyph, x, y - 1));
+			if (!linked) add(x, y, x, y); // pixel suelto (el punto de la 'i'): un segmento de largo 0
+		}
+	}
+	return count;
+}
+
+static float SegmentDistance(const Segment& s, float px, float py)
+{
+	const float dx = s.bx - s.ax, dy = s.by - s.ay;
+	const float wx = px - s.ax, wy = py - s.ay;
+	const float len2 = dx * dx + dy * dy;
+	float t = len2 > 0.0f ? (wx * dx + wy * dy) / len2 : 0.0f;
+	t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+	const float ex = wx - t * dx, ey = wy - t * dy;
+	return sqrtf(ex * ex + ey * ey);
+}
+
+// Escribe la caja del glifo en 'box' (con el stride del atlas).
+static void BakeGlyph(int glyph, uint8_t* box)
+{
+	Segment segments[kMaxSegments];
+	const int count = GlyphSegments(glyph, segments);
+	const float radius = kStrokeRadius * (float)kGlyphCellTexels;
+	const float scale = 127.5f / kGlyphSpreadTexels;
+
+	for (int y = 0; y < kGlyphBoxHeight; ++y)
+	{
+		uint8_t* row = box + (size_t)y * kGlyphAtlasWidth;
+		for (int x = 0; x < kGlyphBoxWidth; ++x)
+		{
+			const float px = (float)x + 0.5f, py = (float)y + 0.5f;
+			float d = 1e9f;
+			for (int i = 0; i < count; ++i)
+			{
+				const float di = SegmentDistance(segments[i], px, py);
+				if (di < d) d = di;
+			}
+			const float v = 127.5f - (d - radius) * scale;
+			row[x] = (uint8_t)(v <= 0.0f ? 0.0f : (v >= 255.0f ? 255.0f : v + 0.5f));
+		}
+	}
+}
+
+static uint8_t* GlyphBox(uint8_t* atlas, int glyph)
+{
+	const int col = glyph % kGlyphAtlasColumns, row = glyph / kGlyphAtlasColumns;
+	return atlas + (size_t)row * kGlyphBoxHeight * kGlyphAtlasWidth + (size_t)col * kGlyphBoxWidth;
+}
+
+void GlyphAtlasBake(uint8_t* dst)
+{
+	// Las cajas de la ultima fila que no tienen glifo quedan en 0 (afuera de todo).
+	memset(dst, 0, GlyphAtlasBytes());
+	ParallelFor(kGlyphCount, 1, [&](int begin, int end)
+	{
+		for (int g = begin; g < end; ++g)
+			BakeGlyph(g, GlyphBox(dst, g));
+	});
+}
+
+int GlyphAtlasVerify(const uint8_t* atlas, int glyphStep)
+{
+	if (glyphStep < 1) glyphStep = 1;
+	uint8_t box[kGlyphBoxHeight * kGlyphAtlasWidth];
+	int bad = 0;
+	for (int g = 0; g < kGlyphCount; g += glyphStep)
+	{
+		BakeGlyph(g, box);
+		const uint8_t* stored = GlyphBox((uint8_t*)atlas, g);
+		for (int y = 0; y < kGlyphBoxHeight; ++y)
+			for (int x = 0; x < kGlyphBoxWidth; ++x)
+				bad += stored[(size_t)y * kGlyphAtlasWidth + x] != box[(size_t)y * kGlyphAtlasWidth + x];
+	}
+	return bad;
+}
+
+uint64_t GlyphAtlasKey()
+{
+	const int params[] = { kGlyphCellTexels, kGlyphBoxWidth, kGlyphBoxHeight, kGlyphAtlasColumns, (int)(kStrokeRadius * 1000.0f),
+		(int)(kGlyphSpreadTexels * 1000.0f), 1 /* formato R8 */ };
+	uint64_t h = 0xCBF29CE484222325ull;
+	auto mix = [&](const void* data, size_t bytes)
+	{
+		for (size_t i = 0; i < bytes; ++i)
+		{
+			h ^= ((const uint8_t*)data)[i];
+			h *= 0x100000001B3ull;
+		}
+	};
+	mix(kFont5x7, sizeof(kFont5x7));
+	mix(params, sizeof(params));
+	return h;
+}
+
+void GlyphAtlasAssetName(char* out, size_t size)
+{
+	snprintf(out, size, "hud/glyph-atlas-%016llx.r8", (unsigned long long)GlyphAtlasKey());
+}
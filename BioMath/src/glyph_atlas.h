@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ---------------------------
+// Atlas de glifos SDF
+// ---------------------------
+
+// El texto del HUD (hud.h) sale de un atlas de campos de distancia: cada texel guarda la distancia
+// al borde del glifo (127.5 = borde, mas = adentro, +-kGlyphSpreadTexels llevados a 0..255). Un
+// atlas chico se ve nitido a cualquier tamanio y el borde y el contorno oscuro son un smoothstep en
+// el fragment shader.
+//
+// Los glifos son ASCII 32..126 de un font de 5x7 pixels embebido, leido como trazos: cada pixel
+// prendido es un punto unido a sus vecinos prendidos por segmentos (los diagonales solo si no hay
+// camino recto), y el campo es la distancia exacta a esos segmentos menos el radio del trazo. Sale
+// un font redondeado en vez de bloques, sin archivos de fuentes ni rasterizador.
+//
+// Layout: R8, kGlyphAtlasColumns x kGlyphAtlasRows cajas de kGlyphBoxWidth x kGlyphBoxHeight
+// texels; el glifo i va en la caja (i % columnas, i / columnas), fila 0 arriba. El horneado
+// reparte glifos entre threads (ParallelFor) y el resultado no depende de cuantos. Tambien puede
+// venir del paquete de assets (BioMathPack --glyph-atlas).
+//
+// Metricas en unidades de la altura de la caja, que es lo que el HUD llama tamanio del texto.
+
+static const int kGlyphFirst = 32;
+static const int kGlyphCount = 95;                  // ' ' .. '~'
+static const int kGlyphFontWidth = 5;
+static const int kGlyphFontHeight = 7;
+static const int kGlyphCellTexels = 6;              // texels por pixel del font
+static const int kGlyphBoxWidth = 48;
+static const int kGlyphBoxHeight = 64;
+static const int kGlyphAtlasColumns = 16;
+static const int kGlyphAtlasRows = (kGlyphCount + kGlyphAtlasColumns - 1) / kGlyphAtlasColumns;
+static const int kGlyphAtlasWidth = kGlyphBoxWidth * kGlyphAtlasColumns;
+static const int kGlyphAtlasHeight = kGlyphBoxHeight * kGlyphAtlasRows;
+static const int kGlyphSpreadTexels = 8;
+
+static const float kGlyphAdvance = (float)((kGlyphFontWidth + 1) * kGlyphCellTexels) / (float)kGlyphBoxHeight;
+static const float kGlyphLineHeight = (float)((kGlyphFontHeight + 3) * kGlyphCellTexels) / (float)kGlyphBoxHeight;
+static const float kGlyphAspect = (float)kGlyphBoxWidth / (float)kGlyphBoxHeight;
+
+static_assert(kGlyphAtlasWidth % 4 == 0, "rows must stay 4-byte aligned for the upload");
+static_assert((kGlyphBoxWidth - kGlyphFontWidth * kGlyphCellTexels) / 2 >= kGlyphSpreadTexels &&
+	(kGlyphBoxHeight - kGlyphFontHeight * kGlyphCellTexels) / 2 >= kGlyphSpreadTexels, "the field must fit in the box");
+
+// Bytes del atlas (kGlyphAtlasWidth * kGlyphAtlasHeight).
+size_t GlyphAtlasBytes();
+
+// Hornea el atlas completo en 'dst' (GlyphAtlasBytes() bytes).
+void GlyphAtlasBake(uint8_t* dst);
+
+// Rehornea uno de cada 'glyphStep' glifos (1 = todos) y devuelve cuantos texels no coinciden.
+// 0 = atlas correcto.
+int GlyphAtlasVerify(const uint8_t* atlas, int glyphStep);
+
+// Indice del glifo de un caracter; los que no estan en el font dan el de '?'.
+int GlyphIndex(unsigned char c);
+
+// Pixel (x, y) del font de 5x7 (y = 0 arriba) del glifo 'glyph'.
+bool GlyphFontPixel(int glyph, int x, int y);
+
+// Clave del generador (font, radio del trazo, layout). Va en el nombre del asset: un paquete hecho
+// con otro generador simplemente no lo tiene.
+uint64_t GlyphAtlasKey();
+
+// "hud/glyph-atlas-<clave>.r8"
+void GlyphAtlasAssetName(char* out, size_t size);
@@ -0,0 +1,301 @@
+#include "headless.h"
+#include "gl_api.h"
+#include "cpu_renderer.h"
+#include "dynamic_resolution.h"
+#include "expr_field.h"
+#include "frame_capture.h"
+#include "noise_texture.h"
+#include "ode_plot.h"
+#include "agents_render.h"
+#include "assets.h"
+#include "hud.h"
+#include "frame_stats.h"
+#include "gl_state.h"
+#include "input.h"
+#include "platform.h"
+#include "profiler.h"
+#include "reaction_diffusion_texture.h"
+#include "shader_program.h"
+#include "shader_variants.h"
+#include "startup.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// Cantidad de timer queries en vuelo. La query de un frame se lee recien cuando se vuelve a usar
+// su slot, kQueryRing frames despues: para entonces la GPU ya termino y la lectura no frena el CPU.
+static const int kQueryRing = 8;
+
+static double NowSeconds()
+{
+	using namespace std::chrono;
+	return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void ParseHeadlessOptions(int argc, char** argv, HeadlessOptions* opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* a = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (strcmp(a, "--headless") == 0) opts->enabled = true;
+		else if (strcmp(a, "--golden") == 0) opts->golden = true;
+		else if (strcmp(a, "--frames") == 0 && hasValue) opts->frames = atoi(argv[++i]);
+		else if (strcmp(a, "--warmup") == 0 && hasValue) opts->warmupFrames = atoi(argv[++i]);
+		else if (strcmp(a, "--dt") == 0 && hasValue) opts->dt = atof(argv[++i]);
+		else if (strcmp(a, "--json") == 0 && hasValue) opts->jsonPath = argv[++i];
+		else if (strcmp(a, "--golden-min-psnr") == 0 && hasValue) opts->goldenMinPsnr = atof(argv[++i]);
+		else if (strcmp(a, "--size") == 0 && hasValue)
+		{
+			int w = 0, h = 0;
+			if (sscanf(argv[++i], "%dx%d", &w, &h) == 2 && w > 0 && h > 0)
+			{
+				opts->width = w;
+				opts->height = h;
+			}
+		}
+	}
+
+	ParseFramePacerOptions(argc, argv, &opts->pacing);
+
+	if (opts->frames < 1) opts->frames = 1;
+	if (opts->warmupFrames < 0) opts->warmupFrames = 0;
+	if (opts->dt <= 0.0) opts->dt = 1.0 / 60.0;
+}
+
+static void WriteJsonString(FILE* f, const char* s)
+{
+	fputc('"', f);
+	for (; s && *s; ++s)
+	{
+		const unsigned char c = (unsigned char)*s;
+		if (c == '"' || c == '\\') fprintf(f, "\\%c", c);
+		else if (c < 0x20) fprintf(f, "\\u%04x", c);
+		else fputc(c, f);
+	}
+	fputc('"', f);
+}
+
+static const char* GLString(GLenum name)
+{
+	const GLubyte* s = glGetString(name);
+	return s ? (const char*)s : "";
+}
+
+int RunHeadless(const HeadlessOptions& opts, HeadlessRenderFn render)
+{
+	if (!glGenFramebuffers_ptr || !glBindFramebuffer_ptr || !glGenRenderbuffers_ptr ||
+		!glBindRenderbuffer_ptr || !glRenderbufferStorage_ptr || !glFramebufferRenderbuffer_ptr ||
+		!glCheckFramebufferStatus_ptr)
+	{
+		fprintf(stderr, "headless: framebuffer objects not available\n");
+		return 1;
+	}
+
+	// Framebuffer offscreen: un renderbuffer RGBA8 del tamanio pedido.
+	GLuint fbo = 0, rbo = 0;
+	glGenRenderbuffers_ptr(1, &rbo);
+	glBindRenderbuffer_ptr(GL_RENDERBUFFER, rbo);
+	glRenderbufferStorage_ptr(GL_RENDERBUFFER, GL_RGBA8, opts.width, opts.height);
+	glGenFramebuffers_ptr(1, &fbo);
+	GLStateBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferRenderbuffer_ptr(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rbo);
+
+	if (glCheckFramebufferStatus_ptr(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		fprintf(stderr, "headless: framebuffer %dx%d incomplete\n", opts.width, opts.height);
+		GLStateBindFramebuffer(GL_FRAMEBUFFER, 0);
+		GLStateDeleteFramebuffer(fbo);
+		glDeleteRenderbuffers_ptr(1, &rbo);
+		return 1;
+	}
+
+	// Timer queries (opcionales: sin ellas se reporta solo CPU).
+	const bool gpuTiming = glGenQueries_ptr && glBeginQuery_ptr && glEndQuery_ptr && glGetQueryObjectui64v_ptr;
+	GLuint queries[kQueryRing] = {};
+	int queryFrame[kQueryRing];          // frame grabado en cada slot (-1 = libre)
+	for (int i = 0; i < kQueryRing; ++i) queryFrame[i] = -1;
+	if (gpuTiming) glGenQueries_ptr(kQueryRing, queries);
+
+	const int total = opts.warmupFrames + opts.frames;
+	std::vector<double> cpuMs((size_t)opts.frames, 0.0);
+	std::vector<double> gpuMs((size_t)opts.frames, 0.0);
+	std::vector<double> callsIssued((size_t)opts.frames, 0.0);
+	std::vector<double> callsElided((size_t)opts.frames, 0.0);
+
+	auto resolveSlot = [&](int slot)
+	{
+		if (queryFrame[slot] < 0) return;
+		GLuint64 ns = 0;
+		glGetQueryObjectui64v_ptr(queries[slot], GL_QUERY_RESULT, &ns);
+		const int recorded = queryFrame[slot] - opts.warmupFrames;
+		if (recorded >= 0) gpuMs[(size_t)recorded] = (double)ns * 1e-6;
+		queryFrame[slot] = -1;
+	};
+
+	const bool paced = opts.pacing.targetHz > 0.0;
+	FramePacer pacer;
+
+	// Con --input-synthetic la cola se consume como en la ventana; el "swap" es el fin del frame.
+	const bool input = InputRunning();
+	const bool lateInput = InputGetOptions().sample == InputSamplePoint::Late;
+
+	double wallStart = NowSeconds();
+	for (int frame = 0; frame < total; ++frame)
+	{
+		if (frame == opts.warmupFrames)
+		{
+			glFinish(); // que el warm-up no se cuele en el wall time
+			wallStart = NowSeconds();
+			if (paced) FramePacerInit(&pacer, opts.pacing); // el pacing se mide sin el warm-up
+		}
+		if (input && !lateInput) InputBeginTick();
+		if (paced && frame >= opts.warmupFrames) FramePacerWait(&pacer);
+		if (input && lateInput) InputBeginTick();
+
+		const double t = (double)frame * opts.dt;
+		const int slot = frame % kQueryRing;
+		if (gpuTiming) resolveSlot(slot);
+
+		GLStateBeginFrame();
+		ProfilerGpuBeginFrame();
+		PROFILE_ZONE("Frame");
+		const double c0 = NowSeconds();
+		RdFieldTick(4); // sin thread de simulacion: con --rd un tick (1x) por frame, dentro del tiempo medido
+		OdePlotTick(4); // idem con --ode
+		AgentsTick(4);  // y con --agents
+		if (gpuTiming) glBeginQuery_ptr(GL_TIME_ELAPSED, queries[slot]);
+		render(opts.width, opts.height, t);
+		if (gpuTiming)
+		{
+			glEndQuery_ptr(GL_TIME_ELAPSED);
+			queryFrame[slot] = frame;
+		}
+		CaptureFrame(opts.width, opts.height); // con --capture: la lectura entra en el tiempo medido
+		glFlush();
+		const double c1 = NowSeconds();
+		if (input) InputFramePresented(PlatformTicks(), InputConsumedEvents());
+		if (frame == 0)
+		{
+			glFinish(); // sin swap: el primer frame "se presenta" cuando la GPU lo termino
+			StartupFirstFrame();
+		}
+
+		if (frame >= opts.warmupFrames)
+		{
+			const size_t i = (size_t)(frame - opts.warmupFrames);
+			const GLStateCounters calls = GLStateFrameCounters();
+			cpuMs[i] = (c1 - c0) * 1e3;
+			callsIssued[i] = (double)calls.issued;
+			callsElided[i] = (double)calls.elided;
+		}
+	}
+	glFinish();
+	const double wallSeconds = NowSeconds() - wallStart;
+	CaptureFlush(); // fuera del wall time: lo que falte escribir no es costo del render
+
+	if (gpuTiming)
+	{
+		for (int i = 0; i < kQueryRing; ++i) resolveSlot(i);
+		glDeleteQueries_ptr(kQueryRing, queries);
+	}
+
+	// Golden: el ultimo frame contra el renderer de CPU con el mismo tiempo.
+	int exitCode = 0;
+	CpuImageDiff golden;
+	if (opts.golden)
+	{
+		const size_t bytes = (size_t)opts.width * (size_t)opts.height * 4;
+		std::vector<uint8_t> gpuImage(bytes);
+		std::vector<uint8_t> cpuImage(bytes);
+		glReadPixels(0, 0, opts.width, opts.height, GL_RGBA, GL_UNSIGNED_BYTE, gpuImage.data());
+		CpuRenderBackground(cpuImage.data(), opts.width, opts.height, (double)(total - 1) * opts.dt);
+		golden = CpuCompareImages(gpuImage.data(), cpuImage.data(), opts.width, opts.height, 8);
+		if (golden.psnr < opts.goldenMinPsnr) exitCode = 2;
+	}
+
+	GLStateBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateDeleteFramebuffer(fbo);
+	glDeleteRenderbuffers_ptr(1, &rbo);
+
+	// Reporte
+	FILE* out = opts.jsonPath ? fopen(opts.jsonPath, "w") : stdout;
+	if (!out)
+	{
+		fprintf(stderr, "headless: cannot write '%s'\n", opts.jsonPath);
+		return 1;
+	}
+
+	fprintf(out, "{\n  \"mode\": \"headless\",\n");
+	fprintf(out, "  \"platform\": ");
+	WriteJsonString(out, PlatformBackendName());
+	fprintf(out, ",\n");
+	fprintf(out, "  \"gl\": { \"vendor\": ");
+	WriteJsonString(out, GLString(GL_VENDOR));
+	fprintf(out, ", \"renderer\": ");
+	WriteJsonString(out, GLString(GL_RENDERER));
+	fprintf(out, ", \"version\": ");
+	WriteJsonString(out, GLString(GL_VERSION));
+	fprintf(out, " },\n");
+	fprintf(out, "  \"width\": %d,\n  \"height\": %d,\n  \"frames\": %d,\n  \"warmup_frames\": %d,\n  \"dt\": %.6f,\n",
+		opts.width, opts.height, opts.frames, opts.warmupFrames, opts.dt);
+	fprintf(out, "  \"wall_seconds\": %.4f,\n  \"fps\": %.2f,\n", wallSeconds, wallSeconds > 0.0 ? opts.frames / wallSeconds : 0.0);
+	fprintf(out, "  ");
+	WriteTimingSummaryJson(out, "cpu_ms", SummarizeTimings(cpuMs.data(), cpuMs.size()));
+	fprintf(out, ",\n  ");
+	if (gpuTiming) WriteTimingSummaryJson(out, "gpu_ms", SummarizeTimings(gpuMs.data(), gpuMs.size()));
+	else fprintf(out, "\"gpu_ms\": null");
+	fprintf(out, ",\n  \"gl_calls_per_frame\": { ");
+	WriteTimingSummaryJson(out, "issued", SummarizeTimings(callsIssued.data(), callsIssued.size()));
+	fprintf(out, ", ");
+	WriteTimingSummaryJson(out, "elided", SummarizeTimings(callsElided.data(), callsElided.size()));
+	fprintf(out, " }");
+	if (paced)
+	{
+		fprintf(out, ",\n  ");
+		WriteFramePacerJson(out, pacer);
+	}
+	fprintf(out, ",\n  ");
+	WriteShaderStatsJson(out);
+	fprintf(out, ",\n  ");
+	WriteDynResJson(out);
+	fprintf(out, ",\n  ");
+	WriteNoiseJson(out);
+	fprintf(out, ",\n  ");
+	WriteReactionDiffusionJson(out);
+	fprintf(out, ",\n  ");
+	WriteExprJson(out);
+	fprintf(out, ",\n  ");
+	WriteOdeJson(out);
+	fprintf(out, ",\n  ");
+	WriteAgentsJson(out);
+	fprintf(out, ",\n  ");
+	WriteCaptureJson(out);
+	fprintf(out, ",\n  ");
+	WriteStartupJson(out);
+	fprintf(out, ",\n  ");
+	WriteAssetsJson(out);
+	fprintf(out, ",\n  ");
+	WriteHudJson(out);
+	if (input)
+	{
+		fprintf(out, ",\n  ");
+		WriteInputJson(out);
+	}
+	const ShaderVariantStats variants = ShaderVariantsStats();
+	fprintf(out, ",\n  \"shader_variants\": { \"active\": \"%s\", \"switches\": %d, \"builds\": %d, \"failures\": %d }",
+		kShaderVariants[ShaderVariantsActive()].name, variants.switches, variants.builds, variants.failures);
+	if (opts.golden)
+	{
+		fprintf(out, ",\n  \"golden\": { \"max_channel_diff\": %d, \"pixels_over_tolerance\": %lld, \"psnr\": %.2f, \"pass\": %s }",
+			golden.maxChannelDiff, golden.pixelsOverTolerance, golden.psnr, exitCode == 0 ? "true" : "false");
+	}
+	fprintf(out, "\n}\n");
+
+	if (out != stdout) fclose(out);
+	return exitCode;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "frame_pacer.h"
+
+// ---------------------------
+// Modo headless (benchmark)
+// ---------------------------
+
+// Renderiza N frames con timestep fijo en un framebuffer offscreen (FBO), sin ventana visible
+// ni SwapBuffers, y reporta tiempos de CPU y GPU por frame (p50/p95/p99) y frames/s en JSON.
+// Pensado para CI: mismo resultado en cada corrida, sin depender de vsync ni del compositor.
+//
+// Uso: BioMath --headless [--frames N] [--warmup N] [--size WxH] [--dt s] [--json path]
+//              [--golden] [--golden-min-psnr dB] [--fps N] [--input-synthetic hz]
+//
+// Con --fps los frames se programan con el frame pacer (frame_pacer.h) y el JSON incluye el
+// error de scheduling por frame; sin --fps se renderiza lo mas rapido posible.
+
+struct HeadlessOptions
+{
+	bool enabled = false;
+	int width = 1280;
+	int height = 720;
+	int frames = 600;
+	int warmupFrames = 30;
+	double dt = 1.0 / 60.0;
+	const char* jsonPath = nullptr;  // nullptr = stdout
+
+	// Compara el ultimo frame contra el renderer de CPU (cpu_renderer.h).
+	bool golden = false;
+	double goldenMinPsnr = 30.0;
+
+	FramePacerOptions pacing;
+};
+
+// Dibuja un frame completo en el framebuffer que este bindeado (viewport, clear, draw).
+typedef void (*HeadlessRenderFn)(int width, int height, double timeSeconds);
+
+// Lee las opciones de la linea de comandos. opts->enabled queda en true si aparece --headless.
+void ParseHeadlessOptions(int argc, char** argv, HeadlessOptions* opts);
+
+// Requiere un contexto GL actual con el programa listo. Devuelve el exit code del proceso:
+// 0 = ok, 1 = no se pudo inicializar (FBO), 2 = la comparacion golden fallo.
+int RunHeadless(const HeadlessOptions& opts, HeadlessRenderFn render);
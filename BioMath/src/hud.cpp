@@ -0,0 +1,389 @@
+#include "hud.h"
+#include "assets.h"
+#include "frame_stats.h"
+#include "gl_state.h"
+#include "glyph_atlas.h"
+#include "parallel.h"
+#include "platform.h"
+#include "profiler.h"
+#include "shader_program.h"
+#include "stream_buffer.h"
+#include "text_layout.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Una instancia por glifo, el layout del vertex buffer: location 0 = (x, y, tamanio, glifo) en
+// floats, location 1 = color RGBA8 normalizado.
+struct HudGlyphInstance
+{
+	float x, y;
+	float size;
+	float glyph;
+	uint32_t color;
+};
+
+static_assert(sizeof(HudGlyphInstance) == 20, "the vertex layout is fixed");
+
+struct HudState
+{
+	HudOptions options;
+	bool active = false;
+	bool visible = true;
+
+	// Atlas (HudPrepare -> HudInit)
+	bool prepared = false;
+	const uint8_t* atlas = nullptr;   // al mapping del paquete o a 'baked'
+	std::vector<uint8_t> baked;
+	std::vector<uint8_t> packStorage; // solo si la entrada del paquete estaba comprimida
+	const char* atlasSource = "off";  // "baked" | "pack"
+	double bakeMs = 0.0;
+	int bakeThreads = 0;
+	double uploadMs = 0.0;
+
+	// Frame
+	TextLayoutCache layouts;
+	std::vector<HudGlyphInstance> instances;
+	uint64_t frames = 0;              // frames con draw
+	uint64_t glyphs = 0;
+	int maxGlyphs = 0;
+	uint64_t dropped = 0;
+	uint64_t texts = 0;
+	std::vector<double> buildMs;      // CPU del frame en HudText (layout + instancias)
+	std::vector<double> uploadFrameMs;
+	size_t sampleCount = 0;
+	uint64_t frameBuildTicks = 0;
+
+	// Render
+	GLuint program = 0;
+	GLint uViewport = -1;
+	GLint uGrid = -1;
+	GLint uAspect = -1;
+	GLuint texture = 0;
+	GLuint vaos[kStreamSegments] = {};
+	StreamBuffer stream;
+	uint64_t mapFailures = 0;
+};
+
+static HudState g_hud;
+
+void ParseHudOptions(int argc, char** argv, HudOptions* opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--hud") == 0) opts->enabled = true;
+		else if (strcmp(argv[i], "--no-hud") == 0) opts->enabled = false;
+		else if (strcmp(argv[i], "--hud-size") == 0 && i + 1 < argc) opts->size = (float)atof(argv[++i]);
+	}
+	if (!(opts->size >= 8.0f)) opts->size = 8.0f;
+	if (opts->size > 256.0f) opts->size = 256.0f;
+}
+
+static double MsSince(uint64_t startTicks)
+{
+	return (double)(PlatformTicks() - startTicks) * 1000.0 / (double)PlatformTickFrequency();
+}
+
+// El atlas del paquete montado: se verifica una muestra de glifos y se sube desde el mapping.
+static bool LoadFromPack()
+{
+	char name[64];
+	GlyphAtlasAssetName(name, sizeof(name));
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	if (!AssetsLoad(name, &data, &size, &g_hud.packStorage)) return false;
+	if (size != GlyphAtlasBytes() || GlyphAtlasVerify(data, 16) != 0)
+	{
+		fprintf(stderr, "hud: '%s' in the asset pack does not verify, ignoring it\n", name);
+		return false;
+	}
+	g_hud.atlas = data;
+	g_hud.atlasSource = "pack";
+	return true;
+}
+
+void HudPrepare(const HudOptions& opts)
+{
+	g_hud.options = opts;
+	g_hud.prepared = true;
+	g_hud.atlas = nullptr;
+	if (!opts.enabled) return;
+	PROFILE_ZONE("HudPrepare");
+
+	const uint64_t start = PlatformTicks();
+	if (!LoadFromPack())
+	{
+		g_hud.baked.resize(GlyphAtlasBytes());
+		GlyphAtlasBake(g_hud.baked.data());
+		g_hud.bakeThreads = ParallelThreadCount();
+		g_hud.atlas = g_hud.baked.data();
+		g_hud.atlasSource = "baked";
+	}
+	g_hud.bakeMs = MsSince(start);
+}
+
+static void ReleaseAtlas()
+{
+	g_hud.atlas = nullptr;
+	std::vector<uint8_t>().swap(g_hud.baked);
+	std::vector<uint8_t>().swap(g_hud.packStorage);
+}
+
+// Tambien despues de un hot reload (ShaderWatch).
+static void LocateUniforms(GLuint program)
+{
+	g_hud.uViewport = glGetUniformLocation_ptr(program, "uViewport");
+	g_hud.uGrid = glGetUniformLocation_ptr(program, "uGrid");
+	g_hud.uAspect = glGetUniformLocation_ptr(program, "uAspect");
+}
+
+static bool CreateGLObjects()
+{
+	ShaderFile file;
+	std::string error;
+	if (!ShaderFileLoad("hud.glsl", &file, &error))
+	{
+		fprintf(stderr, "hud: %s\n", error.c_str());
+		return false;
+	}
+	g_hud.program = ShaderBuildProgram(file, nullptr, &error);
+	if (!g_hud.program)
+	{
+		fprintf(stderr, "hud: shader failed:\n%s\n", error.c_str());
+		return false;
+	}
+	LocateUniforms(g_hud.program);
+	ShaderWatch("hud.glsl", file, nullptr, &g_hud.program, LocateUniforms);
+
+	{
+		PROFILE_ZONE("HudAtlasUpload");
+		const uint64_t start = PlatformTicks();
+		glGenTextures(1, &g_hud.texture);
+		GLStateBindTexture2D(0, g_hud.texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, kGlyphAtlasWidth, kGlyphAtlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, g_hud.atlas);
+		g_hud.uploadMs = MsSince(start);
+	}
+
+	// (x, y, tamanio, glifo) en location 0 y el color en location 1, los dos por instancia.
+	if (!StreamBufferInit(&g_hud.stream, GL_ARRAY_BUFFER, sizeof(HudGlyphInstance) * kHudMaxGlyphs))
+		return false;
+	for (int s = 0; s < g_hud.stream.segments; ++s)
+	{
+		const size_t base = StreamBufferSegmentOffset(g_hud.stream, s);
+		glGenVertexArrays_ptr(1, &g_hud.vaos[s]);
+		GLStateBindVertexArray(g_hud.vaos[s]);
+		GLStateBindBuffer(GL_ARRAY_BUFFER, g_hud.stream.buffer);
+		glEnableVertexAttribArray_ptr(0);
+		glVertexAttribPointer_ptr(0, 4, GL_FLOAT, GL_FALSE, sizeof(HudGlyphInstance), (void*)base);
+		glVertexAttribDivisor_ptr(0, 1);
+		glEnableVertexAttribArray_ptr(1);
+		glVertexAttribPointer_ptr(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(HudGlyphInstance),
+			(void*)(base + offsetof(HudGlyphInstance, color)));
+		glVertexAttribDivisor_ptr(1, 1);
+	}
+	GLStateBindVertexArray(0);
+	GLStateBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	const GLenum glError = glGetError();
+	if (glError != GL_NO_ERROR)
+	{
+		fprintf(stderr, "hud: atlas or instance buffer setup failed (0x%04X)\n", glError);
+		return false;
+	}
+	return true;
+}
+
+static void DeleteGLObjects()
+{
+	StreamBufferShutdown(&g_hud.stream);
+	for (GLuint& vao : g_hud.vaos)
+	{
+		GLStateDeleteVertexArray(vao);
+		vao = 0;
+	}
+	GLStateDeleteTexture(g_hud.texture);
+	g_hud.texture = 0;
+	ShaderUnwatch(&g_hud.program);
+	GLStateDeleteProgram(g_hud.program);
+	g_hud.program = 0;
+}
+
+bool HudInit(const HudOptions& opts)
+{
+	if (!g_hud.prepared) HudPrepare(opts);
+	g_hud.prepared = false;
+	g_hud.active = false;
+	if (!opts.enabled || !g_hud.atlas)
+	{
+		ReleaseAtlas();
+		return false;
+	}
+	if (!glDrawArraysInstanced_ptr || !glVertexAttribDivisor_ptr || !glMapBufferRange_ptr || !glUnmapBuffer_ptr)
+	{
+		fprintf(stderr, "hud: instanced drawing or glMapBufferRange not available, HUD disabled\n");
+		ReleaseAtlas();
+		return false;
+	}
+	PROFILE_ZONE("HudInit");
+
+	const bool ok = CreateGLObjects();
+	ReleaseAtlas(); // ya esta en la textura
+	if (!ok)
+	{
+		DeleteGLObjects();
+		return false;
+	}
+	g_hud.instances.reserve(kHudMaxGlyphs);
+	g_hud.buildMs.assign(kHudTimingSamples, 0.0);
+	g_hud.uploadFrameMs.assign(kHudTimingSamples, 0.0);
+	g_hud.active = true;
+	return true;
+}
+
+void HudShutdown()
+{
+	ReleaseAtlas(); // preparado y nunca subido (InitGL fallo antes)
+	DeleteGLObjects();
+	g_hud.active = false;
+}
+
+bool HudActive()
+{
+	return g_hud.active;
+}
+
+void HudSetVisible(bool visible)
+{
+	g_hud.visible = visible;
+}
+
+bool HudVisible()
+{
+	return g_hud.visible;
+}
+
+float HudTextSize()
+{
+	return g_hud.options.size;
+}
+
+float HudText(float x, float y, float size, uint32_t color, const char* text)
+{
+	if (!g_hud.active || !g_hud.visible) return 0.0f;
+	const uint64_t start = PlatformTicks();
+
+	const TextLayout& layout = TextLayoutCacheGet(&g_hud.layouts, text);
+	++g_hud.texts;
+	for (const TextGlyph& g : layout.glyphs)
+	{
+		if (g_hud.instances.size() >= (size_t)kHudMaxGlyphs)
+		{
+			++g_hud.dropped;
+			continue;
+		}
+		g_hud.instances.push_back({ x + g.x * size, y + g.y * size, size, (float)g.glyph, color });
+	}
+
+	g_hud.frameBuildTicks += PlatformTicks() - start;
+	return layout.width * size;
+}
+
+static void EndFrame(double uploadMs)
+{
+	const size_t sample = g_hud.sampleCount++ % kHudTimingSamples;
+	g_hud.buildMs[sample] = (double)g_hud.frameBuildTicks * 1000.0 / (double)PlatformTickFrequency();
+	g_hud.uploadFrameMs[sample] = uploadMs;
+	g_hud.frameBuildTicks = 0;
+	g_hud.instances.clear();
+	TextLayoutCacheEndFrame(&g_hud.layouts);
+}
+
+void HudDraw(int outputWidth, int outputHeight)
+{
+	if (!g_hud.active) return;
+	const int count = (int)g_hud.instances.size();
+	if (count == 0)
+	{
+		EndFrame(0.0);
+		return;
+	}
+
+	double uploadMs = 0.0;
+	{
+		PROFILE_ZONE("HudUpload");
+		const uint64_t t0 = PlatformTicks();
+		const size_t bytes = sizeof(HudGlyphInstance) * (size_t)count;
+		StreamWrite w;
+		bool ok = StreamBufferBegin(&g_hud.stream, &w);
+		if (ok)
+		{
+			memcpy(w.data, g_hud.instances.data(), bytes);
+			ok = StreamBufferEnd(&g_hud.stream, bytes);
+		}
+		uploadMs = MsSince(t0);
+		if (!ok)
+		{
+			++g_hud.mapFailures; // sin glifos este frame: dibujar el segmento viejo mostraria otro texto
+			EndFrame(uploadMs);
+			return;
+		}
+	}
+
+	PROFILE_GPU_ZONE("Hud");
+	const float w = (float)(outputWidth > 0 ? outputWidth : 1);
+	const float h = (float)(outputHeight > 0 ? outputHeight : 1);
+	GLStateViewport(0, 0, (GLsizei)w, (GLsizei)h);
+	GLStateUseProgram(g_hud.program);
+	GLStateUniform2f(g_hud.uViewport, 2.0f / w, 2.0f / h);
+	GLStateUniform2f(g_hud.uGrid, (float)kGlyphAtlasColumns, (float)kGlyphAtlasRows);
+	GLStateUniform1f(g_hud.uAspect, kGlyphAspect);
+	GLStateBindTexture2D(0, g_hud.texture);
+	GLStateBindVertexArray(g_hud.vaos[g_hud.stream.segment]);
+
+	// El blending solo lo usa este draw: se prende y se apaga aca (gl_state.h no lo sigue).
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	GLStateDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
+	glDisable(GL_BLEND);
+	StreamBufferFence(&g_hud.stream);
+
+	++g_hud.frames;
+	g_hud.glyphs += (uint64_t)count;
+	if (count > g_hud.maxGlyphs) g_hud.maxGlyphs = count;
+	EndFrame(uploadMs);
+}
+
+void WriteHudJson(FILE* f)
+{
+	if (!g_hud.active)
+	{
+		fprintf(f, "\"hud\": { \"enabled\": false }");
+		return;
+	}
+
+	const TextLayoutCache& c = g_hud.layouts;
+	fprintf(f, "\"hud\": { \"enabled\": true, \"size\": %.1f, \"atlas\": { \"source\": \"%s\", \"width\": %d, \"height\": %d, \"glyphs\": %d",
+		(double)g_hud.options.size, g_hud.atlasSource, kGlyphAtlasWidth, kGlyphAtlasHeight, kGlyphCount);
+	fprintf(f, ", \"prepare_ms\": %.3f, \"threads\": %d, \"upload_ms\": %.3f }", g_hud.bakeMs, g_hud.bakeThreads, g_hud.uploadMs);
+	fprintf(f, ", \"frames\": %llu, \"draws_per_frame\": 1, \"texts\": %llu, \"glyphs_per_frame\": %.1f, \"max_glyphs\": %d, \"dropped\": %llu",
+		(unsigned long long)g_hud.frames, (unsigned long long)g_hud.texts,
+		g_hud.frames ? (double)g_hud.glyphs / (double)g_hud.frames : 0.0, g_hud.maxGlyphs, (unsigned long long)g_hud.dropped);
+	fprintf(f, ", \"layout_cache\": { \"lookups\": %llu, \"hits\": %llu, \"hit_rate\": %.4f, \"entries\": %d, \"evictions\": %llu }",
+		(unsigned long long)c.lookups, (unsigned long long)c.hits, c.lookups ? (double)c.hits / (double)c.lookups : 0.0,
+		(int)c.entries.size(), (unsigned long long)c.evictions);
+	fprintf(f, ", \"map_failures\": %llu, ", (unsigned long long)g_hud.mapFailures);
+	const size_t samples = g_hud.sampleCount < kHudTimingSamples ? g_hud.sampleCount : kHudTimingSamples;
+	WriteTimingSummaryJson(f, "build_ms", SummarizeTimings(g_hud.buildMs.data(), samples));
+	fprintf(f, ", ");
+	WriteTimingSummaryJson(f, "upload_ms", SummarizeTimings(g_hud.uploadFrameMs.data(), samples));
+	fprintf(f, ", ");
+	WriteStreamBufferJson(f, g_hud.stream);
+	fprintf(f, " }");
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "gl_api.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+// ---------------------------
+// HUD de texto
+// ---------------------------
+
+// Texto encima del frame (metricas en vivo, parametros de la simulacion) con un solo draw por
+// frame, sin importar cuantos strings haya. Durante el frame se llama a HudText: el layout sale
+// del cache (text_layout.h; un string que no cambio no se vuelve a armar) y sus glifos se agregan
+// como instancias de 20 bytes (posicion, tamanio, indice en el atlas, color) a un buffer de CPU.
+// HudDraw copia ese buffer al segmento siguiente de un StreamBuffer (stream_buffer.h; un VAO por
+// segmento) y dibuja todo con un glDrawArraysInstanced: un quad de 4 vertices en strip por glifo,
+// armado con gl_VertexID en shaders/hud.glsl, que lee el atlas SDF (glyph_atlas.h) y pinta el
+// borde y un contorno oscuro con smoothstep. Blending premultiplicado, a la resolucion de salida,
+// despues de todo lo demas (tambien queda en las capturas).
+//
+// El atlas se hornea en la tarea de arranque "hud_atlas" (en paralelo) o, con --assets, se usa el
+// del paquete (BioMathPack --glyph-atlas) y se sube desde el mapping. Va en la unidad 0 como las
+// demas texturas: el sampler no necesita glUniform1i.
+//
+// Prendido en la ventana (F1 lo oculta y lo muestra) y apagado en headless salvo --hud; --golden
+// lo rechaza.
+
+struct HudOptions
+{
+	bool enabled = false;
+	float size = 24.0f;   // alto de la caja de cada glifo en pixels (la mayuscula es ~2/3)
+};
+
+static const int kHudMaxGlyphs = 8192;   // por frame; lo que sobra se descarta (y se cuenta)
+static const size_t kHudTimingSamples = 1 << 16;
+
+// --hud, --no-hud, --hud-size px
+void ParseHudOptions(int argc, char** argv, HudOptions* opts);
+
+// La parte de CPU de HudInit, sin GL: busca el atlas en el paquete de assets o lo hornea. Puede
+// correr en otro thread mientras se crea el contexto (startup.h).
+void HudPrepare(const HudOptions& opts);
+
+// Requiere contexto GL: sube el atlas y crea el programa y el buffer de instancias. Si falta algo
+// (instancing, glMapBufferRange) queda apagado y el motivo va a stderr.
+bool HudInit(const HudOptions& opts);
+void HudShutdown();
+bool HudActive();
+
+// F1. Oculto, HudText no agrega nada y HudDraw no dibuja.
+void HudSetVisible(bool visible);
+bool HudVisible();
+float HudTextSize();   // --hud-size
+
+// RGBA8 en el orden de memoria del atributo (r en el byte bajo).
+inline uint32_t HudColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255)
+{
+	return (uint32_t)r | (uint32_t)g << 8 | (uint32_t)b << 16 | (uint32_t)a << 24;
+}
+
+// Agrega 'text' con la esquina superior izquierda en (x, y), en pixels desde arriba a la izquierda
+// de la salida; 'size' = alto de la caja del glifo en pixels. Devuelve el ancho en pixels.
+float HudText(float x, float y, float size, uint32_t color, const char* text);
+
+// Sube las instancias del frame y las dibuja sobre lo que haya en el framebuffer bindeado. Una vez
+// por frame, al final.
+void HudDraw(int outputWidth, int outputHeight);
+
+// "hud": { ... } para los reportes JSON.
+void WriteHudJson(FILE* f);
@@ -0,0 +1,251 @@
+#include "image_file.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+// ---------------------------
+// Video (Y4M / raw)
+// ---------------------------
+
+struct VideoWriter
+{
+	FILE* file = nullptr;
+	VideoFormat format = VideoFormat::Y4m;
+	int width = 0;
+	int height = 0;
+	std::vector<uint8_t> planes;   // Y4M: Y, U y V del frame; raw: una fila
+	bool ok = true;
+};
+
+VideoWriter* VideoOpen(const char* path, VideoFormat format, int width, int height, double fps)
+{
+	if (width < 1 || height < 1) return nullptr;
+	FILE* f = fopen(path, "wb");
+	if (!f) return nullptr;
+
+	VideoWriter* video = new VideoWriter();
+	video->file = f;
+	video->format = format;
+	video->width = width;
+	video->height = height;
+	if (format == VideoFormat::Y4m)
+	{
+		// fps como racional: los enteros exactos, el resto en milesimas (59.94 -> 59940:1000).
+		const long num = fabs(fps - floor(fps + 0.5)) < 1e-9 ? (long)floor(fps + 0.5) : (long)floor(fps * 1000.0 + 0.5);
+		const long den = fabs(fps - floor(fps + 0.5)) < 1e-9 ? 1 : 1000;
+		video->ok = fprintf(f, "YUV4MPEG2 W%d H%d F%ld:%ld Ip A1:1 C420jpeg\n", width, height, num > 0 ? num : 60, num > 0 ? den : 1) > 0;
+		const size_t chromaW = (size_t)(width + 1) / 2, chromaH = (size_t)(height + 1) / 2;
+		video->planes.resize((size_t)width * (size_t)height + 2 * chromaW * chromaH);
+	}
+	else
+	{
+		video->planes.resize((size_t)width * 4);
+	}
+	return video;
+}
+
+// BT.601 rango limitado (16..235 / 16..240), en enteros como lo hace ffmpeg por defecto.
+static inline uint8_t LumaOf(int r, int g, int b)
+{
+	return (uint8_t)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+
+// Y4M 4:2:0: un U y un V por bloque de 2x2, del promedio del bloque (en los bordes impares, de lo
+// que haya).
+static void RgbaToI420(const uint8_t* rgba, ptrdiff_t stride, int width, int height, uint8_t* planes)
+{
+	const int chromaW = (width + 1) / 2, chromaH = (height + 1) / 2;
+	uint8_t* yPlane = planes;
+	uint8_t* uPlane = yPlane + (size_t)width * (size_t)height;
+	uint8_t* vPlane = uPlane + (size_t)chromaW * (size_t)chromaH;
+
+	for (int y = 0; y < height; ++y)
+	{
+		const uint8_t* row = rgba + stride * y;
+		uint8_t* dst = yPlane + (size_t)width * (size_t)y;
+		for (int x = 0; x < width; ++x)
+			dst[x] = LumaOf(row[4 * x], row[4 * x + 1], row[4 * x + 2]);
+	}
+
+	for (int cy = 0; cy < chromaH; ++cy)
+	{
+		const uint8_t* row0 = rgba + stride * (2 * cy);
+		const uint8_t* row1 = 2 * cy + 1 < height ? row0 + stride : row0;
+		for (int cx = 0; cx < chromaW; ++cx)
+		{
+			const int x0 = 2 * cx, x1 = x0 + 1 < width ? x0 + 1 : x0;
+			const int r = row0[4 * x0] + row0[4 * x1] + row1[4 * x0] + row1[4 * x1];
+			const int g = row0[4 * x0 + 1] + row0[4 * x1 + 1] + row1[4 * x0 + 1] + row1[4 * x1 + 1];
+			const int b = row0[4 * x0 + 2] + row0[4 * x1 + 2] + row1[4 * x0 + 2] + row1[4 * x1 + 2];
+			// Sumas de 4: el >> 10 en vez de >> 8 es el promedio.
+			uPlane[(size_t)chromaW * (size_t)cy + (size_t)cx] = (uint8_t)(((-38 * r - 74 * g + 112 * b + 512) >> 10) + 128);
+			vPlane[(size_t)chromaW * (size_t)cy + (size_t)cx] = (uint8_t)(((112 * r - 94 * g - 18 * b + 512) >> 10) + 128);
+		}
+	}
+}
+
+bool VideoWriteFrame(VideoWriter* video, const uint8_t* rgba, ptrdiff_t stride)
+{
+	if (!video || !video->ok) return false;
+
+	if (video->format == VideoFormat::Y4m)
+	{
+		RgbaToI420(rgba, stride, video->width, video->height, video->planes.data());
+		video->ok = fwrite("FRAME\n", 6, 1, video->file) == 1 &&
+			fwrite(video->planes.data(), video->planes.size(), 1, video->file) == 1;
+		return video->ok;
+	}
+
+	const size_t rowBytes = (size_t)video->width * 4;
+	for (int y = 0; y < video->height && video->ok; ++y)
+		video->ok = fwrite(rgba + stride * y, rowBytes, 1, video->file) == 1;
+	return video->ok;
+}
+
+bool VideoClose(VideoWriter* video)
+{
+	if (!video) return false;
+	bool ok = video->ok;
+	if (fclose(video->file) != 0) ok = false;
+	delete video;
+	return ok;
+}
+
+// ---------------------------
+// PNG
+// ---------------------------
+
+struct CrcTable
+{
+	uint32_t v[256];
+
+	CrcTable()
+	{
+		for (uint32_t n = 0; n < 256; ++n)
+		{
+			uint32_t c = n;
+			for (int k = 0; k < 8; ++k)
+				c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			v[n] = c;
+		}
+	}
+};
+
+static uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t n)
+{
+	static const CrcTable table;
+	crc = ~crc;
+	for (size_t i = 0; i < n; ++i)
+		crc = table.v[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+// Adler-32 del zlib: con 5552 bytes por tanda las sumas no pasan 2^32 antes del modulo.
+static uint32_t Adler32(uint32_t adler, const uint8_t* data, size_t n)
+{
+	uint32_t a = adler & 0xFFFF, b = adler >> 16;
+	while (n > 0)
+	{
+		const size_t chunk = n < 5552 ? n : 5552;
+		for (size_t i = 0; i < chunk; ++i)
+		{
+			a += data[i];
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+		data += chunk;
+		n -= chunk;
+	}
+	return (b << 16) | a;
+}
+
+static void PutBE32(uint8_t* p, uint32_t v)
+{
+	p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v;
+}
+
+static bool WriteChunk(FILE* f, const char* type, const uint8_t* data, size_t n)
+{
+	uint8_t head[8];
+	PutBE32(head, (uint32_t)n);
+	memcpy(head + 4, type, 4);
+	uint8_t tail[4];
+	PutBE32(tail, Crc32(Crc32(0, head + 4, 4), data, n));
+	return fwrite(head, 8, 1, f) == 1 && (n == 0 || fwrite(data, n, 1, f) == 1) && fwrite(tail, 4, 1, f) == 1;
+}
+
+bool PngWrite(const char* path, const uint8_t* rgba, int width, int height, ptrdiff_t stride)
+{
+	if (width < 1 || height < 1) return false;
+	// Datos sin comprimir: por fila, el byte de filtro (0 = ninguno) y la fila. Van directo a los
+	// bloques stored del deflate (de hasta 65535 bytes, cada uno con 5 bytes de header), entre el
+	// header del zlib (deflate, ventana de 32K, sin diccionario) y el Adler-32 de los datos.
+	const size_t rowBytes = (size_t)width * 4;
+	const size_t rawBytes = (rowBytes + 1) * (size_t)height;
+	const size_t blocks = (rawBytes + 65534) / 65535;
+	const size_t zlibBytes = 2 + rawBytes + 5 * blocks + 4;
+	if (zlibBytes > 0x7FFFFFFF) return false;   // un solo IDAT: el largo del chunk es de 31 bits
+
+	// El buffer se reusa entre llamadas del mismo thread (el writer de capturas escribe uno por frame).
+	thread_local std::vector<uint8_t> zlib;
+	zlib.resize(zlibBytes);
+	uint8_t* z = zlib.data();
+	z[0] = 0x78;
+	z[1] = 0x01;
+	for (size_t b = 0; b < blocks; ++b)
+	{
+		const size_t n = b + 1 < blocks ? 65535 : rawBytes - b * 65535;
+		uint8_t* h = z + 2 + b * (65535 + 5);
+		h[0] = b + 1 == blocks ? 1 : 0;   // BFINAL en el ultimo, BTYPE = 00 (stored)
+		h[1] = (uint8_t)n;
+		h[2] = (uint8_t)(n >> 8);
+		h[3] = (uint8_t)~n;
+		h[4] = (uint8_t)(~n >> 8);
+	}
+
+	// Copia 'n' bytes al flujo sin comprimir a partir de la posicion 'at', saltando los headers.
+	uint32_t adler = 1;
+	size_t at = 0;
+	auto put = [&](const uint8_t* src, size_t n)
+	{
+		adler = Adler32(adler, src, n);
+		while (n > 0)
+		{
+			const size_t block = at / 65535, inBlock = at % 65535;
+			const size_t take = n < 65535 - inBlock ? n : 65535 - inBlock;
+			memcpy(z + 2 + block * (65535 + 5) + 5 + inBlock, src, take);
+			src += take;
+			n -= take;
+			at += take;
+		}
+	};
+	static const uint8_t kFilterNone = 0;
+	for (int y = 0; y < height; ++y)
+	{
+		put(&kFilterNone, 1);
+		put(rgba + stride * y, rowBytes);
+	}
+	PutBE32(z + zlibBytes - 4, adler);
+
+	uint8_t ihdr[13];
+	PutBE32(ihdr, (uint32_t)width);
+	PutBE32(ihdr + 4, (uint32_t)height);
+	ihdr[8] = 8;    // bits por canal
+	ihdr[9] = 6;    // RGBA
+	ihdr[10] = 0;   // deflate
+	ihdr[11] = 0;   // filtros adaptativos (todos 0 aca)
+	ihdr[12] = 0;   // sin interlace
+
+	FILE* f = fopen(path, "wb");
+	if (!f) return false;
+	static const uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	bool ok = fwrite(kSignature, 8, 1, f) == 1 &&
+		WriteChunk(f, "IHDR", ihdr, sizeof(ihdr)) &&
+		WriteChunk(f, "IDAT", zlib.data(), zlib.size()) &&
+		WriteChunk(f, "IEND", nullptr, 0);
+	if (fclose(f) != 0) ok = false;
+	return ok;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ---------------------------
+// Imagenes y video sin comprimir
+// ---------------------------
+
+// Escritura de frames RGBA8 (capturas del render, frame_capture.h) en formatos que abre cualquier
+// herramienta sin dependencias de nuestro lado:
+//   - Y4M (YUV4MPEG2, 4:2:0, BT.601 rango limitado): ffmpeg, mpv y VLC lo leen directo y pesa 3/8
+//     de RGBA. La conversion a YUV pierde un poco: para comparar pixel a pixel usar raw o PNG.
+//   - Raw: los bytes RGBA de cada frame uno detras de otro, filas de arriba a abajo, sin header
+//     (ffmpeg -f rawvideo -pix_fmt rgba -s WxH).
+//   - PNG: un archivo por frame, RGBA sin perdida. El deflate va en bloques "stored" (sin
+//     comprimir): escribir es memcpy + CRC, y cualquier lector lo acepta.
+//
+// 'stride' es la distancia en bytes entre el comienzo de una fila y el de la siguiente (de arriba
+// a abajo); negativo para imagenes que vienen de abajo hacia arriba (glReadPixels): se pasa el
+// puntero a la ultima fila y -width * 4.
+
+enum class VideoFormat
+{
+	Y4m,
+	Raw,
+};
+
+struct VideoWriter;
+
+// nullptr si no se pudo crear el archivo. 'fps' va en el header del Y4M.
+VideoWriter* VideoOpen(const char* path, VideoFormat format, int width, int height, double fps);
+
+// Agrega un frame del tamanio de VideoOpen.
+bool VideoWriteFrame(VideoWriter* video, const uint8_t* rgba, ptrdiff_t stride);
+
+// Cierra. Devuelve false si algo fallo en el camino.
+bool VideoClose(VideoWriter* video);
+
+// Un PNG RGBA8. false si no se pudo escribir.
+bool PngWrite(const char* path, const uint8_t* rgba, int width, int height, ptrdiff_t stride);
@@ -0,0 +1,304 @@
+#include "input.h"
+#include "frame_stats.h"
+#include "profiler.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+struct InputPending
+{
+	uint64_t eventTicks;
+	uint64_t consumeTicks;
+	uint64_t sequence;     // numero de evento consumido (InputConsumedEvents antes de este)
+};
+
+static const int kInputPendingCapacity = kInputMaxTickEvents * 4;
+
+struct InputSystem
+{
+	InputOptions options;
+	bool running = false;
+	const char* backend = "none";
+
+	// Productor: el thread del backend (o el inyector). Consumidor: InputBeginTick.
+	SpscRing<PlatformInputEvent, kInputQueueCapacity> queue;
+	std::atomic<uint64_t> dropped{ 0 };
+
+	// Inyector sintetico
+	std::thread synthetic;
+	std::atomic<bool> syntheticRunning{ false };
+
+	// Tick actual
+	InputState state;
+	PlatformInputEvent tickEvents[kInputMaxTickEvents];
+	int tickEventCount = 0;
+	uint64_t ticks = 0;
+	uint64_t events = 0;
+	int maxTickEvents = 0;
+
+	// Eventos consumidos que todavia no llegaron a la pantalla. Productor: el tick (InputBeginTick),
+	// consumidor: el render (InputFramePresented); pueden ser threads distintos (simulation.h).
+	SpscRing<InputPending, kInputPendingCapacity> pending;
+	InputPending nextPending{};     // sacado del ring pero de un tick que todavia no se dibujo
+	bool hasNextPending = false;
+	std::atomic<uint64_t> pendingOverflow{ 0 };
+
+	// Latencias en ms (preasignadas en InputInit; las escribe el render)
+	std::vector<double> queueMs, frameMs, totalMs;
+	size_t samples = 0;
+};
+
+static InputSystem g_input;
+
+void ParseInputOptions(int argc, char** argv, InputOptions* opts)
+{
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--input-sample") == 0)
+			opts->sample = strcmp(argv[++i], "early") == 0 ? InputSamplePoint::Early : InputSamplePoint::Late;
+		else if (strcmp(argv[i], "--input-synthetic") == 0)
+			opts->syntheticHz = atof(argv[++i]);
+	}
+}
+
+// Callback de plataforma: corre en el thread del backend.
+static void PushEvent(void*, const PlatformInputEvent& ev)
+{
+	if (!g_input.queue.TryPush(ev))
+		g_input.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Eventos a intervalos pseudoaleatorios alrededor de 1/hz: F12 abajo/arriba y movimientos de mouse.
+// Ejercita la cola y la medicion de latencia sin dispositivos (CI, headless).
+static void SyntheticMain()
+{
+	ProfilerSetThreadName("InputSynthetic");
+	const double meanTicks = (double)PlatformTickFrequency() / g_input.options.syntheticHz;
+	uint32_t rng = 0x1234567u;
+	uint64_t next = PlatformTicks();
+	int phase = 0;
+
+	while (g_input.syntheticRunning.load(std::memory_order_acquire))
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		next += (uint64_t)(meanTicks * (0.5 + (double)(rng >> 8) / 16777216.0));
+		PlatformSleepUntil(next);
+
+		PlatformInputEvent ev;
+		ev.ticks = PlatformTicks();
+		switch (phase++ % 3)
+		{
+		case 0:
+			ev.type = PlatformInputType::KeyDown;
+			ev.code = (uint16_t)PlatformKey::F12;
+			break;
+		case 1:
+			ev.type = PlatformInputType::KeyUp;
+			ev.code = (uint16_t)PlatformKey::F12;
+			break;
+		default:
+			ev.type = PlatformInputType::MouseMove;
+			ev.x = (int32_t)(rng % 9) - 4;
+			ev.y = (int32_t)((rng >> 4) % 9) - 4;
+			break;
+		}
+		PushEvent(nullptr, ev);
+	}
+}
+
+bool InputInit(const InputOptions& opts)
+{
+	g_input.options = opts;
+	g_input.queueMs.assign(kInputLatencySamples, 0.0);
+	g_input.frameMs.assign(kInputLatencySamples, 0.0);
+	g_input.totalMs.assign(kInputLatencySamples, 0.0);
+
+	if (opts.syntheticHz > 0.0)
+	{
+		g_input.backend = "synthetic";
+		g_input.syntheticRunning.store(true, std::memory_order_release);
+		g_input.synthetic = std::thread(SyntheticMain);
+	}
+	else if (PlatformInputStart(PushEvent, nullptr))
+	{
+		g_input.backend = PlatformInputBackendName();
+	}
+	else
+	{
+		g_input.backend = "none";
+		return false;
+	}
+	g_input.running = true;
+	return true;
+}
+
+void InputShutdown()
+{
+	if (!g_input.running) return;
+	g_input.running = false;
+
+	if (g_input.synthetic.joinable())
+	{
+		g_input.syntheticRunning.store(false, std::memory_order_release);
+		g_input.synthetic.join();
+	}
+	else
+	{
+		PlatformInputStop();
+	}
+}
+
+bool InputRunning()
+{
+	return g_input.running;
+}
+
+const InputOptions& InputGetOptions()
+{
+	return g_input.options;
+}
+
+static void ApplyEvent(InputState& s, const PlatformInputEvent& ev)
+{
+	const int key = ev.code & 0xFF;
+	const int pad = ev.pad & 3;
+	switch (ev.type)
+	{
+	case PlatformInputType::KeyDown:
+		s.keys[key] = 1;
+		s.pressed[key] = 1;
+		break;
+	case PlatformInputType::KeyUp:
+		s.keys[key] = 0;
+		s.released[key] = 1;
+		break;
+	case PlatformInputType::MouseMove:
+		s.mouseDx += ev.x;
+		s.mouseDy += ev.y;
+		break;
+	case PlatformInputType::MouseButtonDown:
+		s.mouseButtons |= (uint8_t)(1u << (ev.code & 7));
+		break;
+	case PlatformInputType::MouseButtonUp:
+		s.mouseButtons &= (uint8_t)~(1u << (ev.code & 7));
+		break;
+	case PlatformInputType::MouseWheel:
+		s.wheel += ev.value;
+		break;
+	case PlatformInputType::GamepadButtonDown:
+		s.gamepadButtons[pad] |= (uint16_t)(1u << (ev.code & 15));
+		s.gamepadPressed[pad] |= (uint16_t)(1u << (ev.code & 15));
+		break;
+	case PlatformInputType::GamepadButtonUp:
+		s.gamepadButtons[pad] &= (uint16_t)~(1u << (ev.code & 15));
+		break;
+	case PlatformInputType::GamepadAxis:
+		if (ev.code < 6) s.gamepadAxes[pad][ev.code] = ev.value;
+		break;
+	case PlatformInputType::GamepadConnected:
+		s.gamepadConnected[pad] = true;
+		break;
+	case PlatformInputType::GamepadDisconnected:
+		s.gamepadConnected[pad] = false;
+		s.gamepadButtons[pad] = 0;
+		memset(s.gamepadAxes[pad], 0, sizeof(s.gamepadAxes[pad]));
+		break;
+	}
+}
+
+void InputBeginTick()
+{
+	PROFILE_ZONE("InputBeginTick");
+	InputState& s = g_input.state;
+
+	// Los flancos y deltas son del tick; el estado (teclas, botones, ejes) persiste.
+	memset(s.pressed, 0, sizeof(s.pressed));
+	memset(s.released, 0, sizeof(s.released));
+	memset(s.gamepadPressed, 0, sizeof(s.gamepadPressed));
+	s.mouseDx = 0;
+	s.mouseDy = 0;
+	s.wheel = 0.0f;
+
+	const uint64_t now = PlatformTicks();
+	int count = 0;
+	PlatformInputEvent ev;
+	while (count < kInputMaxTickEvents && g_input.queue.TryPop(&ev))
+	{
+		ApplyEvent(s, ev);
+		g_input.tickEvents[count++] = ev;
+
+		const InputPending p{ ev.ticks, now, g_input.events + (uint64_t)count - 1 };
+		if (!g_input.pending.TryPush(p))
+			g_input.pendingOverflow.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	g_input.tickEventCount = count;
+	g_input.events += (uint64_t)count;
+	if (count > g_input.maxTickEvents) g_input.maxTickEvents = count;
+	++g_input.ticks;
+}
+
+const InputState& InputGetState()
+{
+	return g_input.state;
+}
+
+int InputTickEvents(const PlatformInputEvent** events)
+{
+	*events = g_input.tickEvents;
+	return g_input.tickEventCount;
+}
+
+uint64_t InputConsumedEvents()
+{
+	return g_input.events;
+}
+
+void InputFramePresented(uint64_t presentTicks, uint64_t consumedEvents)
+{
+	const double tickMs = 1000.0 / (double)PlatformTickFrequency();
+	for (;;)
+	{
+		if (!g_input.hasNextPending && !g_input.pending.TryPop(&g_input.nextPending)) break;
+		g_input.hasNextPending = true;
+		const InputPending& p = g_input.nextPending;
+		if (p.sequence >= consumedEvents) break; // de un tick mas nuevo que el que se dibuja
+		g_input.hasNextPending = false;
+		if (g_input.samples >= (size_t)kInputLatencySamples) continue;
+
+		// evdev/raw input pueden fechar el evento un poco despues de que lo leimos (relojes con
+		// distinta granularidad): se recorta a 0.
+		const uint64_t eventTicks = p.eventTicks < p.consumeTicks ? p.eventTicks : p.consumeTicks;
+		const size_t n = g_input.samples++;
+		g_input.queueMs[n] = (double)(p.consumeTicks - eventTicks) * tickMs;
+		g_input.frameMs[n] = (double)(presentTicks - p.consumeTicks) * tickMs;
+		g_input.totalMs[n] = (double)(presentTicks - eventTicks) * tickMs;
+	}
+}
+
+void WriteInputJson(FILE* f)
+{
+	fprintf(f, "\"input\": { \"backend\": \"%s\", \"sample\": \"%s\", \"ticks\": %llu, \"events\": %llu, \"dropped\": %llu",
+		g_input.backend, g_input.options.sample == InputSamplePoint::Early ? "early" : "late",
+		(unsigned long long)g_input.ticks, (unsigned long long)g_input.events,
+		(unsigned long long)g_input.dropped.load(std::memory_order_relaxed));
+	fprintf(f, ", \"max_events_per_tick\": %d, \"latency_samples\": %llu, \"unmeasured\": %llu", g_input.maxTickEvents,
+		(unsigned long long)g_input.samples, (unsigned long long)g_input.pendingOverflow.load(std::memory_order_relaxed));
+	if (g_input.samples)
+	{
+		fprintf(f, ", \"latency_ms\": { ");
+		WriteTimingSummaryJson(f, "queue", SummarizeTimings(g_input.queueMs.data(), g_input.samples));
+		fprintf(f, ", ");
+		WriteTimingSummaryJson(f, "frame", SummarizeTimings(g_input.frameMs.data(), g_input.samples));
+		fprintf(f, ", ");
+		WriteTimingSummaryJson(f, "total", SummarizeTimings(g_input.totalMs.data(), g_input.samples));
+		fprintf(f, " }");
+	}
+	fprintf(f, " }");
+}
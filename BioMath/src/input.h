@@ -0,0 +1,91 @@
+#pragma once
+
+#include "platform.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+// ---------------------------
+// Entrada
+// ---------------------------
+
+// El backend de plataforma (o el inyector sintetico) produce PlatformInputEvent con timestamp en su
+// thread y los encola en un ring SPSC sin locks. Cada tick de simulacion (simulation.h) los consume
+// todos de una vez (InputBeginTick) y arma el estado del tick: teclas apretadas, flancos, mouse y
+// gamepad.
+//
+// Latencia input -> foto: InputFramePresented se llama justo antes de SwapBuffers (o al terminar el
+// frame en headless) con la cantidad de eventos que reflejan el snapshot dibujado. Para cada evento
+// consumido hasta ahi que no se midio todavia registra
+//
+//   queue = consumo - timestamp del evento   (cuanto espero en la cola hasta el tick)
+//   frame = swap - consumo                   (simulacion + render hasta el frame que lo refleja)
+//   total = swap - timestamp
+//
+// El tick y el render pueden ir en threads distintos: los consumos pasan al render por otro ring.
+//
+// --input-sample elige cuando se consume en el frame si el tick corre en el loop (headless,
+// --sim-inline): "late" (default) despues de la espera del frame pacer, justo antes de simular y
+// dibujar; "early" al principio del frame, antes de esperar.
+
+enum class InputSamplePoint
+{
+	Early,   // antes de FramePacerWait
+	Late,    // despues de FramePacerWait
+};
+
+struct InputOptions
+{
+	InputSamplePoint sample = InputSamplePoint::Late;
+	double syntheticHz = 0.0;   // > 0: inyecta eventos sinteticos (CI/headless) en vez del backend
+};
+
+static const int kInputQueueCapacity = 1024;
+static const int kInputMaxTickEvents = 256;   // eventos por tick; el resto queda para el siguiente
+static const int kInputLatencySamples = 65536;
+
+// --input-sample early|late, --input-synthetic hz
+void ParseInputOptions(int argc, char** argv, InputOptions* opts);
+
+// Arranca el backend de plataforma (requiere la ventana) o el inyector sintetico.
+bool InputInit(const InputOptions& opts);
+void InputShutdown();
+bool InputRunning();
+const InputOptions& InputGetOptions();
+
+// Estado armado por InputBeginTick.
+struct InputState
+{
+	uint8_t keys[256] = {};          // 1 = apretada, indexado por PlatformKey / ASCII
+	uint8_t pressed[256] = {};       // bajo en este tick
+	uint8_t released[256] = {};      // subio en este tick
+	uint8_t mouseButtons = 0;        // bit n = boton n
+	int32_t mouseDx = 0;             // desplazamiento acumulado en el tick
+	int32_t mouseDy = 0;
+	float wheel = 0.0f;
+	uint16_t gamepadButtons[4] = {}; // bits de PlatformGamepadButton
+	uint16_t gamepadPressed[4] = {};
+	float gamepadAxes[4][6] = {};
+	bool gamepadConnected[4] = {};
+};
+
+// Consume la cola (hasta kInputMaxTickEvents) y actualiza el estado. Una vez por tick, siempre desde
+// el mismo thread.
+void InputBeginTick();
+const InputState& InputGetState();
+
+// Eventos consumidos en el ultimo tick, en orden de llegada.
+int InputTickEvents(const PlatformInputEvent** events);
+
+inline bool InputKeyPressed(const InputState& s, PlatformKey key) { return s.pressed[(uint16_t)key & 0xFF] != 0; }
+inline bool InputKeyDown(const InputState& s, PlatformKey key) { return s.keys[(uint16_t)key & 0xFF] != 0; }
+
+// Eventos consumidos hasta el ultimo tick (del thread de InputBeginTick; va en el snapshot).
+uint64_t InputConsumedEvents();
+
+// Justo antes de SwapBuffers, desde un solo thread: cierra la latencia de los eventos
+// [0, consumedEvents) que no se habian medido.
+void InputFramePresented(uint64_t presentTicks, uint64_t consumedEvents);
+
+// "input": { ... } para los reportes JSON.
+void WriteInputJson(FILE* f);
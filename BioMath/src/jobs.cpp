@@ -0,0 +1,346 @@
+#include "jobs.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+// Slots de deque: los workers ocupan los primeros; los threads externos toman uno libre en su
+// primer envio y lo sueltan al terminar. Sin slot libre, los envios de ese thread corren inline.
+static const int kJobSlots = 64;
+static const int kJobDequeSize = 1024;      // jobs pendientes por thread (potencia de 2)
+static const int kJobIdleSpins = 64;        // intentos de robo antes de dormir
+
+// Deque Chase-Lev de tamanio fijo (Le, Pop, Cohen, Zappa Nardelli, "Correct and Efficient
+// Work-Stealing for Weak Memory Models", 2013). El duenio usa Push/Pop por abajo, los ladrones
+// Steal por arriba; el unico conflicto (el ultimo elemento) se resuelve con un CAS sobre top.
+struct JobDeque
+{
+	alignas(64) std::atomic<int64_t> top{ 0 };
+	alignas(64) std::atomic<int64_t> bottom{ 0 };
+	std::atomic<bool> used{ false };
+	std::atomic<Job*> slots[kJobDequeSize];
+
+	bool Push(Job* job)
+	{
+		const int64_t b = bottom.load(std::memory_order_relaxed);
+		const int64_t t = top.load(std::memory_order_acquire);
+		if (b - t >= kJobDequeSize) return false;
+		slots[b & (kJobDequeSize - 1)].store(job, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	Job* Pop()
+	{
+		const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_relaxed);
+		if (t > b)
+		{
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		Job* job = slots[b & (kJobDequeSize - 1)].load(std::memory_order_relaxed);
+		if (t == b)
+		{
+			// Ultimo elemento: compite con los ladrones.
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				job = nullptr;
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+
+	Job* Steal()
+	{
+		int64_t t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t b = bottom.load(std::memory_order_acquire);
+		if (t >= b) return nullptr;
+		Job* job = slots[t & (kJobDequeSize - 1)].load(std::memory_order_relaxed);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;   // otro ladron (o el duenio) se lo llevo
+		return job;
+	}
+};
+
+struct JobSystem
+{
+	JobDeque deques[kJobSlots];
+	std::atomic<int> slotCount{ 0 };          // slots [0, slotCount) alguna vez usados (donde robar)
+	std::vector<std::thread> workers;
+	std::once_flag started;
+
+	// Dormir: un worker sin trabajo anota el epoch, se suma a 'sleepers', mira una vez mas y duerme
+	// hasta que el epoch cambie. Cada envio incrementa el epoch y despierta solo si hay alguien
+	// durmiendo, asi que el camino comun no toca el mutex.
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+	std::condition_variable park;             // workers fuera del limite de threads
+	std::atomic<unsigned> epoch{ 0 };
+	std::atomic<int> sleepers{ 0 };
+	std::atomic<int> threadLimit{ 0 };
+	std::atomic<bool> quit{ false };
+
+	std::atomic<unsigned long long> submitted{ 0 };
+	std::atomic<unsigned long long> inlined{ 0 };
+	std::atomic<unsigned long long> stolen{ 0 };
+	std::atomic<unsigned long long> sleeps{ 0 };
+
+	~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			quit.store(true);
+		}
+		wake.notify_all();
+		park.notify_all();
+		for (std::thread& t : workers)
+			t.join();
+	}
+};
+
+static JobSystem& Jobs()
+{
+	static JobSystem s_jobs;
+	return s_jobs;
+}
+
+// Slot del thread actual (-1: todavia no tiene, o no habia libres).
+struct JobThreadSlot
+{
+	int index = -1;
+	bool tried = false;
+	uint32_t rng = 0;
+
+	~JobThreadSlot()
+	{
+		if (index >= 0) Jobs().deques[index].used.store(false, std::memory_order_release);
+	}
+};
+
+static thread_local JobThreadSlot t_slot;
+
+static int ClaimSlot(JobSystem& s, int first)
+{
+	for (int i = first; i < kJobSlots; ++i)
+	{
+		bool expected = false;
+		if (s.deques[i].used.compare_exchange_strong(expected, true, std::memory_order_acquire))
+		{
+			int count = s.slotCount.load(std::memory_order_relaxed);
+			while (count < i + 1 && !s.slotCount.compare_exchange_weak(count, i + 1, std::memory_order_release))
+			{
+			}
+			return i;
+		}
+	}
+	return -1;
+}
+
+static int ThreadSlot(JobSystem& s)
+{
+	if (!t_slot.tried)
+	{
+		t_slot.tried = true;
+		t_slot.index = ClaimSlot(s, (int)s.workers.size());
+	}
+	return t_slot.index;
+}
+
+static bool WorkerAllowed(const JobSystem& s, int worker)
+{
+	const int limit = s.threadLimit.load(std::memory_order_relaxed);
+	return limit <= 0 || worker + 1 < limit;
+}
+
+static void Execute(Job* job)
+{
+	// Despues del fetch_sub el Job y el contador pueden dejar de existir.
+	JobCounter* counter = job->counter;
+	job->fn(job->ctx);
+	counter->pending.fetch_sub(1, std::memory_order_release);
+}
+
+// Lo proximo para correr: la deque propia (LIFO) y si esta vacia, robar de otro slot empezando
+// por uno al azar.
+static Job* FindWork(JobSystem& s, int self)
+{
+	if (self >= 0)
+	{
+		if (Job* job = s.deques[self].Pop()) return job;
+	}
+
+	const int count = s.slotCount.load(std::memory_order_acquire);
+	if (count <= 0) return nullptr;
+	uint32_t& r = t_slot.rng;
+	if (r == 0) r = 0x9E3779B9u ^ (uint32_t)(uintptr_t)&t_slot;
+	r ^= r << 13;
+	r ^= r >> 17;
+	r ^= r << 5;
+	const int start = (int)(r % (uint32_t)count);
+	for (int k = 0; k < count; ++k)
+	{
+		int victim = start + k;
+		if (victim >= count) victim -= count;
+		if (victim == self) continue;
+		if (Job* job = s.deques[victim].Steal())
+		{
+			s.stolen.fetch_add(1, std::memory_order_relaxed);
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+static void WorkerMain(JobSystem* s, int index)
+{
+	t_slot.index = index;
+	t_slot.tried = true;
+
+	int idle = 0;
+	for (;;)
+	{
+		if (s->quit.load(std::memory_order_acquire)) return;
+
+		if (!WorkerAllowed(*s, index))
+		{
+			std::unique_lock<std::mutex> lock(s->sleepMutex);
+			s->park.wait(lock, [&] { return s->quit.load() || WorkerAllowed(*s, index); });
+			continue;
+		}
+
+		if (Job* job = FindWork(*s, index))
+		{
+			Execute(job);
+			idle = 0;
+			continue;
+		}
+		if (++idle < kJobIdleSpins)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		idle = 0;
+
+		const unsigned seen = s->epoch.load();
+		s->sleepers.fetch_add(1);
+		if (Job* job = FindWork(*s, index))
+		{
+			s->sleepers.fetch_sub(1);
+			Execute(job);
+			continue;
+		}
+		{
+			std::unique_lock<std::mutex> lock(s->sleepMutex);
+			s->sleeps.fetch_add(1, std::memory_order_relaxed);
+			s->wake.wait(lock, [&] { return s->quit.load() || s->epoch.load() != seen || !WorkerAllowed(*s, index); });
+		}
+		s->sleepers.fetch_sub(1);
+	}
+}
+
+void JobStartWorkers(int count)
+{
+	JobSystem& s = Jobs();
+	std::call_once(s.started, [&]
+	{
+		if (count < 0)
+		{
+			const unsigned hc = std::thread::hardware_concurrency();
+			count = hc > 1 ? (int)hc - 1 : 0;
+		}
+		if (count > kJobSlots / 2) count = kJobSlots / 2;   // el resto queda para threads externos
+		for (int i = 0; i < count; ++i)
+			ClaimSlot(s, i);
+		for (int i = 0; i < count; ++i)
+			s.workers.emplace_back(WorkerMain, &s, i);
+	});
+}
+
+void JobSubmit(Job* job, JobCounter* counter)
+{
+	JobSystem& s = Jobs();
+	JobStartWorkers(-1);
+	job->counter = counter;
+	s.submitted.fetch_add(1, std::memory_order_relaxed);
+
+	const int self = JobThreadCount() > 1 ? ThreadSlot(s) : -1;
+	if (self < 0)
+	{
+		s.inlined.fetch_add(1, std::memory_order_relaxed);
+		job->fn(job->ctx);
+		return;
+	}
+
+	// El contador sube antes de publicar el job: un ladron puede terminarlo enseguida.
+	counter->pending.fetch_add(1, std::memory_order_relaxed);
+	if (!s.deques[self].Push(job))
+	{
+		s.inlined.fetch_add(1, std::memory_order_relaxed);
+		Execute(job);
+		return;
+	}
+
+	s.epoch.fetch_add(1);
+	if (s.sleepers.load() > 0)
+	{
+		std::lock_guard<std::mutex> lock(s.sleepMutex);
+		s.wake.notify_all();
+	}
+}
+
+void JobWait(JobCounter* counter)
+{
+	JobSystem& s = Jobs();
+	if (counter->pending.load(std::memory_order_acquire) <= 0) return;
+
+	const int self = ThreadSlot(s);
+	while (counter->pending.load(std::memory_order_acquire) > 0)
+	{
+		if (Job* job = FindWork(s, self))
+			Execute(job);
+		else
+			std::this_thread::yield();   // lo que falta lo esta corriendo otro thread
+	}
+}
+
+bool JobDone(const JobCounter* counter)
+{
+	return counter->pending.load(std::memory_order_acquire) <= 0;
+}
+
+int JobThreadCount()
+{
+	JobSystem& s = Jobs();
+	JobStartWorkers(-1);
+	const int all = (int)s.workers.size() + 1;
+	const int limit = s.threadLimit.load(std::memory_order_relaxed);
+	return (limit > 0 && limit < all) ? limit : all;
+}
+
+void JobSetThreadLimit(int maxThreads)
+{
+	JobSystem& s = Jobs();
+	{
+		std::lock_guard<std::mutex> lock(s.sleepMutex);
+		s.threadLimit.store(maxThreads > 0 ? maxThreads : 0);
+	}
+	s.wake.notify_all();
+	s.park.notify_all();
+}
+
+JobStats JobGetStats()
+{
+	JobSystem& s = Jobs();
+	JobStats stats;
+	stats.submitted = s.submitted.load(std::memory_order_relaxed);
+	stats.inlined = s.inlined.load(std::memory_order_relaxed);
+	stats.stolen = s.stolen.load(std::memory_order_relaxed);
+	stats.sleeps = s.sleeps.load(std::memory_order_relaxed);
+	return stats;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+
+// ---------------------------
+// Jobs
+// ---------------------------
+
+// Scheduler de tareas con robo de trabajo, compartido por todo lo que quiera usar mas de un core
+// (ParallelFor esta encima de esto: simulaciones, horneado de ruido, renderer de CPU, VM de
+// expresiones).
+//
+// Cada worker, y cada thread externo que envia trabajo (el principal, el de simulacion, los del
+// arranque), tiene una deque Chase-Lev propia: el duenio apila y desapila por abajo sin locks
+// (LIFO, lo que acaba de partir sigue caliente en cache) y los demas roban por arriba (FIFO, los
+// pedazos mas grandes). Hay hardware_concurrency() - 1 workers; cuando no encuentran nada que
+// robar giran un rato y despues duermen hasta el proximo envio.
+//
+// Padre/hijo: cada job descuenta su JobCounter al terminar. Un job (o cualquier thread) que parte
+// trabajo envia los hijos con un contador propio y JobWait sobre ese contador; mientras espera no
+// duerme, corre sus propios hijos o roba de otros ("help while waiting"). Asi un job puede
+// esperar a sus hijos adentro de un worker sin bloquearlo y el anidamiento no tiene limite.
+//
+// Reglas:
+//   - El Job y el JobCounter son del que envia (en su stack, normalmente) y tienen que vivir hasta
+//     que JobWait vuelve.
+//   - Un job no puede bloquearse esperando algo que no sea un JobCounter (un mutex que tenga otro
+//     job, E/S): el que espera a ese job podria estar corriendolo. Las tareas de E/S del arranque
+//     tienen sus propios threads (startup.h).
+//   - Mientras espera, un thread puede correr cualquier job, incluso otro pedazo del mismo
+//     ParallelFor en el que esta metido. Un job que envia hijos no puede contar con que su estado
+//     thread_local siga intacto despues de JobWait.
+//   - El thread de audio no envia jobs: su bloque tiene plazo fijo y no puede quedar esperando a
+//     un worker que el sistema saco de la CPU.
+//
+// Uso:
+//   JobCounter children;
+//   Job jobs[2] = { { LeftFn, &left }, { RightFn, &right } };
+//   JobSubmit(&jobs[0], &children);
+//   JobSubmit(&jobs[1], &children);
+//   JobWait(&children);
+
+typedef void (*JobFn)(void* ctx);
+
+struct JobCounter
+{
+	std::atomic<int> pending{ 0 };   // jobs enviados con este contador que todavia no terminaron
+};
+
+struct Job
+{
+	JobFn fn = nullptr;
+	void* ctx = nullptr;
+	JobCounter* counter = nullptr;   // lo completa JobSubmit
+};
+
+// Encola 'job' en la deque del thread que llama y suma uno a 'counter'. Sin workers (un solo
+// core, o JobSetThreadLimit(1)) o con la deque llena, el job corre aca mismo antes de volver.
+void JobSubmit(Job* job, JobCounter* counter);
+
+// Vuelve cuando todos los jobs de 'counter' terminaron. Mientras tanto corre jobs: primero los
+// de la deque propia, despues robados.
+void JobWait(JobCounter* counter);
+
+// true si todos los jobs de 'counter' terminaron (sin esperar).
+bool JobDone(const JobCounter* counter);
+
+// Crea los workers (count < 0: hardware_concurrency() - 1). Solo la primera llamada cuenta, y
+// el primer JobSubmit la hace con el default si nadie la hizo antes. Para benchmarks que quieren
+// mas workers que cores.
+void JobStartWorkers(int count);
+
+// Cantidad de threads que pueden correr jobs de un envio: los workers + el que espera.
+int JobThreadCount();
+
+// Limita los workers que roban (0 = todos): con n, roban los primeros n - 1. Para benchmarks de
+// escalado por cantidad de cores.
+void JobSetThreadLimit(int maxThreads);
+
+// Estadisticas acumuladas desde el arranque (contadores relajados, aproximados mientras corren).
+struct JobStats
+{
+	unsigned long long submitted = 0;
+	unsigned long long inlined = 0;   // corrieron en JobSubmit (sin workers o deque llena)
+	unsigned long long stolen = 0;
+	unsigned long long sleeps = 0;    // veces que un worker se durmio sin trabajo
+};
+
+JobStats JobGetStats();
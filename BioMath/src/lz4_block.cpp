@@ -0,0 +1,174 @@
+#include "lz4_block.h"
+
+#include <string.h>
+#include <vector>
+
+// Constantes del formato: un match mide al menos 4 bytes, los ultimos 5 bytes son siempre
+// literales y el ultimo match empieza a mas de 12 bytes del final (el decodificador de referencia
+// copia de a 8 bytes y cuenta con ese margen).
+static const size_t kMinMatch = 4;
+static const size_t kLastLiterals = 5;
+static const size_t kMatchFindLimit = 12;
+static const size_t kMaxOffset = 65535;
+static const int kHashBits = 16;
+
+size_t Lz4CompressBound(size_t bytes)
+{
+	return bytes + bytes / 255 + 16;
+}
+
+static uint32_t Read32(const uint8_t* p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static uint32_t Hash4(uint32_t v)
+{
+	return (v * 2654435761u) >> (32 - kHashBits);
+}
+
+// Bytes de extension de un largo (el token guarda hasta 15; lo que pasa de ahi va en 255, 255, ..., resto).
+static uint8_t* WriteLength(uint8_t* op, size_t length)
+{
+	while (length >= 255)
+	{
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (uint8_t)length;
+	return op;
+}
+
+// Una secuencia: token, literales y, salvo en la ultima (matchBytes = 0), offset y largo del match.
+static uint8_t* WriteSequence(uint8_t* op, const uint8_t* literals, size_t literalBytes, size_t offset, size_t matchBytes)
+{
+	uint8_t* token = op++;
+	*token = (uint8_t)((literalBytes < 15 ? literalBytes : 15) << 4);
+	if (literalBytes >= 15) op = WriteLength(op, literalBytes - 15);
+	memcpy(op, literals, literalBytes);
+	op += literalBytes;
+	if (matchBytes == 0) return op;
+
+	op[0] = (uint8_t)offset;
+	op[1] = (uint8_t)(offset >> 8);
+	op += 2;
+	const size_t extra = matchBytes - kMinMatch;
+	*token |= (uint8_t)(extra < 15 ? extra : 15);
+	if (extra >= 15) op = WriteLength(op, extra - 15);
+	return op;
+}
+
+size_t Lz4Compress(const uint8_t* src, size_t bytes, uint8_t* dst, size_t capacity)
+{
+	if (bytes > kLz4MaxInput || capacity < Lz4CompressBound(bytes)) return 0;
+
+	uint8_t* op = dst;
+	size_t anchor = 0;   // primer byte todavia no emitido
+	if (bytes > kMatchFindLimit)
+	{
+		// Ultima posicion vista de cada hash de 4 bytes.
+		std::vector<uint32_t> table((size_t)1 << kHashBits, UINT32_MAX);
+		const size_t lastMatchStart = bytes - kMatchFindLimit;
+		const size_t matchEndLimit = bytes - kLastLiterals;
+
+		size_t ip = 0;
+		while (ip <= lastMatchStart)
+		{
+			const uint32_t sequence = Read32(src + ip);
+			const uint32_t h = Hash4(sequence);
+			const uint32_t candidate = table[h];
+			table[h] = (uint32_t)ip;
+			if (candidate == UINT32_MAX || ip - candidate > kMaxOffset || Read32(src + candidate) != sequence)
+			{
+				++ip;
+				continue;
+			}
+
+			// Se extiende hacia atras (sobre los literales pendientes) y hacia adelante.
+			size_t start = ip;
+			size_t from = candidate;
+			while (start > anchor && from > 0 && src[start - 1] == src[from - 1])
+			{
+				--start;
+				--from;
+			}
+			size_t end = ip + kMinMatch;
+			while (end < matchEndLimit && src[end] == src[from + (end - start)])
+				++end;
+
+			op = WriteSequence(op, src + anchor, start - anchor, start - from, end - start);
+			table[Hash4(Read32(src + end - 2))] = (uint32_t)(end - 2);
+			ip = anchor = end;
+		}
+	}
+	op = WriteSequence(op, src + anchor, bytes - anchor, 0, 0);
+	return (size_t)(op - dst);
+}
+
+static bool ReadLength(const uint8_t* src, size_t srcBytes, size_t* s, size_t* length)
+{
+	uint8_t b;
+	do
+	{
+		if (*s >= srcBytes) return false;
+		b = src[(*s)++];
+		*length += b;
+	} while (b == 255);
+	return true;
+}
+
+bool Lz4Decompress(const uint8_t* src, size_t srcBytes, uint8_t* dst, size_t dstBytes)
+{
+	size_t s = 0;
+	size_t d = 0;
+	for (;;)
+	{
+		if (s >= srcBytes) return false;
+		const uint8_t token = src[s++];
+
+		size_t literals = token >> 4;
+		if (literals == 15 && !ReadLength(src, srcBytes, &s, &literals)) return false;
+		if (literals > srcBytes - s || literals > dstBytes - d) return false;
+		// Las secuencias cortas son la mayoria: una copia fija de 16 bytes (lo que sobra lo pisa la
+		// secuencia siguiente) cuando hay lugar en los dos buffers.
+		if (literals <= 16 && srcBytes - s >= 16 && dstBytes - d >= 16)
+			memcpy(dst + d, src + s, 16);
+		else
+			memcpy(dst + d, src + s, literals);
+		s += literals;
+		d += literals;
+		if (s == srcBytes) return d == dstBytes;   // la ultima secuencia no tiene match
+
+		if (srcBytes - s < 2) return false;
+		const size_t offset = (size_t)src[s] | (size_t)src[s + 1] << 8;
+		s += 2;
+		if (offset == 0 || offset > d) return false;
+
+		size_t match = token & 15;
+		if (match == 15 && !ReadLength(src, srcBytes, &s, &match)) return false;
+		match += kMinMatch;
+		if (match > dstBytes - d) return false;
+
+		// Con offset < largo el match se solapa con lo que escribe (repeticiones): byte a byte.
+		uint8_t* out = dst + d;
+		const uint8_t* in = out - offset;
+		if (offset >= 16 && match <= 32 && dstBytes - d >= 32)
+		{
+			// Cada bloque de 16 lee solo bytes ya escritos (offset >= 16).
+			memcpy(out, in, 16);
+			memcpy(out + 16, in + 16, 16);
+		}
+		else if (offset >= match)
+		{
+			memcpy(out, in, match);
+		}
+		else
+		{
+			for (size_t i = 0; i < match; ++i)
+				out[i] = in[i];
+		}
+		d += match;
+	}
+}
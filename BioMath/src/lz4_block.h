@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ---------------------------
+// LZ4 (formato de bloque)
+// ---------------------------
+
+// Compresor y descompresor del formato de bloque de LZ4 (el de LZ4_compress_default /
+// LZ4_decompress_safe, sin el frame): secuencias de token + literales + offset de 16 bits + largo
+// del match. Lo que escribe Lz4Compress lo lee cualquier LZ4, y al reves.
+//
+// El compresor es el greedy de una sola tabla de hash de 4 bytes (el "fast" de referencia sin
+// aceleracion): pensado para el empaquetador offline, no para tiempo real. El descompresor valida
+// todo contra los dos tamanios, asi que un bloque corrupto da false y nunca escribe ni lee afuera.
+
+// Entradas mas grandes que esto no se comprimen (el limite del formato de referencia).
+static const size_t kLz4MaxInput = 0x7E000000;
+
+// Peor caso de Lz4Compress para 'bytes' de entrada (datos incomprimibles).
+size_t Lz4CompressBound(size_t bytes);
+
+// Comprime 'src' en 'dst', que tiene que tener al menos Lz4CompressBound(bytes). Devuelve los
+// bytes escritos, o 0 si bytes > kLz4MaxInput o no entra.
+size_t Lz4Compress(const uint8_t* src, size_t bytes, uint8_t* dst, size_t capacity);
+
+// Descomprime un bloque de 'srcBytes' que tiene que dar exactamente 'dstBytes'. false si el bloque
+// es invalido o no da ese tamanio.
+bool Lz4Decompress(const uint8_t* src, size_t srcBytes, uint8_t* dst, size_t dstBytes);
@@ -7,164 +7,47 @@
 // especfica. Funciona como un "puerto" o hilo de ejecucin activo, obligatorio para que los comandos 
 // de la GPU surtan efecto en una ventana especfica, siguiendo reglas estrictas de un contexto por hilo.
 
-#define WIN32_LEAN_AND_MEAN //Minimal basic WinApi
-#include <windows.h>
-#include <malloc.h>
-#include <gl/GL.h>
-
-#pragma comment(lib, "opengl32.lib")
-
-// ----------------------------
-// Declaraciones GL/WGL minimas
-// ----------------------------
-
-// Construccin manual de tipos bsicos de OpenGL
-
-typedef char GLchar;
-typedef ptrdiff_t GLsizeiptr;
-
-// Constantes simblicas de OpenGL.
-
-#define GL_ARRAY_BUFFER 0x8892 // 0x8892 Un valor entero nico que el estndar OpenGL asigna al concepto array buffer. (Vertex data).
-#define GL_STATIC_DRAW 0x88E4 // Pista (sugerencia) sobre como se va a usar el buffer para el driver.
-#define GL_VERTEX_SHADER 0x8B31 // Se usa para crear shaders (un shader de tipo vrtice)
-#define GL_FRAGMENT_SHADER 0x8B30 // Se usa para crear shaders (un shader de tipo fragment)
-#define GL_COMPILE_STATUS 0x8B81 // El estado de compilacin de un shader (Este shader compil bien?)
-#define GL_LINK_STATUS 0x8B82 // El estado de linkeo de un programa de shaders
-#define GL_INFO_LOG_LENGTH 0x8B84 // La longitud del log de errores o warnings
-#define GL_TRUE 1 // Los valores booleanos de OpenGL (usa enteros).
-#define GL_FALSE 0
-
-
-// Constantes de la extensin WGL (permite pedir contextos OpenGL modernos)
-
-#define WGL_CONTEXT_MAJOR_VERSION_ARB 0x2091 // El nmero de versin mayor del contexto OpenGL que estamos pidiendo
-#define WGL_CONTEXT_MINOR_VERSION_ARB 0x2092 // El nmero de versin menor del contexto OpenGL
-#define WGL_CONTEXT_PROFILE_MASK_ARB  0x9126 // Que perfil de OpenGL quiero
-#define WGL_CONTEXT_CORE_PROFILE_BIT_ARB 0x00000001 // El perfil core de OpenGL
-
-
-// Typedef de un puntero a funcin para el tipo de la funcin de extensin wglCreateContextAttribsARB, 
-// que es la que te permite crear un contexto OpenGL moderno(ej : 3.3 core) en Windows.
-
-typedef HGLRC(WINAPI* PFNWGLCREATECONTEXTATTRIBSARBPROC)(HDC, HGLRC, const int*);
-
-
-// En algunos casos APIENTRYP no puede no estar definido, lo definimos.
-// APIENTRY suele corresponder a __stdcall en 32 bits y a "*" en 64 bits. 
-// Bsicamente define como una funcin recibe argumentos, quin limpia la pila y cmo se nombra el smbolo a nivel binario.
-
-#ifndef APIENTRYP
-	#define APIENTRYP APIENTRY *
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN //Minimal basic WinApi
+	#include <windows.h>
 #endif
-
-// Typedefs que describen la firma exacta de diversas funciones OpenGL modernas, para poder mas adelante obtener el puntero
-// y llamarlas como funciones normales.
-
-// PFNGL...PROC viene de la convencin del "registry":
-// PFN = Pointer to FuNction
-// GL = OpenGL
-// ... = nombre de la funcin
-// PROC = procedure(histrico)
-
-
-// BLoque de shaders:
-
-typedef GLuint(APIENTRYP PFNGLCREATESHADERPROC)(GLenum); // Crea un objeto shader (vertex o fragment) y devuelve un ID (GLuint).
-typedef void  (APIENTRYP PFNGLSHADERSOURCEPROC)(GLuint, GLsizei, const GLchar* const*, const GLint*); // Le pasa el cdigo GLSL al shader (se puede pasar 1 o varias strings).
-typedef void  (APIENTRYP PFNGLCOMPILESHADERPROC)(GLuint); // Compila el shader.
-typedef void  (APIENTRYP PFNGLGETSHADERIVPROC)(GLuint, GLenum, GLint*); // Consulta propiedades, resultado de compilacion
-typedef void  (APIENTRYP PFNGLGETSHADERINFOLOGPROC)(GLuint, GLsizei, GLsizei*, GLchar*); // Obtiene el texto del log de compilacin
-typedef void  (APIENTRYP PFNGLDELETESHADERPROC)(GLuint); // Libera el objeto shader
-
-// Bloque de programas (linkeo de shaders)
-
-typedef GLuint(APIENTRYP PFNGLCREATEPROGRAMPROC)(void); // Crea un "program object".
-typedef void  (APIENTRYP PFNGLATTACHSHADERPROC)(GLuint, GLuint); // Adjunta shaders al programa (vertex + fragment).
-typedef void  (APIENTRYP PFNGLLINKPROGRAMPROC)(GLuint); // Linkea el programa (verifica compatibilidad de inputs/outputs).
-typedef void  (APIENTRYP PFNGLGETPROGRAMIVPROC)(GLuint, GLenum, GLint*); // Igual que con shaders, pero para el link.
-typedef void  (APIENTRYP PFNGLGETPROGRAMINFOLOGPROC)(GLuint, GLsizei, GLsizei*, GLchar*);
-typedef void  (APIENTRYP PFNGLUSEPROGRAMPROC)(GLuint); // Activa el programa para dibujar.
-typedef void  (APIENTRYP PFNGLDELETEPROGRAMPROC)(GLuint); // Libera el programa.
-
-// VAOs (Vertex Array Objects)
-
-typedef void  (APIENTRYP PFNGLGENVERTEXARRAYSPROC)(GLsizei, GLuint*); // Genera IDs de VAOs.
-typedef void  (APIENTRYP PFNGLBINDVERTEXARRAYPROC)(GLuint); // Selecciona el VAO actual.
-typedef void  (APIENTRYP PFNGLDELETEVERTEXARRAYSPROC)(GLsizei, const GLuint*); // Libera VAOs.
-
-// VBOs / Buffers
-
-typedef void  (APIENTRYP PFNGLGENBUFFERSPROC)(GLsizei, GLuint*); // Genera IDs de buffers.
-typedef void  (APIENTRYP PFNGLBINDBUFFERPROC)(GLenum, GLuint); // Bindea un buffer a un target (GL_ARRAY_BUFFER, etc.)
-typedef void  (APIENTRYP PFNGLBUFFERDATAPROC)(GLenum, GLsizeiptr, const void*, GLenum); // Reserva y/o copia datos al buffer.
-typedef void  (APIENTRYP PFNGLDELETEBUFFERSPROC)(GLsizei, const GLuint*); // Libera buffers.
-
-// Vertex attributes (Le dicen al pipeline cmo leer el VBO para alimentar el vertex shader.)
-
-typedef void  (APIENTRYP PFNGLENABLEVERTEXATTRIBARRAYPROC)(GLuint); // Habilita un atributo (ej: location 0 para posicin).
-typedef void  (APIENTRYP PFNGLVERTEXATTRIBPOINTERPROC)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*); //Define el layout: cantidad de componentes, tipo, stride, offset, etc.
-
-// Uniforms (variables globales para shaders)
-
-typedef GLint(APIENTRYP PFNGLGETUNIFORMLOCATIONPROC)(GLuint, const GLchar*); //Busca la ubicacin de un uniform por nombre.
-typedef void  (APIENTRYP PFNGLUNIFORM1FPROC)(GLint, GLfloat); //Setea un float.
-typedef void  (APIENTRYP PFNGLUNIFORM2FPROC)(GLint, GLfloat, GLfloat); //Setea dos floats (vec2).
-
-
-
-// Punteros:
-// Donde vamos a guardar la referencia a las funciones previamente definidas, que carguen dinmicamente
-static PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB_ptr = nullptr;
-
-static PFNGLCREATESHADERPROC glCreateShader_ptr = nullptr;
-static PFNGLSHADERSOURCEPROC glShaderSource_ptr = nullptr;
-static PFNGLCOMPILESHADERPROC glCompileShader_ptr = nullptr;
-static PFNGLGETSHADERIVPROC glGetShaderiv_ptr = nullptr;
-static PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog_ptr = nullptr;
-static PFNGLDELETESHADERPROC glDeleteShader_ptr = nullptr;
-
-static PFNGLCREATEPROGRAMPROC glCreateProgram_ptr = nullptr;
-static PFNGLATTACHSHADERPROC glAttachShader_ptr = nullptr;
-static PFNGLLINKPROGRAMPROC glLinkProgram_ptr = nullptr;
-static PFNGLGETPROGRAMIVPROC glGetProgramiv_ptr = nullptr;
-static PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog_ptr = nullptr;
-static PFNGLUSEPROGRAMPROC glUseProgram_ptr = nullptr;
-static PFNGLDELETEPROGRAMPROC glDeleteProgram_ptr = nullptr;
-
-static PFNGLGENVERTEXARRAYSPROC glGenVertexArrays_ptr = nullptr;
-static PFNGLBINDVERTEXARRAYPROC glBindVertexArray_ptr = nullptr;
-static PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays_ptr = nullptr;
-
-static PFNGLGENBUFFERSPROC glGenBuffers_ptr = nullptr;
-static PFNGLBINDBUFFERPROC glBindBuffer_ptr = nullptr;
-static PFNGLBUFFERDATAPROC glBufferData_ptr = nullptr;
-static PFNGLDELETEBUFFERSPROC glDeleteBuffers_ptr = nullptr;
-
-static PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray_ptr = nullptr;
-static PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer_ptr = nullptr;
-
-static PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation_ptr = nullptr;
-static PFNGLUNIFORM1FPROC glUniform1f_ptr = nullptr;
-static PFNGLUNIFORM2FPROC glUniform2f_ptr = nullptr;
-
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gl_api.h"
+#include "gl_state.h"
+#include "platform.h"
+#include "frame_clock.h"
+#include "frame_pacer.h"
+#include "cpu_renderer.h"
+#include "headless.h"
+#include "profiler.h"
+#include "shader_program.h"
+#include "shader_variants.h"
+#include "dynamic_resolution.h"
+#include "expr_field.h"
+#include "noise_texture.h"
+#include "audio_engine.h"
+#include "ambient_music.h"
+#include "input.h"
+#include "simulation.h"
+#include "reaction_diffusion_texture.h"
+#include "ode_plot.h"
+#include "agents_render.h"
+#include "stream_buffer.h"
+#include "frame_capture.h"
+#include "startup.h"
+#include "assets.h"
+#include "hud.h"
+#include "glyph_atlas.h"
 
 
 // ---------------------------
 // App globals
 // ---------------------------
 
-static const wchar_t* kClassName = L"BioMathWindow";
-
-// Handlers (encargados de procesar eventos):
-
-// HWND: Handle to Window
-// HDC: Handle to device context
-// HGLRC: Handle to OpenGL rendering context
-
-static HDC   g_hdc = nullptr;
-static HGLRC g_glrc = nullptr;
-static bool  g_running = true;
+static bool g_running = true;
 
 static int g_width = 1280;
 static int g_height = 720;
@@ -178,199 +61,162 @@ static GLuint g_vbo = 0;
 // -1 = uniform no encontrado / invlido, valor estndar de error
 static GLint  g_uTime = -1;
 static GLint  g_uRes = -1;
-
-static float g_timeSeconds = 0.0f; //Tiempo global
+static GLint  g_uExprTime = -1;
+static GLint  g_uNoiseScroll[kBackgroundMaxOctaves];   // uNoiseScroll[o], -1 mas alla de NOISE_OCTAVES
+
+// Programa de fondo: variantes de shaders/fullscreen.glsl (shader_variants.h). El loop de la
+// ventana vigila el archivo para hot reload.
+static const char* kShaderFileName = "fullscreen.glsl";
+static const double kShaderPollSeconds = 0.25;
+
+static int g_variant = kShaderVariantDefault; // --variant name
+static int g_variantCycleFrames = 0;          // --variant-cycle N: pasa a la siguiente cada N frames
+static uint64_t g_frameIndex = 0;
+
+// --noise baked: hash() del fondo leido de un lattice horneado en CPU (noise_texture.h). Con
+// --golden sirve de verificacion: cpu_renderer evalua el hash analitico.
+static NoiseOptions g_noiseOptions;
+
+// --rd: el fondo muestra una simulacion de reaccion-difusion (reaction_diffusion_texture.h) en vez
+// del ruido. Prendida en la ventana; en headless solo con --rd (un tick por frame) y sin --golden.
+static RdOptions g_rdOptions;
+
+// --expr "f(x, y, t)": el fondo muestra una formula compilada a GLSL (expr_field.h) en vez del
+// ruido o de la reaccion-difusion. En la ventana y en headless, sin --golden.
+static ExprOptions g_exprOptions;
+
+// --ode lv|sir|hh: diagrama de fase de un ensamble de EDOs encima del fondo (ode_plot.h). Apagado
+// por defecto; en headless un tick por frame y sin --golden.
+static OdeOptions g_odeOptions;
+
+// --agents flock|chemo: simulacion de agentes (por defecto 1M) encima del fondo (agents_render.h).
+// Apagada por defecto; en headless un tick por frame y sin --golden.
+static AgentsOptions g_agentsOptions;
+
+// --stream-bench: en vez del loop headless corre el microbenchmark de streaming de geometria
+// (stream_buffer.h). Implica --headless.
+static StreamBenchOptions g_streamBenchOptions;
+
+// --capture path: graba los frames a Y4M, RGBA crudo o PNGs (frame_capture.h), en la ventana y en
+// headless. La lectura va por un anillo de PBOs y la escritura por su propio thread.
+static CaptureOptions g_captureOptions;
+
+// HUD de texto (hud.h): metricas y parametros encima de todo, un draw por frame. Prendido en la
+// ventana (F1 lo oculta), apagado en headless salvo --hud y sin --golden.
+static HudOptions g_hudOptions;
+static int g_hudSpeedQuarters = 4;   // la del ultimo snapshot (headless: 1x)
+
+// Resolucion dinamica (dynamic_resolution.h): prendida en la ventana, apagada en headless salvo
+// --dynres (el benchmark y el golden miden la resolucion pedida).
+static DynResOptions g_dynresOptions;
+static double g_frameBudgetMs = 1000.0 / 60.0;
+
+// Musica de fondo (audio_engine.h + ambient_music.h): solo en la ventana. El loop secuencia las
+// notas y las manda a la cola del thread de audio; nunca toca el synth.
+static AudioOptions g_audioOptions;
+static AmbientMusic g_music;
+
+// Entrada (input.h) y simulacion a paso fijo (simulation.h): la simulacion consume la entrada en
+// cada tick y el loop dibuja el snapshot interpolado. Escape cierra, Tab pasa a la siguiente
+// variante del shader, Up/Down cambian la velocidad de la animacion, F1 oculta el HUD. En headless la entrada solo
+// corre con --input-synthetic y no hay simulacion: el tiempo sale del numero de frame.
+static InputOptions g_inputOptions;
+static SimOptions g_simOptions;
+
+static FrameClock g_clock; // Tiempo global: ticks enteros desde el arranque (ver frame_clock.h)
+
+static bool g_headless = false; // --headless: sin ventana visible ni cuadros modales (CI)
+
+// Arranque en paralelo (startup.h): lo que no necesita GL corre en workers mientras se crean la
+// ventana y el contexto. InitGL espera cada tarea justo antes de la parte de GL que la usa; la
+// del audio no frena el primer frame: la musica arranca cuando termina.
+static StartupTask g_shaderSourcesTask = kStartupNone;
+static StartupTask g_noiseTask = kStartupNone;
+static StartupTask g_rdTask = kStartupNone;
+static StartupTask g_odeTask = kStartupNone;
+static StartupTask g_agentsTask = kStartupNone;
+static StartupTask g_hudTask = kStartupNone;
+static StartupTask g_audioTask = kStartupNone;
+static bool g_audioReady = false;
 
 
 // ---------------------------
 // Helpers
 // ---------------------------
 
-// Dame el nombre de una funcin OpenGL y te devuelvo un puntero ejecutable a esa funcin, si existe
-static void* GetGLProc(const char* name)
-{
-	void* p = (void*)wglGetProcAddress(name);
-	if (p) return p;
-
-	// Some core funcs can live in opengl32.dll (rare for modern ones, but fine to try)
-	HMODULE mod = GetModuleHandleW(L"opengl32.dll");
-	if (mod) return (void*)GetProcAddress(mod, name);
-
-	return nullptr;
-}
-
-
-// Este helper hace exactamente lo que hara GLAD/GLEW, pero a mano y solo con lo que el programa necesita.
-static bool LoadGLFunctions() 
+// Cuadro de mensaje modal para debug (en headless va a stderr: nadie lo va a cerrar)
+static void DebugMessageBoxA(const char* title, const char* text)
 {
-	wglCreateContextAttribsARB_ptr = (PFNWGLCREATECONTEXTATTRIBSARBPROC)GetGLProc("wglCreateContextAttribsARB");
-
-	glCreateShader_ptr = (PFNGLCREATESHADERPROC)GetGLProc("glCreateShader");
-	glShaderSource_ptr = (PFNGLSHADERSOURCEPROC)GetGLProc("glShaderSource");
-	glCompileShader_ptr = (PFNGLCOMPILESHADERPROC)GetGLProc("glCompileShader");
-	glGetShaderiv_ptr = (PFNGLGETSHADERIVPROC)GetGLProc("glGetShaderiv");
-	glGetShaderInfoLog_ptr = (PFNGLGETSHADERINFOLOGPROC)GetGLProc("glGetShaderInfoLog");
-	glDeleteShader_ptr = (PFNGLDELETESHADERPROC)GetGLProc("glDeleteShader");
-
-	glCreateProgram_ptr = (PFNGLCREATEPROGRAMPROC)GetGLProc("glCreateProgram");
-	glAttachShader_ptr = (PFNGLATTACHSHADERPROC)GetGLProc("glAttachShader");
-	glLinkProgram_ptr = (PFNGLLINKPROGRAMPROC)GetGLProc("glLinkProgram");
-	glGetProgramiv_ptr = (PFNGLGETPROGRAMIVPROC)GetGLProc("glGetProgramiv");
-	glGetProgramInfoLog_ptr = (PFNGLGETPROGRAMINFOLOGPROC)GetGLProc("glGetProgramInfoLog");
-	glUseProgram_ptr = (PFNGLUSEPROGRAMPROC)GetGLProc("glUseProgram");
-	glDeleteProgram_ptr = (PFNGLDELETEPROGRAMPROC)GetGLProc("glDeleteProgram");
-
-	glGenVertexArrays_ptr = (PFNGLGENVERTEXARRAYSPROC)GetGLProc("glGenVertexArrays");
-	glBindVertexArray_ptr = (PFNGLBINDVERTEXARRAYPROC)GetGLProc("glBindVertexArray");
-	glDeleteVertexArrays_ptr = (PFNGLDELETEVERTEXARRAYSPROC)GetGLProc("glDeleteVertexArrays");
-
-	glGenBuffers_ptr = (PFNGLGENBUFFERSPROC)GetGLProc("glGenBuffers");
-	glBindBuffer_ptr = (PFNGLBINDBUFFERPROC)GetGLProc("glBindBuffer");
-	glBufferData_ptr = (PFNGLBUFFERDATAPROC)GetGLProc("glBufferData");
-	glDeleteBuffers_ptr = (PFNGLDELETEBUFFERSPROC)GetGLProc("glDeleteBuffers");
-
-	glEnableVertexAttribArray_ptr = (PFNGLENABLEVERTEXATTRIBARRAYPROC)GetGLProc("glEnableVertexAttribArray");
-	glVertexAttribPointer_ptr = (PFNGLVERTEXATTRIBPOINTERPROC)GetGLProc("glVertexAttribPointer");
-
-	glGetUniformLocation_ptr = (PFNGLGETUNIFORMLOCATIONPROC)GetGLProc("glGetUniformLocation");
-	glUniform1f_ptr = (PFNGLUNIFORM1FPROC)GetGLProc("glUniform1f");
-	glUniform2f_ptr = (PFNGLUNIFORM2FPROC)GetGLProc("glUniform2f");
-
-	// Minimal sanity check: shaders + VAO required for our path
-	return glCreateShader_ptr && glShaderSource_ptr && glCompileShader_ptr &&
-		glCreateProgram_ptr && glLinkProgram_ptr && glUseProgram_ptr &&
-		glGenVertexArrays_ptr && glBindVertexArray_ptr &&
-		glGenBuffers_ptr && glBindBuffer_ptr && glBufferData_ptr &&
-		glEnableVertexAttribArray_ptr && glVertexAttribPointer_ptr &&
-		glGetUniformLocation_ptr && glUniform1f_ptr && glUniform2f_ptr;
+	if (g_headless)
+	{
+		fprintf(stderr, "%s: %s\n", title, text);
+		return;
+	}
+	PlatformShowError(title, text);
 }
 
 
-// Cuadro de mensaje modal para debug
-static void DebugMessageBoxA(const char* title, const char* text)
+// Carga shaders/fullscreen.glsl y lanza la variante elegida. Mientras compila (en el worker o en
+// los threads del driver) el thread de render sigue con el resto de InitGL.
+static bool StartSceneProgram()
 {
-	MessageBoxA(nullptr, text, title, MB_ICONERROR | MB_OK);
-}
+	PROFILE_ZONE("StartSceneProgram");
 
+	ShaderAsyncInit();
 
-// Define el cdigo GLSL de un vertex shader y un fragment shader, los compila, los linkea en un programa, 
-// maneja errores mostrando logs, borra los objetos shader temporales y cachea los uniform locations.
-static bool CompileAndLinkProgram()
-{
-	// TODO: ESTUDIAR
-	const char* vsSrc =
-		"#version 330 core\n"
-		"layout(location=0) in vec2 aPos;\n"
-		"out vec2 vUV;\n"
-		"void main(){\n"
-		"  gl_Position = vec4(aPos, 0.0, 1.0);\n"
-		"  vUV = aPos * 0.5 + 0.5;\n"
-		"}\n";
-
-
-	// TODO: ESTUDIAR
-	const char* fsSrc =
-		"#version 330 core\n"
-		"in vec2 vUV;\n"
-		"out vec4 FragColor;\n"
-		"uniform float uTime;\n"
-		"uniform vec2  uResolution;\n"
-		"\n"
-		"float hash(vec2 p){ return fract(sin(dot(p, vec2(127.1,311.7))) * 43758.5453123); }\n"
-		"float noise(vec2 p){\n"
-		"  vec2 i = floor(p);\n"
-		"  vec2 f = fract(p);\n"
-		"  float a = hash(i);\n"
-		"  float b = hash(i + vec2(1,0));\n"
-		"  float c = hash(i + vec2(0,1));\n"
-		"  float d = hash(i + vec2(1,1));\n"
-		"  vec2 u = f*f*(3.0-2.0*f);\n"
-		"  return mix(a,b,u.x) + (c-a)*u.y*(1.0-u.x) + (d-b)*u.x*u.y;\n"
-		"}\n"
-		"\n"
-		"void main(){\n"
-		"  vec2 uv = vUV;\n"
-		"  float t = uTime;\n"
-		"  float n = noise(uv*6.0 + vec2(t*0.15, t*0.07));\n"
-		"  float vign = smoothstep(1.2, 0.2, length(uv - 0.5));\n"
-		"  vec3 col = vec3(0.08,0.10,0.14);\n"
-		"  col += 0.35 * vec3(0.20,0.55,0.95) * n;\n"
-		"  col += 0.15 * vec3(sin(t + uv.x*6.0), sin(t*0.7 + uv.y*5.0), sin(t*1.3)) * 0.5;\n"
-		"  col *= vign;\n"
-		"  FragColor = vec4(col, 1.0);\n"
-		"}\n";
-
-	GLuint vs = glCreateShader_ptr(GL_VERTEX_SHADER);
-	glShaderSource_ptr(vs, 1, &vsSrc, nullptr);
-	glCompileShader_ptr(vs);
-
-	GLint ok = GL_FALSE;
-	glGetShaderiv_ptr(vs, GL_COMPILE_STATUS, &ok);
-	if (!ok)
-	{
-		GLint len = 0;
-		glGetShaderiv_ptr(vs, GL_INFO_LOG_LENGTH, &len);
-		char* log = (char*)_alloca((size_t)len + 1);
-		GLsizei outLen = 0;
-		glGetShaderInfoLog_ptr(vs, len, &outLen, log);
-		log[outLen] = 0;
-		DebugMessageBoxA("Vertex shader compile failed", log);
-		glDeleteShader_ptr(vs);
+	std::string error;
+	if (!ShaderVariantsBegin(kShaderFileName, g_variant, NoiseShaderDefines() + RdShaderDefines() + ExprShaderDefines(), &error))
+	{
+		DebugMessageBoxA("Shader compile failed", error.c_str());
 		return false;
 	}
+	return true;
+}
 
-	GLuint fs = glCreateShader_ptr(GL_FRAGMENT_SHADER);
-	glShaderSource_ptr(fs, 1, &fsSrc, nullptr);
-	glCompileShader_ptr(fs);
+// Espera la variante elegida. Las demas se compilan en segundo plano (en headless solo si se van a
+// usar).
+static bool FinishSceneProgram()
+{
+	PROFILE_ZONE("FinishSceneProgram");
 
-	glGetShaderiv_ptr(fs, GL_COMPILE_STATUS, &ok);
-	if (!ok)
+	std::string error;
+	const bool prewarm = !g_headless || g_variantCycleFrames > 0;
+	if (!ShaderVariantsEnd(prewarm, &error))
 	{
-		GLint len = 0;
-		glGetShaderiv_ptr(fs, GL_INFO_LOG_LENGTH, &len);
-		char* log = (char*)_alloca((size_t)len + 1);
-		GLsizei outLen = 0;
-		glGetShaderInfoLog_ptr(fs, len, &outLen, log);
-		log[outLen] = 0;
-		DebugMessageBoxA("Fragment shader compile failed", log);
-		glDeleteShader_ptr(fs);
-		glDeleteShader_ptr(vs);
+		DebugMessageBoxA("Shader compile failed", error.c_str());
 		return false;
 	}
+	return true;
+}
 
-	g_program = glCreateProgram_ptr();
-	glAttachShader_ptr(g_program, vs);
-	glAttachShader_ptr(g_program, fs);
-	glLinkProgram_ptr(g_program);
-
-	glGetProgramiv_ptr(g_program, GL_LINK_STATUS, &ok);
-	if (!ok)
-	{
-		GLint len = 0;
-		glGetProgramiv_ptr(g_program, GL_INFO_LOG_LENGTH, &len);
-		char* log = (char*)_alloca((size_t)len + 1);
-		GLsizei outLen = 0;
-		glGetProgramInfoLog_ptr(g_program, len, &outLen, log);
-		log[outLen] = 0;
-		DebugMessageBoxA("Program link failed", log);
-		glDeleteProgram_ptr(g_program);
-		g_program = 0;
-		glDeleteShader_ptr(fs);
-		glDeleteShader_ptr(vs);
-		return false;
-	}
+// Recoge los builds terminados y, si cambio la variante activa (o se recargo el archivo), toma el
+// programa nuevo y sus uniform locations. Nunca espera a un compilador.
+static void SyncActiveProgram()
+{
+	if (g_variantCycleFrames > 0 && g_frameIndex > 0 && g_frameIndex % (uint64_t)g_variantCycleFrames == 0)
+		ShaderVariantsRequest((ShaderVariantsRequested() + 1) % kShaderVariantCount);
+	++g_frameIndex;
 
-	glDeleteShader_ptr(fs);
-	glDeleteShader_ptr(vs);
+	ShaderVariantsUpdate();
 
+	const GLuint program = ShaderVariantsProgram();
+	if (program == g_program) return;
+	g_program = program;
 	g_uTime = glGetUniformLocation_ptr(g_program, "uTime");
 	g_uRes = glGetUniformLocation_ptr(g_program, "uResolution");
-
-	return true;
+	g_uExprTime = glGetUniformLocation_ptr(g_program, "uExprTime");
+	for (int o = 0; o < kBackgroundMaxOctaves; ++o)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "uNoiseScroll[%d]", o);
+		g_uNoiseScroll[o] = glGetUniformLocation_ptr(g_program, name);
+	}
 }
 
 static void CreateFullscreenTriangle()
 {
+	PROFILE_ZONE("CreateFullscreenTriangle");
+
 	// Fullscreen triangle in clip space:
 	// (-1,-1), (3,-1), (-1,3)
 	const float verts[] = {
@@ -381,11 +227,11 @@ static void CreateFullscreenTriangle()
 
 	// Genero VAO
 	glGenVertexArrays_ptr(1, &g_vao); // Creo un VAO (ID)
-	glBindVertexArray_ptr(g_vao); // Lo pongo activo
+	GLStateBindVertexArray(g_vao); // Lo pongo activo
 
 	// Genero VBO
 	glGenBuffers_ptr(1, &g_vbo);
-	glBindBuffer_ptr(GL_ARRAY_BUFFER, g_vbo);
+	GLStateBindBuffer(GL_ARRAY_BUFFER, g_vbo);
 	glBufferData_ptr(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(verts), verts, GL_STATIC_DRAW);
 
 	// Conecto el VBO con el shder (location 0)
@@ -398,227 +244,630 @@ static void CreateFullscreenTriangle()
 	// offset = 0 porque la posicin empieza al inicio del buffer
 
 	// desbindea (defensivo)
-	glBindVertexArray_ptr(0);
-	glBindBuffer_ptr(GL_ARRAY_BUFFER, 0);
+	GLStateBindVertexArray(0);
+	GLStateBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 
-// ---------------------------
-// Win32 + WGL
-// ---------------------------	
-
-LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
+// El texto del HUD. Las etiquetas son fijas y los valores se reescriben 4 veces por segundo (los
+// numeros se pueden leer y entre refrescos todos los strings son iguales: el layout sale del
+// cache). El fps y los ms del frame son promedios moviles entre refrescos.
+static void BuildHud(int outputWidth, int outputHeight)
 {
-	switch (msg)
+	if (!HudActive() || !HudVisible()) return;
+	PROFILE_ZONE("BuildHud");
+
+	static uint64_t lastTicks = 0, nextRefresh = 0;
+	static double frameMs = 0.0;
+	static char lines[6][128];
+	const uint64_t now = PlatformTicks();
+	const uint64_t frequency = PlatformTickFrequency();
+	if (lastTicks)
 	{
-	case WM_SIZE:
-		g_width = LOWORD(lParam);
-		g_height = HIWORD(lParam);
-		return 0;
-
-	case WM_CLOSE:
-		DestroyWindow(hWnd);
-		return 0;
+		const double ms = (double)(now - lastTicks) * 1000.0 / (double)frequency;
+		frameMs = frameMs > 0.0 ? frameMs + (ms - frameMs) * 0.1 : ms;
+	}
+	lastTicks = now;
 
-	case WM_DESTROY:
-		g_running = false;
-		PostQuitMessage(0);
-		return 0;
+	if (now >= nextRefresh)
+	{
+		nextRefresh = now + frequency / 4;
+		const int variant = ShaderVariantsActive();
+		snprintf(lines[0], sizeof(lines[0]), "%s  %s", PlatformBackendName(),
+			variant >= 0 && variant < kShaderVariantCount ? kShaderVariants[variant].name : "?");
+		if (frameMs > 0.0) snprintf(lines[1], sizeof(lines[1]), "%.1f fps  %.2f ms", 1000.0 / frameMs, frameMs);
+		else snprintf(lines[1], sizeof(lines[1]), "-- fps");
+		if (DynResEnabled())
+			snprintf(lines[2], sizeof(lines[2]), "%dx%d  scale %.2f  gpu %.2f/%.2f ms", outputWidth, outputHeight,
+				(double)DynResScale(), DynResLastGpuMs(), DynResBudgetMs());
+		else
+			snprintf(lines[2], sizeof(lines[2]), "%dx%d", outputWidth, outputHeight);
+		const char* background = RdTextureActive() ? "reaction-diffusion" : ExprFieldActive() ? "expr"
+			: NoiseTextureActive() ? "noise (baked)" : "noise";
+		snprintf(lines[3], sizeof(lines[3]), "%s  speed %.2fx", background, g_hudSpeedQuarters * 0.25);
+		lines[4][0] = '\0';
+		if (OdePlotActive())
+			snprintf(lines[4], sizeof(lines[4]), "ode %s %s x%d", kOdeModels[(int)g_odeOptions.model].name,
+				OdeMethodName(g_odeOptions.method), g_odeOptions.systems);
+		lines[5][0] = '\0';
+		if (AgentsActive())
+			snprintf(lines[5], sizeof(lines[5]), "agents %s x%d", AgentModeName(g_agentsOptions.mode), g_agentsOptions.count);
+	}
 
-	default:
-		return DefWindowProc(hWnd, msg, wParam, lParam);
+	const float size = HudTextSize();
+	const float line = size * kGlyphLineHeight;
+	const uint32_t label = HudColor(150, 200, 255);
+	const uint32_t value = HudColor(255, 255, 255);
+	float y = size * 0.5f;
+	for (int i = 0; i < 6; ++i)
+	{
+		if (!lines[i][0]) continue;
+		HudText(size * 0.5f, y, size, i == 0 ? label : value, lines[i]);
+		y += line;
 	}
+	HudText(size * 0.5f, y, size * 0.75f, label, "F1 hud  Tab variant  Up/Down speed  Esc quit");
 }
 
-// Inicializacin de WGL.
-// Conecto OpenGL a la ventana.
-// Creo un contexto viejo para poder cargar la funcin que crea un contexto moderno.
-// Si puedo, creo OpenGL 3.3 core.Si no, me quedo con el viejo.
-// Y finalmente verifico que tengo las funciones necesarias para renderizar.
 
-static bool InitWGL(HWND hWnd)
+// Dibuja un frame completo en el framebuffer bindeado. Lo usan el loop de la ventana y el modo headless.
+// Todo pasa por gl_state.h: lo que no cambio desde el frame anterior no llega al driver.
+static void RenderFrame(int outputWidth, int outputHeight, double timeSeconds)
 {
-	g_hdc = GetDC(hWnd);
-	if (!g_hdc) return false;
-
-	PIXELFORMATDESCRIPTOR pfd{}; // Como sera el framebuffer?
-	pfd.nSize = sizeof(pfd);
-	pfd.nVersion = 1;
-	pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
-	pfd.iPixelType = PFD_TYPE_RGBA;
-	pfd.cColorBits = 32;
-	pfd.cDepthBits = 24; // Z-Buffer bits (mientras ms, mas precisa la comparacion (menos Z fighting).
-
-	// Una linda definicin del stencil buffer:
-	// Un buffer auxiliar, por pxel, que participa en pruebas (tests) durante el pipeline 
-	// de rasterizacin para decidir si un fragmento se procesa o se descarta.
-	pfd.cStencilBits = 8;
-	pfd.iLayerType = PFD_MAIN_PLANE;
-
-	int pf = ChoosePixelFormat(g_hdc, &pfd);
-	if (pf == 0) return false;
-	if (!SetPixelFormat(g_hdc, pf, &pfd)) return false;
-
-	// 1) Create legacy context first (needed to load wglCreateContextAttribsARB)
-	HGLRC legacy = wglCreateContext(g_hdc);
-	if (!legacy) return false;
-
-	// Asocio el contexto OpenGL (HGLRC) con el Device Context (HDC) en el thread actual, haciendo que OpenGL quede activo.
-	if (!wglMakeCurrent(g_hdc, legacy)) return false;
-
-	// Load WGL extensions + GL functions (from legacy context)
-	LoadGLFunctions();
-
-	// 2) Try to create a modern core context (3.3)
-	if (wglCreateContextAttribsARB_ptr)
-	{
-		const int attribs[] = {
-			WGL_CONTEXT_MAJOR_VERSION_ARB, 3,
-			WGL_CONTEXT_MINOR_VERSION_ARB, 3,
-			WGL_CONTEXT_PROFILE_MASK_ARB,  WGL_CONTEXT_CORE_PROFILE_BIT_ARB,
-			0
-		};
-
-		HGLRC modern = wglCreateContextAttribsARB_ptr(g_hdc, 0, attribs);
-		if (modern)
-		{
-			wglMakeCurrent(nullptr, nullptr);
-			wglDeleteContext(legacy);
+	SyncActiveProgram();
+	RdTextureUpload(); // el ultimo campo publicado por la simulacion, si hay uno nuevo
 
-			g_glrc = modern;
-			if (!wglMakeCurrent(g_hdc, g_glrc)) return false;
-		}
-		else
-		{
-			// Fallback: keep legacy
-			g_glrc = legacy;
-		}
+	// Con resolucion dinamica la escena va a un FBO de width x height <= la salida.
+	int width = 0, height = 0;
+	DynResBeginScene(outputWidth, outputHeight, &width, &height);
+
+	// Preparar el frame (viewport y clear)
+	{
+		PROFILE_GPU_ZONE("Clear");
+		GLStateViewport(0, 0, width > 0 ? width : 1, height > 0 ? height : 1);
+		GLStateClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		GLStateClear(GL_COLOR_BUFFER_BIT);
+	}
+
+	// Usar programa y setear uniforms
+	{
+		PROFILE_GPU_ZONE("UploadUniforms");
+		GLStateUseProgram(g_program);
+		NoiseTextureBind();
+		RdTextureBind();
+		const BackgroundTime bt = BackgroundTimeAt(timeSeconds);
+		if (g_uTime >= 0) GLStateUniform1f(g_uTime, bt.time);
+		if (g_uExprTime >= 0) GLStateUniform1f(g_uExprTime, bt.exprTime);
+		for (int o = 0; o < kBackgroundMaxOctaves; ++o)
+			if (g_uNoiseScroll[o] >= 0) GLStateUniform2f(g_uNoiseScroll[o], bt.scrollX[o], bt.scrollY[o]);
+		if (g_uRes >= 0) GLStateUniform2f(g_uRes, (float)width, (float)height);
+	}
+
+	// Dibujar el fullscreen triangle. El VAO queda bindeado: el cache evita rebindearlo.
+	{
+		PROFILE_GPU_ZONE("DrawArrays");
+		GLStateBindVertexArray(g_vao);
+		GLStateDrawArrays(GL_TRIANGLES, 0, 3);
 	}
-	else
+
+	DynResEndScene(g_vao); // upsample a la salida
+	AgentsDraw(outputWidth, outputHeight);  // a la resolucion de salida, encima de la escena
+	OdePlotDraw(outputWidth, outputHeight);
+	BuildHud(outputWidth, outputHeight);
+	HudDraw(outputWidth, outputHeight);     // al final: el texto va encima de todo
+}
+
+
+// ---------------------------
+// Inicializacion GL
+// ---------------------------
+
+// Tareas de arranque (startup.h), con las opciones ya leidas y antes de crear la ventana: leer
+// los shaders, cargar u hornear el ruido, sembrar las simulaciones y, en la ventana, abrir el audio.
+static void LaunchStartupTasks()
+{
+	g_shaderSourcesTask = StartupAdd("shader_sources", []
 	{
-		// No attribs extension: keep legacy
-		g_glrc = legacy;
+		ShaderFilePrefetch(kShaderFileName);
+		if (g_dynresOptions.enabled) ShaderFilePrefetch("upsample.glsl");
+		if (g_odeOptions.enabled) ShaderFilePrefetch("ode_plot.glsl");
+		if (g_agentsOptions.enabled) ShaderFilePrefetch("agents.glsl");
+		if (g_hudOptions.enabled) ShaderFilePrefetch("hud.glsl");
+	});
+	// Con el campo de reaccion-difusion no se usa el ruido (si el campo falla, InitGL lo prepara ahi).
+	if (g_rdOptions.enabled) g_rdTask = StartupAdd("rd_seed", [] { RdTexturePrepare(g_rdOptions); });
+	else if (g_noiseOptions.mode == NoiseMode::Baked) g_noiseTask = StartupAdd("noise_lattice", [] { NoiseTexturePrepare(g_noiseOptions); });
+	if (g_odeOptions.enabled) g_odeTask = StartupAdd("ode_ensemble", [] { OdePlotPrepare(g_odeOptions); });
+	if (g_agentsOptions.enabled) g_agentsTask = StartupAdd("agents_world", [] { AgentsPrepare(g_agentsOptions); });
+	if (g_hudOptions.enabled) g_hudTask = StartupAdd("hud_atlas", [] { HudPrepare(g_hudOptions); });
+	if (!g_headless && g_audioOptions.enabled)
+	{
+		g_audioTask = StartupAdd("audio", []
+		{
+			if (AudioEngineInit(g_audioOptions))
+				AmbientMusicInit(&g_music, (uint32_t)PlatformTicks());
+		});
 	}
+	StartupLaunch();
+}
 
-	// Ensure GL funcs are loaded for the final current context
-	if (!LoadGLFunctions())
+// La ventana y el contexto los pone la capa de plataforma (platform.h): WGL en Windows,
+// GLX o EGL en Linux. Aca solo queda lo que es comun a todos.
+static bool InitGL()
+{
+	bool contextOk = false;
+	{
+		PROFILE_ZONE("PlatformCreateGLContext");
+		StartupPhase phase("gl_context");
+		contextOk = PlatformCreateGLContext();
+	}
+	if (!contextOk)
 	{
 		DebugMessageBoxA("OpenGL init failed",
-			"Could not load required OpenGL functions.\n"
+			"Could not create an OpenGL context or load required OpenGL functions.\n"
 			"Your driver/context may not support OpenGL 2.0+ or required entry points.");
 		return false;
 	}
 
-	return true;
+	{
+		StartupPhase phase("gl_resources");
+		GLStateInvalidate(); // contexto nuevo: no sabemos nada de su estado
+		ProfilerGpuInit();
+
+		// Antes del programa: definen REACTION_DIFFUSION / BAKED_NOISE. Con el campo no se usa el ruido.
+		StartupWait(g_rdTask);
+		if (!RdTextureInit(g_rdOptions))
+		{
+			StartupWait(g_noiseTask);
+			NoiseTextureInit(g_noiseOptions);
+		}
+
+		// El programa de la escena compila mientras se crea el resto.
+		StartupWait(g_shaderSourcesTask);
+		if (!StartSceneProgram())
+			return false;
+
+		// Presupuesto de GPU por defecto: 80% del periodo del frame (el resto para upsample y present).
+		DynResInit(g_dynresOptions, g_frameBudgetMs * 0.8);
+		StartupWait(g_odeTask);
+		OdePlotInit(g_odeOptions);
+		StartupWait(g_agentsTask);
+		AgentsInit(g_agentsOptions);
+		StartupWait(g_hudTask);
+		HudInit(g_hudOptions);
+		CaptureInit(g_captureOptions);
+		CreateFullscreenTriangle();
+	}
+
+	// Va al final para que el reporte "shader" sea el de la escena.
+	StartupPhase phase("scene_program");
+	return FinishSceneProgram();
+}
+
+static void ShutdownGL()
+{
+	CaptureShutdown(); // termina las lecturas en vuelo y cierra el archivo
+	ProfilerGpuShutdown();
+
+	DynResShutdown();
+	NoiseTextureShutdown();
+	RdTextureShutdown();
+	OdePlotShutdown();
+	AgentsShutdown();
+	HudShutdown();
+	ShaderVariantsShutdown(); // borra los programas de todas las variantes
+	ShaderAsyncShutdown();
+	GLStateDeleteBuffer(g_vbo);
+	GLStateDeleteVertexArray(g_vao);
+	g_program = 0;
+	g_vbo = 0;
+	g_vao = 0;
+
+	PlatformDestroyGLContext();
 }
 
-static void ShutdownGL(HWND hWnd)
+// ---------------------------
+// Fallback sin GL
+// ---------------------------
+
+// Si no hay driver GL usable (o el shader no compila) el fondo se renderiza en CPU
+// (ver cpu_renderer.h) y se presenta sin GL (GDI / XPutImage). Mismo loop que el de GL, sin
+// Sleep: el renderer ya ocupa todos los cores y la presentacion hace de throttle.
+static int RunCpuFallback()
 {
-	if (g_program)
+	uint8_t* pixels = nullptr;
+	int pixW = 0, pixH = 0;
+
+	while (g_running)
 	{
-		glDeleteProgram_ptr(g_program);
-		g_program = 0;
+		g_running = PlatformPumpEvents();
+		if (!g_running) break;
+
+		PlatformGetWindowSize(&g_width, &g_height);
+		const int w = g_width > 0 ? g_width : 1;
+		const int h = g_height > 0 ? g_height : 1;
+		if (w != pixW || h != pixH)
+		{
+			free(pixels);
+			pixels = (uint8_t*)malloc((size_t)w * (size_t)h * 4);
+			if (!pixels) break;
+			pixW = w;
+			pixH = h;
+		}
+
+		CpuRenderBackground(pixels, w, h, FrameClockSeconds(g_clock), CpuShadePath::Auto, CpuPixelFormat::BGRA8);
+		if (!PlatformPresentPixels(pixels, w, h)) break;
 	}
-	if (g_vbo)
+
+	free(pixels);
+	PlatformDestroyWindow();
+	return 0;
+}
+
+// ---------------------------
+// Modo headless
+// ---------------------------
+
+// Sin ventana visible: se dibuja en un FBO y no se llama a SwapBuffers. En Windows la ventana
+// existe igual, oculta (WGL necesita un HDC); en Linux el contexto es EGL surfaceless.
+static int RunHeadlessMode(const HeadlessOptions& opts)
+{
+	PlatformAttachConsole();
+
+	PlatformDesc desc;
+	desc.width = opts.width;
+	desc.height = opts.height;
+	desc.surface = PlatformSurface::Offscreen;
+	bool windowOk = false;
 	{
-		glDeleteBuffers_ptr(1, &g_vbo);
-		g_vbo = 0;
+		StartupPhase phase("window");
+		windowOk = PlatformCreateWindow(desc);
 	}
-	if (g_vao)
+	if (!windowOk)
 	{
-		glDeleteVertexArrays_ptr(1, &g_vao);
-		g_vao = 0;
+		fprintf(stderr, "headless: cannot create platform surface\n");
+		StartupJoin();
+		return 1;
 	}
 
-	if (g_glrc)
+	if (!InitGL())
 	{
-		wglMakeCurrent(nullptr, nullptr);
-		wglDeleteContext(g_glrc);
-		g_glrc = nullptr;
+		StartupJoin();
+		ShutdownGL();
+		PlatformDestroyWindow();
+		return 1;
 	}
 
-	if (g_hdc)
-	{
-		ReleaseDC(hWnd, g_hdc);
-		g_hdc = nullptr;
-	}
+	if (g_inputOptions.syntheticHz > 0.0)
+		InputInit(g_inputOptions);
+
+	const int rc = g_streamBenchOptions.enabled ? RunStreamBench(g_streamBenchOptions) : RunHeadless(opts, RenderFrame);
+
+	InputShutdown();
+	StartupJoin();
+	ShutdownGL();
+	PlatformDestroyWindow();
+	return rc;
 }
 
 // ---------------------------
 // Entry point
 // ---------------------------
 
-int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int)
+// --trace path: graba zonas de CPU/GPU y al salir las escribe como Chrome trace (profiler.h).
+static const char* ParseTracePath(int argc, char** argv)
+{
+	for (int i = 1; i + 1 < argc; ++i)
+		if (strcmp(argv[i], "--trace") == 0) return argv[i + 1];
+	return nullptr;
+}
+
+static void WriteTrace(const char* tracePath)
+{
+	if (tracePath && !ProfilerWriteChromeTrace(tracePath))
+		fprintf(stderr, "profiler: cannot write '%s'\n", tracePath);
+}
+
+// --variant name, --variant-cycle N (ver shader_variants.h)
+static bool ParseVariantOptions(int argc, char** argv)
+{
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--variant") == 0)
+		{
+			g_variant = ShaderVariantFind(argv[++i]);
+			if (g_variant < 0)
+			{
+				PlatformAttachConsole();
+				fprintf(stderr, "unknown shader variant '%s'; available:", argv[i]);
+				for (const ShaderVariant& v : kShaderVariants) fprintf(stderr, " %s", v.name);
+				fprintf(stderr, "\n");
+				return false;
+			}
+		}
+		else if (strcmp(argv[i], "--variant-cycle") == 0)
+		{
+			g_variantCycleFrames = atoi(argv[++i]);
+		}
+	}
+	return true;
+}
+
+// SynthPostFn de la musica: encola para el thread de audio (si la cola esta llena se pierde la nota).
+static void PostToAudio(void*, const SynthCommand& cmd)
 {
-	WNDCLASS wc{};
-	wc.lpfnWndProc = WndProc;
-	wc.hInstance = hInstance;
-	wc.lpszClassName = kClassName;
+	AudioEnginePost(cmd);
+}
+
+static int RunApp(int argc, char** argv)
+{
+	const char* tracePath = ParseTracePath(argc, argv);
+	if (tracePath)
+	{
+		ProfilerSetEnabled(true);
+		ProfilerSetThreadName("main");
+	}
+
+	ShaderOptions shaderOptions;
+	ParseShaderOptions(argc, argv, &shaderOptions);
+	ShaderSetOptions(shaderOptions);
+
+	AssetOptions assetOptions;
+	ParseAssetOptions(argc, argv, &assetOptions);
+	if (!AssetsMount(assetOptions))
+		return 1;
+
+	if (!ParseVariantOptions(argc, argv))
+		return 1;
+
+	HeadlessOptions headless;
+	ParseHeadlessOptions(argc, argv, &headless);
+	ParseStreamBenchOptions(argc, argv, &g_streamBenchOptions);
+	if (g_streamBenchOptions.enabled) headless.enabled = true;
+	if (headless.golden && (g_variant != kShaderVariantDefault || g_variantCycleFrames > 0))
+	{
+		PlatformAttachConsole();
+		fprintf(stderr, "--golden compares against cpu_renderer, which only implements the '%s' variant\n",
+			kShaderVariants[kShaderVariantDefault].name);
+		return 1;
+	}
+
+	FramePacerOptions pacing;
+	ParseFramePacerOptions(argc, argv, &pacing);
+	if (pacing.targetHz > 0.0) g_frameBudgetMs = 1000.0 / pacing.targetHz;
+
+	ParseNoiseOptions(argc, argv, &g_noiseOptions);
+
+	if (!ParseExprOptions(argc, argv, &g_exprOptions))
+		return 1;
+	if (headless.golden && g_exprOptions.source)
+	{
+		PlatformAttachConsole();
+		fprintf(stderr, "--golden compares against the noise background: drop --expr\n");
+		return 1;
+	}
+
+	// Con --expr la reaccion-difusion no se veria: apagada salvo --rd explicito.
+	g_rdOptions.enabled = !headless.enabled && !g_exprOptions.source;
+	if (!ParseReactionDiffusionOptions(argc, argv, &g_rdOptions))
+		return 1;
+	if (headless.golden && g_rdOptions.enabled)
+	{
+		PlatformAttachConsole();
+		fprintf(stderr, "--golden compares against the noise background: drop --rd\n");
+		return 1;
+	}
 
-	if (!RegisterClass(&wc))
+	if (!ParseOdeOptions(argc, argv, &g_odeOptions))
+		return 1;
+	if (headless.golden && g_odeOptions.enabled)
+	{
+		PlatformAttachConsole();
+		fprintf(stderr, "--golden compares the background only: drop --ode\n");
+		return 1;
+	}
+
+	if (!ParseAgentsOptions(argc, argv, &g_agentsOptions))
+		return 1;
+	if (headless.golden && g_agentsOptions.enabled)
+	{
+		PlatformAttachConsole();
+		fprintf(stderr, "--golden compares the background only: drop --agents\n");
+		return 1;
+	}
+
+	g_hudOptions.enabled = !headless.enabled;
+	ParseHudOptions(argc, argv, &g_hudOptions);
+	if (headless.golden && g_hudOptions.enabled)
+	{
+		PlatformAttachConsole();
+		fprintf(stderr, "--golden compares the background only: drop --hud\n");
 		return 1;
+	}
+
+	g_audioOptions.enabled = !headless.enabled;
+	ParseAudioOptions(argc, argv, &g_audioOptions);
 
-	HWND hWnd = CreateWindowEx(
-		0, kClassName, L"WIP BioMath",
-		WS_OVERLAPPEDWINDOW,
-		CW_USEDEFAULT, CW_USEDEFAULT, g_width, g_height,
-		nullptr, nullptr, hInstance, nullptr
-	);
-	if (!hWnd) return 1;
+	if (!ParseCaptureOptions(argc, argv, &g_captureOptions))
+		return 1;
 
-	ShowWindow(hWnd, SW_SHOW);
+	ParseInputOptions(argc, argv, &g_inputOptions);
+	ParseSimOptions(argc, argv, &g_simOptions);
 
-	if (!InitWGL(hWnd))
+	g_dynresOptions.enabled = !headless.enabled;
+	ParseDynResOptions(argc, argv, &g_dynresOptions);
+	if (headless.golden && g_dynresOptions.enabled)
+	{
+		PlatformAttachConsole();
+		fprintf(stderr, "--golden needs the scene at full resolution: drop --dynres\n");
 		return 1;
+	}
+	if (headless.enabled) g_headless = true;
+	LaunchStartupTasks();
+
+	if (headless.enabled)
+	{
+		const int rc = RunHeadlessMode(headless);
+		WriteTrace(tracePath);
+		return rc;
+	}
 
-	// Build program + geometry
-	if (!CompileAndLinkProgram())
+	PlatformDesc desc;
+	desc.width = g_width;
+	desc.height = g_height;
+	bool windowOk = false;
+	{
+		StartupPhase phase("window");
+		windowOk = PlatformCreateWindow(desc);
+	}
+	if (!windowOk)
+	{
+		StartupJoin();
+		AudioEngineShutdown();
 		return 1;
+	}
+
+	FrameClockStart(&g_clock);
+
+	// Sin GL usable (driver, contexto o shader): seguimos con el renderer de CPU, sin musica.
+	if (!InitGL())
+	{
+		StartupJoin();
+		AudioEngineShutdown();
+		ShutdownGL();
+		return RunCpuFallback();
+	}
+
+	// Frame pacing: tasa objetivo (--fps) + swap interval (--vsync). Ver frame_pacer.h.
+	PlatformSetSwapInterval(pacing.swapInterval);
 
-	CreateFullscreenTriangle();
+	FramePacer pacer;
+	FramePacerInit(&pacer, pacing);
 
-	LARGE_INTEGER freq{};
-	LARGE_INTEGER prev{};
-	QueryPerformanceFrequency(&freq);
-	QueryPerformanceCounter(&prev); // reloj de alta precisin en Windows.
+	if (!InputInit(g_inputOptions))
+		fprintf(stderr, "input: no input backend available\n");
+	SimInit(g_simOptions);
+
+	uint64_t nextShaderPoll = 0;
+	uint32_t variantSteps = 0;
 
-	MSG msg{};
 	while (g_running)
 	{
-		while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
 		{
-			if (msg.message == WM_QUIT)
-				g_running = false;
-			TranslateMessage(&msg);
-			DispatchMessage(&msg);
+			PROFILE_ZONE("PumpEvents");
+			g_running = PlatformPumpEvents();
+		}
+		if (!g_running) break;
+
+		// Con --sim-inline los ticks vencidos corren aca. "early": antes de esperar, y la entrada
+		// espera en la cola lo que dure el sleep. Con el thread de simulacion no hace nada.
+		const bool lateInput = g_inputOptions.sample == InputSamplePoint::Late;
+		if (!lateInput) SimRunInline();
+
+		{
+			PROFILE_ZONE("FramePacerWait");
+			FramePacerWait(&pacer);
+		}
+
+		if (lateInput) SimRunInline();
+
+		SimState sim;
+		const SimSnapshot& snapshot = SimAcquire(PlatformTicks(), &sim);
+		if (snapshot.quit)
+			break;
+		for (; variantSteps != snapshot.variantSteps; ++variantSteps)
+			ShaderVariantsRequest((ShaderVariantsRequested() + 1) % kShaderVariantCount);
+		HudSetVisible(!snapshot.hudHidden);
+		g_hudSpeedQuarters = snapshot.timeScaleQuarters;
+
+		PROFILE_ZONE("Frame");
+		GLStateBeginFrame();
+		ProfilerGpuBeginFrame();
+
+		// La musica va con el reloj de pared (el audio no se interpola); el shader con la fase de la simulacion.
+		const double timeSeconds = FrameClockSeconds(g_clock);
+
+		// La musica arranca cuando termino su tarea (el dispositivo se abre en un worker).
+		if (!g_audioReady) g_audioReady = StartupDone(g_audioTask);
+		if (g_audioReady && AudioEngineRunning())
+		{
+			PROFILE_ZONE("Music");
+			AmbientMusicUpdate(&g_music, timeSeconds, PostToAudio, nullptr);
+		}
+
+		if (FrameClockElapsedTicks(g_clock) >= nextShaderPoll)
+		{
+			nextShaderPoll = FrameClockElapsedTicks(g_clock) + SecondsToTicks(kShaderPollSeconds, g_clock.frequency);
+			ShaderVariantsReloadIfChanged();
+			ShaderReloadChanged();
 		}
 
-		// Calcular delta time y acumular tiempo
-		LARGE_INTEGER now{};
-		QueryPerformanceCounter(&now);
-		const double dt = double(now.QuadPart - prev.QuadPart) / double(freq.QuadPart);
-		prev = now;
-		g_timeSeconds += (float)dt;
+		PlatformGetWindowSize(&g_width, &g_height);
+		RenderFrame(g_width, g_height, sim.phase);
+		CaptureFrame(g_width, g_height);
 
-		// Preparar el frame (viewport y clear)
-		glViewport(0, 0, g_width > 0 ? g_width : 1, g_height > 0 ? g_height : 1);
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
+		// Lo consumido hasta el tick dibujado se ve en este swap.
+		InputFramePresented(PlatformTicks(), snapshot.inputEvents);
 
-		// Usar programa y setear uniforms
-		glUseProgram_ptr(g_program);
-		if (g_uTime >= 0) glUniform1f_ptr(g_uTime, g_timeSeconds);
-		if (g_uRes >= 0) glUniform2f_ptr(g_uRes, (float)g_width, (float)g_height);
+		{
+			PROFILE_ZONE("SwapBuffers");
+			PlatformSwapBuffers();
+		}
+		StartupFirstFrame();
+	}
 
-		// Dibujar el fullscreen triangle
-		glBindVertexArray_ptr(g_vao);
-		glDrawArrays(GL_TRIANGLES, 0, 3);
-		glBindVertexArray_ptr(0);
+	SimShutdown();
+	CaptureFlush();
+	StartupJoin();
 
-		SwapBuffers(g_hdc);
-		Sleep(1);
+	if (pacing.jsonPath)
+	{
+		if (FILE* f = fopen(pacing.jsonPath, "w"))
+		{
+			fprintf(f, "{\n  \"platform\": \"%s\",\n  ", PlatformBackendName());
+			WriteFramePacerJson(f, pacer);
+			fprintf(f, ",\n  ");
+			WriteAudioJson(f);
+			fprintf(f, ",\n  ");
+			WriteInputJson(f);
+			fprintf(f, ",\n  ");
+			WriteSimJson(f);
+			fprintf(f, ",\n  ");
+			WriteReactionDiffusionJson(f);
+			fprintf(f, ",\n  ");
+			WriteExprJson(f);
+			fprintf(f, ",\n  ");
+			WriteOdeJson(f);
+			fprintf(f, ",\n  ");
+			WriteAgentsJson(f);
+			fprintf(f, ",\n  ");
+			WriteCaptureJson(f);
+			fprintf(f, ",\n  ");
+			WriteStartupJson(f);
+			fprintf(f, ",\n  ");
+			WriteAssetsJson(f);
+			fprintf(f, ",\n  ");
+			WriteHudJson(f);
+			fprintf(f, "\n}\n");
+			fclose(f);
+		}
 	}
 
-	ShutdownGL(hWnd);
+	InputShutdown();
+	AudioEngineShutdown();
+	ShutdownGL();
+	PlatformDestroyWindow();
+	WriteTrace(tracePath);
 	return 0;
-}
\ No newline at end of file
+}
+
+#ifdef _WIN32
+int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
+{
+	return RunApp(__argc, __argv);
+}
+#else
+int main(int argc, char** argv)
+{
+	return RunApp(argc, argv);
+}
+#endif
@@ -0,0 +1,176 @@
+#include "noise_bake.h"
+#include "cpu_renderer_internal.h"
+#include "parallel.h"
+#include "simd_math.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Subir si cambia el algoritmo del hash o de simd::Sin: invalida los lattices en disco.
+static const uint32_t kNoiseBakeVersion = 1;
+
+// ---------------------------
+// Kernel escalar (referencia)
+// ---------------------------
+
+// Mismas operaciones, en el mismo orden, que hash() en fullscreen.glsl y que cpu_renderer.cpp.
+
+static inline float Fract(float x) { return x - floorf(x); }
+
+static inline float SinHash(float x, float y)
+{
+	return Fract(simd::Sin(x * shade::kHashX + y * shade::kHashY) * shade::kHashScale);
+}
+
+static inline float CheapHash(float x, float y)
+{
+	// p3 = fract(p.xyx * 0.1031); p3 += dot(p3, p3.yzx + 33.33); fract((p3.x + p3.y) * p3.z)
+	const float p3x = Fract(x * shade::kCheapHashScale);
+	const float p3y = Fract(y * shade::kCheapHashScale);
+	const float p3z = p3x;
+	const float d = p3x * (p3y + shade::kCheapHashBias) + p3y * (p3z + shade::kCheapHashBias) + p3z * (p3x + shade::kCheapHashBias);
+	return Fract(((p3x + d) + (p3y + d)) * (p3z + d));
+}
+
+static inline uint16_t Quantize(float h)
+{
+	return (uint16_t)(uint32_t)(h * shade::kNoiseQuantize + 0.5f);
+}
+
+void NoiseBakeRowScalar(int y, int period, uint16_t* sinRow, uint16_t* cheapRow)
+{
+	const float fy = (float)y;
+	for (int x = 0; x < period; ++x)
+	{
+		sinRow[x] = Quantize(SinHash((float)x, fy));
+		cheapRow[x] = Quantize(CheapHash((float)x, fy));
+	}
+}
+
+// ---------------------------
+// Kernel SSE2
+// ---------------------------
+
+static inline __m128 SinHashSSE(__m128 x, __m128 y)
+{
+	const __m128 d = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(shade::kHashX)), _mm_mul_ps(y, _mm_set1_ps(shade::kHashY)));
+	return simd::Fract(_mm_mul_ps(simd::Sin(d), _mm_set1_ps(shade::kHashScale)));
+}
+
+static inline __m128 CheapHashSSE(__m128 x, __m128 y)
+{
+	const __m128 bias = _mm_set1_ps(shade::kCheapHashBias);
+	const __m128 p3x = simd::Fract(_mm_mul_ps(x, _mm_set1_ps(shade::kCheapHashScale)));
+	const __m128 p3y = simd::Fract(_mm_mul_ps(y, _mm_set1_ps(shade::kCheapHashScale)));
+	const __m128 p3z = p3x;
+	__m128 d = _mm_mul_ps(p3x, _mm_add_ps(p3y, bias));
+	d = _mm_add_ps(d, _mm_mul_ps(p3y, _mm_add_ps(p3z, bias)));
+	d = _mm_add_ps(d, _mm_mul_ps(p3z, _mm_add_ps(p3x, bias)));
+	const __m128 sum = _mm_add_ps(_mm_add_ps(p3x, d), _mm_add_ps(p3y, d));
+	return simd::Fract(_mm_mul_ps(sum, _mm_add_ps(p3z, d)));
+}
+
+// 8 floats en [0,1) -> 8 unorm16. SSE2 no tiene packus_epi32: se corre el rango a int16 con signo,
+// se empaqueta con saturacion y se vuelve a correr.
+static inline __m128i QuantizeSSE(__m128 lo, __m128 hi)
+{
+	const __m128 scale = _mm_set1_ps(shade::kNoiseQuantize);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128i bias = _mm_set1_epi32(32768);
+	const __m128i a = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(lo, scale), half)), bias);
+	const __m128i b = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(hi, scale), half)), bias);
+	return _mm_xor_si128(_mm_packs_epi32(a, b), _mm_set1_epi16((short)0x8000));
+}
+
+void NoiseBakeRowSSE2(int y, int period, uint16_t* sinRow, uint16_t* cheapRow)
+{
+	const __m128 vy = _mm_set1_ps((float)y);
+	const __m128 ramp = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+	const __m128 four = _mm_set1_ps(4.0f);
+
+	for (int x = 0; x < period; x += 8)
+	{
+		const __m128 x0 = _mm_add_ps(_mm_set1_ps((float)x), ramp);
+		const __m128 x1 = _mm_add_ps(x0, four);
+		_mm_storeu_si128((__m128i*)(sinRow + x), QuantizeSSE(SinHashSSE(x0, vy), SinHashSSE(x1, vy)));
+		_mm_storeu_si128((__m128i*)(cheapRow + x), QuantizeSSE(CheapHashSSE(x0, vy), CheapHashSSE(x1, vy)));
+	}
+}
+
+// ---------------------------
+// Dispatch
+// ---------------------------
+
+size_t NoiseBakeBytes(int period)
+{
+	return (size_t)period * (size_t)period * (size_t)kNoiseLayers * sizeof(uint16_t);
+}
+
+void NoiseBakeLattice(uint16_t* dst, int period, CpuShadePath path)
+{
+	if (!dst || period < 16 || (period & (period - 1)) != 0) return;
+
+	path = CpuResolveShadePath(path);
+	NoiseBakeRowFn row = NoiseBakeRowScalar;
+	if (path == CpuShadePath::SSE2) row = NoiseBakeRowSSE2;
+	if (path == CpuShadePath::AVX2) row = NoiseBakeRowAVX2;
+
+	const size_t layerTexels = (size_t)period * (size_t)period;
+	ParallelFor(period, 16, [&](int begin, int end)
+	{
+		for (int y = begin; y < end; ++y)
+		{
+			uint16_t* sinRow = dst + (size_t)y * (size_t)period;
+			row(y, period, sinRow, sinRow + layerTexels);
+		}
+	});
+}
+
+float NoiseAnalyticHash(int layer, float x, float y)
+{
+	return layer == 0 ? SinHash(x, y) : CheapHash(x, y);
+}
+
+int NoiseBakeVerify(const uint16_t* lattice, int period, int rowStep)
+{
+	if (rowStep < 1) rowStep = 1;
+	const size_t layerTexels = (size_t)period * (size_t)period;
+
+	int mismatches = 0;
+	for (int layer = 0; layer < kNoiseLayers; ++layer)
+	{
+		for (int y = 0; y < period; y += rowStep)
+		{
+			const uint16_t* row = lattice + layerTexels * (size_t)layer + (size_t)y * (size_t)period;
+			for (int x = 0; x < period; ++x)
+				if (row[x] != Quantize(NoiseAnalyticHash(layer, (float)x, (float)y))) ++mismatches;
+		}
+	}
+	return mismatches;
+}
+
+uint64_t NoiseBakeKey(int period)
+{
+	const float constants[] = {
+		shade::kHashX, shade::kHashY, shade::kHashScale,
+		shade::kCheapHashScale, shade::kCheapHashBias, shade::kNoiseQuantize,
+	};
+	const uint32_t shape[] = { kNoiseBakeVersion, (uint32_t)period, (uint32_t)kNoiseLayers, (uint32_t)sizeof(uint16_t) };
+
+	// FNV-1a sobre los bytes de las constantes y la forma del lattice.
+	uint64_t h = 1469598103934665603ull;
+	auto mix = [&](const void* data, size_t size)
+	{
+		const uint8_t* p = (const uint8_t*)data;
+		for (size_t i = 0; i < size; ++i) h = (h ^ p[i]) * 1099511628211ull;
+	};
+	mix(constants, sizeof(constants));
+	mix(shape, sizeof(shape));
+	return h;
+}
+
+void NoiseBakeAssetName(int period, char* out, size_t size)
+{
+	snprintf(out, size, "noise/lattice-%016llx.r16", (unsigned long long)NoiseBakeKey(period));
+}
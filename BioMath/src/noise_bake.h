@@ -0,0 +1,53 @@
+#pragma once
+
+#include "cpu_renderer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ---------------------------
+// Lattice de ruido horneado
+// ---------------------------
+
+// noise() del shader de fondo evalua hash() en las 4 esquinas de la celda: cuatro fract(sin(...))
+// por pixel y por octava. hash() solo se evalua en puntos enteros, asi que se puede precalcular:
+// este modulo hornea hash(x, y) para x, y en [0, period) y el shader lo lee con texelFetch
+// (BAKED_NOISE en fullscreen.glsl) envolviendo la coordenada con & (period - 1).
+//
+// Dentro del primer periodo el resultado es el mismo hash que evalua el shader (salvo la
+// cuantizacion a 16 bits, ~1e-5); afuera el ruido se repite, sin costuras. Con period = 1024 y
+// la escala del fondo (6 celdas por pantalla, 0.15 celdas/s) eso pasa despues de casi 2 horas.
+//
+// Capas (una textura 2D array):
+//   0 = hash con sin() (todas las variantes salvo CHEAP_HASH, y el que reproduce cpu_renderer)
+//   1 = hash aritmetico de CHEAP_HASH
+//
+// Los texels son unorm16, fila y = hash(*, y), capa tras capa. El horneado reparte filas entre
+// threads (ParallelFor) y usa los mismos kernels/ISA que cpu_renderer: SSE2 o AVX2 dan
+// exactamente los mismos bits que el escalar.
+
+static const int kNoisePeriod = 1024;
+static const int kNoiseLayers = 2;
+
+static_assert((kNoisePeriod & (kNoisePeriod - 1)) == 0 && kNoisePeriod % 16 == 0, "the period must be a power of two (shader wraps with &)");
+
+// Bytes de todo el lattice (todas las capas).
+size_t NoiseBakeBytes(int period);
+
+// Hornea el lattice en 'dst' (NoiseBakeBytes(period) bytes). 'period' potencia de 2, >= 16.
+void NoiseBakeLattice(uint16_t* dst, int period, CpuShadePath path = CpuShadePath::Auto);
+
+// hash() analitico de la capa, en float, exactamente como lo evalua cpu_renderer.
+float NoiseAnalyticHash(int layer, float x, float y);
+
+// Verificacion contra el analitico: recalcula una de cada 'rowStep' filas (1 = todas) y devuelve
+// cuantos texels no coinciden con la cuantizacion del escalar. 0 = lattice correcto.
+int NoiseBakeVerify(const uint16_t* lattice, int period, int rowStep);
+
+// Clave del generador (constantes del hash, periodo, formato). Cambia si cambia algo que haga
+// invalido un lattice guardado en disco.
+uint64_t NoiseBakeKey(int period);
+
+// Nombre del lattice dentro del paquete de assets (asset_pack.h): "noise/lattice-<clave>.r16". La
+// clave va en el nombre, asi que un paquete hecho con otro generador simplemente no lo tiene.
+void NoiseBakeAssetName(int period, char* out, size_t size);
@@ -0,0 +1,50 @@
+// Kernel AVX2 del horneado de ruido (noise_bake.h). Igual que cpu_renderer_avx2.cpp: unidad de
+// compilacion propia por -mavx2, solo se llama si GetCpuFeatures().avx2.
+
+#include "cpu_renderer_internal.h"
+#include "simd_math.h"
+
+static inline __m256 SinHashAVX2(__m256 x, __m256 y)
+{
+	const __m256 d = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(shade::kHashX)), _mm256_mul_ps(y, _mm256_set1_ps(shade::kHashY)));
+	return simd::Fract(_mm256_mul_ps(simd::Sin(d), _mm256_set1_ps(shade::kHashScale)));
+}
+
+static inline __m256 CheapHashAVX2(__m256 x, __m256 y)
+{
+	const __m256 bias = _mm256_set1_ps(shade::kCheapHashBias);
+	const __m256 p3x = simd::Fract(_mm256_mul_ps(x, _mm256_set1_ps(shade::kCheapHashScale)));
+	const __m256 p3y = simd::Fract(_mm256_mul_ps(y, _mm256_set1_ps(shade::kCheapHashScale)));
+	const __m256 p3z = p3x;
+	__m256 d = _mm256_mul_ps(p3x, _mm256_add_ps(p3y, bias));
+	d = _mm256_add_ps(d, _mm256_mul_ps(p3y, _mm256_add_ps(p3z, bias)));
+	d = _mm256_add_ps(d, _mm256_mul_ps(p3z, _mm256_add_ps(p3x, bias)));
+	const __m256 sum = _mm256_add_ps(_mm256_add_ps(p3x, d), _mm256_add_ps(p3y, d));
+	return simd::Fract(_mm256_mul_ps(sum, _mm256_add_ps(p3z, d)));
+}
+
+// 16 floats en [0,1) -> 16 unorm16. packus trabaja por mitades de 128 bits: el permute deja los
+// texels en orden.
+static inline __m256i QuantizeAVX2(__m256 lo, __m256 hi)
+{
+	const __m256 scale = _mm256_set1_ps(shade::kNoiseQuantize);
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256i a = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(lo, scale), half));
+	const __m256i b = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(hi, scale), half));
+	return _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8);
+}
+
+void NoiseBakeRowAVX2(int y, int period, uint16_t* sinRow, uint16_t* cheapRow)
+{
+	const __m256 vy = _mm256_set1_ps((float)y);
+	const __m256 ramp = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m256 eight = _mm256_set1_ps(8.0f);
+
+	for (int x = 0; x < period; x += 16)
+	{
+		const __m256 x0 = _mm256_add_ps(_mm256_set1_ps((float)x), ramp);
+		const __m256 x1 = _mm256_add_ps(x0, eight);
+		_mm256_storeu_si256((__m256i*)(sinRow + x), QuantizeAVX2(SinHashAVX2(x0, vy), SinHashAVX2(x1, vy)));
+		_mm256_storeu_si256((__m256i*)(cheapRow + x), QuantizeAVX2(CheapHashAVX2(x0, vy), CheapHashAVX2(x1, vy)));
+	}
+}
@@ -0,0 +1,295 @@
+#include "noise_texture.h"
+#include "assets.h"
+#include "gl_state.h"
+#include "noise_bake.h"
+#include "platform.h"
+#include "profiler.h"
+
+#include <string.h>
+#include <vector>
+
+// Archivo de cache: header + lattice tal cual lo espera glTexImage3D. El nombre lleva la clave del
+// generador, asi que un cambio de constantes o de periodo nunca lee un archivo viejo.
+struct NoiseCacheHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t period;
+	uint32_t layers;
+	uint64_t key;
+	uint64_t bytes;
+};
+
+static const char kNoiseCacheMagic[4] = { 'B', 'M', 'N', 'L' };
+static const uint32_t kNoiseCacheVersion = 1;
+static const int kVerifyRowStep = 64; // filas recalculadas al cargar del disco: 1 de cada 64
+
+static_assert(sizeof(NoiseCacheHeader) % 16 == 0, "keep the lattice aligned inside the mapping");
+
+struct NoiseTexture
+{
+	bool active = false;
+	GLuint texture = 0;
+
+	// Reporte
+	const char* source = "off";       // "off" | "baked" | "cache" | "pack"
+	const char* cache = "disabled";   // "disabled" | "hit" | "miss" | "rejected"
+	const char* bakePath = "";
+	double bakeMs = 0.0;
+	double loadMs = 0.0;              // mapear + verificar
+	double uploadMs = 0.0;
+};
+
+static NoiseTexture g_noise;
+
+void ParseNoiseOptions(int argc, char** argv, NoiseOptions* opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--noise") == 0 && i + 1 < argc)
+			opts->mode = strcmp(argv[++i], "baked") == 0 ? NoiseMode::Baked : NoiseMode::Analytic;
+		else if (strcmp(argv[i], "--no-noise-cache") == 0)
+			opts->cache = false;
+	}
+}
+
+static double MsSince(uint64_t startTicks)
+{
+	return (double)(PlatformTicks() - startTicks) * 1000.0 / (double)PlatformTickFrequency();
+}
+
+static std::string CachePath(uint64_t key)
+{
+	char dir[1024];
+	if (!PlatformCacheDirectory(dir, sizeof(dir))) return std::string();
+
+	char name[64];
+	snprintf(name, sizeof(name), "/noise-lattice-%016llx.bin", (unsigned long long)key);
+	return std::string(dir) + name;
+}
+
+static bool Upload(const uint16_t* lattice)
+{
+	PROFILE_ZONE("NoiseUpload");
+	const uint64_t start = PlatformTicks();
+
+	glGenTextures(1, &g_noise.texture);
+	GLStateBindTexture2DArray(0, g_noise.texture);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // sin mipmaps: texelFetch lee el nivel 0
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage3D_ptr(GL_TEXTURE_2D_ARRAY, 0, GL_R16, kNoisePeriod, kNoisePeriod, kNoiseLayers, 0,
+		GL_RED, GL_UNSIGNED_SHORT, lattice);
+
+	const GLenum error = glGetError();
+	g_noise.uploadMs = MsSince(start);
+	if (error != GL_NO_ERROR)
+	{
+		fprintf(stderr, "noise: glTexImage3D failed (0x%04X), using the analytic hash\n", error);
+		GLStateDeleteTexture(g_noise.texture);
+		g_noise.texture = 0;
+		return false;
+	}
+	return true;
+}
+
+// Mapea el archivo y lo verifica: si sirve, el mapping queda abierto para subirlo desde ahi.
+// false si no hay archivo o no pasa la verificacion.
+static bool MapCache(const std::string& path, uint64_t key, PlatformFileMapping* mapping)
+{
+	PROFILE_ZONE("NoiseCacheLoad");
+	const uint64_t start = PlatformTicks();
+
+	if (!PlatformMapFile(path.c_str(), mapping))
+	{
+		g_noise.cache = "miss";
+		return false;
+	}
+
+	const size_t bytes = NoiseBakeBytes(kNoisePeriod);
+	const NoiseCacheHeader* header = (const NoiseCacheHeader*)mapping->data;
+	const uint16_t* lattice = (const uint16_t*)(mapping->data + sizeof(NoiseCacheHeader));
+	const bool valid = mapping->size == sizeof(NoiseCacheHeader) + bytes &&
+		memcmp(header->magic, kNoiseCacheMagic, sizeof(kNoiseCacheMagic)) == 0 &&
+		header->version == kNoiseCacheVersion && header->period == (uint32_t)kNoisePeriod &&
+		header->layers == (uint32_t)kNoiseLayers && header->key == key && header->bytes == bytes &&
+		NoiseBakeVerify(lattice, kNoisePeriod, kVerifyRowStep) == 0;
+	g_noise.loadMs = MsSince(start);
+
+	if (!valid)
+	{
+		g_noise.cache = "rejected";
+		PlatformUnmapFile(mapping);
+		return false;
+	}
+	g_noise.cache = "hit";
+	return true;
+}
+
+static void StoreToCache(const std::string& path, uint64_t key, const uint16_t* lattice)
+{
+	PROFILE_ZONE("NoiseCacheStore");
+
+	NoiseCacheHeader header;
+	memcpy(header.magic, kNoiseCacheMagic, sizeof(kNoiseCacheMagic));
+	header.version = kNoiseCacheVersion;
+	header.period = (uint32_t)kNoisePeriod;
+	header.layers = (uint32_t)kNoiseLayers;
+	header.key = key;
+	header.bytes = NoiseBakeBytes(kNoisePeriod);
+
+	// Igual que el cache de programas: se escribe aparte y se renombra.
+	const std::string tmpPath = path + ".tmp";
+	FILE* f = fopen(tmpPath.c_str(), "wb");
+	if (!f) return;
+	const bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+		fwrite(lattice, 1, (size_t)header.bytes, f) == (size_t)header.bytes;
+	if (fclose(f) != 0 || !ok)
+	{
+		remove(tmpPath.c_str());
+		return;
+	}
+	remove(path.c_str()); // rename no pisa en Windows
+	if (rename(tmpPath.c_str(), path.c_str()) != 0) remove(tmpPath.c_str());
+}
+
+// Lo que deja NoiseTexturePrepare para NoiseTextureInit: el lattice listo para subir, desde el
+// paquete de assets, el archivo mapeado o recien horneado.
+struct NoisePrepared
+{
+	bool done = false;
+	const uint16_t* lattice = nullptr;
+	const char* source = "off";
+	PlatformFileMapping mapping;
+	bool mapped = false;
+	std::vector<uint16_t> baked;
+	std::vector<uint8_t> packStorage;   // solo si la entrada del paquete estaba comprimida
+};
+
+static NoisePrepared g_prepared;
+
+static void ReleasePrepared()
+{
+	if (g_prepared.mapped) PlatformUnmapFile(&g_prepared.mapping);
+	g_prepared = NoisePrepared();
+}
+
+// El lattice del paquete montado (--assets): sin comprimir, 'lattice' apunta al mapping del
+// paquete y se sube desde ahi. Se verifica igual que el archivo de cache.
+static bool LoadFromPack()
+{
+	char name[64];
+	NoiseBakeAssetName(kNoisePeriod, name, sizeof(name));
+	const uint64_t start = PlatformTicks();
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	if (!AssetsLoad(name, &data, &size, &g_prepared.packStorage)) return false;
+
+	const bool valid = size == NoiseBakeBytes(kNoisePeriod) &&
+		NoiseBakeVerify((const uint16_t*)data, kNoisePeriod, kVerifyRowStep) == 0;
+	g_noise.loadMs = MsSince(start);
+	if (!valid)
+	{
+		fprintf(stderr, "noise: '%s' in the asset pack does not verify, ignoring it\n", name);
+		return false;
+	}
+	g_prepared.lattice = (const uint16_t*)data;
+	g_prepared.source = "pack";
+	return true;
+}
+
+void NoiseTexturePrepare(const NoiseOptions& opts)
+{
+	ReleasePrepared();
+	g_noise = NoiseTexture();
+	g_prepared.done = true;
+	if (opts.mode != NoiseMode::Baked) return;
+	PROFILE_ZONE("NoiseTexturePrepare");
+
+	if (LoadFromPack()) return;
+
+	const uint64_t key = NoiseBakeKey(kNoisePeriod);
+	const std::string path = opts.cache ? CachePath(key) : std::string();
+
+	if (!path.empty() && MapCache(path, key, &g_prepared.mapping))
+	{
+		g_prepared.mapped = true;
+		g_prepared.lattice = (const uint16_t*)(g_prepared.mapping.data + sizeof(NoiseCacheHeader));
+		g_prepared.source = "cache";
+		return;
+	}
+
+	g_prepared.baked.resize(NoiseBakeBytes(kNoisePeriod) / sizeof(uint16_t));
+	{
+		PROFILE_ZONE("NoiseBake");
+		const uint64_t start = PlatformTicks();
+		NoiseBakeLattice(g_prepared.baked.data(), kNoisePeriod);
+		g_noise.bakeMs = MsSince(start);
+		g_noise.bakePath = CpuShadePathName(CpuResolveShadePath(CpuShadePath::Auto));
+	}
+	if (!path.empty()) StoreToCache(path, key, g_prepared.baked.data());
+
+	g_prepared.lattice = g_prepared.baked.data();
+	g_prepared.source = "baked";
+}
+
+bool NoiseTextureInit(const NoiseOptions& opts)
+{
+	if (!g_prepared.done) NoiseTexturePrepare(opts);
+	if (opts.mode != NoiseMode::Baked || !g_prepared.lattice)
+	{
+		ReleasePrepared();
+		return false;
+	}
+	if (!glTexImage3D_ptr || !glActiveTexture_ptr)
+	{
+		fprintf(stderr, "noise: glTexImage3D not available, using the analytic hash\n");
+		ReleasePrepared();
+		return false;
+	}
+	PROFILE_ZONE("NoiseTextureInit");
+
+	const bool ok = Upload(g_prepared.lattice);
+	if (ok)
+	{
+		g_noise.source = g_prepared.source;
+		g_noise.active = true;
+	}
+	ReleasePrepared();
+	return ok;
+}
+
+void NoiseTextureShutdown()
+{
+	ReleasePrepared(); // preparado y nunca subido (InitGL fallo antes)
+	GLStateDeleteTexture(g_noise.texture);
+	g_noise.texture = 0;
+	g_noise.active = false;
+}
+
+bool NoiseTextureActive()
+{
+	return g_noise.active;
+}
+
+void NoiseTextureBind()
+{
+	if (g_noise.active) GLStateBindTexture2DArray(0, g_noise.texture);
+}
+
+std::string NoiseShaderDefines()
+{
+	if (!g_noise.active) return std::string();
+
+	char defines[64];
+	snprintf(defines, sizeof(defines), "#define BAKED_NOISE 1\n#define NOISE_PERIOD %d\n", kNoisePeriod);
+	return defines;
+}
+
+void WriteNoiseJson(FILE* f)
+{
+	fprintf(f, "\"noise\": { \"mode\": \"%s\", \"source\": \"%s\", \"cache\": \"%s\", \"period\": %d, \"bytes\": %llu",
+		g_noise.active ? "baked" : "analytic", g_noise.source, g_noise.cache, kNoisePeriod,
+		(unsigned long long)(g_noise.active ? NoiseBakeBytes(kNoisePeriod) : 0));
+	fprintf(f, ", \"bake_ms\": %.3f, \"bake_path\": \"%s\", \"load_ms\": %.3f, \"upload_ms\": %.3f }",
+		g_noise.bakeMs, g_noise.bakePath, g_noise.loadMs, g_noise.uploadMs);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "gl_api.h"
+
+#include <stdio.h>
+#include <string>
+
+// ---------------------------
+// Ruido horneado en textura
+// ---------------------------
+
+// Modo --noise baked: el lattice de noise_bake.h se sube como GL_TEXTURE_2D_ARRAY (R16, una capa
+// por hash) y fullscreen.glsl compila con BAKED_NOISE, que cambia los 4 fract(sin(...)) por
+// pixel y octava por 4 texelFetch.
+//
+// El lattice se guarda en la carpeta de cache (PlatformCacheDirectory) la primera vez; en los
+// arranques siguientes se mapea el archivo (PlatformMapFile) y se sube directo desde el mapping,
+// sin copia intermedia. Antes de usarlo se recalcula una muestra de filas contra el hash analitico:
+// si no coincide (archivo viejo o corrupto) se vuelve a hornear y se reescribe.
+//
+// La textura va en la unidad 0, que es el valor por defecto de un sampler: no hace falta
+// glUniform1i. El pase de upsample (dynamic_resolution.h) usa la misma unidad con otro target.
+
+enum class NoiseMode
+{
+	Analytic,  // hash() evaluado en el shader (el original)
+	Baked,     // hash() leido del lattice horneado
+};
+
+struct NoiseOptions
+{
+	NoiseMode mode = NoiseMode::Analytic;
+	bool cache = true;
+};
+
+// --noise analytic|baked, --no-noise-cache
+void ParseNoiseOptions(int argc, char** argv, NoiseOptions* opts);
+
+// La parte de CPU de NoiseTextureInit, sin GL: mapea y verifica el archivo de cache, o hornea el
+// lattice y lo guarda. Puede correr en otro thread mientras se crea el contexto (startup.h); el
+// resultado queda para el NoiseTextureInit siguiente.
+void NoiseTexturePrepare(const NoiseOptions& opts);
+
+// Requiere contexto GL. Con mode = Baked sube el lattice (si no se llamo a NoiseTexturePrepare,
+// antes lo carga u hornea aca). Devuelve false si no
+// se pudo: el shader sigue con el hash analitico y el motivo va a stderr.
+bool NoiseTextureInit(const NoiseOptions& opts);
+void NoiseTextureShutdown();
+bool NoiseTextureActive();
+
+// Bindea el lattice para el pase de la escena (no hace nada en modo analitico).
+void NoiseTextureBind();
+
+// #defines para fullscreen.glsl ("" en modo analitico).
+std::string NoiseShaderDefines();
+
+// "noise": { ... } para los reportes JSON.
+void WriteNoiseJson(FILE* f);
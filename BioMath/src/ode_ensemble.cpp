@@ -0,0 +1,178 @@
+#include "ode_ensemble.h"
+#include "ode_ensemble_kernels.h"
+#include "parallel.h"
+
+#include <atomic>
+#include <math.h>
+#include <string.h>
+
+// ---------------------------
+// Kernels escalar y SSE2 (el AVX2 esta en ode_ensemble_avx2.cpp)
+// ---------------------------
+
+void OdeAdvanceSpanScalar(const OdeSpan& span, int lane0, int lane1, OdeSpanStats* stats)
+{
+	ode::AdvanceSpan<lanes::F1>(span, lane0, lane1, stats);
+}
+
+void OdeAdvanceSpanSSE2(const OdeSpan& span, int lane0, int lane1, OdeSpanStats* stats)
+{
+	ode::AdvanceSpan<lanes::F4>(span, lane0, lane1, stats);
+}
+
+// ---------------------------
+// Modelos
+// ---------------------------
+
+const OdeModelInfo& OdeModelGetInfo(OdeModel model)
+{
+	return kOdeModels[(int)model];
+}
+
+const char* OdeMethodName(OdeMethod method)
+{
+	return method == OdeMethod::RK45 ? "rk45" : "rk4";
+}
+
+bool OdeModelFind(const char* name, OdeModel* model)
+{
+	for (int i = 0; i < kOdeModelCount; ++i)
+	{
+		if (strcmp(kOdeModels[i].name, name) != 0) continue;
+		*model = (OdeModel)i;
+		return true;
+	}
+	return false;
+}
+
+bool OdeMethodFind(const char* name, OdeMethod* method)
+{
+	if (strcmp(name, "rk4") == 0) *method = OdeMethod::RK4;
+	else if (strcmp(name, "rk45") == 0) *method = OdeMethod::RK45;
+	else return false;
+	return true;
+}
+
+// ---------------------------
+// Ensamble
+// ---------------------------
+
+bool OdeEnsembleInit(OdeEnsemble* ens, OdeModel model, OdeMethod method, int count, float tolerance)
+{
+	if (count < 1) return false;
+
+	const OdeModelInfo& info = OdeModelGetInfo(model);
+	ens->model = model;
+	ens->method = method;
+	ens->tolerance = tolerance;
+	ens->count = count;
+	ens->stride = (count + kOdeLaneAlign - 1) / kOdeLaneAlign * kOdeLaneAlign;
+
+	// Grilla casi cuadrada: columnas = ceil(sqrt(count)).
+	int columns = (int)sqrt((double)count);
+	if (columns * columns < count) ++columns;
+	ens->sweepColumns = columns;
+	ens->sweepRows = (count + columns - 1) / columns;
+
+	const size_t stride = (size_t)ens->stride;
+	ens->p.assign(stride * kOdeParams, 0.0f);
+	for (int lane = 0; lane < ens->stride; ++lane)
+	{
+		const int i = lane < count ? lane : count - 1;
+		const float u = ((float)(i % columns) + 0.5f) / (float)columns;
+		const float v = ((float)(i / columns) + 0.5f) / (float)ens->sweepRows;
+		ens->p[(size_t)lane] = info.paramMin[0] + (info.paramMax[0] - info.paramMin[0]) * u;
+		ens->p[stride + (size_t)lane] = info.paramMin[1] + (info.paramMax[1] - info.paramMin[1]) * v;
+	}
+
+	ens->y.assign(stride * (size_t)info.vars, 0.0f);
+	ens->h.assign(stride, info.dt);
+	OdeEnsembleReset(ens);
+	return true;
+}
+
+void OdeEnsembleReset(OdeEnsemble* ens)
+{
+	const OdeModelInfo& info = OdeModelGetInfo(ens->model);
+	const size_t stride = (size_t)ens->stride;
+	for (int v = 0; v < info.vars; ++v)
+		for (size_t i = 0; i < stride; ++i) ens->y[(size_t)v * stride + i] = info.y0[v];
+	for (float& h : ens->h) h = info.dt;
+	ens->time = 0.0;
+}
+
+void OdeEnsembleAdvance(OdeEnsemble* ens, float duration, CpuShadePath path)
+{
+	if (ens->count <= 0 || !(duration > 0.0f)) return;
+
+	path = CpuResolveShadePath(path);
+	OdeAdvanceSpanFn span = OdeAdvanceSpanScalar;
+	if (path == CpuShadePath::SSE2) span = OdeAdvanceSpanSSE2;
+	if (path == CpuShadePath::AVX2) span = OdeAdvanceSpanAVX2;
+
+	const OdeModelInfo& info = OdeModelGetInfo(ens->model);
+	OdeSpan s = {};
+	s.model = (int)ens->model;
+	s.method = (int)ens->method;
+	s.duration = duration;
+	s.rk4Steps = (int)ceilf(duration / info.dt - 1e-3f); // sin un paso extra por redondeo
+	if (s.rk4Steps < 1) s.rk4Steps = 1;
+	s.rk4Step = duration / (float)s.rk4Steps;
+	s.minStep = info.dt * 1e-4f;
+	s.tolerance = ens->tolerance;
+	s.y = ens->y.data();
+	s.p = ens->p.data();
+	s.h = ens->h.data();
+	s.stride = (size_t)ens->stride;
+
+	std::atomic<uint64_t> accepted(0), rejected(0);
+	ParallelFor(ens->stride, kOdeGrainLanes, [&](int lane0, int lane1)
+	{
+		OdeSpanStats stats = {};
+		span(s, lane0, lane1, &stats);
+		accepted.fetch_add(stats.accepted, std::memory_order_relaxed);
+		rejected.fetch_add(stats.rejected, std::memory_order_relaxed);
+	});
+
+	ens->time += (double)duration;
+	if (ens->method == OdeMethod::RK4)
+		ens->accepted += (uint64_t)s.rk4Steps * (uint64_t)ens->stride;
+	ens->accepted += accepted.load();
+	ens->rejected += rejected.load();
+}
+
+// ---------------------------
+// Referencia en double
+// ---------------------------
+
+void OdeReferenceInit(OdeReference* ref, const OdeEnsemble& ens)
+{
+	ref->model = ens.model;
+	ref->count = ens.count;
+	ref->stride = ens.stride;
+	ref->y.assign(ens.y.begin(), ens.y.end());
+	ref->p.assign(ens.p.begin(), ens.p.end());
+}
+
+void OdeReferenceAdvance(OdeReference* ref, double duration, int subdivisions)
+{
+	if (ref->count <= 0 || !(duration > 0.0)) return;
+
+	const double dt = (double)OdeModelGetInfo(ref->model).dt / (double)(subdivisions > 0 ? subdivisions : 1);
+	int steps = (int)ceil(duration / dt - 1e-6);
+	if (steps < 1) steps = 1;
+	const double step = duration / (double)steps;
+
+	ParallelFor(ref->stride, kOdeGrainLanes, [&](int lane0, int lane1)
+	{
+		double* y = ref->y.data();
+		const double* p = ref->p.data();
+		const size_t stride = (size_t)ref->stride;
+		switch (ref->model)
+		{
+		case OdeModel::LotkaVolterra: ode::AdvanceRK4<ode::LotkaVolterra, lanes::D1>(y, p, stride, lane0, lane1, steps, step); break;
+		case OdeModel::SIR:           ode::AdvanceRK4<ode::SIR, lanes::D1>(y, p, stride, lane0, lane1, steps, step); break;
+		case OdeModel::HodgkinHuxley: ode::AdvanceRK4<ode::HodgkinHuxley, lanes::D1>(y, p, stride, lane0, lane1, steps, step); break;
+		}
+	});
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "cpu_renderer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// ---------------------------
+// Ensamble de EDOs
+// ---------------------------
+
+// Muchas copias independientes de un sistema chico de EDOs (Lotka-Volterra, SIR, Hodgkin-Huxley),
+// cada una con sus parametros: un barrido 2D sobre los dos parametros del modelo (tabla
+// kOdeModels). Todas empiezan del mismo estado y avanzan juntas en el tiempo.
+//
+// El estado es SoA (un array por variable, 'stride' lanes cada uno) y cada lane SIMD integra un
+// sistema distinto: el kernel es un solo template (ode_ensemble_kernels.h sobre simd_lanes.h)
+// compilado para 1, 4 y 8 lanes. Los grupos de lanes se reparten entre threads (ParallelFor).
+// Escalar, SSE2 y AVX2 hacen las mismas operaciones en el mismo orden (sin FMA): dan los mismos bits.
+//
+// Metodos:
+//   RK4   paso fijo: 'duration' se parte en pasos iguales de a lo sumo dt del modelo.
+//   RK45  Dormand-Prince 5(4) con paso adaptativo por lane (FSAL). Cada lane acepta o rechaza su
+//         paso por su cuenta (mascaras); el grupo sigue hasta que todas sus lanes llegan al final,
+//         asi que un sistema rigido dentro del grupo frena a los otros 7 (se ve en "rejected").
+//
+// La referencia (OdeReference) es el mismo template en double, para medir la precision.
+
+enum class OdeModel
+{
+	LotkaVolterra,
+	SIR,
+	HodgkinHuxley,
+};
+
+enum class OdeMethod
+{
+	RK4,
+	RK45,
+};
+
+static const int kOdeMaxVars = 4;
+static const int kOdeParams = 2;        // ejes del barrido
+static const int kOdeLaneAlign = 8;     // 'stride' multiplo de esto (el ancho de AVX2)
+static const int kOdeGrainLanes = 1024; // lanes por bloque de ParallelFor
+static const int kOdeMaxIterations = 100000; // por grupo y llamada a RK45 (cinturon de seguridad)
+static const float kOdeDefaultTolerance = 1e-5f;
+
+struct OdeModelInfo
+{
+	const char* name;
+	int vars;
+	const char* varNames[kOdeMaxVars];
+	float y0[kOdeMaxVars];
+	const char* paramNames[kOdeParams];
+	float paramMin[kOdeParams];   // barrido: lane (i, j) de la grilla -> min + (max - min) * (i + 0.5) / n
+	float paramMax[kOdeParams];
+	float dt;                     // paso de RK4 y paso inicial de RK45
+	float timePerTick;            // tiempo del modelo por tick de simulacion a 1x
+	float restartTime;            // vuelve a y0 al pasar este tiempo (0 = nunca)
+	int plotX, plotY;             // variables del grafico de fase
+	float plotMin[2];
+	float plotMax[2];
+};
+
+// Unidades: LV y SIR adimensionales (SIR en fraccion de la poblacion, tiempo en dias); HH en ms,
+// mV, mS/cm^2 y uA/cm^2 (convencion moderna, reposo en -65 mV).
+static constexpr OdeModelInfo kOdeModels[] = {
+	{ "lv", 2, { "prey", "predator" }, { 10.0f, 10.0f },
+		{ "alpha", "gamma" }, { 0.6f, 0.2f }, { 1.6f, 0.8f },
+		0.005f, 0.01f, 0.0f, 0, 1, { 0.0f, 0.0f }, { 40.0f, 30.0f } },
+	{ "sir", 3, { "S", "I", "R" }, { 0.99f, 0.01f, 0.0f },
+		{ "beta", "gamma" }, { 0.1f, 0.05f }, { 1.0f, 0.5f },
+		0.1f, 0.1f, 160.0f, 0, 1, { 0.0f, 0.0f }, { 1.0f, 0.7f } },
+	{ "hh", 4, { "V", "m", "h", "n" }, { -65.0f, 0.05f, 0.6f, 0.32f },
+		{ "I", "gK" }, { 0.0f, 24.0f }, { 20.0f, 48.0f },
+		0.025f, 0.125f, 0.0f, 0, 3, { -80.0f, 0.2f }, { 50.0f, 0.8f } },
+};
+
+static constexpr int kOdeModelCount = (int)(sizeof(kOdeModels) / sizeof(kOdeModels[0]));
+
+struct OdeEnsemble
+{
+	OdeModel model = OdeModel::LotkaVolterra;
+	OdeMethod method = OdeMethod::RK4;
+	float tolerance = kOdeDefaultTolerance;   // RK45: relativa y absoluta
+	int count = 0;
+	int stride = 0;                // count redondeado a kOdeLaneAlign (las lanes de relleno copian la ultima)
+	int sweepColumns = 0;          // grilla del barrido: lane i = (i % columns, i / columns)
+	int sweepRows = 0;
+	std::vector<float> y;          // variable v de la lane i en y[v * stride + i]
+	std::vector<float> p;          // idem con los kOdeParams parametros
+	std::vector<float> h;          // RK45: ultimo paso aceptado de cada lane
+
+	double time = 0.0;
+	uint64_t accepted = 0;         // pasos (por lane, sumados)
+	uint64_t rejected = 0;
+};
+
+const OdeModelInfo& OdeModelGetInfo(OdeModel model);
+const char* OdeMethodName(OdeMethod method);
+
+// Por nombre ("lv", "sir", "hh" / "rk4", "rk45"). false si no existe.
+bool OdeModelFind(const char* name, OdeModel* model);
+bool OdeMethodFind(const char* name, OdeMethod* method);
+
+// Reserva 'count' sistemas, reparte el barrido y los pone en y0. false si count < 1.
+bool OdeEnsembleInit(OdeEnsemble* ens, OdeModel model, OdeMethod method, int count, float tolerance = kOdeDefaultTolerance);
+
+// Vuelve todos los sistemas a y0 y el tiempo a 0 (los parametros no cambian).
+void OdeEnsembleReset(OdeEnsemble* ens);
+
+// Avanza todos los sistemas 'duration' unidades de tiempo del modelo. En paralelo.
+void OdeEnsembleAdvance(OdeEnsemble* ens, float duration, CpuShadePath path = CpuShadePath::Auto);
+
+// Referencia en double: mismo barrido y estado inicial, RK4 con paso dt / 'subdivisions'.
+struct OdeReference
+{
+	OdeModel model = OdeModel::LotkaVolterra;
+	int count = 0;
+	int stride = 0;
+	std::vector<double> y;
+	std::vector<double> p;
+};
+
+// Copia estado y parametros de 'ens' (normalmente recien inicializado).
+void OdeReferenceInit(OdeReference* ref, const OdeEnsemble& ens);
+void OdeReferenceAdvance(OdeReference* ref, double duration, int subdivisions);
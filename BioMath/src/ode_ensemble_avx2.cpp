@@ -0,0 +1,10 @@
+// Kernel AVX2 del ensamble de EDOs (ode_ensemble.h). Igual que cpu_renderer_avx2.cpp: unidad de
+// compilacion propia por -mavx2, solo se llama si GetCpuFeatures().avx2. El template es el mismo
+// de los otros caminos (ode_ensemble_kernels.h), instanciado con 8 lanes.
+
+#include "ode_ensemble_kernels.h"
+
+void OdeAdvanceSpanAVX2(const OdeSpan& span, int lane0, int lane1, OdeSpanStats* stats)
+{
+	ode::AdvanceSpan<lanes::F8>(span, lane0, lane1, stats);
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+// Kernels del ensamble de EDOs (ode_ensemble.h), escritos una vez sobre los tipos de simd_lanes.h.
+// Los incluyen ode_ensemble.cpp (F1, F4, D1) y ode_ensemble_avx2.cpp (F8).
+//
+// Todo pasa por los operadores de V: el orden de las operaciones es el mismo en todos los anchos,
+// asi que escalar, SSE2 y AVX2 dan los mismos bits. Cambiar una formula aca la cambia en todos.
+
+#include "cpu_renderer_internal.h"
+#include "ode_ensemble.h"
+#include "simd_lanes.h"
+
+namespace ode
+{
+	using namespace lanes;
+
+	// ---- Modelos: dy = f(y, p). Autonomos (no dependen de t) ----
+
+	// x' = x (alpha - beta y), y' = y (delta x - gamma). Barrido: alpha, gamma.
+	struct LotkaVolterra
+	{
+		static const int kVars = 2;
+
+		template <typename V>
+		static inline void Eval(const V* y, const V* p, V* dy)
+		{
+			typedef typename V::Scalar S;
+			const V beta = V(S(0.4)), delta = V(S(0.1));
+			dy[0] = y[0] * (p[0] - beta * y[1]);
+			dy[1] = y[1] * (delta * y[0] - p[1]);
+		}
+	};
+
+	// S' = -beta S I, I' = beta S I - gamma I, R' = gamma I. Barrido: beta, gamma.
+	struct SIR
+	{
+		static const int kVars = 3;
+
+		template <typename V>
+		static inline void Eval(const V* y, const V* p, V* dy)
+		{
+			typedef typename V::Scalar S;
+			const V bsi = (p[0] * y[0]) * y[1];
+			const V gi = p[1] * y[1];
+			dy[0] = V(S(0)) - bsi;
+			dy[1] = bsi - gi;
+			dy[2] = gi;
+		}
+	};
+
+	// Hodgkin-Huxley (axon de calamar, C = 1 uF/cm^2). Barrido: corriente inyectada I y gK.
+	// am y an son 0/0 en V = -40 y V = -55: ahi se usa el limite (1 y 0.1).
+	struct HodgkinHuxley
+	{
+		static const int kVars = 4;
+
+		template <typename V>
+		static inline void Eval(const V* y, const V* p, V* dy)
+		{
+			typedef typename V::Scalar S;
+			const V v = y[0], m = y[1], h = y[2], n = y[3];
+			const V one = V(S(1));
+			const V eps = V(S(1e-4));
+
+			const V u = v + V(S(40));
+			const V am = Select(Abs(u) < eps, one, (V(S(0.1)) * u) / (one - Exp(u * V(S(-0.1)))));
+			const V bm = V(S(4)) * Exp((v + V(S(65))) * V(S(-1.0 / 18.0)));
+			const V ah = V(S(0.07)) * Exp((v + V(S(65))) * V(S(-0.05)));
+			const V bh = one / (one + Exp((v + V(S(35))) * V(S(-0.1))));
+			const V w = v + V(S(55));
+			const V an = Select(Abs(w) < eps, V(S(0.1)), (V(S(0.01)) * w) / (one - Exp(w * V(S(-0.1)))));
+			const V bn = V(S(0.125)) * Exp((v + V(S(65))) * V(S(-1.0 / 80.0)));
+
+			const V gNa = V(S(120)), gL = V(S(0.3));
+			const V n2 = n * n;
+			const V iNa = ((gNa * ((m * m) * m)) * h) * (v - V(S(50)));
+			const V iK = (p[1] * (n2 * n2)) * (v - V(S(-77)));
+			const V iL = gL * (v - V(S(-54.387)));
+			dy[0] = ((p[0] - iNa) - iK) - iL;
+			dy[1] = am * (one - m) - bm * m;
+			dy[2] = ah * (one - h) - bh * h;
+			dy[3] = an * (one - n) - bn * n;
+		}
+	};
+
+	// ---- RK4 de paso fijo ----
+
+	template <typename M, typename V>
+	static void AdvanceRK4(typename V::Scalar* yBase, const typename V::Scalar* pBase, size_t stride,
+		int lane0, int lane1, int steps, typename V::Scalar step)
+	{
+		typedef typename V::Scalar S;
+		const int K = M::kVars;
+		const V h = V(step), half = V(step * S(0.5)), sixth = V(step / S(6)), two = V(S(2));
+
+		for (int lane = lane0; lane < lane1; lane += V::kWidth)
+		{
+			V y[kOdeMaxVars], p[kOdeParams];
+			for (int v = 0; v < K; ++v) y[v] = V::Load(yBase + (size_t)v * stride + lane);
+			for (int i = 0; i < kOdeParams; ++i) p[i] = V::Load(pBase + (size_t)i * stride + lane);
+
+			for (int s = 0; s < steps; ++s)
+			{
+				V k1[kOdeMaxVars], k2[kOdeMaxVars], k3[kOdeMaxVars], k4[kOdeMaxVars], t[kOdeMaxVars];
+				M::Eval(y, p, k1);
+				for (int v = 0; v < K; ++v) t[v] = y[v] + half * k1[v];
+				M::Eval(t, p, k2);
+				for (int v = 0; v < K; ++v) t[v] = y[v] + half * k2[v];
+				M::Eval(t, p, k3);
+				for (int v = 0; v < K; ++v) t[v] = y[v] + h * k3[v];
+				M::Eval(t, p, k4);
+				for (int v = 0; v < K; ++v) y[v] = y[v] + sixth * ((k1[v] + k4[v]) + (k2[v] + k3[v]) * two);
+			}
+
+			for (int v = 0; v < K; ++v) y[v].Store(yBase + (size_t)v * stride + lane);
+		}
+	}
+
+	// ---- Dormand-Prince 5(4), paso adaptativo por lane ----
+
+	// Tablero de Butcher. La fila 7 son los pesos de orden 5 (FSAL: k7 es el k1 del paso siguiente);
+	// E = b5 - b4 da el estimador del error.
+	template <typename S>
+	struct DormandPrince
+	{
+		static constexpr S a21 = S(1.0 / 5.0);
+		static constexpr S a31 = S(3.0 / 40.0), a32 = S(9.0 / 40.0);
+		static constexpr S a41 = S(44.0 / 45.0), a42 = S(-56.0 / 15.0), a43 = S(32.0 / 9.0);
+		static constexpr S a51 = S(19372.0 / 6561.0), a52 = S(-25360.0 / 2187.0), a53 = S(64448.0 / 6561.0), a54 = S(-212.0 / 729.0);
+		static constexpr S a61 = S(9017.0 / 3168.0), a62 = S(-355.0 / 33.0), a63 = S(46732.0 / 5247.0), a64 = S(49.0 / 176.0), a65 = S(-5103.0 / 18656.0);
+		static constexpr S b1 = S(35.0 / 384.0), b3 = S(500.0 / 1113.0), b4 = S(125.0 / 192.0), b5 = S(-2187.0 / 6784.0), b6 = S(11.0 / 84.0);
+		static constexpr S e1 = S(71.0 / 57600.0), e3 = S(-71.0 / 16695.0), e4 = S(71.0 / 1920.0), e5 = S(-17253.0 / 339200.0), e6 = S(22.0 / 525.0), e7 = S(-1.0 / 40.0);
+	};
+
+	template <typename M, typename V>
+	static void AdvanceRK45(typename V::Scalar* yBase, const typename V::Scalar* pBase, typename V::Scalar* hBase, size_t stride,
+		int lane0, int lane1, typename V::Scalar duration, typename V::Scalar minStep, typename V::Scalar tolerance, OdeSpanStats* stats)
+	{
+		typedef typename V::Scalar S;
+		typedef typename V::Mask Mask;
+		typedef DormandPrince<S> T;
+		const int K = M::kVars;
+		const V end = V(duration), hMin = V(minStep), tol = V(tolerance);
+		const V zero = V(S(0)), one = V(S(1));
+
+		for (int lane = lane0; lane < lane1; lane += V::kWidth)
+		{
+			V y[kOdeMaxVars], p[kOdeParams];
+			for (int v = 0; v < K; ++v) y[v] = V::Load(yBase + (size_t)v * stride + lane);
+			for (int i = 0; i < kOdeParams; ++i) p[i] = V::Load(pBase + (size_t)i * stride + lane);
+			V h = V::Load(hBase + lane);
+			V t = zero;
+
+			V k1[kOdeMaxVars], k2[kOdeMaxVars], k3[kOdeMaxVars], k4[kOdeMaxVars], k5[kOdeMaxVars], k6[kOdeMaxVars], k7[kOdeMaxVars];
+			V s[kOdeMaxVars], y5[kOdeMaxVars];
+			M::Eval(y, p, k1);
+
+			Mask active = t < end;
+			for (int iter = 0; iter < kOdeMaxIterations && Any(active); ++iter)
+			{
+				const V left = end - t;
+				const Mask clipped = left < h;
+				const V hs = Min(h, left);
+
+				for (int v = 0; v < K; ++v) s[v] = y[v] + hs * (V(T::a21) * k1[v]);
+				M::Eval(s, p, k2);
+				for (int v = 0; v < K; ++v) s[v] = y[v] + hs * (V(T::a31) * k1[v] + V(T::a32) * k2[v]);
+				M::Eval(s, p, k3);
+				for (int v = 0; v < K; ++v) s[v] = y[v] + hs * ((V(T::a41) * k1[v] + V(T::a42) * k2[v]) + V(T::a43) * k3[v]);
+				M::Eval(s, p, k4);
+				for (int v = 0; v < K; ++v)
+					s[v] = y[v] + hs * (((V(T::a51) * k1[v] + V(T::a52) * k2[v]) + V(T::a53) * k3[v]) + V(T::a54) * k4[v]);
+				M::Eval(s, p, k5);
+				for (int v = 0; v < K; ++v)
+					s[v] = y[v] + hs * ((((V(T::a61) * k1[v] + V(T::a62) * k2[v]) + V(T::a63) * k3[v]) + V(T::a64) * k4[v]) + V(T::a65) * k5[v]);
+				M::Eval(s, p, k6);
+				for (int v = 0; v < K; ++v)
+					y5[v] = y[v] + hs * ((((V(T::b1) * k1[v] + V(T::b3) * k3[v]) + V(T::b4) * k4[v]) + V(T::b5) * k5[v]) + V(T::b6) * k6[v]);
+				M::Eval(y5, p, k7);
+
+				// Error normalizado: max sobre las variables de |err| / (tol + tol * max(|y|, |y5|)).
+				V err = zero;
+				for (int v = 0; v < K; ++v)
+				{
+					const V e = hs * (((((V(T::e1) * k1[v] + V(T::e3) * k3[v]) + V(T::e4) * k4[v]) + V(T::e5) * k5[v]) + V(T::e6) * k6[v]) + V(T::e7) * k7[v]);
+					const V scale = tol + tol * Max(Abs(y[v]), Abs(y5[v]));
+					err = Max(err, Abs(e) / scale);
+				}
+
+				const Mask ok = (err <= one) & active;
+				stats->accepted += (uint64_t)Count(ok);
+				stats->rejected += (uint64_t)(Count(active) - Count(ok));
+
+				for (int v = 0; v < K; ++v)
+				{
+					y[v] = Select(ok, y5[v], y[v]);
+					k1[v] = Select(ok, k7[v], k1[v]);
+				}
+				t = Select(ok, Select(clipped, end, t + hs), t);
+
+				// Control de paso clasico (exponente 1/5, factor en [0.2, 5]). Un paso aceptado que se
+				// recorto para caer justo en el final no achica h: el proximo Advance sigue con el de antes.
+				const V factor = Min(Max(V(S(0.9)) * Exp(V(S(-0.2)) * Log(Max(err, V(S(1e-10))))), V(S(0.2))), V(S(5)));
+				const V next = Max(hs * factor, hMin);
+				h = Select(ok & clipped, h, Select(active, next, h));
+				active = t < end;
+			}
+
+			for (int v = 0; v < K; ++v) y[v].Store(yBase + (size_t)v * stride + lane);
+			h.Store(hBase + lane);
+		}
+	}
+
+	// ---- Dispatch por modelo y metodo (una vez por bloque de lanes) ----
+
+	template <typename M, typename V>
+	static void AdvanceModel(const OdeSpan& span, int lane0, int lane1, OdeSpanStats* stats)
+	{
+		if (span.method == (int)OdeMethod::RK45)
+			AdvanceRK45<M, V>(span.y, span.p, span.h, span.stride, lane0, lane1, span.duration, span.minStep, span.tolerance, stats);
+		else
+			AdvanceRK4<M, V>(span.y, span.p, span.stride, lane0, lane1, span.rk4Steps, span.rk4Step);
+	}
+
+	template <typename V>
+	static void AdvanceSpan(const OdeSpan& span, int lane0, int lane1, OdeSpanStats* stats)
+	{
+		switch ((OdeModel)span.model)
+		{
+		case OdeModel::LotkaVolterra: AdvanceModel<LotkaVolterra, V>(span, lane0, lane1, stats); break;
+		case OdeModel::SIR:           AdvanceModel<SIR, V>(span, lane0, lane1, stats); break;
+		case OdeModel::HodgkinHuxley: AdvanceModel<HodgkinHuxley, V>(span, lane0, lane1, stats); break;
+		}
+	}
+}
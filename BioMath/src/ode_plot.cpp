@@ -0,0 +1,346 @@
+#include "ode_plot.h"
+#include "frame_stats.h"
+#include "gl_state.h"
+#include "parallel.h"
+#include "platform.h"
+#include "profiler.h"
+#include "shader_program.h"
+#include "stream_buffer.h"
+#include "triple_buffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Las dos variables del grafico de un tick, una detras de la otra (X de todos, despues Y de todos):
+// el mismo layout que el vertex buffer. Los slots se reservan al iniciar: publicar no aloca.
+struct OdeFrame
+{
+	double time = 0.0;
+	std::vector<float> xy;
+};
+
+struct OdePlot
+{
+	OdeOptions options;
+	bool active = false;
+	bool prepared = false;    // OdePlotPrepare corrio y su resultado espera a OdePlotInit
+	bool ready = false;       // el ensamble esta reservado y su estado inicial publicado
+	OdeEnsemble ensemble;
+	TripleBuffer<OdeFrame> frames;
+	size_t bytes = 0;
+
+	// Lo toca solo quien corre los ticks; se lee despues de SimShutdown.
+	uint64_t ticks = 0;
+	uint64_t restarts = 0;
+	uint64_t published = 0;
+	double tickSeconds = 0.0;
+	std::vector<double> tickMs;
+	size_t tickCount = 0;
+
+	// Render
+	GLuint program = 0;
+	GLint uPlotScale = -1;
+	GLint uPlotOffset = -1;
+	GLint uSweep = -1;
+	GLuint vaos[kStreamSegments] = {};   // uno por segmento del stream: los offsets son fijos
+	StreamBuffer stream;
+	uint64_t uploaded = 0;
+	uint64_t mapFailures = 0;
+	std::vector<double> uploadMs;
+	size_t uploadCount = 0;
+};
+
+static OdePlot g_ode;
+
+// Margen alrededor del grafico, en coordenadas de clip.
+static const float kOdePlotExtent = 0.9f;
+
+bool ParseOdeOptions(int argc, char** argv, OdeOptions* opts)
+{
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--ode") == 0)
+		{
+			opts->enabled = true;
+			if (!OdeModelFind(argv[++i], &opts->model))
+			{
+				PlatformAttachConsole();
+				fprintf(stderr, "unknown ODE model '%s'; available:", argv[i]);
+				for (const OdeModelInfo& m : kOdeModels) fprintf(stderr, " %s", m.name);
+				fprintf(stderr, "\n");
+				return false;
+			}
+		}
+		else if (strcmp(argv[i], "--ode-method") == 0)
+		{
+			if (!OdeMethodFind(argv[++i], &opts->method))
+			{
+				PlatformAttachConsole();
+				fprintf(stderr, "unknown ODE method '%s'; available: rk4 rk45\n", argv[i]);
+				return false;
+			}
+		}
+		else if (strcmp(argv[i], "--ode-systems") == 0)
+			opts->systems = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--ode-tol") == 0)
+			opts->tolerance = (float)atof(argv[++i]);
+	}
+
+	if (opts->systems < 1) opts->systems = 1;
+	if (opts->systems > 4000000) opts->systems = 4000000;
+	if (!(opts->tolerance >= 1e-7f)) opts->tolerance = 1e-7f;
+	if (opts->tolerance > 1e-1f) opts->tolerance = 1e-1f;
+	return true;
+}
+
+static double MsSince(uint64_t startTicks)
+{
+	return (double)(PlatformTicks() - startTicks) * 1000.0 / (double)PlatformTickFrequency();
+}
+
+static void PublishPlot()
+{
+	const OdeModelInfo& info = OdeModelGetInfo(g_ode.ensemble.model);
+	const size_t count = (size_t)g_ode.ensemble.count;
+	const size_t stride = (size_t)g_ode.ensemble.stride;
+
+	OdeFrame& frame = g_ode.frames.Write();
+	memcpy(frame.xy.data(), g_ode.ensemble.y.data() + (size_t)info.plotX * stride, count * sizeof(float));
+	memcpy(frame.xy.data() + count, g_ode.ensemble.y.data() + (size_t)info.plotY * stride, count * sizeof(float));
+	frame.time = g_ode.ensemble.time;
+	g_ode.frames.Publish();
+	++g_ode.published;
+}
+
+// Tambien despues de un hot reload (ShaderWatch).
+static void LocateUniforms(GLuint program)
+{
+	g_ode.uPlotScale = glGetUniformLocation_ptr(program, "uPlotScale");
+	g_ode.uPlotOffset = glGetUniformLocation_ptr(program, "uPlotOffset");
+	g_ode.uSweep = glGetUniformLocation_ptr(program, "uSweep");
+}
+
+static bool CreateGLObjects()
+{
+	ShaderFile file;
+	std::string error;
+	if (!ShaderFileLoad("ode_plot.glsl", &file, &error))
+	{
+		fprintf(stderr, "ode: %s\n", error.c_str());
+		return false;
+	}
+	g_ode.program = ShaderBuildProgram(file, nullptr, &error);
+	if (!g_ode.program)
+	{
+		fprintf(stderr, "ode: plot shader failed:\n%s\n", error.c_str());
+		return false;
+	}
+	LocateUniforms(g_ode.program);
+	ShaderWatch("ode_plot.glsl", file, nullptr, &g_ode.program, LocateUniforms);
+
+	// X en location 0 e Y en location 1, del mismo segmento: [X de todos | Y de todos].
+	if (!StreamBufferInit(&g_ode.stream, GL_ARRAY_BUFFER, g_ode.bytes))
+		return false;
+	for (int s = 0; s < g_ode.stream.segments; ++s)
+	{
+		const size_t base = StreamBufferSegmentOffset(g_ode.stream, s);
+		glGenVertexArrays_ptr(1, &g_ode.vaos[s]);
+		GLStateBindVertexArray(g_ode.vaos[s]);
+		GLStateBindBuffer(GL_ARRAY_BUFFER, g_ode.stream.buffer);
+		glEnableVertexAttribArray_ptr(0);
+		glVertexAttribPointer_ptr(0, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)base);
+		glEnableVertexAttribArray_ptr(1);
+		glVertexAttribPointer_ptr(1, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(base + g_ode.bytes / 2));
+	}
+	GLStateBindVertexArray(0);
+	GLStateBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	const GLenum glError = glGetError();
+	if (glError != GL_NO_ERROR)
+	{
+		fprintf(stderr, "ode: vertex buffer setup failed (0x%04X)\n", glError);
+		return false;
+	}
+	return true;
+}
+
+static void DeleteGLObjects()
+{
+	StreamBufferShutdown(&g_ode.stream);
+	for (GLuint& vao : g_ode.vaos)
+	{
+		GLStateDeleteVertexArray(vao);
+		vao = 0;
+	}
+	ShaderUnwatch(&g_ode.program);
+	GLStateDeleteProgram(g_ode.program);
+	g_ode.program = 0;
+}
+
+void OdePlotPrepare(const OdeOptions& opts)
+{
+	g_ode.options = opts;
+	g_ode.prepared = true;
+	g_ode.ready = false;
+	if (!opts.enabled) return;
+	PROFILE_ZONE("OdePlotPrepare");
+
+	if (!OdeEnsembleInit(&g_ode.ensemble, opts.model, opts.method, opts.systems, opts.tolerance))
+		return;
+
+	const size_t floats = (size_t)opts.systems * 2;
+	g_ode.bytes = floats * sizeof(float);
+	for (auto& slot : g_ode.frames.slots)
+		slot.value.xy.assign(floats, 0.0f);
+	g_ode.tickMs.assign(kOdeTimingSamples, 0.0);
+	g_ode.uploadMs.assign(kOdeTimingSamples, 0.0);
+
+	// El estado inicial se publica ya: el primer frame tiene algo que dibujar.
+	PublishPlot();
+	g_ode.ready = true;
+}
+
+bool OdePlotInit(const OdeOptions& opts)
+{
+	if (!g_ode.prepared) OdePlotPrepare(opts);
+	g_ode.prepared = false;
+	g_ode.active = false;
+	if (!opts.enabled || !g_ode.ready) return false;
+	if (!glMapBufferRange_ptr || !glUnmapBuffer_ptr)
+	{
+		fprintf(stderr, "ode: glMapBufferRange not available, plot disabled\n");
+		g_ode.ensemble = OdeEnsemble();
+		return false;
+	}
+	PROFILE_ZONE("OdePlotInit");
+
+	if (!CreateGLObjects())
+	{
+		DeleteGLObjects();
+		g_ode.ensemble = OdeEnsemble();
+		return false;
+	}
+	g_ode.active = true;
+	return true;
+}
+
+void OdePlotShutdown()
+{
+	DeleteGLObjects();
+	g_ode.active = false;
+}
+
+bool OdePlotActive()
+{
+	return g_ode.active;
+}
+
+void OdePlotTick(int timeScaleQuarters)
+{
+	if (!g_ode.active || timeScaleQuarters <= 0) return; // congelado: nada nuevo que publicar
+
+	PROFILE_ZONE("OdeTick");
+	const uint64_t t0 = PlatformTicks();
+	const OdeModelInfo& info = OdeModelGetInfo(g_ode.ensemble.model);
+
+	// SIR se apaga solo: pasado restartTime vuelve al estado inicial para que siempre haya algo.
+	if (info.restartTime > 0.0f && g_ode.ensemble.time >= (double)info.restartTime)
+	{
+		OdeEnsembleReset(&g_ode.ensemble);
+		++g_ode.restarts;
+	}
+	OdeEnsembleAdvance(&g_ode.ensemble, info.timePerTick * (float)timeScaleQuarters * 0.25f);
+	++g_ode.ticks;
+	PublishPlot();
+
+	const double ms = MsSince(t0);
+	g_ode.tickSeconds += ms * 1e-3;
+	g_ode.tickMs[g_ode.tickCount++ % kOdeTimingSamples] = ms;
+}
+
+static void Upload()
+{
+	PROFILE_ZONE("OdeUpload");
+	const uint64_t t0 = PlatformTicks();
+
+	StreamWrite w;
+	if (StreamBufferBegin(&g_ode.stream, &w))
+	{
+		memcpy(w.data, g_ode.frames.Read().xy.data(), g_ode.bytes);
+		if (StreamBufferEnd(&g_ode.stream, g_ode.bytes))
+			++g_ode.uploaded;
+		else
+			++g_ode.mapFailures; // el contenido se perdio: se dibuja lo que haya y se sube el proximo
+	}
+	else
+	{
+		++g_ode.mapFailures;
+	}
+
+	g_ode.uploadMs[g_ode.uploadCount++ % kOdeTimingSamples] = MsSince(t0);
+}
+
+void OdePlotDraw(int outputWidth, int outputHeight)
+{
+	if (!g_ode.active) return;
+	if (g_ode.frames.Acquire()) Upload();
+
+	PROFILE_GPU_ZONE("OdePlot");
+	const OdeModelInfo& info = OdeModelGetInfo(g_ode.ensemble.model);
+
+	// [plotMin, plotMax] -> [-kOdePlotExtent, kOdePlotExtent] en cada eje.
+	float scale[2], offset[2];
+	for (int a = 0; a < 2; ++a)
+	{
+		scale[a] = 2.0f * kOdePlotExtent / (info.plotMax[a] - info.plotMin[a]);
+		offset[a] = -kOdePlotExtent - info.plotMin[a] * scale[a];
+	}
+
+	GLStateViewport(0, 0, outputWidth > 0 ? outputWidth : 1, outputHeight > 0 ? outputHeight : 1);
+	GLStateUseProgram(g_ode.program);
+	GLStateUniform2f(g_ode.uPlotScale, scale[0], scale[1]);
+	GLStateUniform2f(g_ode.uPlotOffset, offset[0], offset[1]);
+	GLStateUniform2f(g_ode.uSweep, (float)g_ode.ensemble.sweepColumns, (float)g_ode.ensemble.sweepRows);
+	GLStateBindVertexArray(g_ode.vaos[g_ode.stream.segment]);
+
+	// El blending solo lo usa este draw: se prende y se apaga aca (gl_state.h no lo sigue).
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE);
+	glPointSize(2.0f);
+	GLStateDrawArrays(GL_POINTS, 0, g_ode.ensemble.count);
+	glDisable(GL_BLEND);
+	StreamBufferFence(&g_ode.stream);
+}
+
+void WriteOdeJson(FILE* f)
+{
+	if (!g_ode.active)
+	{
+		fprintf(f, "\"ode\": { \"enabled\": false }");
+		return;
+	}
+
+	const OdeEnsemble& ens = g_ode.ensemble;
+	const double systemTicksPerSecond = g_ode.tickSeconds > 0.0 ? (double)g_ode.ticks * (double)ens.count / g_ode.tickSeconds : 0.0;
+	fprintf(f, "\"ode\": { \"enabled\": true, \"model\": \"%s\", \"method\": \"%s\", \"systems\": %d",
+		OdeModelGetInfo(ens.model).name, OdeMethodName(ens.method), ens.count);
+	if (ens.method == OdeMethod::RK45) fprintf(f, ", \"tolerance\": %g", (double)ens.tolerance);
+	fprintf(f, ", \"path\": \"%s\", \"threads\": %d, \"ticks\": %llu, \"model_time\": %.3f, \"restarts\": %llu",
+		CpuShadePathName(CpuResolveShadePath(CpuShadePath::Auto)), ParallelThreadCount(), (unsigned long long)g_ode.ticks,
+		ens.time, (unsigned long long)g_ode.restarts);
+	fprintf(f, ", \"steps_accepted\": %llu, \"steps_rejected\": %llu, \"msystem_ticks_per_s\": %.2f",
+		(unsigned long long)ens.accepted, (unsigned long long)ens.rejected, systemTicksPerSecond * 1e-6);
+	fprintf(f, ", \"published\": %llu, \"uploaded\": %llu, \"dropped\": %llu, \"map_failures\": %llu, ",
+		(unsigned long long)g_ode.published, (unsigned long long)g_ode.uploaded,
+		(unsigned long long)(g_ode.published - g_ode.uploaded - g_ode.mapFailures), (unsigned long long)g_ode.mapFailures);
+	const size_t ticks = g_ode.tickCount < kOdeTimingSamples ? g_ode.tickCount : kOdeTimingSamples;
+	const size_t uploads = g_ode.uploadCount < kOdeTimingSamples ? g_ode.uploadCount : kOdeTimingSamples;
+	WriteTimingSummaryJson(f, "tick_ms", SummarizeTimings(g_ode.tickMs.data(), ticks));
+	fprintf(f, ", ");
+	WriteTimingSummaryJson(f, "upload_ms", SummarizeTimings(g_ode.uploadMs.data(), uploads));
+	fprintf(f, ", ");
+	WriteStreamBufferJson(f, g_ode.stream);
+	fprintf(f, " }");
+}
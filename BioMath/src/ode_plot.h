@@ -0,0 +1,63 @@
+#pragma once
+
+#include "gl_api.h"
+#include "ode_ensemble.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+// ---------------------------
+// Grafico del ensamble de EDOs
+// ---------------------------
+
+// Con --ode el frame lleva encima un diagrama de fase: un punto por sistema del ensamble
+// (ode_ensemble.h), en las dos variables plotX/plotY del modelo, coloreado por su posicion en el
+// barrido de parametros. Con 100k sistemas la nube muestra de un vistazo como cambia la dinamica
+// con los parametros (ciclos de LV, picos de SIR, spikes de HH).
+//
+// El ensamble avanza en el thread de simulacion (simulation.h): cada tick integra timePerTick del
+// modelo escalado por la velocidad (Up/Down, en cuartos; a 0 se congela) y publica las dos
+// variables del grafico (ya son SoA: dos memcpy) por un triple buffer. El render toma la ultima
+// publicacion y la copia al segmento siguiente de un StreamBuffer (stream_buffer.h: anillo
+// persistente con fences, u orphaning si el contexto no tiene buffer storage); el shader
+// (shaders/ode_plot.glsl) lee X e Y como dos atributos del mismo segmento y saca el color del
+// barrido de gl_VertexID. Un solo draw de GL_POINTS
+// con blending aditivo, a la resolucion de salida, despues del upsample de la escena.
+//
+// En headless no hay thread de simulacion: el loop de headless.cpp llama a OdePlotTick antes de
+// cada frame (un tick por frame, velocidad 1x).
+
+struct OdeOptions
+{
+	bool enabled = false;
+	OdeModel model = OdeModel::HodgkinHuxley;
+	OdeMethod method = OdeMethod::RK4;
+	int systems = 100000;
+	float tolerance = kOdeDefaultTolerance;
+};
+
+static const size_t kOdeTimingSamples = 1 << 16;
+
+// --ode lv|sir|hh (lo prende), --ode-systems N, --ode-method rk4|rk45, --ode-tol x.
+// false si el modelo o el metodo no existen.
+bool ParseOdeOptions(int argc, char** argv, OdeOptions* opts);
+
+// La parte de CPU de OdePlotInit, sin GL: reserva el ensamble y publica su estado inicial. Puede
+// correr en otro thread mientras se crea el contexto (startup.h).
+void OdePlotPrepare(const OdeOptions& opts);
+
+// Requiere contexto GL: reserva el ensamble (si no se llamo a OdePlotPrepare) y crea el programa y
+// los buffers. Si falta algo queda apagado y el motivo va a stderr.
+bool OdePlotInit(const OdeOptions& opts);
+void OdePlotShutdown();   // despues de SimShutdown
+bool OdePlotActive();
+
+// Thread de simulacion (o el loop en headless): un tick. 'timeScaleQuarters' = velocidad en cuartos.
+void OdePlotTick(int timeScaleQuarters);
+
+// Render: sube la ultima publicacion (si hay una nueva) y dibuja los puntos sobre lo que haya en
+// el framebuffer bindeado. Una vez por frame, despues de la escena.
+void OdePlotDraw(int outputWidth, int outputHeight);
+
+// "ode": { ... } para los reportes JSON. Despues de SimShutdown.
+void WriteOdeJson(FILE* f);
@@ -0,0 +1,79 @@
+#include "parallel.h"
+#include "jobs.h"
+
+// ParallelFor sobre el scheduler de jobs (jobs.h), con particion binaria perezosa: el thread que
+// tiene un rango manda la mitad derecha como job (la puede robar otro) y sigue partiendo la
+// izquierda hasta quedarse con un bloque de 'grain', que corre. Despues espera a sus mitades
+// ayudando. Un rango robado se vuelve a partir en el thread que lo robo, asi que el trabajo se
+// reparte en log2(bloques) pasos sin que nadie tenga que conocer a los demas. Los bordes caen
+// siempre en multiplos de 'grain', igual que con el pool de antes.
+
+struct ParallelRange
+{
+	ParallelRangeFn fn;
+	void* ctx;
+	int grain;
+};
+
+struct ParallelPart
+{
+	const ParallelRange* range;
+	int begin;
+	int end;
+};
+
+static void RunRange(const ParallelRange& range, int begin, int end);
+
+static void RunPart(void* ctx)
+{
+	const ParallelPart* part = static_cast<const ParallelPart*>(ctx);
+	RunRange(*part->range, part->begin, part->end);
+}
+
+static void RunRange(const ParallelRange& range, int begin, int end)
+{
+	// Como mucho 31 mitades: cada una es la mitad de lo que quedaba.
+	ParallelPart parts[32];
+	Job jobs[32];
+	JobCounter halves;
+	int split = 0;
+	while (end - begin > range.grain && split < 32)
+	{
+		const int chunks = (end - begin + range.grain - 1) / range.grain;
+		const int mid = begin + chunks / 2 * range.grain;
+		parts[split] = { &range, mid, end };
+		jobs[split].fn = RunPart;
+		jobs[split].ctx = &parts[split];
+		JobSubmit(&jobs[split], &halves);
+		++split;
+		end = mid;
+	}
+	range.fn(range.ctx, begin, end);
+	JobWait(&halves);
+}
+
+int ParallelThreadCount()
+{
+	return JobThreadCount();
+}
+
+void ParallelSetThreadLimit(int maxThreads)
+{
+	JobSetThreadLimit(maxThreads);
+}
+
+void ParallelFor(int count, int grain, ParallelRangeFn fn, void* ctx)
+{
+	if (count <= 0) return;
+	if (grain < 1) grain = 1;
+
+	// Un solo bloque o un solo thread: todo el rango de una vez, sin jobs.
+	if (count <= grain || JobThreadCount() <= 1)
+	{
+		fn(ctx, 0, count);
+		return;
+	}
+
+	const ParallelRange range = { fn, ctx, grain };
+	RunRange(range, 0, count);
+}
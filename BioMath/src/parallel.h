@@ -0,0 +1,31 @@
+#pragma once
+
+#include <type_traits>
+
+// ---------------------------
+// ParallelFor
+// ---------------------------
+
+// Reparte el rango [0, count) en bloques de 'grain' elementos entre los threads del scheduler de
+// jobs (jobs.h). El thread que llama tambien trabaja, y la funcion no vuelve hasta que se proceso
+// todo el rango. Llamadas simultaneas desde varios threads (el principal y el de simulacion, por
+// ejemplo) y ParallelFor anidados comparten los mismos workers.
+
+typedef void (*ParallelRangeFn)(void* ctx, int begin, int end);
+
+void ParallelFor(int count, int grain, ParallelRangeFn fn, void* ctx);
+
+// Cantidad de threads que participan en un ParallelFor (workers + el thread que llama).
+int ParallelThreadCount();
+
+// Limita los threads usados (0 = todos). Pensado para benchmarks de escalado por cantidad de cores.
+void ParallelSetThreadLimit(int maxThreads);
+
+// Version con lambda: ParallelFor(n, 16, [&](int begin, int end) { ... });
+template <typename F>
+void ParallelFor(int count, int grain, F&& fn)
+{
+	ParallelFor(count, grain,
+		[](void* ctx, int begin, int end) { (*static_cast<std::remove_reference_t<F>*>(ctx))(begin, end); },
+		(void*)&fn);
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ---------------------------
+// Capa de plataforma
+// ---------------------------
+
+// Todo lo que depende del sistema operativo: ventana/superficie, contexto GL, cargador de
+// funciones GL, reloj y bomba de eventos. Hay una implementacion por sistema:
+//
+//   platform_win32.cpp  Win32 + WGL (+ GDI para el fallback de CPU)
+//   platform_linux.cpp  X11 + GLX para ventana, EGL surfaceless para offscreen (headless)
+//
+// Hay una sola ventana y un solo contexto por proceso, asi que el estado vive dentro de
+// cada implementacion y la interfaz son funciones libres.
+
+enum class PlatformSurface
+{
+	Window,     // Ventana visible con double buffering
+	Offscreen,  // Sin ventana visible: se dibuja en un FBO (modo headless)
+};
+
+struct PlatformDesc
+{
+	const char* title = "WIP BioMath";
+	int width = 1280;
+	int height = 720;
+	PlatformSurface surface = PlatformSurface::Window;
+};
+
+// Crea la ventana (o lo que el backend necesite para tener un contexto offscreen).
+bool PlatformCreateWindow(const PlatformDesc& desc);
+void PlatformDestroyWindow();
+
+// Crea un contexto OpenGL 3.3 core (o el mejor disponible), lo deja actual en este thread y
+// carga los punteros de gl_api.h. Devuelve false si no hay un contexto usable.
+bool PlatformCreateGLContext();
+void PlatformDestroyGLContext();
+
+// Contexto GL que comparte objetos (programas, buffers, texturas) con el principal, para un thread
+// de trabajo. Se crea y se destruye desde el thread del contexto principal; el worker lo activa
+// con PlatformMakeSharedGLContextCurrent y lo suelta (nullptr) antes de terminar. nullptr si el
+// backend no puede.
+struct PlatformSharedContext;
+PlatformSharedContext* PlatformCreateSharedGLContext();
+bool PlatformMakeSharedGLContextCurrent(PlatformSharedContext* shared);
+void PlatformDestroySharedGLContext(PlatformSharedContext* shared);
+
+// Nombre del backend activo ("win32-wgl", "x11-glx", "egl-surfaceless"), para logs y reportes.
+const char* PlatformBackendName();
+
+// Puntero a una funcion GL del contexto actual (nullptr si no existe).
+void* PlatformGetGLProc(const char* name);
+
+// Procesa los eventos pendientes sin bloquear. Devuelve false cuando se pidio cerrar la app.
+bool PlatformPumpEvents();
+
+// Tamanio actual del area cliente de la ventana (o el pedido, en offscreen).
+void PlatformGetWindowSize(int* width, int* height);
+
+void PlatformSwapBuffers();
+
+// Swap interval (vsync): 0 = sin sync, 1 = cada vblank, -1 = adaptive. Devuelve false si el
+// backend no lo soporta (el valor queda el que tenga el driver).
+bool PlatformSetSwapInterval(int interval);
+
+// Presenta una imagen de CPU en la ventana, sin GL (fallback de cpu_renderer.h).
+// Pixeles BGRA8 con filas de abajo hacia arriba, igual que CpuPixelFormat::BGRA8.
+bool PlatformPresentPixels(const uint8_t* pixels, int width, int height);
+
+// Reloj monotono de alta resolucion, en ticks. Para pasar a segundos: ticks / frecuencia.
+uint64_t PlatformTicks();
+uint64_t PlatformTickFrequency();
+
+// Duerme hasta el tick absoluto indicado con la mejor resolucion que de el sistema (waitable timer
+// de alta resolucion en Windows, clock_nanosleep en Linux). Puede despertar un poco tarde, nunca antes.
+void PlatformSleepUntil(uint64_t deadlineTicks);
+
+// Fecha de ultima modificacion de un archivo, en una unidad propia de cada sistema (solo sirve
+// para comparar). 0 si el archivo no existe.
+uint64_t PlatformFileModifiedTime(const char* path);
+
+// Carpeta de cache por usuario para la app (%LOCALAPPDATA%\BioMath, $XDG_CACHE_HOME/biomath o
+// ~/.cache/biomath). La crea si no existe. Devuelve false si no hay donde escribir.
+bool PlatformCacheDirectory(char* out, size_t size);
+
+// Archivo mapeado en memoria, solo lectura. Las paginas las trae el sistema a medida que se leen,
+// asi que abrir un archivo grande es casi gratis. 'handle' es del sistema (mapping en Windows).
+// Implementado en platform_file.cpp (sin GL, parte de biomath_core).
+struct PlatformFileMapping
+{
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	void* handle = nullptr;
+};
+
+bool PlatformMapFile(const char* path, PlatformFileMapping* mapping);
+void PlatformUnmapFile(PlatformFileMapping* mapping);
+
+// Salida de audio estereo, bloqueante: el thread de audio escribe un bloque y PlatformAudioWrite
+// espera hasta que el dispositivo tenga lugar, asi que es lo que marca el ritmo del thread. Con
+// 'bufferBlocks' bloques en cola la latencia es ~bufferBlocks * blockFrames / sampleRate.
+// waveOut en Windows; ALSA en Linux (cargada con dlopen: si no esta, no hay dispositivo).
+struct PlatformAudioDesc
+{
+	int sampleRate = 48000;
+	int blockFrames = 128;
+	int bufferBlocks = 3;
+};
+
+enum class PlatformAudioResult
+{
+	Ok,
+	Underrun,  // el dispositivo se quedo sin datos antes de este bloque (se escucho un corte)
+	Error,
+};
+
+struct PlatformAudioDevice;
+PlatformAudioDevice* PlatformAudioOpen(const PlatformAudioDesc& desc); // nullptr si no hay salida
+PlatformAudioResult PlatformAudioWrite(PlatformAudioDevice* device, const float* left, const float* right, int frames);
+void PlatformAudioClose(PlatformAudioDevice* device);
+const char* PlatformAudioBackendName();
+
+// Prioridad de tiempo real para el thread actual (audio). Puede fallar sin permisos: es un pedido.
+bool PlatformSetAudioThreadPriority();
+
+// Entrada cruda (teclado, mouse, gamepad). El backend la lee en su propio thread, sin pasar por
+// la cola de mensajes de la ventana, y llama a 'callback' por cada evento con el tick (PlatformTicks)
+// en que lo recibio; siempre desde un mismo thread, asi que el callback puede ser el productor de
+// una cola SPSC (input.h). Solo entrega eventos mientras la ventana tiene el foco.
+//
+//   Windows: Raw Input (WM_INPUT) en una ventana message-only + XInput (hasta 4 gamepads, polling)
+//   Linux:   evdev (/dev/input/event*, timestamps del kernel en CLOCK_MONOTONIC) con gamepads; si no
+//            hay permisos para leer teclado/mouse, eventos de X11 desde PlatformPumpEvents (sin gamepad)
+enum class PlatformInputType : uint8_t
+{
+	KeyDown,             // code = PlatformKey (sin autorepeat)
+	KeyUp,
+	MouseMove,           // x, y = desplazamiento relativo (mickeys / unidades del dispositivo)
+	MouseButtonDown,     // code = 0 izquierdo, 1 derecho, 2 medio, 3-4 laterales
+	MouseButtonUp,
+	MouseWheel,          // value = muescas (+ hacia adelante)
+	GamepadButtonDown,   // pad = indice, code = PlatformGamepadButton
+	GamepadButtonUp,
+	GamepadAxis,         // pad, code = 0 LX, 1 LY, 2 RX, 3 RY (-1..1), 4 LT, 5 RT (0..1); value
+	GamepadConnected,
+	GamepadDisconnected,
+};
+
+// Teclas: mismos valores que los virtual-key de Windows. Letras y digitos son su ASCII ('A', '0').
+enum class PlatformKey : uint16_t
+{
+	Backspace = 0x08, Tab = 0x09, Enter = 0x0D, Shift = 0x10, Control = 0x11, Alt = 0x12,
+	Escape = 0x1B, Space = 0x20, Left = 0x25, Up = 0x26, Right = 0x27, Down = 0x28,
+	F1 = 0x70, F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12,
+};
+
+// Botones de gamepad: indice del bit de XInput.
+enum class PlatformGamepadButton : uint16_t
+{
+	DPadUp = 0, DPadDown, DPadLeft, DPadRight, Start, Back, LeftThumb, RightThumb,
+	LeftShoulder, RightShoulder, A = 12, B, X, Y,
+};
+
+struct PlatformInputEvent
+{
+	uint64_t ticks = 0;  // PlatformTicks() al recibirlo (Linux/evdev: cuando lo recibio el kernel)
+	PlatformInputType type = PlatformInputType::KeyDown;
+	uint8_t pad = 0;
+	uint16_t code = 0;
+	int32_t x = 0;
+	int32_t y = 0;
+	float value = 0.0f;
+};
+
+typedef void (*PlatformInputCallback)(void* ctx, const PlatformInputEvent& ev);
+
+// Requiere la ventana creada. false si el backend no pudo arrancar (sin ventana, sin dispositivos).
+bool PlatformInputStart(PlatformInputCallback callback, void* ctx);
+void PlatformInputStop();
+const char* PlatformInputBackendName(); // "rawinput+xinput", "evdev", "x11", "none"
+
+// Error fatal visible para el usuario (cuadro de mensaje en Windows, stderr en Linux).
+void PlatformShowError(const char* title, const char* text);
+
+// En Windows la app es de subsistema GUI: si la lanzaron desde una consola, stdout/stderr van ahi.
+void PlatformAttachConsole();
@@ -0,0 +1,78 @@
+#include "platform.h"
+
+// Archivos mapeados en memoria. No dependen de la ventana ni de GL, asi que viven aparte de
+// platform_*.cpp y entran en biomath_core: los usan el paquete de assets (asset_pack.h), el cache
+// del ruido horneado y los benchmarks.
+
+#ifdef _WIN32
+
+#ifndef WIN32_LEAN_AND_MEAN
+	#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+bool PlatformMapFile(const char* path, PlatformFileMapping* mapping)
+{
+	*mapping = PlatformFileMapping();
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	HANDLE map = nullptr;
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+		map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file); // el mapping mantiene el archivo abierto
+	if (!map) return false;
+
+	const void* data = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle(map);
+		return false;
+	}
+
+	mapping->data = (const uint8_t*)data;
+	mapping->size = (size_t)size.QuadPart;
+	mapping->handle = map;
+	return true;
+}
+
+void PlatformUnmapFile(PlatformFileMapping* mapping)
+{
+	if (mapping->data) UnmapViewOfFile(mapping->data);
+	if (mapping->handle) CloseHandle((HANDLE)mapping->handle);
+	*mapping = PlatformFileMapping();
+}
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool PlatformMapFile(const char* path, PlatformFileMapping* mapping)
+{
+	*mapping = PlatformFileMapping();
+	const int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) return false;
+
+	struct stat st;
+	void* data = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && st.st_size > 0)
+		data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // el mapping se queda con su propia referencia al archivo
+	if (data == MAP_FAILED) return false;
+
+	mapping->data = (const uint8_t*)data;
+	mapping->size = (size_t)st.st_size;
+	return true;
+}
+
+void PlatformUnmapFile(PlatformFileMapping* mapping)
+{
+	if (mapping->data) munmap((void*)mapping->data, mapping->size);
+	*mapping = PlatformFileMapping();
+}
+
+#endif
@@ -0,0 +1,1497 @@
+#include "platform.h"
+#include "gl_api.h"
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <time.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// BIOMATH_HAS_X11 lo define CMake si encontro Xlib. Sin X11 solo queda el backend offscreen
+// (EGL surfaceless), que es lo que usan las maquinas de CI y de perf.
+#ifndef BIOMATH_HAS_X11
+	#define BIOMATH_HAS_X11 0
+#endif
+
+#if !BIOMATH_HAS_X11
+	#define EGL_NO_X11 // que eglplatform.h no incluya Xlib.h
+#endif
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#if BIOMATH_HAS_X11
+	#include <X11/Xlib.h>
+	#include <X11/Xutil.h>
+	#include <X11/XKBlib.h>
+	#include <X11/keysym.h>
+	#define GLX_GLXEXT_LEGACY // las extensiones GLX que usamos se declaran abajo
+	#include <GL/glx.h>
+#endif
+
+// ----------------------------
+// Declaraciones GLX/EGL minimas
+// ----------------------------
+
+// Mismo esquema que WGL en Windows: contexto 3.3 core via la extension *_create_context.
+
+#if BIOMATH_HAS_X11
+#define GLX_CONTEXT_MAJOR_VERSION_ARB 0x2091
+#define GLX_CONTEXT_MINOR_VERSION_ARB 0x2092
+#define GLX_CONTEXT_PROFILE_MASK_ARB  0x9126
+#define GLX_CONTEXT_CORE_PROFILE_BIT_ARB 0x00000001
+
+typedef GLXContext(*PFNGLXCREATECONTEXTATTRIBSARBPROC)(Display*, GLXFBConfig, GLXContext, Bool, const int*);
+typedef void (*PFNGLXSWAPINTERVALEXTPROC)(Display*, GLXDrawable, int);   // GLX_EXT_swap_control
+typedef int  (*PFNGLXSWAPINTERVALMESAPROC)(unsigned int);                  // GLX_MESA_swap_control
+#endif
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+	#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+typedef EGLDisplay(*PFNEGLGETPLATFORMDISPLAYEXTPROC_)(EGLenum, void*, const EGLint*);
+
+
+// ---------------------------
+// Estado
+// ---------------------------
+
+enum class GLBackend
+{
+	NoContext,
+	Glx,  // ventana X11
+	Egl,  // offscreen, sin servidor grafico
+};
+
+static GLBackend g_backend = GLBackend::NoContext;
+static PlatformSurface g_surface = PlatformSurface::Window;
+static bool g_running = true;
+
+static int g_width = 1280;
+static int g_height = 720;
+
+#if BIOMATH_HAS_X11
+static Display*    g_display = nullptr;
+static Window      g_window = 0;
+static Colormap    g_colormap = 0;
+static Visual*     g_visual = nullptr;
+static int         g_depth = 0;
+static GC          g_gc = nullptr;
+static Atom        g_wmDelete = 0;
+static GLXFBConfig g_fbConfig = nullptr;
+static GLXContext  g_glxContext = nullptr;
+static bool        g_glxCore = false; // creado con glXCreateContextAttribsARB (los compartidos igual)
+
+static std::vector<uint8_t> g_presentRows; // copia top-down para XPutImage
+#endif
+
+static EGLDisplay g_eglDisplay = EGL_NO_DISPLAY;
+static EGLContext g_eglContext = EGL_NO_CONTEXT;
+static EGLSurface g_eglSurface = EGL_NO_SURFACE; // pbuffer 1x1 si no hay EGL_KHR_surfaceless_context
+static EGLConfig  g_eglConfig = nullptr;
+static bool       g_eglCore = false;
+
+static bool HasExtension(const char* list, const char* name)
+{
+	if (!list) return false;
+	const size_t len = strlen(name);
+	for (const char* p = list; (p = strstr(p, name)) != nullptr; p += len)
+	{
+		const bool startOk = p == list || p[-1] == ' ';
+		const bool endOk = p[len] == ' ' || p[len] == 0;
+		if (startOk && endOk) return true;
+	}
+	return false;
+}
+
+
+// ---------------------------
+// Ventana (X11)
+// ---------------------------
+
+bool PlatformCreateWindow(const PlatformDesc& desc)
+{
+	g_surface = desc.surface;
+	g_width = desc.width;
+	g_height = desc.height;
+	g_running = true;
+
+	// Offscreen no necesita ventana ni servidor X: el contexto EGL es surfaceless.
+	if (desc.surface == PlatformSurface::Offscreen)
+		return true;
+
+#if BIOMATH_HAS_X11
+	XInitThreads(); // el thread de compilacion de shaders usa un contexto GLX compartido (PlatformCreateSharedGLContext)
+	g_display = XOpenDisplay(nullptr);
+	if (!g_display)
+	{
+		fprintf(stderr, "platform: cannot open X11 display (DISPLAY=%s)\n", getenv("DISPLAY") ? getenv("DISPLAY") : "");
+		return false;
+	}
+
+	const int screen = DefaultScreen(g_display);
+	Window root = RootWindow(g_display, screen);
+
+	// Framebuffer: RGBA8 + depth 24 + stencil 8, double buffered (igual que el pixel format de WGL).
+	const int fbAttribs[] = {
+		GLX_X_RENDERABLE, True,
+		GLX_DRAWABLE_TYPE, GLX_WINDOW_BIT,
+		GLX_RENDER_TYPE, GLX_RGBA_BIT,
+		GLX_X_VISUAL_TYPE, GLX_TRUE_COLOR,
+		GLX_RED_SIZE, 8,
+		GLX_GREEN_SIZE, 8,
+		GLX_BLUE_SIZE, 8,
+		GLX_ALPHA_SIZE, 8,
+		GLX_DEPTH_SIZE, 24,
+		GLX_STENCIL_SIZE, 8,
+		GLX_DOUBLEBUFFER, True,
+		None
+	};
+
+	// Si GLX no esta disponible la ventana se crea igual con el visual por defecto: sirve para
+	// el fallback de CPU (PlatformPresentPixels).
+	XVisualInfo* vi = nullptr;
+	int glxMajor = 0, glxMinor = 0;
+	if (glXQueryVersion(g_display, &glxMajor, &glxMinor) && (glxMajor > 1 || glxMinor >= 3))
+	{
+		int count = 0;
+		GLXFBConfig* configs = glXChooseFBConfig(g_display, screen, fbAttribs, &count);
+		if (configs && count > 0)
+		{
+			g_fbConfig = configs[0];
+			vi = glXGetVisualFromFBConfig(g_display, g_fbConfig);
+		}
+		if (configs) XFree(configs);
+	}
+
+	g_visual = vi ? vi->visual : DefaultVisual(g_display, screen);
+	g_depth = vi ? vi->depth : DefaultDepth(g_display, screen);
+	if (vi) XFree(vi);
+
+	g_colormap = XCreateColormap(g_display, root, g_visual, AllocNone);
+
+	XSetWindowAttributes swa{};
+	swa.colormap = g_colormap;
+	swa.background_pixel = 0;
+	swa.border_pixel = 0;
+	swa.event_mask = StructureNotifyMask | ExposureMask | KeyPressMask | KeyReleaseMask |
+		ButtonPressMask | ButtonReleaseMask | PointerMotionMask | FocusChangeMask;
+
+	g_window = XCreateWindow(g_display, root, 0, 0, (unsigned)g_width, (unsigned)g_height, 0,
+		g_depth, InputOutput, g_visual, CWColormap | CWBackPixel | CWBorderPixel | CWEventMask, &swa);
+	if (!g_window)
+	{
+		PlatformDestroyWindow();
+		return false;
+	}
+
+	XStoreName(g_display, g_window, desc.title ? desc.title : "");
+
+	// Que el boton de cerrar nos llegue como ClientMessage en vez de matar la conexion.
+	g_wmDelete = XInternAtom(g_display, "WM_DELETE_WINDOW", False);
+	XSetWMProtocols(g_display, g_window, &g_wmDelete, 1);
+
+	g_gc = XCreateGC(g_display, g_window, 0, nullptr);
+
+	XMapWindow(g_display, g_window);
+	XFlush(g_display);
+	return true;
+#else
+	fprintf(stderr, "platform: built without X11, only --headless is available\n");
+	return false;
+#endif
+}
+
+void PlatformDestroyWindow()
+{
+#if BIOMATH_HAS_X11
+	if (!g_display) return;
+
+	if (g_gc) XFreeGC(g_display, g_gc);
+	if (g_window) XDestroyWindow(g_display, g_window);
+	if (g_colormap) XFreeColormap(g_display, g_colormap);
+	XCloseDisplay(g_display);
+
+	g_gc = nullptr;
+	g_window = 0;
+	g_colormap = 0;
+	g_fbConfig = nullptr;
+	g_display = nullptr;
+#endif
+}
+
+
+// ---------------------------
+// GLX
+// ---------------------------
+
+#if BIOMATH_HAS_X11
+// glXCreateContextAttribsARB reporta "no soporto esta version" como error X (BadMatch), y el
+// handler por defecto de Xlib termina el proceso. Mientras probamos, lo reemplazamos por uno mudo.
+static bool g_xError = false;
+
+static int SilentXErrorHandler(Display*, XErrorEvent*)
+{
+	g_xError = true;
+	return 0;
+}
+
+static const int kGlxCoreAttribs[] = {
+	GLX_CONTEXT_MAJOR_VERSION_ARB, 3,
+	GLX_CONTEXT_MINOR_VERSION_ARB, 3,
+	GLX_CONTEXT_PROFILE_MASK_ARB,  GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
+	None
+};
+
+static PFNGLXCREATECONTEXTATTRIBSARBPROC glXCreateContextAttribsARB_ptr = nullptr;
+
+static GLXContext CreateGlxCoreContext(GLXContext share)
+{
+	g_xError = false;
+	int (*oldHandler)(Display*, XErrorEvent*) = XSetErrorHandler(SilentXErrorHandler);
+	GLXContext context = glXCreateContextAttribsARB_ptr(g_display, g_fbConfig, share, True, kGlxCoreAttribs);
+	XSync(g_display, False);
+	XSetErrorHandler(oldHandler);
+
+	if (g_xError && context)
+	{
+		glXDestroyContext(g_display, context);
+		context = nullptr;
+	}
+	return context;
+}
+
+static bool CreateGlxContext()
+{
+	if (!g_display || !g_window || !g_fbConfig) return false;
+
+	glXCreateContextAttribsARB_ptr =
+		(PFNGLXCREATECONTEXTATTRIBSARBPROC)glXGetProcAddressARB((const GLubyte*)"glXCreateContextAttribsARB");
+
+	// 1) Contexto moderno (3.3 core)
+	if (glXCreateContextAttribsARB_ptr &&
+		HasExtension(glXQueryExtensionsString(g_display, DefaultScreen(g_display)), "GLX_ARB_create_context"))
+	{
+		g_glxContext = CreateGlxCoreContext(nullptr);
+	}
+	g_glxCore = g_glxContext != nullptr;
+
+	// 2) Fallback: contexto legacy
+	if (!g_glxContext)
+		g_glxContext = glXCreateNewContext(g_display, g_fbConfig, GLX_RGBA_TYPE, nullptr, True);
+	if (!g_glxContext) return false;
+
+	if (!glXMakeCurrent(g_display, g_window, g_glxContext))
+	{
+		glXDestroyContext(g_display, g_glxContext);
+		g_glxContext = nullptr;
+		return false;
+	}
+
+	g_backend = GLBackend::Glx;
+	return true;
+}
+#endif
+
+
+// ---------------------------
+// EGL surfaceless
+// ---------------------------
+
+static const EGLint kEglCoreAttribs[] = {
+	EGL_CONTEXT_MAJOR_VERSION, 3,
+	EGL_CONTEXT_MINOR_VERSION, 3,
+	EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+	EGL_NONE
+};
+
+// Contexto GL de escritorio sin ventana ni servidor X (Mesa llvmpipe, drivers de GPU headless).
+// Se dibuja siempre en un FBO, asi que no hace falta superficie.
+static bool CreateEglContext()
+{
+	// Preferimos la plataforma surfaceless de Mesa; si no esta, el display por defecto.
+	const char* clientExts = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	PFNEGLGETPLATFORMDISPLAYEXTPROC_ getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC_)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+	if (getPlatformDisplay && HasExtension(clientExts, "EGL_MESA_platform_surfaceless"))
+		g_eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, (void*)EGL_DEFAULT_DISPLAY, nullptr);
+	if (g_eglDisplay == EGL_NO_DISPLAY)
+		g_eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	if (g_eglDisplay == EGL_NO_DISPLAY) return false;
+
+	EGLint major = 0, minor = 0;
+	if (!eglInitialize(g_eglDisplay, &major, &minor))
+	{
+		g_eglDisplay = EGL_NO_DISPLAY;
+		return false;
+	}
+
+	if (!eglBindAPI(EGL_OPENGL_API)) return false;
+
+	EGLint configAttribs[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_ALPHA_SIZE, 8,
+		EGL_NONE
+	};
+
+	EGLConfig config = nullptr;
+	EGLint count = 0;
+	if (!eglChooseConfig(g_eglDisplay, configAttribs, &config, 1, &count) || count == 0)
+	{
+		// Algunas plataformas surfaceless no exponen configs con pbuffer.
+		configAttribs[1] = EGL_DONT_CARE;
+		if (!eglChooseConfig(g_eglDisplay, configAttribs, &config, 1, &count) || count == 0)
+			return false;
+	}
+
+	// 1) Contexto moderno (3.3 core), 2) fallback sin atributos.
+	g_eglConfig = config;
+	g_eglContext = eglCreateContext(g_eglDisplay, config, EGL_NO_CONTEXT, kEglCoreAttribs);
+	g_eglCore = g_eglContext != EGL_NO_CONTEXT;
+	if (g_eglContext == EGL_NO_CONTEXT)
+		g_eglContext = eglCreateContext(g_eglDisplay, config, EGL_NO_CONTEXT, nullptr);
+	if (g_eglContext == EGL_NO_CONTEXT) return false;
+
+	const char* displayExts = eglQueryString(g_eglDisplay, EGL_EXTENSIONS);
+	if (!HasExtension(displayExts, "EGL_KHR_surfaceless_context"))
+	{
+		const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+		g_eglSurface = eglCreatePbufferSurface(g_eglDisplay, config, pbufferAttribs);
+		if (g_eglSurface == EGL_NO_SURFACE) return false;
+	}
+
+	if (!eglMakeCurrent(g_eglDisplay, g_eglSurface, g_eglSurface, g_eglContext))
+		return false;
+
+	g_backend = GLBackend::Egl;
+	return true;
+}
+
+static void DestroyEglContext()
+{
+	if (g_eglDisplay == EGL_NO_DISPLAY) return;
+
+	eglMakeCurrent(g_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if (g_eglSurface != EGL_NO_SURFACE) eglDestroySurface(g_eglDisplay, g_eglSurface);
+	if (g_eglContext != EGL_NO_CONTEXT) eglDestroyContext(g_eglDisplay, g_eglContext);
+	eglTerminate(g_eglDisplay);
+
+	g_eglSurface = EGL_NO_SURFACE;
+	g_eglContext = EGL_NO_CONTEXT;
+	g_eglDisplay = EGL_NO_DISPLAY;
+	g_eglConfig = nullptr;
+}
+
+
+// ---------------------------
+// Contexto
+// ---------------------------
+
+bool PlatformCreateGLContext()
+{
+	bool ok = false;
+	if (g_surface == PlatformSurface::Offscreen)
+	{
+		ok = CreateEglContext();
+		if (!ok) DestroyEglContext();
+	}
+#if BIOMATH_HAS_X11
+	else
+	{
+		ok = CreateGlxContext();
+	}
+#endif
+
+	return ok && LoadGLFunctions();
+}
+
+void PlatformDestroyGLContext()
+{
+#if BIOMATH_HAS_X11
+	if (g_glxContext)
+	{
+		glXMakeCurrent(g_display, None, nullptr);
+		glXDestroyContext(g_display, g_glxContext);
+		g_glxContext = nullptr;
+	}
+#endif
+	DestroyEglContext();
+	g_backend = GLBackend::NoContext;
+}
+
+// ---------------------------
+// Contextos compartidos
+// ---------------------------
+
+struct PlatformSharedContext
+{
+#if BIOMATH_HAS_X11
+	GLXContext glx = nullptr;
+#endif
+	EGLContext egl = EGL_NO_CONTEXT;
+	EGLSurface eglSurface = EGL_NO_SURFACE; // un pbuffer solo puede estar actual en un contexto a la vez
+};
+
+PlatformSharedContext* PlatformCreateSharedGLContext()
+{
+	PlatformSharedContext* shared = new PlatformSharedContext();
+
+#if BIOMATH_HAS_X11
+	if (g_backend == GLBackend::Glx)
+	{
+		// El worker usa la misma ventana como drawable (GLX lo permite con contextos distintos);
+		// nunca dibuja en ella.
+		shared->glx = g_glxCore ? CreateGlxCoreContext(g_glxContext)
+			: glXCreateNewContext(g_display, g_fbConfig, GLX_RGBA_TYPE, g_glxContext, True);
+		if (shared->glx) return shared;
+	}
+#endif
+	if (g_backend == GLBackend::Egl)
+	{
+		shared->egl = eglCreateContext(g_eglDisplay, g_eglConfig, g_eglContext, g_eglCore ? kEglCoreAttribs : nullptr);
+		if (shared->egl != EGL_NO_CONTEXT && g_eglSurface != EGL_NO_SURFACE)
+		{
+			const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+			shared->eglSurface = eglCreatePbufferSurface(g_eglDisplay, g_eglConfig, pbufferAttribs);
+			if (shared->eglSurface == EGL_NO_SURFACE)
+			{
+				eglDestroyContext(g_eglDisplay, shared->egl);
+				shared->egl = EGL_NO_CONTEXT;
+			}
+		}
+		if (shared->egl != EGL_NO_CONTEXT) return shared;
+	}
+
+	delete shared;
+	return nullptr;
+}
+
+bool PlatformMakeSharedGLContextCurrent(PlatformSharedContext* shared)
+{
+#if BIOMATH_HAS_X11
+	if (g_backend == GLBackend::Glx)
+		return shared ? glXMakeCurrent(g_display, g_window, shared->glx) : glXMakeCurrent(g_display, None, nullptr);
+#endif
+	if (g_backend == GLBackend::Egl)
+	{
+		if (!shared) return eglMakeCurrent(g_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		return eglMakeCurrent(g_eglDisplay, shared->eglSurface, shared->eglSurface, shared->egl);
+	}
+	return false;
+}
+
+void PlatformDestroySharedGLContext(PlatformSharedContext* shared)
+{
+	if (!shared) return;
+#if BIOMATH_HAS_X11
+	if (shared->glx) glXDestroyContext(g_display, shared->glx);
+#endif
+	if (shared->eglSurface != EGL_NO_SURFACE) eglDestroySurface(g_eglDisplay, shared->eglSurface);
+	if (shared->egl != EGL_NO_CONTEXT) eglDestroyContext(g_eglDisplay, shared->egl);
+	delete shared;
+}
+
+const char* PlatformBackendName()
+{
+	switch (g_backend)
+	{
+	case GLBackend::Glx: return "x11-glx";
+	case GLBackend::Egl: return g_eglSurface == EGL_NO_SURFACE ? "egl-surfaceless" : "egl-pbuffer";
+	default:             return g_surface == PlatformSurface::Window ? "x11" : "none";
+	}
+}
+
+void* PlatformGetGLProc(const char* name)
+{
+	// Ojo: glXGetProcAddress devuelve un stub no nulo aun para nombres que el driver no tiene.
+#if BIOMATH_HAS_X11
+	if (g_backend == GLBackend::Glx)
+		return (void*)glXGetProcAddressARB((const GLubyte*)name);
+#endif
+	if (g_backend == GLBackend::Egl)
+		return (void*)eglGetProcAddress(name);
+	return nullptr;
+}
+
+
+// ---------------------------
+// Eventos, presentacion
+// ---------------------------
+
+// Entrada (ver mas abajo): teclado, mouse y foco pasan por aca; el fallback de X11 produce los
+// eventos en este mismo thread.
+#if BIOMATH_HAS_X11
+static bool X11InputEvent(const XEvent& ev);
+#endif
+
+bool PlatformPumpEvents()
+{
+#if BIOMATH_HAS_X11
+	while (g_display && XPending(g_display) > 0)
+	{
+		XEvent ev;
+		XNextEvent(g_display, &ev);
+		if (X11InputEvent(ev)) continue;
+		switch (ev.type)
+		{
+		case ConfigureNotify:
+			g_width = ev.xconfigure.width;
+			g_height = ev.xconfigure.height;
+			break;
+
+		case ClientMessage:
+			if ((Atom)ev.xclient.data.l[0] == g_wmDelete)
+				g_running = false;
+			break;
+
+		case DestroyNotify:
+			g_running = false;
+			break;
+
+		default:
+			break;
+		}
+	}
+#endif
+	return g_running;
+}
+
+void PlatformGetWindowSize(int* width, int* height)
+{
+	*width = g_width;
+	*height = g_height;
+}
+
+void PlatformSwapBuffers()
+{
+#if BIOMATH_HAS_X11
+	if (g_backend == GLBackend::Glx)
+	{
+		glXSwapBuffers(g_display, g_window);
+		return;
+	}
+#endif
+	if (g_backend == GLBackend::Egl && g_eglSurface != EGL_NO_SURFACE)
+		eglSwapBuffers(g_eglDisplay, g_eglSurface);
+}
+
+bool PlatformSetSwapInterval(int interval)
+{
+#if BIOMATH_HAS_X11
+	if (g_backend == GLBackend::Glx)
+	{
+		const char* exts = glXQueryExtensionsString(g_display, DefaultScreen(g_display));
+		if (interval < 0 && !HasExtension(exts, "GLX_EXT_swap_control_tear"))
+			interval = 1;
+
+		if (HasExtension(exts, "GLX_EXT_swap_control"))
+		{
+			PFNGLXSWAPINTERVALEXTPROC fn = (PFNGLXSWAPINTERVALEXTPROC)glXGetProcAddressARB((const GLubyte*)"glXSwapIntervalEXT");
+			if (fn)
+			{
+				fn(g_display, g_window, interval);
+				return true;
+			}
+		}
+		if (interval >= 0 && HasExtension(exts, "GLX_MESA_swap_control"))
+		{
+			PFNGLXSWAPINTERVALMESAPROC fn = (PFNGLXSWAPINTERVALMESAPROC)glXGetProcAddressARB((const GLubyte*)"glXSwapIntervalMESA");
+			return fn && fn((unsigned)interval) == 0;
+		}
+		return false;
+	}
+#endif
+	// Sin superficie (surfaceless) no hay swap: el intervalo no aplica.
+	if (g_backend == GLBackend::Egl && g_eglSurface != EGL_NO_SURFACE)
+		return eglSwapInterval(g_eglDisplay, interval < 0 ? 1 : interval) == EGL_TRUE;
+	return false;
+}
+
+bool PlatformPresentPixels(const uint8_t* pixels, int width, int height)
+{
+#if BIOMATH_HAS_X11
+	if (!g_display || !g_window || width <= 0 || height <= 0) return false;
+
+	// BGRA8 en memoria = pixel 0xAARRGGBB en little endian: es el layout de los visuales
+	// TrueColor de 24/32 bits. Otros visuales (16 bits, big endian) no estan soportados.
+	if (g_visual->red_mask != 0xFF0000 || g_visual->green_mask != 0x00FF00 || g_visual->blue_mask != 0x0000FF)
+		return false;
+
+	// El renderer escribe bottom-up (convencion GL); X11 espera top-down.
+	const size_t rowBytes = (size_t)width * 4;
+	g_presentRows.resize(rowBytes * (size_t)height);
+	for (int y = 0; y < height; ++y)
+		memcpy(&g_presentRows[(size_t)y * rowBytes], pixels + (size_t)(height - 1 - y) * rowBytes, rowBytes);
+
+	XImage* image = XCreateImage(g_display, g_visual, (unsigned)g_depth, ZPixmap, 0,
+		(char*)g_presentRows.data(), (unsigned)width, (unsigned)height, 32, (int)rowBytes);
+	if (!image) return false;
+
+	XPutImage(g_display, g_window, g_gc, image, 0, 0, 0, 0, (unsigned)width, (unsigned)height);
+	image->data = nullptr; // el buffer es nuestro: que XDestroyImage no lo libere
+	XDestroyImage(image);
+
+	// Esperar al servidor hace de throttle, como StretchDIBits en Windows.
+	XSync(g_display, False);
+	return true;
+#else
+	(void)pixels; (void)width; (void)height;
+	return false;
+#endif
+}
+
+
+// ---------------------------
+// Reloj
+// ---------------------------
+
+uint64_t PlatformTicks()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t PlatformTickFrequency()
+{
+	return 1000000000ull; // ticks = nanosegundos
+}
+
+void PlatformSleepUntil(uint64_t deadlineTicks)
+{
+	// Deadline absoluto sobre el mismo reloj que PlatformTicks: un EINTR no corre la espera.
+	timespec ts;
+	ts.tv_sec = (time_t)(deadlineTicks / 1000000000ull);
+	ts.tv_nsec = (long)(deadlineTicks % 1000000000ull);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+}
+
+
+// ---------------------------
+// Archivos
+// ---------------------------
+
+uint64_t PlatformFileModifiedTime(const char* path)
+{
+	struct stat st;
+	if (stat(path, &st) != 0) return 0;
+	return (uint64_t)st.st_mtim.tv_sec * 1000000000ull + (uint64_t)st.st_mtim.tv_nsec;
+}
+
+bool PlatformCacheDirectory(char* out, size_t size)
+{
+	char base[1024];
+	const char* xdg = getenv("XDG_CACHE_HOME");
+	const char* home = getenv("HOME");
+	if (xdg && xdg[0]) snprintf(base, sizeof(base), "%s", xdg);
+	else if (home && home[0]) snprintf(base, sizeof(base), "%s/.cache", home);
+	else return false;
+
+	mkdir(base, 0755); // ~/.cache puede no existir todavia
+	if (snprintf(out, size, "%s/biomath", base) >= (int)size) return false;
+	return mkdir(out, 0755) == 0 || errno == EEXIST;
+}
+
+// ---------------------------
+// Audio (ALSA via dlopen)
+// ---------------------------
+
+// libasound se carga en runtime, como GL: el binario no depende de ALSA (las maquinas de CI no la
+// tienen) y sin ella simplemente no hay salida de audio. Se usa la API "simple" de snd_pcm.
+
+struct snd_pcm_t;
+
+static const int kSndPcmStreamPlayback = 0;
+static const int kSndPcmFormatS16LE = 2;
+static const int kSndPcmAccessRWInterleaved = 3;
+
+struct AlsaApi
+{
+	void* lib = nullptr;
+	int (*pcmOpen)(snd_pcm_t**, const char*, int, int) = nullptr;
+	int (*pcmSetParams)(snd_pcm_t*, int, int, unsigned, unsigned, int, unsigned) = nullptr;
+	long (*pcmWritei)(snd_pcm_t*, const void*, unsigned long) = nullptr;
+	int (*pcmRecover)(snd_pcm_t*, int, int) = nullptr;
+	int (*pcmDrop)(snd_pcm_t*) = nullptr;
+	int (*pcmClose)(snd_pcm_t*) = nullptr;
+};
+
+static AlsaApi g_alsa;
+
+static bool LoadAlsa()
+{
+	if (g_alsa.lib) return true;
+	void* lib = dlopen("libasound.so.2", RTLD_NOW | RTLD_LOCAL);
+	if (!lib) return false;
+
+	AlsaApi api;
+	api.lib = lib;
+	api.pcmOpen = (int (*)(snd_pcm_t**, const char*, int, int))dlsym(lib, "snd_pcm_open");
+	api.pcmSetParams = (int (*)(snd_pcm_t*, int, int, unsigned, unsigned, int, unsigned))dlsym(lib, "snd_pcm_set_params");
+	api.pcmWritei = (long (*)(snd_pcm_t*, const void*, unsigned long))dlsym(lib, "snd_pcm_writei");
+	api.pcmRecover = (int (*)(snd_pcm_t*, int, int))dlsym(lib, "snd_pcm_recover");
+	api.pcmDrop = (int (*)(snd_pcm_t*))dlsym(lib, "snd_pcm_drop");
+	api.pcmClose = (int (*)(snd_pcm_t*))dlsym(lib, "snd_pcm_close");
+	if (!api.pcmOpen || !api.pcmSetParams || !api.pcmWritei || !api.pcmRecover || !api.pcmDrop || !api.pcmClose)
+	{
+		dlclose(lib);
+		return false;
+	}
+	g_alsa = api;
+	return true;
+}
+
+struct PlatformAudioDevice
+{
+	snd_pcm_t* pcm = nullptr;
+	int blockFrames = 0;
+	std::vector<int16_t> interleaved; // se dimensiona al abrir: Write no aloca
+};
+
+PlatformAudioDevice* PlatformAudioOpen(const PlatformAudioDesc& desc)
+{
+	if (!LoadAlsa()) return nullptr;
+
+	snd_pcm_t* pcm = nullptr;
+	if (g_alsa.pcmOpen(&pcm, "default", kSndPcmStreamPlayback, 0) < 0) return nullptr;
+
+	const unsigned latencyUs = (unsigned)((double)desc.bufferBlocks * desc.blockFrames * 1e6 / desc.sampleRate);
+	if (g_alsa.pcmSetParams(pcm, kSndPcmFormatS16LE, kSndPcmAccessRWInterleaved, 2, (unsigned)desc.sampleRate, 1, latencyUs) < 0)
+	{
+		g_alsa.pcmClose(pcm);
+		return nullptr;
+	}
+
+	PlatformAudioDevice* device = new PlatformAudioDevice();
+	device->pcm = pcm;
+	device->blockFrames = desc.blockFrames;
+	device->interleaved.resize((size_t)desc.blockFrames * 2);
+	return device;
+}
+
+static int16_t AudioToPcm16(float x)
+{
+	if (x > 1.0f) x = 1.0f;
+	if (x < -1.0f) x = -1.0f;
+	return (int16_t)(x * 32767.0f);
+}
+
+PlatformAudioResult PlatformAudioWrite(PlatformAudioDevice* device, const float* left, const float* right, int frames)
+{
+	if (frames > device->blockFrames) frames = device->blockFrames;
+	int16_t* out = device->interleaved.data();
+	for (int i = 0; i < frames; ++i)
+	{
+		out[i * 2] = AudioToPcm16(left[i]);
+		out[i * 2 + 1] = AudioToPcm16(right[i]);
+	}
+
+	PlatformAudioResult result = PlatformAudioResult::Ok;
+	int written = 0;
+	while (written < frames)
+	{
+		const long n = g_alsa.pcmWritei(device->pcm, out + written * 2, (unsigned long)(frames - written));
+		if (n >= 0)
+		{
+			written += (int)n;
+			continue;
+		}
+		// -EPIPE = underrun; recover re-prepara el stream y se reintenta.
+		if (n == -EPIPE) result = PlatformAudioResult::Underrun;
+		if (g_alsa.pcmRecover(device->pcm, (int)n, 1) < 0) return PlatformAudioResult::Error;
+	}
+	return result;
+}
+
+void PlatformAudioClose(PlatformAudioDevice* device)
+{
+	if (!device) return;
+	g_alsa.pcmDrop(device->pcm);
+	g_alsa.pcmClose(device->pcm);
+	delete device;
+}
+
+const char* PlatformAudioBackendName()
+{
+	return "alsa";
+}
+
+bool PlatformSetAudioThreadPriority()
+{
+	// SCHED_FIFO necesita CAP_SYS_NICE o rtprio en limits.conf; sin eso queda en la prioridad normal.
+	sched_param param;
+	param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 10;
+	return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+}
+
+// ---------------------------
+// Entrada (evdev / X11)
+// ---------------------------
+
+// evdev lee los dispositivos directamente del kernel en un thread propio: cada evento trae el
+// timestamp de la interrupcion (EVIOCSCLOCKID lo pasa a CLOCK_MONOTONIC, el reloj de PlatformTicks)
+// y no depende de cuando el loop bombea la cola de X. Hace falta permiso de lectura sobre
+// /dev/input/event* (grupo "input"); sin teclado ni mouse legibles se cae a los eventos de X11,
+// fechados al sacarlos de la cola en PlatformPumpEvents. Los dispositivos se enumeran al arrancar
+// (sin hotplug): un gamepad que se desconecta manda GamepadDisconnected y no vuelve.
+//
+// Sin X11 no hay ventana, ni foco que respetar: no hay entrada.
+
+#if BIOMATH_HAS_X11
+static const int kEvdevMaxDevices = 32;
+static const int kInputMaxPads = 4;
+
+enum class InputBackend
+{
+	Stopped,  // (None es un macro de Xlib)
+	Evdev,
+	X11,
+};
+
+enum class EvdevKind
+{
+	Keyboard,
+	Mouse,
+	Gamepad,
+};
+
+struct EvdevDevice
+{
+	int fd = -1;
+	EvdevKind kind = EvdevKind::Keyboard;
+	int pad = 0;
+	bool monotonic = false;  // timestamps en CLOCK_MONOTONIC (si no, se fecha al leer)
+	int32_t relX = 0;        // movimiento acumulado hasta el proximo SYN_REPORT
+	int32_t relY = 0;
+	int hatX = 0;            // cruceta reportada como ABS_HAT0X/Y
+	int hatY = 0;
+	int32_t absMin[6] = {};  // rangos de los ejes, en el orden de PlatformInputType::GamepadAxis
+	int32_t absMax[6] = {};
+};
+
+// Lo que el productor reporto como apretado, para cortar el autorepeat y soltar todo al perder el foco.
+struct InputHeld
+{
+	uint8_t keys[256] = {};
+	uint8_t mouse = 0;
+	uint16_t pads[kInputMaxPads] = {};
+};
+
+struct InputPlatform
+{
+	InputBackend backend = InputBackend::Stopped;
+	PlatformInputCallback callback = nullptr;
+	void* ctx = nullptr;
+	std::atomic<bool> focused{ false };
+	bool wasFocused = false;
+	InputHeld held;
+
+	std::vector<EvdevDevice> devices;
+	int wakePipe[2] = { -1, -1 };
+	std::thread thread;
+
+	int lastX = 0, lastY = 0;  // ultima posicion de MotionNotify (backend x11)
+	bool hasLast = false;
+};
+
+static InputPlatform g_inputPlatform;
+
+// Filtro comun de los dos backends: sin foco no sale nada y las teclas ya apretadas no se repiten.
+static void InputEmit(const PlatformInputEvent& ev)
+{
+	InputPlatform& in = g_inputPlatform;
+	if (!in.focused.load(std::memory_order_relaxed)) return;
+
+	InputHeld& h = in.held;
+	const int pad = ev.pad & (kInputMaxPads - 1);
+	switch (ev.type)
+	{
+	case PlatformInputType::KeyDown:
+		if (h.keys[ev.code & 0xFF]) return;
+		h.keys[ev.code & 0xFF] = 1;
+		break;
+	case PlatformInputType::KeyUp:
+		if (!h.keys[ev.code & 0xFF]) return;
+		h.keys[ev.code & 0xFF] = 0;
+		break;
+	case PlatformInputType::MouseButtonDown:
+		h.mouse |= (uint8_t)(1u << (ev.code & 7));
+		break;
+	case PlatformInputType::MouseButtonUp:
+		h.mouse &= (uint8_t)~(1u << (ev.code & 7));
+		break;
+	case PlatformInputType::GamepadButtonDown:
+		h.pads[pad] |= (uint16_t)(1u << (ev.code & 15));
+		break;
+	case PlatformInputType::GamepadButtonUp:
+		h.pads[pad] &= (uint16_t)~(1u << (ev.code & 15));
+		break;
+	default:
+		break;
+	}
+	in.callback(in.ctx, ev);
+}
+
+// Al perder el foco los "up" no van a llegar: se mandan ahora, con el foco todavia a favor.
+static void InputReleaseHeld(uint64_t ticks)
+{
+	InputHeld& h = g_inputPlatform.held;
+	PlatformInputEvent ev;
+	ev.ticks = ticks;
+	for (int k = 0; k < 256; ++k)
+	{
+		if (!h.keys[k]) continue;
+		ev.type = PlatformInputType::KeyUp;
+		ev.code = (uint16_t)k;
+		g_inputPlatform.callback(g_inputPlatform.ctx, ev);
+	}
+	for (int b = 0; b < 8; ++b)
+	{
+		if (!(h.mouse & (1u << b))) continue;
+		ev.type = PlatformInputType::MouseButtonUp;
+		ev.code = (uint16_t)b;
+		g_inputPlatform.callback(g_inputPlatform.ctx, ev);
+	}
+	for (int p = 0; p < kInputMaxPads; ++p)
+	{
+		for (int b = 0; b < 16; ++b)
+		{
+			if (!(h.pads[p] & (1u << b))) continue;
+			ev.type = PlatformInputType::GamepadButtonUp;
+			ev.pad = (uint8_t)p;
+			ev.code = (uint16_t)b;
+			g_inputPlatform.callback(g_inputPlatform.ctx, ev);
+		}
+	}
+	h = InputHeld();
+}
+
+// Codigo de tecla de evdev (layout fisico US) -> PlatformKey. 0 = no la usamos.
+static uint16_t EvdevKeyToPlatform(int code)
+{
+	static const char kRowQ[] = "QWERTYUIOP";
+	static const char kRowA[] = "ASDFGHJKL";
+	static const char kRowZ[] = "ZXCVBNM";
+	if (code >= KEY_Q && code <= KEY_P) return (uint16_t)kRowQ[code - KEY_Q];
+	if (code >= KEY_A && code <= KEY_L) return (uint16_t)kRowA[code - KEY_A];
+	if (code >= KEY_Z && code <= KEY_M) return (uint16_t)kRowZ[code - KEY_Z];
+	if (code >= KEY_1 && code <= KEY_9) return (uint16_t)('1' + (code - KEY_1));
+	if (code >= KEY_F1 && code <= KEY_F10) return (uint16_t)((int)PlatformKey::F1 + (code - KEY_F1));
+
+	switch (code)
+	{
+	case KEY_0:         return '0';
+	case KEY_F11:       return (uint16_t)PlatformKey::F11;
+	case KEY_F12:       return (uint16_t)PlatformKey::F12;
+	case KEY_ESC:       return (uint16_t)PlatformKey::Escape;
+	case KEY_BACKSPACE: return (uint16_t)PlatformKey::Backspace;
+	case KEY_TAB:       return (uint16_t)PlatformKey::Tab;
+	case KEY_ENTER:
+	case KEY_KPENTER:   return (uint16_t)PlatformKey::Enter;
+	case KEY_SPACE:     return (uint16_t)PlatformKey::Space;
+	case KEY_LEFTSHIFT:
+	case KEY_RIGHTSHIFT: return (uint16_t)PlatformKey::Shift;
+	case KEY_LEFTCTRL:
+	case KEY_RIGHTCTRL: return (uint16_t)PlatformKey::Control;
+	case KEY_LEFTALT:
+	case KEY_RIGHTALT:  return (uint16_t)PlatformKey::Alt;
+	case KEY_LEFT:      return (uint16_t)PlatformKey::Left;
+	case KEY_RIGHT:     return (uint16_t)PlatformKey::Right;
+	case KEY_UP:        return (uint16_t)PlatformKey::Up;
+	case KEY_DOWN:      return (uint16_t)PlatformKey::Down;
+	default:            return 0;
+	}
+}
+
+// Boton de gamepad de evdev -> PlatformGamepadButton. -1 = no lo usamos.
+static int EvdevPadButton(int code)
+{
+	switch (code)
+	{
+	case BTN_SOUTH:      return (int)PlatformGamepadButton::A;
+	case BTN_EAST:       return (int)PlatformGamepadButton::B;
+	case BTN_X:          return (int)PlatformGamepadButton::X;
+	case BTN_Y:          return (int)PlatformGamepadButton::Y;
+	case BTN_TL:         return (int)PlatformGamepadButton::LeftShoulder;
+	case BTN_TR:         return (int)PlatformGamepadButton::RightShoulder;
+	case BTN_SELECT:     return (int)PlatformGamepadButton::Back;
+	case BTN_START:      return (int)PlatformGamepadButton::Start;
+	case BTN_THUMBL:     return (int)PlatformGamepadButton::LeftThumb;
+	case BTN_THUMBR:     return (int)PlatformGamepadButton::RightThumb;
+	case BTN_DPAD_UP:    return (int)PlatformGamepadButton::DPadUp;
+	case BTN_DPAD_DOWN:  return (int)PlatformGamepadButton::DPadDown;
+	case BTN_DPAD_LEFT:  return (int)PlatformGamepadButton::DPadLeft;
+	case BTN_DPAD_RIGHT: return (int)PlatformGamepadButton::DPadRight;
+	default:             return -1;
+	}
+}
+
+// Eje de evdev -> indice de GamepadAxis. -1 = no lo usamos.
+static int EvdevPadAxis(int code)
+{
+	switch (code)
+	{
+	case ABS_X:  return 0;
+	case ABS_Y:  return 1;
+	case ABS_RX: return 2;
+	case ABS_RY: return 3;
+	case ABS_Z:  return 4;
+	case ABS_RZ: return 5;
+	default:     return -1;
+	}
+}
+
+static bool TestBit(const unsigned long* bits, int bit)
+{
+	const int perLong = (int)sizeof(unsigned long) * 8;
+	return (bits[bit / perLong] >> (bit % perLong)) & 1ul;
+}
+
+static uint64_t EvdevTicks(const EvdevDevice& dev, const input_event& ev)
+{
+	if (!dev.monotonic) return PlatformTicks();
+	return (uint64_t)ev.input_event_sec * 1000000000ull + (uint64_t)ev.input_event_usec * 1000ull;
+}
+
+static void EmitPadButton(const EvdevDevice& dev, uint64_t ticks, int button, bool down)
+{
+	PlatformInputEvent out;
+	out.ticks = ticks;
+	out.type = down ? PlatformInputType::GamepadButtonDown : PlatformInputType::GamepadButtonUp;
+	out.pad = (uint8_t)dev.pad;
+	out.code = (uint16_t)button;
+	InputEmit(out);
+}
+
+// La cruceta como eje (-1/0/+1) pasa a dos pares de botones.
+static void EmitPadHat(EvdevDevice& dev, uint64_t ticks, int* hat, int value, PlatformGamepadButton neg, PlatformGamepadButton pos)
+{
+	if (*hat == value) return;
+	if (*hat < 0) EmitPadButton(dev, ticks, (int)neg, false);
+	if (*hat > 0) EmitPadButton(dev, ticks, (int)pos, false);
+	if (value < 0) EmitPadButton(dev, ticks, (int)neg, true);
+	if (value > 0) EmitPadButton(dev, ticks, (int)pos, true);
+	*hat = value;
+}
+
+static void EvdevTranslate(EvdevDevice& dev, const input_event& ev)
+{
+	const uint64_t ticks = EvdevTicks(dev, ev);
+	PlatformInputEvent out;
+	out.ticks = ticks;
+
+	switch (ev.type)
+	{
+	case EV_KEY:
+		if (ev.value == 2) return; // autorepeat del kernel
+		if (dev.kind == EvdevKind::Gamepad)
+		{
+			const int button = EvdevPadButton(ev.code);
+			if (button >= 0) EmitPadButton(dev, ticks, button, ev.value != 0);
+			return;
+		}
+		if (ev.code >= BTN_LEFT && ev.code <= BTN_EXTRA)
+		{
+			// BTN_LEFT, RIGHT, MIDDLE, SIDE, EXTRA son consecutivos y en el orden de PlatformInputType
+			out.type = ev.value ? PlatformInputType::MouseButtonDown : PlatformInputType::MouseButtonUp;
+			out.code = (uint16_t)(ev.code - BTN_LEFT);
+			InputEmit(out);
+			return;
+		}
+		out.code = EvdevKeyToPlatform(ev.code);
+		if (!out.code) return;
+		out.type = ev.value ? PlatformInputType::KeyDown : PlatformInputType::KeyUp;
+		InputEmit(out);
+		return;
+
+	case EV_REL:
+		if (ev.code == REL_X) dev.relX += ev.value;
+		else if (ev.code == REL_Y) dev.relY += ev.value;
+		else if (ev.code == REL_WHEEL)
+		{
+			out.type = PlatformInputType::MouseWheel;
+			out.value = (float)ev.value;
+			InputEmit(out);
+		}
+		return;
+
+	case EV_ABS:
+	{
+		if (dev.kind != EvdevKind::Gamepad) return;
+		if (ev.code == ABS_HAT0X)
+		{
+			EmitPadHat(dev, ticks, &dev.hatX, ev.value, PlatformGamepadButton::DPadLeft, PlatformGamepadButton::DPadRight);
+			return;
+		}
+		if (ev.code == ABS_HAT0Y)
+		{
+			EmitPadHat(dev, ticks, &dev.hatY, ev.value, PlatformGamepadButton::DPadUp, PlatformGamepadButton::DPadDown);
+			return;
+		}
+		const int axis = EvdevPadAxis(ev.code);
+		if (axis < 0 || dev.absMax[axis] <= dev.absMin[axis]) return;
+		float v = (float)(ev.value - dev.absMin[axis]) / (float)(dev.absMax[axis] - dev.absMin[axis]);
+		if (axis < 4)
+		{
+			v = v * 2.0f - 1.0f;
+			if (axis == 1 || axis == 3) v = -v; // evdev: Y+ hacia abajo; XInput: hacia arriba
+		}
+		out.type = PlatformInputType::GamepadAxis;
+		out.pad = (uint8_t)dev.pad;
+		out.code = (uint16_t)axis;
+		out.value = v;
+		InputEmit(out);
+		return;
+	}
+
+	case EV_SYN:
+		if (ev.code == SYN_REPORT && (dev.relX || dev.relY))
+		{
+			out.type = PlatformInputType::MouseMove;
+			out.x = dev.relX;
+			out.y = dev.relY;
+			dev.relX = 0;
+			dev.relY = 0;
+			InputEmit(out);
+		}
+		return;
+
+	default:
+		return;
+	}
+}
+
+static void EvdevClose(EvdevDevice& dev)
+{
+	if (dev.fd < 0) return;
+	close(dev.fd);
+	dev.fd = -1;
+	if (dev.kind == EvdevKind::Gamepad)
+	{
+		// Los botones del pad los suelta input.cpp al ver la desconexion.
+		g_inputPlatform.held.pads[dev.pad] = 0;
+		PlatformInputEvent ev;
+		ev.ticks = PlatformTicks();
+		ev.type = PlatformInputType::GamepadDisconnected;
+		ev.pad = (uint8_t)dev.pad;
+		g_inputPlatform.callback(g_inputPlatform.ctx, ev);
+	}
+}
+
+static void EvdevThreadMain()
+{
+	InputPlatform& in = g_inputPlatform;
+	pollfd fds[kEvdevMaxDevices + 1];
+	int deviceOf[kEvdevMaxDevices + 1];
+	input_event events[64];
+
+	for (;;)
+	{
+		int count = 0;
+		fds[count++] = pollfd{ in.wakePipe[0], POLLIN, 0 };
+		for (int i = 0; i < (int)in.devices.size(); ++i)
+		{
+			if (in.devices[(size_t)i].fd < 0) continue;
+			deviceOf[count] = i;
+			fds[count++] = pollfd{ in.devices[(size_t)i].fd, POLLIN, 0 };
+		}
+
+		// El timeout solo sirve para notar que se perdio el foco sin eventos de por medio.
+		const int ready = poll(fds, (nfds_t)count, 50);
+
+		const bool focused = in.focused.load(std::memory_order_relaxed);
+		if (in.wasFocused && !focused) InputReleaseHeld(PlatformTicks());
+		in.wasFocused = focused;
+
+		if (ready < 0 && errno != EINTR) break;
+		if (fds[0].revents) break; // PlatformInputStop
+
+		for (int i = 1; i < count; ++i)
+		{
+			if (!fds[i].revents) continue;
+			EvdevDevice& dev = in.devices[(size_t)deviceOf[i]];
+			for (;;)
+			{
+				const ssize_t n = read(dev.fd, events, sizeof(events));
+				if (n < 0)
+				{
+					if (errno != EAGAIN && errno != EINTR) EvdevClose(dev); // ENODEV: lo desenchufaron
+					break;
+				}
+				for (size_t e = 0; e < (size_t)n / sizeof(input_event); ++e)
+					EvdevTranslate(dev, events[e]);
+				if ((size_t)n < sizeof(events)) break;
+			}
+		}
+	}
+}
+
+// Abre /dev/input/event* y se queda con teclados, mouse y gamepads. false si no hay teclado ni mouse.
+static bool EvdevOpenDevices()
+{
+	InputPlatform& in = g_inputPlatform;
+	bool keyboardOrMouse = false;
+	int pads = 0;
+
+	for (int i = 0; i < 64 && (int)in.devices.size() < kEvdevMaxDevices; ++i)
+	{
+		char path[64];
+		snprintf(path, sizeof(path), "/dev/input/event%d", i);
+		const int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+		if (fd < 0) continue;
+
+		unsigned long keyBits[KEY_MAX / (sizeof(unsigned long) * 8) + 1] = {};
+		unsigned long relBits[REL_MAX / (sizeof(unsigned long) * 8) + 1] = {};
+		unsigned long absBits[ABS_MAX / (sizeof(unsigned long) * 8) + 1] = {};
+		ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits);
+		ioctl(fd, EVIOCGBIT(EV_REL, sizeof(relBits)), relBits);
+		ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits);
+
+		EvdevDevice dev;
+		dev.fd = fd;
+		if (TestBit(absBits, ABS_X) && TestBit(keyBits, BTN_GAMEPAD) && pads < kInputMaxPads)
+		{
+			dev.kind = EvdevKind::Gamepad;
+			dev.pad = pads++;
+			static const int kAxes[6] = { ABS_X, ABS_Y, ABS_RX, ABS_RY, ABS_Z, ABS_RZ };
+			for (int a = 0; a < 6; ++a)
+			{
+				input_absinfo info{};
+				if (TestBit(absBits, kAxes[a]) && ioctl(fd, EVIOCGABS(kAxes[a]), &info) == 0)
+				{
+					dev.absMin[a] = info.minimum;
+					dev.absMax[a] = info.maximum;
+				}
+			}
+		}
+		else if (TestBit(relBits, REL_X) && TestBit(relBits, REL_Y) && TestBit(keyBits, BTN_LEFT))
+		{
+			dev.kind = EvdevKind::Mouse;
+			keyboardOrMouse = true;
+		}
+		else if (TestBit(keyBits, KEY_A) && TestBit(keyBits, KEY_SPACE))
+		{
+			dev.kind = EvdevKind::Keyboard;
+			keyboardOrMouse = true;
+		}
+		else
+		{
+			close(fd);
+			continue;
+		}
+
+		int clock = CLOCK_MONOTONIC;
+		dev.monotonic = ioctl(fd, EVIOCSCLOCKID, &clock) == 0;
+		in.devices.push_back(dev);
+	}
+
+	if (keyboardOrMouse) return true;
+	for (EvdevDevice& dev : in.devices) close(dev.fd);
+	in.devices.clear();
+	return false;
+}
+
+static uint16_t X11KeyToPlatform(KeySym sym)
+{
+	if (sym >= XK_a && sym <= XK_z) return (uint16_t)('A' + (sym - XK_a));
+	if (sym >= XK_0 && sym <= XK_9) return (uint16_t)('0' + (sym - XK_0));
+	if (sym >= XK_F1 && sym <= XK_F12) return (uint16_t)((int)PlatformKey::F1 + (int)(sym - XK_F1));
+
+	switch (sym)
+	{
+	case XK_Escape:    return (uint16_t)PlatformKey::Escape;
+	case XK_BackSpace: return (uint16_t)PlatformKey::Backspace;
+	case XK_Tab:       return (uint16_t)PlatformKey::Tab;
+	case XK_Return:
+	case XK_KP_Enter:  return (uint16_t)PlatformKey::Enter;
+	case XK_space:     return (uint16_t)PlatformKey::Space;
+	case XK_Shift_L:
+	case XK_Shift_R:   return (uint16_t)PlatformKey::Shift;
+	case XK_Control_L:
+	case XK_Control_R: return (uint16_t)PlatformKey::Control;
+	case XK_Alt_L:
+	case XK_Alt_R:     return (uint16_t)PlatformKey::Alt;
+	case XK_Left:      return (uint16_t)PlatformKey::Left;
+	case XK_Right:     return (uint16_t)PlatformKey::Right;
+	case XK_Up:        return (uint16_t)PlatformKey::Up;
+	case XK_Down:      return (uint16_t)PlatformKey::Down;
+	default:           return 0;
+	}
+}
+
+// Llamado desde PlatformPumpEvents con cada evento de X. Devuelve true si era de entrada (el foco
+// se registra siempre; teclas y mouse solo se traducen con el backend x11).
+static bool X11InputEvent(const XEvent& ev)
+{
+	InputPlatform& in = g_inputPlatform;
+	if (ev.type == FocusIn || ev.type == FocusOut)
+	{
+		const bool focused = ev.type == FocusIn;
+		if (!focused && in.backend == InputBackend::X11) InputReleaseHeld(PlatformTicks());
+		in.focused.store(focused, std::memory_order_relaxed);
+		in.hasLast = false;
+		return true;
+	}
+	if (in.backend != InputBackend::X11) return false;
+
+	PlatformInputEvent out;
+	out.ticks = PlatformTicks();
+	switch (ev.type)
+	{
+	case KeyPress:
+	case KeyRelease:
+		out.code = X11KeyToPlatform(XkbKeycodeToKeysym(g_display, (KeyCode)ev.xkey.keycode, 0, 0));
+		if (!out.code) return true;
+		out.type = ev.type == KeyPress ? PlatformInputType::KeyDown : PlatformInputType::KeyUp;
+		InputEmit(out);
+		return true;
+
+	case ButtonPress:
+	case ButtonRelease:
+	{
+		const unsigned b = ev.xbutton.button;
+		if (b == Button4 || b == Button5)
+		{
+			// La rueda llega como press/release de los botones 4 y 5; alcanza con el press.
+			if (ev.type != ButtonPress) return true;
+			out.type = PlatformInputType::MouseWheel;
+			out.value = b == Button4 ? 1.0f : -1.0f;
+			InputEmit(out);
+			return true;
+		}
+		static const int kButtons[10] = { -1, 0, 2, 1, -1, -1, -1, -1, 3, 4 }; // X: 1 izq, 2 medio, 3 der, 8-9 laterales
+		if (b >= 10 || kButtons[b] < 0) return true;
+		out.type = ev.type == ButtonPress ? PlatformInputType::MouseButtonDown : PlatformInputType::MouseButtonUp;
+		out.code = (uint16_t)kButtons[b];
+		InputEmit(out);
+		return true;
+	}
+
+	case MotionNotify:
+		// X da posiciones absolutas: el desplazamiento es contra la ultima vista.
+		if (in.hasLast)
+		{
+			out.type = PlatformInputType::MouseMove;
+			out.x = ev.xmotion.x - in.lastX;
+			out.y = ev.xmotion.y - in.lastY;
+			if (out.x || out.y) InputEmit(out);
+		}
+		in.lastX = ev.xmotion.x;
+		in.lastY = ev.xmotion.y;
+		in.hasLast = true;
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+bool PlatformInputStart(PlatformInputCallback callback, void* ctx)
+{
+	InputPlatform& in = g_inputPlatform;
+	if (!g_display || !g_window || in.backend != InputBackend::Stopped) return false;
+
+	in.callback = callback;
+	in.ctx = ctx;
+	in.held = InputHeld();
+
+	if (EvdevOpenDevices() && pipe2(in.wakePipe, O_CLOEXEC) == 0)
+	{
+		in.backend = InputBackend::Evdev;
+		in.wasFocused = in.focused.load(std::memory_order_relaxed);
+		for (const EvdevDevice& dev : in.devices)
+		{
+			if (dev.kind != EvdevKind::Gamepad) continue;
+			PlatformInputEvent ev;
+			ev.ticks = PlatformTicks();
+			ev.type = PlatformInputType::GamepadConnected;
+			ev.pad = (uint8_t)dev.pad;
+			callback(ctx, ev);
+		}
+		in.thread = std::thread(EvdevThreadMain);
+		return true;
+	}
+
+	for (EvdevDevice& dev : in.devices) close(dev.fd);
+	in.devices.clear();
+
+	// Sin esto X manda el autorepeat como pares release/press indistinguibles de los reales.
+	XkbSetDetectableAutoRepeat(g_display, True, nullptr);
+	in.backend = InputBackend::X11;
+	return true;
+}
+
+void PlatformInputStop()
+{
+	InputPlatform& in = g_inputPlatform;
+	if (in.backend == InputBackend::Evdev)
+	{
+		const char wake = 1;
+		if (write(in.wakePipe[1], &wake, 1) < 0) {}
+		in.thread.join();
+		for (EvdevDevice& dev : in.devices)
+			if (dev.fd >= 0) close(dev.fd);
+		in.devices.clear();
+		close(in.wakePipe[0]);
+		close(in.wakePipe[1]);
+		in.wakePipe[0] = in.wakePipe[1] = -1;
+	}
+	in.backend = InputBackend::Stopped;
+	in.callback = nullptr;
+}
+
+const char* PlatformInputBackendName()
+{
+	switch (g_inputPlatform.backend)
+	{
+	case InputBackend::Evdev: return "evdev";
+	case InputBackend::X11:   return "x11";
+	default:                  return "none";
+	}
+}
+#else
+bool PlatformInputStart(PlatformInputCallback, void*)
+{
+	return false;
+}
+
+void PlatformInputStop()
+{
+}
+
+const char* PlatformInputBackendName()
+{
+	return "none";
+}
+#endif
+
+// ---------------------------
+// Consola, errores
+// ---------------------------
+
+void PlatformShowError(const char* title, const char* text)
+{
+	fprintf(stderr, "%s: %s\n", title, text);
+}
+
+void PlatformAttachConsole()
+{
+	// En Linux stdout/stderr ya son los de la terminal.
+}
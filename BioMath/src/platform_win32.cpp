@@ -0,0 +1,939 @@
+#include "platform.h"
+#include "gl_api.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <mmsystem.h>
+#include <timeapi.h>
+#include <Xinput.h>
+
+#pragma comment(lib, "opengl32.lib")
+#pragma comment(lib, "winmm.lib") // timeBeginPeriod (solo sin timers de alta resolucion), waveOut
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+	#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+// ----------------------------
+// Declaraciones WGL minimas
+// ----------------------------
+
+// Constantes de la extensin WGL (permite pedir contextos OpenGL modernos)
+
+#define WGL_CONTEXT_MAJOR_VERSION_ARB 0x2091 // El nmero de versin mayor del contexto OpenGL que estamos pidiendo
+#define WGL_CONTEXT_MINOR_VERSION_ARB 0x2092 // El nmero de versin menor del contexto OpenGL
+#define WGL_CONTEXT_PROFILE_MASK_ARB  0x9126 // Que perfil de OpenGL quiero
+#define WGL_CONTEXT_CORE_PROFILE_BIT_ARB 0x00000001 // El perfil core de OpenGL
+
+
+// Typedef de un puntero a funcin para el tipo de la funcin de extensin wglCreateContextAttribsARB,
+// que es la que te permite crear un contexto OpenGL moderno(ej : 3.3 core) en Windows.
+
+typedef HGLRC(WINAPI* PFNWGLCREATECONTEXTATTRIBSARBPROC)(HDC, HGLRC, const int*);
+
+// WGL_EXT_swap_control: intervalo de vsync (-1 = adaptive con WGL_EXT_swap_control_tear).
+typedef BOOL(WINAPI* PFNWGLSWAPINTERVALEXTPROC)(int);
+
+static PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB_ptr = nullptr;
+static PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT_ptr = nullptr;
+
+
+// ---------------------------
+// Estado
+// ---------------------------
+
+static const wchar_t* kClassName = L"BioMathWindow";
+
+// Handlers (encargados de procesar eventos):
+
+// HWND: Handle to Window
+// HDC: Handle to device context
+// HGLRC: Handle to OpenGL rendering context
+
+static HWND  g_hwnd = nullptr;
+static HDC   g_hdc = nullptr;
+static HGLRC g_glrc = nullptr;
+static bool  g_running = true;
+
+static int g_width = 1280;
+static int g_height = 720;
+
+
+// ---------------------------
+// Ventana
+// ---------------------------
+
+static LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	switch (msg)
+	{
+	case WM_SIZE:
+		g_width = LOWORD(lParam);
+		g_height = HIWORD(lParam);
+		return 0;
+
+	case WM_CLOSE:
+		DestroyWindow(hWnd);
+		return 0;
+
+	case WM_DESTROY:
+		g_running = false;
+		PostQuitMessage(0);
+		return 0;
+
+	default:
+		return DefWindowProc(hWnd, msg, wParam, lParam);
+	}
+}
+
+bool PlatformCreateWindow(const PlatformDesc& desc)
+{
+	HINSTANCE hInstance = GetModuleHandleW(nullptr);
+
+	WNDCLASS wc{};
+	wc.lpfnWndProc = WndProc;
+	wc.hInstance = hInstance;
+	wc.lpszClassName = kClassName;
+
+	if (!RegisterClass(&wc))
+		return false;
+
+	// El titulo llega en UTF-8 (la interfaz es portable) y la ventana es Unicode.
+	wchar_t title[256] = {};
+	MultiByteToWideChar(CP_UTF8, 0, desc.title ? desc.title : "", -1, title, 256);
+
+	g_width = desc.width;
+	g_height = desc.height;
+
+	// En offscreen la ventana existe igual (WGL necesita un HDC para el pixel format) pero
+	// nunca se muestra: se dibuja en un FBO.
+	g_hwnd = CreateWindowEx(
+		0, kClassName, title,
+		WS_OVERLAPPEDWINDOW,
+		CW_USEDEFAULT, CW_USEDEFAULT, g_width, g_height,
+		nullptr, nullptr, hInstance, nullptr
+	);
+	if (!g_hwnd) return false;
+
+	if (desc.surface == PlatformSurface::Window)
+		ShowWindow(g_hwnd, SW_SHOW);
+
+	g_running = true;
+	return true;
+}
+
+void PlatformDestroyWindow()
+{
+	if (g_hwnd)
+	{
+		DestroyWindow(g_hwnd);
+		g_hwnd = nullptr;
+	}
+}
+
+
+// ---------------------------
+// WGL
+// ---------------------------
+
+// Inicializacin de WGL.
+// Conecto OpenGL a la ventana.
+// Creo un contexto viejo para poder cargar la funcin que crea un contexto moderno.
+// Si puedo, creo OpenGL 3.3 core.Si no, me quedo con el viejo.
+// Y finalmente verifico que tengo las funciones necesarias para renderizar.
+
+bool PlatformCreateGLContext()
+{
+	g_hdc = GetDC(g_hwnd);
+	if (!g_hdc) return false;
+
+	PIXELFORMATDESCRIPTOR pfd{}; // Como sera el framebuffer?
+	pfd.nSize = sizeof(pfd);
+	pfd.nVersion = 1;
+	pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
+	pfd.iPixelType = PFD_TYPE_RGBA;
+	pfd.cColorBits = 32;
+	pfd.cDepthBits = 24; // Z-Buffer bits (mientras ms, mas precisa la comparacion (menos Z fighting).
+
+	// Una linda definicin del stencil buffer:
+	// Un buffer auxiliar, por pxel, que participa en pruebas (tests) durante el pipeline
+	// de rasterizacin para decidir si un fragmento se procesa o se descarta.
+	pfd.cStencilBits = 8;
+	pfd.iLayerType = PFD_MAIN_PLANE;
+
+	int pf = ChoosePixelFormat(g_hdc, &pfd);
+	if (pf == 0) return false;
+	if (!SetPixelFormat(g_hdc, pf, &pfd)) return false;
+
+	// 1) Create legacy context first (needed to load wglCreateContextAttribsARB)
+	HGLRC legacy = wglCreateContext(g_hdc);
+	if (!legacy) return false;
+
+	// Asocio el contexto OpenGL (HGLRC) con el Device Context (HDC) en el thread actual, haciendo que OpenGL quede activo.
+	if (!wglMakeCurrent(g_hdc, legacy))
+	{
+		wglDeleteContext(legacy);
+		return false;
+	}
+
+	// WGL extensions (from legacy context). Las funciones GL se cargan una sola vez, al final, con
+	// el contexto definitivo: cargarlas tambien aca era un recorrido entero de wglGetProcAddress.
+	wglCreateContextAttribsARB_ptr = (PFNWGLCREATECONTEXTATTRIBSARBPROC)wglGetProcAddress("wglCreateContextAttribsARB");
+
+	// 2) Try to create a modern core context (3.3)
+	if (wglCreateContextAttribsARB_ptr)
+	{
+		const int attribs[] = {
+			WGL_CONTEXT_MAJOR_VERSION_ARB, 3,
+			WGL_CONTEXT_MINOR_VERSION_ARB, 3,
+			WGL_CONTEXT_PROFILE_MASK_ARB,  WGL_CONTEXT_CORE_PROFILE_BIT_ARB,
+			0
+		};
+
+		HGLRC modern = wglCreateContextAttribsARB_ptr(g_hdc, 0, attribs);
+		if (modern)
+		{
+			wglMakeCurrent(nullptr, nullptr);
+			wglDeleteContext(legacy);
+
+			g_glrc = modern;
+			if (!wglMakeCurrent(g_hdc, g_glrc)) return false;
+		}
+		else
+		{
+			// Fallback: keep legacy
+			g_glrc = legacy;
+		}
+	}
+	else
+	{
+		// No attribs extension: keep legacy
+		g_glrc = legacy;
+	}
+
+	wglSwapIntervalEXT_ptr = (PFNWGLSWAPINTERVALEXTPROC)wglGetProcAddress("wglSwapIntervalEXT");
+
+	// Ensure GL funcs are loaded for the final current context
+	return LoadGLFunctions();
+}
+
+void PlatformDestroyGLContext()
+{
+	if (g_glrc)
+	{
+		wglMakeCurrent(nullptr, nullptr);
+		wglDeleteContext(g_glrc);
+		g_glrc = nullptr;
+	}
+
+	if (g_hdc)
+	{
+		ReleaseDC(g_hwnd, g_hdc);
+		g_hdc = nullptr;
+	}
+}
+
+// ---------------------------
+// Contextos compartidos
+// ---------------------------
+
+struct PlatformSharedContext
+{
+	HGLRC glrc = nullptr;
+};
+
+PlatformSharedContext* PlatformCreateSharedGLContext()
+{
+	if (!g_hdc || !g_glrc) return nullptr;
+
+	// Mismos atributos que el principal; sin la extension, wglShareLists sobre un contexto legacy
+	// (tiene que estar vacio: se llama antes de crear nada en el).
+	HGLRC glrc = nullptr;
+	if (wglCreateContextAttribsARB_ptr)
+	{
+		const int attribs[] = {
+			WGL_CONTEXT_MAJOR_VERSION_ARB, 3,
+			WGL_CONTEXT_MINOR_VERSION_ARB, 3,
+			WGL_CONTEXT_PROFILE_MASK_ARB,  WGL_CONTEXT_CORE_PROFILE_BIT_ARB,
+			0
+		};
+		glrc = wglCreateContextAttribsARB_ptr(g_hdc, g_glrc, attribs);
+	}
+	if (!glrc)
+	{
+		glrc = wglCreateContext(g_hdc);
+		if (glrc && !wglShareLists(g_glrc, glrc))
+		{
+			wglDeleteContext(glrc);
+			glrc = nullptr;
+		}
+	}
+	if (!glrc) return nullptr;
+
+	PlatformSharedContext* shared = new PlatformSharedContext();
+	shared->glrc = glrc;
+	return shared;
+}
+
+bool PlatformMakeSharedGLContextCurrent(PlatformSharedContext* shared)
+{
+	// El worker usa el mismo HDC (mismo pixel format); nunca dibuja en la ventana.
+	return shared ? wglMakeCurrent(g_hdc, shared->glrc) != FALSE : wglMakeCurrent(nullptr, nullptr) != FALSE;
+}
+
+void PlatformDestroySharedGLContext(PlatformSharedContext* shared)
+{
+	if (!shared) return;
+	wglDeleteContext(shared->glrc);
+	delete shared;
+}
+
+const char* PlatformBackendName()
+{
+	return "win32-wgl";
+}
+
+// Dame el nombre de una funcin OpenGL y te devuelvo un puntero ejecutable a esa funcin, si existe
+void* PlatformGetGLProc(const char* name)
+{
+	void* p = (void*)wglGetProcAddress(name);
+
+	// wglGetProcAddress puede devolver 1, 2, 3 o -1 como error en algunos drivers.
+	if (p && p != (void*)1 && p != (void*)2 && p != (void*)3 && p != (void*)-1) return p;
+
+	// Some core funcs can live in opengl32.dll (rare for modern ones, but fine to try)
+	HMODULE mod = GetModuleHandleW(L"opengl32.dll");
+	if (mod) return (void*)GetProcAddress(mod, name);
+
+	return nullptr;
+}
+
+
+// ---------------------------
+// Eventos, presentacion
+// ---------------------------
+
+bool PlatformPumpEvents()
+{
+	MSG msg{};
+	while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+	{
+		if (msg.message == WM_QUIT)
+			g_running = false;
+		TranslateMessage(&msg);
+		DispatchMessage(&msg);
+	}
+	return g_running;
+}
+
+void PlatformGetWindowSize(int* width, int* height)
+{
+	*width = g_width;
+	*height = g_height;
+}
+
+void PlatformSwapBuffers()
+{
+	SwapBuffers(g_hdc);
+}
+
+bool PlatformSetSwapInterval(int interval)
+{
+	return wglSwapIntervalEXT_ptr && wglSwapIntervalEXT_ptr(interval);
+}
+
+bool PlatformPresentPixels(const uint8_t* pixels, int width, int height)
+{
+	if (!g_hwnd) return false;
+	HDC hdc = GetDC(g_hwnd);
+	if (!hdc) return false;
+
+	// biHeight positivo = DIB bottom-up, igual que el buffer del renderer.
+	BITMAPINFO bmi{};
+	bmi.bmiHeader.biSize = sizeof(bmi.bmiHeader);
+	bmi.bmiHeader.biWidth = width;
+	bmi.bmiHeader.biHeight = height;
+	bmi.bmiHeader.biPlanes = 1;
+	bmi.bmiHeader.biBitCount = 32;
+	bmi.bmiHeader.biCompression = BI_RGB;
+	StretchDIBits(hdc, 0, 0, width, height, 0, 0, width, height, pixels, &bmi, DIB_RGB_COLORS, SRCCOPY);
+
+	ReleaseDC(g_hwnd, hdc);
+	return true;
+}
+
+
+// ---------------------------
+// Reloj
+// ---------------------------
+
+uint64_t PlatformTicks()
+{
+	LARGE_INTEGER now{};
+	QueryPerformanceCounter(&now); // reloj de alta precisin en Windows.
+	return (uint64_t)now.QuadPart;
+}
+
+uint64_t PlatformTickFrequency()
+{
+	static uint64_t freq = 0;
+	if (!freq)
+	{
+		LARGE_INTEGER f{};
+		QueryPerformanceFrequency(&f);
+		freq = (uint64_t)f.QuadPart;
+	}
+	return freq;
+}
+
+// Waitable timer de alta resolucion (Windows 10 1803+): despierta con ~0.5 ms de error sin tocar
+// la resolucion global del timer. En versiones anteriores cae a un timer comun + timeBeginPeriod(1).
+// Vive lo que vive el proceso.
+static HANDLE g_sleepTimer = nullptr;
+static bool   g_sleepTimerInit = false;
+
+void PlatformSleepUntil(uint64_t deadlineTicks)
+{
+	const uint64_t now = PlatformTicks();
+	if ((int64_t)(deadlineTicks - now) <= 0) return;
+
+	if (!g_sleepTimerInit)
+	{
+		g_sleepTimerInit = true;
+		g_sleepTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		if (!g_sleepTimer)
+		{
+			timeBeginPeriod(1);
+			g_sleepTimer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+		}
+	}
+
+	// Tiempo relativo en unidades de 100 ns (negativo = relativo).
+	const uint64_t remaining = deadlineTicks - now;
+	LARGE_INTEGER due{};
+	due.QuadPart = -(LONGLONG)(remaining * 10000000ull / PlatformTickFrequency());
+
+	if (g_sleepTimer && SetWaitableTimer(g_sleepTimer, &due, 0, nullptr, nullptr, FALSE))
+		WaitForSingleObject(g_sleepTimer, INFINITE);
+	else
+		Sleep((DWORD)(remaining * 1000ull / PlatformTickFrequency()));
+}
+
+
+// ---------------------------
+// Archivos
+// ---------------------------
+
+uint64_t PlatformFileModifiedTime(const char* path)
+{
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data)) return 0;
+	return ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+}
+
+bool PlatformCacheDirectory(char* out, size_t size)
+{
+	const char* localAppData = getenv("LOCALAPPDATA");
+	if (!localAppData || !localAppData[0]) return false;
+	if (snprintf(out, size, "%s\\BioMath", localAppData) >= (int)size) return false;
+	return CreateDirectoryA(out, nullptr) || GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+// ---------------------------
+// Audio (waveOut)
+// ---------------------------
+
+// waveOut con un ring de 'bufferBlocks' buffers y CALLBACK_EVENT: el driver senializa el evento
+// cada vez que termina un buffer. Write espera a que el proximo buffer del ring este libre.
+
+struct PlatformAudioDevice
+{
+	HWAVEOUT wave = nullptr;
+	HANDLE event = nullptr;
+	int blockFrames = 0;
+	int count = 0;
+	int next = 0;
+	int submitted = 0;
+	std::vector<WAVEHDR> headers;
+	std::vector<int16_t> samples; // count bloques intercalados, reservados al abrir
+};
+
+PlatformAudioDevice* PlatformAudioOpen(const PlatformAudioDesc& desc)
+{
+	WAVEFORMATEX format = {};
+	format.wFormatTag = WAVE_FORMAT_PCM;
+	format.nChannels = 2;
+	format.nSamplesPerSec = (DWORD)desc.sampleRate;
+	format.wBitsPerSample = 16;
+	format.nBlockAlign = 4;
+	format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+
+	HANDLE event = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+	if (!event) return nullptr;
+
+	HWAVEOUT wave = nullptr;
+	if (waveOutOpen(&wave, WAVE_MAPPER, &format, (ULONG_PTR)event, 0, CALLBACK_EVENT) != MMSYSERR_NOERROR)
+	{
+		CloseHandle(event);
+		return nullptr;
+	}
+
+	PlatformAudioDevice* device = new PlatformAudioDevice();
+	device->wave = wave;
+	device->event = event;
+	device->blockFrames = desc.blockFrames;
+	device->count = desc.bufferBlocks < 2 ? 2 : desc.bufferBlocks;
+	device->headers.resize((size_t)device->count);
+	device->samples.resize((size_t)device->count * (size_t)desc.blockFrames * 2);
+	for (int i = 0; i < device->count; ++i)
+	{
+		WAVEHDR& h = device->headers[(size_t)i];
+		h = WAVEHDR();
+		h.lpData = (LPSTR)(device->samples.data() + (size_t)i * (size_t)desc.blockFrames * 2);
+		h.dwBufferLength = (DWORD)(desc.blockFrames * 4);
+		waveOutPrepareHeader(wave, &h, sizeof(WAVEHDR));
+		h.dwFlags |= WHDR_DONE; // libre
+	}
+	return device;
+}
+
+PlatformAudioResult PlatformAudioWrite(PlatformAudioDevice* device, const float* left, const float* right, int frames)
+{
+	if (frames > device->blockFrames) frames = device->blockFrames;
+
+	// Si todos los buffers en cola ya terminaron, el dispositivo estuvo sonando silencio.
+	bool allDone = device->submitted >= device->count;
+	for (const WAVEHDR& h : device->headers)
+		if (!(h.dwFlags & WHDR_DONE)) allDone = false;
+
+	WAVEHDR& h = device->headers[(size_t)device->next];
+	while (!(h.dwFlags & WHDR_DONE))
+		WaitForSingleObject(device->event, 100);
+
+	int16_t* out = (int16_t*)h.lpData;
+	for (int i = 0; i < frames; ++i)
+	{
+		const float l = left[i] > 1.0f ? 1.0f : (left[i] < -1.0f ? -1.0f : left[i]);
+		const float r = right[i] > 1.0f ? 1.0f : (right[i] < -1.0f ? -1.0f : right[i]);
+		out[i * 2] = (int16_t)(l * 32767.0f);
+		out[i * 2 + 1] = (int16_t)(r * 32767.0f);
+	}
+	h.dwBufferLength = (DWORD)(frames * 4);
+	h.dwFlags &= ~WHDR_DONE;
+	if (waveOutWrite(device->wave, &h, sizeof(WAVEHDR)) != MMSYSERR_NOERROR)
+		return PlatformAudioResult::Error;
+
+	device->next = (device->next + 1) % device->count;
+	++device->submitted;
+	return allDone ? PlatformAudioResult::Underrun : PlatformAudioResult::Ok;
+}
+
+void PlatformAudioClose(PlatformAudioDevice* device)
+{
+	if (!device) return;
+	waveOutReset(device->wave); // devuelve todos los buffers pendientes
+	for (WAVEHDR& h : device->headers)
+		waveOutUnprepareHeader(device->wave, &h, sizeof(WAVEHDR));
+	waveOutClose(device->wave);
+	CloseHandle(device->event);
+	delete device;
+}
+
+const char* PlatformAudioBackendName()
+{
+	return "waveout";
+}
+
+bool PlatformSetAudioThreadPriority()
+{
+	return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+}
+
+// ---------------------------
+// Entrada (Raw Input + XInput)
+// ---------------------------
+
+// Un thread propio con una ventana message-only registrada para Raw Input (RIDEV_INPUTSINK: recibe
+// aunque no tenga el foco, el foco se mira contra la ventana principal). Asi el teclado y el mouse
+// no esperan a que el loop bombee la cola de mensajes: cada WM_INPUT se fecha cuando llega a este
+// thread. Los gamepads se leen con XInput por polling cada kInputPollMs; un pad desconectado se
+// vuelve a buscar cada kPadRetryMs porque XInputGetState sobre un slot vacio es caro.
+// XInput se carga en runtime (xinput1_4, o xinput9_1_0 en Windows 7), igual que waveOut no es
+// obligatorio: sin la DLL no hay gamepads.
+
+static const DWORD kInputPollMs = 4;
+static const DWORD kPadRetryMs = 1000;
+static const int kInputMaxPads = 4;
+static const wchar_t* kInputClassName = L"BioMathInput";
+
+typedef DWORD(WINAPI* PFNXINPUTGETSTATEPROC)(DWORD, XINPUT_STATE*);
+
+// Lo que el thread reporto como apretado, para cortar el autorepeat y soltar todo al perder el foco.
+struct InputHeld
+{
+	uint8_t keys[256] = {};
+	uint8_t mouse = 0;
+	uint16_t pads[kInputMaxPads] = {};
+};
+
+struct InputPad
+{
+	bool connected = false;
+	DWORD packet = 0;
+	WORD buttons = 0;
+	float axes[6] = {};
+	uint64_t retryTicks = 0;  // proximo intento si esta desconectado
+};
+
+struct InputPlatform
+{
+	PlatformInputCallback callback = nullptr;
+	void* ctx = nullptr;
+	std::thread thread;
+	std::atomic<bool> running{ false };
+	std::atomic<int> started{ 0 };    // 1 = ventana y Raw Input listos, -1 = fallo
+	bool focused = false;
+	InputHeld held;
+
+	HMODULE xinput = nullptr;
+	PFNXINPUTGETSTATEPROC getState = nullptr;
+	InputPad pads[kInputMaxPads];
+};
+
+static InputPlatform g_inputPlatform;
+
+static bool InputFocused()
+{
+	return g_hwnd && GetForegroundWindow() == g_hwnd;
+}
+
+// Sin foco no sale nada y las teclas ya apretadas no se repiten (Raw Input manda el autorepeat).
+static void InputEmit(const PlatformInputEvent& ev)
+{
+	InputPlatform& in = g_inputPlatform;
+	if (!in.focused) return;
+
+	InputHeld& h = in.held;
+	const int pad = ev.pad & (kInputMaxPads - 1);
+	switch (ev.type)
+	{
+	case PlatformInputType::KeyDown:
+		if (h.keys[ev.code & 0xFF]) return;
+		h.keys[ev.code & 0xFF] = 1;
+		break;
+	case PlatformInputType::KeyUp:
+		if (!h.keys[ev.code & 0xFF]) return;
+		h.keys[ev.code & 0xFF] = 0;
+		break;
+	case PlatformInputType::MouseButtonDown:
+		h.mouse |= (uint8_t)(1u << (ev.code & 7));
+		break;
+	case PlatformInputType::MouseButtonUp:
+		h.mouse &= (uint8_t)~(1u << (ev.code & 7));
+		break;
+	case PlatformInputType::GamepadButtonDown:
+		h.pads[pad] |= (uint16_t)(1u << (ev.code & 15));
+		break;
+	case PlatformInputType::GamepadButtonUp:
+		h.pads[pad] &= (uint16_t)~(1u << (ev.code & 15));
+		break;
+	default:
+		break;
+	}
+	in.callback(in.ctx, ev);
+}
+
+// Al perder el foco los "up" no van a llegar: se mandan ahora.
+static void InputReleaseHeld(uint64_t ticks)
+{
+	InputPlatform& in = g_inputPlatform;
+	InputHeld& h = in.held;
+	PlatformInputEvent ev;
+	ev.ticks = ticks;
+	for (int k = 0; k < 256; ++k)
+	{
+		if (!h.keys[k]) continue;
+		ev.type = PlatformInputType::KeyUp;
+		ev.code = (uint16_t)k;
+		in.callback(in.ctx, ev);
+	}
+	for (int b = 0; b < 8; ++b)
+	{
+		if (!(h.mouse & (1u << b))) continue;
+		ev.type = PlatformInputType::MouseButtonUp;
+		ev.code = (uint16_t)b;
+		in.callback(in.ctx, ev);
+	}
+	for (int p = 0; p < kInputMaxPads; ++p)
+	{
+		for (int b = 0; b < 16; ++b)
+		{
+			if (!(h.pads[p] & (1u << b))) continue;
+			ev.type = PlatformInputType::GamepadButtonUp;
+			ev.pad = (uint8_t)p;
+			ev.code = (uint16_t)b;
+			in.callback(in.ctx, ev);
+		}
+	}
+	h = InputHeld();
+}
+
+static void HandleRawInput(HRAWINPUT handle)
+{
+	// RAWINPUT de teclado o mouse entra siempre en este buffer (los HID genericos no se registran).
+	alignas(8) BYTE buffer[sizeof(RAWINPUT) + 64];
+	UINT size = sizeof(buffer);
+	if (GetRawInputData(handle, RID_INPUT, buffer, &size, sizeof(RAWINPUTHEADER)) == (UINT)-1) return;
+	const RAWINPUT& raw = *(const RAWINPUT*)buffer;
+
+	PlatformInputEvent ev;
+	ev.ticks = PlatformTicks();
+
+	if (raw.header.dwType == RIM_TYPEKEYBOARD)
+	{
+		const RAWKEYBOARD& kb = raw.data.keyboard;
+		if (kb.VKey == 0 || kb.VKey >= 255) return; // 255: parte de una secuencia escapada
+		ev.type = (kb.Flags & RI_KEY_BREAK) ? PlatformInputType::KeyUp : PlatformInputType::KeyDown;
+		ev.code = kb.VKey;
+		InputEmit(ev);
+		return;
+	}
+
+	if (raw.header.dwType != RIM_TYPEMOUSE) return;
+	const RAWMOUSE& mouse = raw.data.mouse;
+
+	if (!(mouse.usFlags & MOUSE_MOVE_ABSOLUTE) && (mouse.lLastX || mouse.lLastY))
+	{
+		ev.type = PlatformInputType::MouseMove;
+		ev.x = mouse.lLastX;
+		ev.y = mouse.lLastY;
+		InputEmit(ev);
+	}
+
+	// RI_MOUSE_BUTTON_n_DOWN/UP son pares de bits consecutivos, en el orden de PlatformInputType.
+	const USHORT flags = mouse.usButtonFlags;
+	ev.x = ev.y = 0;
+	for (int b = 0; b < 5; ++b)
+	{
+		ev.code = (uint16_t)b;
+		if (flags & (1u << (b * 2)))
+		{
+			ev.type = PlatformInputType::MouseButtonDown;
+			InputEmit(ev);
+		}
+		if (flags & (1u << (b * 2 + 1)))
+		{
+			ev.type = PlatformInputType::MouseButtonUp;
+			InputEmit(ev);
+		}
+	}
+	if (flags & RI_MOUSE_WHEEL)
+	{
+		ev.type = PlatformInputType::MouseWheel;
+		ev.code = 0;
+		ev.value = (float)(SHORT)mouse.usButtonData / (float)WHEEL_DELTA;
+		InputEmit(ev);
+	}
+}
+
+static LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	if (msg == WM_INPUT)
+		HandleRawInput((HRAWINPUT)lParam);
+	return DefWindowProc(hWnd, msg, wParam, lParam); // WM_INPUT tambien: libera el buffer del sistema
+}
+
+static float PadStick(SHORT v)
+{
+	const float f = (float)v / 32767.0f;
+	return f < -1.0f ? -1.0f : f;
+}
+
+static void PollPads(uint64_t now)
+{
+	InputPlatform& in = g_inputPlatform;
+	if (!in.getState) return;
+
+	for (int p = 0; p < kInputMaxPads; ++p)
+	{
+		InputPad& pad = in.pads[p];
+		if (!pad.connected && now < pad.retryTicks) continue;
+
+		XINPUT_STATE state{};
+		const bool connected = in.getState((DWORD)p, &state) == ERROR_SUCCESS;
+
+		PlatformInputEvent ev;
+		ev.ticks = now;
+		ev.pad = (uint8_t)p;
+		if (connected != pad.connected)
+		{
+			// Conexion y desconexion pasan aunque no haya foco: son estado, no entrada del usuario.
+			// Al desconectar, input.cpp suelta los botones del pad por su cuenta.
+			in.held.pads[p] = 0;
+			ev.type = connected ? PlatformInputType::GamepadConnected : PlatformInputType::GamepadDisconnected;
+			in.callback(in.ctx, ev);
+			pad = InputPad();
+			pad.connected = connected;
+		}
+		if (!connected)
+		{
+			pad.retryTicks = now + (uint64_t)kPadRetryMs * PlatformTickFrequency() / 1000ull;
+			continue;
+		}
+		if (state.dwPacketNumber == pad.packet) continue;
+		pad.packet = state.dwPacketNumber;
+
+		const XINPUT_GAMEPAD& g = state.Gamepad;
+		const WORD changed = (WORD)(g.wButtons ^ pad.buttons);
+		for (int b = 0; b < 16; ++b)
+		{
+			if (!(changed & (1u << b))) continue;
+			ev.type = (g.wButtons & (1u << b)) ? PlatformInputType::GamepadButtonDown : PlatformInputType::GamepadButtonUp;
+			ev.code = (uint16_t)b;
+			InputEmit(ev);
+		}
+		pad.buttons = g.wButtons;
+
+		const float axes[6] = {
+			PadStick(g.sThumbLX), PadStick(g.sThumbLY), PadStick(g.sThumbRX), PadStick(g.sThumbRY),
+			(float)g.bLeftTrigger / 255.0f, (float)g.bRightTrigger / 255.0f,
+		};
+		for (int a = 0; a < 6; ++a)
+		{
+			if (axes[a] == pad.axes[a]) continue;
+			pad.axes[a] = axes[a];
+			ev.type = PlatformInputType::GamepadAxis;
+			ev.code = (uint16_t)a;
+			ev.value = axes[a];
+			InputEmit(ev);
+		}
+	}
+}
+
+static void InputThreadMain()
+{
+	InputPlatform& in = g_inputPlatform;
+	HINSTANCE hInstance = GetModuleHandleW(nullptr);
+
+	WNDCLASSW wc{};
+	wc.lpfnWndProc = InputWndProc;
+	wc.hInstance = hInstance;
+	wc.lpszClassName = kInputClassName;
+	RegisterClassW(&wc);
+
+	HWND hwnd = CreateWindowExW(0, kInputClassName, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, hInstance, nullptr);
+
+	RAWINPUTDEVICE devices[2] = {};
+	devices[0].usUsagePage = 0x01; // generic desktop
+	devices[0].usUsage = 0x06;     // teclado
+	devices[0].dwFlags = RIDEV_INPUTSINK;
+	devices[0].hwndTarget = hwnd;
+	devices[1] = devices[0];
+	devices[1].usUsage = 0x02;     // mouse
+
+	if (!hwnd || !RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE)))
+	{
+		if (hwnd) DestroyWindow(hwnd);
+		UnregisterClassW(kInputClassName, hInstance);
+		in.started.store(-1, std::memory_order_release);
+		return;
+	}
+	in.started.store(1, std::memory_order_release);
+
+	while (in.running.load(std::memory_order_acquire))
+	{
+		// Despierta con cada WM_INPUT o cada kInputPollMs para los gamepads y el foco.
+		MsgWaitForMultipleObjects(0, nullptr, FALSE, kInputPollMs, QS_RAWINPUT | QS_POSTMESSAGE);
+
+		const bool focused = InputFocused();
+		if (in.focused && !focused) InputReleaseHeld(PlatformTicks());
+		in.focused = focused;
+
+		MSG msg{};
+		while (PeekMessageW(&msg, hwnd, 0, 0, PM_REMOVE))
+			DispatchMessageW(&msg);
+
+		PollPads(PlatformTicks());
+	}
+
+	devices[0].dwFlags = devices[1].dwFlags = RIDEV_REMOVE;
+	devices[0].hwndTarget = devices[1].hwndTarget = nullptr;
+	RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE));
+	DestroyWindow(hwnd);
+	UnregisterClassW(kInputClassName, hInstance);
+}
+
+bool PlatformInputStart(PlatformInputCallback callback, void* ctx)
+{
+	InputPlatform& in = g_inputPlatform;
+	if (!g_hwnd || in.running.load()) return false;
+
+	in.callback = callback;
+	in.ctx = ctx;
+	in.held = InputHeld();
+	in.focused = false;
+	for (InputPad& pad : in.pads) pad = InputPad();
+
+	in.xinput = LoadLibraryW(L"xinput1_4.dll");
+	if (!in.xinput) in.xinput = LoadLibraryW(L"xinput9_1_0.dll");
+	in.getState = in.xinput ? (PFNXINPUTGETSTATEPROC)GetProcAddress(in.xinput, "XInputGetState") : nullptr;
+
+	in.started.store(0, std::memory_order_relaxed);
+	in.running.store(true, std::memory_order_release);
+	in.thread = std::thread(InputThreadMain);
+	while (in.started.load(std::memory_order_acquire) == 0)
+		Sleep(0);
+
+	if (in.started.load(std::memory_order_acquire) < 0)
+	{
+		in.running.store(false, std::memory_order_release);
+		in.thread.join();
+		PlatformInputStop();
+		return false;
+	}
+	return true;
+}
+
+void PlatformInputStop()
+{
+	InputPlatform& in = g_inputPlatform;
+	if (in.thread.joinable())
+	{
+		in.running.store(false, std::memory_order_release);
+		in.thread.join();
+	}
+	if (in.xinput) FreeLibrary(in.xinput);
+	in.xinput = nullptr;
+	in.getState = nullptr;
+	in.callback = nullptr;
+}
+
+const char* PlatformInputBackendName()
+{
+	const InputPlatform& in = g_inputPlatform;
+	if (!in.running.load()) return "none";
+	return in.getState ? "rawinput+xinput" : "rawinput";
+}
+
+// ---------------------------
+// Consola, errores
+// ---------------------------
+
+void PlatformShowError(const char* title, const char* text)
+{
+	MessageBoxA(nullptr, text, title, MB_ICONERROR | MB_OK);
+}
+
+void PlatformAttachConsole()
+{
+	// Somos una app de subsistema Windows: si nos lanzaron desde una consola, escribimos ahi.
+	if (AttachConsole(ATTACH_PARENT_PROCESS))
+	{
+		freopen("CONOUT$", "w", stdout);
+		freopen("CONOUT$", "w", stderr);
+	}
+}
@@ -0,0 +1,303 @@
+#include "profiler.h"
+#include "gl_api.h"
+#include "platform.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static const uint32_t kRingSize = 1u << 15; // eventos por thread (potencia de 2), ~1 MB
+static const int kMaxThreads = 64;
+
+struct ProfEvent
+{
+	const char* name;
+	uint64_t begin;
+	uint64_t end;
+};
+
+// Ring de un solo productor: solo el thread duenio escribe; el export lee con 'head' (acquire).
+struct ProfRing
+{
+	std::atomic<uint64_t> head{ 0 };
+	uint32_t tid = 0;
+	char name[32] = {};
+	ProfEvent events[kRingSize];
+};
+
+static std::atomic<bool> g_enabled{ false };
+static std::mutex g_registryMutex;
+static ProfRing* g_rings[kMaxThreads] = {};
+static std::atomic<int> g_ringCount{ 0 };
+
+static thread_local ProfRing* t_ring = nullptr;
+
+static ProfRing* RegisterRing(const char* name)
+{
+	std::lock_guard<std::mutex> lock(g_registryMutex);
+	const int index = g_ringCount.load(std::memory_order_relaxed);
+	if (index >= kMaxThreads) return nullptr;
+
+	// Los rings viven hasta el final del proceso: el export puede leerlos en cualquier momento.
+	ProfRing* ring = new ProfRing();
+	ring->tid = (uint32_t)index + 1;
+	if (name) snprintf(ring->name, sizeof(ring->name), "%s", name);
+	else snprintf(ring->name, sizeof(ring->name), "thread %d", index + 1);
+
+	g_rings[index] = ring;
+	g_ringCount.store(index + 1, std::memory_order_release);
+	return ring;
+}
+
+static void PushEvent(ProfRing* ring, const char* name, uint64_t begin, uint64_t end)
+{
+	const uint64_t h = ring->head.load(std::memory_order_relaxed);
+	ProfEvent& e = ring->events[h & (kRingSize - 1)];
+	e.name = name;
+	e.begin = begin;
+	e.end = end;
+	ring->head.store(h + 1, std::memory_order_release);
+}
+
+void ProfilerSetEnabled(bool enabled)
+{
+	g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool ProfilerEnabled()
+{
+	return g_enabled.load(std::memory_order_relaxed);
+}
+
+void ProfilerSetThreadName(const char* name)
+{
+	if (!t_ring) t_ring = RegisterRing(name);
+	else snprintf(t_ring->name, sizeof(t_ring->name), "%s", name);
+}
+
+uint64_t ProfilerZoneBegin()
+{
+	return PlatformTicks();
+}
+
+void ProfilerZoneEnd(const char* name, uint64_t beginTicks)
+{
+	const uint64_t end = PlatformTicks();
+	if (!t_ring) t_ring = RegisterRing(nullptr);
+	if (t_ring) PushEvent(t_ring, name, beginTicks, end);
+}
+
+
+// ---------------------------
+// GPU
+// ---------------------------
+
+struct GpuFrame
+{
+	int zoneCount = 0;
+	const char* names[kProfilerGpuZonesPerFrame] = {};
+};
+
+struct GpuProfiler
+{
+	bool active = false;
+	GLuint queries[kProfilerGpuFrames][kProfilerGpuZonesPerFrame * 2] = {};
+	GpuFrame frames[kProfilerGpuFrames];
+	int current = 0;          // slot del frame que se esta grabando
+	uint64_t frameCount = 0;
+	uint64_t dropped = 0;     // frames cuyos resultados no estaban listos al reciclar el slot
+
+	// Calibracion: un timestamp de GPU y el tick de CPU del mismo instante.
+	GLint64 calibGpuNs = 0;
+	uint64_t calibCpuTicks = 0;
+
+	ProfRing* ring = nullptr; // track "GPU" en el trace (lo escribe el thread de render)
+};
+
+static GpuProfiler g_gpu;
+
+static uint64_t GpuToCpuTicks(GLuint64 gpuNs)
+{
+	const double ns = (double)((GLint64)gpuNs - g_gpu.calibGpuNs);
+	return g_gpu.calibCpuTicks + (uint64_t)(int64_t)(ns * 1e-9 * (double)PlatformTickFrequency());
+}
+
+static void Calibrate()
+{
+	// glGetInteger64v(GL_TIMESTAMP) devuelve el reloj de la GPU sin esperar al pipeline.
+	glFinish();
+	g_gpu.calibCpuTicks = PlatformTicks();
+	glGetInteger64v_ptr(GL_TIMESTAMP, &g_gpu.calibGpuNs);
+}
+
+void ProfilerGpuInit()
+{
+	if (g_gpu.active || !ProfilerEnabled()) return;
+	if (!glGenQueries_ptr || !glQueryCounter_ptr || !glGetQueryObjectui64v_ptr || !glGetInteger64v_ptr)
+		return;
+
+	for (int f = 0; f < kProfilerGpuFrames; ++f)
+	{
+		glGenQueries_ptr(kProfilerGpuZonesPerFrame * 2, g_gpu.queries[f]);
+		g_gpu.frames[f].zoneCount = 0;
+	}
+	if (!g_gpu.ring) g_gpu.ring = RegisterRing("GPU");
+	Calibrate();
+
+	g_gpu.current = 0;
+	g_gpu.frameCount = 0;
+	g_gpu.active = g_gpu.ring != nullptr;
+}
+
+// Lee los resultados de un slot. Con wait=false, si la GPU todavia no termino el frame se descarta.
+static void ResolveGpuFrame(int slot, bool wait)
+{
+	GpuFrame& frame = g_gpu.frames[slot];
+	if (frame.zoneCount == 0) return;
+
+	// Las queries terminan en orden: si la ultima esta lista, estan todas.
+	GLuint* q = g_gpu.queries[slot];
+	if (!wait)
+	{
+		GLint available = 0;
+		glGetQueryObjectiv_ptr(q[frame.zoneCount * 2 - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+		{
+			++g_gpu.dropped;
+			frame.zoneCount = 0;
+			return;
+		}
+	}
+
+	for (int z = 0; z < frame.zoneCount; ++z)
+	{
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v_ptr(q[z * 2], GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v_ptr(q[z * 2 + 1], GL_QUERY_RESULT, &end);
+		PushEvent(g_gpu.ring, frame.names[z], GpuToCpuTicks(begin), GpuToCpuTicks(end));
+	}
+	frame.zoneCount = 0;
+}
+
+void ProfilerGpuBeginFrame()
+{
+	if (!g_gpu.active) return;
+
+	++g_gpu.frameCount;
+	g_gpu.current = (int)(g_gpu.frameCount % kProfilerGpuFrames);
+	ResolveGpuFrame(g_gpu.current, false); // grabado hace kProfilerGpuFrames frames
+}
+
+int ProfilerGpuZoneBegin(const char* name)
+{
+	if (!g_gpu.active) return -1;
+	GpuFrame& frame = g_gpu.frames[g_gpu.current];
+	if (frame.zoneCount >= kProfilerGpuZonesPerFrame) return -1;
+
+	const int zone = frame.zoneCount++;
+	frame.names[zone] = name;
+	glQueryCounter_ptr(g_gpu.queries[g_gpu.current][zone * 2], GL_TIMESTAMP);
+	return zone;
+}
+
+void ProfilerGpuZoneEnd(int zone)
+{
+	if (!g_gpu.active) return;
+	glQueryCounter_ptr(g_gpu.queries[g_gpu.current][zone * 2 + 1], GL_TIMESTAMP);
+}
+
+void ProfilerGpuShutdown()
+{
+	if (!g_gpu.active) return;
+
+	// Al cerrar si se espera: son los ultimos frames y el contexto se va.
+	for (int i = 1; i <= kProfilerGpuFrames; ++i)
+		ResolveGpuFrame((g_gpu.current + i) % kProfilerGpuFrames, true);
+
+	for (int f = 0; f < kProfilerGpuFrames; ++f)
+		glDeleteQueries_ptr(kProfilerGpuZonesPerFrame * 2, g_gpu.queries[f]);
+	g_gpu.active = false;
+}
+
+
+// ---------------------------
+// Export
+// ---------------------------
+
+static void WriteJsonName(FILE* f, const char* s)
+{
+	fputc('"', f);
+	for (; s && *s; ++s)
+	{
+		if (*s == '"' || *s == '\\') fputc('\\', f);
+		if ((unsigned char)*s >= 0x20) fputc(*s, f);
+	}
+	fputc('"', f);
+}
+
+bool ProfilerWriteChromeTrace(const char* path)
+{
+	FILE* f = fopen(path, "w");
+	if (!f) return false;
+
+	const int ringCount = g_ringCount.load(std::memory_order_acquire);
+	const double ticksToUs = 1e6 / (double)PlatformTickFrequency();
+
+	// Origen del trace: el evento mas viejo que sobrevive en cualquier ring.
+	std::vector<ProfEvent> events;
+	std::vector<uint32_t> eventTids;
+	uint64_t origin = UINT64_MAX;
+
+	for (int r = 0; r < ringCount; ++r)
+	{
+		ProfRing* ring = g_rings[r];
+		const uint64_t head = ring->head.load(std::memory_order_acquire);
+		const uint64_t first = head > kRingSize ? head - kRingSize : 0;
+
+		const size_t base = events.size();
+		for (uint64_t i = first; i < head; ++i)
+			events.push_back(ring->events[i & (kRingSize - 1)]);
+
+		// Lo que el productor piso mientras copiabamos no es confiable: se descarta. El evento en
+		// curso (indice headAfter, todavia sin publicar) ya esta pisando su slot.
+		const uint64_t headAfter = ring->head.load(std::memory_order_acquire) + 1;
+		const uint64_t firstValid = headAfter > kRingSize ? headAfter - kRingSize : 0;
+		const size_t copied = events.size() - base;
+		size_t skip = firstValid > first ? (size_t)(firstValid - first) : 0;
+		if (skip > copied) skip = copied;
+		events.erase(events.begin() + (ptrdiff_t)base, events.begin() + (ptrdiff_t)(base + skip));
+
+		eventTids.resize(events.size(), ring->tid);
+		for (size_t i = base; i < events.size(); ++i)
+			if (events[i].begin < origin) origin = events[i].begin;
+	}
+	if (origin == UINT64_MAX) origin = 0;
+
+	fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first = true;
+	for (int r = 0; r < ringCount; ++r)
+	{
+		fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", g_rings[r]->tid);
+		WriteJsonName(f, g_rings[r]->name);
+		fprintf(f, "}}");
+		first = false;
+	}
+	for (size_t i = 0; i < events.size(); ++i)
+	{
+		const ProfEvent& e = events[i];
+		const double ts = (double)(int64_t)(e.begin - origin) * ticksToUs;
+		const double dur = e.end > e.begin ? (double)(e.end - e.begin) * ticksToUs : 0.0;
+		fprintf(f, "%s{\"name\":", first ? "" : ",\n");
+		WriteJsonName(f, e.name);
+		fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", eventTids[i], ts, dur);
+		first = false;
+	}
+	fprintf(f, "\n],\"otherData\":{\"platform\":");
+	WriteJsonName(f, PlatformBackendName());
+	fprintf(f, ",\"gpu_frames_dropped\":%llu}}\n", (unsigned long long)g_gpu.dropped);
+
+	fclose(f);
+	return true;
+}
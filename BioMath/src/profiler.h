@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+
+// ---------------------------
+// Profiler (zonas CPU y GPU)
+// ---------------------------
+
+// Zonas con scope que se exportan como Chrome trace (chrome://tracing, Perfetto):
+//
+//   { PROFILE_ZONE("SwapBuffers"); PlatformSwapBuffers(); }
+//   { PROFILE_GPU_ZONE("DrawArrays"); GLStateDrawArrays(...); }   // CPU + GPU
+//
+// CPU: cada thread escribe en su propio ring buffer (un solo productor, sin locks). El unico
+// lock es el registro del thread, la primera vez que graba. El export puede correr mientras se
+// graba: lo que se sobrescribio durante la copia se descarta.
+//
+// GPU: pares de queries GL_TIMESTAMP por zona, en un pool de kProfilerGpuFrames frames. Los
+// resultados se leen cuando el slot del frame se vuelve a usar, varios frames despues, asi que
+// nunca se espera a la GPU. Se pasan a la linea de tiempo de CPU con una calibracion inicial.
+//
+// Apagado (default) cada zona cuesta un branch. BIOMATH_PROFILER=0 las saca en compilacion.
+
+#ifndef BIOMATH_PROFILER
+	#define BIOMATH_PROFILER 1
+#endif
+
+static const int kProfilerGpuFrames = 4;         // frames de queries en vuelo
+static const int kProfilerGpuZonesPerFrame = 32;
+
+void ProfilerSetEnabled(bool enabled);
+bool ProfilerEnabled();
+
+// Nombre del thread actual en el trace (por defecto "thread N").
+void ProfilerSetThreadName(const char* name);
+
+// Zonas CPU. 'name' tiene que vivir todo el programa (literal).
+uint64_t ProfilerZoneBegin();
+void ProfilerZoneEnd(const char* name, uint64_t beginTicks);
+
+// Zonas GPU (requieren contexto GL actual; solo desde el thread de render).
+// ProfilerGpuInit despues de crear el contexto, ProfilerGpuShutdown antes de destruirlo.
+void ProfilerGpuInit();
+void ProfilerGpuShutdown();
+void ProfilerGpuBeginFrame(); // al inicio de cada frame: recicla el slot mas viejo y lee sus resultados
+int  ProfilerGpuZoneBegin(const char* name);
+void ProfilerGpuZoneEnd(int zone);
+
+// Escribe todo lo grabado como Chrome trace JSON. Se puede llamar en cualquier momento.
+bool ProfilerWriteChromeTrace(const char* path);
+
+struct ProfilerZoneScope
+{
+	const char* name;
+	uint64_t begin;
+
+	explicit ProfilerZoneScope(const char* n) : name(n), begin(ProfilerEnabled() ? ProfilerZoneBegin() : 0) {}
+	~ProfilerZoneScope() { if (begin) ProfilerZoneEnd(name, begin); }
+};
+
+struct ProfilerGpuZoneScope
+{
+	ProfilerZoneScope cpu;
+	int zone;
+
+	explicit ProfilerGpuZoneScope(const char* n) : cpu(n), zone(ProfilerEnabled() ? ProfilerGpuZoneBegin(n) : -1) {}
+	~ProfilerGpuZoneScope() { if (zone >= 0) ProfilerGpuZoneEnd(zone); }
+};
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+
+#if BIOMATH_PROFILER
+	#define PROFILE_ZONE(name)     ProfilerZoneScope PROFILER_CONCAT(profZone_, __LINE__)(name)
+	#define PROFILE_GPU_ZONE(name) ProfilerGpuZoneScope PROFILER_CONCAT(profGpuZone_, __LINE__)(name)
+#else
+	#define PROFILE_ZONE(name)     ((void)0)
+	#define PROFILE_GPU_ZONE(name) ((void)0)
+#endif
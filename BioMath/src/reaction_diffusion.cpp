@@ -0,0 +1,226 @@
+#include "reaction_diffusion.h"
+#include "cpu_renderer_internal.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <emmintrin.h>
+#include <string.h>
+
+// ---------------------------
+// Kernel escalar (referencia)
+// ---------------------------
+
+// Una celda. El orden de las operaciones es el contrato con los kernels SIMD: cambiarlo aca
+// obliga a cambiarlo en los tres.
+static inline void Cell(const RdConstants& k,
+	float uN, float uS, float uW, float uE, float uC,
+	float vN, float vS, float vW, float vE, float vC,
+	float* uOut, float* vOut)
+{
+	const float lapU = ((uN + uS) + (uW + uE)) - uC * 4.0f;
+	const float lapV = ((vN + vS) + (vW + vE)) - vC * 4.0f;
+	const float uvv = (uC * vC) * vC;
+	*uOut = uC + k.dt * ((k.du * lapU - uvv) + k.feed * (1.0f - uC));
+	*vOut = vC + k.dt * ((k.dv * lapV + uvv) - k.feedKill * vC);
+}
+
+void RdStepSpanScalar(const RdConstants& k, const RdRows& r, int x0, int x1)
+{
+	for (int x = x0; x < x1; ++x)
+	{
+		Cell(k, r.uUp[x], r.uDown[x], r.uMid[x - 1], r.uMid[x + 1], r.uMid[x],
+			r.vUp[x], r.vDown[x], r.vMid[x - 1], r.vMid[x + 1], r.vMid[x],
+			r.uOut + x, r.vOut + x);
+	}
+}
+
+// Columna 'x' con los vecinos envueltos (solo las columnas 0 y width - 1).
+static inline void EdgeCell(const RdConstants& k, const RdRows& r, int x, int width)
+{
+	const int w = x == 0 ? width - 1 : x - 1;
+	const int e = x == width - 1 ? 0 : x + 1;
+	Cell(k, r.uUp[x], r.uDown[x], r.uMid[w], r.uMid[e], r.uMid[x],
+		r.vUp[x], r.vDown[x], r.vMid[w], r.vMid[e], r.vMid[x],
+		r.uOut + x, r.vOut + x);
+}
+
+// ---------------------------
+// Kernel SSE2
+// ---------------------------
+
+void RdStepSpanSSE2(const RdConstants& k, const RdRows& r, int x0, int x1)
+{
+	const __m128 du = _mm_set1_ps(k.du);
+	const __m128 dv = _mm_set1_ps(k.dv);
+	const __m128 feed = _mm_set1_ps(k.feed);
+	const __m128 feedKill = _mm_set1_ps(k.feedKill);
+	const __m128 dt = _mm_set1_ps(k.dt);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 four = _mm_set1_ps(4.0f);
+
+	int x = x0;
+	for (; x + 4 <= x1; x += 4)
+	{
+		const __m128 uC = _mm_loadu_ps(r.uMid + x);
+		const __m128 vC = _mm_loadu_ps(r.vMid + x);
+		const __m128 uNS = _mm_add_ps(_mm_loadu_ps(r.uUp + x), _mm_loadu_ps(r.uDown + x));
+		const __m128 uWE = _mm_add_ps(_mm_loadu_ps(r.uMid + x - 1), _mm_loadu_ps(r.uMid + x + 1));
+		const __m128 vNS = _mm_add_ps(_mm_loadu_ps(r.vUp + x), _mm_loadu_ps(r.vDown + x));
+		const __m128 vWE = _mm_add_ps(_mm_loadu_ps(r.vMid + x - 1), _mm_loadu_ps(r.vMid + x + 1));
+		const __m128 lapU = _mm_sub_ps(_mm_add_ps(uNS, uWE), _mm_mul_ps(uC, four));
+		const __m128 lapV = _mm_sub_ps(_mm_add_ps(vNS, vWE), _mm_mul_ps(vC, four));
+		const __m128 uvv = _mm_mul_ps(_mm_mul_ps(uC, vC), vC);
+
+		const __m128 ru = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(du, lapU), uvv), _mm_mul_ps(feed, _mm_sub_ps(one, uC)));
+		const __m128 rv = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(dv, lapV), uvv), _mm_mul_ps(feedKill, vC));
+		_mm_storeu_ps(r.uOut + x, _mm_add_ps(uC, _mm_mul_ps(dt, ru)));
+		_mm_storeu_ps(r.vOut + x, _mm_add_ps(vC, _mm_mul_ps(dt, rv)));
+	}
+	RdStepSpanScalar(k, r, x, x1);
+}
+
+// ---------------------------
+// Dispatch
+// ---------------------------
+
+int RdPresetFind(const char* name)
+{
+	for (int i = 0; i < kRdPresetCount; ++i)
+		if (strcmp(kRdPresets[i].name, name) == 0) return i;
+	return -1;
+}
+
+bool RdGridInit(RdGrid* grid, int width, int height)
+{
+	if (width < kRdMinSize || height < kRdMinSize || (width & 15) != 0) return false;
+
+	const size_t cells = (size_t)width * (size_t)height;
+	grid->width = width;
+	grid->height = height;
+	grid->u.assign(cells, 1.0f);
+	grid->v.assign(cells, 0.0f);
+	grid->nextU.assign(cells, 0.0f);
+	grid->nextV.assign(cells, 0.0f);
+	return true;
+}
+
+void RdGridSeed(RdGrid* grid, uint32_t seed)
+{
+	const int width = grid->width, height = grid->height;
+	std::fill(grid->u.begin(), grid->u.end(), 1.0f);
+	std::fill(grid->v.begin(), grid->v.end(), 0.0f);
+
+	// Un parche cada ~128x128 celdas, de lado 1/128 de la grilla (16 celdas a 2048).
+	const int side = std::max(std::min(width, height) / 128, 4);
+	const int patches = (int)((size_t)width * (size_t)height / (128 * 128)) + 8;
+
+	uint32_t rng = seed ? seed : 0x9E3779B9u;
+	auto next = [&]() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; };
+	for (int p = 0; p < patches; ++p)
+	{
+		const int px = (int)(next() % (uint32_t)width);
+		const int py = (int)(next() % (uint32_t)height);
+		for (int dy = 0; dy < side; ++dy)
+		{
+			const size_t row = (size_t)((py + dy) % height) * (size_t)width;
+			for (int dx = 0; dx < side; ++dx)
+			{
+				const size_t i = row + (size_t)((px + dx) % width);
+				grid->u[i] = 0.5f;
+				grid->v[i] = 0.25f;
+			}
+		}
+	}
+}
+
+void RdStep(RdGrid* grid, const RdParams& params, int steps, CpuShadePath path)
+{
+	const int width = grid->width, height = grid->height;
+	if (width <= 0 || height <= 0) return;
+
+	path = CpuResolveShadePath(path);
+	RdStepSpanFn span = RdStepSpanScalar;
+	if (path == CpuShadePath::SSE2) span = RdStepSpanSSE2;
+	if (path == CpuShadePath::AVX2) span = RdStepSpanAVX2;
+
+	const RdConstants k = { params.du, params.dv, params.feed, params.feed + params.kill, params.dt };
+
+	for (int s = 0; s < steps; ++s)
+	{
+		const float* u = grid->u.data();
+		const float* v = grid->v.data();
+		float* uOut = grid->nextU.data();
+		float* vOut = grid->nextV.data();
+
+		ParallelFor(height, kRdBandRows, [&](int y0, int y1)
+		{
+			for (int bx = 0; bx < width; bx += kRdBlockColumns)
+			{
+				const int bx1 = bx + kRdBlockColumns < width ? bx + kRdBlockColumns : width;
+				const int x0 = bx == 0 ? 1 : bx;
+				const int x1 = bx1 == width ? width - 1 : bx1;
+
+				for (int y = y0; y < y1; ++y)
+				{
+					const size_t up = (size_t)(y == 0 ? height - 1 : y - 1) * (size_t)width;
+					const size_t mid = (size_t)y * (size_t)width;
+					const size_t down = (size_t)(y == height - 1 ? 0 : y + 1) * (size_t)width;
+					const RdRows rows = { u + up, u + mid, u + down, v + up, v + mid, v + down, uOut + mid, vOut + mid };
+
+					span(k, rows, x0, x1);
+					if (bx == 0) EdgeCell(k, rows, 0, width);
+					if (bx1 == width) EdgeCell(k, rows, width - 1, width);
+				}
+			}
+		});
+
+		std::swap(grid->u, grid->nextU);
+		std::swap(grid->v, grid->nextV);
+	}
+}
+
+static inline uint8_t Quantize(float v)
+{
+	float q = v * kRdQuantizeScale;
+	q = q < 0.0f ? 0.0f : q;
+	q = q > 255.0f ? 255.0f : q;
+	return (uint8_t)(int)(q + 0.5f);
+}
+
+void RdQuantize(const RdGrid& grid, uint8_t* dst, CpuShadePath path)
+{
+	const int width = grid.width;
+	const bool sse = CpuResolveShadePath(path) != CpuShadePath::Scalar;
+	const float* v = grid.v.data();
+
+	// Una sola variante SIMD: es ancho de banda puro, AVX2 no cambia nada.
+	ParallelFor(grid.height, 64, [&](int y0, int y1)
+	{
+		const __m128 scale = _mm_set1_ps(kRdQuantizeScale);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 max = _mm_set1_ps(255.0f);
+		const __m128 half = _mm_set1_ps(0.5f);
+		auto quantize4 = [&](const float* p)
+		{
+			const __m128 q = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(p), scale), zero), max);
+			return _mm_cvttps_epi32(_mm_add_ps(q, half));
+		};
+
+		for (int y = y0; y < y1; ++y)
+		{
+			const float* row = v + (size_t)y * (size_t)width;
+			uint8_t* out = dst + (size_t)y * (size_t)width;
+			if (!sse)
+			{
+				for (int x = 0; x < width; ++x) out[x] = Quantize(row[x]);
+				continue;
+			}
+			for (int x = 0; x < width; x += 16) // width es multiplo de 16
+			{
+				const __m128i lo = _mm_packs_epi32(quantize4(row + x), quantize4(row + x + 4));
+				const __m128i hi = _mm_packs_epi32(quantize4(row + x + 8), quantize4(row + x + 12));
+				_mm_storeu_si128((__m128i*)(out + x), _mm_packus_epi16(lo, hi));
+			}
+		}
+	});
+}
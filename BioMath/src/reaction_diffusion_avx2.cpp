@@ -0,0 +1,38 @@
+// Kernel AVX2 del paso de reaccion-difusion (reaction_diffusion.h). Igual que cpu_renderer_avx2.cpp:
+// unidad de compilacion propia por -mavx2, solo se llama si GetCpuFeatures().avx2.
+
+#include "cpu_renderer_internal.h"
+
+#include <immintrin.h>
+
+void RdStepSpanAVX2(const RdConstants& k, const RdRows& r, int x0, int x1)
+{
+	const __m256 du = _mm256_set1_ps(k.du);
+	const __m256 dv = _mm256_set1_ps(k.dv);
+	const __m256 feed = _mm256_set1_ps(k.feed);
+	const __m256 feedKill = _mm256_set1_ps(k.feedKill);
+	const __m256 dt = _mm256_set1_ps(k.dt);
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 four = _mm256_set1_ps(4.0f);
+
+	// Mismas operaciones y orden que Cell() en reaction_diffusion.cpp (sin FMA).
+	int x = x0;
+	for (; x + 8 <= x1; x += 8)
+	{
+		const __m256 uC = _mm256_loadu_ps(r.uMid + x);
+		const __m256 vC = _mm256_loadu_ps(r.vMid + x);
+		const __m256 uNS = _mm256_add_ps(_mm256_loadu_ps(r.uUp + x), _mm256_loadu_ps(r.uDown + x));
+		const __m256 uWE = _mm256_add_ps(_mm256_loadu_ps(r.uMid + x - 1), _mm256_loadu_ps(r.uMid + x + 1));
+		const __m256 vNS = _mm256_add_ps(_mm256_loadu_ps(r.vUp + x), _mm256_loadu_ps(r.vDown + x));
+		const __m256 vWE = _mm256_add_ps(_mm256_loadu_ps(r.vMid + x - 1), _mm256_loadu_ps(r.vMid + x + 1));
+		const __m256 lapU = _mm256_sub_ps(_mm256_add_ps(uNS, uWE), _mm256_mul_ps(uC, four));
+		const __m256 lapV = _mm256_sub_ps(_mm256_add_ps(vNS, vWE), _mm256_mul_ps(vC, four));
+		const __m256 uvv = _mm256_mul_ps(_mm256_mul_ps(uC, vC), vC);
+
+		const __m256 ru = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(du, lapU), uvv), _mm256_mul_ps(feed, _mm256_sub_ps(one, uC)));
+		const __m256 rv = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(dv, lapV), uvv), _mm256_mul_ps(feedKill, vC));
+		_mm256_storeu_ps(r.uOut + x, _mm256_add_ps(uC, _mm256_mul_ps(dt, ru)));
+		_mm256_storeu_ps(r.vOut + x, _mm256_add_ps(vC, _mm256_mul_ps(dt, rv)));
+	}
+	RdStepSpanScalar(k, r, x, x1);
+}
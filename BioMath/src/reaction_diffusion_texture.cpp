@@ -0,0 +1,301 @@
+#include "reaction_diffusion_texture.h"
+#include "frame_stats.h"
+#include "gl_state.h"
+#include "parallel.h"
+#include "platform.h"
+#include "profiler.h"
+#include "reaction_diffusion.h"
+#include "triple_buffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// V cuantizado de un tick. Los tres slots del triple buffer se reservan al iniciar: publicar no
+// aloca.
+struct RdFrame
+{
+	uint64_t step = 0;
+	std::vector<uint8_t> texels;
+};
+
+struct ReactionDiffusion
+{
+	RdOptions options;
+	bool active = false;
+	bool prepared = false;    // RdTexturePrepare corrio y su resultado espera a RdTextureInit
+	bool seeded = false;      // la grilla esta reservada y sembrada
+	RdGrid grid;
+	RdParams params;
+	TripleBuffer<RdFrame> frames;
+	size_t bytes = 0;
+
+	// Lo toca solo quien corre los ticks; se lee despues de SimShutdown.
+	uint64_t steps = 0;
+	uint64_t pendingQuarters = 0;  // pasos en cuartos que todavia no llegaron a uno entero
+	uint64_t published = 0;
+	double tickSeconds = 0.0;
+	std::vector<double> tickMs;
+	size_t tickCount = 0;
+
+	// Render
+	GLuint texture = 0;
+	GLuint pbos[kRdPboCount] = {};
+	int nextPbo = 0;
+	uint64_t uploaded = 0;
+	uint64_t mapFailures = 0;
+	std::vector<double> uploadMs;
+	size_t uploadCount = 0;
+};
+
+static ReactionDiffusion g_rd;
+
+bool ParseReactionDiffusionOptions(int argc, char** argv, RdOptions* opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--rd") == 0)
+			opts->enabled = true;
+		else if (strcmp(argv[i], "--no-rd") == 0)
+			opts->enabled = false;
+		else if (strcmp(argv[i], "--rd-size") == 0 && i + 1 < argc)
+			opts->size = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--rd-steps") == 0 && i + 1 < argc)
+			opts->stepsPerTick = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--rd-seed") == 0 && i + 1 < argc)
+			opts->seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--rd-preset") == 0 && i + 1 < argc)
+		{
+			opts->preset = RdPresetFind(argv[++i]);
+			if (opts->preset < 0)
+			{
+				PlatformAttachConsole();
+				fprintf(stderr, "unknown reaction-diffusion preset '%s'; available:", argv[i]);
+				for (const RdPreset& p : kRdPresets) fprintf(stderr, " %s", p.name);
+				fprintf(stderr, "\n");
+				return false;
+			}
+		}
+	}
+
+	// Multiplo de 16 (kernels SIMD y filas alineadas para el upload).
+	opts->size = (opts->size + 15) & ~15;
+	if (opts->size < kRdMinSize) opts->size = kRdMinSize;
+	if (opts->size > 8192) opts->size = 8192;
+	if (opts->stepsPerTick < 1) opts->stepsPerTick = 1;
+	if (opts->stepsPerTick > 64) opts->stepsPerTick = 64;
+	return true;
+}
+
+static double MsSince(uint64_t startTicks)
+{
+	return (double)(PlatformTicks() - startTicks) * 1000.0 / (double)PlatformTickFrequency();
+}
+
+static void PublishField()
+{
+	RdFrame& frame = g_rd.frames.Write();
+	RdQuantize(g_rd.grid, frame.texels.data());
+	frame.step = g_rd.steps;
+	g_rd.frames.Publish();
+	++g_rd.published;
+}
+
+static bool CreateGLObjects()
+{
+	const int size = g_rd.options.size;
+
+	glGenTextures(1, &g_rd.texture);
+	GLStateBindTexture2D(0, g_rd.texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT); // la grilla es toroidal
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, size, size, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+
+	glGenBuffers_ptr(kRdPboCount, g_rd.pbos);
+	for (GLuint pbo : g_rd.pbos)
+	{
+		GLStateBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+		glBufferData_ptr(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)g_rd.bytes, nullptr, GL_STREAM_DRAW);
+	}
+	GLStateBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	const GLenum error = glGetError();
+	if (error != GL_NO_ERROR)
+	{
+		fprintf(stderr, "reaction-diffusion: texture/PBO setup failed (0x%04X), using the noise background\n", error);
+		return false;
+	}
+	return true;
+}
+
+static void DeleteGLObjects()
+{
+	for (GLuint& pbo : g_rd.pbos)
+	{
+		GLStateDeleteBuffer(pbo);
+		pbo = 0;
+	}
+	GLStateDeleteTexture(g_rd.texture);
+	g_rd.texture = 0;
+}
+
+void RdTexturePrepare(const RdOptions& opts)
+{
+	g_rd.options = opts;
+	g_rd.prepared = true;
+	g_rd.seeded = false;
+	if (!opts.enabled) return;
+	PROFILE_ZONE("RdTexturePrepare");
+
+	if (!RdGridInit(&g_rd.grid, opts.size, opts.size))
+	{
+		fprintf(stderr, "reaction-diffusion: invalid grid size %d\n", opts.size);
+		return;
+	}
+	RdGridSeed(&g_rd.grid, opts.seed);
+	g_rd.params = RdParams();
+	g_rd.params.feed = kRdPresets[opts.preset].feed;
+	g_rd.params.kill = kRdPresets[opts.preset].kill;
+
+	g_rd.bytes = (size_t)opts.size * (size_t)opts.size;
+	for (auto& slot : g_rd.frames.slots)
+		slot.value.texels.assign(g_rd.bytes, 0);
+	g_rd.tickMs.assign(kRdTimingSamples, 0.0);
+	g_rd.uploadMs.assign(kRdTimingSamples, 0.0);
+
+	// El estado sembrado se publica ya: el primer frame tiene algo que subir.
+	PublishField();
+	g_rd.seeded = true;
+}
+
+bool RdTextureInit(const RdOptions& opts)
+{
+	if (!g_rd.prepared) RdTexturePrepare(opts);
+	g_rd.prepared = false;
+	g_rd.active = false;
+	if (!opts.enabled || !g_rd.seeded) return false;
+	if (!glMapBufferRange_ptr || !glUnmapBuffer_ptr || !glActiveTexture_ptr)
+	{
+		fprintf(stderr, "reaction-diffusion: pixel buffer objects not available, using the noise background\n");
+		g_rd.grid = RdGrid();
+		return false;
+	}
+	PROFILE_ZONE("RdTextureInit");
+
+	if (!CreateGLObjects())
+	{
+		DeleteGLObjects();
+		g_rd.grid = RdGrid();
+		return false;
+	}
+	g_rd.active = true;
+	return true;
+}
+
+void RdTextureShutdown()
+{
+	DeleteGLObjects();
+	g_rd.active = false;
+}
+
+bool RdTextureActive()
+{
+	return g_rd.active;
+}
+
+void RdFieldTick(int timeScaleQuarters)
+{
+	if (!g_rd.active) return;
+
+	// Los pasos van en cuartos, como la fase de la simulacion: a 0.25x corre uno cada 4 ticks.
+	g_rd.pendingQuarters += (uint64_t)g_rd.options.stepsPerTick * (uint64_t)timeScaleQuarters;
+	const int steps = (int)(g_rd.pendingQuarters / 4);
+	g_rd.pendingQuarters %= 4;
+	if (steps == 0) return; // congelado: nada nuevo que publicar
+
+	PROFILE_ZONE("RdTick");
+	const uint64_t t0 = PlatformTicks();
+	RdStep(&g_rd.grid, g_rd.params, steps);
+	g_rd.steps += (uint64_t)steps;
+	PublishField();
+
+	const double ms = MsSince(t0);
+	g_rd.tickSeconds += ms * 1e-3;
+	g_rd.tickMs[g_rd.tickCount++ % kRdTimingSamples] = ms;
+}
+
+void RdTextureUpload()
+{
+	if (!g_rd.active || !g_rd.frames.Acquire()) return;
+	PROFILE_ZONE("RdUpload");
+	const uint64_t t0 = PlatformTicks();
+
+	// Anillo de PBOs: aunque el driver no renombre el buffer al invalidarlo, el que se llena ahora
+	// no es el que la GPU puede estar copiando todavia del frame anterior.
+	const GLuint pbo = g_rd.pbos[g_rd.nextPbo];
+	g_rd.nextPbo = (g_rd.nextPbo + 1) % kRdPboCount;
+
+	GLStateBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+	void* dst = glMapBufferRange_ptr(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)g_rd.bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (dst)
+	{
+		memcpy(dst, g_rd.frames.Read().texels.data(), g_rd.bytes);
+		if (glUnmapBuffer_ptr(GL_PIXEL_UNPACK_BUFFER))
+		{
+			// Con un PBO bindeado el ultimo argumento es un offset dentro del buffer.
+			GLStateBindTexture2D(0, g_rd.texture);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, g_rd.options.size, g_rd.options.size, GL_RED, GL_UNSIGNED_BYTE, (const void*)0);
+			++g_rd.uploaded;
+		}
+		else
+		{
+			++g_rd.mapFailures; // el contenido se perdio (cambio de modo, etc.): se sube el proximo
+		}
+	}
+	else
+	{
+		++g_rd.mapFailures;
+	}
+	// Sin esto cualquier otra subida desde memoria del proceso leeria del PBO.
+	GLStateBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	g_rd.uploadMs[g_rd.uploadCount++ % kRdTimingSamples] = MsSince(t0);
+}
+
+void RdTextureBind()
+{
+	if (g_rd.active) GLStateBindTexture2D(0, g_rd.texture);
+}
+
+std::string RdShaderDefines()
+{
+	return g_rd.active ? std::string("#define REACTION_DIFFUSION 1\n") : std::string();
+}
+
+void WriteReactionDiffusionJson(FILE* f)
+{
+	if (!g_rd.active)
+	{
+		fprintf(f, "\"reaction_diffusion\": { \"enabled\": false }");
+		return;
+	}
+
+	const double cells = (double)g_rd.bytes;
+	const double updatesPerSecond = g_rd.tickSeconds > 0.0 ? (double)g_rd.steps * cells / g_rd.tickSeconds : 0.0;
+	fprintf(f, "\"reaction_diffusion\": { \"enabled\": true, \"size\": %d, \"preset\": \"%s\", \"steps_per_tick\": %d",
+		g_rd.options.size, kRdPresets[g_rd.options.preset].name, g_rd.options.stepsPerTick);
+	fprintf(f, ", \"path\": \"%s\", \"threads\": %d, \"steps\": %llu, \"mcell_updates_per_s\": %.1f",
+		CpuShadePathName(CpuResolveShadePath(CpuShadePath::Auto)), ParallelThreadCount(), (unsigned long long)g_rd.steps,
+		updatesPerSecond * 1e-6);
+	fprintf(f, ", \"published\": %llu, \"uploaded\": %llu, \"dropped\": %llu, \"map_failures\": %llu, ",
+		(unsigned long long)g_rd.published, (unsigned long long)g_rd.uploaded,
+		(unsigned long long)(g_rd.published - g_rd.uploaded - g_rd.mapFailures), (unsigned long long)g_rd.mapFailures);
+	const size_t ticks = g_rd.tickCount < kRdTimingSamples ? g_rd.tickCount : kRdTimingSamples;
+	const size_t uploads = g_rd.uploadCount < kRdTimingSamples ? g_rd.uploadCount : kRdTimingSamples;
+	WriteTimingSummaryJson(f, "tick_ms", SummarizeTimings(g_rd.tickMs.data(), ticks));
+	fprintf(f, ", ");
+	WriteTimingSummaryJson(f, "upload_ms", SummarizeTimings(g_rd.uploadMs.data(), uploads));
+	fprintf(f, " }");
+}
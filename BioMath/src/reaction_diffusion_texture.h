@@ -0,0 +1,67 @@
+#pragma once
+
+#include "gl_api.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+// ---------------------------
+// Fondo de reaccion-difusion
+// ---------------------------
+
+// Con --rd el fondo deja de ser ruido: fullscreen.glsl compila con REACTION_DIFFUSION y usa el
+// campo V de una simulacion Gray-Scott (reaction_diffusion.h) en lugar de fbm().
+//
+// El campo avanza en el thread de simulacion (simulation.h): cada tick corre los pasos que tocan
+// segun la velocidad (Up/Down; a 0 se congela), cuantiza V a unorm8 y lo publica por un triple
+// buffer. El render toma el ultimo frame publicado (sin interpolar: es un estado discreto) y lo
+// sube a una textura GL_R8 pasando por un anillo de PBOs: el memcpy va a memoria del driver
+// (mapeada con INVALIDATE, que no espera a la GPU) y glTexSubImage2D desde el PBO vuelve enseguida;
+// la copia a la textura la hace el driver/DMA despues. Si la simulacion publica dos frames entre
+// dos renders, el viejo ni se sube.
+//
+// La grilla es toroidal y la textura usa GL_REPEAT: el shader la repite en X para la relacion de
+// aspecto de la ventana sin costuras. Va en la unidad 0 (valor por defecto del sampler): con --rd
+// no se usa el lattice de ruido horneado.
+//
+// En headless no hay thread de simulacion: el loop de headless.cpp llama a RdFieldTick antes de
+// cada frame (un tick por frame, velocidad 1x).
+
+struct RdOptions
+{
+	bool enabled = true;
+	int size = 2048;          // lado de la grilla
+	int stepsPerTick = 1;     // a velocidad 1x (2048^2: ~3 ms por paso en 8 cores, limitado por memoria)
+	int preset = 0;           // kRdPresets
+	uint32_t seed = 1;
+};
+
+static const int kRdPboCount = 2;
+static const size_t kRdTimingSamples = 1 << 16;
+
+// --rd / --no-rd, --rd-size N, --rd-steps N, --rd-preset name, --rd-seed N. false si el preset no existe.
+bool ParseReactionDiffusionOptions(int argc, char** argv, RdOptions* opts);
+
+// La parte de CPU de RdTextureInit, sin GL: reserva la grilla, la siembra y publica el primer
+// campo. Puede correr en otro thread mientras se crea el contexto (startup.h).
+void RdTexturePrepare(const RdOptions& opts);
+
+// Requiere contexto GL: reserva y siembra la grilla (si no se llamo a RdTexturePrepare) y crea
+// textura + PBOs. Si falta algo (PBOs, memoria) queda apagado, el motivo va a stderr y el fondo sigue siendo ruido.
+bool RdTextureInit(const RdOptions& opts);
+void RdTextureShutdown();   // despues de SimShutdown
+bool RdTextureActive();
+
+// Thread de simulacion (o el loop en headless): un tick. 'timeScaleQuarters' = velocidad en cuartos.
+void RdFieldTick(int timeScaleQuarters);
+
+// Render: si hay un frame nuevo lo sube (PBO -> textura). Una vez por frame, antes de dibujar.
+void RdTextureUpload();
+void RdTextureBind();
+
+// #defines para fullscreen.glsl ("" si esta apagado).
+std::string RdShaderDefines();
+
+// "reaction_diffusion": { ... } para los reportes JSON. Despues de SimShutdown.
+void WriteReactionDiffusionJson(FILE* f);
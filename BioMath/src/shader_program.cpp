@@ -0,0 +1,841 @@
+#include "shader_program.h"
+#include "assets.h"
+#include "gl_state.h"
+#include "platform.h"
+#include "profiler.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+static ShaderOptions g_options;
+static ShaderBuildStats g_stats;
+static std::string g_lastPath;
+
+void ParseShaderOptions(int argc, char** argv, ShaderOptions* opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--shader-dir") == 0 && i + 1 < argc) opts->directory = argv[++i];
+		else if (strcmp(argv[i], "--no-shader-cache") == 0) opts->binaryCache = false;
+		else if (strcmp(argv[i], "--shader-async") == 0 && i + 1 < argc)
+		{
+			const char* mode = argv[++i];
+			if (strcmp(mode, "khr") == 0) opts->async = ShaderAsyncMode::Khr;
+			else if (strcmp(mode, "worker") == 0) opts->async = ShaderAsyncMode::Worker;
+			else if (strcmp(mode, "off") == 0) opts->async = ShaderAsyncMode::Off;
+			else opts->async = ShaderAsyncMode::Auto;
+		}
+	}
+}
+
+void ShaderSetOptions(const ShaderOptions& opts)
+{
+	g_options = opts;
+}
+
+
+// ---------------------------
+// Archivos
+// ---------------------------
+
+// BOM de UTF-8 (algunos editores de Windows lo agregan): GLSL no lo acepta.
+static void StripBom(std::string* s)
+{
+	if (s->size() >= 3 && (unsigned char)(*s)[0] == 0xEF && (unsigned char)(*s)[1] == 0xBB && (unsigned char)(*s)[2] == 0xBF)
+		s->erase(0, 3);
+}
+
+static bool ReadWholeFile(const char* path, std::string* out)
+{
+	FILE* f = fopen(path, "rb");
+	if (!f) return false;
+
+	out->clear();
+	char buffer[4096];
+	size_t n = 0;
+	while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+		out->append(buffer, n);
+	fclose(f);
+	StripBom(out);
+	return true;
+}
+
+static bool FindAndRead(const char* name, ShaderFile* file, std::string* error)
+{
+	// Con --assets el paquete va primero, salvo un --shader-dir explicito. La ruta no existe en
+	// disco (paquete:nombre), asi que ShaderFileChanged nunca lo da por cambiado.
+	if (!g_options.directory && AssetsMounted())
+	{
+		const std::string assetName = std::string("shaders/") + name;
+		std::vector<uint8_t> storage;
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+		if (AssetsLoad(assetName.c_str(), &data, &size, &storage))
+		{
+			ShaderFile loaded;
+			loaded.source.assign((const char*)data, size);
+			StripBom(&loaded.source);
+			loaded.path = std::string(AssetsPackPath()) + ":" + assetName;
+			loaded.modifiedTime = 0;
+			*file = std::move(loaded);
+			return true;
+		}
+	}
+
+	std::vector<std::string> dirs;
+	if (g_options.directory) dirs.push_back(g_options.directory);
+	else
+	{
+		if (const char* env = getenv("BIOMATH_SHADER_DIR")) dirs.push_back(env);
+#ifdef BIOMATH_SHADER_SOURCE_DIR
+		dirs.push_back(BIOMATH_SHADER_SOURCE_DIR);
+#endif
+		dirs.push_back("shaders");
+		dirs.push_back("BioMath/shaders");
+	}
+
+	for (const std::string& dir : dirs)
+	{
+		const std::string path = dir + "/" + name;
+		const uint64_t modified = PlatformFileModifiedTime(path.c_str());
+		if (!modified) continue;
+
+		ShaderFile loaded;
+		if (!ReadWholeFile(path.c_str(), &loaded.source)) continue;
+		loaded.path = path;
+		loaded.modifiedTime = modified;
+		*file = std::move(loaded);
+		return true;
+	}
+
+	if (error)
+	{
+		*error = std::string("Cannot find '") + name + "' in:";
+		for (const std::string& dir : dirs) *error += "\n  " + dir;
+		*error += "\nUse --shader-dir or BIOMATH_SHADER_DIR to point at BioMath/shaders.";
+	}
+	return false;
+}
+
+// Archivos leidos por adelantado (ShaderFilePrefetch), por nombre. Cada uno se usa una vez.
+struct PrefetchedFile
+{
+	std::string name;
+	ShaderFile file;
+};
+
+static std::mutex g_prefetchMutex;
+static std::vector<PrefetchedFile> g_prefetched;
+
+void ShaderFilePrefetch(const char* name)
+{
+	PROFILE_ZONE("ShaderFilePrefetch");
+	PrefetchedFile entry;
+	entry.name = name;
+	if (!FindAndRead(name, &entry.file, nullptr)) return; // el error lo da el ShaderFileLoad de despues
+
+	std::lock_guard<std::mutex> lock(g_prefetchMutex);
+	g_prefetched.push_back(std::move(entry));
+}
+
+bool ShaderFileLoad(const char* name, ShaderFile* file, std::string* error)
+{
+	PROFILE_ZONE("ShaderFileLoad");
+
+	PrefetchedFile entry;
+	bool found = false;
+	{
+		std::lock_guard<std::mutex> lock(g_prefetchMutex);
+		for (size_t i = 0; i < g_prefetched.size(); ++i)
+		{
+			if (g_prefetched[i].name != name) continue;
+			entry = std::move(g_prefetched[i]);
+			g_prefetched.erase(g_prefetched.begin() + (ptrdiff_t)i);
+			found = true;
+			break;
+		}
+	}
+	// Si el archivo cambio desde la lectura (hot reload, editor guardando) se lee de nuevo.
+	if (found && PlatformFileModifiedTime(entry.file.path.c_str()) == entry.file.modifiedTime)
+	{
+		*file = std::move(entry.file);
+		return true;
+	}
+	return FindAndRead(name, file, error);
+}
+
+bool ShaderFileChanged(const ShaderFile& file)
+{
+	const uint64_t modified = PlatformFileModifiedTime(file.path.c_str());
+	return modified != 0 && modified != file.modifiedTime;
+}
+
+
+// ---------------------------
+// Cache de binarios
+// ---------------------------
+
+// Cabecera de cada entrada: la clave se repite adentro para descartar archivos renombrados o
+// truncados sin confiar solo en el nombre.
+struct ProgramCacheHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint64_t key;
+	uint32_t format;
+	uint32_t length;
+};
+
+static const char kCacheMagic[4] = { 'B', 'M', 'P', 'B' };
+static const uint32_t kCacheVersion = 1;
+static const uint32_t kCacheMaxBinaryBytes = 64u << 20;   // mas que esto no es un binario de driver
+
+struct ProgramCache
+{
+	bool checked = false;
+	bool available = false;
+	ShaderCacheResult unavailableReason = ShaderCacheResult::Disabled;
+	char directory[1024] = {};
+};
+
+static ProgramCache g_cache;
+
+static bool CacheAvailable()
+{
+	if (g_cache.checked) return g_cache.available;
+	g_cache.checked = true;
+
+	if (!g_options.binaryCache) return false;
+
+	g_cache.unavailableReason = ShaderCacheResult::Unsupported;
+	if (!glGetProgramBinary_ptr || !glProgramBinary_ptr || !glProgramParameteri_ptr) return false;
+
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	if (formats <= 0) return false;
+
+	g_cache.unavailableReason = ShaderCacheResult::Disabled;
+	if (!PlatformCacheDirectory(g_cache.directory, sizeof(g_cache.directory))) return false;
+
+	g_cache.available = true;
+	return true;
+}
+
+// FNV-1a de 64 bits: no es criptografico, solo tiene que separar versiones del mismo shader.
+static uint64_t HashBytes(uint64_t h, const void* data, size_t size)
+{
+	const uint8_t* p = (const uint8_t*)data;
+	for (size_t i = 0; i < size; ++i)
+	{
+		h ^= p[i];
+		h *= 0x100000001B3ull;
+	}
+	return h;
+}
+
+static uint64_t HashString(uint64_t h, const char* s)
+{
+	// Se incluye el terminador: "ab"+"c" y "a"+"bc" dan claves distintas.
+	return HashBytes(h, s ? s : "", s ? strlen(s) + 1 : 1);
+}
+
+static uint64_t ProgramCacheKey(const std::string& vsSrc, const std::string& fsSrc)
+{
+	uint64_t h = 0xCBF29CE484222325ull;
+	h = HashString(h, vsSrc.c_str());
+	h = HashString(h, fsSrc.c_str());
+	h = HashString(h, (const char*)glGetString(GL_VENDOR));
+	h = HashString(h, (const char*)glGetString(GL_RENDERER));
+	h = HashString(h, (const char*)glGetString(GL_VERSION));
+	return h;
+}
+
+static std::string CachePath(uint64_t key)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "/program-%016llx.bin", (unsigned long long)key);
+	return std::string(g_cache.directory) + name;
+}
+
+// true si 'program' quedo linkeado desde el binario. *rejected = habia entrada y el driver la rechazo.
+static bool CacheLoad(uint64_t key, GLuint program, bool* rejected)
+{
+	PROFILE_ZONE("ProgramBinaryLoad");
+	*rejected = false;
+
+	FILE* f = fopen(CachePath(key).c_str(), "rb");
+	if (!f) return false;
+
+	// El largo del header tiene que ser justo lo que queda del archivo: una entrada truncada o
+	// corrupta no llega a reservar memoria (el largo es de 32 bits: hasta 4 GB).
+	long fileSize = -1;
+	if (fseek(f, 0, SEEK_END) == 0) fileSize = ftell(f);
+	rewind(f);
+
+	ProgramCacheHeader header;
+	std::vector<uint8_t> binary;
+	bool ok = fileSize > (long)sizeof(header) && fread(&header, sizeof(header), 1, f) == 1 &&
+		memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) == 0 &&
+		header.version == kCacheVersion && header.key == key && header.length > 0 &&
+		header.length <= kCacheMaxBinaryBytes && (unsigned long)header.length == (unsigned long)fileSize - sizeof(header);
+	if (ok)
+	{
+		binary.resize(header.length);
+		ok = fread(binary.data(), 1, binary.size(), f) == binary.size();
+	}
+	fclose(f);
+
+	if (!ok)
+	{
+		*rejected = true;
+		return false;
+	}
+
+	glProgramBinary_ptr(program, header.format, binary.data(), (GLsizei)binary.size());
+	GLint linked = GL_FALSE;
+	glGetProgramiv_ptr(program, GL_LINK_STATUS, &linked);
+	*rejected = linked != GL_TRUE;
+	return linked == GL_TRUE;
+}
+
+static void CacheStore(uint64_t key, GLuint program)
+{
+	PROFILE_ZONE("ProgramBinaryStore");
+
+	GLint length = 0;
+	glGetProgramiv_ptr(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) return;
+
+	std::vector<uint8_t> binary((size_t)length);
+	GLsizei written = 0;
+	GLenum format = 0;
+	glGetProgramBinary_ptr(program, (GLsizei)length, &written, &format, binary.data());
+	if (written <= 0) return;
+
+	ProgramCacheHeader header;
+	memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+	header.version = kCacheVersion;
+	header.key = key;
+	header.format = format;
+	header.length = (uint32_t)written;
+
+	// Se escribe aparte y se renombra: otra instancia nunca lee una entrada a medias.
+	const std::string path = CachePath(key);
+	const std::string tmpPath = path + ".tmp";
+	FILE* f = fopen(tmpPath.c_str(), "wb");
+	if (!f) return;
+	const bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+		fwrite(binary.data(), 1, (size_t)written, f) == (size_t)written;
+	if (fclose(f) != 0 || !ok)
+	{
+		remove(tmpPath.c_str());
+		return;
+	}
+	remove(path.c_str()); // rename no pisa en Windows
+	if (rename(tmpPath.c_str(), path.c_str()) != 0) remove(tmpPath.c_str());
+}
+
+
+// ---------------------------
+// Compilacion
+// ---------------------------
+
+struct ShaderBuild
+{
+	std::string path;
+	std::string vsSrc;
+	std::string fsSrc;
+	uint64_t key = 0;
+	bool useCache = false;
+	ShaderCacheResult cache = ShaderCacheResult::Disabled;
+
+	GLuint program = 0;
+	GLuint vs = 0;
+	GLuint fs = 0;
+	bool linked = false;
+	std::string log;
+
+	uint64_t beginTicks = 0;
+	double ms = 0.0;
+	std::atomic<bool> done{ false }; // lo publica el worker (release) y lo lee el render (acquire)
+};
+
+static std::string StageSource(const ShaderFile& file, const char* stageDefine, const char* defines)
+{
+	std::string src = "#version 330 core\n#define ";
+	src += stageDefine;
+	src += "\n";
+	if (defines) src += defines;
+	src += "#line 1\n";
+	src += file.source;
+	return src;
+}
+
+static void AppendInfoLog(std::string* log, const std::string& what, const char* text)
+{
+	*log += what;
+	*log += ":\n";
+	*log += text;
+	*log += "\n";
+}
+
+// Manda a compilar y linkear sin consultar ningun estado: con parallel compile vuelve enseguida.
+static void SubmitCompile(ShaderBuild* b)
+{
+	const char* vsText = b->vsSrc.c_str();
+	const char* fsText = b->fsSrc.c_str();
+
+	b->vs = glCreateShader_ptr(GL_VERTEX_SHADER);
+	glShaderSource_ptr(b->vs, 1, &vsText, nullptr);
+	glCompileShader_ptr(b->vs);
+
+	b->fs = glCreateShader_ptr(GL_FRAGMENT_SHADER);
+	glShaderSource_ptr(b->fs, 1, &fsText, nullptr);
+	glCompileShader_ptr(b->fs);
+
+	if (b->useCache) glProgramParameteri_ptr(b->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glAttachShader_ptr(b->program, b->vs);
+	glAttachShader_ptr(b->program, b->fs);
+	glLinkProgram_ptr(b->program);
+}
+
+static void AppendShaderLog(ShaderBuild* b, GLuint shader, const char* stage)
+{
+	GLint ok = GL_FALSE;
+	glGetShaderiv_ptr(shader, GL_COMPILE_STATUS, &ok);
+	if (ok) return;
+
+	GLint len = 0;
+	glGetShaderiv_ptr(shader, GL_INFO_LOG_LENGTH, &len);
+	std::vector<char> info((size_t)len + 1, 0);
+	GLsizei outLen = 0;
+	glGetShaderInfoLog_ptr(shader, len, &outLen, info.data());
+	AppendInfoLog(&b->log, b->path + " (" + stage + ")", info.data());
+}
+
+// Lee el resultado de SubmitCompile (bloquea si el driver no termino) y libera los shaders.
+static bool FinishCompile(ShaderBuild* b)
+{
+	GLint ok = GL_FALSE;
+	glGetProgramiv_ptr(b->program, GL_LINK_STATUS, &ok);
+	if (!ok)
+	{
+		// Si fallo un stage el link tambien: el log util es el del compilador.
+		AppendShaderLog(b, b->vs, "vertex");
+		AppendShaderLog(b, b->fs, "fragment");
+		if (b->log.empty())
+		{
+			GLint len = 0;
+			glGetProgramiv_ptr(b->program, GL_INFO_LOG_LENGTH, &len);
+			std::vector<char> info((size_t)len + 1, 0);
+			GLsizei outLen = 0;
+			glGetProgramInfoLog_ptr(b->program, len, &outLen, info.data());
+			AppendInfoLog(&b->log, b->path + " (link)", info.data());
+		}
+	}
+
+	// Despues del link los shaders sobran (el programa no los necesita para dibujar).
+	glDeleteShader_ptr(b->vs);
+	glDeleteShader_ptr(b->fs);
+	b->vs = 0;
+	b->fs = 0;
+	return ok == GL_TRUE;
+}
+
+static ShaderBuild* CreateBuild(const ShaderFile& file, const char* defines)
+{
+	ShaderBuild* b = new ShaderBuild();
+	b->path = file.path;
+	b->vsSrc = StageSource(file, "VERTEX_SHADER", defines);
+	b->fsSrc = StageSource(file, "FRAGMENT_SHADER", defines);
+	b->useCache = CacheAvailable();
+	b->key = b->useCache ? ProgramCacheKey(b->vsSrc, b->fsSrc) : 0;
+	b->cache = b->useCache ? ShaderCacheResult::Miss : g_cache.unavailableReason;
+	b->beginTicks = PlatformTicks();
+	return b;
+}
+
+// Intenta la cache de binarios. Si el binario fue rechazado deja un programa nuevo para compilar.
+static bool TryCache(ShaderBuild* b)
+{
+	b->program = glCreateProgram_ptr();
+	if (!b->useCache) return false;
+
+	bool rejected = false;
+	if (CacheLoad(b->key, b->program, &rejected))
+	{
+		b->cache = ShaderCacheResult::Hit;
+		return true;
+	}
+	if (rejected)
+	{
+		// Un binario rechazado deja el programa en un estado indefinido: se arranca de cero.
+		b->cache = ShaderCacheResult::Rejected;
+		glDeleteProgram_ptr(b->program);
+		b->program = glCreateProgram_ptr();
+	}
+	return false;
+}
+
+static void CompleteBuild(ShaderBuild* b, bool linked)
+{
+	if (linked && b->useCache && b->cache != ShaderCacheResult::Hit) CacheStore(b->key, b->program);
+	if (!linked)
+	{
+		glDeleteProgram_ptr(b->program);
+		b->program = 0;
+	}
+	b->linked = linked;
+	b->ms = (double)(PlatformTicks() - b->beginTicks) * 1000.0 / (double)PlatformTickFrequency();
+}
+
+// Build entero en el thread actual (render o worker).
+static void RunBuild(ShaderBuild* b)
+{
+	PROFILE_ZONE("ShaderBuild");
+	if (TryCache(b))
+	{
+		CompleteBuild(b, true);
+		return;
+	}
+	SubmitCompile(b);
+	CompleteBuild(b, FinishCompile(b));
+}
+
+static GLuint TakeResult(ShaderBuild* b, std::string* log)
+{
+	if (b->linked)
+	{
+		g_stats.cache = b->cache;
+		g_stats.buildMs = b->ms;
+		++g_stats.builds;
+		g_lastPath = b->path;
+	}
+	else if (log)
+	{
+		*log = b->log;
+	}
+
+	const GLuint program = b->program;
+	delete b;
+	return program;
+}
+
+GLuint ShaderBuildProgram(const ShaderFile& file, const char* defines, std::string* log)
+{
+	PROFILE_ZONE("ShaderBuildProgram");
+	ShaderBuild* b = CreateBuild(file, defines);
+	RunBuild(b);
+	return TakeResult(b, log);
+}
+
+
+// ---------------------------
+// Hot reload de programas sueltos
+// ---------------------------
+
+struct WatchedProgram
+{
+	std::string name;
+	ShaderFile file;
+	std::string defines;
+	GLuint* program = nullptr;
+	ShaderRelocateFn relocate = nullptr;
+};
+
+static std::vector<WatchedProgram> g_watched;
+
+void ShaderWatch(const char* name, const ShaderFile& file, const char* defines, GLuint* program, ShaderRelocateFn relocate)
+{
+	ShaderUnwatch(program);
+	WatchedProgram w;
+	w.name = name;
+	w.file = file;
+	w.defines = defines ? defines : "";
+	w.program = program;
+	w.relocate = relocate;
+	g_watched.push_back(std::move(w));
+}
+
+void ShaderUnwatch(GLuint* program)
+{
+	for (size_t i = 0; i < g_watched.size(); ++i)
+	{
+		if (g_watched[i].program != program) continue;
+		g_watched.erase(g_watched.begin() + (ptrdiff_t)i);
+		return;
+	}
+}
+
+void ShaderReloadChanged()
+{
+	for (WatchedProgram& w : g_watched)
+	{
+		if (!ShaderFileChanged(w.file)) continue;
+		PROFILE_ZONE("ShaderReload");
+
+		ShaderFile updated;
+		if (!ShaderFileLoad(w.name.c_str(), &updated, nullptr)) continue; // a mitad de un guardado
+		w.file = std::move(updated);
+		fprintf(stderr, "shader changed: %s\n", w.file.path.c_str());
+
+		std::string log;
+		const GLuint program = ShaderBuildProgram(w.file, w.defines.c_str(), &log);
+		if (!program)
+		{
+			fprintf(stderr, "shader '%s' failed, keeping the previous program\n%s", w.name.c_str(), log.c_str());
+			continue;
+		}
+		GLStateDeleteProgram(*w.program);
+		*w.program = program;
+		w.relocate(program);
+	}
+}
+
+
+// ---------------------------
+// Compilacion asincronica
+// ---------------------------
+
+// El worker tiene su propio contexto, compartido con el principal: los programas que linkea se
+// ven desde el render. Antes de publicar 'done' hace glFinish, asi el render nunca usa un
+// programa con comandos pendientes en otro contexto.
+struct ShaderWorker
+{
+	PlatformSharedContext* context = nullptr;
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable finished;
+	std::deque<ShaderBuild*> queue;
+	bool quit = false;
+	bool exited = false; // ya no atiende la cola: ShaderBuildStart falla los builds nuevos
+};
+
+static ShaderAsyncMode g_asyncMode = ShaderAsyncMode::Off;
+static ShaderWorker g_worker;
+
+// Build que el worker no va a hacer: queda fallado y 'done'. Con el mutex tomado.
+static void FailBuildLocked(ShaderBuild* b)
+{
+	b->linked = false;
+	b->log = "shader worker stopped before building " + b->path;
+	b->done.store(true, std::memory_order_release);
+}
+
+static void WorkerMain(std::promise<bool>* started)
+{
+	ProfilerSetThreadName("ShaderCompiler");
+	const bool current = PlatformMakeSharedGLContextCurrent(g_worker.context);
+	started->set_value(current); // despues de esto 'started' ya no existe
+	if (current)
+	{
+		for (;;)
+		{
+			ShaderBuild* b = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(g_worker.mutex);
+				g_worker.wake.wait(lock, [] { return g_worker.quit || !g_worker.queue.empty(); });
+				if (g_worker.queue.empty()) break; // quit con la cola vacia
+				b = g_worker.queue.front();
+				g_worker.queue.pop_front();
+			}
+
+			RunBuild(b);
+			glFinish();
+
+			{
+				std::lock_guard<std::mutex> lock(g_worker.mutex);
+				b->done.store(true, std::memory_order_release);
+			}
+			g_worker.finished.notify_all();
+		}
+		PlatformMakeSharedGLContextCurrent(nullptr);
+	}
+
+	// Si sale antes de tiempo, nadie queda esperando en ShaderBuildFinish.
+	{
+		std::lock_guard<std::mutex> lock(g_worker.mutex);
+		g_worker.exited = true;
+		for (ShaderBuild* b : g_worker.queue) FailBuildLocked(b);
+		g_worker.queue.clear();
+	}
+	g_worker.finished.notify_all();
+}
+
+// El modo Worker se elige solo si el thread pudo hacer current su contexto; si no, queda Off.
+static bool StartWorker()
+{
+	g_worker.context = PlatformCreateSharedGLContext();
+	if (!g_worker.context) return false;
+
+	g_worker.quit = false;
+	g_worker.exited = false;
+	std::promise<bool> started;
+	std::future<bool> current = started.get_future();
+	g_worker.thread = std::thread(WorkerMain, &started);
+	if (current.get()) return true;
+
+	fprintf(stderr, "shader worker: could not make the shared context current, compiling on the render thread\n");
+	g_worker.thread.join();
+	PlatformDestroySharedGLContext(g_worker.context);
+	g_worker.context = nullptr;
+	return false;
+}
+
+void ShaderAsyncInit()
+{
+	// La cache se inicializa aca, en el thread de render: despues la consulta tambien el worker.
+	CacheAvailable();
+
+	const ShaderAsyncMode wanted = g_options.async;
+	const bool khr = glMaxShaderCompilerThreadsKHR_ptr &&
+		(GLHasExtension("GL_KHR_parallel_shader_compile") || GLHasExtension("GL_ARB_parallel_shader_compile"));
+
+	g_asyncMode = ShaderAsyncMode::Off;
+	if ((wanted == ShaderAsyncMode::Auto || wanted == ShaderAsyncMode::Khr) && khr)
+	{
+		glMaxShaderCompilerThreadsKHR_ptr(0xFFFFFFFFu); // que el driver decida cuantos
+		g_asyncMode = ShaderAsyncMode::Khr;
+	}
+	else if ((wanted == ShaderAsyncMode::Auto || wanted == ShaderAsyncMode::Worker || wanted == ShaderAsyncMode::Khr) && StartWorker())
+	{
+		g_asyncMode = ShaderAsyncMode::Worker;
+	}
+}
+
+void ShaderAsyncShutdown()
+{
+	if (g_worker.thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(g_worker.mutex);
+			g_worker.quit = true;
+		}
+		g_worker.wake.notify_all();
+		g_worker.thread.join();
+	}
+	PlatformDestroySharedGLContext(g_worker.context);
+	g_worker.context = nullptr;
+	g_asyncMode = ShaderAsyncMode::Off;
+}
+
+ShaderAsyncMode ShaderAsyncActiveMode()
+{
+	return g_asyncMode;
+}
+
+const char* ShaderAsyncModeName(ShaderAsyncMode mode)
+{
+	switch (mode)
+	{
+	case ShaderAsyncMode::Auto: return "auto";
+	case ShaderAsyncMode::Khr: return "khr";
+	case ShaderAsyncMode::Worker: return "worker";
+	case ShaderAsyncMode::Off: return "off";
+	}
+	return "unknown";
+}
+
+ShaderBuild* ShaderBuildStart(const ShaderFile& file, const char* defines)
+{
+	PROFILE_ZONE("ShaderBuildStart");
+	ShaderBuild* b = CreateBuild(file, defines);
+
+	switch (g_asyncMode)
+	{
+	case ShaderAsyncMode::Khr:
+		if (TryCache(b))
+		{
+			CompleteBuild(b, true);
+			b->done.store(true, std::memory_order_relaxed);
+		}
+		else SubmitCompile(b);
+		break;
+
+	case ShaderAsyncMode::Worker:
+		{
+			std::lock_guard<std::mutex> lock(g_worker.mutex);
+			if (g_worker.exited) FailBuildLocked(b);
+			else g_worker.queue.push_back(b);
+		}
+		g_worker.wake.notify_one();
+		break;
+
+	default:
+		RunBuild(b);
+		b->done.store(true, std::memory_order_relaxed);
+		break;
+	}
+	return b;
+}
+
+bool ShaderBuildPoll(ShaderBuild* b)
+{
+	if (b->done.load(std::memory_order_acquire)) return true;
+	if (g_asyncMode != ShaderAsyncMode::Khr) return false;
+
+	// Con parallel compile, el estado del programa se consulta sin bloquear.
+	GLint complete = GL_FALSE;
+	glGetProgramiv_ptr(b->program, GL_COMPLETION_STATUS_KHR, &complete);
+	if (!complete) return false;
+
+	CompleteBuild(b, FinishCompile(b));
+	b->done.store(true, std::memory_order_relaxed);
+	return true;
+}
+
+GLuint ShaderBuildFinish(ShaderBuild* b, std::string* log)
+{
+	PROFILE_ZONE("ShaderBuildFinish");
+	if (!b->done.load(std::memory_order_acquire))
+	{
+		if (g_asyncMode == ShaderAsyncMode::Khr)
+		{
+			CompleteBuild(b, FinishCompile(b)); // bloquea hasta que el driver termine
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock(g_worker.mutex);
+			g_worker.finished.wait(lock, [b] { return b->done.load(std::memory_order_acquire); });
+		}
+	}
+	return TakeResult(b, log);
+}
+
+ShaderBuildStats ShaderLastBuildStats()
+{
+	return g_stats;
+}
+
+const char* ShaderCacheResultName(ShaderCacheResult result)
+{
+	switch (result)
+	{
+	case ShaderCacheResult::Disabled: return "disabled";
+	case ShaderCacheResult::Unsupported: return "unsupported";
+	case ShaderCacheResult::Hit: return "hit";
+	case ShaderCacheResult::Miss: return "miss";
+	case ShaderCacheResult::Rejected: return "rejected";
+	}
+	return "unknown";
+}
+
+void WriteShaderStatsJson(FILE* f)
+{
+	fprintf(f, "\"shader\": { \"path\": \"");
+	for (const char c : g_lastPath)
+	{
+		if (c == '"' || c == '\\') fputc('\\', f);
+		if ((unsigned char)c >= 0x20) fputc(c, f);
+	}
+	fprintf(f, "\", \"binary_cache\": \"%s\", \"build_ms\": %.3f, \"builds\": %d, \"async\": \"%s\" }",
+		ShaderCacheResultName(g_stats.cache), g_stats.buildMs, g_stats.builds, ShaderAsyncModeName(g_asyncMode));
+}
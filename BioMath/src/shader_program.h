@@ -0,0 +1,131 @@
+#pragma once
+
+#include "gl_api.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+// ---------------------------
+// Shaders desde archivo + cache de programas
+// ---------------------------
+
+// Los shaders viven en BioMath/shaders/, un archivo .glsl por programa con los dos stages:
+//
+//   #ifdef VERTEX_SHADER   ... #endif
+//   #ifdef FRAGMENT_SHADER ... #endif
+//
+// Al compilar se antepone "#version 330 core", el define del stage y los defines extra que se
+// pidan, seguido de "#line 1" para que los errores apunten a la linea del archivo.
+//
+// Hot reload: ShaderFileChanged() compara la fecha de modificacion (un stat, barato). El loop de
+// la ventana lo consulta unas veces por segundo y recompila; si el shader nuevo no compila se
+// sigue dibujando con el anterior. fullscreen.glsl lo maneja shader_variants.h; los demas
+// programas de un archivo se anotan con ShaderWatch y los revisa ShaderReloadChanged.
+//
+// Cache de binarios: despues de linkear se guarda glGetProgramBinary en la carpeta de cache del
+// usuario (PlatformCacheDirectory). La clave es un hash del codigo completo de los dos stages mas
+// GL_VENDOR / GL_RENDERER / GL_VERSION, asi que un cambio de driver o de shader nunca reusa un
+// binario viejo. En un arranque en caliente glProgramBinary reemplaza compile + link. Si el
+// driver rechaza el binario se compila normal y se pisa la entrada.
+//
+// Compilacion asincronica (ShaderBuildStart/Poll/Finish): con GL_KHR_parallel_shader_compile el
+// driver compila en sus threads y se consulta GL_COMPLETION_STATUS_KHR sin bloquear; si no esta,
+// un thread propio con un contexto compartido (PlatformCreateSharedGLContext) hace el trabajo.
+// En los dos casos el thread de render nunca espera a un compilador.
+
+enum class ShaderAsyncMode
+{
+	Auto,    // KHR si esta, si no worker, si no sincronico
+	Khr,     // GL_KHR_parallel_shader_compile (o la version ARB)
+	Worker,  // thread propio con contexto compartido
+	Off,     // todo en el thread de render
+};
+
+struct ShaderOptions
+{
+	const char* directory = nullptr; // --shader-dir; nullptr = buscar (ver ShaderFileLoad)
+	bool binaryCache = true;         // --no-shader-cache lo apaga
+	ShaderAsyncMode async = ShaderAsyncMode::Auto;
+};
+
+// --shader-dir dir, --no-shader-cache, --shader-async auto|khr|worker|off
+void ParseShaderOptions(int argc, char** argv, ShaderOptions* opts);
+
+// Se llama una vez, antes de cargar shaders.
+void ShaderSetOptions(const ShaderOptions& opts);
+
+struct ShaderFile
+{
+	std::string path;
+	std::string source;
+	uint64_t modifiedTime = 0;
+};
+
+// Carga 'name' (p. ej. "fullscreen.glsl") del directorio de shaders. Si no se paso --shader-dir
+// se prueba, en orden: $BIOMATH_SHADER_DIR, el directorio del codigo fuente (build de CMake),
+// "shaders" y "BioMath/shaders" relativos al directorio actual.
+bool ShaderFileLoad(const char* name, ShaderFile* file, std::string* error);
+
+// Lee 'name' de disco por adelantado, desde cualquier thread (no usa GL): el ShaderFileLoad
+// siguiente de ese nombre lo toma sin volver a leer, si el archivo no cambio en el medio. Para el
+// arranque (startup.h), mientras se crea el contexto. Un error aca no se reporta: lo da el
+// ShaderFileLoad.
+void ShaderFilePrefetch(const char* name);
+
+// true si el archivo en disco tiene otra fecha que file.modifiedTime. Mientras no existe (algunos
+// editores guardan borrando y renombrando) devuelve false.
+bool ShaderFileChanged(const ShaderFile& file);
+
+// Compila y linkea los dos stages de 'file' con 'defines' antepuestos (puede ser nullptr o "").
+// Primero intenta la cache de binarios. Devuelve 0 y el log del driver en 'log' si falla.
+GLuint ShaderBuildProgram(const ShaderFile& file, const char* defines, std::string* log);
+
+// Hot reload de un programa ya construido con ShaderBuildProgram. ShaderWatch anota el archivo
+// ('name' como se paso a ShaderFileLoad), los defines y la variable del modulo que tiene el
+// programa. ShaderReloadChanged (desde el mismo timer que ShaderVariantsReloadIfChanged) recompila
+// los que cambiaron en disco; solo si el build nuevo linkea borra el anterior, deja el nuevo en
+// *program y llama a 'relocate' para que el modulo vuelva a buscar sus uniforms. Si falla, el log
+// va a stderr y queda el anterior. ShaderUnwatch antes de borrar el programa.
+typedef void (*ShaderRelocateFn)(GLuint program);
+void ShaderWatch(const char* name, const ShaderFile& file, const char* defines, GLuint* program, ShaderRelocateFn relocate);
+void ShaderUnwatch(GLuint* program);
+void ShaderReloadChanged();
+
+// Compilacion asincronica. ShaderAsyncInit despues de crear el contexto (elige el modo pedido o el
+// mejor disponible); ShaderAsyncShutdown antes de destruirlo, con todos los builds terminados.
+void ShaderAsyncInit();
+void ShaderAsyncShutdown();
+ShaderAsyncMode ShaderAsyncActiveMode();
+const char* ShaderAsyncModeName(ShaderAsyncMode mode);
+
+// Un build en vuelo. Start no bloquea (salvo un hit de la cache de binarios, que es carga directa);
+// Poll dice si Finish va a volver sin esperar; Finish devuelve el programa (0 + log si fallo) y
+// libera el build. Todo desde el thread de render.
+struct ShaderBuild;
+ShaderBuild* ShaderBuildStart(const ShaderFile& file, const char* defines);
+bool ShaderBuildPoll(ShaderBuild* build);
+GLuint ShaderBuildFinish(ShaderBuild* build, std::string* log);
+
+// Resultado del ultimo build terminado (sincronico o no), para reportes.
+enum class ShaderCacheResult
+{
+	Disabled,     // --no-shader-cache
+	Unsupported,  // el driver no devuelve binarios (GL_NUM_PROGRAM_BINARY_FORMATS == 0)
+	Hit,          // cargado con glProgramBinary
+	Miss,         // compilado (y guardado)
+	Rejected,     // habia binario pero el driver no lo acepto: compilado y guardado de nuevo
+};
+
+struct ShaderBuildStats
+{
+	ShaderCacheResult cache = ShaderCacheResult::Disabled;
+	double buildMs = 0.0;
+	int builds = 0;
+};
+
+ShaderBuildStats ShaderLastBuildStats();
+const char* ShaderCacheResultName(ShaderCacheResult result);
+
+// "shader": { ... } para los reportes JSON (sin coma ni salto de linea alrededor).
+void WriteShaderStatsJson(FILE* f);
@@ -0,0 +1,196 @@
+#include "shader_variants.h"
+#include "gl_state.h"
+#include "profiler.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Un slot por fila de la tabla. 'program' es el ultimo que compilo bien; 'pending' el build en
+// vuelo. Si el archivo cambia con un build en vuelo no se puede cancelar: se marca 'stale', su
+// resultado se descarta y se lanza otro con el codigo nuevo.
+struct VariantSlot
+{
+	GLuint program = 0;
+	ShaderBuild* pending = nullptr;
+	bool stale = false;
+	bool wanted = false; // hay que (re)compilarla cuando se pueda
+};
+
+struct ShaderVariants
+{
+	const char* fileName = nullptr;
+	std::string baseDefines;
+	ShaderFile file;
+	VariantSlot slots[kShaderVariantCount];
+	int active = kShaderVariantDefault;
+	int requested = kShaderVariantDefault;
+	ShaderVariantStats stats;
+};
+
+static ShaderVariants g_variants;
+
+int ShaderVariantFind(const char* name)
+{
+	for (int i = 0; i < kShaderVariantCount; ++i)
+		if (strcmp(kShaderVariants[i].name, name) == 0) return i;
+	return -1;
+}
+
+std::string ShaderVariantDefines(const ShaderVariant& variant)
+{
+	char defines[160];
+	snprintf(defines, sizeof(defines), "#define NOISE_OCTAVES %d\n#define VIGNETTE %d\n#define CHEAP_HASH %d\n",
+		variant.noiseOctaves, variant.vignette ? 1 : 0, variant.cheapHash ? 1 : 0);
+	return defines;
+}
+
+static std::string SlotDefines(int index)
+{
+	return g_variants.baseDefines + ShaderVariantDefines(kShaderVariants[index]);
+}
+
+static void StartBuild(int index)
+{
+	VariantSlot& slot = g_variants.slots[index];
+	slot.wanted = true;
+	if (slot.pending) return; // se relanza al terminar si quedo 'stale'
+
+	slot.pending = ShaderBuildStart(g_variants.file, SlotDefines(index).c_str());
+	slot.stale = false;
+}
+
+bool ShaderVariantsBegin(const char* fileName, int initial, const std::string& baseDefines, std::string* error)
+{
+	PROFILE_ZONE("ShaderVariantsBegin");
+
+	g_variants.fileName = fileName;
+	g_variants.baseDefines = baseDefines;
+	if (!ShaderFileLoad(fileName, &g_variants.file, error)) return false;
+
+	g_variants.active = initial;
+	g_variants.requested = initial;
+	StartBuild(initial);
+	return true;
+}
+
+bool ShaderVariantsEnd(bool prewarm, std::string* error)
+{
+	PROFILE_ZONE("ShaderVariantsEnd");
+
+	const int initial = g_variants.active;
+	VariantSlot& slot = g_variants.slots[initial];
+	if (!slot.pending) return slot.program != 0;
+
+	const GLuint program = ShaderBuildFinish(slot.pending, error);
+	slot.pending = nullptr;
+	if (!program) return false;
+
+	slot.program = program;
+	++g_variants.stats.builds;
+
+	// El resto recien ahora: no le compiten los cores a la que hace falta para el primer frame.
+	if (prewarm)
+		for (int i = 0; i < kShaderVariantCount; ++i)
+			if (i != initial) StartBuild(i);
+	return true;
+}
+
+bool ShaderVariantsInit(const char* fileName, int initial, bool prewarm, const std::string& baseDefines, std::string* error)
+{
+	PROFILE_ZONE("ShaderVariantsInit");
+	return ShaderVariantsBegin(fileName, initial, baseDefines, error) && ShaderVariantsEnd(prewarm, error);
+}
+
+void ShaderVariantsShutdown()
+{
+	for (VariantSlot& slot : g_variants.slots)
+	{
+		if (slot.pending) GLStateDeleteProgram(ShaderBuildFinish(slot.pending, nullptr));
+		GLStateDeleteProgram(slot.program);
+		slot = VariantSlot();
+	}
+}
+
+void ShaderVariantsUpdate()
+{
+	for (int i = 0; i < kShaderVariantCount; ++i)
+	{
+		VariantSlot& slot = g_variants.slots[i];
+		if (!slot.pending || !ShaderBuildPoll(slot.pending)) continue;
+
+		std::string log;
+		const GLuint program = ShaderBuildFinish(slot.pending, &log);
+		slot.pending = nullptr;
+
+		if (slot.stale)
+		{
+			// Compilado con el codigo viejo: se tira y se compila el nuevo.
+			GLStateDeleteProgram(program);
+			StartBuild(i);
+			continue;
+		}
+		if (!program)
+		{
+			++g_variants.stats.failures;
+			fprintf(stderr, "shader variant '%s' failed, keeping the previous program\n%s", kShaderVariants[i].name, log.c_str());
+			continue;
+		}
+
+		GLStateDeleteProgram(slot.program); // la version anterior (hot reload), si habia
+		slot.program = program;
+		++g_variants.stats.builds;
+	}
+
+	const int requested = g_variants.requested;
+	if (requested != g_variants.active && g_variants.slots[requested].program)
+	{
+		g_variants.active = requested;
+		++g_variants.stats.switches;
+	}
+}
+
+void ShaderVariantsRequest(int index)
+{
+	if (index < 0 || index >= kShaderVariantCount) return;
+	g_variants.requested = index;
+	if (!g_variants.slots[index].program) StartBuild(index);
+}
+
+int ShaderVariantsActive()
+{
+	return g_variants.active;
+}
+
+int ShaderVariantsRequested()
+{
+	return g_variants.requested;
+}
+
+GLuint ShaderVariantsProgram()
+{
+	return g_variants.slots[g_variants.active].program;
+}
+
+void ShaderVariantsReloadIfChanged()
+{
+	if (!g_variants.fileName || !ShaderFileChanged(g_variants.file)) return;
+	PROFILE_ZONE("ShaderVariantsReload");
+
+	ShaderFile updated;
+	if (!ShaderFileLoad(g_variants.fileName, &updated, nullptr)) return; // a mitad de un guardado
+	g_variants.file = std::move(updated);
+	fprintf(stderr, "shader changed: %s\n", g_variants.file.path.c_str());
+
+	for (int i = 0; i < kShaderVariantCount; ++i)
+	{
+		VariantSlot& slot = g_variants.slots[i];
+		if (!slot.wanted) continue;
+		if (slot.pending) slot.stale = true;
+		else StartBuild(i);
+	}
+}
+
+ShaderVariantStats ShaderVariantsStats()
+{
+	return g_variants.stats;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "cpu_renderer.h"
+#include "shader_program.h"
+
+#include <string>
+
+// ---------------------------
+// Variantes del programa de fondo
+// ---------------------------
+
+// shaders/fullscreen.glsl es una familia de programas: cada variante es el mismo archivo con otros
+// #defines (NOISE_OCTAVES, VIGNETTE, CHEAP_HASH). La tabla es constexpr: agregar un nivel de
+// calidad es agregar una fila.
+//
+// Cambiar de variante nunca bloquea el frame: ShaderVariantsRequest pide la nueva y se sigue
+// dibujando con la ultima lista hasta que termina de compilar (shader_program.h, compilacion
+// asincronica). Al arrancar se compilan todas en paralelo, asi que despues el cambio es inmediato.
+
+struct ShaderVariant
+{
+	const char* name;
+	int noiseOctaves;   // 1 = un solo noise() (el original); >1 = fbm
+	bool vignette;
+	bool cheapHash;     // hash aritmetico en vez de fract(sin(...))
+};
+
+static constexpr ShaderVariant kShaderVariants[] = {
+	{ "low",    1, false, true  },
+	{ "medium", 1, true,  false }, // el shader original: el que reproduce cpu_renderer (--golden)
+	{ "high",   3, true,  false },
+	{ "ultra",  5, true,  false },
+};
+
+static constexpr int kShaderVariantCount = (int)(sizeof(kShaderVariants) / sizeof(kShaderVariants[0]));
+static constexpr int kShaderVariantDefault = 1;
+
+static_assert(kShaderVariantDefault >= 0 && kShaderVariantDefault < kShaderVariantCount, "default variant out of range");
+static_assert(kShaderVariants[kShaderVariantDefault].noiseOctaves == 1 && kShaderVariants[kShaderVariantDefault].vignette &&
+	!kShaderVariants[kShaderVariantDefault].cheapHash, "the default variant must match cpu_renderer (golden test)");
+
+// Cada octava del fbm tiene su uniform de desplazamiento (uNoiseScroll, BackgroundTimeAt).
+constexpr bool ShaderVariantsOctavesFit(int i = 0)
+{
+	return i >= kShaderVariantCount ||
+		(kShaderVariants[i].noiseOctaves <= kBackgroundMaxOctaves && ShaderVariantsOctavesFit(i + 1));
+}
+static_assert(ShaderVariantsOctavesFit(), "a variant has more octaves than kBackgroundMaxOctaves");
+
+// Indice de la variante por nombre, -1 si no existe.
+int ShaderVariantFind(const char* name);
+
+// Bloque de #defines de la variante, listo para ShaderBuildProgram / ShaderBuildStart.
+std::string ShaderVariantDefines(const ShaderVariant& variant);
+
+// Carga el archivo, compila la variante 'initial' en el momento (hace falta para el primer frame)
+// y, con 'prewarm', lanza el resto en segundo plano. 'baseDefines' se agrega a todas las variantes
+// (p.ej. NoiseShaderDefines()). false + error si la inicial no compila.
+bool ShaderVariantsInit(const char* fileName, int initial, bool prewarm, const std::string& baseDefines, std::string* error);
+
+// ShaderVariantsInit en dos partes, para hacer otra cosa en el thread de render mientras compila
+// la inicial (en el worker o en los threads del driver): Begin carga el archivo y lanza la
+// inicial; End la espera y, con 'prewarm', lanza el resto. false + error como en Init.
+bool ShaderVariantsBegin(const char* fileName, int initial, const std::string& baseDefines, std::string* error);
+bool ShaderVariantsEnd(bool prewarm, std::string* error);
+
+// Espera los builds en vuelo y borra todos los programas (antes de destruir el contexto).
+void ShaderVariantsShutdown();
+
+// Una vez por frame: recoge los builds terminados y, si la variante pedida ya esta lista, la
+// activa. No bloquea.
+void ShaderVariantsUpdate();
+
+// Pide cambiar de variante. Si ya esta compilada el cambio ocurre en el proximo Update.
+void ShaderVariantsRequest(int index);
+int  ShaderVariantsActive();
+int  ShaderVariantsRequested();
+
+// Programa de la variante activa (cambia de ID cuando se activa otra o se recarga el archivo).
+GLuint ShaderVariantsProgram();
+
+// Hot reload: si el archivo cambio, recompila todas las variantes ya construidas en segundo plano.
+// Cada una reemplaza a la vieja cuando termina; si no compila, se queda la vieja y el error va a stderr.
+void ShaderVariantsReloadIfChanged();
+
+// Cambios de variante efectivos y builds terminados, para reportes.
+struct ShaderVariantStats
+{
+	int switches = 0;
+	int builds = 0;
+	int failures = 0;
+};
+
+ShaderVariantStats ShaderVariantsStats();
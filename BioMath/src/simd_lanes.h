@@ -0,0 +1,239 @@
+#pragma once
+
+#include "simd_math.h"
+
+#include <math.h>
+
+// ---------------------------
+// Lanes: un mismo codigo para 1, 4, 8 o 16 floats
+// ---------------------------
+
+// Envoltorios con operadores para escribir un kernel una sola vez como template y compilarlo por
+// ancho: F1 (float), F4 (SSE2), F8 (AVX2, solo en unidades compiladas con -mavx2 o en MSVC), F16
+// (AVX-512F, solo con -mavx512f o en MSVC) y D1 (double, para referencias de precision). Cada
+// operacion es exactamente una instruccion del ancho correspondiente (sin FMA, Min/Max con la
+// semantica de minps/maxps; Sqrt es correctamente redondeada en todos), asi que el mismo template
+// da los mismos bits con F1, F4, F8 y F16. Floor/Fract/Sin/Exp/Log son las de simd_math.h.
+//
+// Las mascaras (comparaciones) son bool en F1/D1, el registro de comparacion en F4/F8 y un
+// __mmask16 en F16.
+
+namespace lanes
+{
+	// ---- F1: float ----
+
+	struct F1
+	{
+		typedef float Scalar;
+		typedef bool Mask;
+		static constexpr int kWidth = 1;
+
+		float v;
+		F1() = default;
+		F1(float x) : v(x) {}
+
+		static F1 Load(const float* p) { return F1(*p); }
+		void Store(float* p) const { *p = v; }
+	};
+
+	static inline F1 operator+(F1 a, F1 b) { return F1(a.v + b.v); }
+	static inline F1 operator-(F1 a, F1 b) { return F1(a.v - b.v); }
+	static inline F1 operator*(F1 a, F1 b) { return F1(a.v * b.v); }
+	static inline F1 operator/(F1 a, F1 b) { return F1(a.v / b.v); }
+	static inline bool operator<(F1 a, F1 b) { return a.v < b.v; }
+	static inline bool operator<=(F1 a, F1 b) { return a.v <= b.v; }
+	static inline F1 Min(F1 a, F1 b) { return F1(a.v < b.v ? a.v : b.v); }
+	static inline F1 Max(F1 a, F1 b) { return F1(a.v > b.v ? a.v : b.v); }
+	static inline F1 Abs(F1 a) { return F1(fabsf(a.v)); }
+	static inline F1 Sqrt(F1 a) { return F1(sqrtf(a.v)); }
+	static inline F1 Exp(F1 a) { return F1(simd::Exp(a.v)); }
+	static inline F1 Log(F1 a) { return F1(simd::Log(a.v)); }
+	static inline F1 Floor(F1 a) { return F1(floorf(a.v)); }
+	static inline F1 Fract(F1 a) { return F1(a.v - floorf(a.v)); }
+	static inline F1 Sin(F1 a) { return F1(simd::Sin(a.v)); }
+	static inline F1 Select(bool m, F1 a, F1 b) { return m ? a : b; }
+	static inline bool Any(bool m) { return m; }
+	static inline int Count(bool m) { return m ? 1 : 0; }
+
+	// ---- D1: double (referencia) ----
+
+	struct D1
+	{
+		typedef double Scalar;
+		typedef bool Mask;
+		static constexpr int kWidth = 1;
+
+		double v;
+		D1() = default;
+		D1(double x) : v(x) {}
+
+		static D1 Load(const double* p) { return D1(*p); }
+		void Store(double* p) const { *p = v; }
+	};
+
+	static inline D1 operator+(D1 a, D1 b) { return D1(a.v + b.v); }
+	static inline D1 operator-(D1 a, D1 b) { return D1(a.v - b.v); }
+	static inline D1 operator*(D1 a, D1 b) { return D1(a.v * b.v); }
+	static inline D1 operator/(D1 a, D1 b) { return D1(a.v / b.v); }
+	static inline bool operator<(D1 a, D1 b) { return a.v < b.v; }
+	static inline bool operator<=(D1 a, D1 b) { return a.v <= b.v; }
+	static inline D1 Min(D1 a, D1 b) { return D1(a.v < b.v ? a.v : b.v); }
+	static inline D1 Max(D1 a, D1 b) { return D1(a.v > b.v ? a.v : b.v); }
+	static inline D1 Abs(D1 a) { return D1(fabs(a.v)); }
+	static inline D1 Sqrt(D1 a) { return D1(sqrt(a.v)); }
+	static inline D1 Exp(D1 a) { return D1(exp(a.v)); }
+	static inline D1 Log(D1 a) { return D1(log(a.v)); }
+	static inline D1 Select(bool m, D1 a, D1 b) { return m ? a : b; }
+
+	// ---- F4: SSE2 ----
+
+	struct M4
+	{
+		__m128 v;
+	};
+
+	struct F4
+	{
+		typedef float Scalar;
+		typedef M4 Mask;
+		static constexpr int kWidth = 4;
+
+		__m128 v;
+		F4() = default;
+		F4(__m128 x) : v(x) {}
+		F4(float x) : v(_mm_set1_ps(x)) {}
+
+		static F4 Load(const float* p) { return F4(_mm_loadu_ps(p)); }
+		void Store(float* p) const { _mm_storeu_ps(p, v); }
+	};
+
+	static inline F4 operator+(F4 a, F4 b) { return F4(_mm_add_ps(a.v, b.v)); }
+	static inline F4 operator-(F4 a, F4 b) { return F4(_mm_sub_ps(a.v, b.v)); }
+	static inline F4 operator*(F4 a, F4 b) { return F4(_mm_mul_ps(a.v, b.v)); }
+	static inline F4 operator/(F4 a, F4 b) { return F4(_mm_div_ps(a.v, b.v)); }
+	static inline M4 operator<(F4 a, F4 b) { return M4{ _mm_cmplt_ps(a.v, b.v) }; }
+	static inline M4 operator<=(F4 a, F4 b) { return M4{ _mm_cmple_ps(a.v, b.v) }; }
+	static inline M4 operator&(M4 a, M4 b) { return M4{ _mm_and_ps(a.v, b.v) }; }
+	static inline M4 operator|(M4 a, M4 b) { return M4{ _mm_or_ps(a.v, b.v) }; }
+	static inline F4 Min(F4 a, F4 b) { return F4(_mm_min_ps(a.v, b.v)); }
+	static inline F4 Max(F4 a, F4 b) { return F4(_mm_max_ps(a.v, b.v)); }
+	static inline F4 Abs(F4 a) { return F4(_mm_and_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)))); }
+	static inline F4 Sqrt(F4 a) { return F4(_mm_sqrt_ps(a.v)); }
+	static inline F4 Exp(F4 a) { return F4(simd::Exp(a.v)); }
+	static inline F4 Log(F4 a) { return F4(simd::Log(a.v)); }
+	static inline F4 Floor(F4 a)
+	{
+		// simd::Floor de SSE2 vale para |x| < 2^31; desde 2^23 todo float ya es entero (y NaN pasa igual).
+		const __m128 small = _mm_cmplt_ps(Abs(a).v, _mm_set1_ps(8388608.0f));
+		return F4(_mm_or_ps(_mm_and_ps(small, simd::Floor(a.v)), _mm_andnot_ps(small, a.v)));
+	}
+	static inline F4 Fract(F4 a) { return a - Floor(a); }
+	static inline F4 Sin(F4 a) { return F4(simd::Sin(a.v)); }
+	static inline F4 Select(M4 m, F4 a, F4 b) { return F4(_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))); }
+	static inline bool Any(M4 m) { return _mm_movemask_ps(m.v) != 0; }
+	static inline int Count(M4 m)
+	{
+		const int bits = _mm_movemask_ps(m.v);
+		return (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1);
+	}
+
+	// ---- F8: AVX2 ----
+
+#if defined(_MSC_VER) || defined(__AVX2__)
+	struct M8
+	{
+		__m256 v;
+	};
+
+	struct F8
+	{
+		typedef float Scalar;
+		typedef M8 Mask;
+		static constexpr int kWidth = 8;
+
+		__m256 v;
+		F8() = default;
+		F8(__m256 x) : v(x) {}
+		F8(float x) : v(_mm256_set1_ps(x)) {}
+
+		static F8 Load(const float* p) { return F8(_mm256_loadu_ps(p)); }
+		void Store(float* p) const { _mm256_storeu_ps(p, v); }
+	};
+
+	static inline F8 operator+(F8 a, F8 b) { return F8(_mm256_add_ps(a.v, b.v)); }
+	static inline F8 operator-(F8 a, F8 b) { return F8(_mm256_sub_ps(a.v, b.v)); }
+	static inline F8 operator*(F8 a, F8 b) { return F8(_mm256_mul_ps(a.v, b.v)); }
+	static inline F8 operator/(F8 a, F8 b) { return F8(_mm256_div_ps(a.v, b.v)); }
+	static inline M8 operator<(F8 a, F8 b) { return M8{ _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+	static inline M8 operator<=(F8 a, F8 b) { return M8{ _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) }; }
+	static inline M8 operator&(M8 a, M8 b) { return M8{ _mm256_and_ps(a.v, b.v) }; }
+	static inline M8 operator|(M8 a, M8 b) { return M8{ _mm256_or_ps(a.v, b.v) }; }
+	static inline F8 Min(F8 a, F8 b) { return F8(_mm256_min_ps(a.v, b.v)); }
+	static inline F8 Max(F8 a, F8 b) { return F8(_mm256_max_ps(a.v, b.v)); }
+	static inline F8 Abs(F8 a) { return F8(_mm256_and_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)))); }
+	static inline F8 Sqrt(F8 a) { return F8(_mm256_sqrt_ps(a.v)); }
+	static inline F8 Exp(F8 a) { return F8(simd::Exp(a.v)); }
+	static inline F8 Log(F8 a) { return F8(simd::Log(a.v)); }
+	static inline F8 Floor(F8 a) { return F8(simd::Floor(a.v)); }
+	static inline F8 Fract(F8 a) { return F8(simd::Fract(a.v)); }
+	static inline F8 Sin(F8 a) { return F8(simd::Sin(a.v)); }
+	static inline F8 Select(M8 m, F8 a, F8 b) { return F8(_mm256_blendv_ps(b.v, a.v, m.v)); }
+	static inline bool Any(M8 m) { return _mm256_movemask_ps(m.v) != 0; }
+	static inline int Count(M8 m)
+	{
+		int bits = _mm256_movemask_ps(m.v), n = 0;
+		for (; bits; bits &= bits - 1) ++n;
+		return n;
+	}
+#endif
+
+	// ---- F16: AVX-512F ----
+
+#if defined(_MSC_VER) || defined(__AVX512F__)
+	struct M16
+	{
+		__mmask16 v;
+	};
+
+	struct F16
+	{
+		typedef float Scalar;
+		typedef M16 Mask;
+		static constexpr int kWidth = 16;
+
+		__m512 v;
+		F16() = default;
+		F16(__m512 x) : v(x) {}
+		F16(float x) : v(_mm512_set1_ps(x)) {}
+
+		static F16 Load(const float* p) { return F16(_mm512_loadu_ps(p)); }
+		void Store(float* p) const { _mm512_storeu_ps(p, v); }
+	};
+
+	static inline F16 operator+(F16 a, F16 b) { return F16(_mm512_add_ps(a.v, b.v)); }
+	static inline F16 operator-(F16 a, F16 b) { return F16(_mm512_sub_ps(a.v, b.v)); }
+	static inline F16 operator*(F16 a, F16 b) { return F16(_mm512_mul_ps(a.v, b.v)); }
+	static inline F16 operator/(F16 a, F16 b) { return F16(_mm512_div_ps(a.v, b.v)); }
+	static inline M16 operator<(F16 a, F16 b) { return M16{ _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ) }; }
+	static inline M16 operator<=(F16 a, F16 b) { return M16{ _mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ) }; }
+	static inline M16 operator&(M16 a, M16 b) { return M16{ (__mmask16)(a.v & b.v) }; }
+	static inline M16 operator|(M16 a, M16 b) { return M16{ (__mmask16)(a.v | b.v) }; }
+	static inline F16 Min(F16 a, F16 b) { return F16(_mm512_min_ps(a.v, b.v)); }
+	static inline F16 Max(F16 a, F16 b) { return F16(_mm512_max_ps(a.v, b.v)); }
+	static inline F16 Abs(F16 a) { return F16(_mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(0x7FFFFFFF)))); }
+	static inline F16 Sqrt(F16 a) { return F16(_mm512_sqrt_ps(a.v)); }
+	static inline F16 Exp(F16 a) { return F16(simd::Exp(a.v)); }
+	static inline F16 Log(F16 a) { return F16(simd::Log(a.v)); }
+	static inline F16 Floor(F16 a) { return F16(simd::Floor(a.v)); }
+	static inline F16 Fract(F16 a) { return F16(simd::Fract(a.v)); }
+	static inline F16 Sin(F16 a) { return F16(simd::Sin(a.v)); }
+	static inline F16 Select(M16 m, F16 a, F16 b) { return F16(_mm512_mask_blend_ps(m.v, b.v, a.v)); }
+	static inline bool Any(M16 m) { return m.v != 0; }
+	static inline int Count(M16 m)
+	{
+		int bits = m.v, n = 0;
+		for (; bits; bits &= bits - 1) ++n;
+		return n;
+	}
+#endif
+}
@@ -0,0 +1,452 @@
+#pragma once
+
+// ---------------------------
+// Funciones matematicas SIMD
+// ---------------------------
+
+// Versiones vectoriales de las pocas funciones de GLSL que usamos en CPU (sin, floor, fract) y de
+// exp/log para los modelos de ode_ensemble.h.
+// sin() es la aproximacion de Cephes: reduccion de rango Cody-Waite a [-pi/4, pi/4] y polinomios
+// minimax de seno/coseno. Error ~1 ulp para |x| < 8192, mas que suficiente para mirar un shader.
+// exp() y log() tambien son las de Cephes (expf/logf): ~1-2 ulp. Exp satura el argumento a
+// [-87, 88] (sin infinitos ni denormales); Log espera x > 0 (satura a FLT_MIN).
+//
+// Importante: nada de FMA aca. El hash del shader (fract(sin(x) * 43758.5)) amplifica cualquier
+// diferencia de redondeo: 1 ulp en sin() ya cambia el hash en ~3e-3, y si cae cerca de un entero
+// el fract() salta de 0.999 a 0.001. Por eso hay una version escalar de Sin() con exactamente las
+// mismas operaciones: todos los caminos de CPU dan resultados identicos bit a bit.
+
+#include <emmintrin.h>
+#include <math.h>
+#include <string.h>
+#if defined(_MSC_VER) || defined(__AVX2__) || defined(__AVX512F__)
+	#include <immintrin.h>
+#endif
+
+namespace simd
+{
+	// ---- Escalar (mismas operaciones que las versiones vectoriales) ----
+
+	static inline float Sin(float x)
+	{
+		float sign = x < 0.0f ? -1.0f : 1.0f;
+		x = x < 0.0f ? -x : x;
+
+		int j = (int)(x * 1.27323954473516f);
+		j = (j + 1) & ~1;
+		const float y = (float)j;
+
+		if (j & 4) sign = -sign;
+		const bool useSin = (j & 2) == 0;
+
+		x = x + y * -0.78515625f;
+		x = x + y * -2.4187564849853515625e-4f;
+		x = x + y * -3.77489497744594108e-8f;
+
+		const float z = x * x;
+		float r;
+		if (useSin)
+		{
+			float s = -1.9515295891e-4f;
+			s = s * z + 8.3321608736e-3f;
+			s = s * z + -1.6666654611e-1f;
+			r = s * z * x + x;
+		}
+		else
+		{
+			float c = 2.443315711809948e-5f;
+			c = c * z + -1.388731625493765e-3f;
+			c = c * z + 4.166664568298827e-2f;
+			c = c * z * z;
+			c = c - z * 0.5f;
+			r = c + 1.0f;
+		}
+		return r * sign;
+	}
+
+	static const float kExpMin = -87.0f;
+	static const float kExpMax = 88.0f;
+
+	static inline float Exp(float x)
+	{
+		x = x < kExpMax ? x : kExpMax;
+		x = x > kExpMin ? x : kExpMin;
+
+		// x = n*ln2 + r, |r| <= ln2/2, con ln2 en dos partes.
+		const float fx = floorf(x * 1.44269504088896341f + 0.5f);
+		x = x - fx * 0.693359375f;
+		x = x - fx * -2.12194440e-4f;
+
+		const float z = x * x;
+		float y = 1.9875691500e-4f;
+		y = y * x + 1.3981999507e-3f;
+		y = y * x + 8.3334519073e-3f;
+		y = y * x + 4.1665795894e-2f;
+		y = y * x + 1.6666665459e-1f;
+		y = y * x + 5.0000001201e-1f;
+		y = y * z + x;
+		y = y + 1.0f;
+
+		// 2^n armando el exponente a mano.
+		const int bits = ((int)fx + 127) << 23;
+		float pow2;
+		memcpy(&pow2, &bits, sizeof(pow2));
+		return y * pow2;
+	}
+
+	static inline float Log(float x)
+	{
+		x = x > 1.17549435e-38f ? x : 1.17549435e-38f;
+
+		// x = m * 2^e con m en [0.5, 1); si m < sqrt(1/2) se usa 2m y e - 1.
+		int bits;
+		memcpy(&bits, &x, sizeof(bits));
+		float e = (float)((bits >> 23) - 126);
+		bits = (bits & 0x807FFFFF) | 0x3F000000;
+		float m;
+		memcpy(&m, &bits, sizeof(m));
+		const bool small = m < 0.707106781186547524f;
+		e = e - (small ? 1.0f : 0.0f);
+		x = (m - 1.0f) + (small ? m : 0.0f);
+
+		const float z = x * x;
+		float y = 7.0376836292e-2f;
+		y = y * x + -1.1514610310e-1f;
+		y = y * x + 1.1676998740e-1f;
+		y = y * x + -1.2420140846e-1f;
+		y = y * x + 1.4249322787e-1f;
+		y = y * x + -1.6668057665e-1f;
+		y = y * x + 2.0000714765e-1f;
+		y = y * x + -2.4999993993e-1f;
+		y = y * x + 3.3333331174e-1f;
+		y = (y * x) * z;
+		y = y + e * -2.12194440e-4f;
+		y = y - z * 0.5f;
+		x = x + y;
+		return x + e * 0.693359375f;
+	}
+
+	// ---- SSE2 (4 lanes) ----
+
+	static inline __m128 Floor(__m128 x)
+	{
+		// SSE2 no tiene roundps: truncamos y corregimos los negativos. Valido para |x| < 2^31.
+		const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+		const __m128 fix = _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f));
+		return _mm_sub_ps(t, fix);
+	}
+
+	static inline __m128 Fract(__m128 x)
+	{
+		return _mm_sub_ps(x, Floor(x));
+	}
+
+	static inline __m128 Clamp01(__m128 x)
+	{
+		return _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+	}
+
+	static inline __m128 Sin(__m128 x)
+	{
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+		__m128 sign = _mm_and_ps(x, signMask);
+		x = _mm_andnot_ps(signMask, x);
+
+		// j = (int)(x * 4/pi), redondeado al par siguiente.
+		__m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+		j = _mm_add_epi32(j, _mm_set1_epi32(1));
+		j = _mm_and_si128(j, _mm_set1_epi32(~1));
+		const __m128 y = _mm_cvtepi32_ps(j);
+
+		// Octantes 4..7 invierten el signo; octantes 2,3,6,7 usan el polinomio de coseno.
+		const __m128 swapSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+		const __m128 useSin = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+		sign = _mm_xor_ps(sign, swapSign);
+
+		// x - y*pi/4 en tres partes (Cody-Waite).
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+
+		const __m128 z = _mm_mul_ps(x, x);
+
+		__m128 c = _mm_set1_ps(2.443315711809948e-5f);
+		c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(-1.388731625493765e-3f));
+		c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(4.166664568298827e-2f));
+		c = _mm_mul_ps(_mm_mul_ps(c, z), z);
+		c = _mm_sub_ps(c, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+		c = _mm_add_ps(c, _mm_set1_ps(1.0f));
+
+		__m128 s = _mm_set1_ps(-1.9515295891e-4f);
+		s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(8.3321608736e-3f));
+		s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(-1.6666654611e-1f));
+		s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), x), x);
+
+		const __m128 r = _mm_or_ps(_mm_and_ps(useSin, s), _mm_andnot_ps(useSin, c));
+		return _mm_xor_ps(r, sign);
+	}
+
+	static inline __m128 Exp(__m128 x)
+	{
+		x = _mm_min_ps(x, _mm_set1_ps(kExpMax));
+		x = _mm_max_ps(x, _mm_set1_ps(kExpMin));
+
+		const __m128 fx = Floor(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f)), _mm_set1_ps(0.5f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(0.693359375f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(-2.12194440e-4f)));
+
+		const __m128 z = _mm_mul_ps(x, x);
+		__m128 y = _mm_set1_ps(1.9875691500e-4f);
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.3981999507e-3f));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(8.3334519073e-3f));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(4.1665795894e-2f));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.6666665459e-1f));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(5.0000001201e-1f));
+		y = _mm_add_ps(_mm_mul_ps(y, z), x);
+		y = _mm_add_ps(y, _mm_set1_ps(1.0f));
+
+		const __m128i n = _mm_add_epi32(_mm_cvttps_epi32(fx), _mm_set1_epi32(127));
+		return _mm_mul_ps(y, _mm_castsi128_ps(_mm_slli_epi32(n, 23)));
+	}
+
+	static inline __m128 Log(__m128 x)
+	{
+		x = _mm_max_ps(x, _mm_set1_ps(1.17549435e-38f));
+
+		const __m128i bits = _mm_castps_si128(x);
+		__m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126)));
+		const __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x807FFFFF)), _mm_set1_epi32(0x3F000000)));
+		const __m128 small = _mm_cmplt_ps(m, _mm_set1_ps(0.707106781186547524f));
+		e = _mm_sub_ps(e, _mm_and_ps(small, _mm_set1_ps(1.0f)));
+		x = _mm_add_ps(_mm_sub_ps(m, _mm_set1_ps(1.0f)), _mm_and_ps(small, m));
+
+		const __m128 z = _mm_mul_ps(x, x);
+		__m128 y = _mm_set1_ps(7.0376836292e-2f);
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.1514610310e-1f));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.1676998740e-1f));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.2420140846e-1f));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.4249322787e-1f));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.6668057665e-1f));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(2.0000714765e-1f));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-2.4999993993e-1f));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(3.3333331174e-1f));
+		y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+		y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+		y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+		x = _mm_add_ps(x, y);
+		return _mm_add_ps(x, _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+	}
+
+#if defined(_MSC_VER) || defined(__AVX2__)
+	// ---- AVX2 (8 lanes) ----
+	// Solo se puede llamar desde codigo que ya verifico GetCpuFeatures().avx2.
+
+	static inline __m256 Floor(__m256 x)
+	{
+		return _mm256_floor_ps(x);
+	}
+
+	static inline __m256 Fract(__m256 x)
+	{
+		return _mm256_sub_ps(x, _mm256_floor_ps(x));
+	}
+
+	static inline __m256 Clamp01(__m256 x)
+	{
+		return _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+	}
+
+	static inline __m256 Sin(__m256 x)
+	{
+		const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000));
+		__m256 sign = _mm256_and_ps(x, signMask);
+		x = _mm256_andnot_ps(signMask, x);
+
+		__m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)));
+		j = _mm256_add_epi32(j, _mm256_set1_epi32(1));
+		j = _mm256_and_si256(j, _mm256_set1_epi32(~1));
+		const __m256 y = _mm256_cvtepi32_ps(j);
+
+		const __m256 swapSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29));
+		const __m256 useSin = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+		sign = _mm256_xor_ps(sign, swapSign);
+
+		x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(-0.78515625f)));
+		x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(-2.4187564849853515625e-4f)));
+		x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(-3.77489497744594108e-8f)));
+
+		const __m256 z = _mm256_mul_ps(x, x);
+
+		__m256 c = _mm256_set1_ps(2.443315711809948e-5f);
+		c = _mm256_add_ps(_mm256_mul_ps(c, z), _mm256_set1_ps(-1.388731625493765e-3f));
+		c = _mm256_add_ps(_mm256_mul_ps(c, z), _mm256_set1_ps(4.166664568298827e-2f));
+		c = _mm256_mul_ps(_mm256_mul_ps(c, z), z);
+		c = _mm256_sub_ps(c, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+		c = _mm256_add_ps(c, _mm256_set1_ps(1.0f));
+
+		__m256 s = _mm256_set1_ps(-1.9515295891e-4f);
+		s = _mm256_add_ps(_mm256_mul_ps(s, z), _mm256_set1_ps(8.3321608736e-3f));
+		s = _mm256_add_ps(_mm256_mul_ps(s, z), _mm256_set1_ps(-1.6666654611e-1f));
+		s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(s, z), x), x);
+
+		const __m256 r = _mm256_blendv_ps(c, s, useSin);
+		return _mm256_xor_ps(r, sign);
+	}
+
+	static inline __m256 Exp(__m256 x)
+	{
+		x = _mm256_min_ps(x, _mm256_set1_ps(kExpMax));
+		x = _mm256_max_ps(x, _mm256_set1_ps(kExpMin));
+
+		const __m256 fx = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)), _mm256_set1_ps(0.5f)));
+		x = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(0.693359375f)));
+		x = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(-2.12194440e-4f)));
+
+		const __m256 z = _mm256_mul_ps(x, x);
+		__m256 y = _mm256_set1_ps(1.9875691500e-4f);
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.3981999507e-3f));
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(8.3334519073e-3f));
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(4.1665795894e-2f));
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.6666665459e-1f));
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(5.0000001201e-1f));
+		y = _mm256_add_ps(_mm256_mul_ps(y, z), x);
+		y = _mm256_add_ps(y, _mm256_set1_ps(1.0f));
+
+		const __m256i n = _mm256_add_epi32(_mm256_cvttps_epi32(fx), _mm256_set1_epi32(127));
+		return _mm256_mul_ps(y, _mm256_castsi256_ps(_mm256_slli_epi32(n, 23)));
+	}
+
+	static inline __m256 Log(__m256 x)
+	{
+		x = _mm256_max_ps(x, _mm256_set1_ps(1.17549435e-38f));
+
+		const __m256i bits = _mm256_castps_si256(x);
+		__m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+		const __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x807FFFFF)), _mm256_set1_epi32(0x3F000000)));
+		const __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+		e = _mm256_sub_ps(e, _mm256_and_ps(small, _mm256_set1_ps(1.0f)));
+		x = _mm256_add_ps(_mm256_sub_ps(m, _mm256_set1_ps(1.0f)), _mm256_and_ps(small, m));
+
+		const __m256 z = _mm256_mul_ps(x, x);
+		__m256 y = _mm256_set1_ps(7.0376836292e-2f);
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.1514610310e-1f));
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.1676998740e-1f));
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.2420140846e-1f));
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.4249322787e-1f));
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.6668057665e-1f));
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(2.0000714765e-1f));
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-2.4999993993e-1f));
+		y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(3.3333331174e-1f));
+		y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+		y = _mm256_add_ps(y, _mm256_mul_ps(e, _mm256_set1_ps(-2.12194440e-4f)));
+		y = _mm256_sub_ps(y, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+		x = _mm256_add_ps(x, y);
+		return _mm256_add_ps(x, _mm256_mul_ps(e, _mm256_set1_ps(0.693359375f)));
+	}
+#endif
+
+#if defined(_MSC_VER) || defined(__AVX512F__)
+	// ---- AVX-512F (16 lanes) ----
+	// Solo se puede llamar desde codigo que ya verifico GetCpuFeatures().avx512f. Las operaciones
+	// logicas de float (and/xor) son de AVX-512DQ: aca van por los enteros, que son de F.
+
+	static inline __m512 Floor(__m512 x)
+	{
+		return _mm512_roundscale_ps(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+	}
+
+	static inline __m512 Fract(__m512 x)
+	{
+		return _mm512_sub_ps(x, Floor(x));
+	}
+
+	static inline __m512 Sin(__m512 x)
+	{
+		const __m512i signMask = _mm512_set1_epi32((int)0x80000000);
+		__m512i sign = _mm512_and_si512(_mm512_castps_si512(x), signMask);
+		x = _mm512_castsi512_ps(_mm512_andnot_si512(signMask, _mm512_castps_si512(x)));
+
+		__m512i j = _mm512_cvttps_epi32(_mm512_mul_ps(x, _mm512_set1_ps(1.27323954473516f)));
+		j = _mm512_add_epi32(j, _mm512_set1_epi32(1));
+		j = _mm512_and_si512(j, _mm512_set1_epi32(~1));
+		const __m512 y = _mm512_cvtepi32_ps(j);
+
+		const __m512i swapSign = _mm512_slli_epi32(_mm512_and_si512(j, _mm512_set1_epi32(4)), 29);
+		const __mmask16 useSin = _mm512_testn_epi32_mask(j, _mm512_set1_epi32(2));
+		sign = _mm512_xor_si512(sign, swapSign);
+
+		x = _mm512_add_ps(x, _mm512_mul_ps(y, _mm512_set1_ps(-0.78515625f)));
+		x = _mm512_add_ps(x, _mm512_mul_ps(y, _mm512_set1_ps(-2.4187564849853515625e-4f)));
+		x = _mm512_add_ps(x, _mm512_mul_ps(y, _mm512_set1_ps(-3.77489497744594108e-8f)));
+
+		const __m512 z = _mm512_mul_ps(x, x);
+
+		__m512 c = _mm512_set1_ps(2.443315711809948e-5f);
+		c = _mm512_add_ps(_mm512_mul_ps(c, z), _mm512_set1_ps(-1.388731625493765e-3f));
+		c = _mm512_add_ps(_mm512_mul_ps(c, z), _mm512_set1_ps(4.166664568298827e-2f));
+		c = _mm512_mul_ps(_mm512_mul_ps(c, z), z);
+		c = _mm512_sub_ps(c, _mm512_mul_ps(z, _mm512_set1_ps(0.5f)));
+		c = _mm512_add_ps(c, _mm512_set1_ps(1.0f));
+
+		__m512 s = _mm512_set1_ps(-1.9515295891e-4f);
+		s = _mm512_add_ps(_mm512_mul_ps(s, z), _mm512_set1_ps(8.3321608736e-3f));
+		s = _mm512_add_ps(_mm512_mul_ps(s, z), _mm512_set1_ps(-1.6666654611e-1f));
+		s = _mm512_add_ps(_mm512_mul_ps(_mm512_mul_ps(s, z), x), x);
+
+		const __m512 r = _mm512_mask_blend_ps(useSin, c, s);
+		return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(r), sign));
+	}
+
+	static inline __m512 Exp(__m512 x)
+	{
+		x = _mm512_min_ps(x, _mm512_set1_ps(kExpMax));
+		x = _mm512_max_ps(x, _mm512_set1_ps(kExpMin));
+
+		const __m512 fx = Floor(_mm512_add_ps(_mm512_mul_ps(x, _mm512_set1_ps(1.44269504088896341f)), _mm512_set1_ps(0.5f)));
+		x = _mm512_sub_ps(x, _mm512_mul_ps(fx, _mm512_set1_ps(0.693359375f)));
+		x = _mm512_sub_ps(x, _mm512_mul_ps(fx, _mm512_set1_ps(-2.12194440e-4f)));
+
+		const __m512 z = _mm512_mul_ps(x, x);
+		__m512 y = _mm512_set1_ps(1.9875691500e-4f);
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(1.3981999507e-3f));
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(8.3334519073e-3f));
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(4.1665795894e-2f));
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(1.6666665459e-1f));
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(5.0000001201e-1f));
+		y = _mm512_add_ps(_mm512_mul_ps(y, z), x);
+		y = _mm512_add_ps(y, _mm512_set1_ps(1.0f));
+
+		const __m512i n = _mm512_add_epi32(_mm512_cvttps_epi32(fx), _mm512_set1_epi32(127));
+		return _mm512_mul_ps(y, _mm512_castsi512_ps(_mm512_slli_epi32(n, 23)));
+	}
+
+	static inline __m512 Log(__m512 x)
+	{
+		x = _mm512_max_ps(x, _mm512_set1_ps(1.17549435e-38f));
+
+		const __m512i bits = _mm512_castps_si512(x);
+		__m512 e = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(126)));
+		const __m512 m = _mm512_castsi512_ps(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32(0x807FFFFF)), _mm512_set1_epi32(0x3F000000)));
+		const __mmask16 small = _mm512_cmp_ps_mask(m, _mm512_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+		e = _mm512_mask_sub_ps(e, small, e, _mm512_set1_ps(1.0f));
+		const __m512 m1 = _mm512_sub_ps(m, _mm512_set1_ps(1.0f));
+		x = _mm512_mask_add_ps(m1, small, m1, m);
+
+		const __m512 z = _mm512_mul_ps(x, x);
+		__m512 y = _mm512_set1_ps(7.0376836292e-2f);
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(-1.1514610310e-1f));
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(1.1676998740e-1f));
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(-1.2420140846e-1f));
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(1.4249322787e-1f));
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(-1.6668057665e-1f));
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(2.0000714765e-1f));
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(-2.4999993993e-1f));
+		y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(3.3333331174e-1f));
+		y = _mm512_mul_ps(_mm512_mul_ps(y, x), z);
+		y = _mm512_add_ps(y, _mm512_mul_ps(e, _mm512_set1_ps(-2.12194440e-4f)));
+		y = _mm512_sub_ps(y, _mm512_mul_ps(z, _mm512_set1_ps(0.5f)));
+		x = _mm512_add_ps(x, y);
+		return _mm512_add_ps(x, _mm512_mul_ps(e, _mm512_set1_ps(0.693359375f)));
+	}
+#endif
+}
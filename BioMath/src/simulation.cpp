@@ -0,0 +1,215 @@
+#include "simulation.h"
+#include "agents_render.h"
+#include "frame_stats.h"
+#include "input.h"
+#include "ode_plot.h"
+#include "platform.h"
+#include "profiler.h"
+#include "reaction_diffusion_texture.h"
+#include "triple_buffer.h"
+
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+struct Simulation
+{
+	SimOptions options;
+	bool initialized = false;
+	uint64_t frequency = 1;
+	uint64_t periodTicks = 1;
+	double dt = 0.0;
+
+	std::thread thread;
+	std::atomic<bool> running{ false };
+
+	TripleBuffer<SimSnapshot> snapshots;
+
+	// Lo toca solo quien corre los ticks (el thread, o el loop en modo inline)
+	SimSnapshot state;
+	uint64_t phaseQuarters = 0;   // fase en cuartos de tick: timeScaleQuarters por tick
+
+	// Estadisticas: las escribe quien corre los ticks; se leen despues de SimShutdown.
+	std::vector<double> stepMs;
+	size_t stepCount = 0;
+	uint64_t lateTicks = 0;       // corridos para alcanzar (mas de uno vencido a la vez)
+	uint64_t skippedTicks = 0;    // descartados por atraso mayor a kSimMaxCatchUp
+	uint64_t published = 0;
+
+	// Render
+	uint64_t acquired = 0;
+	uint64_t framesWithoutNewTick = 0;
+};
+
+static Simulation g_sim;
+
+void ParseSimOptions(int argc, char** argv, SimOptions* opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--sim-hz") == 0 && i + 1 < argc)
+			opts->hz = atof(argv[++i]);
+		else if (strcmp(argv[i], "--sim-inline") == 0)
+			opts->threaded = false;
+	}
+
+	if (opts->hz < 10.0) opts->hz = 10.0;
+	if (opts->hz > 2000.0) opts->hz = 2000.0;
+}
+
+static void Publish()
+{
+	g_sim.snapshots.Write() = g_sim.state;
+	g_sim.snapshots.Publish();
+	++g_sim.published;
+}
+
+static void Step()
+{
+	PROFILE_ZONE("SimStep");
+	const uint64_t t0 = PlatformTicks();
+
+	InputBeginTick();
+	const InputState& input = InputGetState();
+
+	SimSnapshot& s = g_sim.state;
+	if (InputKeyPressed(input, PlatformKey::Up) && s.timeScaleQuarters < kSimTimeScaleMax) ++s.timeScaleQuarters;
+	if (InputKeyPressed(input, PlatformKey::Down) && s.timeScaleQuarters > 0) --s.timeScaleQuarters;
+	if (InputKeyPressed(input, PlatformKey::Tab)) ++s.variantSteps;
+	if (InputKeyPressed(input, PlatformKey::Escape)) s.quit = true;
+	if (InputKeyPressed(input, PlatformKey::F1)) s.hudHidden = !s.hudHidden;
+
+	s.previous = s.current;
+	++s.tick;
+	g_sim.phaseQuarters += (uint64_t)s.timeScaleQuarters;
+	s.current.time = (double)s.tick * g_sim.dt;
+	s.current.phase = (double)g_sim.phaseQuarters * g_sim.dt * 0.25;
+	s.inputEvents = InputConsumedEvents();
+
+	// El campo de reaccion-difusion, el ensamble de EDOs y los agentes avanzan con la misma velocidad
+	// que la fase (0 = congelado).
+	RdFieldTick(s.timeScaleQuarters);
+	OdePlotTick(s.timeScaleQuarters);
+	AgentsTick(s.timeScaleQuarters);
+
+	Publish();
+
+	const double ms = (double)(PlatformTicks() - t0) * 1000.0 / (double)g_sim.frequency;
+	g_sim.stepMs[g_sim.stepCount++ % kSimStepSamples] = ms;
+}
+
+// Corre los ticks vencidos a 'now': el tick k vence en originTicks + k * periodo.
+static void RunDue(uint64_t now)
+{
+	SimSnapshot& s = g_sim.state;
+	if (now < s.originTicks) return;
+
+	const uint64_t dueTick = (now - s.originTicks) / g_sim.periodTicks;
+	if (dueTick <= s.tick) return;
+
+	uint64_t pending = dueTick - s.tick;
+	if (pending > (uint64_t)kSimMaxCatchUp)
+	{
+		// Se descarta el tiempo que no se puede alcanzar: el origen avanza y la simulacion sigue
+		// desde donde estaba, igual de determinista (solo cambia cuando corre cada tick).
+		const uint64_t skip = pending - (uint64_t)kSimMaxCatchUp;
+		s.originTicks += skip * g_sim.periodTicks;
+		g_sim.skippedTicks += skip;
+		pending = (uint64_t)kSimMaxCatchUp;
+	}
+	if (pending > 1) g_sim.lateTicks += pending - 1;
+
+	for (uint64_t i = 0; i < pending; ++i)
+		Step();
+}
+
+static void SimMain()
+{
+	ProfilerSetThreadName("Simulation");
+	while (g_sim.running.load(std::memory_order_acquire))
+	{
+		// Solo sleep: un tick de error de ~0.1 ms no se ve (el render interpola) y no vale un core en spin.
+		PlatformSleepUntil(g_sim.state.originTicks + (g_sim.state.tick + 1) * g_sim.periodTicks);
+		RunDue(PlatformTicks());
+	}
+}
+
+bool SimInit(const SimOptions& opts)
+{
+	g_sim.options = opts;
+	g_sim.frequency = PlatformTickFrequency();
+	g_sim.periodTicks = (uint64_t)((double)g_sim.frequency / opts.hz + 0.5);
+	if (g_sim.periodTicks == 0) g_sim.periodTicks = 1;
+	g_sim.dt = 1.0 / opts.hz;
+	g_sim.stepMs.assign(kSimStepSamples, 0.0);
+
+	// Tick 0 publicado antes de arrancar: el render siempre tiene un snapshot valido.
+	g_sim.state = SimSnapshot();
+	g_sim.state.originTicks = PlatformTicks();
+	Publish();
+
+	g_sim.initialized = true;
+	if (opts.threaded)
+	{
+		g_sim.running.store(true, std::memory_order_release);
+		g_sim.thread = std::thread(SimMain);
+	}
+	return true;
+}
+
+void SimShutdown()
+{
+	if (!g_sim.initialized) return;
+	g_sim.initialized = false;
+	if (g_sim.thread.joinable())
+	{
+		g_sim.running.store(false, std::memory_order_release);
+		g_sim.thread.join();
+	}
+}
+
+const SimOptions& SimGetOptions()
+{
+	return g_sim.options;
+}
+
+void SimRunInline()
+{
+	if (!g_sim.options.threaded && g_sim.initialized)
+		RunDue(PlatformTicks());
+}
+
+const SimSnapshot& SimAcquire(uint64_t nowTicks, SimState* interpolated)
+{
+	if (g_sim.snapshots.Acquire()) ++g_sim.acquired;
+	else ++g_sim.framesWithoutNewTick;
+	const SimSnapshot& s = g_sim.snapshots.Read();
+
+	// Con el render un tick atrasado, el instante t cae entre previous (tick - 1) y current (tick).
+	double alpha = 1.0;
+	if (nowTicks > s.originTicks)
+	{
+		const double ticks = (double)(nowTicks - s.originTicks) / (double)g_sim.periodTicks;
+		alpha = ticks - (double)s.tick;
+	}
+	if (alpha < 0.0) alpha = 0.0;
+	if (alpha > 1.0) alpha = 1.0;
+
+	interpolated->time = s.previous.time + (s.current.time - s.previous.time) * alpha;
+	interpolated->phase = s.previous.phase + (s.current.phase - s.previous.phase) * alpha;
+	return s;
+}
+
+void WriteSimJson(FILE* f)
+{
+	const size_t samples = g_sim.stepCount < kSimStepSamples ? g_sim.stepCount : kSimStepSamples;
+	fprintf(f, "\"sim\": { \"mode\": \"%s\", \"hz\": %.1f, \"ticks\": %llu, \"late_ticks\": %llu, \"skipped_ticks\": %llu",
+		g_sim.options.threaded ? "thread" : "inline", g_sim.options.hz, (unsigned long long)g_sim.state.tick,
+		(unsigned long long)g_sim.lateTicks, (unsigned long long)g_sim.skippedTicks);
+	fprintf(f, ", \"snapshots_published\": %llu, \"snapshots_acquired\": %llu, \"frames_without_new_tick\": %llu, ",
+		(unsigned long long)g_sim.published, (unsigned long long)g_sim.acquired, (unsigned long long)g_sim.framesWithoutNewTick);
+	WriteTimingSummaryJson(f, "step_ms", SummarizeTimings(g_sim.stepMs.data(), samples));
+	fprintf(f, " }");
+}
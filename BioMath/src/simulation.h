@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+// ---------------------------
+// Simulacion a paso fijo
+// ---------------------------
+
+// La simulacion avanza de a ticks de duracion fija (1 / hz), en su propio thread, independiente
+// de la tasa de frames: el mismo tick da el mismo resultado en cualquier maquina. Cada tick
+// consume la entrada (InputBeginTick), avanza el estado y publica un snapshot inmutable por un
+// triple buffer (triple_buffer.h); el render nunca espera a la simulacion ni al reves.
+//
+// El snapshot trae el estado del tick y el del anterior. El render dibuja un tick atrasado: para
+// el instante t interpola entre los ticks floor(t) - 1 y floor(t), asi el movimiento es continuo
+// aunque la simulacion corra a otra tasa que la pantalla.
+//
+// Si la simulacion se atrasa (un paso caro, el thread sin CPU) corre los ticks pendientes sin
+// dormir, hasta kSimMaxCatchUp seguidos; mas atras que eso descarta tiempo en vez de entrar en
+// una espiral de ticks atrasados.
+//
+// --sim-hz N (default 120), --sim-inline: sin thread, el loop de render corre los ticks vencidos
+// en el punto de --input-sample (para comparar latencias y depurar).
+
+struct SimOptions
+{
+	double hz = 120.0;
+	bool threaded = true;
+};
+
+static const int kSimMaxCatchUp = 8;
+static const int kSimTimeScaleMax = 16;   // en cuartos: velocidad 0..4x
+static const size_t kSimStepSamples = 1 << 16;
+
+void ParseSimOptions(int argc, char** argv, SimOptions* opts);
+
+// Lo que se interpola. Tiempo y fase salen de contadores enteros (ticks), no de sumar dt.
+struct SimState
+{
+	double time = 0.0;    // segundos de simulacion
+	double phase = 0.0;   // tiempo de la animacion: avanza a timeScale (Up/Down)
+};
+
+struct SimSnapshot
+{
+	uint64_t tick = 0;
+	uint64_t originTicks = 0;     // PlatformTicks en que "hubiera corrido" el tick 0 (se corre al descartar)
+	SimState previous;            // estado del tick anterior
+	SimState current;
+	int timeScaleQuarters = 4;
+	uint32_t variantSteps = 0;    // Tab: el render pasa a la siguiente variante por cada uno
+	bool quit = false;            // Escape
+	bool hudHidden = false;       // F1 (hud.h)
+	uint64_t inputEvents = 0;     // eventos de entrada consumidos hasta este tick (InputFramePresented)
+};
+
+// Arranca el thread (o deja todo listo para SimRunInline). Llamar despues de InputInit.
+bool SimInit(const SimOptions& opts);
+void SimShutdown();
+const SimOptions& SimGetOptions();
+
+// Solo en modo inline: corre en el thread que llama los ticks vencidos. No hace nada con thread.
+void SimRunInline();
+
+// Render: toma el ultimo snapshot publicado (o se queda con el anterior) y lo interpola al
+// instante 'nowTicks'. La referencia vale hasta la proxima llamada.
+const SimSnapshot& SimAcquire(uint64_t nowTicks, SimState* interpolated);
+
+// "sim": { ... } para los reportes JSON. Despues de SimShutdown (las estadisticas son del thread).
+void WriteSimJson(FILE* f);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// ---------------------------
+// Cola SPSC sin locks
+// ---------------------------
+
+// Ring de capacidad fija para un productor y un consumidor (p.ej. loop principal -> thread de
+// audio). Ninguna operacion aloca, bloquea ni llama al sistema: se puede usar desde un callback
+// de tiempo real.
+//
+// head lo escribe solo el consumidor y tail solo el productor; cada uno lee el indice del otro con
+// acquire y publica el suyo con release, asi el elemento queda visible antes que el indice. Cada
+// lado cachea el ultimo indice que vio del otro para no tocar su linea de cache en cada operacion.
+// Los indices corren libres (uint32 con wraparound) y se enmascaran al indexar.
+
+template <typename T, uint32_t Capacity>
+struct SpscRing
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+	// Productor
+	bool TryPush(const T& item)
+	{
+		const uint32_t tail = tailIndex.load(std::memory_order_relaxed);
+		if (tail - headCache == Capacity)
+		{
+			headCache = headIndex.load(std::memory_order_acquire);
+			if (tail - headCache == Capacity) return false; // llena
+		}
+		items[tail & (Capacity - 1)] = item;
+		tailIndex.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumidor
+	bool TryPop(T* item)
+	{
+		const uint32_t head = headIndex.load(std::memory_order_relaxed);
+		if (head == tailCache)
+		{
+			tailCache = tailIndex.load(std::memory_order_acquire);
+			if (head == tailCache) return false; // vacia
+		}
+		*item = items[head & (Capacity - 1)];
+		headIndex.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Aproximado si se llama mientras el otro lado trabaja (solo para estadisticas).
+	uint32_t Size() const
+	{
+		return tailIndex.load(std::memory_order_acquire) - headIndex.load(std::memory_order_acquire);
+	}
+
+	// Productor y consumidor en lineas de cache separadas (sin false sharing). No tocar de afuera.
+	alignas(64) std::atomic<uint32_t> tailIndex{ 0 };
+	uint32_t headCache = 0;
+	alignas(64) std::atomic<uint32_t> headIndex{ 0 };
+	uint32_t tailCache = 0;
+	alignas(64) T items[Capacity];
+};
@@ -0,0 +1,229 @@
+#include "startup.h"
+#include "platform.h"
+#include "profiler.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// El origen de los tiempos es la inicializacion de estaticos, lo mas cerca del arranque del
+// proceso que se puede medir sin ayuda del sistema.
+static const uint64_t g_processStart = PlatformTicks();
+
+static double MsSinceStart(uint64_t ticks)
+{
+	return (double)(ticks - g_processStart) * 1000.0 / (double)PlatformTickFrequency();
+}
+
+static double NowMs()
+{
+	return MsSinceStart(PlatformTicks());
+}
+
+struct StartupTaskState
+{
+	const char* name = nullptr;
+	std::function<void()> fn;
+	std::vector<StartupTask> deps;
+	bool taken = false;
+	bool done = false;
+	int worker = -1;
+	double startMs = 0.0;
+	double endMs = 0.0;
+	double waitedMs = 0.0;   // lo que el thread principal la espero
+};
+
+struct StartupPhaseRecord
+{
+	const char* name;
+	double startMs;
+	double endMs;
+};
+
+struct StartupGraph
+{
+	std::vector<StartupTaskState> tasks;
+	std::vector<StartupPhaseRecord> phases;
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable ready;     // una tarea termino (desbloquea dependientes y esperas)
+	int workerCount = 0;
+	double launchMs = 0.0;
+	double firstFrameMs = 0.0;
+	bool launched = false;
+};
+
+static StartupGraph g_startup;
+
+StartupTask StartupAdd(const char* name, std::function<void()> fn, std::initializer_list<StartupTask> deps)
+{
+	StartupTaskState task;
+	task.name = name;
+	task.fn = std::move(fn);
+	for (StartupTask d : deps)
+		if (d != kStartupNone) task.deps.push_back(d);
+	g_startup.tasks.push_back(std::move(task));
+	return (StartupTask)g_startup.tasks.size() - 1;
+}
+
+// La primera tarea sin tomar cuyas dependencias terminaron, o -1. Con el mutex tomado.
+static int NextReady(bool* pending)
+{
+	*pending = false;
+	for (size_t i = 0; i < g_startup.tasks.size(); ++i)
+	{
+		StartupTaskState& t = g_startup.tasks[i];
+		if (t.taken) continue;
+		*pending = true;
+		bool ready = true;
+		for (StartupTask d : t.deps)
+			ready = ready && g_startup.tasks[d].done;
+		if (ready) return (int)i;
+	}
+	return -1;
+}
+
+static void StartupWorkerMain(int index)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "Startup %d", index);
+	ProfilerSetThreadName(name);
+
+	std::unique_lock<std::mutex> lock(g_startup.mutex);
+	for (;;)
+	{
+		bool pending = false;
+		int next = -1;
+		g_startup.ready.wait(lock, [&] { next = NextReady(&pending); return next >= 0 || !pending; });
+		if (next < 0) return;   // no queda nada por tomar
+
+		StartupTaskState& t = g_startup.tasks[next];
+		t.taken = true;
+		t.worker = index;
+		t.startMs = NowMs();
+		lock.unlock();
+		{
+			PROFILE_ZONE(t.name);
+			t.fn();
+		}
+		lock.lock();
+		t.endMs = NowMs();
+		t.done = true;
+		g_startup.ready.notify_all();
+	}
+}
+
+void StartupLaunch()
+{
+	if (g_startup.launched) return;
+	g_startup.launched = true;
+	g_startup.launchMs = NowMs();
+
+	// Aunque haya un solo core conviene un worker: el thread principal pasa buena parte de la
+	// creacion del contexto esperando al driver y al sistema de ventanas.
+	unsigned hc = std::thread::hardware_concurrency();
+	size_t count = hc > 2 ? hc : 2;
+	if (count > g_startup.tasks.size()) count = g_startup.tasks.size();
+	g_startup.workerCount = (int)count;
+	for (size_t i = 0; i < count; ++i)
+		g_startup.workers.emplace_back(StartupWorkerMain, (int)i);
+}
+
+void StartupWait(StartupTask task)
+{
+	if (task == kStartupNone || task >= (StartupTask)g_startup.tasks.size()) return;
+	const double t0 = NowMs();
+	{
+		std::unique_lock<std::mutex> lock(g_startup.mutex);
+		StartupTaskState& t = g_startup.tasks[task];
+		if (!g_startup.launched)
+		{
+			// Sin StartupLaunch (p. ej. un modo que no lanza el grafo): la tarea corre aca.
+			lock.unlock();
+			StartupLaunch();
+			lock.lock();
+		}
+		g_startup.ready.wait(lock, [&] { return t.done; });
+		t.waitedMs += NowMs() - t0;
+	}
+}
+
+bool StartupDone(StartupTask task)
+{
+	if (task == kStartupNone || task >= (StartupTask)g_startup.tasks.size()) return true;
+	std::lock_guard<std::mutex> lock(g_startup.mutex);
+	return g_startup.tasks[task].done;
+}
+
+void StartupJoin()
+{
+	for (std::thread& t : g_startup.workers)
+		t.join();
+	g_startup.workers.clear();
+}
+
+StartupPhase::StartupPhase(const char* phaseName)
+	: name(phaseName), startMs(NowMs())
+{
+}
+
+StartupPhase::~StartupPhase()
+{
+	g_startup.phases.push_back({ name, startMs, NowMs() });
+}
+
+void StartupFirstFrame()
+{
+	if (g_startup.firstFrameMs == 0.0)
+		g_startup.firstFrameMs = NowMs();
+}
+
+double StartupTimeToFirstFrameMs()
+{
+	return g_startup.firstFrameMs;
+}
+
+static void WriteJsonString(FILE* f, const char* s)
+{
+	fputc('"', f);
+	for (; *s; ++s)
+	{
+		if (*s == '"' || *s == '\\') fputc('\\', f);
+		fputc(*s, f);
+	}
+	fputc('"', f);
+}
+
+void WriteStartupJson(FILE* f)
+{
+	std::lock_guard<std::mutex> lock(g_startup.mutex);
+
+	double waited = 0.0;
+	for (const StartupTaskState& t : g_startup.tasks)
+		waited += t.waitedMs;
+
+	fprintf(f, "\"startup\": { \"ttff_ms\": %.3f, \"launch_ms\": %.3f, \"workers\": %d, \"main_waited_ms\": %.3f, \"tasks\": [",
+		g_startup.firstFrameMs, g_startup.launchMs, g_startup.workerCount, waited);
+	for (size_t i = 0; i < g_startup.tasks.size(); ++i)
+	{
+		const StartupTaskState& t = g_startup.tasks[i];
+		fprintf(f, "%s{ \"name\": ", i ? ", " : " ");
+		WriteJsonString(f, t.name);
+		if (t.done)
+			fprintf(f, ", \"worker\": %d, \"start_ms\": %.3f, \"end_ms\": %.3f, \"waited_ms\": %.3f }",
+				t.worker, t.startMs, t.endMs, t.waitedMs);
+		else
+			fprintf(f, ", \"done\": false }");
+	}
+	fprintf(f, " ], \"main\": [");
+	for (size_t i = 0; i < g_startup.phases.size(); ++i)
+	{
+		const StartupPhaseRecord& p = g_startup.phases[i];
+		fprintf(f, "%s{ \"name\": ", i ? ", " : " ");
+		WriteJsonString(f, p.name);
+		fprintf(f, ", \"start_ms\": %.3f, \"end_ms\": %.3f }", p.startMs, p.endMs);
+	}
+	fprintf(f, " ] }");
+}
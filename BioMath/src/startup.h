@@ -0,0 +1,67 @@
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <stdio.h>
+
+// ---------------------------
+// Arranque en paralelo
+// ---------------------------
+
+// El arranque es un grafo de tareas. Lo que no necesita contexto GL (leer los shaders, hornear o
+// mapear el ruido, sembrar las simulaciones, abrir el dispositivo de audio) corre en workers
+// desde el principio, mientras el thread principal crea la ventana y el contexto. El thread
+// principal espera cada tarea recien cuando necesita su resultado (StartupWait), justo antes de
+// la parte de GL que la usa (subir la textura, crear los buffers).
+//
+// Cada tarea y cada fase del thread principal queda registrada con su inicio y su fin, relativos
+// al arranque del proceso, junto con el tiempo hasta el primer frame presentado. El reporte va en
+// el JSON como "startup".
+//
+// Uso:
+//   StartupTask noise = StartupAdd("noise", [] { NoiseTexturePrepare(opts); });
+//   StartupLaunch();
+//   { StartupPhase phase("gl_context"); PlatformCreateGLContext(); }
+//   StartupWait(noise);
+//   NoiseTextureInit(opts);   // usa lo preparado
+//   ...
+//   StartupFirstFrame();      // despues del primer swap
+
+typedef int StartupTask;
+static const StartupTask kStartupNone = -1;
+
+// Registra una tarea para los workers. 'deps' tienen que haber terminado antes de que empiece.
+// Todas las tareas se agregan antes de StartupLaunch.
+StartupTask StartupAdd(const char* name, std::function<void()> fn, std::initializer_list<StartupTask> deps = {});
+
+// Arranca los workers (hasta uno por core, no mas que tareas). Vuelve enseguida.
+void StartupLaunch();
+
+// El thread principal espera a 'task' (no hace nada con kStartupNone). El tiempo esperado se
+// reporta: si es grande, esa tarea es la que marca el arranque.
+void StartupWait(StartupTask task);
+
+// true si 'task' ya termino (sin esperar). kStartupNone cuenta como terminada.
+bool StartupDone(StartupTask task);
+
+// Espera todas las tareas y libera los workers. Antes de apagar lo que las tareas inicializaron.
+void StartupJoin();
+
+// Fase del thread principal, para el reporte (RAII).
+struct StartupPhase
+{
+	explicit StartupPhase(const char* name);
+	~StartupPhase();
+
+	const char* name;
+	double startMs;
+};
+
+// Marca el primer frame presentado (la primera vez; despues no hace nada).
+void StartupFirstFrame();
+
+// ms desde el arranque del proceso hasta StartupFirstFrame (0 si todavia no paso).
+double StartupTimeToFirstFrameMs();
+
+// "startup": { ... } para los reportes JSON.
+void WriteStartupJson(FILE* f);
@@ -0,0 +1,212 @@
+#include "stream_buffer.h"
+#include "gl_state.h"
+#include "platform.h"
+
+#include <string.h>
+
+// Offsets de segmento alineados: sirven para atributos, UBOs (GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+// es <= 256 en todo lo que conocemos) y copias a texturas.
+static const size_t kStreamAlign = 256;
+
+// glClientWaitSync espera de a esto (ns) para poder contar el tiempo y no colgarse para siempre.
+static const GLuint64 kStreamWaitSliceNs = 1000000;
+
+static const GLbitfield kPersistentFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+const char* StreamBufferModeName(StreamBufferMode mode)
+{
+	switch (mode)
+	{
+	case StreamBufferMode::Auto:       return "auto";
+	case StreamBufferMode::Persistent: return "persistent";
+	case StreamBufferMode::Orphan:     return "orphan";
+	}
+	return "?";
+}
+
+bool StreamBufferModeFind(const char* name, StreamBufferMode* mode)
+{
+	if (strcmp(name, "auto") == 0) *mode = StreamBufferMode::Auto;
+	else if (strcmp(name, "persistent") == 0) *mode = StreamBufferMode::Persistent;
+	else if (strcmp(name, "orphan") == 0) *mode = StreamBufferMode::Orphan;
+	else return false;
+	return true;
+}
+
+bool StreamBufferPersistentSupported()
+{
+	// Los punteros solos no alcanzan: glXGetProcAddress devuelve algo hasta para funciones que el
+	// contexto no tiene.
+	if (!glBufferStorage_ptr || !glMapBufferRange_ptr || !glFenceSync_ptr || !glClientWaitSync_ptr || !glDeleteSync_ptr)
+		return false;
+	return GLVersionAtLeast(4, 4) || GLHasExtension("GL_ARB_buffer_storage");
+}
+
+static double MsSince(uint64_t startTicks)
+{
+	return (double)(PlatformTicks() - startTicks) * 1000.0 / (double)PlatformTickFrequency();
+}
+
+static bool InitPersistent(StreamBuffer* sb)
+{
+	const size_t total = sb->segmentBytes * kStreamSegments;
+	glGenBuffers_ptr(1, &sb->buffer);
+	GLStateBindBuffer(sb->target, sb->buffer);
+	glBufferStorage_ptr(sb->target, (GLsizeiptr)total, nullptr, kPersistentFlags);
+	sb->mapped = (uint8_t*)glMapBufferRange_ptr(sb->target, 0, (GLsizeiptr)total, kPersistentFlags);
+
+	const GLenum glError = glGetError();
+	if (!sb->mapped || glError != GL_NO_ERROR)
+	{
+		fprintf(stderr, "stream: persistent mapping failed (0x%04X), falling back to orphaning\n", glError);
+		GLStateDeleteBuffer(sb->buffer);
+		sb->buffer = 0;
+		sb->mapped = nullptr;
+		return false;
+	}
+	sb->mode = StreamBufferMode::Persistent;
+	sb->segments = kStreamSegments;
+	return true;
+}
+
+static bool InitOrphan(StreamBuffer* sb)
+{
+	if (!glMapBufferRange_ptr || !glUnmapBuffer_ptr)
+	{
+		fprintf(stderr, "stream: glMapBufferRange not available\n");
+		return false;
+	}
+	glGenBuffers_ptr(1, &sb->buffer);
+	GLStateBindBuffer(sb->target, sb->buffer);
+	glBufferData_ptr(sb->target, (GLsizeiptr)sb->segmentBytes, nullptr, GL_STREAM_DRAW);
+	sb->mode = StreamBufferMode::Orphan;
+	sb->segments = 1;
+	return true;
+}
+
+bool StreamBufferInit(StreamBuffer* sb, GLenum target, size_t bytes, StreamBufferMode mode)
+{
+	*sb = StreamBuffer();
+	sb->target = target;
+	sb->segmentBytes = (bytes + kStreamAlign - 1) / kStreamAlign * kStreamAlign;
+	if (sb->segmentBytes == 0) sb->segmentBytes = kStreamAlign;
+
+	if (mode != StreamBufferMode::Orphan)
+	{
+		if (StreamBufferPersistentSupported())
+		{
+			if (InitPersistent(sb)) return true;
+		}
+		else if (mode == StreamBufferMode::Persistent)
+		{
+			fprintf(stderr, "stream: ARB_buffer_storage not available, falling back to orphaning\n");
+		}
+	}
+	return InitOrphan(sb);
+}
+
+void StreamBufferShutdown(StreamBuffer* sb)
+{
+	for (GLsync& fence : sb->fences)
+	{
+		if (fence) glDeleteSync_ptr(fence);
+		fence = nullptr;
+	}
+	if (sb->buffer && sb->mapped)
+	{
+		GLStateBindBuffer(sb->target, sb->buffer);
+		glUnmapBuffer_ptr(sb->target);
+	}
+	GLStateDeleteBuffer(sb->buffer);
+	sb->buffer = 0;
+	sb->mapped = nullptr;
+}
+
+// Espera a que la GPU termine de leer el segmento. Lo normal es que el fence ya haya pasado.
+static void WaitSegment(StreamBuffer* sb, int segment)
+{
+	GLsync fence = sb->fences[segment];
+	if (!fence) return;
+
+	GLenum result = glClientWaitSync_ptr(fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		++sb->stalls;
+		const uint64_t t0 = PlatformTicks();
+		do
+			result = glClientWaitSync_ptr(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kStreamWaitSliceNs);
+		while (result == GL_TIMEOUT_EXPIRED);
+		sb->stallMs += MsSince(t0);
+	}
+	glDeleteSync_ptr(fence);
+	sb->fences[segment] = nullptr;
+}
+
+bool StreamBufferBegin(StreamBuffer* sb, StreamWrite* out)
+{
+	GLStateBindBuffer(sb->target, sb->buffer);
+
+	if (sb->mode == StreamBufferMode::Persistent)
+	{
+		const int segment = (sb->segment + 1) % kStreamSegments;
+		WaitSegment(sb, segment);
+		sb->segment = segment;
+		out->segment = segment;
+		out->offset = StreamBufferSegmentOffset(*sb, segment);
+		out->data = sb->mapped + out->offset;
+		return true;
+	}
+
+	// Orphan: storage nuevo (el viejo lo libera el driver cuando la GPU termina) y mapeo sin esperar.
+	glBufferData_ptr(sb->target, (GLsizeiptr)sb->segmentBytes, nullptr, GL_STREAM_DRAW);
+	sb->mapped = (uint8_t*)glMapBufferRange_ptr(sb->target, 0, (GLsizeiptr)sb->segmentBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (!sb->mapped)
+	{
+		++sb->mapFailures;
+		return false;
+	}
+	out->segment = 0;
+	out->offset = 0;
+	out->data = sb->mapped;
+	return true;
+}
+
+bool StreamBufferEnd(StreamBuffer* sb, size_t bytes)
+{
+	if (sb->mode == StreamBufferMode::Orphan)
+	{
+		GLStateBindBuffer(sb->target, sb->buffer);
+		const bool ok = glUnmapBuffer_ptr(sb->target) != GL_FALSE;
+		sb->mapped = nullptr;
+		if (!ok)
+		{
+			++sb->mapFailures; // el contenido se perdio: se dibuja lo que haya y se sube el proximo
+			return false;
+		}
+	}
+	++sb->writes;
+	sb->bytesWritten += bytes;
+	return true;
+}
+
+void StreamBufferFence(StreamBuffer* sb)
+{
+	if (sb->mode != StreamBufferMode::Persistent) return;
+	GLsync& fence = sb->fences[sb->segment];
+	if (fence) glDeleteSync_ptr(fence);
+	fence = glFenceSync_ptr(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+size_t StreamBufferSegmentOffset(const StreamBuffer& sb, int segment)
+{
+	return sb.segmentBytes * (size_t)segment;
+}
+
+void WriteStreamBufferJson(FILE* f, const StreamBuffer& sb)
+{
+	fprintf(f, "\"stream\": { \"mode\": \"%s\", \"segments\": %d, \"segment_bytes\": %llu, \"writes\": %llu, \"mb_written\": %.1f",
+		StreamBufferModeName(sb.mode), sb.segments, (unsigned long long)sb.segmentBytes, (unsigned long long)sb.writes,
+		(double)sb.bytesWritten / (1024.0 * 1024.0));
+	fprintf(f, ", \"stalls\": %llu, \"stall_ms\": %.3f, \"map_failures\": %llu }",
+		(unsigned long long)sb.stalls, sb.stallMs, (unsigned long long)sb.mapFailures);
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "gl_api.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// ---------------------------
+// Streaming de geometria dinamica
+// ---------------------------
+
+// Un buffer de GL que se reescribe entero cada vez que hay datos nuevos (puntos de las EDOs,
+// agentes), sin que el driver tenga que sincronizar implicitamente con la GPU.
+//
+// Modo Persistent (GL 4.4 / ARB_buffer_storage): un solo buffer inmutable de 3 segmentos,
+// mapeado una vez (PERSISTENT | COHERENT) y escrito directo desde la CPU. Cada escritura va al
+// segmento siguiente del anillo; despues del draw que lo lee se pone un fence, y antes de volver
+// a escribirlo se espera ese fence (si todavia no paso, es un stall: la GPU va 3 frames atras).
+// Sin map/unmap por frame ni copias del driver.
+//
+// Modo Orphan (fallback sin buffer storage o fences): un segmento; cada escritura huerfana el
+// storage anterior (glBufferData con null) y lo mapea con INVALIDATE: el driver da memoria nueva
+// si la GPU todavia lee la vieja. Es lo que hacian ode_plot y agents_render a mano.
+//
+// Uso por frame:
+//   StreamWrite w;
+//   if (StreamBufferBegin(&sb, &w)) { memcpy(w.data, src, n); StreamBufferEnd(&sb, n); }
+//   ... draw leyendo desde w.offset (o con el VAO del segmento sb.segment) ...
+//   StreamBufferFence(&sb);   // despues del ultimo draw que lee el segmento
+//
+// Los offsets de cada segmento son fijos, asi que quien dibuja puede armar un VAO por segmento
+// (StreamBufferSegmentOffset) y no reapuntar atributos cada frame.
+
+static const int kStreamSegments = 3;
+
+enum class StreamBufferMode
+{
+	Auto,        // Persistent si el contexto lo soporta, si no Orphan
+	Persistent,
+	Orphan,
+};
+
+const char* StreamBufferModeName(StreamBufferMode mode);
+bool StreamBufferModeFind(const char* name, StreamBufferMode* mode);   // "auto", "persistent", "orphan"
+
+// true si el contexto actual soporta el modo Persistent (buffer storage + fences).
+bool StreamBufferPersistentSupported();
+
+struct StreamBuffer
+{
+	GLenum target = GL_ARRAY_BUFFER;
+	GLuint buffer = 0;
+	StreamBufferMode mode = StreamBufferMode::Orphan;
+	size_t segmentBytes = 0;   // redondeado a 256 (alineacion de offsets de atributos y UBOs)
+	int segments = 1;          // kStreamSegments en Persistent, 1 en Orphan
+	int segment = 0;           // el ultimo escrito
+	uint8_t* mapped = nullptr; // Persistent: todo el buffer; Orphan: el segmento mientras esta mapeado
+	GLsync fences[kStreamSegments] = {};
+
+	// Estadisticas
+	uint64_t writes = 0;
+	uint64_t bytesWritten = 0;
+	uint64_t stalls = 0;          // Persistent: el fence del segmento no habia pasado todavia
+	double stallMs = 0.0;         // tiempo esperando esos fences
+	uint64_t mapFailures = 0;     // Orphan: map o unmap fallaron (ese frame no se subio)
+};
+
+struct StreamWrite
+{
+	void* data = nullptr;   // segmentBytes escribibles
+	size_t offset = 0;      // offset del segmento dentro del buffer
+	int segment = 0;
+};
+
+// Requiere contexto GL. 'bytes' = lo maximo que se escribe por vez. Auto elige Persistent si se
+// puede; si se pide Persistent y no hay soporte, cae a Orphan (con el motivo en stderr).
+bool StreamBufferInit(StreamBuffer* sb, GLenum target, size_t bytes, StreamBufferMode mode = StreamBufferMode::Auto);
+void StreamBufferShutdown(StreamBuffer* sb);
+
+// Avanza al segmento siguiente y lo deja listo para escribir (espera su fence si hace falta).
+// Deja el buffer bindeado a 'target'. false si no se pudo mapear (Orphan): no llamar a End.
+bool StreamBufferBegin(StreamBuffer* sb, StreamWrite* out);
+
+// Termina la escritura de Begin ('bytes' = lo escrito, para las estadisticas). Orphan: unmap.
+// false si el contenido se perdio.
+bool StreamBufferEnd(StreamBuffer* sb, size_t bytes);
+
+// Pone el fence del segmento actual. Despues del ultimo draw que lo lee (en cada frame que se
+// dibuje, aunque no se haya escrito: el fence nuevo reemplaza al anterior). No hace nada en Orphan.
+void StreamBufferFence(StreamBuffer* sb);
+
+size_t StreamBufferSegmentOffset(const StreamBuffer& sb, int segment);
+
+// "stream": { ... } dentro de la seccion JSON de quien lo usa.
+void WriteStreamBufferJson(FILE* f, const StreamBuffer& sb);
+
+// ---------------------------
+// Microbenchmark (BioMath --headless --stream-bench)
+// ---------------------------
+
+// Sube 'megabytes' MB por frame durante 'frames' frames y los dibuja como puntos en un FBO chico,
+// con cada camino: glBufferData con los datos (re-especifica el storage cada frame), Orphan
+// (glBufferData null + map INVALIDATE) y Persistent (anillo con fences). Reporta MB/s, ms por
+// subida (p50/p99), subidas que bloquearon mas de 1 ms y stalls de fence. JSON a 'jsonPath' o stdout.
+struct StreamBenchOptions
+{
+	bool enabled = false;
+	double megabytes = 16.0;
+	int frames = 300;
+	const char* jsonPath = nullptr;
+};
+
+// --stream-bench (lo prende), --stream-mb x, --frames N, --json path.
+void ParseStreamBenchOptions(int argc, char** argv, StreamBenchOptions* opts);
+
+// Requiere contexto GL. Devuelve el exit code (0 ok, 1 si no se pudo armar el FBO o el programa).
+int RunStreamBench(const StreamBenchOptions& opts);
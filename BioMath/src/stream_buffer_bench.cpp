@@ -0,0 +1,271 @@
+#include "stream_buffer.h"
+#include "frame_stats.h"
+#include "gl_state.h"
+#include "platform.h"
+#include "shader_program.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// FBO del benchmark: chico para que el costo sea la subida y no el raster.
+static const int kStreamBenchSize = 256;
+
+// Una subida "bloqueo" si tardo mas que esto por encima de un memcpy del mismo tamanio a memoria
+// propia: la diferencia es el driver esperando a la GPU (o copiando).
+static const double kStreamBlockedMs = 1.0;
+
+enum class StreamBenchPath
+{
+	BufferData,   // glBufferData(datos) por frame
+	Orphan,
+	Persistent,
+};
+
+static const char* StreamBenchPathName(StreamBenchPath path)
+{
+	switch (path)
+	{
+	case StreamBenchPath::BufferData: return "buffer_data";
+	case StreamBenchPath::Orphan:     return "orphan";
+	case StreamBenchPath::Persistent: return "persistent";
+	}
+	return "?";
+}
+
+struct StreamBenchResult
+{
+	StreamBenchPath path = StreamBenchPath::BufferData;
+	bool ran = false;
+	double wallSeconds = 0.0;
+	std::vector<double> uploadMs;
+	int blocked = 0;
+	StreamBuffer stream;   // estadisticas (Orphan/Persistent)
+};
+
+void ParseStreamBenchOptions(int argc, char** argv, StreamBenchOptions* opts)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* a = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (strcmp(a, "--stream-bench") == 0) opts->enabled = true;
+		else if (strcmp(a, "--stream-mb") == 0 && hasValue) opts->megabytes = atof(argv[++i]);
+		else if (strcmp(a, "--frames") == 0 && hasValue) opts->frames = atoi(argv[++i]);
+		else if (strcmp(a, "--json") == 0 && hasValue) opts->jsonPath = argv[++i];
+	}
+
+	if (opts->megabytes < 0.01) opts->megabytes = 0.01;
+	if (opts->megabytes > 256.0) opts->megabytes = 256.0;
+	if (opts->frames < 1) opts->frames = 1;
+}
+
+static double MsSince(uint64_t startTicks)
+{
+	return (double)(PlatformTicks() - startTicks) * 1000.0 / (double)PlatformTickFrequency();
+}
+
+static GLuint CreatePointsVao(GLuint buffer, size_t offset)
+{
+	GLuint vao = 0;
+	glGenVertexArrays_ptr(1, &vao);
+	GLStateBindVertexArray(vao);
+	GLStateBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glEnableVertexAttribArray_ptr(0);
+	glVertexAttribPointer_ptr(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)offset);
+	GLStateBindVertexArray(0);
+	return vao;
+}
+
+static void RunPath(StreamBenchResult* result, const std::vector<float>& points, int frames, double memcpyMs)
+{
+	const size_t bytes = points.size() * sizeof(float);
+	const GLsizei count = (GLsizei)(points.size() / 2);
+
+	GLuint buffer = 0;
+	GLuint vaos[kStreamSegments] = {};
+	if (result->path == StreamBenchPath::BufferData)
+	{
+		glGenBuffers_ptr(1, &buffer);
+		GLStateBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glBufferData_ptr(GL_ARRAY_BUFFER, (GLsizeiptr)bytes, nullptr, GL_STREAM_DRAW);
+		vaos[0] = CreatePointsVao(buffer, 0);
+	}
+	else
+	{
+		const StreamBufferMode mode = result->path == StreamBenchPath::Persistent ? StreamBufferMode::Persistent : StreamBufferMode::Orphan;
+		if (!StreamBufferInit(&result->stream, GL_ARRAY_BUFFER, bytes, mode)) return;
+		if (result->stream.mode != mode)
+		{
+			StreamBufferShutdown(&result->stream);
+			return; // sin soporte: ya se aviso en stderr
+		}
+		for (int s = 0; s < result->stream.segments; ++s)
+			vaos[s] = CreatePointsVao(result->stream.buffer, StreamBufferSegmentOffset(result->stream, s));
+	}
+
+	result->uploadMs.assign((size_t)frames, 0.0);
+	glFinish();
+	const uint64_t start = PlatformTicks();
+	for (int frame = 0; frame < frames; ++frame)
+	{
+		const uint64_t t0 = PlatformTicks();
+		int segment = 0;
+		if (result->path == StreamBenchPath::BufferData)
+		{
+			GLStateBindBuffer(GL_ARRAY_BUFFER, buffer);
+			glBufferData_ptr(GL_ARRAY_BUFFER, (GLsizeiptr)bytes, points.data(), GL_STREAM_DRAW);
+		}
+		else
+		{
+			StreamWrite w;
+			if (StreamBufferBegin(&result->stream, &w))
+			{
+				memcpy(w.data, points.data(), bytes);
+				StreamBufferEnd(&result->stream, bytes);
+			}
+			segment = result->stream.segment;
+		}
+		const double ms = MsSince(t0);
+		result->uploadMs[(size_t)frame] = ms;
+		if (ms > memcpyMs + kStreamBlockedMs) ++result->blocked;
+
+		GLStateBindVertexArray(vaos[segment]);
+		GLStateDrawArrays(GL_POINTS, 0, count);
+		if (result->path != StreamBenchPath::BufferData)
+			StreamBufferFence(&result->stream);
+	}
+	glFinish();
+	result->wallSeconds = MsSince(start) * 1e-3;
+	result->ran = true;
+
+	GLStateBindVertexArray(0);
+	for (GLuint vao : vaos)
+		if (vao) GLStateDeleteVertexArray(vao);
+	if (result->path == StreamBenchPath::BufferData) GLStateDeleteBuffer(buffer);
+	else StreamBufferShutdown(&result->stream);
+}
+
+static void WriteResultJson(FILE* f, const StreamBenchResult& r, double megabytes, int frames)
+{
+	fprintf(f, "    { \"path\": \"%s\"", StreamBenchPathName(r.path));
+	if (!r.ran)
+	{
+		fprintf(f, ", \"supported\": false }");
+		return;
+	}
+	fprintf(f, ", \"supported\": true, \"wall_seconds\": %.4f, \"mb_per_s\": %.1f, \"frames_per_s\": %.2f, ",
+		r.wallSeconds, r.wallSeconds > 0.0 ? megabytes * frames / r.wallSeconds : 0.0, r.wallSeconds > 0.0 ? frames / r.wallSeconds : 0.0);
+	WriteTimingSummaryJson(f, "upload_ms", SummarizeTimings(r.uploadMs.data(), r.uploadMs.size()));
+	fprintf(f, ", \"blocked_uploads\": %d", r.blocked);
+	if (r.path != StreamBenchPath::BufferData)
+		fprintf(f, ", \"fence_stalls\": %llu, \"stall_ms\": %.3f, \"map_failures\": %llu",
+			(unsigned long long)r.stream.stalls, r.stream.stallMs, (unsigned long long)r.stream.mapFailures);
+	fprintf(f, " }");
+}
+
+int RunStreamBench(const StreamBenchOptions& opts)
+{
+	if (!glGenFramebuffers_ptr || !glGenRenderbuffers_ptr || !glMapBufferRange_ptr || !glUnmapBuffer_ptr)
+	{
+		fprintf(stderr, "stream-bench: framebuffer objects or glMapBufferRange not available\n");
+		return 1;
+	}
+
+	ShaderFile file;
+	std::string error;
+	if (!ShaderFileLoad("stream_bench.glsl", &file, &error))
+	{
+		fprintf(stderr, "stream-bench: %s\n", error.c_str());
+		return 1;
+	}
+	const GLuint program = ShaderBuildProgram(file, nullptr, &error);
+	if (!program)
+	{
+		fprintf(stderr, "stream-bench: shader failed:\n%s\n", error.c_str());
+		return 1;
+	}
+
+	GLuint fbo = 0, rbo = 0;
+	glGenRenderbuffers_ptr(1, &rbo);
+	glBindRenderbuffer_ptr(GL_RENDERBUFFER, rbo);
+	glRenderbufferStorage_ptr(GL_RENDERBUFFER, GL_RGBA8, kStreamBenchSize, kStreamBenchSize);
+	glGenFramebuffers_ptr(1, &fbo);
+	GLStateBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferRenderbuffer_ptr(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rbo);
+	const bool complete = glCheckFramebufferStatus_ptr(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+	// Puntos (x, y) pseudoaleatorios en [-1, 1]: 8 bytes cada uno.
+	const size_t pointCount = (size_t)(opts.megabytes * 1024.0 * 1024.0) / (2 * sizeof(float));
+	std::vector<float> points(pointCount * 2);
+	uint32_t rng = 0x9E3779B9u;
+	for (float& v : points)
+	{
+		rng = rng * 1664525u + 1013904223u;
+		v = (float)(rng >> 8) * (2.0f / 16777216.0f) - 1.0f;
+	}
+	const size_t bytes = points.size() * sizeof(float);
+
+	// Referencia: lo que cuesta copiar los datos sin GL de por medio.
+	std::vector<float> host(points.size());
+	std::vector<double> memcpyMs(16);
+	for (double& ms : memcpyMs)
+	{
+		const uint64_t t0 = PlatformTicks();
+		memcpy(host.data(), points.data(), bytes);
+		ms = MsSince(t0);
+	}
+	const TimingSummary memcpySummary = SummarizeTimings(memcpyMs.data(), memcpyMs.size());
+
+	StreamBenchResult results[3];
+	results[0].path = StreamBenchPath::BufferData;
+	results[1].path = StreamBenchPath::Orphan;
+	results[2].path = StreamBenchPath::Persistent;
+	if (complete)
+	{
+		GLStateViewport(0, 0, kStreamBenchSize, kStreamBenchSize);
+		GLStateUseProgram(program);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_ONE, GL_ONE);
+		for (StreamBenchResult& r : results)
+		{
+			GLStateClear(GL_COLOR_BUFFER_BIT);
+			RunPath(&r, points, opts.frames, memcpySummary.p50);
+		}
+		glDisable(GL_BLEND);
+	}
+	else
+	{
+		fprintf(stderr, "stream-bench: framebuffer incomplete\n");
+	}
+
+	GLStateBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateDeleteFramebuffer(fbo);
+	glDeleteRenderbuffers_ptr(1, &rbo);
+	GLStateDeleteProgram(program);
+	if (!complete) return 1;
+
+	FILE* out = opts.jsonPath ? fopen(opts.jsonPath, "w") : stdout;
+	if (!out)
+	{
+		fprintf(stderr, "stream-bench: cannot write '%s'\n", opts.jsonPath);
+		return 1;
+	}
+	const GLubyte* renderer = glGetString(GL_RENDERER);
+	fprintf(out, "{\n  \"mode\": \"stream_bench\",\n  \"renderer\": \"%s\",\n", renderer ? (const char*)renderer : "");
+	fprintf(out, "  \"persistent_supported\": %s,\n", StreamBufferPersistentSupported() ? "true" : "false");
+	fprintf(out, "  \"megabytes_per_frame\": %.2f,\n  \"frames\": %d,\n  ", (double)bytes / (1024.0 * 1024.0), opts.frames);
+	WriteTimingSummaryJson(out, "memcpy_ms", memcpySummary);
+	fprintf(out, ",\n  \"paths\": [\n");
+	for (int i = 0; i < 3; ++i)
+	{
+		WriteResultJson(out, results[i], (double)bytes / (1024.0 * 1024.0), opts.frames);
+		fprintf(out, i < 2 ? ",\n" : "\n");
+	}
+	fprintf(out, "  ]\n}\n");
+
+	if (out != stdout) fclose(out);
+	return 0;
+}
@@ -0,0 +1,499 @@
+#include "synth.h"
+#include "simd_math.h"
+
+#include <math.h>
+#include <string.h>
+
+static const float kPi = 3.14159265358979f;
+static const float kEnvFloor = 1e-4f;        // -80 dB: debajo de esto la voz se apaga
+static const float kEnvTimeLevel = -6.9078f; // ln(0.001): decay/release llegan a -60 dB en su tiempo
+
+// ---------------------------
+// Comandos
+// ---------------------------
+
+void SynthInit(Synth* synth, float sampleRate)
+{
+	// Campo a campo: Synth() en el stack serian ~60 KB de temporal.
+	synth->sampleRate = sampleRate;
+	synth->masterGain = 1.0f;
+	synth->nextOrder = 0;
+	synth->coefFrames = 128;
+	memset(&synth->voices, 0, sizeof(synth->voices)); // stage 0 = Off
+	synth->stats = SynthStats();
+	ArenaInit(&synth->arena, synth->scratch, sizeof(synth->scratch));
+}
+
+static float PerFrameCoef(float seconds, float sampleRate)
+{
+	const float frames = (seconds > 1e-4f ? seconds : 1e-4f) * sampleRate;
+	return expf(kEnvTimeLevel / frames);
+}
+
+static void UpdateBlockCoefs(SynthVoicePool& p, int v, int frames)
+{
+	p.attackBlock[v] = p.attackPerFrame[v] * (float)frames;
+	p.decayBlock[v] = powf(p.decayPerFrame[v], (float)frames);
+	p.releaseBlock[v] = powf(p.releasePerFrame[v], (float)frames);
+}
+
+// Voz libre, o la que menos se va a extraniar entre las de prioridad <= 'priority': la de menor
+// prioridad, en release antes que sostenida, la mas baja en volumen, la mas vieja. -1 si no hay.
+static int AllocateVoice(Synth* synth, uint8_t priority)
+{
+	const SynthVoicePool& p = synth->voices;
+	for (int v = 0; v < kSynthMaxVoices; ++v)
+		if (p.stage[v] == (uint8_t)SynthEnvStage::Off) return v;
+
+	int best = -1;
+	for (int v = 0; v < kSynthMaxVoices; ++v)
+	{
+		if (p.priority[v] > priority) continue;
+		if (best < 0) { best = v; continue; }
+
+		const bool releasing = p.stage[v] == (uint8_t)SynthEnvStage::Release;
+		const bool bestReleasing = p.stage[best] == (uint8_t)SynthEnvStage::Release;
+		if (p.priority[v] != p.priority[best]) { if (p.priority[v] < p.priority[best]) best = v; continue; }
+		if (releasing != bestReleasing) { if (releasing) best = v; continue; }
+		if (p.env[v] != p.env[best]) { if (p.env[v] < p.env[best]) best = v; continue; }
+		if (p.startOrder[v] < p.startOrder[best]) best = v;
+	}
+	if (best >= 0) ++synth->stats.voicesStolen;
+	return best;
+}
+
+static void NoteOn(Synth* synth, const SynthCommand& cmd)
+{
+	const int v = AllocateVoice(synth, cmd.priority);
+	if (v < 0)
+	{
+		++synth->stats.notesDropped;
+		return;
+	}
+
+	const SynthPatch& patch = cmd.patch;
+	const float sr = synth->sampleRate;
+	SynthVoicePool& p = synth->voices;
+
+	p.stage[v] = (uint8_t)SynthEnvStage::Attack;
+	p.wave[v] = (uint8_t)patch.wave;
+	p.priority[v] = cmd.priority;
+	p.note[v] = cmd.note;
+	p.startOrder[v] = synth->nextOrder++;
+
+	const float inc = cmd.freqHz / sr;
+	p.phase[v] = 0.0f;
+	p.phaseInc[v] = inc < 0.0f ? 0.0f : (inc > 0.49f ? 0.49f : inc);
+	p.noise[v] = ((uint32_t)p.startOrder[v] * 0x9E3779B9u + 0x6A09E667u) | 1u;
+
+	p.env[v] = 0.0f;
+	p.attackPerFrame[v] = 1.0f / ((patch.attack > 1e-4f ? patch.attack : 1e-4f) * sr);
+	p.decayPerFrame[v] = PerFrameCoef(patch.decay, sr);
+	p.releasePerFrame[v] = PerFrameCoef(patch.release, sr);
+	p.sustain[v] = patch.sustain < 0.0f ? 0.0f : (patch.sustain > 1.0f ? 1.0f : patch.sustain);
+	UpdateBlockCoefs(p, v, synth->coefFrames);
+
+	// Paneo de potencia constante: cos/sin de [0, pi/2].
+	const float pan = patch.pan < -1.0f ? -1.0f : (patch.pan > 1.0f ? 1.0f : patch.pan);
+	const float angle = (pan + 1.0f) * 0.25f * kPi;
+	const float amp = cmd.velocity * patch.gain;
+	p.gainL[v] = amp * cosf(angle);
+	p.gainR[v] = amp * sinf(angle);
+
+	// SVF TPT (Zavalishin): g = tan(pi fc / fs), k = 2 - 2 * resonancia.
+	const float nyquistLimit = 0.45f * sr;
+	p.filtered[v] = patch.cutoffHz < nyquistLimit;
+	p.ic1[v] = 0.0f;
+	p.ic2[v] = 0.0f;
+	if (p.filtered[v])
+	{
+		const float fc = patch.cutoffHz > 10.0f ? patch.cutoffHz : 10.0f;
+		const float res = patch.resonance < 0.0f ? 0.0f : (patch.resonance > 0.97f ? 0.97f : patch.resonance);
+		const float g = tanf(kPi * fc / sr);
+		const float k = 2.0f - 2.0f * res;
+		p.a1[v] = 1.0f / (1.0f + g * (g + k));
+		p.a2[v] = g * p.a1[v];
+		p.a3[v] = g * p.a2[v];
+	}
+
+	++synth->stats.notesStarted;
+}
+
+void SynthApply(Synth* synth, const SynthCommand& cmd)
+{
+	SynthVoicePool& p = synth->voices;
+	switch (cmd.type)
+	{
+	case SynthCommandType::NoteOn:
+		NoteOn(synth, cmd);
+		break;
+	case SynthCommandType::NoteOff:
+		for (int v = 0; v < kSynthMaxVoices; ++v)
+			if (p.note[v] == cmd.note && p.stage[v] != (uint8_t)SynthEnvStage::Off) p.stage[v] = (uint8_t)SynthEnvStage::Release;
+		break;
+	case SynthCommandType::AllNotesOff:
+		for (int v = 0; v < kSynthMaxVoices; ++v)
+			if (p.stage[v] != (uint8_t)SynthEnvStage::Off) p.stage[v] = (uint8_t)SynthEnvStage::Release;
+		break;
+	case SynthCommandType::MasterGain:
+		synth->masterGain = cmd.value;
+		break;
+	}
+}
+
+// ---------------------------
+// Envolventes (SSE2, 4 voces por iteracion)
+// ---------------------------
+
+static inline __m128i LoadStages(const uint8_t* stage)
+{
+	int packed;
+	memcpy(&packed, stage, 4);
+	const __m128i zero = _mm_setzero_si128();
+	return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+}
+
+static inline void StoreStages(uint8_t* stage, __m128i stages)
+{
+	const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(stages, stages), stages);
+	const int value = _mm_cvtsi128_si32(packed);
+	memcpy(stage, &value, 4);
+}
+
+static inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128i SelectI(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Avanza un bloque las envolventes de todas las voces: env pasa a ser el nivel al final del bloque
+// y stage la etapa siguiente. Las transiciones se evaluan para todas las etapas y se eligen con
+// mascaras, sin saltos por voz.
+static void AdvanceEnvelopes(SynthVoicePool& p)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 floorLevel = _mm_set1_ps(kEnvFloor);
+	const __m128i stageOff = _mm_set1_epi32((int)SynthEnvStage::Off);
+	const __m128i stageAttack = _mm_set1_epi32((int)SynthEnvStage::Attack);
+	const __m128i stageDecay = _mm_set1_epi32((int)SynthEnvStage::Decay);
+	const __m128i stageSustain = _mm_set1_epi32((int)SynthEnvStage::Sustain);
+	const __m128i stageRelease = _mm_set1_epi32((int)SynthEnvStage::Release);
+
+	for (int v = 0; v < kSynthMaxVoices; v += 4)
+	{
+		const __m128i stage = LoadStages(p.stage + v);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(stage, stageOff)) == 0xFFFF) continue;
+
+		const __m128 env = _mm_load_ps(p.env + v);
+		const __m128 sustain = _mm_load_ps(p.sustain + v);
+
+		// Attack: rampa lineal hasta 1
+		const __m128 envA = _mm_min_ps(_mm_add_ps(env, _mm_load_ps(p.attackBlock + v)), one);
+		const __m128i doneA = _mm_castps_si128(_mm_cmpge_ps(envA, one));
+		const __m128i nextA = SelectI(doneA, stageDecay, stageAttack);
+
+		// Decay: exponencial hacia sustain; cerca de sustain pasa a Sustain (u Off si sustain = 0)
+		__m128 envD = _mm_add_ps(sustain, _mm_mul_ps(_mm_sub_ps(env, sustain), _mm_load_ps(p.decayBlock + v)));
+		const __m128 doneD = _mm_cmplt_ps(_mm_sub_ps(envD, sustain), floorLevel);
+		envD = Select(doneD, sustain, envD);
+		const __m128i afterD = SelectI(_mm_castps_si128(_mm_cmpgt_ps(sustain, floorLevel)), stageSustain, stageOff);
+		const __m128i nextD = SelectI(_mm_castps_si128(doneD), afterD, stageDecay);
+
+		// Release: exponencial hacia 0; la rampa del ultimo bloque termina en 0 (sin click)
+		__m128 envR = _mm_mul_ps(env, _mm_load_ps(p.releaseBlock + v));
+		const __m128 doneR = _mm_cmplt_ps(envR, floorLevel);
+		envR = Select(doneR, zero, envR);
+		const __m128i nextR = SelectI(_mm_castps_si128(doneR), stageOff, stageRelease);
+
+		const __m128i isA = _mm_cmpeq_epi32(stage, stageAttack);
+		const __m128i isD = _mm_cmpeq_epi32(stage, stageDecay);
+		const __m128i isS = _mm_cmpeq_epi32(stage, stageSustain);
+		const __m128i isR = _mm_cmpeq_epi32(stage, stageRelease);
+
+		__m128 next = _mm_and_ps(_mm_castsi128_ps(isA), envA);
+		next = _mm_or_ps(next, _mm_and_ps(_mm_castsi128_ps(isD), envD));
+		next = _mm_or_ps(next, _mm_and_ps(_mm_castsi128_ps(isS), sustain));
+		next = _mm_or_ps(next, _mm_and_ps(_mm_castsi128_ps(isR), envR));
+		_mm_store_ps(p.env + v, next);
+
+		__m128i nextStage = _mm_and_si128(isA, nextA);
+		nextStage = _mm_or_si128(nextStage, _mm_and_si128(isD, nextD));
+		nextStage = _mm_or_si128(nextStage, _mm_and_si128(isS, stageSustain));
+		nextStage = _mm_or_si128(nextStage, _mm_and_si128(isR, nextR));
+		StoreStages(p.stage + v, nextStage);
+	}
+}
+
+// ---------------------------
+// Grupos de voces (SSE2, una voz por lane)
+// ---------------------------
+
+// Correccion PolyBLEP de un salto de -2 en t = 0 (sierra): suaviza la discontinuidad con un
+// polinomio de 2 muestras. dt = incremento de fase.
+static inline __m128 PolyBlep(__m128 t, __m128 dt, __m128 invDt)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	const __m128 lo = _mm_cmplt_ps(t, dt);
+	const __m128 x = _mm_mul_ps(t, invDt);                              // t / dt
+	const __m128 loValue = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(x, x), _mm_mul_ps(x, x)), one); // 2x - x^2 - 1
+
+	const __m128 hi = _mm_cmpgt_ps(t, _mm_sub_ps(one, dt));
+	const __m128 y = _mm_mul_ps(_mm_sub_ps(t, one), invDt);             // (t - 1) / dt
+	const __m128 hiValue = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y, y), _mm_add_ps(y, y)), one); // y^2 + 2y + 1
+
+	return _mm_or_ps(_mm_and_ps(lo, loValue), _mm_and_ps(hi, hiValue));
+}
+
+// Estado de hasta 4 voces cargado del pool. Las lanes sin voz tienen ganancia e incremento 0.
+struct VoiceGroup
+{
+	alignas(16) float phase[4], inc[4], env0[4], env1[4], gainL[4], gainR[4];
+	alignas(16) float a1[4], a2[4], a3[4], ic1[4], ic2[4];
+	alignas(16) uint32_t noise[4];
+};
+
+static void GatherGroup(const SynthVoicePool& p, const float* envStart, const uint16_t* voices, int count, VoiceGroup* g)
+{
+	*g = VoiceGroup();
+	for (int lane = 0; lane < count; ++lane)
+	{
+		const int v = voices[lane];
+		g->phase[lane] = p.phase[v];
+		g->inc[lane] = p.phaseInc[v];
+		g->env0[lane] = envStart[v];
+		g->env1[lane] = p.env[v];
+		g->gainL[lane] = p.gainL[v];
+		g->gainR[lane] = p.gainR[v];
+		g->a1[lane] = p.a1[v];
+		g->a2[lane] = p.a2[v];
+		g->a3[lane] = p.a3[v];
+		g->ic1[lane] = p.ic1[v];
+		g->ic2[lane] = p.ic2[v];
+		g->noise[lane] = p.noise[v];
+	}
+}
+
+static void ScatterGroup(SynthVoicePool& p, const uint16_t* voices, int count, const VoiceGroup& g)
+{
+	for (int lane = 0; lane < count; ++lane)
+	{
+		const int v = voices[lane];
+		p.phase[v] = g.phase[lane];
+		p.ic1[v] = g.ic1[lane];
+		p.ic2[v] = g.ic2[lane];
+		p.noise[v] = g.noise[lane];
+	}
+}
+
+// Suma 4 voces de la misma onda en accL/accR, intercalados por frame: acc[4 * i + lane].
+template <SynthWave Wave, bool Filtered>
+static void RenderGroup(VoiceGroup& g, float* accL, float* accR, int frames)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 inc = _mm_load_ps(g.inc);
+	const __m128 invDt = Select(_mm_cmpgt_ps(inc, _mm_setzero_ps()), _mm_div_ps(one, inc), _mm_setzero_ps());
+	const __m128 gainL = _mm_load_ps(g.gainL);
+	const __m128 gainR = _mm_load_ps(g.gainR);
+	const __m128 a1 = _mm_load_ps(g.a1), a2 = _mm_load_ps(g.a2), a3 = _mm_load_ps(g.a3);
+
+	const __m128 env0 = _mm_load_ps(g.env0);
+	const __m128 envStep = _mm_div_ps(_mm_sub_ps(_mm_load_ps(g.env1), env0), _mm_set1_ps((float)frames));
+	__m128 env = _mm_add_ps(env0, envStep);
+
+	__m128 phase = _mm_load_ps(g.phase);
+	__m128 ic1 = _mm_load_ps(g.ic1), ic2 = _mm_load_ps(g.ic2);
+	__m128i noise = _mm_load_si128((const __m128i*)g.noise);
+
+	for (int i = 0; i < frames; ++i)
+	{
+		__m128 s;
+		if (Wave == SynthWave::Sine)
+		{
+			s = simd::Sin(_mm_mul_ps(phase, _mm_set1_ps(2.0f * kPi)));
+		}
+		else if (Wave == SynthWave::Saw)
+		{
+			s = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(phase, phase), one), PolyBlep(phase, inc, invDt));
+		}
+		else if (Wave == SynthWave::Square)
+		{
+			// +1 en la primera mitad, -1 en la segunda; un salto en t = 0 y otro en t = 0.5.
+			const __m128 naive = Select(_mm_cmplt_ps(phase, half), one, _mm_set1_ps(-1.0f));
+			const __m128 t2 = simd::Fract(_mm_add_ps(phase, half));
+			s = _mm_sub_ps(_mm_add_ps(naive, PolyBlep(phase, inc, invDt)), PolyBlep(t2, inc, invDt));
+		}
+		else
+		{
+			// xorshift32 por voz; los 23 bits altos como mantisa de un float en [1, 2) -> [-1, 1).
+			noise = _mm_xor_si128(noise, _mm_slli_epi32(noise, 13));
+			noise = _mm_xor_si128(noise, _mm_srli_epi32(noise, 17));
+			noise = _mm_xor_si128(noise, _mm_slli_epi32(noise, 5));
+			const __m128 f = _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(noise, 9), _mm_set1_epi32(0x3F800000)));
+			s = _mm_sub_ps(_mm_add_ps(f, f), _mm_set1_ps(3.0f));
+		}
+
+		phase = _mm_add_ps(phase, inc);
+		phase = _mm_sub_ps(phase, _mm_and_ps(_mm_cmpge_ps(phase, one), one));
+
+		if (Filtered)
+		{
+			const __m128 v3 = _mm_sub_ps(s, ic2);
+			const __m128 v1 = _mm_add_ps(_mm_mul_ps(a1, ic1), _mm_mul_ps(a2, v3));
+			const __m128 v2 = _mm_add_ps(_mm_add_ps(ic2, _mm_mul_ps(a2, ic1)), _mm_mul_ps(a3, v3));
+			ic1 = _mm_sub_ps(_mm_add_ps(v1, v1), ic1);
+			ic2 = _mm_sub_ps(_mm_add_ps(v2, v2), ic2);
+			s = v2; // pasa-bajos
+		}
+
+		s = _mm_mul_ps(s, env);
+		env = _mm_add_ps(env, envStep);
+
+		_mm_store_ps(accL + 4 * i, _mm_add_ps(_mm_load_ps(accL + 4 * i), _mm_mul_ps(s, gainL)));
+		_mm_store_ps(accR + 4 * i, _mm_add_ps(_mm_load_ps(accR + 4 * i), _mm_mul_ps(s, gainR)));
+	}
+
+	_mm_store_ps(g.phase, phase);
+	_mm_store_ps(g.ic1, ic1);
+	_mm_store_ps(g.ic2, ic2);
+	_mm_store_si128((__m128i*)g.noise, noise);
+}
+
+typedef void (*RenderGroupFn)(VoiceGroup& g, float* accL, float* accR, int frames);
+
+// Indice: wave * 2 + filtrado
+static const RenderGroupFn kRenderGroup[] = {
+	RenderGroup<SynthWave::Sine, false>, RenderGroup<SynthWave::Sine, true>,
+	RenderGroup<SynthWave::Saw, false>, RenderGroup<SynthWave::Saw, true>,
+	RenderGroup<SynthWave::Square, false>, RenderGroup<SynthWave::Square, true>,
+	RenderGroup<SynthWave::Noise, false>, RenderGroup<SynthWave::Noise, true>,
+};
+static const int kGroupKinds = (int)(sizeof(kRenderGroup) / sizeof(kRenderGroup[0]));
+
+// acc[4 * i + lane] -> out[i] = suma de las 4 lanes (transpuesta 4x4 y suma vertical).
+static void ReduceLanes(const float* acc, float* out, int frames)
+{
+	for (int i = 0; i < frames; i += 4)
+	{
+		__m128 r0 = _mm_load_ps(acc + 4 * i);
+		__m128 r1 = _mm_load_ps(acc + 4 * i + 4);
+		__m128 r2 = _mm_load_ps(acc + 4 * i + 8);
+		__m128 r3 = _mm_load_ps(acc + 4 * i + 12);
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		_mm_store_ps(out + i, _mm_add_ps(_mm_add_ps(r0, r1), _mm_add_ps(r2, r3)));
+	}
+}
+
+// ---------------------------
+// Master
+// ---------------------------
+
+// Ganancia master + saturacion suave: aproximante de Pade de tanh, exacto +-1 en +-3.
+static void RenderMaster(float gain, float* samples, int frames)
+{
+	const __m128 g = _mm_set1_ps(gain);
+	const __m128 limit = _mm_set1_ps(3.0f);
+	const __m128 c27 = _mm_set1_ps(27.0f);
+	const __m128 c9 = _mm_set1_ps(9.0f);
+	for (int i = 0; i < frames; i += 4)
+	{
+		__m128 x = _mm_mul_ps(_mm_load_ps(samples + i), g);
+		x = _mm_min_ps(_mm_max_ps(x, _mm_sub_ps(_mm_setzero_ps(), limit)), limit);
+		const __m128 x2 = _mm_mul_ps(x, x);
+		const __m128 y = _mm_div_ps(_mm_mul_ps(x, _mm_add_ps(c27, x2)), _mm_add_ps(c27, _mm_mul_ps(c9, x2)));
+		_mm_store_ps(samples + i, y);
+	}
+}
+
+// ---------------------------
+// Bloque
+// ---------------------------
+
+void SynthRender(Synth* synth, float* left, float* right, int frames)
+{
+	if (frames > kSynthMaxBlock) frames = kSynthMaxBlock;
+	frames &= ~3;
+
+	SynthVoicePool& p = synth->voices;
+	Arena* arena = &synth->arena;
+	ArenaReset(arena);
+
+	if (frames != synth->coefFrames)
+	{
+		synth->coefFrames = frames;
+		for (int v = 0; v < kSynthMaxVoices; ++v)
+			UpdateBlockCoefs(p, v, frames);
+	}
+
+	float* envStart = ArenaAllocArray<float>(arena, kSynthMaxVoices);
+	uint16_t* lists = ArenaAllocArray<uint16_t>(arena, (size_t)kGroupKinds * kSynthMaxVoices);
+	float* accL = ArenaAllocArray<float>(arena, (size_t)frames * 4);
+	float* accR = ArenaAllocArray<float>(arena, (size_t)frames * 4);
+	synth->stats.scratchHighWater = arena->highWater;
+	if (!envStart || !lists || !accL || !accR)
+	{
+		++synth->stats.scratchFailures;
+		memset(left, 0, sizeof(float) * (size_t)frames);
+		memset(right, 0, sizeof(float) * (size_t)frames);
+		return;
+	}
+
+	// Voces activas agrupadas por onda y filtro. Las que terminan en este bloque se incluyen: su
+	// rampa final hasta 0 todavia se escucha.
+	int counts[kGroupKinds] = {};
+	int active = 0;
+	for (int v = 0; v < kSynthMaxVoices; ++v)
+	{
+		if (p.stage[v] == (uint8_t)SynthEnvStage::Off) continue;
+		const int kind = p.wave[v] * 2 + (p.filtered[v] ? 1 : 0);
+		lists[kind * kSynthMaxVoices + counts[kind]++] = (uint16_t)v;
+		++active;
+	}
+
+	memcpy(envStart, p.env, sizeof(float) * kSynthMaxVoices);
+	AdvanceEnvelopes(p);
+
+	memset(accL, 0, sizeof(float) * (size_t)frames * 4);
+	memset(accR, 0, sizeof(float) * (size_t)frames * 4);
+	VoiceGroup group;
+	for (int kind = 0; kind < kGroupKinds; ++kind)
+	{
+		const uint16_t* list = lists + kind * kSynthMaxVoices;
+		for (int first = 0; first < counts[kind]; first += 4)
+		{
+			const int count = counts[kind] - first < 4 ? counts[kind] - first : 4;
+			GatherGroup(p, envStart, list + first, count, &group);
+			kRenderGroup[kind](group, accL, accR, frames);
+			ScatterGroup(p, list + first, count, group);
+		}
+	}
+
+	ReduceLanes(accL, left, frames);
+	ReduceLanes(accR, right, frames);
+	RenderMaster(synth->masterGain, left, frames);
+	RenderMaster(synth->masterGain, right, frames);
+
+	++synth->stats.blocks;
+	synth->stats.activeVoices = active;
+}
+
+int SynthActiveVoices(const Synth* synth)
+{
+	return synth->stats.activeVoices;
+}
+
+void SynthEnableFlushToZero()
+{
+	_mm_setcsr(_mm_getcsr() | 0x8040); // FTZ (bit 15) + DAZ (bit 6)
+}
+
+float SynthMidiToHz(float midiNote)
+{
+	return 440.0f * exp2f((midiNote - 69.0f) / 12.0f);
+}
@@ -0,0 +1,80 @@
+#include "text_layout.h"
+#include "glyph_atlas.h"
+
+#include <string.h>
+
+// Cada cuantos frames TextLayoutCacheEndFrame recorre las entradas buscando viejas.
+static const uint64_t kEvictIntervalFrames = 60;
+
+void TextLayoutBuild(const char* text, TextLayout* out)
+{
+	out->glyphs.clear();
+	float x = 0.0f, y = 0.0f, width = 0.0f;
+	int column = 0;
+	for (const unsigned char* p = (const unsigned char*)text; *p; ++p)
+	{
+		if (*p == '\n')
+		{
+			if (x > width) width = x;
+			x = 0.0f;
+			column = 0;
+			y += kGlyphLineHeight;
+			continue;
+		}
+		const int columns = *p == '\t' ? 4 - column % 4 : 1;
+		if (*p != ' ' && *p != '\t')
+			out->glyphs.push_back({ x, y, GlyphIndex(*p) });
+		x += kGlyphAdvance * (float)columns;
+		column += columns;
+	}
+	out->width = x > width ? x : width;
+	out->height = y + kGlyphLineHeight;
+}
+
+static uint64_t HashText(const char* text, size_t bytes)
+{
+	uint64_t h = 0xCBF29CE484222325ull;
+	for (size_t i = 0; i < bytes; ++i)
+	{
+		h ^= (uint8_t)text[i];
+		h *= 0x100000001B3ull;
+	}
+	return h;
+}
+
+const TextLayout& TextLayoutCacheGet(TextLayoutCache* cache, const char* text)
+{
+	++cache->lookups;
+	const size_t bytes = strlen(text);
+	TextLayoutEntry& e = cache->entries[HashText(text, bytes)];
+	e.lastFrame = cache->frame;
+	// height > 0: la entrada ya tiene un layout armado (recien creada esta vacia)
+	if (e.layout.height > 0.0f && e.text.size() == bytes && memcmp(e.text.data(), text, bytes) == 0)
+	{
+		++cache->hits;
+		return e.layout;
+	}
+
+	// Entrada nueva o colision de hash: se arma (y pisa la anterior).
+	e.text.assign(text, bytes);
+	TextLayoutBuild(text, &e.layout);
+	return e.layout;
+}
+
+void TextLayoutCacheEndFrame(TextLayoutCache* cache)
+{
+	++cache->frame;
+	if (cache->frame % kEvictIntervalFrames != 0) return;
+	for (auto it = cache->entries.begin(); it != cache->entries.end();)
+	{
+		if (cache->frame - it->second.lastFrame > kTextLayoutMaxIdleFrames)
+		{
+			it = cache->entries.erase(it);
+			++cache->evictions;
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------
+// Layout de texto
+// ---------------------------
+
+// Convierte un string en la lista de glifos posicionados que dibuja el HUD (hud.h), con las
+// metricas del atlas (glyph_atlas.h): ancho fijo, '\n' baja una linea, '\t' va a la proxima
+// columna multiplo de 4, los espacios no generan glifo. Las posiciones son relativas al origen del
+// texto y en unidades del tamanio: el mismo layout sirve para cualquier posicion, tamanio y color.
+//
+// TextLayoutCache guarda los layouts por contenido. Un HUD repite casi todos sus strings frame a
+// frame (etiquetas, y valores que se refrescan unas pocas veces por segundo): lo que no cambio no
+// se vuelve a armar ni aloca. Las entradas que no se piden en kTextLayoutMaxIdleFrames frames se
+// descartan.
+
+struct TextGlyph
+{
+	float x, y;     // esquina superior izquierda de la caja, en unidades del tamanio
+	int glyph;      // indice en el atlas
+};
+
+struct TextLayout
+{
+	std::vector<TextGlyph> glyphs;
+	float width = 0.0f;     // de la linea mas larga
+	float height = 0.0f;    // lineas * kGlyphLineHeight
+};
+
+// Arma el layout de 'text' (sin cache).
+void TextLayoutBuild(const char* text, TextLayout* out);
+
+static const uint64_t kTextLayoutMaxIdleFrames = 120;
+
+struct TextLayoutEntry
+{
+	std::string text;
+	TextLayout layout;
+	uint64_t lastFrame = 0;
+};
+
+struct TextLayoutCache
+{
+	std::unordered_map<uint64_t, TextLayoutEntry> entries;   // por hash del contenido
+	uint64_t frame = 0;
+
+	// Estadisticas
+	uint64_t lookups = 0;
+	uint64_t hits = 0;
+	uint64_t evictions = 0;
+};
+
+// El layout de 'text', del cache o recien armado. La referencia vale hasta el proximo Get o EndFrame.
+const TextLayout& TextLayoutCacheGet(TextLayoutCache* cache, const char* text);
+
+// Fin de frame: avanza el contador y cada tanto descarta las entradas que no se usaron.
+void TextLayoutCacheEndFrame(TextLayoutCache* cache);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// ---------------------------
+// Triple buffer sin locks
+// ---------------------------
+
+// Un escritor publica valores completos y un lector toma siempre el mas nuevo, sin esperarse nunca
+// (p.ej. thread de simulacion -> render). Hay tres copias: la que llena el escritor (back), la que
+// lee el lector (front) y la del medio, que es la ultima publicada. Publicar y tomar son un solo
+// exchange sobre el indice del medio, que lleva ademas un bit de "nuevo"; si el escritor publica
+// dos veces antes de que el lector tome, la intermedia se pisa (el lector solo quiere la ultima).
+//
+// Lo que devuelve Read() no cambia hasta el proximo Acquire(): el lector puede guardarse punteros
+// adentro mientras dure el frame.
+
+template <typename T>
+struct TripleBuffer
+{
+	// Escritor: llenar Write() y publicarlo.
+	T& Write() { return slots[back].value; }
+
+	void Publish()
+	{
+		const uint32_t previous = middle.exchange(back | kFresh, std::memory_order_acq_rel);
+		back = previous & kIndexMask;
+	}
+
+	// Lector: false si no hubo nada publicado desde el ultimo Acquire (Read() sigue siendo el anterior).
+	bool Acquire()
+	{
+		if (!(middle.load(std::memory_order_relaxed) & kFresh)) return false;
+		const uint32_t previous = middle.exchange(front, std::memory_order_acq_rel);
+		front = previous & kIndexMask;
+		return true;
+	}
+
+	const T& Read() const { return slots[front].value; }
+
+	static const uint32_t kIndexMask = 3;
+	static const uint32_t kFresh = 4;
+
+	// Cada copia en su linea de cache; back solo lo toca el escritor, front solo el lector.
+	struct alignas(64) Slot
+	{
+		T value{};
+	};
+	Slot slots[3];
+	alignas(64) std::atomic<uint32_t> middle{ 1 };
+	alignas(64) uint32_t back = 0;
+	alignas(64) uint32_t front = 2;
+};
@@ -0,0 +1,102 @@
+#include "wav_file.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+struct WavWriter
+{
+	FILE* file = nullptr;
+	int channels = 2;
+	uint32_t dataBytes = 0;
+	bool ok = true;
+};
+
+static void PutU16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void PutU32(uint8_t* p, uint32_t v) { PutU16(p, (uint16_t)v); PutU16(p + 2, (uint16_t)(v >> 16)); }
+
+// Header RIFF/WAVE canonico de 44 bytes (little-endian, sin depender del endianness del host).
+static void BuildHeader(uint8_t* h, int sampleRate, int channels, uint32_t dataBytes)
+{
+	memcpy(h, "RIFF", 4);
+	PutU32(h + 4, 36 + dataBytes);
+	memcpy(h + 8, "WAVEfmt ", 8);
+	PutU32(h + 16, 16);                                   // tamanio del chunk fmt
+	PutU16(h + 20, 1);                                    // PCM
+	PutU16(h + 22, (uint16_t)channels);
+	PutU32(h + 24, (uint32_t)sampleRate);
+	PutU32(h + 28, (uint32_t)(sampleRate * channels * 2)); // bytes por segundo
+	PutU16(h + 32, (uint16_t)(channels * 2));              // bytes por frame
+	PutU16(h + 34, 16);                                   // bits por muestra
+	memcpy(h + 36, "data", 4);
+	PutU32(h + 40, dataBytes);
+}
+
+WavWriter* WavOpen(const char* path, int sampleRate, int channels)
+{
+	FILE* f = fopen(path, "wb");
+	if (!f) return nullptr;
+
+	uint8_t header[44];
+	BuildHeader(header, sampleRate, channels, 0); // se completa en WavClose
+	if (fwrite(header, sizeof(header), 1, f) != 1)
+	{
+		fclose(f);
+		return nullptr;
+	}
+
+	WavWriter* wav = new WavWriter();
+	wav->file = f;
+	wav->channels = channels;
+	return wav;
+}
+
+static int16_t ToPcm16(float x)
+{
+	if (x > 1.0f) x = 1.0f;
+	if (x < -1.0f) x = -1.0f;
+	return (int16_t)(x * 32767.0f + (x >= 0.0f ? 0.5f : -0.5f));
+}
+
+bool WavWriteFrames(WavWriter* wav, const float* left, const float* right, int frames)
+{
+	if (!wav || !wav->ok) return false;
+
+	uint8_t buffer[1024 * 4];
+	const int framesPerChunk = (int)sizeof(buffer) / (wav->channels * 2);
+	for (int start = 0; start < frames; start += framesPerChunk)
+	{
+		const int count = frames - start < framesPerChunk ? frames - start : framesPerChunk;
+		uint8_t* p = buffer;
+		for (int i = start; i < start + count; ++i)
+		{
+			PutU16(p, (uint16_t)ToPcm16(left[i]));
+			p += 2;
+			if (wav->channels > 1)
+			{
+				PutU16(p, (uint16_t)ToPcm16(right[i]));
+				p += 2;
+			}
+		}
+		const size_t bytes = (size_t)(p - buffer);
+		if (fwrite(buffer, 1, bytes, wav->file) != bytes) wav->ok = false;
+		wav->dataBytes += (uint32_t)bytes;
+	}
+	return wav->ok;
+}
+
+bool WavClose(WavWriter* wav)
+{
+	if (!wav) return false;
+
+	// Solo hay que reescribir los dos tamanios; el resto del header ya esta bien.
+	uint8_t riffSize[4], dataSize[4];
+	PutU32(riffSize, 36 + wav->dataBytes);
+	PutU32(dataSize, wav->dataBytes);
+	bool ok = wav->ok;
+	ok = ok && fseek(wav->file, 4, SEEK_SET) == 0 && fwrite(riffSize, 4, 1, wav->file) == 1;
+	ok = ok && fseek(wav->file, 40, SEEK_SET) == 0 && fwrite(dataSize, 4, 1, wav->file) == 1;
+	ok = fclose(wav->file) == 0 && ok;
+	delete wav;
+	return ok;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// ---------------------------
+// WAV
+// ---------------------------
+
+// Escritura de WAV PCM de 16 bits a partir de muestras float en [-1, 1] (lo de afuera se recorta).
+// Para el render offline del sintetizador: se puede escuchar y comparar en cualquier maquina.
+
+struct WavWriter;
+
+// 'channels' canales intercalados. nullptr si no se pudo crear el archivo.
+WavWriter* WavOpen(const char* path, int sampleRate, int channels);
+
+// Agrega 'frames' frames. left/right planares (right se ignora con 1 canal).
+bool WavWriteFrames(WavWriter* wav, const float* left, const float* right, int frames);
+
+// Completa los tamanios del header y cierra. Devuelve false si algo fallo en el camino.
+bool WavClose(WavWriter* wav);